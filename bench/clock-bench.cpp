@@ -0,0 +1,104 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Benchmark comparing the cost of Timestamp::now() with each of the clock
+ * sources (and with a ClockPage, read through a callback)
+ *
+ * Usage: present-bench-clock [count]
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#include "present.h"
+
+/** Get the number of milliseconds elapsed since @p start. */
+static double
+elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+/** The ClockPage that page_clock reads. */
+static ClockPage * clock_page = NULL;
+
+/** A clock source callback that reads a ClockPage. */
+static void
+page_clock(struct Timestamp * const result)
+{
+    *result = clock_page->now();
+}
+
+/** A clock source callback that does as little as possible. */
+static void
+epoch_clock(struct Timestamp * const result)
+{
+    *result = Timestamp::epoch();
+}
+
+/** Read the time @p count times, and print how long each read took. */
+static void
+report(const char * name, size_t count)
+{
+    std::chrono::steady_clock::time_point start;
+    Timestamp previous = Timestamp::epoch();
+    size_t changes = 0;
+    double ms;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        const Timestamp now = Timestamp::now();
+        changes += now != previous;
+        previous = now;
+    }
+    ms = elapsed_ms(start);
+    printf("%-24s %9.1f ms   %6.1f ns/read   %lu distinct readings\n",
+            name, ms, ms * 1000000.0 / count, (unsigned long) changes);
+}
+
+int
+main(int argc, char ** argv)
+{
+    const size_t count = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10)
+                                  : 10000000;
+
+    printf("Timestamp::now() %lu times\n", (unsigned long) count);
+
+    ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME);
+    report("realtime", count);
+
+    if (ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME_COARSE)) {
+        report("realtime coarse", count);
+    } else {
+        printf("%-24s not available\n", "realtime coarse");
+    }
+
+    if (ClockSource_select(PRESENT_CLOCK_SOURCE_TSC)) {
+        report("tsc", count);
+    } else {
+        printf("%-24s not available\n", "tsc");
+    }
+
+    ClockPage page;
+    if (page.publish(NULL, TimeDelta::from_microseconds(100))) {
+        clock_page = &page;
+        ClockSource_set_callback(&page_clock);
+        report("clock page (100 us)", count);
+    } else {
+        printf("%-24s not available\n", "clock page");
+    }
+
+    ClockSource_set_callback(&epoch_clock);
+    report("callback (dispatch only)", count);
+
+    ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME);
+    return 0;
+}
+
@@ -0,0 +1,175 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Benchmark comparing CronSchedule next-time lookups (one at a time and in a
+ * batch) against stepping through the times one minute at a time
+ *
+ * Usage: present-bench-cron [count]
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "present.h"
+
+/** Simple linear congruential generator (so that every run is the same). */
+static unsigned long long
+next_random(unsigned long long & seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed >> 17;
+}
+
+/** Get the number of milliseconds elapsed since @p start. */
+static double
+elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+/** Print a result line, and exit if the lookups did not agree. */
+static void
+report(const char * name, size_t count, double baseline_ms, double cron_ms,
+        bool matches)
+{
+    printf("%-30s %8lu   stepping %9.1f ms   bit scan %9.1f ms   (%.1fx)\n",
+            name, (unsigned long) count, baseline_ms, cron_ms,
+            baseline_ms / cron_ms);
+    if (!matches) {
+        fprintf(stderr, "%s: results do not match\n", name);
+        exit(1);
+    }
+}
+
+/** Append a random field (a value, a range, a list, or a step). */
+static void
+append_field(std::string & expression, unsigned long long & seed, int min,
+        int max, bool allow_star)
+{
+    char buffer[32];
+    const int span = max - min + 1;
+    const int a = min + (int) (next_random(seed) % span);
+    const int b = min + (int) (next_random(seed) % span);
+    switch (next_random(seed) % (allow_star ? 5 : 4)) {
+        case 0:
+            sprintf(buffer, "%d", a);
+            break;
+        case 1:
+            sprintf(buffer, "%d-%d", a < b ? a : b, a < b ? b : a);
+            break;
+        case 2:
+            sprintf(buffer, "%d,%d", a, b);
+            break;
+        case 3:
+            sprintf(buffer, "*/%d", 1 + (int) (next_random(seed) % 6));
+            break;
+        default:
+            sprintf(buffer, "*");
+            break;
+    }
+    if (!expression.empty()) {
+        expression += ' ';
+    }
+    expression += buffer;
+}
+
+/** Find the next matching minute by stepping through the minutes. */
+static Timestamp
+stepping_next_after(const CronSchedule & schedule, const Timestamp & timestamp)
+{
+    const TimeDelta minute = TimeDelta::from_minutes(1);
+    const time_t seconds = timestamp.get_time_t();
+    Timestamp t = Timestamp::create(seconds - ((seconds % 60) + 60) % 60);
+    do {
+        t += minute;
+    } while (!schedule.matches(t));
+    return t;
+}
+
+int
+main(int argc, char ** argv)
+{
+    const size_t count = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10)
+                                  : 100000;
+    /* Stepping can take up to a year of minutes, so it only gets a sample */
+    const size_t sample_count = count < 200 ? count : 200;
+    unsigned long long seed = 1;
+    std::chrono::steady_clock::time_point start;
+    double baseline_ms, cron_ms;
+    bool matches;
+
+    /* Random 5-field schedules, in a handful of time zone offsets (sorted so
+       that the batch can reuse the split-up time) */
+    std::vector<CronSchedule> schedules;
+    schedules.reserve(count);
+    while (schedules.size() < count) {
+        std::string expression;
+        append_field(expression, seed, 0, 59, true);
+        append_field(expression, seed, 0, 23, true);
+        append_field(expression, seed, 1, 28, true);
+        append_field(expression, seed, 1, 12, true);
+        append_field(expression, seed, 0, 6, true);
+        const CronSchedule schedule = CronSchedule::create(expression.c_str(),
+                TimeDelta::from_hours(
+                    (int) (schedules.size() * 4 / count) * 3 - 6));
+        if (!schedule.has_error) {
+            schedules.push_back(schedule);
+        }
+    }
+
+    const Timestamp now = Timestamp::create_utc(Date::create(2024, 6, 7),
+            ClockTime::create(23, 57, 12));
+    printf("Next times for %lu cron schedules\n", (unsigned long) count);
+
+    std::vector<Timestamp> expected(sample_count);
+    std::vector<Timestamp> results(count);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < sample_count; ++i) {
+        expected[i] = stepping_next_after(schedules[i], now);
+    }
+    baseline_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < sample_count; ++i) {
+        results[i] = schedules[i].next_after(now);
+    }
+    cron_ms = elapsed_ms(start);
+    matches = true;
+    for (size_t i = 0; i < sample_count; ++i) {
+        matches = matches && results[i] == expected[i];
+    }
+    report("next_after (sample)", sample_count, baseline_ms, cron_ms,
+            matches);
+
+    /* All of the schedules, one at a time and in a batch, with the times per
+       schedule scaled from the sample */
+    std::vector<Timestamp> single(count);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        single[i] = schedules[i].next_after(now);
+    }
+    cron_ms = elapsed_ms(start);
+    report("next_after (all)", count,
+            baseline_ms * count / sample_count, cron_ms, true);
+
+    start = std::chrono::steady_clock::now();
+    CronSchedule::next_after_batch(&schedules[0], now, &results[0], count);
+    cron_ms = elapsed_ms(start);
+    matches = true;
+    for (size_t i = 0; i < count; ++i) {
+        matches = matches && results[i] == single[i];
+    }
+    report("next_after_batch (all)", count,
+            baseline_ms * count / sample_count, cron_ms, matches);
+
+    return 0;
+}
+
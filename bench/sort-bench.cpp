@@ -0,0 +1,146 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Benchmark comparing the radix sorts of Timestamps, Dates, and columns
+ * against std::sort
+ *
+ * Usage: present-bench-sort [count]
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "present.h"
+
+/** Simple linear congruential generator (so that every run is the same). */
+static unsigned long long
+next_random(unsigned long long & seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed >> 17;
+}
+
+/** Get the number of milliseconds elapsed since @p start. */
+static double
+elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+/** Print a result line, and exit if the two sorts did not agree. */
+static void
+report(const char * name, double baseline_ms, double radix_ms, bool matches)
+{
+    printf("%-28s std::sort %9.1f ms   radix %9.1f ms   (%.2fx)\n",
+            name, baseline_ms, radix_ms, baseline_ms / radix_ms);
+    if (!matches) {
+        fprintf(stderr, "%s: results do not match\n", name);
+        exit(1);
+    }
+}
+
+int
+main(int argc, char ** argv)
+{
+    const size_t count = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10)
+                                  : 10000000;
+    const unsigned int thread_count =
+        std::max(1U, std::thread::hardware_concurrency());
+    unsigned long long seed = 1;
+    std::chrono::steady_clock::time_point start;
+    double baseline_ms, radix_ms;
+
+    printf("Sorting %lu values (%u threads for the parallel sorts)\n",
+            (unsigned long) count, thread_count);
+
+    /* Timestamps within about 10 years of 2020, at nanosecond resolution */
+    std::vector<Timestamp> timestamps;
+    timestamps.reserve(count);
+    TimestampColumn column;
+    column.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned long long r = next_random(seed);
+        timestamps.push_back(Timestamp::create(
+                    (time_t) (1577836800 + (long long) (r % 315360000))) +
+                TimeDelta::from_nanoseconds((r >> 29) % 1000000000));
+        column.push_back(timestamps.back());
+    }
+
+    std::vector<Timestamp> expected(timestamps);
+    start = std::chrono::steady_clock::now();
+    std::sort(expected.begin(), expected.end());
+    baseline_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    Timestamp::sort(&timestamps[0], timestamps.size());
+    radix_ms = elapsed_ms(start);
+    report("Timestamp array", baseline_ms, radix_ms, timestamps == expected);
+
+    TimestampColumn parallel(column);
+    start = std::chrono::steady_clock::now();
+    column.sort();
+    radix_ms = elapsed_ms(start);
+    bool matches = true;
+    for (size_t i = 0; i < count; ++i) {
+        matches = matches && column[i] == expected[i];
+    }
+    report("TimestampColumn", baseline_ms, radix_ms, matches);
+
+    start = std::chrono::steady_clock::now();
+    parallel.sort_parallel(thread_count);
+    radix_ms = elapsed_ms(start);
+    for (size_t i = 0; i < count; ++i) {
+        matches = matches && parallel[i] == expected[i];
+    }
+    report("TimestampColumn (parallel)", baseline_ms, radix_ms, matches);
+
+    start = std::chrono::steady_clock::now();
+    expected.erase(std::unique(expected.begin(), expected.end()),
+            expected.end());
+    baseline_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    column.unique();
+    radix_ms = elapsed_ms(start);
+    printf("%-28s std::unique %7.1f ms   unique %8.1f ms\n",
+            "TimestampColumn dedup", baseline_ms, radix_ms);
+    if (column.size() != expected.size()) {
+        fprintf(stderr, "TimestampColumn dedup: results do not match\n");
+        return 1;
+    }
+
+    /* Dates between the years 1 and 3000 */
+    std::vector<Date> dates;
+    dates.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned long long r = next_random(seed);
+        dates.push_back(Date::create((int_year) (r % 3000 + 1),
+                    (int_month) ((r >> 12) % 12 + 1),
+                    (int_day) ((r >> 20) % 28 + 1)));
+    }
+
+    std::vector<Date> expected_dates(dates);
+    start = std::chrono::steady_clock::now();
+    std::stable_sort(expected_dates.begin(), expected_dates.end());
+    baseline_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    Date::sort(&dates[0], dates.size());
+    radix_ms = elapsed_ms(start);
+    matches = true;
+    for (size_t i = 0; i < count; ++i) {
+        matches = matches && dates[i] == expected_dates[i];
+    }
+    report("Date array", baseline_ms, radix_ms, matches);
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Benchmark comparing TimeIndex lookups against std::lower_bound over the
+ * same sorted timestamps
+ *
+ * Usage: present-bench-time-index [count] [queries]
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "present.h"
+
+/** Simple linear congruential generator (so that every run is the same). */
+static unsigned long long
+next_random(unsigned long long & seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed >> 17;
+}
+
+/** Get the number of milliseconds elapsed since @p start. */
+static double
+elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+/** Create a timestamp within about 10 years of 2020. */
+static Timestamp
+random_timestamp(unsigned long long & seed)
+{
+    const unsigned long long r = next_random(seed);
+    return Timestamp::create(
+            (time_t) (1577836800 + (long long) (r % 315360000))) +
+        TimeDelta::from_nanoseconds((r >> 29) % 1000000000);
+}
+
+int
+main(int argc, char ** argv)
+{
+    const size_t count = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10)
+                                  : 20000000;
+    const size_t query_count = argc > 2 ?
+        (size_t) strtoul(argv[2], NULL, 10) : 2000000;
+    unsigned long long seed = 1;
+    std::chrono::steady_clock::time_point start;
+    double baseline_ms, index_ms, build_ms;
+    size_t i, baseline_sum = 0, index_sum = 0;
+
+    printf("Looking up %lu timestamps among %lu\n",
+            (unsigned long) query_count, (unsigned long) count);
+
+    std::vector<Timestamp> timestamps;
+    timestamps.reserve(count);
+    for (i = 0; i < count; ++i) {
+        timestamps.push_back(random_timestamp(seed));
+    }
+    Timestamp::sort(&timestamps[0], timestamps.size());
+
+    std::vector<Timestamp> queries;
+    queries.reserve(query_count);
+    for (i = 0; i < query_count; ++i) {
+        queries.push_back(random_timestamp(seed));
+    }
+
+    start = std::chrono::steady_clock::now();
+    TimeIndex index(&timestamps[0], timestamps.size());
+    build_ms = elapsed_ms(start);
+
+    /* Sum the positions, so that neither loop can be optimized away */
+    start = std::chrono::steady_clock::now();
+    for (i = 0; i < query_count; ++i) {
+        baseline_sum += (size_t) (std::lower_bound(timestamps.begin(),
+                    timestamps.end(), queries[i]) - timestamps.begin());
+    }
+    baseline_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    for (i = 0; i < query_count; ++i) {
+        index_sum += index.lower_bound(queries[i]);
+    }
+    index_ms = elapsed_ms(start);
+
+    printf("%-20s %9.1f ms\n", "TimeIndex build", build_ms);
+    printf("%-20s std::lower_bound %7.1f ns   TimeIndex %7.1f ns   "
+            "(%.2fx)\n", "lower_bound",
+            baseline_ms * 1000000.0 / (double) query_count,
+            index_ms * 1000000.0 / (double) query_count,
+            baseline_ms / index_ms);
+    if (baseline_sum != index_sum) {
+        fprintf(stderr, "lower_bound: results do not match\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -3,6 +3,7 @@
  *
  * Header file that includes all structures and methods for:
  * ClockTime, Date, DayDelta, MonthDelta, TimeDelta, Timestamp
+ * (and the DateColumn and TimestampColumn containers)
  *
  * If this is being read by a C compiler, it will just have the struct
  * definitions and C method declarations (no implementations). In this case,
@@ -14,6 +15,12 @@
  * individual header files in "present/". (This is enforced at compile-time;
  * for more, see "present/internal/cpp-guard.h").
  *
+ * If PRESENT_HEADER_ONLY is defined before this file is included, then it will
+ * also have the implementations of all the C functions (defined "static
+ * inline"), so the program doesn't need to link to libpresent, and the
+ * compiler can inline Present calls into the surrounding code. In this case,
+ * Present's "src" directory must be in the include path as well.
+ *
  * Licensed under the MIT License.
  * For details, see LICENSE.
  */
@@ -47,6 +54,21 @@
 #include "present/time-delta.h"
 #include "present/timestamp.h"
 
+#include "present/clock-source.h"
+#include "present/clock-page.h"
+#include "present/instant.h"
+
+#include "present/column.h"
+#include "present/cron-schedule.h"
+#include "present/time-delta-histogram.h"
+#include "present/time-index.h"
+#include "present/time-interval.h"
+#include "present/interval-set.h"
+#include "present/business-calendar.h"
+#include "present/range.h"
+#include "present/recurrence.h"
+#include "present/timer-wheel.h"
+
 #ifdef __cplusplus
 # ifdef __clang__
 #  ifndef __ICC
@@ -107,6 +129,8 @@
 
 #ifdef __cplusplus
 
+#include "present/impl/utils.hpp"
+
 #include "present/impl/clock-time.hpp"
 #include "present/impl/date.hpp"
 #include "present/impl/day-delta.hpp"
@@ -114,6 +138,37 @@
 #include "present/impl/time-delta.hpp"
 #include "present/impl/timestamp.hpp"
 
+#include "present/impl/instant.hpp"
+#include "present/impl/clock-page.hpp"
+
+#include "present/impl/column.hpp"
+#include "present/impl/cron-schedule.hpp"
+#include "present/impl/time-delta-histogram.hpp"
+#include "present/impl/time-index.hpp"
+#include "present/impl/time-interval.hpp"
+#include "present/impl/interval-set.hpp"
+#include "present/impl/business-calendar.hpp"
+#include "present/impl/range.hpp"
+#include "present/impl/recurrence.hpp"
+#include "present/impl/timer-wheel.hpp"
+#include "present/impl/time-window.hpp"
+
+#include "present/impl/format.hpp"
+#include "present/impl/policy.hpp"
+
+#if __cplusplus >= 201103L
+#include "present/impl/literals.hpp"
+#endif
+
+#endif
+
+/*
+ * Implementations of the C functions, when Present is used in header-only
+ * mode (defined "static inline")
+ */
+
+#ifdef PRESENT_HEADER_ONLY
+#include "present-header-only.h"
 #endif
 
 #endif /* _PRESENT_H_ */
@@ -0,0 +1,283 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the BusinessCalendar structure and declarations of the
+ * corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#ifndef _PRESENT_BUSINESS_CALENDAR_H_
+#define _PRESENT_BUSINESS_CALENDAR_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct Date;
+
+/*
+ * Weekend masks for BusinessCalendar_build
+ */
+
+/**
+ * The bit of a weekend mask for a day of the week (1 to 7, with 1 being
+ * Monday and 7 being Sunday, like Date_day_of_week).
+ */
+#define PRESENT_WEEKDAY_BIT(day_of_week)    (1U << ((day_of_week) - 1))
+
+/** A weekend of Saturday and Sunday. */
+#define PRESENT_WEEKEND_SATURDAY_SUNDAY \
+    (PRESENT_WEEKDAY_BIT(6) | PRESENT_WEEKDAY_BIT(7))
+
+/** A weekend of Friday and Saturday. */
+#define PRESENT_WEEKEND_FRIDAY_SATURDAY \
+    (PRESENT_WEEKDAY_BIT(5) | PRESENT_WEEKDAY_BIT(6))
+
+/*
+ * Rules for BusinessCalendar_adjust (for dates that are not business days)
+ */
+
+/** Keep the date as it is. */
+#define PRESENT_ADJUST_UNADJUSTED           (0)
+/** Move to the next business day. */
+#define PRESENT_ADJUST_FOLLOWING            (1)
+/**
+ * Move to the next business day, unless it is in the next month, in which
+ * case move to the previous business day.
+ */
+#define PRESENT_ADJUST_MODIFIED_FOLLOWING   (2)
+/** Move to the previous business day. */
+#define PRESENT_ADJUST_PRECEDING            (3)
+/**
+ * Move to the previous business day, unless it is in the previous month, in
+ * which case move to the next business day.
+ */
+#define PRESENT_ADJUST_MODIFIED_PRECEDING   (4)
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct holding the business days (the days that are not on a
+ * weekend or a holiday) of a range of dates, for settlement and SLA
+ * calculations such as "3 business days after the trade date".
+ *
+ * The calendar precomputes, for each day in its range, the number of
+ * business days before that day, and the day of each business day (by its
+ * number). Checking whether a date is a business day, counting the business
+ * days between two dates, adding a number of business days to a date, and
+ * adjusting a date to a business day are then each a few array lookups,
+ * rather than a loop over the days in between.
+ *
+ * The dates passed to the functions (and the dates that they return) must be
+ * within the range of the calendar, which should cover every date that the
+ * calculations might reach.
+ *
+ * In C, a BusinessCalendar must be initialized with BusinessCalendar_init,
+ * and released with BusinessCalendar_destroy. In C++, this is done by the
+ * constructor and the destructor.
+ */
+struct PRESENT_CLASS_API BusinessCalendar {
+    /* The first day of the range (in days since the UNIX epoch) */
+    int_delta first_day_;
+    /* The number of days in the range */
+    size_t day_count_;
+    /*
+     * The number of business days before each day of the range (day_count_
+     * + 1 entries, by days since first_day_)
+     */
+    int_delta * counts_;
+    /*
+     * Each business day (in days since first_day_), in order (in the same
+     * block as counts_)
+     */
+    int_delta * business_days_;
+    /* The number of business days in the range */
+    size_t business_day_count_;
+
+#ifdef __cplusplus
+    /** @copydoc BusinessCalendar_init */
+    BusinessCalendar();
+    /**
+     * @copydoc BusinessCalendar_build
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    BusinessCalendar(
+            const Date & first,
+            const Date & end,
+            unsigned int weekend_mask,
+            const Date * holidays,
+            size_t holiday_count);
+    BusinessCalendar(const BusinessCalendar & other);
+    BusinessCalendar & operator=(const BusinessCalendar & other);
+    /** @copydoc BusinessCalendar_destroy */
+    ~BusinessCalendar();
+
+    /**
+     * @copydoc BusinessCalendar_build
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void build(
+            const Date & first,
+            const Date & end,
+            unsigned int weekend_mask,
+            const Date * holidays,
+            size_t holiday_count);
+
+    /** @copydoc BusinessCalendar_first */
+    Date first() const;
+    /** @copydoc BusinessCalendar_end */
+    Date end() const;
+
+    /** @copydoc BusinessCalendar_is_business_day */
+    bool is_business_day(const Date & date) const;
+    /** @copydoc BusinessCalendar_business_days_between */
+    int_delta business_days_between(
+            const Date & first,
+            const Date & end) const;
+    /** @copydoc BusinessCalendar_add_business_days */
+    Date add_business_days(const Date & date, int_delta count) const;
+    /** @copydoc BusinessCalendar_adjust */
+    Date adjust(const Date & date, int rule) const;
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize an empty BusinessCalendar (with no dates in its range).
+ */
+PRESENT_API void
+BusinessCalendar_init(struct BusinessCalendar * const self);
+
+/**
+ * Release the memory held by a BusinessCalendar (which is left empty).
+ */
+PRESENT_API void
+BusinessCalendar_destroy(struct BusinessCalendar * const self);
+
+/**
+ * Replace the contents of a BusinessCalendar with the business days from
+ * @p first up to (but not including) @p end.
+ *
+ * @param weekend_mask The days of the week that are never business days, as
+ * PRESENT_WEEKDAY_BIT values combined with "|" (for example,
+ * PRESENT_WEEKEND_SATURDAY_SUNDAY).
+ * @param holidays The other days that are not business days, in any order
+ * (holidays outside the range are ignored). May be NULL if
+ * @p holiday_count is 0.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the calendar is unchanged).
+ */
+PRESENT_API present_bool
+BusinessCalendar_build(
+        struct BusinessCalendar * const self,
+        const struct Date * const first,
+        const struct Date * const end,
+        unsigned int weekend_mask,
+        const struct Date * const holidays,
+        size_t holiday_count);
+
+/**
+ * Replace the contents of a BusinessCalendar with a copy of another
+ * BusinessCalendar.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the calendar is unchanged).
+ */
+PRESENT_API present_bool
+BusinessCalendar_assign(
+        struct BusinessCalendar * const self,
+        const struct BusinessCalendar * const other);
+
+/**
+ * Get the first date in the range of a BusinessCalendar.
+ */
+PRESENT_API struct Date
+BusinessCalendar_first(const struct BusinessCalendar * const self);
+
+/**
+ * Get the date after the last date in the range of a BusinessCalendar.
+ */
+PRESENT_API struct Date
+BusinessCalendar_end(const struct BusinessCalendar * const self);
+
+/**
+ * Check whether a date is a business day (which it never is if it is outside
+ * the range of the BusinessCalendar).
+ */
+PRESENT_API present_bool
+BusinessCalendar_is_business_day(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date);
+
+/**
+ * Count the business days from @p first up to (but not including) @p end.
+ *
+ * Only the business days in the range of the calendar are counted (a date
+ * before the range counts as its first day, and a date after it as its end).
+ *
+ * @return The number of business days (negative if @p end is before
+ * @p first).
+ */
+PRESENT_API int_delta
+BusinessCalendar_business_days_between(
+        const struct BusinessCalendar * const self,
+        const struct Date * const first,
+        const struct Date * const end);
+
+/**
+ * Add a number of business days to a date.
+ *
+ * If @p count is positive, the result is the @p count'th business day after
+ * @p date; if it is negative, the result is the -@p count'th business day
+ * before @p date; and if it is 0, the result is @p date itself (even if it is
+ * not a business day).
+ *
+ * If @p date or the result is outside the range of the calendar, then the
+ * result has has_error and errors.day_out_of_range set.
+ */
+PRESENT_API struct Date
+BusinessCalendar_add_business_days(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date,
+        int_delta count);
+
+/**
+ * Adjust a date that is not a business day to a business day, according to a
+ * rule (a PRESENT_ADJUST_* value). Business days are not changed.
+ *
+ * If @p date or the result is outside the range of the calendar, then the
+ * result has has_error and errors.day_out_of_range set.
+ */
+PRESENT_API struct Date
+BusinessCalendar_adjust(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date,
+        int rule);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_BUSINESS_CALENDAR_H_ */
+
@@ -0,0 +1,228 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the ClockPage structure and declarations of the
+ * corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/time-delta.h"
+#include "present/timestamp.h"
+
+#ifndef _PRESENT_CLOCK_PAGE_H_
+#define _PRESENT_CLOCK_PAGE_H_
+
+/** The private state of the thread that publishes a ClockPage. */
+struct ClockPagePublisher;
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct for a page of shared memory that holds the current time,
+ * so that many processes can read the time without each of them calling
+ * clock_gettime.
+ *
+ * One process publishes the page: it creates the shared memory, and starts
+ * a thread that writes the time from CLOCK_REALTIME to it every interval
+ * (whichever clock source Timestamp_now() is using, so the page can itself be
+ * read through a clock source callback). Any process that opens
+ * the page can then read the last time that was written, with ClockPage_now,
+ * which makes no system calls and takes no locks (the time is protected by a
+ * sequence lock, so a reader only retries if it reads the page while it is
+ * being written). The time that is read is at most one interval old (as long
+ * as the publisher's thread is keeping up). The page also holds a heartbeat,
+ * so that readers can tell how long ago it was written (ClockPage_get_age),
+ * and so notice a publisher that was killed.
+ *
+ * The shared memory is created with shm_open (if it has a name, such as
+ * "/myapp-clock", which other processes can open it by) or with memfd_create
+ * (if it has no name; then it is shared with child processes, either through
+ * the mapping that fork copies, or through the file descriptor). A ClockPage
+ * is only supported where Present is compiled with POSIX shared memory,
+ * pthread support (PRESENT_USE_PTHREAD), and GCC-style atomic builtins;
+ * elsewhere, publishing and opening always fail.
+ *
+ * In C, a ClockPage must be initialized with ClockPage_init, and released
+ * with ClockPage_close. In C++, this is done by the constructor and the
+ * destructor.
+ */
+struct PRESENT_CLASS_API ClockPage {
+    /* The mapped shared memory (laid out in clock-page.c), or NULL if the
+       ClockPage is not open */
+    void * page_;
+    /* The file descriptor of the shared memory, or -1 if there is none */
+    int fd_;
+    /* The publisher's thread, or NULL if this ClockPage only reads */
+    struct ClockPagePublisher * publisher_;
+
+#ifdef __cplusplus
+    /** @copydoc ClockPage_init */
+    ClockPage();
+    /** @copydoc ClockPage_close */
+    ~ClockPage();
+
+    /** @copydoc ClockPage_publish */
+    bool publish(const char * name, const TimeDelta & interval);
+    /** @copydoc ClockPage_open */
+    bool open(const char * name);
+    /** @copydoc ClockPage_open_fd */
+    bool open_fd(int fd);
+    /** @copydoc ClockPage_close */
+    void close();
+
+    /** @copydoc ClockPage_is_open */
+    bool is_open() const;
+    /** @copydoc ClockPage_is_publishing */
+    bool is_publishing() const;
+    /** @copydoc ClockPage_get_fd */
+    int fd() const;
+    /** @copydoc ClockPage_get_interval */
+    TimeDelta interval() const;
+    /** @copydoc ClockPage_get_age */
+    TimeDelta age() const;
+
+    /** @copydoc ClockPage_now */
+    Timestamp now() const;
+
+private:
+    ClockPage(const ClockPage &);
+    ClockPage & operator=(const ClockPage &);
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize a ClockPage that is not open.
+ */
+PRESENT_API void
+ClockPage_init(struct ClockPage * const self);
+
+/**
+ * Create a ClockPage, and start a thread that writes the time from
+ * CLOCK_REALTIME to it every interval, until it is closed.
+ *
+ * If shared memory with the name already exists, it is only replaced if it
+ * was left behind by a publisher that is no longer writing to it (one that
+ * was closed, or whose heartbeat is more than 10 intervals, and more than a
+ * second, old). Publishers that find it stale at the same time take turns
+ * (with flock), so only one of them replaces it, and the others fail.
+ *
+ * @param name The name of the shared memory (starting with a slash, such as
+ * "/myapp-clock"), which is removed again when the ClockPage is closed; or
+ * NULL for shared memory without a name.
+ * @param interval How often to write the time (which must be positive), such
+ * as 100 microseconds.
+ * @return 1 if it was published, or 0 if another publisher is using the name,
+ * or the shared memory or the thread could not be created (in which case, the
+ * ClockPage is not open).
+ */
+PRESENT_API present_bool
+ClockPage_publish(
+        struct ClockPage * const self,
+        const char * name,
+        const struct TimeDelta * const interval);
+
+/**
+ * Open a ClockPage that another process published with a name.
+ *
+ * @return 1 if it was opened, or 0 if there is no ClockPage with that name
+ * (in which case, the ClockPage is not open).
+ */
+PRESENT_API present_bool
+ClockPage_open(struct ClockPage * const self, const char * name);
+
+/**
+ * Open a ClockPage from the file descriptor of its shared memory (see
+ * ClockPage_get_fd), such as one passed down to a child process. The
+ * ClockPage takes ownership of the file descriptor, and closes it when it is
+ * closed (even if it could not be opened).
+ *
+ * @return 1 if it was opened, or 0 if the file descriptor is not a
+ * ClockPage (in which case, the ClockPage is not open).
+ */
+PRESENT_API present_bool
+ClockPage_open_fd(struct ClockPage * const self, int fd);
+
+/**
+ * Close a ClockPage (or do nothing if it is not open).
+ *
+ * If this process published it, this stops the publisher's thread, and
+ * removes its name. Processes that still have it open can still read it, but
+ * the time in it no longer changes. (A child process that was forked from
+ * the publisher only unmaps its copy.)
+ */
+PRESENT_API void
+ClockPage_close(struct ClockPage * const self);
+
+/**
+ * Determine whether a ClockPage is open.
+ */
+PRESENT_API present_bool
+ClockPage_is_open(const struct ClockPage * const self);
+
+/**
+ * Determine whether the ClockPage that published an open ClockPage has not
+ * been closed.
+ *
+ * A publisher that was killed never closes its ClockPage, so this does not
+ * show that the time is still being updated; compare ClockPage_get_age with
+ * the interval for that.
+ */
+PRESENT_API present_bool
+ClockPage_is_publishing(const struct ClockPage * const self);
+
+/**
+ * Get the file descriptor of a ClockPage's shared memory, or -1 if there is
+ * none (it is not open, or its shared memory has no file descriptor).
+ */
+PRESENT_API int
+ClockPage_get_fd(const struct ClockPage * const self);
+
+/**
+ * Get how often the time in an open ClockPage is written (the most that the
+ * time read from it can be out of date by).
+ */
+PRESENT_API struct TimeDelta
+ClockPage_get_interval(const struct ClockPage * const self);
+
+/**
+ * Get how long ago the time in an open ClockPage was last written (by the
+ * monotonic clock). While the publisher's thread is keeping up, this is less
+ * than the interval (plus scheduling delays); if it keeps growing, the
+ * publisher has stopped.
+ */
+PRESENT_API struct TimeDelta
+ClockPage_get_age(const struct ClockPage * const self);
+
+/**
+ * Get the last time that was written to an open ClockPage, without any
+ * system calls or locks.
+ */
+PRESENT_API struct Timestamp
+ClockPage_now(const struct ClockPage * const self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_CLOCK_PAGE_H_ */
+
@@ -0,0 +1,134 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definitions of the clock sources that the current time can be read from,
+ * and declarations of the functions for selecting one
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/time-delta.h"
+#include "present/timestamp.h"
+
+#ifndef _PRESENT_CLOCK_SOURCE_H_
+#define _PRESENT_CLOCK_SOURCE_H_
+
+/**
+ * The clock sources that Timestamp_now() can read the current time from.
+ *
+ * PRESENT_CLOCK_SOURCE_REALTIME is CLOCK_REALTIME (the default), which is
+ * precise to the nanosecond (or as precise as the hardware is).
+ *
+ * PRESENT_CLOCK_SOURCE_REALTIME_COARSE is CLOCK_REALTIME_COARSE, which is
+ * only updated on each timer tick (usually every 1 to 4 milliseconds), but
+ * is several times cheaper to read, since it does not read the hardware
+ * clock at all. It is only available on Linux.
+ *
+ * PRESENT_CLOCK_SOURCE_CALLBACK is a function provided by the program (with
+ * ClockSource_set_callback).
+ *
+ * PRESENT_CLOCK_SOURCE_TSC reads the CPU's time stamp counter (with the
+ * @p rdtsc instruction), and scales it to nanoseconds with a multiply and a
+ * shift, which is cheaper still than reading CLOCK_REALTIME from the vDSO.
+ * It is calibrated against CLOCK_REALTIME when it is first selected (which
+ * takes about 10 milliseconds), and synced with CLOCK_REALTIME again once a
+ * second (by whichever read finds the last sync to be a second old), so it
+ * follows the system time; but between syncs, it may drift from the system
+ * time by up to a few microseconds. It is only available on x86 CPUs whose
+ * TSC is invariant (which Linux reports with the "constant_tsc" and
+ * "nonstop_tsc" flags in /proc/cpuinfo).
+ *
+ * Where clock_gettime is not supported, the realtime source falls back to
+ * the @p time function (which is only precise to the second).
+ */
+#define PRESENT_CLOCK_SOURCE_REALTIME           0
+#define PRESENT_CLOCK_SOURCE_REALTIME_COARSE    1
+#define PRESENT_CLOCK_SOURCE_CALLBACK           2
+#define PRESENT_CLOCK_SOURCE_TSC                3
+
+/**
+ * A function that reads the current time into @p result (for
+ * PRESENT_CLOCK_SOURCE_CALLBACK).
+ *
+ * Only the time in @p result is used (any errors that the function sets, or
+ * leaves uninitialized, are cleared, and nanoseconds of a second or more are
+ * carried into the seconds), so it may fill in @p result with any Timestamp
+ * function, or just set its seconds and nanoseconds.
+ *
+ * It may be called from any thread, at the same time, so it must be
+ * thread-safe.
+ */
+typedef void (*ClockSourceCallback)(struct Timestamp * const result);
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Select the clock source that Timestamp_now() reads the current time from
+ * (one of the PRESENT_CLOCK_SOURCE_... values, other than
+ * PRESENT_CLOCK_SOURCE_CALLBACK).
+ *
+ * The source is selected for every thread. Reading the current time does no
+ * locking (it only calls the source's function, through a pointer that is
+ * cached when the source is selected), so this should usually be done once,
+ * when the program starts; a thread that reads the time while another thread
+ * selects a source may read it from either source.
+ *
+ * @return 1 if the source was selected, or 0 if it is not available on this
+ * system (in which case, the selected source is not changed).
+ */
+PRESENT_API present_bool
+ClockSource_select(int source);
+
+/**
+ * Select PRESENT_CLOCK_SOURCE_CALLBACK, reading the current time with
+ * @p callback (which must not be NULL).
+ *
+ * @see ClockSource_select
+ */
+PRESENT_API void
+ClockSource_set_callback(ClockSourceCallback callback);
+
+/**
+ * Get the selected clock source (one of the PRESENT_CLOCK_SOURCE_...
+ * values).
+ */
+PRESENT_API int
+ClockSource_get(void);
+
+/**
+ * Determine whether a clock source (one of the PRESENT_CLOCK_SOURCE_...
+ * values) is available on this system. PRESENT_CLOCK_SOURCE_CALLBACK is
+ * always available.
+ */
+PRESENT_API present_bool
+ClockSource_is_available(int source);
+
+/**
+ * Get the resolution of a clock source (the smallest difference that it can
+ * tell between two readings), or zero if it is not known (such as for
+ * PRESENT_CLOCK_SOURCE_CALLBACK, or for a source that is not available).
+ */
+PRESENT_API struct TimeDelta
+ClockSource_resolution(int source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_CLOCK_SOURCE_H_ */
+
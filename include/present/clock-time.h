@@ -12,6 +12,7 @@
  * For details, see LICENSE.
  */
 
+#include <stddef.h>
 #include <time.h>
 
 #include "present/internal/cpp-guard.h"
@@ -40,7 +41,7 @@ struct TimeDelta;
  * There is no date information stored with the time, nor a time zone (so a
  * ClockTime instance is NOT tied to a specific time zone).
  */
-struct PRESENT_API ClockTime {
+struct PRESENT_CLASS_API ClockTime {
     /**
      * This will be true if there were any errors when creating this ClockTime.
      *
@@ -66,88 +67,135 @@ struct PRESENT_API ClockTime {
 
 #ifdef __cplusplus
     /** @copydoc ClockTime_from_hour */
-    static ClockTime create(int_hour hour);
+    static PRESENT_CONSTEXPR ClockTime create(int_hour hour);
 
     /** @copydoc ClockTime_from_hour_minute */
-    static ClockTime create(int_hour hour, int_minute minute);
+    static PRESENT_CONSTEXPR ClockTime create(
+            int_hour hour,
+            int_minute minute);
 
     /** @copydoc ClockTime_from_hour_minute_second */
-    static ClockTime create(
+    static PRESENT_CONSTEXPR ClockTime create(
             int_hour hour,
             int_minute minute,
             int_second second);
 
     /** @copydoc ClockTime_from_hour_minute_second_nanosecond */
-    static ClockTime create(
+    static PRESENT_CONSTEXPR ClockTime create(
             int_hour hour,
             int_minute minute,
             int_second second,
             int_nanosecond nanosecond);
 
+    /** @copydoc ClockTime_batch_from_hour_minute_second */
+    static size_t create_batch(
+            const int_hour * hours,
+            const int_minute * minutes,
+            const int_second * seconds,
+            ClockTime * results,
+            present_uint64 * error_mask,
+            size_t count);
+
     /** @copydoc ClockTime_create_with_decimal_seconds */
-    static ClockTime create_with_decimal_seconds(
+    static PRESENT_CONSTEXPR ClockTime create_with_decimal_seconds(
             int_hour hour,
             int_minute minute,
             double second);
 
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+    /**
+     * Create a ClockTime from a std::chrono::hh_mm_ss (if it is negative or
+     * is not within a day, the ClockTime will have hour_out_of_range set).
+     */
+    template <typename Duration>
+    static PRESENT_CONSTEXPR ClockTime create(
+            const std::chrono::hh_mm_ss<Duration> & hh_mm_ss);
+#endif
+
     /** @copydoc ClockTime_midnight */
-    static ClockTime midnight(void);
+    static PRESENT_CONSTEXPR ClockTime midnight(void);
 
     /** @copydoc ClockTime_noon */
-    static ClockTime noon();
+    static PRESENT_CONSTEXPR ClockTime noon();
 
     /** @copydoc ClockTime_hour */
-    int_hour hour() const;
+    PRESENT_CONSTEXPR int_hour hour() const;
 
     /** @copydoc ClockTime_minute */
-    int_minute minute() const;
+    PRESENT_CONSTEXPR int_minute minute() const;
 
     /** @copydoc ClockTime_second */
-    int_second second() const;
+    PRESENT_CONSTEXPR int_second second() const;
 
     /** @copydoc ClockTime_nanosecond */
-    int_nanosecond nanosecond() const;
+    PRESENT_CONSTEXPR int_nanosecond nanosecond() const;
 
     /** @copydoc ClockTime_second_decimal */
-    double second_decimal() const;
+    PRESENT_CONSTEXPR double second_decimal() const;
 
     /** @copydoc ClockTime_time_since_midnight */
-    TimeDelta time_since_midnight() const;
+    PRESENT_CONSTEXPR TimeDelta time_since_midnight() const;
+
+    /** @copydoc ClockTime_format */
+    size_t format(
+            const char * format,
+            char * buffer,
+            size_t buffer_size) const;
+
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+    /** Convert to a std::chrono::hh_mm_ss with nanosecond precision. */
+    PRESENT_CONSTEXPR std::chrono::hh_mm_ss<std::chrono::nanoseconds>
+    to_hh_mm_ss() const;
+#endif
 
     /** @copydoc ClockTime_add_TimeDelta */
-    ClockTime & operator+=(const TimeDelta & delta);
+    PRESENT_CONSTEXPR ClockTime & operator+=(const TimeDelta & delta);
     /** @copydoc ClockTime_subtract_TimeDelta */
-    ClockTime & operator-=(const TimeDelta & delta);
+    PRESENT_CONSTEXPR ClockTime & operator-=(const TimeDelta & delta);
 
     /** @see ClockTime::operator+=(const TimeDelta & delta) */
-    friend const ClockTime operator+(
+    friend PRESENT_CONSTEXPR const ClockTime operator+(
             const ClockTime & lhs,
             const TimeDelta & rhs);
     /** @see ClockTime::operator+=(const TimeDelta & delta) */
-    friend const ClockTime operator+(
+    friend PRESENT_CONSTEXPR const ClockTime operator+(
             const TimeDelta & lhs,
             const ClockTime & rhs);
 
     /** @see ClockTime::operator-=(const TimeDelta & delta) */
-    friend const ClockTime operator-(
+    friend PRESENT_CONSTEXPR const ClockTime operator-(
             const ClockTime & lhs,
             const TimeDelta & rhs);
 
     /** @copydoc ClockTime_compare */
-    static short compare(const ClockTime & lhs, const ClockTime & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const ClockTime & lhs,
+            const ClockTime & rhs);
 
     /** @copydoc ClockTime_equal */
-    friend bool operator==(const ClockTime & lhs, const ClockTime & rhs);
-    friend bool operator!=(const ClockTime & lhs, const ClockTime & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const ClockTime & lhs,
+            const ClockTime & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const ClockTime & lhs,
+            const ClockTime & rhs);
 
     /** @copydoc ClockTime_less_than */
-    friend bool operator<(const ClockTime & lhs, const ClockTime & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const ClockTime & lhs,
+            const ClockTime & rhs);
     /** @copydoc ClockTime_less_than_or_equal */
-    friend bool operator<=(const ClockTime & lhs, const ClockTime & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const ClockTime & lhs,
+            const ClockTime & rhs);
     /** @copydoc ClockTime_greater_than */
-    friend bool operator>(const ClockTime & lhs, const ClockTime & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const ClockTime & lhs,
+            const ClockTime & rhs);
     /** @copydoc ClockTime_greater_than_or_equal */
-    friend bool operator>=(const ClockTime & lhs, const ClockTime & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const ClockTime & lhs,
+            const ClockTime & rhs);
 #endif
 };
 
@@ -268,6 +316,36 @@ ClockTime_ptr_from_hour_minute_second_nanosecond(
         int_second second,
         int_nanosecond nanosecond);
 
+/**
+ * Create many ClockTime instances at once from parallel arrays of hours,
+ * minutes, and seconds.
+ *
+ * This is equivalent to calling ClockTime_ptr_from_hour_minute_second for
+ * each entry, but it reports the rejected entries in a compact bitmap, so the
+ * results do not have to be scanned for @p has_error afterwards.
+ *
+ * Entry i is rejected if bit (i % 64) of error_mask[i / 64] is set; the
+ * corresponding ClockTime in @p results has @p has_error and @p errors set
+ * just like with ClockTime_from_hour_minute_second.
+ *
+ * @param hours The hours of the day (@p count entries).
+ * @param minutes The minutes of the hour (@p count entries).
+ * @param seconds The seconds of the minute (@p count entries).
+ * @param[out] results An array of @p count struct ClockTime for the results.
+ * @param[out] error_mask An array of PRESENT_BATCH_MASK_WORDS(count) words
+ * for the bitmap of rejected entries, or NULL if it is not needed.
+ * @param count The number of entries.
+ * @return The number of rejected entries.
+ */
+PRESENT_API size_t
+ClockTime_batch_from_hour_minute_second(
+        const int_hour * const hours,
+        const int_minute * const minutes,
+        const int_second * const seconds,
+        struct ClockTime * const results,
+        present_uint64 * const error_mask,
+        size_t count);
+
 /**
  * Create a new ClockTime from either an hour (1 argument), an hour and a
  * minute (2 arguments), an hour/minute/second (3 arguments), or an
@@ -399,6 +477,33 @@ ClockTime_second_decimal(const struct ClockTime * const self);
 PRESENT_API struct TimeDelta
 ClockTime_time_since_midnight(const struct ClockTime * const self);
 
+/**
+ * Format a ClockTime as text, according to a strftime-like format string.
+ *
+ * The supported conversions are:
+ *
+ * - *\%H*: the hour (00 to 23)
+ * - *\%M*: the minute (00 to 59)
+ * - *\%S*: the second (00 to 60)
+ * - *\%f*: the nanoseconds after the second (9 digits)
+ * - *\%T*: the ISO 8601 time (equivalent to "\%H:\%M:\%S")
+ * - *\%R*: the hour and minute (equivalent to "\%H:\%M")
+ * - *\%\%*, *\%n*, *\%t*: a literal "%", newline, or tab
+ *
+ * @param format The format string.
+ * @param buffer The buffer to write the NUL-terminated result to.
+ * @param buffer_size The size of buffer (including room for the NUL).
+ * @return The number of characters written (not including the NUL), or 0 if
+ *         the format string is invalid or the result does not fit in the
+ *         buffer (like strftime).
+ */
+PRESENT_API size_t
+ClockTime_format(
+        const struct ClockTime * const self,
+        const char * const format,
+        char * const buffer,
+        size_t buffer_size);
+
 /**
  * Add a @ref TimeDelta to a ClockTime.
  *
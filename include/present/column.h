@@ -0,0 +1,722 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the DateColumn and TimestampColumn structures and
+ * declarations of the corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#ifndef _PRESENT_COLUMN_H_
+#define _PRESENT_COLUMN_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct Date;
+struct DayDelta;
+struct TimeDelta;
+struct Timestamp;
+
+/**
+ * Alignment (in bytes) of the arrays in a DateColumn or TimestampColumn.
+ *
+ * This is the size of a cache line on most processors, and is enough for the
+ * widest vector loads (AVX-512).
+ */
+#define PRESENT_COLUMN_ALIGNMENT 64
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct holding a growable column of dates, stored as a
+ * "structure of arrays".
+ *
+ * Rather than storing an array of struct Date (with all of its fields and
+ * padding), each date is stored as a single number of days since the UNIX
+ * epoch (January 1, 1970), in an array aligned to PRESENT_COLUMN_ALIGNMENT
+ * bytes. This makes the bulk operations (such as DateColumn_min and
+ * DateColumn_filter_range) simple loops over contiguous integers, which
+ * compilers can vectorize.
+ *
+ * In C, a DateColumn must be initialized with DateColumn_init, and released
+ * with DateColumn_destroy. In C++, this is done by the constructor and the
+ * destructor.
+ */
+struct PRESENT_CLASS_API DateColumn {
+    /*
+     * Days since the UNIX epoch of each date (size_ entries, with room for
+     * capacity_ entries). This may be read directly by code that implements
+     * its own bulk operations.
+     */
+    int_delta * days_;
+    size_t size_;
+    size_t capacity_;
+
+#ifdef __cplusplus
+    /** @copydoc DateColumn_init */
+    DateColumn();
+    DateColumn(const DateColumn & other);
+    DateColumn & operator=(const DateColumn & other);
+    /** @copydoc DateColumn_destroy */
+    ~DateColumn();
+
+    void swap(DateColumn & other);
+
+    /** The number of dates in the column. */
+    size_t size() const;
+    /** The number of dates that the column can hold without reallocating. */
+    size_t capacity() const;
+    /** Whether the column has no dates. */
+    bool empty() const;
+    /** The days since the UNIX epoch of each date (size() entries). */
+    const int_delta * days() const;
+
+    /**
+     * @copydoc DateColumn_reserve
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void reserve(size_t capacity);
+    /** @copydoc DateColumn_clear */
+    void clear();
+    /**
+     * @copydoc DateColumn_push_back
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void push_back(const Date & date);
+
+    /** @copydoc DateColumn_get */
+    Date operator[](size_t index) const;
+
+    /** @copydoc DateColumn_min */
+    Date min() const;
+    /** @copydoc DateColumn_max */
+    Date max() const;
+
+    /** @copydoc DateColumn_filter_range */
+    size_t filter_range(
+            const Date & low,
+            const Date & high,
+            size_t * selection) const;
+
+    /** @copydoc DateColumn_compare */
+    void compare(const Date & value, present_int8 * results) const;
+
+    /** @copydoc DateColumn_add_DayDelta */
+    DateColumn & operator+=(const DayDelta & delta);
+    /** @copydoc DateColumn_subtract_DayDelta */
+    DateColumn & operator-=(const DayDelta & delta);
+
+    /**
+     * @copydoc DateColumn_sort
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void sort(size_t * permutation = NULL);
+    /**
+     * @copydoc DateColumn_sort_parallel
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void sort_parallel(unsigned int thread_count, size_t * permutation = NULL);
+    /** @copydoc DateColumn_unique */
+    size_t unique();
+#endif
+};
+
+/**
+ * Class or struct holding a growable column of timestamps, stored as a
+ * "structure of arrays".
+ *
+ * Rather than storing an array of struct Timestamp (where the seconds and
+ * nanoseconds of each timestamp are interleaved with @p has_error and its
+ * padding), the seconds and the nanoseconds are each stored in their own
+ * array, aligned to PRESENT_COLUMN_ALIGNMENT bytes. This makes the bulk
+ * operations (such as TimestampColumn_min and TimestampColumn_add_TimeDelta)
+ * simple loops over contiguous integers, which compilers can vectorize.
+ *
+ * In C, a TimestampColumn must be initialized with TimestampColumn_init, and
+ * released with TimestampColumn_destroy. In C++, this is done by the
+ * constructor and the destructor.
+ */
+struct PRESENT_CLASS_API TimestampColumn {
+    /*
+     * UNIX timestamp (seconds since 01/01/1970 00:00 UTC) of each timestamp
+     * (size_ entries, with room for capacity_ entries)
+     */
+    int_timestamp * seconds_;
+    /*
+     * Supplement to each timestamp (always from 0 to 999,999,999, inclusive)
+     */
+    int_timestamp * nanoseconds_;
+    size_t size_;
+    size_t capacity_;
+
+#ifdef __cplusplus
+    /** @copydoc TimestampColumn_init */
+    TimestampColumn();
+    TimestampColumn(const TimestampColumn & other);
+    TimestampColumn & operator=(const TimestampColumn & other);
+    /** @copydoc TimestampColumn_destroy */
+    ~TimestampColumn();
+
+    void swap(TimestampColumn & other);
+
+    /** The number of timestamps in the column. */
+    size_t size() const;
+    /**
+     * The number of timestamps that the column can hold without
+     * reallocating.
+     */
+    size_t capacity() const;
+    /** Whether the column has no timestamps. */
+    bool empty() const;
+    /** The UNIX timestamp (in seconds) of each timestamp (size() entries). */
+    const int_timestamp * seconds() const;
+    /** The nanoseconds supplement of each timestamp (size() entries). */
+    const int_timestamp * nanoseconds() const;
+
+    /**
+     * @copydoc TimestampColumn_reserve
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void reserve(size_t capacity);
+    /** @copydoc TimestampColumn_clear */
+    void clear();
+    /**
+     * @copydoc TimestampColumn_push_back
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void push_back(const Timestamp & timestamp);
+
+    /** @copydoc TimestampColumn_get */
+    Timestamp operator[](size_t index) const;
+
+    /** @copydoc TimestampColumn_min */
+    Timestamp min() const;
+    /** @copydoc TimestampColumn_max */
+    Timestamp max() const;
+
+    /** @copydoc TimestampColumn_filter_range */
+    size_t filter_range(
+            const Timestamp & low,
+            const Timestamp & high,
+            size_t * selection) const;
+
+    /** @copydoc TimestampColumn_compare */
+    void compare(const Timestamp & value, present_int8 * results) const;
+
+    /** @copydoc TimestampColumn_add_TimeDelta */
+    TimestampColumn & operator+=(const TimeDelta & delta);
+    /** @copydoc TimestampColumn_subtract_TimeDelta */
+    TimestampColumn & operator-=(const TimeDelta & delta);
+
+    /**
+     * @copydoc TimestampColumn_sort
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void sort(size_t * permutation = NULL);
+    /**
+     * @copydoc TimestampColumn_sort_parallel
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void sort_parallel(unsigned int thread_count, size_t * permutation = NULL);
+    /** @copydoc TimestampColumn_unique */
+    size_t unique();
+
+    /**
+     * @copydoc TimestampColumn_get_date_column
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    DateColumn get_date_column(const TimeDelta & time_zone_offset) const;
+    /**
+     * @copydoc TimestampColumn_get_date_column_utc
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    DateColumn get_date_column_utc() const;
+
+    /** @copydoc TimestampColumn_truncate */
+    void truncate(int unit, const TimeDelta & time_zone_offset);
+    /** @copydoc TimestampColumn_truncate_utc */
+    void truncate_utc(int unit);
+    /** @copydoc TimestampColumn_bucket */
+    void bucket(const TimeDelta & width, const Timestamp & origin);
+    /** @copydoc TimestampColumn_get_windows */
+    void get_windows(
+            const TimeDelta & size,
+            const TimeDelta & hop,
+            const Timestamp & origin,
+            int_delta * first,
+            int_delta * last) const;
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize an empty DateColumn (without allocating any memory).
+ *
+ * @param[out] self The DateColumn to initialize.
+ */
+PRESENT_API void
+DateColumn_init(struct DateColumn * const self);
+
+/**
+ * Release the memory used by a DateColumn. Afterwards, it is empty (as if it
+ * was just initialized with DateColumn_init).
+ */
+PRESENT_API void
+DateColumn_destroy(struct DateColumn * const self);
+
+/**
+ * Make sure that a DateColumn has room for at least @p capacity dates.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+DateColumn_reserve(struct DateColumn * const self, size_t capacity);
+
+/**
+ * Replace the contents of a DateColumn with a copy of another DateColumn.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+DateColumn_assign(
+        struct DateColumn * const self,
+        const struct DateColumn * const other);
+
+/**
+ * Remove all the dates from a DateColumn (without releasing its memory).
+ */
+PRESENT_API void
+DateColumn_clear(struct DateColumn * const self);
+
+/**
+ * Add a date to the end of a DateColumn.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+DateColumn_push_back(
+        struct DateColumn * const self,
+        const struct Date * const date);
+
+/**
+ * Get the date at an index of a DateColumn.
+ *
+ * Precondition: @p index must be less than the size of the column.
+ */
+PRESENT_API struct Date
+DateColumn_get(const struct DateColumn * const self, size_t index);
+
+/**
+ * Get the earliest date in a DateColumn.
+ *
+ * Precondition: The column must not be empty.
+ */
+PRESENT_API struct Date
+DateColumn_min(const struct DateColumn * const self);
+
+/**
+ * Get the latest date in a DateColumn.
+ *
+ * Precondition: The column must not be empty.
+ */
+PRESENT_API struct Date
+DateColumn_max(const struct DateColumn * const self);
+
+/**
+ * Find the dates in a DateColumn that are on or after @p low, and before
+ * @p high.
+ *
+ * The indexes of those dates are written, in increasing order, to the start
+ * of @p selection (a "selection vector" that can be used to look up the
+ * matching rows in other columns).
+ *
+ * @param[out] selection An array with room for as many indexes as there are
+ * dates in the column.
+ * @return The number of indexes written to @p selection.
+ */
+PRESENT_API size_t
+DateColumn_filter_range(
+        const struct DateColumn * const self,
+        const struct Date * const low,
+        const struct Date * const high,
+        size_t * const selection);
+
+/**
+ * Compare each date in a DateColumn to a single Date.
+ *
+ * @param[out] results An array with room for as many results as there are
+ * dates in the column. Each result is negative, 0, or positive (like
+ * Date_compare) if the date in the column is before, the same as, or after
+ * @p value.
+ */
+PRESENT_API void
+DateColumn_compare(
+        const struct DateColumn * const self,
+        const struct Date * const value,
+        present_int8 * const results);
+
+/**
+ * Add a DayDelta to every date in a DateColumn.
+ */
+PRESENT_API void
+DateColumn_add_DayDelta(
+        struct DateColumn * const self,
+        const struct DayDelta * const delta);
+
+/**
+ * Subtract a DayDelta from every date in a DateColumn.
+ */
+PRESENT_API void
+DateColumn_subtract_DayDelta(
+        struct DateColumn * const self,
+        const struct DayDelta * const delta);
+
+/**
+ * Sort the dates in a DateColumn, from earliest to latest.
+ *
+ * This is a radix sort on the days since the UNIX epoch, which takes a
+ * constant number of passes over the column (usually 3 or 4, since the
+ * digits that are the same for every date are skipped) rather than
+ * O(n log n) comparisons.
+ *
+ * @param[out] permutation An array with room for as many indexes as there
+ * are dates in the column, or NULL. If it is not NULL, then each entry is set
+ * to the index (before sorting) of the date that is now at that position, so
+ * that other columns (or any other values that go along with the dates) can
+ * be rearranged to match. Equal dates keep their original order.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+DateColumn_sort(struct DateColumn * const self, size_t * const permutation);
+
+/**
+ * Sort the dates in a DateColumn, like DateColumn_sort, using up to
+ * @p thread_count threads.
+ *
+ * Each pass of the sort is split between the threads (as long as each thread
+ * gets enough dates to make it worthwhile). If Present was compiled without
+ * pthread support, this is the same as DateColumn_sort.
+ */
+PRESENT_API present_bool
+DateColumn_sort_parallel(
+        struct DateColumn * const self,
+        size_t * const permutation,
+        unsigned int thread_count);
+
+/**
+ * Remove the repeated dates from a sorted DateColumn (keeping the first of
+ * each run of equal dates).
+ *
+ * Precondition: The column must be sorted (see DateColumn_sort).
+ *
+ * @return The new size of the column.
+ */
+PRESENT_API size_t
+DateColumn_unique(struct DateColumn * const self);
+
+/**
+ * Initialize an empty TimestampColumn (without allocating any memory).
+ *
+ * @param[out] self The TimestampColumn to initialize.
+ */
+PRESENT_API void
+TimestampColumn_init(struct TimestampColumn * const self);
+
+/**
+ * Release the memory used by a TimestampColumn. Afterwards, it is empty (as
+ * if it was just initialized with TimestampColumn_init).
+ */
+PRESENT_API void
+TimestampColumn_destroy(struct TimestampColumn * const self);
+
+/**
+ * Make sure that a TimestampColumn has room for at least @p capacity
+ * timestamps.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+TimestampColumn_reserve(struct TimestampColumn * const self, size_t capacity);
+
+/**
+ * Replace the contents of a TimestampColumn with a copy of another
+ * TimestampColumn.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+TimestampColumn_assign(
+        struct TimestampColumn * const self,
+        const struct TimestampColumn * const other);
+
+/**
+ * Remove all the timestamps from a TimestampColumn (without releasing its
+ * memory).
+ */
+PRESENT_API void
+TimestampColumn_clear(struct TimestampColumn * const self);
+
+/**
+ * Add a timestamp to the end of a TimestampColumn.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+TimestampColumn_push_back(
+        struct TimestampColumn * const self,
+        const struct Timestamp * const timestamp);
+
+/**
+ * Get the timestamp at an index of a TimestampColumn.
+ *
+ * Precondition: @p index must be less than the size of the column.
+ */
+PRESENT_API struct Timestamp
+TimestampColumn_get(const struct TimestampColumn * const self, size_t index);
+
+/**
+ * Get the earliest timestamp in a TimestampColumn.
+ *
+ * Precondition: The column must not be empty.
+ */
+PRESENT_API struct Timestamp
+TimestampColumn_min(const struct TimestampColumn * const self);
+
+/**
+ * Get the latest timestamp in a TimestampColumn.
+ *
+ * Precondition: The column must not be empty.
+ */
+PRESENT_API struct Timestamp
+TimestampColumn_max(const struct TimestampColumn * const self);
+
+/**
+ * Find the timestamps in a TimestampColumn that are at or after @p low, and
+ * before @p high.
+ *
+ * The indexes of those timestamps are written, in increasing order, to the
+ * start of @p selection (a "selection vector" that can be used to look up the
+ * matching rows in other columns).
+ *
+ * @param[out] selection An array with room for as many indexes as there are
+ * timestamps in the column.
+ * @return The number of indexes written to @p selection.
+ */
+PRESENT_API size_t
+TimestampColumn_filter_range(
+        const struct TimestampColumn * const self,
+        const struct Timestamp * const low,
+        const struct Timestamp * const high,
+        size_t * const selection);
+
+/**
+ * Compare each timestamp in a TimestampColumn to a single Timestamp.
+ *
+ * @param[out] results An array with room for as many results as there are
+ * timestamps in the column. Each result is negative, 0, or positive (like
+ * Timestamp_compare) if the timestamp in the column is before, the same as,
+ * or after @p value.
+ */
+PRESENT_API void
+TimestampColumn_compare(
+        const struct TimestampColumn * const self,
+        const struct Timestamp * const value,
+        present_int8 * const results);
+
+/**
+ * Add a TimeDelta to every timestamp in a TimestampColumn.
+ */
+PRESENT_API void
+TimestampColumn_add_TimeDelta(
+        struct TimestampColumn * const self,
+        const struct TimeDelta * const delta);
+
+/**
+ * Subtract a TimeDelta from every timestamp in a TimestampColumn.
+ */
+PRESENT_API void
+TimestampColumn_subtract_TimeDelta(
+        struct TimestampColumn * const self,
+        const struct TimeDelta * const delta);
+
+/**
+ * Sort the timestamps in a TimestampColumn, from earliest to latest.
+ *
+ * This is a radix sort on a 94-bit key (the seconds, followed by the 30 bits
+ * of the nanoseconds), which takes a constant number of passes over the
+ * column (the digits that are the same for every timestamp are skipped)
+ * rather than O(n log n) comparisons.
+ *
+ * @param[out] permutation An array with room for as many indexes as there
+ * are timestamps in the column, or NULL. If it is not NULL, then each entry
+ * is set to the index (before sorting) of the timestamp that is now at that
+ * position, so that other columns (or any other values that go along with
+ * the timestamps) can be rearranged to match. Equal timestamps keep their
+ * original order.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the column is unchanged).
+ */
+PRESENT_API present_bool
+TimestampColumn_sort(
+        struct TimestampColumn * const self,
+        size_t * const permutation);
+
+/**
+ * Sort the timestamps in a TimestampColumn, like TimestampColumn_sort, using
+ * up to @p thread_count threads.
+ *
+ * Each pass of the sort is split between the threads (as long as each thread
+ * gets enough timestamps to make it worthwhile). If Present was compiled
+ * without pthread support, this is the same as TimestampColumn_sort.
+ */
+PRESENT_API present_bool
+TimestampColumn_sort_parallel(
+        struct TimestampColumn * const self,
+        size_t * const permutation,
+        unsigned int thread_count);
+
+/**
+ * Remove the repeated timestamps from a sorted TimestampColumn (keeping the
+ * first of each run of equal timestamps).
+ *
+ * Precondition: The column must be sorted (see TimestampColumn_sort).
+ *
+ * @return The new size of the column.
+ */
+PRESENT_API size_t
+TimestampColumn_unique(struct TimestampColumn * const self);
+
+/**
+ * Get the date of each timestamp in a TimestampColumn, in a time zone with
+ * the given offset from UTC.
+ *
+ * @param time_zone_offset The offset of the time zone from UTC.
+ * @param[out] result An initialized DateColumn whose contents are replaced
+ * with the dates.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case @p result is unchanged).
+ */
+PRESENT_API present_bool
+TimestampColumn_get_date_column(
+        const struct TimestampColumn * const self,
+        const struct TimeDelta * const time_zone_offset,
+        struct DateColumn * const result);
+
+/**
+ * Get the date of each timestamp in a TimestampColumn, in UTC.
+ *
+ * @param[out] result An initialized DateColumn whose contents are replaced
+ * with the dates.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case @p result is unchanged).
+ */
+PRESENT_API present_bool
+TimestampColumn_get_date_column_utc(
+        const struct TimestampColumn * const self,
+        struct DateColumn * const result);
+
+/**
+ * Replace every timestamp in a TimestampColumn with the start of the calendar
+ * unit that it is in, in a certain time zone (represented by an offset from
+ * UTC), like Timestamp_truncate.
+ *
+ * The units up to PRESENT_TRUNCATE_WEEK are done with TimestampColumn_bucket
+ * (see there), and the longer ones one timestamp at a time.
+ *
+ * @param unit One of the PRESENT_TRUNCATE_* constants.
+ */
+PRESENT_API void
+TimestampColumn_truncate(
+        struct TimestampColumn * const self,
+        int unit,
+        const struct TimeDelta * const time_zone_offset);
+
+/**
+ * Replace every timestamp in a TimestampColumn with the start of the calendar
+ * unit that it is in, in Coordinated Universal Time.
+ *
+ * @see TimestampColumn_truncate
+ */
+PRESENT_API void
+TimestampColumn_truncate_utc(struct TimestampColumn * const self, int unit);
+
+/**
+ * Replace every timestamp in a TimestampColumn with the start of the
+ * fixed-width bucket that it is in, like Timestamp_bucket.
+ *
+ * As long as every timestamp is within about 17 million years of
+ * @p origin (or, for widths that are not a whole number of seconds, within
+ * about 146 years, and with a width of less than about 13 days), this is a
+ * loop without branches or integer division that compilers can vectorize.
+ * It estimates each bucket with a floating-point multiplication by the
+ * reciprocal of the width, and then corrects the estimate exactly with
+ * integers. Otherwise, each timestamp is done with Timestamp_bucket.
+ *
+ * Precondition: @p width must be positive.
+ */
+PRESENT_API void
+TimestampColumn_bucket(
+        struct TimestampColumn * const self,
+        const struct TimeDelta * const width,
+        const struct Timestamp * const origin);
+
+/**
+ * Find the hopping (or sliding) windows that each timestamp in a
+ * TimestampColumn is in, like Timestamp_get_windows.
+ *
+ * Like TimestampColumn_bucket, this is a loop that compilers can vectorize
+ * (as long as the timestamps are close enough to @p origin).
+ *
+ * Preconditions: @p size and @p hop must be positive.
+ *
+ * @param[out] first An array with room for as many window numbers as there
+ * are timestamps in the column, which is set to the first window that each
+ * timestamp is in.
+ * @param[out] last An array with room for as many window numbers as there
+ * are timestamps in the column, which is set to the last window that each
+ * timestamp is in.
+ */
+PRESENT_API void
+TimestampColumn_get_windows(
+        const struct TimestampColumn * const self,
+        const struct TimeDelta * const size,
+        const struct TimeDelta * const hop,
+        const struct Timestamp * const origin,
+        int_delta * const first,
+        int_delta * const last);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_COLUMN_H_ */
+
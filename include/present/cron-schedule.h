@@ -0,0 +1,197 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the CronSchedule structure and declarations of the
+ * corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/time-delta.h"
+#include "present/timestamp.h"
+
+#ifndef _PRESENT_CRON_SCHEDULE_H_
+#define _PRESENT_CRON_SCHEDULE_H_
+
+/*
+ * C++ Class / C Struct Definition
+ */
+
+/**
+ * Class or struct representing a cron schedule: the times (to the second)
+ * that match a cron expression such as "30 9 * * MON-FRI".
+ *
+ * The expression is compiled into a bit mask for each field. The next (or
+ * previous) time that matches is found by scanning the masks for the next
+ * (or previous) set bit, from the month down to the second, rather than by
+ * stepping through the times one minute at a time; this takes a handful of
+ * steps, however far away the time is.
+ *
+ * The schedule is in a fixed time zone offset (or UTC). Since there is no
+ * time zone database, daylight saving time is not taken into account.
+ */
+struct PRESENT_CLASS_API CronSchedule {
+    /**
+     * This will be true if there were any errors when creating this
+     * CronSchedule.
+     *
+     * @copydoc has_error_epilogue
+     */
+    present_bool has_error;
+
+    /**
+     * If there were any errors when creating this CronSchedule, then one or
+     * more of these fields will be set.
+     *
+     * @copydoc errors_epilogue
+     */
+    struct {
+        unsigned int invalid_expression : 1,
+                     never_matches      : 1;
+    } errors;
+
+    /* The seconds (bit 0 to 59), minutes (bit 0 to 59), hours (bit 0 to 23),
+       days of the month (bit 1 to 31), months (bit 1 to 12), and days of
+       the week (bit 0 for Sunday to 6 for Saturday) */
+    present_uint64 seconds_;
+    present_uint64 minutes_;
+    present_uint32 hours_;
+    present_uint32 days_of_month_;
+    present_uint32 months_;
+    unsigned int days_of_week_;
+    /* Whether a day matches if either its day of the month or its day of the
+       week matches (when neither field starts with "*"), rather than both */
+    present_bool day_or_;
+    /* The time zone offset of the schedule */
+    struct TimeDelta time_zone_offset_;
+
+#ifdef __cplusplus
+    /** @copydoc CronSchedule_from_expression */
+    static CronSchedule create(
+            const char * expression,
+            const TimeDelta & time_zone_offset);
+    /** @copydoc CronSchedule_from_expression_utc */
+    static CronSchedule create_utc(const char * expression);
+
+    /** @copydoc CronSchedule_matches */
+    bool matches(const Timestamp & timestamp) const;
+    /** @copydoc CronSchedule_next_after */
+    Timestamp next_after(const Timestamp & timestamp) const;
+    /** @copydoc CronSchedule_prev_before */
+    Timestamp prev_before(const Timestamp & timestamp) const;
+
+    /** @copydoc CronSchedule_batch_next_after */
+    static void next_after_batch(
+            const CronSchedule * schedules,
+            const Timestamp & timestamp,
+            Timestamp * results,
+            size_t count);
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a new CronSchedule from a cron expression, in a time zone offset.
+ *
+ * The expression has 5 fields (minute, hour, day of the month, month, and
+ * day of the week), or 6 fields with the second first. Each field is "*", or
+ * a list of values and ranges separated by commas, where a value is a number
+ * (or a 3-letter name, for the months and the days of the week), a range is
+ * 2 values separated by "-", and either "*" or a range may be followed by
+ * "/" and a step. A value followed by a step runs to the end of the field's
+ * range. The day of the week is 0 (or 7) for Sunday through 6 for Saturday.
+ * "?" is the same as "*".
+ *
+ * As in the traditional cron, if neither the day of the month nor the day of
+ * the week starts with "*", a day matches if either one matches.
+ *
+ * The expression may instead be one of "@yearly" (or "@annually"),
+ * "@monthly", "@weekly", "@daily" (or "@midnight"), and "@hourly".
+ *
+ * If the expression cannot be parsed, the CronSchedule will have
+ * @p has_error and @p errors.invalid_expression set. If no date could ever
+ * match it (such as February 30), it will have @p errors.never_matches set.
+ */
+PRESENT_API struct CronSchedule
+CronSchedule_from_expression(
+        const char * const expression,
+        const struct TimeDelta * const time_zone_offset);
+
+/**
+ * Create a new CronSchedule from a cron expression, in UTC.
+ *
+ * @copydetails CronSchedule_from_expression
+ */
+PRESENT_API struct CronSchedule
+CronSchedule_from_expression_utc(const char * const expression);
+
+/**
+ * Determine whether the second that contains a Timestamp matches a
+ * (non-erroneous) CronSchedule. With a 5-field expression, only the first
+ * second of a minute can match.
+ */
+PRESENT_API present_bool
+CronSchedule_matches(
+        const struct CronSchedule * const self,
+        const struct Timestamp * const timestamp);
+
+/**
+ * Get the first time after a Timestamp (not including the Timestamp itself)
+ * that matches a (non-erroneous) CronSchedule.
+ */
+PRESENT_API struct Timestamp
+CronSchedule_next_after(
+        const struct CronSchedule * const self,
+        const struct Timestamp * const timestamp);
+
+/**
+ * Get the last time before a Timestamp (not including the Timestamp itself)
+ * that matches a (non-erroneous) CronSchedule.
+ */
+PRESENT_API struct Timestamp
+CronSchedule_prev_before(
+        const struct CronSchedule * const self,
+        const struct Timestamp * const timestamp);
+
+/**
+ * Get the next time after the same Timestamp for each of an array of
+ * (non-erroneous) CronSchedules, as with CronSchedule_next_after.
+ *
+ * The Timestamp is only split into a date and a time of day once for each
+ * run of schedules in the same time zone offset.
+ *
+ * @param schedules The schedules (@p count entries).
+ * @param[out] results An array of @p count struct Timestamp for the results.
+ * @param count The number of schedules.
+ */
+PRESENT_API void
+CronSchedule_batch_next_after(
+        const struct CronSchedule * const schedules,
+        const struct Timestamp * const timestamp,
+        struct Timestamp * const results,
+        size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_CRON_SCHEDULE_H_ */
+
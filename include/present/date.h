@@ -12,6 +12,7 @@
  * For details, see LICENSE.
  */
 
+#include <stddef.h>
 #include <time.h>
 
 #include "present/internal/cpp-guard.h"
@@ -56,7 +57,7 @@ struct PresentWeekYear {
  * This includes a year, a month, and a day. There is no time-of-day stored
  * with the date, nor a time zone.
  */
-struct PRESENT_API Date {
+struct PRESENT_CLASS_API Date {
     /**
      * This will be true if there were any errors when creating this Date.
      *
@@ -82,88 +83,199 @@ struct PRESENT_API Date {
 
 #ifdef __cplusplus
     /** @copydoc Date_from_year */
-    static Date create(int_year year);
+    static PRESENT_CONSTEXPR Date create(int_year year);
 
     /** @copydoc Date_from_year_month */
-    static Date create(int_year year, int_month month);
+    static PRESENT_CONSTEXPR Date create(int_year year, int_month month);
 
     /** @copydoc Date_from_year_month_day */
-    static Date create(int_year year, int_month month, int_day day);
+    static PRESENT_CONSTEXPR Date create(
+            int_year year,
+            int_month month,
+            int_day day);
+
+    /** @copydoc Date_batch_from_year_month_day */
+    static size_t create_batch(
+        const int_year * years,
+        const int_month * months,
+        const int_day * days,
+        Date * results,
+        present_uint64 * error_mask,
+        size_t count);
 
     /** @copydoc Date_from_year_day */
-    static Date from_year_day(
+    static PRESENT_CONSTEXPR Date from_year_day(
         int_year year,
         int_day_of_year day_of_year);
 
     /** @copydoc Date_from_year_week_day */
-    static Date from_year_week_day(
+    static PRESENT_CONSTEXPR Date from_year_week_day(
         int_year year,
         int_week_of_year week_of_year,
         int_day_of_week day_of_week);
 
+    /** @copydoc Date_nth_weekday_of_month */
+    static PRESENT_CONSTEXPR Date nth_weekday_of_month(
+        int_year year,
+        int_month month,
+        int_day_of_week day_of_week,
+        int n);
+
+    /** @copydoc Date_batch_nth_weekday_of_month */
+    static size_t nth_weekday_of_month_batch(
+        const int_year * years,
+        const int_month * months,
+        int_day_of_week day_of_week,
+        int n,
+        Date * results,
+        present_uint64 * error_mask,
+        size_t count);
+
+    /** @copydoc Date_batch_last_day_of_month */
+    static size_t last_day_of_month_batch(
+        const int_year * years,
+        const int_month * months,
+        Date * results,
+        present_uint64 * error_mask,
+        size_t count);
+
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+    /**
+     * Create a Date from a std::chrono::year_month_day (if it is not ok(),
+     * the errors are set just like with Date::create).
+     */
+    static PRESENT_CONSTEXPR Date create(
+            const std::chrono::year_month_day & year_month_day);
+    /** Create a Date from a std::chrono::sys_days (days since the epoch). */
+    static PRESENT_CONSTEXPR Date create(const std::chrono::sys_days & days);
+#endif
+
     /** @copydoc Date_year */
-    int_year year() const;
+    PRESENT_CONSTEXPR int_year year() const;
 
     /** @copydoc Date_month */
-    int_month month() const;
+    PRESENT_CONSTEXPR int_month month() const;
 
     /** @copydoc Date_day */
-    int_day day() const;
+    PRESENT_CONSTEXPR int_day day() const;
 
     /** @copydoc Date_day_of_year */
-    int_day_of_year day_of_year() const;
+    PRESENT_CONSTEXPR int_day_of_year day_of_year() const;
 
     /** @copydoc Date_week_of_year */
-    PresentWeekYear week_of_year() const;
+    PRESENT_CONSTEXPR PresentWeekYear week_of_year() const;
 
     /** @copydoc Date_day_of_week */
-    int_day_of_week day_of_week() const;
+    PRESENT_CONSTEXPR int_day_of_week day_of_week() const;
+
+    /** @copydoc Date_days_in_month */
+    PRESENT_CONSTEXPR int_day days_in_month() const;
+
+    /** @copydoc Date_last_day_of_month */
+    PRESENT_CONSTEXPR Date last_day_of_month() const;
+
+    /** @copydoc Date_count_weekday_between */
+    static PRESENT_CONSTEXPR int_delta count_weekday_between(
+            const Date & first,
+            const Date & end,
+            int_day_of_week day_of_week);
+
+    /** @copydoc Date_batch_count_weekday_between */
+    static void count_weekday_between_batch(
+            const Date * firsts,
+            const Date * ends,
+            int_day_of_week day_of_week,
+            int_delta * results,
+            size_t count);
+
+    /** @copydoc Date_format */
+    size_t format(
+            const char * format,
+            char * buffer,
+            size_t buffer_size) const;
+
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+    /** Convert to a std::chrono::year_month_day. */
+    PRESENT_CONSTEXPR std::chrono::year_month_day to_year_month_day() const;
+    /** Convert to a std::chrono::sys_days (days since the epoch). */
+    PRESENT_CONSTEXPR std::chrono::sys_days to_sys_days() const;
+#endif
 
     /** @copydoc Date_difference */
-    DayDelta difference(const Date & other) const;
+    PRESENT_CONSTEXPR DayDelta difference(const Date & other) const;
     /** @copydoc Date_absolute_difference */
-    DayDelta absolute_difference(const Date & other) const;
+    PRESENT_CONSTEXPR DayDelta absolute_difference(const Date & other) const;
 
     /** @copydoc Date_add_DayDelta */
-    Date & operator+=(const DayDelta & delta);
+    PRESENT_CONSTEXPR Date & operator+=(const DayDelta & delta);
     /** @copydoc Date_add_MonthDelta */
-    Date & operator+=(const MonthDelta & delta);
+    PRESENT_CONSTEXPR Date & operator+=(const MonthDelta & delta);
     /** @copydoc Date_subtract_DayDelta */
-    Date & operator-=(const DayDelta & delta);
+    PRESENT_CONSTEXPR Date & operator-=(const DayDelta & delta);
     /** @copydoc Date_subtract_MonthDelta */
-    Date & operator-=(const MonthDelta & delta);
+    PRESENT_CONSTEXPR Date & operator-=(const MonthDelta & delta);
 
     /** @see Date::operator+=(const DayDelta & delta) */
-    friend const Date operator+(const Date & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR const Date operator+(
+            const Date & lhs,
+            const DayDelta & rhs);
     /** @see Date::operator+=(const DayDelta & delta) */
-    friend const Date operator+(const DayDelta & lhs, const Date & rhs);
+    friend PRESENT_CONSTEXPR const Date operator+(
+            const DayDelta & lhs,
+            const Date & rhs);
 
     /** @see Date::operator+=(const MonthDelta & delta) */
-    friend const Date operator+(const Date & lhs, const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR const Date operator+(
+            const Date & lhs,
+            const MonthDelta & rhs);
     /** @see Date::operator+=(const MonthDelta & delta) */
-    friend const Date operator+(const MonthDelta & lhs, const Date & rhs);
+    friend PRESENT_CONSTEXPR const Date operator+(
+            const MonthDelta & lhs,
+            const Date & rhs);
 
     /** @see Date::operator-=(const DayDelta & delta) */
-    friend const Date operator-(const Date & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR const Date operator-(
+            const Date & lhs,
+            const DayDelta & rhs);
 
     /** @see Date::operator-=(const MonthDelta & delta) */
-    friend const Date operator-(const Date & lhs, const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR const Date operator-(
+            const Date & lhs,
+            const MonthDelta & rhs);
 
     /** @copydoc Date_compare */
-    static short compare(const Date & lhs, const Date & rhs);
+    static PRESENT_CONSTEXPR short compare(const Date & lhs, const Date & rhs);
+
+    /**
+     * @copydoc Date_sort
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    static void sort(Date * dates, size_t count);
 
     /** @copydoc Date_equal */
-    friend bool operator==(const Date & lhs, const Date & rhs);
-    friend bool operator!=(const Date & lhs, const Date & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const Date & lhs,
+            const Date & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const Date & lhs,
+            const Date & rhs);
 
     /** @copydoc Date_less_than */
-    friend bool operator<(const Date & lhs, const Date & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const Date & lhs,
+            const Date & rhs);
     /** @copydoc Date_less_than_or_equal */
-    friend bool operator<=(const Date & lhs, const Date & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const Date & lhs,
+            const Date & rhs);
     /** @copydoc Date_greater_than */
-    friend bool operator>(const Date & lhs, const Date & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const Date & lhs,
+            const Date & rhs);
     /** @copydoc Date_greater_than_or_equal */
-    friend bool operator>=(const Date & lhs, const Date & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const Date & lhs,
+            const Date & rhs);
 #endif
 };
 
@@ -243,6 +355,39 @@ Date_ptr_from_year_month_day(
         int_month month,
         int_day day);
 
+/**
+ * Create many Date instances at once from parallel arrays of years, months,
+ * and days.
+ *
+ * This is equivalent to calling Date_ptr_from_year_month_day for each entry,
+ * but it skips the per-Date calls into the C standard library and reports the
+ * rejected entries in a compact bitmap, so the results do not have to be
+ * scanned for @p has_error afterwards.
+ *
+ * Entry i is rejected if bit (i % 64) of error_mask[i / 64] is set; the
+ * corresponding Date in @p results has @p has_error and @p errors set just
+ * like with Date_from_year_month_day. Rejected entries can be located
+ * quickly by scanning the mask words with a popcount or a count of trailing
+ * zeros.
+ *
+ * @param years The years (@p count entries).
+ * @param months The months of the year (@p count entries).
+ * @param days The days of the month (@p count entries).
+ * @param[out] results An array of @p count struct Date for the results.
+ * @param[out] error_mask An array of PRESENT_BATCH_MASK_WORDS(count) words
+ * for the bitmap of rejected entries, or NULL if it is not needed.
+ * @param count The number of entries.
+ * @return The number of rejected entries.
+ */
+PRESENT_API size_t
+Date_batch_from_year_month_day(
+        const int_year * const years,
+        const int_month * const months,
+        const int_day * const days,
+        struct Date * const results,
+        present_uint64 * const error_mask,
+        size_t count);
+
 /**
  * Create a new Date from either a year (1 argument), a year and a month (2
  * arguments), or a year/month/day (3 arguments).
@@ -371,6 +516,174 @@ Date_week_of_year(const struct Date * const self);
 PRESENT_API int_day_of_week
 Date_day_of_week(const struct Date * const self);
 
+/**
+ * Get the number of days in the month of a Date (28 to 31, inclusive).
+ */
+PRESENT_API int_day
+Date_days_in_month(const struct Date * const self);
+
+/**
+ * Get the last day of the month of a Date.
+ */
+PRESENT_API struct Date
+Date_last_day_of_month(const struct Date * const self);
+
+/**
+ * Create a new Date for the nth occurrence of a day of the week in a month
+ * (for example, the third Friday of March 2024, or the last Monday of May).
+ *
+ * The date is calculated directly from the day of the week of the first day
+ * of the month, rather than by stepping through the month.
+ *
+ * If the month or the day of the week is out of range, or the month does not
+ * have an nth occurrence of the day of the week (for example, a fifth
+ * Monday), the Date will have @p has_error and @p errors set.
+ *
+ * @copydoc check_for_error_date
+ *
+ * @param year The year.
+ * @param month The month of the year (1 to 12, inclusive).
+ * @param day_of_week The day of the week (1 to 7, inclusive). See
+ * present/internal/types.h for constants for each day of the week.
+ * @param n Which occurrence of the day of the week: 1 to 5 count from the
+ * start of the month (1 is the first), and -1 to -5 count from the end of the
+ * month (-1 is the last).
+ */
+PRESENT_API struct Date
+Date_nth_weekday_of_month(
+        int_year year,
+        int_month month,
+        int_day_of_week day_of_week,
+        int n);
+
+/**
+ * @copydoc Date_nth_weekday_of_month
+ * @param[out] result A pointer to a struct Date for the result.
+ */
+PRESENT_API void
+Date_ptr_nth_weekday_of_month(
+        struct Date * const result,
+        int_year year,
+        int_month month,
+        int_day_of_week day_of_week,
+        int n);
+
+/**
+ * Count the days with a given day of the week from @p first up to (but not
+ * including) @p end, in constant time.
+ *
+ * @param day_of_week The day of the week (1 to 7, inclusive).
+ * @return The number of days (negative if @p end is before @p first).
+ */
+PRESENT_API int_delta
+Date_count_weekday_between(
+        const struct Date * const first,
+        const struct Date * const end,
+        int_day_of_week day_of_week);
+
+/**
+ * Create many Date instances at once, for the nth occurrence of a day of the
+ * week in each of an array of months (for example, the third Friday of each
+ * month of a schedule).
+ *
+ * Entry i is rejected (like with Date_nth_weekday_of_month) if bit (i % 64)
+ * of error_mask[i / 64] is set, as with Date_batch_from_year_month_day.
+ *
+ * @param years The years (@p count entries).
+ * @param months The months of the year (@p count entries).
+ * @param day_of_week The day of the week (1 to 7, inclusive).
+ * @param n Which occurrence of the day of the week (see
+ * Date_nth_weekday_of_month).
+ * @param[out] results An array of @p count struct Date for the results.
+ * @param[out] error_mask An array of PRESENT_BATCH_MASK_WORDS(count) words
+ * for the bitmap of rejected entries, or NULL if it is not needed.
+ * @param count The number of entries.
+ * @return The number of rejected entries.
+ */
+PRESENT_API size_t
+Date_batch_nth_weekday_of_month(
+        const int_year * const years,
+        const int_month * const months,
+        int_day_of_week day_of_week,
+        int n,
+        struct Date * const results,
+        present_uint64 * const error_mask,
+        size_t count);
+
+/**
+ * Create many Date instances at once, for the last day of each of an array of
+ * months.
+ *
+ * Entry i is rejected (because its month is out of range) if bit (i % 64) of
+ * error_mask[i / 64] is set, as with Date_batch_from_year_month_day.
+ *
+ * @param years The years (@p count entries).
+ * @param months The months of the year (@p count entries).
+ * @param[out] results An array of @p count struct Date for the results.
+ * @param[out] error_mask An array of PRESENT_BATCH_MASK_WORDS(count) words
+ * for the bitmap of rejected entries, or NULL if it is not needed.
+ * @param count The number of entries.
+ * @return The number of rejected entries.
+ */
+PRESENT_API size_t
+Date_batch_last_day_of_month(
+        const int_year * const years,
+        const int_month * const months,
+        struct Date * const results,
+        present_uint64 * const error_mask,
+        size_t count);
+
+/**
+ * Count the days with a given day of the week between each pair of dates
+ * (see Date_count_weekday_between).
+ *
+ * @param firsts The first dates of the ranges (@p count entries).
+ * @param ends The end dates of the ranges (@p count entries).
+ * @param day_of_week The day of the week (1 to 7, inclusive).
+ * @param[out] results An array of @p count counts for the results.
+ * @param count The number of ranges.
+ */
+PRESENT_API void
+Date_batch_count_weekday_between(
+        const struct Date * const firsts,
+        const struct Date * const ends,
+        int_day_of_week day_of_week,
+        int_delta * const results,
+        size_t count);
+
+/**
+ * Format a Date as text, according to a strftime-like format string.
+ *
+ * The supported conversions are:
+ *
+ * - *\%Y*: the year (at least 4 digits, with a "-" if negative)
+ * - *\%y*: the last 2 digits of the year
+ * - *\%m*: the month (01 to 12)
+ * - *\%d*: the day of the month (01 to 31)
+ * - *\%F*: the ISO 8601 date (equivalent to "\%Y-\%m-\%d")
+ * - *\%j*: the day of the year (001 to 366)
+ * - *\%u*: the ISO 8601 day of the week (1 for Monday to 7 for Sunday)
+ * - *\%V*: the ISO 8601 week of the year (01 to 53)
+ * - *\%G*: the year corresponding to the ISO 8601 week of the year
+ * - *\%\%*, *\%n*, *\%t*: a literal "%", newline, or tab
+ *
+ * ClockTime_format and Timestamp_format support additional conversions for
+ * the time of day.
+ *
+ * @param format The format string.
+ * @param buffer The buffer to write the NUL-terminated result to.
+ * @param buffer_size The size of buffer (including room for the NUL).
+ * @return The number of characters written (not including the NUL), or 0 if
+ *         the format string is invalid or the result does not fit in the
+ *         buffer (like strftime).
+ */
+PRESENT_API size_t
+Date_format(
+        const struct Date * const self,
+        const char * const format,
+        char * const buffer,
+        size_t buffer_size);
+
 /**
  * Get the difference between two Date instances.
  */
@@ -469,6 +782,27 @@ Date_greater_than_or_equal(
         const struct Date * const lhs,
         const struct Date * const rhs);
 
+/**
+ * Sort an array of Dates, from earliest to latest.
+ *
+ * This is a radix sort on a key made from the year, month, and day, which
+ * takes a constant number of passes over the array (usually 3, since the
+ * digits of the key that are the same for every Date are skipped) rather
+ * than O(n log n) comparisons. Equal Dates keep their original order.
+ *
+ * For large numbers of dates, a DateColumn is more compact, and can be
+ * sorted in parallel (see DateColumn_sort_parallel).
+ *
+ * Precondition: None of the Dates may have @p has_error set.
+ *
+ * @param dates The Dates to sort (@p count entries).
+ * @param count The number of Dates.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the array is unchanged).
+ */
+PRESENT_API present_bool
+Date_sort(struct Date * const dates, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
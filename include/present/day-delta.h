@@ -37,116 +37,146 @@ struct TimeDelta;
  * Class or struct representing a positive or negative delta of a number of
  * days or weeks.
  */
-struct PRESENT_API DayDelta {
+struct PRESENT_CLASS_API DayDelta {
     /* Internal data representation */
     struct PresentDayDeltaData data_;
 
 #ifdef __cplusplus
     /** @copydoc DayDelta_from_days */
-    static DayDelta from_days(int_delta days);
+    static PRESENT_CONSTEXPR DayDelta from_days(int_delta days);
 
     /** @copydoc DayDelta_from_weeks */
-    static DayDelta from_weeks(int_delta weeks);
+    static PRESENT_CONSTEXPR DayDelta from_weeks(int_delta weeks);
 
     /** @copydoc DayDelta_zero */
-    static DayDelta zero();
+    static PRESENT_CONSTEXPR DayDelta zero();
 
     /** @copydoc DayDelta_days */
-    int_delta days() const;
+    PRESENT_CONSTEXPR int_delta days() const;
 
     /** @copydoc DayDelta_weeks */
-    int_delta weeks() const;
+    PRESENT_CONSTEXPR int_delta weeks() const;
 
     /** @copydoc DayDelta_weeks_decimal */
-    double weeks_decimal() const;
+    PRESENT_CONSTEXPR double weeks_decimal() const;
 
     /** @copydoc DayDelta_to_TimeDelta */
-    TimeDelta to_TimeDelta() const;
+    PRESENT_CONSTEXPR TimeDelta to_TimeDelta() const;
 
     /** @copydoc DayDelta_is_negative */
-    bool is_negative() const;
+    PRESENT_CONSTEXPR bool is_negative() const;
 
     /** @copydoc DayDelta_negate */
-    void negate();
+    PRESENT_CONSTEXPR void negate();
 
     /**
      * Return the negated version of this DayDelta.
      * @see DayDelta::negate
      */
-    DayDelta operator-() const;
+    PRESENT_CONSTEXPR DayDelta operator-() const;
 
     /** Add one day to the DayDelta. */
-    DayDelta & operator++();
+    PRESENT_CONSTEXPR DayDelta & operator++();
     /** Add one day to the DayDelta. */
-    DayDelta operator++(int);
+    PRESENT_CONSTEXPR DayDelta operator++(int);
     /** Subtract one day from the DayDelta. */
-    DayDelta & operator--();
+    PRESENT_CONSTEXPR DayDelta & operator--();
     /** Subtract one day from the DayDelta. */
-    DayDelta operator--(int);
+    PRESENT_CONSTEXPR DayDelta operator--(int);
 
     /** @copydoc DayDelta_multiply_by */
-    DayDelta & operator*=(const long & scale_factor);
+    PRESENT_CONSTEXPR DayDelta & operator*=(const long & scale_factor);
     /** @copydoc DayDelta_divide_by */
-    DayDelta & operator/=(const long & scale_factor);
+    PRESENT_CONSTEXPR DayDelta & operator/=(const long & scale_factor);
 
     /** @see DayDelta::operator*=(const long & scale_factor) */
-    friend const DayDelta operator*(
+    friend PRESENT_CONSTEXPR const DayDelta operator*(
             const DayDelta & delta,
             const long & scale_factor);
     /** @see DayDelta::operator/=(const long & scale_factor) */
-    friend const DayDelta operator/(
+    friend PRESENT_CONSTEXPR const DayDelta operator/(
             const DayDelta & delta,
             const long & scale_factor);
 
     /** @copydoc DayDelta_add */
-    DayDelta & operator+=(const DayDelta & other);
+    PRESENT_CONSTEXPR DayDelta & operator+=(const DayDelta & other);
     /** @copydoc DayDelta_subtract */
-    DayDelta & operator-=(const DayDelta & other);
+    PRESENT_CONSTEXPR DayDelta & operator-=(const DayDelta & other);
 
     /** @see DayDelta::operator+=(const DayDelta & other) */
-    friend const DayDelta operator+(
+    friend PRESENT_CONSTEXPR const DayDelta operator+(
             const DayDelta & lhs,
             const DayDelta & rhs);
     /** @see DayDelta::operator-=(const DayDelta & other) */
-    friend const DayDelta operator-(
+    friend PRESENT_CONSTEXPR const DayDelta operator-(
             const DayDelta & lhs,
             const DayDelta & rhs);
 
     /** @copydoc DayDelta_compare */
-    static short compare(const DayDelta & lhs, const DayDelta & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const DayDelta & lhs,
+            const DayDelta & rhs);
 
     /** @copydoc DayDelta_compare_to_TimeDelta */
-    static short compare(const DayDelta & lhs, const TimeDelta & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
     /** @see DayDelta::compare(const DayDelta & lhs, const TimeDelta & rhs) */
-    static short compare(const TimeDelta & lhs, const DayDelta & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
 
     /** @copydoc DayDelta_equal */
-    friend bool operator==(const DayDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const DayDelta & lhs,
+            const DayDelta & rhs);
     /** @copydoc DayDelta_equal_TimeDelta */
-    friend bool operator==(const DayDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
 
-    friend bool operator!=(const DayDelta & lhs, const DayDelta & rhs);
-    friend bool operator!=(const DayDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const DayDelta & lhs,
+            const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
 
     /** @copydoc DayDelta_less_than */
-    friend bool operator<(const DayDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const DayDelta & lhs,
+            const DayDelta & rhs);
     /** @copydoc DayDelta_less_than_TimeDelta */
-    friend bool operator<(const DayDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
 
     /** @copydoc DayDelta_less_than_or_equal */
-    friend bool operator<=(const DayDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const DayDelta & lhs,
+            const DayDelta & rhs);
     /** @copydoc DayDelta_less_than_or_equal_TimeDelta */
-    friend bool operator<=(const DayDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
 
     /** @copydoc DayDelta_greater_than */
-    friend bool operator>(const DayDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const DayDelta & lhs,
+            const DayDelta & rhs);
     /** @copydoc DayDelta_greater_than_TimeDelta */
-    friend bool operator>(const DayDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
 
     /** @copydoc DayDelta_greater_than_or_equal */
-    friend bool operator>=(const DayDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const DayDelta & lhs,
+            const DayDelta & rhs);
     /** @copydoc DayDelta_greater_than_or_equal_TimeDelta */
-    friend bool operator>=(const DayDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
 #endif
 };
 
@@ -0,0 +1,108 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the BusinessCalendar C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+inline
+BusinessCalendar::BusinessCalendar()
+{
+    BusinessCalendar_init(this);
+}
+
+inline
+BusinessCalendar::BusinessCalendar(
+        const Date & first,
+        const Date & end,
+        unsigned int weekend_mask,
+        const Date * holidays,
+        size_t holiday_count)
+{
+    BusinessCalendar_init(this);
+    build(first, end, weekend_mask, holidays, holiday_count);
+}
+
+inline
+BusinessCalendar::BusinessCalendar(const BusinessCalendar & other)
+{
+    BusinessCalendar_init(this);
+    if (!BusinessCalendar_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline BusinessCalendar &
+BusinessCalendar::operator=(const BusinessCalendar & other)
+{
+    if (!BusinessCalendar_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline
+BusinessCalendar::~BusinessCalendar()
+{
+    BusinessCalendar_destroy(this);
+}
+
+inline void
+BusinessCalendar::build(
+        const Date & first,
+        const Date & end,
+        unsigned int weekend_mask,
+        const Date * holidays,
+        size_t holiday_count)
+{
+    if (!BusinessCalendar_build(this, &first, &end, weekend_mask, holidays,
+                holiday_count)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline Date
+BusinessCalendar::first() const
+{
+    return BusinessCalendar_first(this);
+}
+
+inline Date
+BusinessCalendar::end() const
+{
+    return BusinessCalendar_end(this);
+}
+
+inline bool
+BusinessCalendar::is_business_day(const Date & date) const
+{
+    return BusinessCalendar_is_business_day(this, &date) != 0;
+}
+
+inline int_delta
+BusinessCalendar::business_days_between(
+        const Date & first,
+        const Date & end) const
+{
+    return BusinessCalendar_business_days_between(this, &first, &end);
+}
+
+inline Date
+BusinessCalendar::add_business_days(const Date & date, int_delta count) const
+{
+    return BusinessCalendar_add_business_days(this, &date, count);
+}
+
+inline Date
+BusinessCalendar::adjust(const Date & date, int rule) const
+{
+    return BusinessCalendar_adjust(this, &date, rule);
+}
+
@@ -0,0 +1,84 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the ClockPage C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+inline
+ClockPage::ClockPage()
+{
+    ClockPage_init(this);
+}
+
+inline
+ClockPage::~ClockPage()
+{
+    ClockPage_close(this);
+}
+
+inline bool
+ClockPage::publish(const char * name, const TimeDelta & interval)
+{
+    return ClockPage_publish(this, name, &interval);
+}
+
+inline bool
+ClockPage::open(const char * name)
+{
+    return ClockPage_open(this, name);
+}
+
+inline bool
+ClockPage::open_fd(int fd)
+{
+    return ClockPage_open_fd(this, fd);
+}
+
+inline void
+ClockPage::close()
+{
+    ClockPage_close(this);
+}
+
+inline bool
+ClockPage::is_open() const
+{
+    return ClockPage_is_open(this);
+}
+
+inline bool
+ClockPage::is_publishing() const
+{
+    return ClockPage_is_publishing(this);
+}
+
+inline int
+ClockPage::fd() const
+{
+    return ClockPage_get_fd(this);
+}
+
+inline TimeDelta
+ClockPage::interval() const
+{
+    return ClockPage_get_interval(this);
+}
+
+inline TimeDelta
+ClockPage::age() const
+{
+    return ClockPage_get_age(this);
+}
+
+inline Timestamp
+ClockPage::now() const
+{
+    return ClockPage_now(this);
+}
+
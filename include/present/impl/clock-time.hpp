@@ -10,180 +10,275 @@
  * For details, see LICENSE.
  */
 
-inline ClockTime
+inline PRESENT_CONSTEXPR ClockTime
 ClockTime::create(int_hour hour)
 {
-    ClockTime result;
-    ClockTime_ptr_from_hour(&result, hour);
-    return result;
+    return ClockTime::create(hour, 0, 0, 0);
 }
 
-inline ClockTime
+inline PRESENT_CONSTEXPR ClockTime
 ClockTime::create(int_hour hour, int_minute minute)
 {
-    ClockTime result;
-    ClockTime_ptr_from_hour_minute(&result, hour, minute);
-    return result;
+    return ClockTime::create(hour, minute, 0, 0);
 }
 
-inline ClockTime
+inline PRESENT_CONSTEXPR ClockTime
 ClockTime::create(int_hour hour, int_minute minute, int_second second)
 {
-    ClockTime result;
-    ClockTime_ptr_from_hour_minute_second(&result, hour, minute, second);
-    return result;
+    return ClockTime::create(hour, minute, second, 0);
 }
 
-inline ClockTime
+inline PRESENT_CONSTEXPR ClockTime
 ClockTime::create(
         int_hour hour,
         int_minute minute,
         int_second second,
         int_nanosecond nanosecond)
 {
-    ClockTime result;
-    ClockTime_ptr_from_hour_minute_second_nanosecond(
-            &result,
-            hour,
-            minute,
-            second,
-            nanosecond);
+    ClockTime result = ClockTime();
+
+    if (hour == 24) hour = 0;
+    if (hour < 0 || hour > 24) {
+        result.has_error = 1;
+        result.errors.hour_out_of_range = 1;
+    }
+
+    if (minute < 0 || minute >= 60) {
+        result.has_error = 1;
+        result.errors.minute_out_of_range = 1;
+    }
+
+    /* 61 because of leap seconds :( */
+    if (second < 0 || second >= 61) {
+        result.has_error = 1;
+        result.errors.second_out_of_range = 1;
+    }
+
+    if (nanosecond < 0 ||
+            nanosecond >= present_internal::nanoseconds_in_second) {
+        result.has_error = 1;
+        result.errors.nanosecond_out_of_range = 1;
+    }
+
+    if (!result.has_error) {
+        result.data_.seconds = second +
+            minute * present_internal::seconds_in_minute +
+            hour * present_internal::seconds_in_hour;
+        result.data_.nanoseconds = nanosecond;
+    }
     return result;
 }
 
-inline ClockTime
+inline size_t
+ClockTime::create_batch(
+        const int_hour * hours,
+        const int_minute * minutes,
+        const int_second * seconds,
+        ClockTime * results,
+        present_uint64 * error_mask,
+        size_t count)
+{
+    return ClockTime_batch_from_hour_minute_second(
+            hours, minutes, seconds, results, error_mask, count);
+}
+
+inline PRESENT_CONSTEXPR ClockTime
 ClockTime::create_with_decimal_seconds(
         int_hour hour,
         int_minute minute,
         double second)
 {
-    ClockTime result;
-    ClockTime_ptr_create_with_decimal_seconds(&result, hour, minute, second);
-    return result;
+    const int_second second_int = (int_second)second;
+
+    return ClockTime::create(hour, minute, second_int,
+            (int_nanosecond)present_internal::round(
+                (second - second_int) *
+                (double)present_internal::nanoseconds_in_second));
 }
 
-inline ClockTime
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+
+template <typename Duration>
+inline PRESENT_CONSTEXPR ClockTime
+ClockTime::create(const std::chrono::hh_mm_ss<Duration> & hh_mm_ss)
+{
+    const int_delta hours = (int_delta)hh_mm_ss.hours().count();
+
+    /* Hour -1 will always be reported as out of range */
+    return ClockTime::create(
+            (int_hour)(hh_mm_ss.is_negative() || hours > 24 ? -1 : hours),
+            (int_minute)hh_mm_ss.minutes().count(),
+            (int_second)hh_mm_ss.seconds().count(),
+            (int_nanosecond)std::chrono::duration_cast<
+                std::chrono::nanoseconds>(hh_mm_ss.subseconds()).count());
+}
+
+#endif
+
+inline PRESENT_CONSTEXPR ClockTime
 ClockTime::midnight()
 {
-    ClockTime result;
-    ClockTime_ptr_midnight(&result);
-    return result;
+    return ClockTime::create(0, 0, 0, 0);
 }
 
-inline ClockTime
+inline PRESENT_CONSTEXPR ClockTime
 ClockTime::noon()
 {
-    ClockTime result;
-    ClockTime_ptr_noon(&result);
-    return result;
+    return ClockTime::create(12, 0, 0, 0);
 }
 
-inline int_hour
+inline PRESENT_CONSTEXPR int_hour
 ClockTime::hour() const
 {
-    return ClockTime_hour(this);
+    assert(this->has_error == 0);
+    return (int_hour)(this->data_.seconds / present_internal::seconds_in_hour);
 }
 
-inline int_minute
+inline PRESENT_CONSTEXPR int_minute
 ClockTime::minute() const
 {
-    return ClockTime_minute(this);
+    assert(this->has_error == 0);
+    return (int_minute)(this->data_.seconds %
+            present_internal::seconds_in_hour /
+            present_internal::seconds_in_minute);
 }
 
-inline int_second
+inline PRESENT_CONSTEXPR int_second
 ClockTime::second() const
 {
-    return ClockTime_second(this);
+    assert(this->has_error == 0);
+    return (int_second)(this->data_.seconds %
+            present_internal::seconds_in_minute);
 }
 
-inline int_nanosecond
+inline PRESENT_CONSTEXPR int_nanosecond
 ClockTime::nanosecond() const
 {
-    return ClockTime_nanosecond(this);
+    assert(this->has_error == 0);
+    return this->data_.nanoseconds;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 ClockTime::second_decimal() const
 {
-    return ClockTime_second_decimal(this);
+    assert(this->has_error == 0);
+    return (double)(this->data_.seconds %
+                    present_internal::seconds_in_minute) +
+        (double)this->data_.nanoseconds /
+        (double)present_internal::nanoseconds_in_second;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 ClockTime::time_since_midnight() const
 {
-    return ClockTime_time_since_midnight(this);
+    assert(this->has_error == 0);
+    return TimeDelta::from_seconds(this->data_.seconds) +
+        TimeDelta::from_nanoseconds(this->data_.nanoseconds);
+}
+
+inline size_t
+ClockTime::format(
+        const char * format,
+        char * buffer,
+        size_t buffer_size) const
+{
+    return ClockTime_format(this, format, buffer, buffer_size);
 }
 
-inline ClockTime &
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+
+inline PRESENT_CONSTEXPR std::chrono::hh_mm_ss<std::chrono::nanoseconds>
+ClockTime::to_hh_mm_ss() const
+{
+    assert(this->has_error == 0);
+    return std::chrono::hh_mm_ss<std::chrono::nanoseconds>(
+            present_internal::join_duration<std::chrono::nanoseconds>(
+                this->data_.seconds, this->data_.nanoseconds));
+}
+
+#endif
+
+inline PRESENT_CONSTEXPR ClockTime &
 ClockTime::operator+=(const TimeDelta & delta)
 {
-    ClockTime_add_TimeDelta(this, &delta);
+    assert(this->has_error == 0);
+    this->data_.seconds += delta.data_.delta_seconds;
+    this->data_.nanoseconds += delta.data_.delta_nanoseconds;
+    present_internal::normalize_clock_time_data(this->data_);
     return *this;
 }
 
-inline ClockTime &
+inline PRESENT_CONSTEXPR ClockTime &
 ClockTime::operator-=(const TimeDelta & delta)
 {
-    ClockTime_subtract_TimeDelta(this, &delta);
+    assert(this->has_error == 0);
+    this->data_.seconds -= delta.data_.delta_seconds;
+    this->data_.nanoseconds -= delta.data_.delta_nanoseconds;
+    present_internal::normalize_clock_time_data(this->data_);
     return *this;
 }
 
-inline const ClockTime
+inline PRESENT_CONSTEXPR const ClockTime
 operator+(const ClockTime & lhs, const TimeDelta & rhs)
 {
     return (ClockTime(lhs) += rhs);
 }
-inline const ClockTime
+inline PRESENT_CONSTEXPR const ClockTime
 operator+(const TimeDelta & lhs, const ClockTime & rhs)
 {
     return (ClockTime(rhs) += lhs);
 }
 
-inline const ClockTime
+inline PRESENT_CONSTEXPR const ClockTime
 operator-(const ClockTime & lhs, const TimeDelta & rhs)
 {
     return (ClockTime(lhs) -= rhs);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 ClockTime::compare(const ClockTime & lhs, const ClockTime & rhs)
 {
-    return ClockTime_compare(&lhs, &rhs);
+    assert(lhs.has_error == 0);
+    assert(rhs.has_error == 0);
+    return present_internal::compare(
+            lhs.data_.seconds, rhs.data_.seconds,
+            present_internal::compare(
+                lhs.data_.nanoseconds, rhs.data_.nanoseconds, 0));
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const ClockTime & lhs, const ClockTime & rhs)
 {
-    return ClockTime_equal(&lhs, &rhs);
+    return ClockTime::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const ClockTime & lhs, const ClockTime & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const ClockTime & lhs, const ClockTime & rhs)
 {
-    return ClockTime_less_than(&lhs, &rhs);
+    return ClockTime::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const ClockTime & lhs, const ClockTime & rhs)
 {
-    return ClockTime_less_than_or_equal(&lhs, &rhs);
+    return ClockTime::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const ClockTime & lhs, const ClockTime & rhs)
 {
-    return ClockTime_greater_than(&lhs, &rhs);
+    return ClockTime::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const ClockTime & lhs, const ClockTime & rhs)
 {
-    return ClockTime_greater_than_or_equal(&lhs, &rhs);
+    return ClockTime::compare(lhs, rhs) >= 0;
 }
 
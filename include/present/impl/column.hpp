@@ -0,0 +1,408 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the DateColumn and TimestampColumn C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+/*
+ * DateColumn
+ */
+
+inline
+DateColumn::DateColumn()
+{
+    DateColumn_init(this);
+}
+
+inline
+DateColumn::DateColumn(const DateColumn & other)
+{
+    DateColumn_init(this);
+    if (!DateColumn_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline DateColumn &
+DateColumn::operator=(const DateColumn & other)
+{
+    if (!DateColumn_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline
+DateColumn::~DateColumn()
+{
+    DateColumn_destroy(this);
+}
+
+inline void
+DateColumn::swap(DateColumn & other)
+{
+    DateColumn temp_copy;
+    /* Swap the fields directly (without copying the arrays) */
+    temp_copy.days_ = days_;
+    temp_copy.size_ = size_;
+    temp_copy.capacity_ = capacity_;
+    days_ = other.days_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.days_ = temp_copy.days_;
+    other.size_ = temp_copy.size_;
+    other.capacity_ = temp_copy.capacity_;
+    DateColumn_init(&temp_copy);
+}
+
+inline size_t
+DateColumn::size() const
+{
+    return size_;
+}
+
+inline size_t
+DateColumn::capacity() const
+{
+    return capacity_;
+}
+
+inline bool
+DateColumn::empty() const
+{
+    return size_ == 0;
+}
+
+inline const int_delta *
+DateColumn::days() const
+{
+    return days_;
+}
+
+inline void
+DateColumn::reserve(size_t capacity)
+{
+    if (!DateColumn_reserve(this, capacity)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline void
+DateColumn::clear()
+{
+    DateColumn_clear(this);
+}
+
+inline void
+DateColumn::push_back(const Date & date)
+{
+    if (!DateColumn_push_back(this, &date)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline Date
+DateColumn::operator[](size_t index) const
+{
+    return DateColumn_get(this, index);
+}
+
+inline Date
+DateColumn::min() const
+{
+    return DateColumn_min(this);
+}
+
+inline Date
+DateColumn::max() const
+{
+    return DateColumn_max(this);
+}
+
+inline size_t
+DateColumn::filter_range(
+        const Date & low,
+        const Date & high,
+        size_t * selection) const
+{
+    return DateColumn_filter_range(this, &low, &high, selection);
+}
+
+inline void
+DateColumn::compare(const Date & value, present_int8 * results) const
+{
+    DateColumn_compare(this, &value, results);
+}
+
+inline DateColumn &
+DateColumn::operator+=(const DayDelta & delta)
+{
+    DateColumn_add_DayDelta(this, &delta);
+    return *this;
+}
+
+inline DateColumn &
+DateColumn::operator-=(const DayDelta & delta)
+{
+    DateColumn_subtract_DayDelta(this, &delta);
+    return *this;
+}
+
+inline void
+DateColumn::sort(size_t * permutation)
+{
+    if (!DateColumn_sort(this, permutation)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline void
+DateColumn::sort_parallel(unsigned int thread_count, size_t * permutation)
+{
+    if (!DateColumn_sort_parallel(this, permutation, thread_count)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline size_t
+DateColumn::unique()
+{
+    return DateColumn_unique(this);
+}
+
+/*
+ * TimestampColumn
+ */
+
+inline
+TimestampColumn::TimestampColumn()
+{
+    TimestampColumn_init(this);
+}
+
+inline
+TimestampColumn::TimestampColumn(const TimestampColumn & other)
+{
+    TimestampColumn_init(this);
+    if (!TimestampColumn_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline TimestampColumn &
+TimestampColumn::operator=(const TimestampColumn & other)
+{
+    if (!TimestampColumn_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline
+TimestampColumn::~TimestampColumn()
+{
+    TimestampColumn_destroy(this);
+}
+
+inline void
+TimestampColumn::swap(TimestampColumn & other)
+{
+    TimestampColumn temp_copy;
+    /* Swap the fields directly (without copying the arrays) */
+    temp_copy.seconds_ = seconds_;
+    temp_copy.nanoseconds_ = nanoseconds_;
+    temp_copy.size_ = size_;
+    temp_copy.capacity_ = capacity_;
+    seconds_ = other.seconds_;
+    nanoseconds_ = other.nanoseconds_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.seconds_ = temp_copy.seconds_;
+    other.nanoseconds_ = temp_copy.nanoseconds_;
+    other.size_ = temp_copy.size_;
+    other.capacity_ = temp_copy.capacity_;
+    TimestampColumn_init(&temp_copy);
+}
+
+inline size_t
+TimestampColumn::size() const
+{
+    return size_;
+}
+
+inline size_t
+TimestampColumn::capacity() const
+{
+    return capacity_;
+}
+
+inline bool
+TimestampColumn::empty() const
+{
+    return size_ == 0;
+}
+
+inline const int_timestamp *
+TimestampColumn::seconds() const
+{
+    return seconds_;
+}
+
+inline const int_timestamp *
+TimestampColumn::nanoseconds() const
+{
+    return nanoseconds_;
+}
+
+inline void
+TimestampColumn::reserve(size_t capacity)
+{
+    if (!TimestampColumn_reserve(this, capacity)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline void
+TimestampColumn::clear()
+{
+    TimestampColumn_clear(this);
+}
+
+inline void
+TimestampColumn::push_back(const Timestamp & timestamp)
+{
+    if (!TimestampColumn_push_back(this, &timestamp)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline Timestamp
+TimestampColumn::operator[](size_t index) const
+{
+    return TimestampColumn_get(this, index);
+}
+
+inline Timestamp
+TimestampColumn::min() const
+{
+    return TimestampColumn_min(this);
+}
+
+inline Timestamp
+TimestampColumn::max() const
+{
+    return TimestampColumn_max(this);
+}
+
+inline size_t
+TimestampColumn::filter_range(
+        const Timestamp & low,
+        const Timestamp & high,
+        size_t * selection) const
+{
+    return TimestampColumn_filter_range(this, &low, &high, selection);
+}
+
+inline void
+TimestampColumn::compare(
+        const Timestamp & value,
+        present_int8 * results) const
+{
+    TimestampColumn_compare(this, &value, results);
+}
+
+inline TimestampColumn &
+TimestampColumn::operator+=(const TimeDelta & delta)
+{
+    TimestampColumn_add_TimeDelta(this, &delta);
+    return *this;
+}
+
+inline TimestampColumn &
+TimestampColumn::operator-=(const TimeDelta & delta)
+{
+    TimestampColumn_subtract_TimeDelta(this, &delta);
+    return *this;
+}
+
+inline void
+TimestampColumn::sort(size_t * permutation)
+{
+    if (!TimestampColumn_sort(this, permutation)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline void
+TimestampColumn::sort_parallel(
+        unsigned int thread_count,
+        size_t * permutation)
+{
+    if (!TimestampColumn_sort_parallel(this, permutation, thread_count)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline size_t
+TimestampColumn::unique()
+{
+    return TimestampColumn_unique(this);
+}
+
+inline DateColumn
+TimestampColumn::get_date_column(const TimeDelta & time_zone_offset) const
+{
+    DateColumn result;
+    if (!TimestampColumn_get_date_column(this, &time_zone_offset, &result)) {
+        present_internal::throw_bad_alloc();
+    }
+    return result;
+}
+
+inline DateColumn
+TimestampColumn::get_date_column_utc() const
+{
+    DateColumn result;
+    if (!TimestampColumn_get_date_column_utc(this, &result)) {
+        present_internal::throw_bad_alloc();
+    }
+    return result;
+}
+
+inline void
+TimestampColumn::truncate(int unit, const TimeDelta & time_zone_offset)
+{
+    TimestampColumn_truncate(this, unit, &time_zone_offset);
+}
+
+inline void
+TimestampColumn::truncate_utc(int unit)
+{
+    TimestampColumn_truncate_utc(this, unit);
+}
+
+inline void
+TimestampColumn::bucket(const TimeDelta & width, const Timestamp & origin)
+{
+    TimestampColumn_bucket(this, &width, &origin);
+}
+
+inline void
+TimestampColumn::get_windows(
+        const TimeDelta & size,
+        const TimeDelta & hop,
+        const Timestamp & origin,
+        int_delta * first,
+        int_delta * last) const
+{
+    TimestampColumn_get_windows(this, &size, &hop, &origin, first, last);
+}
+
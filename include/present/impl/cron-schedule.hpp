@@ -0,0 +1,56 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the CronSchedule C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+inline CronSchedule
+CronSchedule::create(
+        const char * expression,
+        const TimeDelta & time_zone_offset)
+{
+    return CronSchedule_from_expression(expression, &time_zone_offset);
+}
+
+inline CronSchedule
+CronSchedule::create_utc(const char * expression)
+{
+    return CronSchedule_from_expression_utc(expression);
+}
+
+inline bool
+CronSchedule::matches(const Timestamp & timestamp) const
+{
+    return CronSchedule_matches(this, &timestamp);
+}
+
+inline Timestamp
+CronSchedule::next_after(const Timestamp & timestamp) const
+{
+    return CronSchedule_next_after(this, &timestamp);
+}
+
+inline Timestamp
+CronSchedule::prev_before(const Timestamp & timestamp) const
+{
+    return CronSchedule_prev_before(this, &timestamp);
+}
+
+inline void
+CronSchedule::next_after_batch(
+        const CronSchedule * schedules,
+        const Timestamp & timestamp,
+        Timestamp * results,
+        size_t count)
+{
+    CronSchedule_batch_next_after(schedules, &timestamp, results, count);
+}
+
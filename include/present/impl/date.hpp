@@ -10,198 +10,504 @@
  * For details, see LICENSE.
  */
 
-inline Date
+inline PRESENT_CONSTEXPR Date
 Date::create(int_year year)
 {
-    Date result;
-    Date_ptr_from_year(&result, year);
-    return result;
+    return Date::create(year, 1, 1);
 }
 
-inline Date
+inline PRESENT_CONSTEXPR Date
 Date::create(int_year year, int_month month)
 {
-    Date result;
-    Date_ptr_from_year_month(&result, year, month);
-    return result;
+    return Date::create(year, month, 1);
 }
 
-inline Date
+inline PRESENT_CONSTEXPR Date
 Date::create(int_year year, int_month month, int_day day)
 {
-    Date result;
-    Date_ptr_from_year_month_day(&result, year, month, day);
+    Date result = Date();
+
+    if (month < 1 || month > 12) {
+        result.has_error = 1;
+        result.errors.month_out_of_range = 1;
+    } else if (day < 1 || day > present_internal::days_in_month(year, month)) {
+        result.has_error = 1;
+        result.errors.day_out_of_range = 1;
+    }
+
+    if (!result.has_error) {
+        result.data_.year = year;
+        result.data_.month = month;
+        result.data_.day = day;
+        present_internal::normalize_date_data(result.data_);
+    }
     return result;
 }
 
-inline Date
+inline size_t
+Date::create_batch(
+        const int_year * years,
+        const int_month * months,
+        const int_day * days,
+        Date * results,
+        present_uint64 * error_mask,
+        size_t count)
+{
+    return Date_batch_from_year_month_day(
+            years, months, days, results, error_mask, count);
+}
+
+inline PRESENT_CONSTEXPR Date
 Date::from_year_day(int_year year, int_day_of_year day_of_year)
 {
-    Date result;
-    Date_ptr_from_year_day(&result, year, day_of_year);
+    Date result = Date();
+    present_internal::civil_from_days(
+            present_internal::days_from_civil(year, 1, day_of_year),
+            result.data_);
     return result;
 }
 
-inline Date
+inline PRESENT_CONSTEXPR Date
 Date::from_year_week_day(
         int_year year,
         int_week_of_year week_of_year,
         int_day_of_week day_of_week)
 {
-    Date result;
-    Date_ptr_from_year_week_day(&result, year, week_of_year, day_of_week);
+    Date result = Date();
+    int_delta jan_4_day_of_week = 0;
+
+    if (week_of_year < 1 ||
+            week_of_year > present_internal::last_week_of_year(year)) {
+        result.has_error = 1;
+        result.errors.week_of_year_out_of_range = 1;
+    }
+
+    if (day_of_week == DAY_OF_WEEK_SUNDAY_COMPAT) {
+        day_of_week = DAY_OF_WEEK_SUNDAY;
+    }
+    if (day_of_week < 1 || day_of_week > 7) {
+        result.has_error = 1;
+        result.errors.day_of_week_out_of_range = 1;
+    }
+
+    if (!result.has_error) {
+        /* https://en.wikipedia.org/wiki/ISO_week_date#Calculating_a_date_given_the_year.2C_week_number_and_weekday
+         */
+        jan_4_day_of_week = present_internal::floor_mod(
+                present_internal::days_from_civil(year, 1, 4) + 3,
+                present_internal::days_in_week) + 1;
+        result = Date::from_year_day(year, (int_day_of_year)(
+                    week_of_year * 7 + day_of_week -
+                    (jan_4_day_of_week + 3)));
+    }
+    return result;
+}
+
+inline PRESENT_CONSTEXPR Date
+Date::nth_weekday_of_month(
+        int_year year,
+        int_month month,
+        int_day_of_week day_of_week,
+        int n)
+{
+    Date result = Date();
+    int_delta first_day = 0, days = 0, day = 0;
+
+    if (month < 1 || month > 12) {
+        result.has_error = 1;
+        result.errors.month_out_of_range = 1;
+    }
+    if (day_of_week == DAY_OF_WEEK_SUNDAY_COMPAT) {
+        day_of_week = DAY_OF_WEEK_SUNDAY;
+    }
+    if (day_of_week < 1 || day_of_week > 7) {
+        result.has_error = 1;
+        result.errors.day_of_week_out_of_range = 1;
+    }
+    if (n == 0 || n < -5 || n > 5) {
+        result.has_error = 1;
+        result.errors.day_out_of_range = 1;
+    }
+
+    if (!result.has_error) {
+        /* Count forward from the first day of the month, or backward from
+           the last day of the month */
+        first_day = present_internal::days_from_civil(year, month, 1);
+        days = present_internal::days_in_month(year, month);
+        if (n > 0) {
+            day = 1 + present_internal::floor_mod(
+                    day_of_week - (first_day + 4),
+                    present_internal::days_in_week) +
+                (n - 1) * present_internal::days_in_week;
+        } else {
+            day = days - present_internal::floor_mod(
+                    first_day + days + 3 - day_of_week,
+                    present_internal::days_in_week) +
+                (n + 1) * present_internal::days_in_week;
+        }
+        if (day < 1 || day > days) {
+            result.has_error = 1;
+            result.errors.day_out_of_range = 1;
+        } else {
+            present_internal::civil_from_days(first_day + day - 1,
+                    result.data_);
+        }
+    }
+    return result;
+}
+
+inline size_t
+Date::nth_weekday_of_month_batch(
+        const int_year * years,
+        const int_month * months,
+        int_day_of_week day_of_week,
+        int n,
+        Date * results,
+        present_uint64 * error_mask,
+        size_t count)
+{
+    return Date_batch_nth_weekday_of_month(
+            years, months, day_of_week, n, results, error_mask, count);
+}
+
+inline size_t
+Date::last_day_of_month_batch(
+        const int_year * years,
+        const int_month * months,
+        Date * results,
+        present_uint64 * error_mask,
+        size_t count)
+{
+    return Date_batch_last_day_of_month(
+            years, months, results, error_mask, count);
+}
+
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+
+inline PRESENT_CONSTEXPR Date
+Date::create(const std::chrono::year_month_day & year_month_day)
+{
+    return Date::create(
+            (int_year)(int)year_month_day.year(),
+            (int_month)(unsigned)year_month_day.month(),
+            (int_day)(unsigned)year_month_day.day());
+}
+
+inline PRESENT_CONSTEXPR Date
+Date::create(const std::chrono::sys_days & days)
+{
+    Date result = Date();
+    present_internal::civil_from_days(
+            (int_delta)days.time_since_epoch().count(), result.data_);
     return result;
 }
 
-inline int_year
+#endif
+
+inline PRESENT_CONSTEXPR int_year
 Date::year() const
 {
-    return Date_year(this);
+    assert(this->has_error == 0);
+    return this->data_.year;
 }
 
-inline int_month
+inline PRESENT_CONSTEXPR int_month
 Date::month() const
 {
-    return Date_month(this);
+    assert(this->has_error == 0);
+    return this->data_.month;
 }
 
-inline int_day
+inline PRESENT_CONSTEXPR int_day
 Date::day() const
 {
-    return Date_day(this);
+    assert(this->has_error == 0);
+    return this->data_.day;
 }
 
-inline int_day_of_year
+inline PRESENT_CONSTEXPR int_day_of_year
 Date::day_of_year() const
 {
-    return Date_day_of_year(this);
+    assert(this->has_error == 0);
+    return this->data_.day_of_year;
 }
 
-inline struct PresentWeekYear
+inline PRESENT_CONSTEXPR struct PresentWeekYear
 Date::week_of_year() const
 {
-    return Date_week_of_year(this);
+    struct PresentWeekYear p = PresentWeekYear();
+
+    assert(this->has_error == 0);
+
+    /* https://en.wikipedia.org/wiki/ISO_week_date#Calculating_the_week_number_of_a_given_date
+       */
+    p.year = this->data_.year;
+    p.week = (int_week_of_year)(
+            (this->data_.day_of_year - this->data_.day_of_week + 10) / 7);
+
+    if (p.week == 0) {
+        /* It's the last week of the previous year */
+        p.year -= 1;
+        p.week = present_internal::last_week_of_year(p.year);
+    } else if (p.week > present_internal::last_week_of_year(p.year)) {
+        /* It's the first week of the next year */
+        p.year += 1;
+        p.week = 1;
+    }
+    return p;
 }
 
-inline int_day_of_week
+inline PRESENT_CONSTEXPR int_day_of_week
 Date::day_of_week() const
 {
-    return Date_day_of_week(this);
+    assert(this->has_error == 0);
+    return this->data_.day_of_week;
+}
+
+inline PRESENT_CONSTEXPR int_day
+Date::days_in_month() const
+{
+    assert(this->has_error == 0);
+    return present_internal::days_in_month(
+            this->data_.year, this->data_.month);
+}
+
+inline PRESENT_CONSTEXPR Date
+Date::last_day_of_month() const
+{
+    assert(this->has_error == 0);
+    return Date::create(this->data_.year, this->data_.month,
+            present_internal::days_in_month(
+                this->data_.year, this->data_.month));
+}
+
+inline PRESENT_CONSTEXPR int_delta
+Date::count_weekday_between(
+        const Date & first,
+        const Date & end,
+        int_day_of_week day_of_week)
+{
+    assert(first.has_error == 0);
+    assert(end.has_error == 0);
+    assert(day_of_week <= DAY_OF_WEEK_SUNDAY);
+
+    /* Count the days with that day of the week before each date, starting
+       from a day with that day of the week (day 0 was a Thursday) */
+    return present_internal::floor_div(
+            present_internal::days_from_civil(
+                end.data_.year, end.data_.month, end.data_.day) -
+            (day_of_week - DAY_OF_WEEK_THURSDAY) +
+            present_internal::days_in_week - 1,
+            present_internal::days_in_week) -
+        present_internal::floor_div(
+            present_internal::days_from_civil(
+                first.data_.year, first.data_.month, first.data_.day) -
+            (day_of_week - DAY_OF_WEEK_THURSDAY) +
+            present_internal::days_in_week - 1,
+            present_internal::days_in_week);
 }
 
-inline DayDelta
+inline void
+Date::count_weekday_between_batch(
+        const Date * firsts,
+        const Date * ends,
+        int_day_of_week day_of_week,
+        int_delta * results,
+        size_t count)
+{
+    Date_batch_count_weekday_between(
+            firsts, ends, day_of_week, results, count);
+}
+
+inline size_t
+Date::format(const char * format, char * buffer, size_t buffer_size) const
+{
+    return Date_format(this, format, buffer, buffer_size);
+}
+
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+
+inline PRESENT_CONSTEXPR std::chrono::year_month_day
+Date::to_year_month_day() const
+{
+    assert(this->has_error == 0);
+    return std::chrono::year_month_day(
+            std::chrono::year(this->data_.year),
+            std::chrono::month((unsigned)this->data_.month),
+            std::chrono::day((unsigned)this->data_.day));
+}
+
+inline PRESENT_CONSTEXPR std::chrono::sys_days
+Date::to_sys_days() const
+{
+    assert(this->has_error == 0);
+    return std::chrono::sys_days(std::chrono::days(
+                present_internal::days_from_civil(
+                    this->data_.year, this->data_.month, this->data_.day)));
+}
+
+#endif
+
+inline PRESENT_CONSTEXPR DayDelta
 Date::difference(const Date & other) const
 {
-    return Date_difference(this, &other);
+    assert(this->has_error == 0);
+    assert(other.has_error == 0);
+    return DayDelta::from_days(
+            present_internal::days_from_civil(
+                this->data_.year, this->data_.month, this->data_.day) -
+            present_internal::days_from_civil(
+                other.data_.year, other.data_.month, other.data_.day));
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 Date::absolute_difference(const Date & other) const
 {
-    return Date_absolute_difference(this, &other);
+    DayDelta delta = this->difference(other);
+    if (delta.is_negative()) {
+        delta.negate();
+    }
+    return delta;
 }
 
-inline Date &
+inline PRESENT_CONSTEXPR Date &
 Date::operator+=(const DayDelta & delta)
 {
-    Date_add_DayDelta(this, &delta);
+    assert(this->has_error == 0);
+    present_internal::civil_from_days(
+            present_internal::days_from_civil(
+                this->data_.year, this->data_.month, this->data_.day) +
+            delta.data_.delta_days,
+            this->data_);
     return *this;
 }
 
-inline Date &
+inline PRESENT_CONSTEXPR Date &
 Date::operator+=(const MonthDelta & delta)
 {
-    Date_add_MonthDelta(this, &delta);
+    assert(this->has_error == 0);
+    present_internal::civil_from_days(
+            present_internal::days_from_civil(
+                this->data_.year,
+                (int_delta)this->data_.month + delta.data_.delta_months,
+                this->data_.day),
+            this->data_);
     return *this;
 }
 
-inline Date &
+inline PRESENT_CONSTEXPR Date &
 Date::operator-=(const DayDelta & delta)
 {
-    Date_subtract_DayDelta(this, &delta);
+    assert(this->has_error == 0);
+    present_internal::civil_from_days(
+            present_internal::days_from_civil(
+                this->data_.year, this->data_.month, this->data_.day) -
+            delta.data_.delta_days,
+            this->data_);
     return *this;
 }
 
-inline Date &
+inline PRESENT_CONSTEXPR Date &
 Date::operator-=(const MonthDelta & delta)
 {
-    Date_subtract_MonthDelta(this, &delta);
+    assert(this->has_error == 0);
+    present_internal::civil_from_days(
+            present_internal::days_from_civil(
+                this->data_.year,
+                (int_delta)this->data_.month - delta.data_.delta_months,
+                this->data_.day),
+            this->data_);
     return *this;
 }
 
-inline const Date
+inline PRESENT_CONSTEXPR const Date
 operator+(const Date & lhs, const DayDelta & rhs)
 {
     return (Date(lhs) += rhs);
 }
-inline const Date
+inline PRESENT_CONSTEXPR const Date
 operator+(const DayDelta & lhs, const Date & rhs)
 {
     return (Date(rhs) += lhs);
 }
 
-inline const Date
+inline PRESENT_CONSTEXPR const Date
 operator+(const Date & lhs, const MonthDelta & rhs)
 {
     return (Date(lhs) += rhs);
 }
-inline const Date
+inline PRESENT_CONSTEXPR const Date
 operator+(const MonthDelta & lhs, const Date & rhs)
 {
     return (Date(rhs) += lhs);
 }
 
-inline const Date
+inline PRESENT_CONSTEXPR const Date
 operator-(const Date & lhs, const DayDelta & rhs)
 {
     return (Date(lhs) -= rhs);
 }
 
-inline const Date
+inline PRESENT_CONSTEXPR const Date
 operator-(const Date & lhs, const MonthDelta & rhs)
 {
     return (Date(lhs) -= rhs);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 Date::compare(const Date & lhs, const Date & rhs)
 {
-    return Date_compare(&lhs, &rhs);
+    assert(lhs.has_error == 0);
+    assert(rhs.has_error == 0);
+    return present_internal::compare(
+            lhs.data_.year, rhs.data_.year,
+            present_internal::compare(
+                lhs.data_.month, rhs.data_.month,
+                present_internal::compare(
+                    lhs.data_.day, rhs.data_.day, 0)));
+}
+
+inline void
+Date::sort(Date * dates, size_t count)
+{
+    if (!Date_sort(dates, count)) {
+        present_internal::throw_bad_alloc();
+    }
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const Date & lhs, const Date & rhs)
 {
-    return Date_equal(&lhs, &rhs);
+    return Date::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const Date & lhs, const Date & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const Date & lhs, const Date & rhs)
 {
-    return Date_less_than(&lhs, &rhs);
+    return Date::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const Date & lhs, const Date & rhs)
 {
-    return Date_less_than_or_equal(&lhs, &rhs);
+    return Date::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const Date & lhs, const Date & rhs)
 {
-    return Date_greater_than(&lhs, &rhs);
+    return Date::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const Date & lhs, const Date & rhs)
 {
-    return Date_greater_than_or_equal(&lhs, &rhs);
+    return Date::compare(lhs, rhs) >= 0;
 }
 
@@ -12,67 +12,64 @@
 
 #include <assert.h>
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 DayDelta::from_days(int_delta days)
 {
-    DayDelta result;
-    DayDelta_ptr_from_days(&result, days);
+    DayDelta result = DayDelta();
+    result.data_.delta_days = days;
     return result;
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 DayDelta::from_weeks(int_delta weeks)
 {
-    DayDelta result;
-    DayDelta_ptr_from_weeks(&result, weeks);
-    return result;
+    return DayDelta::from_days(weeks * present_internal::days_in_week);
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 DayDelta::zero()
 {
-    DayDelta result;
-    DayDelta_ptr_zero(&result);
-    return result;
+    return DayDelta::from_days(0);
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 DayDelta::days() const
 {
-    return DayDelta_days(this);
+    return this->data_.delta_days;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 DayDelta::weeks() const
 {
-    return DayDelta_weeks(this);
+    return this->data_.delta_days / present_internal::days_in_week;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 DayDelta::weeks_decimal() const
 {
-    return DayDelta_weeks_decimal(this);
+    return ((double)this->data_.delta_days) /
+        (double)present_internal::days_in_week;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 DayDelta::to_TimeDelta() const
 {
-    return DayDelta_to_TimeDelta(this);
+    return TimeDelta::from_days(this->data_.delta_days);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 DayDelta::is_negative() const
 {
-    return DayDelta_is_negative(this);
+    return this->data_.delta_days < 0;
 }
 
-inline void
+inline PRESENT_CONSTEXPR void
 DayDelta::negate()
 {
-    DayDelta_negate(this);
+    this->data_.delta_days = -this->data_.delta_days;
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 DayDelta::operator-() const
 {
     DayDelta copy(*this);
@@ -80,14 +77,14 @@ DayDelta::operator-() const
     return copy;
 }
 
-inline DayDelta &
+inline PRESENT_CONSTEXPR DayDelta &
 DayDelta::operator++()
 {
     this->data_.delta_days += 1;
     return *this;
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 DayDelta::operator++(int)
 {
     DayDelta copy(*this);
@@ -95,14 +92,14 @@ DayDelta::operator++(int)
     return copy;
 }
 
-inline DayDelta &
+inline PRESENT_CONSTEXPR DayDelta &
 DayDelta::operator--()
 {
     this->data_.delta_days -= 1;
     return *this;
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 DayDelta::operator--(int)
 {
     DayDelta copy(*this);
@@ -110,145 +107,146 @@ DayDelta::operator--(int)
     return copy;
 }
 
-inline DayDelta &
+inline PRESENT_CONSTEXPR DayDelta &
 DayDelta::operator*=(const long & scale_factor)
 {
-    DayDelta_multiply_by(this, scale_factor);
+    this->data_.delta_days *= scale_factor;
     return *this;
 }
 
-inline DayDelta &
+inline PRESENT_CONSTEXPR DayDelta &
 DayDelta::operator/=(const long & scale_factor)
 {
-    DayDelta_divide_by(this, scale_factor);
+    this->data_.delta_days /= scale_factor;
     return *this;
 }
 
-inline const DayDelta
+inline PRESENT_CONSTEXPR const DayDelta
 operator*(const DayDelta & lhs, const long & rhs)
 {
     return (DayDelta(lhs) *= rhs);
 }
 
-inline const DayDelta
+inline PRESENT_CONSTEXPR const DayDelta
 operator/(const DayDelta & lhs, const long & rhs)
 {
     return (DayDelta(lhs) /= rhs);
 }
 
-inline DayDelta &
+inline PRESENT_CONSTEXPR DayDelta &
 DayDelta::operator+=(const DayDelta & other)
 {
-    DayDelta_add(this, &other);
+    this->data_.delta_days += other.data_.delta_days;
     return *this;
 }
 
-inline DayDelta &
+inline PRESENT_CONSTEXPR DayDelta &
 DayDelta::operator-=(const DayDelta & other)
 {
-    DayDelta_subtract(this, &other);
+    this->data_.delta_days -= other.data_.delta_days;
     return *this;
 }
 
-inline const DayDelta
+inline PRESENT_CONSTEXPR const DayDelta
 operator+(const DayDelta & lhs, const DayDelta & rhs)
 {
     return (DayDelta(lhs) += rhs);
 }
 
-inline const DayDelta
+inline PRESENT_CONSTEXPR const DayDelta
 operator-(const DayDelta & lhs, const DayDelta & rhs)
 {
     return (DayDelta(lhs) -= rhs);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 DayDelta::compare(const DayDelta & lhs, const DayDelta & rhs)
 {
-    return DayDelta_compare(&lhs, &rhs);
+    return present_internal::compare(
+            lhs.data_.delta_days, rhs.data_.delta_days, 0);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 DayDelta::compare(const DayDelta & lhs, const TimeDelta & rhs)
 {
-    return DayDelta_compare_to_TimeDelta(&lhs, &rhs);
+    return -TimeDelta::compare(rhs, lhs);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 DayDelta::compare(const TimeDelta & lhs, const DayDelta & rhs)
 {
-    return -DayDelta_compare_to_TimeDelta(&rhs, &lhs);
+    return TimeDelta::compare(lhs, rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const DayDelta & lhs, const DayDelta & rhs)
 {
-    return DayDelta_equal(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const DayDelta & lhs, const TimeDelta & rhs)
 {
-    return DayDelta_equal_TimeDelta(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const DayDelta & lhs, const DayDelta & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const DayDelta & lhs, const TimeDelta & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const DayDelta & lhs, const DayDelta & rhs)
 {
-    return DayDelta_less_than(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const DayDelta & lhs, const TimeDelta & rhs)
 {
-    return DayDelta_less_than_TimeDelta(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const DayDelta & lhs, const DayDelta & rhs)
 {
-    return DayDelta_less_than_or_equal(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const DayDelta & lhs, const TimeDelta & rhs)
 {
-    return DayDelta_less_than_or_equal_TimeDelta(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const DayDelta & lhs, const DayDelta & rhs)
 {
-    return DayDelta_greater_than(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const DayDelta & lhs, const TimeDelta & rhs)
 {
-    return DayDelta_greater_than_TimeDelta(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const DayDelta & lhs, const DayDelta & rhs)
 {
-    return DayDelta_greater_than_or_equal(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) >= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const DayDelta & lhs, const TimeDelta & rhs)
 {
-    return DayDelta_greater_than_or_equal_TimeDelta(&lhs, &rhs);
+    return DayDelta::compare(lhs, rhs) >= 0;
 }
 
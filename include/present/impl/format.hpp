@@ -0,0 +1,574 @@
+/*
+ * Present - Date/Time Library
+ *
+ * PresentFormat (a strftime-like format that is compiled ahead of time), and
+ * the std::format and {fmt} formatters for the C++ classes
+ *
+ * The formatters are only defined if they are available:
+ *
+ * - std::formatter specializations are defined when compiling as C++20 or
+ *   later with a standard library that has <format>.
+ * - fmt::formatter specializations are defined if <fmt/format.h> is included
+ *   before "present.h".
+ *
+ * The format specification is the same as the format string for
+ * Date_format, ClockTime_format, and Timestamp_format (for example,
+ * std::format("{:%FT%T}", timestamp)); Timestamps are always formatted in
+ * UTC. When the format string is checked at compile time, the format
+ * specification is compiled into a PresentFormat then too.
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "present/internal/format-utils.h"
+
+#if __cplusplus >= 202002L && defined(__has_include)
+# if __has_include(<format>)
+#  include <format>
+# endif
+#endif
+
+/**
+ * A strftime-like format string (see Date_format) that has been compiled
+ * into a fixed sequence of literal characters and conversions, so formatting
+ * a value neither parses the format string nor checks the space left in the
+ * buffer for each conversion.
+ *
+ * When compiling as C++14 or later, the format can be compiled at compile
+ * time:
+ *
+ *     constexpr PresentFormat iso = PresentFormat::compile("%FT%T");
+ */
+struct PresentFormat {
+    /** The most literal characters and conversions in a format. */
+    static const size_t max_items = 64;
+
+    /** A buffer of this size can hold the output of any PresentFormat. */
+    static const size_t max_output_size =
+        max_items * PRESENT_FORMAT_MAX_CONVERSION_LENGTH + 1;
+
+    /** This will be true if the format string could not be compiled. */
+    present_bool has_error;
+
+    /** If has_error is true, then one or more of these will be set. */
+    struct {
+        unsigned int invalid_conversion : 1,
+                     too_long           : 1;
+    } errors;
+
+    /* Literal characters and conversions (the characters after the "%") */
+    char items_[max_items];
+    /* Whether each item in items_ is a conversion */
+    present_bool conversions_[max_items];
+    /* Number of items in items_ */
+    size_t item_count_;
+    /* Parts of a value that the conversions need (PRESENT_FORMAT_*) */
+    int needs_;
+    /* The most characters the format can produce */
+    size_t max_length_;
+
+    /** Compile the format string between begin and end. */
+    template <typename Iterator>
+    static PRESENT_CONSTEXPR PresentFormat compile(
+            Iterator begin,
+            Iterator end);
+
+    /** Compile a NUL-terminated format string. */
+    static PRESENT_CONSTEXPR PresentFormat compile(const char * format);
+
+    /** Get the most characters that this format can produce. */
+    PRESENT_CONSTEXPR size_t max_length() const;
+
+    /**
+     * Determine whether this format can be used for a value that has the
+     * provided parts (PRESENT_FORMAT_DATE, PRESENT_FORMAT_CLOCK_TIME,
+     * and/or PRESENT_FORMAT_TIMESTAMP).
+     */
+    PRESENT_CONSTEXPR bool can_format(int available) const;
+
+    /**
+     * Write the formatted fields to out (which must have room for at least
+     * max_length() characters), without a terminating NUL.
+     *
+     * @return A pointer to the character after the last one written.
+     */
+    char * write(const PresentFormatFields & fields, char * out) const;
+
+    /** @copydoc Date_format */
+    size_t format(
+            const Date & date,
+            char * buffer,
+            size_t buffer_size) const;
+
+    /** @copydoc ClockTime_format */
+    size_t format(
+            const ClockTime & clock_time,
+            char * buffer,
+            size_t buffer_size) const;
+
+    /** @copydoc Timestamp_format */
+    size_t format(
+            const Timestamp & timestamp,
+            const TimeDelta & time_zone_offset,
+            char * buffer,
+            size_t buffer_size) const;
+
+    /** @copydoc Timestamp_format_utc */
+    size_t format_utc(
+            const Timestamp & timestamp,
+            char * buffer,
+            size_t buffer_size) const;
+
+private:
+    size_t format_fields(
+            const PresentFormatFields & fields,
+            int available,
+            char * buffer,
+            size_t buffer_size) const;
+};
+
+template <typename Iterator>
+inline PRESENT_CONSTEXPR PresentFormat
+PresentFormat::compile(Iterator begin, Iterator end)
+{
+    PresentFormat result = PresentFormat();
+    int max_length = 0, needs = 0;
+
+    for (Iterator it = begin; it != end; ++it) {
+        if (result.item_count_ == PresentFormat::max_items) {
+            result.has_error = true;
+            result.errors.too_long = 1;
+            break;
+        }
+
+        if (*it == '%') {
+            ++it;
+            max_length = (it == end) ? 0 :
+                present_format_conversion_info(*it, &needs);
+            if (max_length == 0) {
+                result.has_error = true;
+                result.errors.invalid_conversion = 1;
+                break;
+            }
+            result.conversions_[result.item_count_] = true;
+            result.needs_ |= needs;
+        } else {
+            max_length = 1;
+        }
+        result.items_[result.item_count_] = *it;
+        result.item_count_ += 1;
+        result.max_length_ += (size_t)max_length;
+    }
+    return result;
+}
+
+inline PRESENT_CONSTEXPR PresentFormat
+PresentFormat::compile(const char * format)
+{
+    const char * end = format;
+    while (*end != '\0') {
+        ++end;
+    }
+    return PresentFormat::compile(format, end);
+}
+
+inline PRESENT_CONSTEXPR size_t
+PresentFormat::max_length() const
+{
+    return this->max_length_;
+}
+
+inline PRESENT_CONSTEXPR bool
+PresentFormat::can_format(int available) const
+{
+    return !this->has_error && (this->needs_ & ~available) == 0;
+}
+
+inline char *
+PresentFormat::write(const PresentFormatFields & fields, char * out) const
+{
+    for (size_t i = 0; i < this->item_count_; ++i) {
+        if (this->conversions_[i]) {
+            out = present_format_conversion(out, this->items_[i], &fields);
+        } else {
+            *out++ = this->items_[i];
+        }
+    }
+    return out;
+}
+
+inline size_t
+PresentFormat::format_fields(
+        const PresentFormatFields & fields,
+        int available,
+        char * buffer,
+        size_t buffer_size) const
+{
+    char scratch[PresentFormat::max_output_size];
+    size_t length = 0;
+
+    if (buffer_size == 0) {
+        return 0;
+    }
+    if (!this->can_format(available)) {
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    if (buffer_size > this->max_length_) {
+        length = (size_t)(this->write(fields, buffer) - buffer);
+    } else {
+        /* The output might not fit, so we can't write it directly */
+        length = (size_t)(this->write(fields, scratch) - scratch);
+        if (length >= buffer_size) {
+            buffer[0] = '\0';
+            return 0;
+        }
+        memcpy(buffer, scratch, length);
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+inline size_t
+PresentFormat::format(
+        const Date & date,
+        char * buffer,
+        size_t buffer_size) const
+{
+    PresentFormatFields fields = PresentFormatFields();
+
+    assert(date.has_error == 0);
+    fields.date = date.data_;
+    return this->format_fields(
+            fields, PRESENT_FORMAT_DATE, buffer, buffer_size);
+}
+
+inline size_t
+PresentFormat::format(
+        const ClockTime & clock_time,
+        char * buffer,
+        size_t buffer_size) const
+{
+    PresentFormatFields fields = PresentFormatFields();
+
+    assert(clock_time.has_error == 0);
+    fields.clock_time = clock_time.data_;
+    return this->format_fields(
+            fields, PRESENT_FORMAT_CLOCK_TIME, buffer, buffer_size);
+}
+
+inline size_t
+PresentFormat::format(
+        const Timestamp & timestamp,
+        const TimeDelta & time_zone_offset,
+        char * buffer,
+        size_t buffer_size) const
+{
+    PresentFormatFields fields = PresentFormatFields();
+
+    assert(timestamp.has_error == 0);
+    present_format_timestamp_fields(
+            &fields,
+            timestamp.data_.timestamp_seconds,
+            timestamp.data_.additional_nanoseconds,
+            time_zone_offset.seconds());
+    return this->format_fields(fields,
+            PRESENT_FORMAT_DATE | PRESENT_FORMAT_CLOCK_TIME |
+            PRESENT_FORMAT_TIMESTAMP,
+            buffer, buffer_size);
+}
+
+inline size_t
+PresentFormat::format_utc(
+        const Timestamp & timestamp,
+        char * buffer,
+        size_t buffer_size) const
+{
+    return this->format(timestamp, TimeDelta::zero(), buffer, buffer_size);
+}
+
+namespace present_internal {
+
+/**
+ * The parts of each class that can be formatted, and the format used when
+ * the format specification is empty.
+ */
+template <typename T>
+struct FormatTraits;
+
+template <>
+struct FormatTraits<Date> {
+    static const int available = PRESENT_FORMAT_DATE;
+
+    static PRESENT_CONSTEXPR const char * default_format() {
+        return "%F";
+    }
+
+    static void fill(const Date & date, PresentFormatFields & fields) {
+        assert(date.has_error == 0);
+        fields.date = date.data_;
+    }
+};
+
+template <>
+struct FormatTraits<ClockTime> {
+    static const int available = PRESENT_FORMAT_CLOCK_TIME;
+
+    static PRESENT_CONSTEXPR const char * default_format() {
+        return "%T.%f";
+    }
+
+    static void fill(
+            const ClockTime & clock_time,
+            PresentFormatFields & fields) {
+        assert(clock_time.has_error == 0);
+        fields.clock_time = clock_time.data_;
+    }
+};
+
+template <>
+struct FormatTraits<Timestamp> {
+    static const int available = PRESENT_FORMAT_DATE |
+        PRESENT_FORMAT_CLOCK_TIME | PRESENT_FORMAT_TIMESTAMP;
+
+    static PRESENT_CONSTEXPR const char * default_format() {
+        return "%FT%T.%fZ";
+    }
+
+    static void fill(
+            const Timestamp & timestamp,
+            PresentFormatFields & fields) {
+        assert(timestamp.has_error == 0);
+        present_format_timestamp_fields(
+                &fields,
+                timestamp.data_.timestamp_seconds,
+                timestamp.data_.additional_nanoseconds,
+                0);
+    }
+};
+
+/**
+ * Common implementation of the std::format and {fmt} formatters for Date,
+ * ClockTime, and Timestamp.
+ */
+template <typename T>
+struct Formatter {
+    PresentFormat format_;
+
+    PRESENT_CONSTEXPR Formatter() : format_(PresentFormat()) {}
+
+    /**
+     * Compile the format specification starting at it (which is advanced to
+     * the closing "}"). Returns an error message, or NULL if successful.
+     */
+    template <typename Iterator>
+    PRESENT_CONSTEXPR const char * compile(Iterator & it, Iterator end) {
+        Iterator close = it;
+        while (close != end && *close != '}') {
+            ++close;
+        }
+
+        this->format_ = (close == it)
+            ? PresentFormat::compile(FormatTraits<T>::default_format())
+            : PresentFormat::compile(it, close);
+        it = close;
+
+        if (this->format_.has_error) {
+            return "invalid Present format specification";
+        }
+        if (!this->format_.can_format(FormatTraits<T>::available)) {
+            return "Present format specification has conversions that do "
+                "not apply to this type";
+        }
+        return 0;
+    }
+
+    template <typename OutputIterator>
+    OutputIterator write(const T & value, OutputIterator out) const {
+        PresentFormatFields fields = PresentFormatFields();
+        char buffer[PresentFormat::max_output_size];
+        const char * end = 0;
+
+        FormatTraits<T>::fill(value, fields);
+        end = this->format_.write(fields, buffer);
+        for (const char * c = buffer; c != end; ++c) {
+            *out++ = *c;
+        }
+        return out;
+    }
+};
+
+/** Write a TimeDelta as an ISO 8601 duration (e.g. "PT5400.5S"). */
+inline char *
+write_iso_duration(const TimeDelta & delta, char * out)
+{
+    int_delta seconds = delta.data_.delta_seconds;
+    int_delta nanoseconds = delta.data_.delta_nanoseconds;
+    int digits = 9;
+
+    /* delta_seconds and delta_nanoseconds always have the same sign */
+    if (seconds < 0 || nanoseconds < 0) {
+        *out++ = '-';
+        seconds = -seconds;
+        nanoseconds = -nanoseconds;
+    }
+    *out++ = 'P';
+    *out++ = 'T';
+    out = present_format_integer(out, seconds, 1);
+    if (nanoseconds != 0) {
+        while (nanoseconds % 10 == 0) {
+            nanoseconds /= 10;
+            digits -= 1;
+        }
+        *out++ = '.';
+        out = present_format_digits(out, (present_uint64)nanoseconds, digits);
+    }
+    *out++ = 'S';
+    return out;
+}
+
+/** Write a DayDelta as an ISO 8601 duration (e.g. "P3D"). */
+inline char *
+write_iso_duration(const DayDelta & delta, char * out)
+{
+    int_delta days = delta.data_.delta_days;
+
+    if (days < 0) {
+        *out++ = '-';
+        days = -days;
+    }
+    *out++ = 'P';
+    out = present_format_integer(out, days, 1);
+    *out++ = 'D';
+    return out;
+}
+
+/** Write a MonthDelta as an ISO 8601 duration (e.g. "P14M"). */
+inline char *
+write_iso_duration(const MonthDelta & delta, char * out)
+{
+    int_delta months = delta.data_.delta_months;
+
+    if (months < 0) {
+        *out++ = '-';
+        months = -months;
+    }
+    *out++ = 'P';
+    out = present_format_integer(out, months, 1);
+    *out++ = 'M';
+    return out;
+}
+
+/**
+ * Common implementation of the std::format and {fmt} formatters for
+ * TimeDelta, DayDelta, and MonthDelta (which are always formatted as ISO
+ * 8601 durations, and do not take a format specification).
+ */
+template <typename T>
+struct DeltaFormatter {
+    template <typename Iterator>
+    PRESENT_CONSTEXPR const char * compile(Iterator & it, Iterator end) {
+        if (it != end && *it != '}') {
+            return "Present delta types do not take a format specification";
+        }
+        return 0;
+    }
+
+    template <typename OutputIterator>
+    OutputIterator write(const T & value, OutputIterator out) const {
+        char buffer[2 * PRESENT_FORMAT_MAX_CONVERSION_LENGTH + 4];
+        const char * end = write_iso_duration(value, buffer);
+
+        for (const char * c = buffer; c != end; ++c) {
+            *out++ = *c;
+        }
+        return out;
+    }
+};
+
+}
+
+#ifdef __cpp_lib_format
+
+/*
+ * Without exceptions, an invalid format specification aborts (or, when the
+ * format string is checked at compile time, fails to compile)
+ */
+#ifdef PRESENT_HAS_EXCEPTIONS
+# define PRESENT_FORMAT_ERROR(message) throw format_error(message)
+#else
+# define PRESENT_FORMAT_ERROR(message) abort()
+#endif
+
+#define PRESENT_STD_FORMATTER(__Class__, __Base__)                          \
+    template <>                                                             \
+    struct formatter<__Class__, char> :                                     \
+            present_internal::__Base__<__Class__> {                         \
+        constexpr format_parse_context::iterator                            \
+        parse(format_parse_context & ctx) {                                 \
+            format_parse_context::iterator it = ctx.begin();                \
+            const char * error = this->compile(it, ctx.end());              \
+            if (error) PRESENT_FORMAT_ERROR(error);                         \
+            return it;                                                      \
+        }                                                                   \
+        template <typename FormatContext>                                   \
+        typename FormatContext::iterator                                    \
+        format(const __Class__ & value, FormatContext & ctx) const {        \
+            return this->write(value, ctx.out());                           \
+        }                                                                   \
+    };
+
+namespace std {
+PRESENT_STD_FORMATTER(ClockTime, Formatter)
+PRESENT_STD_FORMATTER(Date, Formatter)
+PRESENT_STD_FORMATTER(Timestamp, Formatter)
+PRESENT_STD_FORMATTER(DayDelta, DeltaFormatter)
+PRESENT_STD_FORMATTER(MonthDelta, DeltaFormatter)
+PRESENT_STD_FORMATTER(TimeDelta, DeltaFormatter)
+}
+
+#undef PRESENT_STD_FORMATTER
+#undef PRESENT_FORMAT_ERROR
+
+#endif
+
+#ifdef FMT_VERSION
+
+#define PRESENT_FMT_FORMATTER(__Class__, __Base__)                          \
+    template <>                                                             \
+    struct formatter<__Class__> : present_internal::__Base__<__Class__> {   \
+        PRESENT_CONSTEXPR format_parse_context::iterator                    \
+        parse(format_parse_context & ctx) {                                 \
+            format_parse_context::iterator it = ctx.begin();                \
+            const char * error = this->compile(it, ctx.end());              \
+            if (error) FMT_THROW(format_error(error));                      \
+            return it;                                                      \
+        }                                                                   \
+        template <typename FormatContext>                                   \
+        auto format(const __Class__ & value, FormatContext & ctx) const     \
+            -> decltype(ctx.out()) {                                        \
+            return this->write(value, ctx.out());                           \
+        }                                                                   \
+    };
+
+namespace fmt {
+PRESENT_FMT_FORMATTER(ClockTime, Formatter)
+PRESENT_FMT_FORMATTER(Date, Formatter)
+PRESENT_FMT_FORMATTER(Timestamp, Formatter)
+PRESENT_FMT_FORMATTER(DayDelta, DeltaFormatter)
+PRESENT_FMT_FORMATTER(MonthDelta, DeltaFormatter)
+PRESENT_FMT_FORMATTER(TimeDelta, DeltaFormatter)
+}
+
+#undef PRESENT_FMT_FORMATTER
+
+#endif
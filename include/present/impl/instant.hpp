@@ -0,0 +1,175 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the Instant and Stopwatch C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+/*
+ * Instant
+ */
+
+inline Instant
+Instant::now()
+{
+    return Instant_now();
+}
+
+inline Instant
+Instant::now(int clock)
+{
+    return Instant_now_from(clock);
+}
+
+inline int
+Instant::clock() const
+{
+    return Instant_get_clock(this);
+}
+
+inline TimeDelta
+Instant::elapsed() const
+{
+    return Instant_elapsed(this);
+}
+
+inline Instant &
+Instant::operator+=(const TimeDelta & delta)
+{
+    Instant_add_TimeDelta(this, &delta);
+    return *this;
+}
+
+inline Instant &
+Instant::operator-=(const TimeDelta & delta)
+{
+    Instant_subtract_TimeDelta(this, &delta);
+    return *this;
+}
+
+inline Instant
+operator+(const Instant & lhs, const TimeDelta & rhs)
+{
+    Instant result = lhs;
+    return result += rhs;
+}
+
+inline Instant
+operator+(const TimeDelta & lhs, const Instant & rhs)
+{
+    Instant result = rhs;
+    return result += lhs;
+}
+
+inline Instant
+operator-(const Instant & lhs, const TimeDelta & rhs)
+{
+    Instant result = lhs;
+    return result -= rhs;
+}
+
+inline TimeDelta
+operator-(const Instant & lhs, const Instant & rhs)
+{
+    return Instant_difference(&lhs, &rhs);
+}
+
+inline short
+Instant::compare(const Instant & lhs, const Instant & rhs)
+{
+    return Instant_compare(&lhs, &rhs);
+}
+
+inline bool
+operator==(const Instant & lhs, const Instant & rhs)
+{
+    return Instant_equal(&lhs, &rhs);
+}
+
+inline bool
+operator!=(const Instant & lhs, const Instant & rhs)
+{
+    return !(lhs == rhs);
+}
+
+inline bool
+operator<(const Instant & lhs, const Instant & rhs)
+{
+    return Instant_less_than(&lhs, &rhs);
+}
+
+inline bool
+operator<=(const Instant & lhs, const Instant & rhs)
+{
+    return Instant_less_than_or_equal(&lhs, &rhs);
+}
+
+inline bool
+operator>(const Instant & lhs, const Instant & rhs)
+{
+    return Instant_greater_than(&lhs, &rhs);
+}
+
+inline bool
+operator>=(const Instant & lhs, const Instant & rhs)
+{
+    return Instant_greater_than_or_equal(&lhs, &rhs);
+}
+
+/*
+ * Stopwatch
+ */
+
+inline Stopwatch
+Stopwatch::start()
+{
+    return Stopwatch_start();
+}
+
+inline Stopwatch
+Stopwatch::stopped()
+{
+    return Stopwatch_stopped();
+}
+
+inline bool
+Stopwatch::is_running() const
+{
+    return Stopwatch_is_running(this);
+}
+
+inline TimeDelta
+Stopwatch::elapsed() const
+{
+    return Stopwatch_elapsed(this);
+}
+
+inline TimeDelta
+Stopwatch::stop()
+{
+    return Stopwatch_stop(this);
+}
+
+inline void
+Stopwatch::resume()
+{
+    Stopwatch_resume(this);
+}
+
+inline void
+Stopwatch::restart()
+{
+    Stopwatch_restart(this);
+}
+
+inline TimeDelta
+Stopwatch::lap()
+{
+    return Stopwatch_lap(this);
+}
+
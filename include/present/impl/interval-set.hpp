@@ -0,0 +1,174 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the IntervalSet C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+inline
+IntervalSet::IntervalSet()
+{
+    IntervalSet_init(this);
+}
+
+inline
+IntervalSet::IntervalSet(const TimeInterval * intervals, size_t count)
+{
+    IntervalSet_init(this);
+    if (!IntervalSet_assign_intervals(this, intervals, count)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline
+IntervalSet::IntervalSet(const IntervalSet & other)
+{
+    IntervalSet_init(this);
+    if (!IntervalSet_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline IntervalSet &
+IntervalSet::operator=(const IntervalSet & other)
+{
+    if (!IntervalSet_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline
+IntervalSet::~IntervalSet()
+{
+    IntervalSet_destroy(this);
+}
+
+inline size_t
+IntervalSet::size() const
+{
+    return IntervalSet_count(this);
+}
+
+inline bool
+IntervalSet::empty() const
+{
+    return size_ == 0;
+}
+
+inline TimeInterval
+IntervalSet::operator[](size_t index) const
+{
+    return IntervalSet_get(this, index);
+}
+
+inline void
+IntervalSet::clear()
+{
+    IntervalSet_clear(this);
+}
+
+inline void
+IntervalSet::add(const TimeInterval & interval)
+{
+    if (!IntervalSet_add(this, &interval)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline bool
+IntervalSet::contains(const Timestamp & timestamp) const
+{
+    return IntervalSet_contains(this, &timestamp) != 0;
+}
+
+inline TimeDelta
+IntervalSet::total_duration() const
+{
+    return IntervalSet_total_duration(this);
+}
+
+inline Timestamp
+IntervalSet::find_free_slot(
+        const Timestamp & after,
+        const TimeDelta & duration) const
+{
+    return IntervalSet_find_free_slot(this, &after, &duration);
+}
+
+inline IntervalSet &
+IntervalSet::operator|=(const IntervalSet & other)
+{
+    if (!IntervalSet_union(this, this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline IntervalSet &
+IntervalSet::operator&=(const IntervalSet & other)
+{
+    if (!IntervalSet_intersection(this, this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline IntervalSet &
+IntervalSet::operator-=(const IntervalSet & other)
+{
+    if (!IntervalSet_difference(this, this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline IntervalSet
+operator|(const IntervalSet & lhs, const IntervalSet & rhs)
+{
+    IntervalSet result;
+    if (!IntervalSet_union(&result, &lhs, &rhs)) {
+        present_internal::throw_bad_alloc();
+    }
+    return result;
+}
+
+inline IntervalSet
+operator&(const IntervalSet & lhs, const IntervalSet & rhs)
+{
+    IntervalSet result;
+    if (!IntervalSet_intersection(&result, &lhs, &rhs)) {
+        present_internal::throw_bad_alloc();
+    }
+    return result;
+}
+
+inline IntervalSet
+operator-(const IntervalSet & lhs, const IntervalSet & rhs)
+{
+    IntervalSet result;
+    if (!IntervalSet_difference(&result, &lhs, &rhs)) {
+        present_internal::throw_bad_alloc();
+    }
+    return result;
+}
+
+inline bool
+operator==(const IntervalSet & lhs, const IntervalSet & rhs)
+{
+    return IntervalSet_equal(&lhs, &rhs) != 0;
+}
+
+inline bool
+operator!=(const IntervalSet & lhs, const IntervalSet & rhs)
+{
+    return IntervalSet_equal(&lhs, &rhs) == 0;
+}
+
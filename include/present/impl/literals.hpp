@@ -0,0 +1,214 @@
+/*
+ * Present - Date/Time Library
+ *
+ * User-defined literals for the C++ classes (C++11 and above)
+ *
+ * These are in the "present_literals" namespace, and can be used like this:
+ *
+ *     using namespace present_literals;
+ *     constexpr Date deadline = "2024-03-01"_date;
+ *     constexpr TimeDelta timeout = 90_min;
+ *
+ * When compiling as C++14 or later, all the literals are constexpr.
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+namespace present_internal {
+
+/**
+ * Parse a non-negative decimal number of between 1 and max_digits digits
+ * from str, starting at pos (which is advanced past the number).
+ * Returns -1 if there is no number at pos.
+ */
+inline PRESENT_CONSTEXPR int_delta
+parse_literal_number(
+        const char * str,
+        size_t length,
+        size_t & pos,
+        size_t max_digits)
+{
+    int_delta value = 0;
+    size_t digits = 0;
+
+    while (pos < length && digits < max_digits &&
+            str[pos] >= '0' && str[pos] <= '9') {
+        value = value * 10 + (str[pos] - '0');
+        ++pos;
+        ++digits;
+    }
+    return digits == 0 ? -1 : value;
+}
+
+/** Consume the separator character c from str at pos, if it is there. */
+inline PRESENT_CONSTEXPR bool
+parse_literal_separator(
+        const char * str,
+        size_t length,
+        size_t & pos,
+        char c)
+{
+    if (pos < length && str[pos] == c) {
+        ++pos;
+        return true;
+    }
+    return false;
+}
+
+}
+
+namespace present_literals {
+
+/**
+ * Create a Date from a string in ISO 8601 "YYYY-MM-DD" format.
+ *
+ * If the string is malformed, then the Date will have its month_out_of_range
+ * error set; if the day does not exist in the month, then the Date will have
+ * its day_out_of_range error set (just like Date::create).
+ */
+inline PRESENT_CONSTEXPR Date
+operator"" _date(const char * str, size_t length)
+{
+    size_t pos = 0;
+    const bool negative =
+        present_internal::parse_literal_separator(str, length, pos, '-');
+    int_delta year = 0, month = 0, day = 0;
+
+    year = present_internal::parse_literal_number(str, length, pos, 9);
+    if (present_internal::parse_literal_separator(str, length, pos, '-')) {
+        month = present_internal::parse_literal_number(str, length, pos, 2);
+    }
+    if (present_internal::parse_literal_separator(str, length, pos, '-')) {
+        day = present_internal::parse_literal_number(str, length, pos, 2);
+    }
+    if (year < 0 || month < 0 || day < 0 || pos != length) {
+        /* Malformed; month 0 will always be reported as out of range */
+        return Date::create(0, 0, 1);
+    }
+
+    return Date::create(
+            (int_year)(negative ? -year : year),
+            (int_month)month,
+            (int_day)day);
+}
+
+/**
+ * Create a ClockTime from a string in "HH:MM", "HH:MM:SS", or
+ * "HH:MM:SS.fffffffff" format.
+ *
+ * If the string is malformed, then the ClockTime will have its
+ * hour_out_of_range error set; any fields that are out of range are reported
+ * just like ClockTime::create.
+ */
+inline PRESENT_CONSTEXPR ClockTime
+operator"" _clock_time(const char * str, size_t length)
+{
+    size_t pos = 0, fraction_start = 0;
+    int_delta hour = 0, minute = -1, second = 0, nanosecond = 0;
+
+    hour = present_internal::parse_literal_number(str, length, pos, 2);
+    if (present_internal::parse_literal_separator(str, length, pos, ':')) {
+        minute = present_internal::parse_literal_number(str, length, pos, 2);
+    }
+    if (present_internal::parse_literal_separator(str, length, pos, ':')) {
+        second = present_internal::parse_literal_number(str, length, pos, 2);
+        if (present_internal::parse_literal_separator(
+                    str, length, pos, '.')) {
+            fraction_start = pos;
+            nanosecond = present_internal::parse_literal_number(
+                    str, length, pos, 9);
+            for (size_t i = pos - fraction_start; i < 9; ++i) {
+                nanosecond *= 10;
+            }
+        }
+    }
+    if (hour < 0 || minute < 0 || second < 0 || nanosecond < 0 ||
+            pos != length) {
+        /* Malformed; hour -1 will always be reported as out of range */
+        return ClockTime::create(-1, 0, 0, 0);
+    }
+
+    return ClockTime::create(
+            (int_hour)hour,
+            (int_minute)minute,
+            (int_second)second,
+            (int_nanosecond)nanosecond);
+}
+
+/** Create a TimeDelta from a number of nanoseconds. */
+inline PRESENT_CONSTEXPR TimeDelta
+operator"" _ns(unsigned long long nanoseconds)
+{
+    return TimeDelta::from_nanoseconds((int_delta)nanoseconds);
+}
+
+/** Create a TimeDelta from a number of microseconds. */
+inline PRESENT_CONSTEXPR TimeDelta
+operator"" _us(unsigned long long microseconds)
+{
+    return TimeDelta::from_microseconds((int_delta)microseconds);
+}
+
+/** Create a TimeDelta from a number of milliseconds. */
+inline PRESENT_CONSTEXPR TimeDelta
+operator"" _ms(unsigned long long milliseconds)
+{
+    return TimeDelta::from_milliseconds((int_delta)milliseconds);
+}
+
+/** Create a TimeDelta from a number of seconds. */
+inline PRESENT_CONSTEXPR TimeDelta
+operator"" _s(unsigned long long seconds)
+{
+    return TimeDelta::from_seconds((int_delta)seconds);
+}
+
+/** Create a TimeDelta from a number of minutes. */
+inline PRESENT_CONSTEXPR TimeDelta
+operator"" _min(unsigned long long minutes)
+{
+    return TimeDelta::from_minutes((int_delta)minutes);
+}
+
+/** Create a TimeDelta from a number of hours. */
+inline PRESENT_CONSTEXPR TimeDelta
+operator"" _h(unsigned long long hours)
+{
+    return TimeDelta::from_hours((int_delta)hours);
+}
+
+/** Create a DayDelta from a number of days. */
+inline PRESENT_CONSTEXPR DayDelta
+operator"" _days(unsigned long long days)
+{
+    return DayDelta::from_days((int_delta)days);
+}
+
+/** Create a DayDelta from a number of weeks. */
+inline PRESENT_CONSTEXPR DayDelta
+operator"" _weeks(unsigned long long weeks)
+{
+    return DayDelta::from_weeks((int_delta)weeks);
+}
+
+/** Create a MonthDelta from a number of months. */
+inline PRESENT_CONSTEXPR MonthDelta
+operator"" _months(unsigned long long months)
+{
+    return MonthDelta::from_months((int_month_delta)months);
+}
+
+/** Create a MonthDelta from a number of years. */
+inline PRESENT_CONSTEXPR MonthDelta
+operator"" _years(unsigned long long years)
+{
+    return MonthDelta::from_years((int_year_delta)years);
+}
+
+}
@@ -12,61 +12,62 @@
 
 #include <assert.h>
 
-inline MonthDelta
+inline PRESENT_CONSTEXPR MonthDelta
 MonthDelta::from_months(int_month_delta months)
 {
-    MonthDelta result;
-    MonthDelta_ptr_from_months(&result, months);
+    MonthDelta result = MonthDelta();
+    result.data_.delta_months = months;
     return result;
 }
 
-inline MonthDelta
+inline PRESENT_CONSTEXPR MonthDelta
 MonthDelta::from_years(int_year_delta years)
 {
-    MonthDelta result;
-    MonthDelta_ptr_from_years(&result, years);
+    MonthDelta result = MonthDelta();
+    result.data_.delta_months =
+        (int_month_delta)(years * present_internal::months_in_year);
     return result;
 }
 
-inline MonthDelta
+inline PRESENT_CONSTEXPR MonthDelta
 MonthDelta::zero()
 {
-    MonthDelta result;
-    MonthDelta_ptr_zero(&result);
-    return result;
+    return MonthDelta::from_months(0);
 }
 
-inline int_month_delta
+inline PRESENT_CONSTEXPR int_month_delta
 MonthDelta::months() const
 {
-    return MonthDelta_months(this);
+    return this->data_.delta_months;
 }
 
-inline int_year_delta
+inline PRESENT_CONSTEXPR int_year_delta
 MonthDelta::years() const
 {
-    return MonthDelta_years(this);
+    return (int_year_delta)(
+        this->data_.delta_months / present_internal::months_in_year);
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 MonthDelta::years_decimal() const
 {
-    return MonthDelta_years_decimal(this);
+    return ((double)this->data_.delta_months) /
+        (double)present_internal::months_in_year;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 MonthDelta::is_negative() const
 {
-    return MonthDelta_is_negative(this);
+    return this->data_.delta_months < 0;
 }
 
-inline void
+inline PRESENT_CONSTEXPR void
 MonthDelta::negate()
 {
-    MonthDelta_negate(this);
+    this->data_.delta_months = -this->data_.delta_months;
 }
 
-inline MonthDelta
+inline PRESENT_CONSTEXPR MonthDelta
 MonthDelta::operator-() const
 {
     MonthDelta copy(*this);
@@ -74,14 +75,14 @@ MonthDelta::operator-() const
     return copy;
 }
 
-inline MonthDelta &
+inline PRESENT_CONSTEXPR MonthDelta &
 MonthDelta::operator++()
 {
     this->data_.delta_months += 1;
     return *this;
 }
 
-inline MonthDelta
+inline PRESENT_CONSTEXPR MonthDelta
 MonthDelta::operator++(int)
 {
     MonthDelta copy(*this);
@@ -89,14 +90,14 @@ MonthDelta::operator++(int)
     return copy;
 }
 
-inline MonthDelta &
+inline PRESENT_CONSTEXPR MonthDelta &
 MonthDelta::operator--()
 {
     this->data_.delta_months -= 1;
     return *this;
 }
 
-inline MonthDelta
+inline PRESENT_CONSTEXPR MonthDelta
 MonthDelta::operator--(int)
 {
     MonthDelta copy(*this);
@@ -104,97 +105,98 @@ MonthDelta::operator--(int)
     return copy;
 }
 
-inline MonthDelta &
+inline PRESENT_CONSTEXPR MonthDelta &
 MonthDelta::operator*=(const long & scale_factor)
 {
-    MonthDelta_multiply_by(this, scale_factor);
+    this->data_.delta_months *= scale_factor;
     return *this;
 }
 
-inline MonthDelta &
+inline PRESENT_CONSTEXPR MonthDelta &
 MonthDelta::operator/=(const long & scale_factor)
 {
-    MonthDelta_divide_by(this, scale_factor);
+    this->data_.delta_months /= scale_factor;
     return *this;
 }
 
-inline const MonthDelta
+inline PRESENT_CONSTEXPR const MonthDelta
 operator*(const MonthDelta & lhs, const long & rhs)
 {
     return (MonthDelta(lhs) *= rhs);
 }
 
-inline const MonthDelta
+inline PRESENT_CONSTEXPR const MonthDelta
 operator/(const MonthDelta & lhs, const long & rhs)
 {
     return (MonthDelta(lhs) /= rhs);
 }
 
-inline MonthDelta &
+inline PRESENT_CONSTEXPR MonthDelta &
 MonthDelta::operator+=(const MonthDelta & other)
 {
-    MonthDelta_add(this, &other);
+    this->data_.delta_months += other.data_.delta_months;
     return *this;
 }
 
-inline MonthDelta &
+inline PRESENT_CONSTEXPR MonthDelta &
 MonthDelta::operator-=(const MonthDelta & other)
 {
-    MonthDelta_subtract(this, &other);
+    this->data_.delta_months -= other.data_.delta_months;
     return *this;
 }
 
-inline const MonthDelta
+inline PRESENT_CONSTEXPR const MonthDelta
 operator+(const MonthDelta & lhs, const MonthDelta & rhs)
 {
     return (MonthDelta(lhs) += rhs);
 }
 
-inline const MonthDelta
+inline PRESENT_CONSTEXPR const MonthDelta
 operator-(const MonthDelta & lhs, const MonthDelta & rhs)
 {
     return (MonthDelta(lhs) -= rhs);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 MonthDelta::compare(const MonthDelta & lhs, const MonthDelta & rhs)
 {
-    return MonthDelta_compare(&lhs, &rhs);
+    return present_internal::compare(
+            lhs.data_.delta_months, rhs.data_.delta_months, 0);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const MonthDelta & lhs, const MonthDelta & rhs)
 {
-    return MonthDelta_equal(&lhs, &rhs);
+    return MonthDelta::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const MonthDelta & lhs, const MonthDelta & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const MonthDelta & lhs, const MonthDelta & rhs)
 {
-    return MonthDelta_less_than(&lhs, &rhs);
+    return MonthDelta::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const MonthDelta & lhs, const MonthDelta & rhs)
 {
-    return MonthDelta_less_than_or_equal(&lhs, &rhs);
+    return MonthDelta::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const MonthDelta & lhs, const MonthDelta & rhs)
 {
-    return MonthDelta_greater_than(&lhs, &rhs);
+    return MonthDelta::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const MonthDelta & lhs, const MonthDelta & rhs)
 {
-    return MonthDelta_greater_than_or_equal(&lhs, &rhs);
+    return MonthDelta::compare(lhs, rhs) >= 0;
 }
 
@@ -0,0 +1,643 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Policy-templated variants of the C++ classes that can have errors:
+ * BasicDate, BasicClockTime, and BasicTimestamp
+ *
+ * The policy determines what happens when one of these is created from
+ * out-of-range values:
+ *
+ * - present_policy::Flags (the same as the plain Date, ClockTime, and
+ *   Timestamp classes): has_error and the error bitfields are set, and the
+ *   accessors assert that there is no error.
+ * - present_policy::Throwing: a PresentError is thrown. No error state is
+ *   stored, so the accessors never need to check it.
+ * - present_policy::Unchecked: nothing is validated, and no error state is
+ *   stored. The caller guarantees that all values are in range (this is
+ *   only checked with assert, when creating from a Date/ClockTime/Timestamp).
+ *
+ * For Throwing and Unchecked, the object is exactly the size of its internal
+ * data representation (e.g. sizeof(BasicDate<present_policy::Unchecked>) ==
+ * sizeof(PresentDateData)).
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stdexcept>
+
+/**
+ * Exception thrown when creating a BasicDate, BasicClockTime, or
+ * BasicTimestamp with the present_policy::Throwing policy from out-of-range
+ * values.
+ */
+class PresentError : public std::invalid_argument {
+public:
+    explicit PresentError(const char * what) : std::invalid_argument(what) {}
+};
+
+namespace present_internal {
+
+/** Get a description of the first error on a Date. */
+inline const char *
+error_message(const Date & date)
+{
+    if (date.errors.month_out_of_range) return "Date: month out of range";
+    if (date.errors.day_out_of_range) return "Date: day out of range";
+    if (date.errors.week_of_year_out_of_range)
+        return "Date: week of year out of range";
+    if (date.errors.day_of_week_out_of_range)
+        return "Date: day of week out of range";
+    return "Date: invalid date";
+}
+
+/** Get a description of the first error on a ClockTime. */
+inline const char *
+error_message(const ClockTime & clock_time)
+{
+    if (clock_time.errors.hour_out_of_range)
+        return "ClockTime: hour out of range";
+    if (clock_time.errors.minute_out_of_range)
+        return "ClockTime: minute out of range";
+    if (clock_time.errors.second_out_of_range)
+        return "ClockTime: second out of range";
+    if (clock_time.errors.nanosecond_out_of_range)
+        return "ClockTime: nanosecond out of range";
+    return "ClockTime: invalid clock time";
+}
+
+/** Get a description of the first error on a Timestamp. */
+inline const char *
+error_message(const Timestamp & timestamp)
+{
+    if (timestamp.errors.invalid_date) return "Timestamp: invalid date";
+    if (timestamp.errors.invalid_clock_time)
+        return "Timestamp: invalid clock time";
+    return "Timestamp: invalid timestamp";
+}
+
+/**
+ * Storage for a policy-templated class that has no error state (only the
+ * internal data representation of T).
+ */
+template <typename T, typename Data, bool HasErrorState>
+struct PolicyStorage {
+    Data data_;
+
+    PRESENT_CONSTEXPR T value() const {
+        T result = T();
+        result.data_ = data_;
+        return result;
+    }
+
+    PRESENT_CONSTEXPR void assign(const T & value) {
+        data_ = value.data_;
+    }
+
+    PRESENT_CONSTEXPR bool stored_error() const {
+        return false;
+    }
+};
+
+/**
+ * Storage for a policy-templated class that keeps the error state (the
+ * entire T).
+ */
+template <typename T, typename Data>
+struct PolicyStorage<T, Data, true> {
+    T value_;
+
+    PRESENT_CONSTEXPR T value() const {
+        return value_;
+    }
+
+    PRESENT_CONSTEXPR void assign(const T & value) {
+        value_ = value;
+    }
+
+    PRESENT_CONSTEXPR bool stored_error() const {
+        return value_.has_error;
+    }
+};
+
+}
+
+namespace present_policy {
+
+/**
+ * Errors are recorded in has_error and the error bitfields (this is the
+ * behavior of the plain Date, ClockTime, and Timestamp classes).
+ */
+struct Flags {
+    static const bool validates = true;
+    static const bool has_error_state = true;
+
+    template <typename T>
+    static PRESENT_CONSTEXPR const T & check(const T & value) {
+        return value;
+    }
+};
+
+/** Errors are reported by throwing a PresentError. */
+struct Throwing {
+    static const bool validates = true;
+    static const bool has_error_state = false;
+
+    template <typename T>
+    static PRESENT_CONSTEXPR const T & check(const T & value) {
+        if (value.has_error) {
+            throw PresentError(present_internal::error_message(value));
+        }
+        return value;
+    }
+};
+
+/** Nothing is validated; all values must already be in range. */
+struct Unchecked {
+    static const bool validates = false;
+    static const bool has_error_state = false;
+
+    template <typename T>
+    static PRESENT_CONSTEXPR const T & check(const T & value) {
+        assert(value.has_error == 0);
+        return value;
+    }
+};
+
+}
+
+/**
+ * A Date with a compile-time error-handling policy.
+ * @see Date
+ */
+template <typename Policy>
+struct BasicDate {
+    /* Internal data representation (and error state, for Flags) */
+    present_internal::PolicyStorage<
+        Date, PresentDateData, Policy::has_error_state> storage_;
+
+    /** Create from a Date, checking it according to the policy. */
+    static PRESENT_CONSTEXPR BasicDate from(const Date & date) {
+        BasicDate result = BasicDate();
+        result.storage_.assign(Policy::check(date));
+        return result;
+    }
+
+    /** @copydoc Date_from_year */
+    static PRESENT_CONSTEXPR BasicDate create(int_year year) {
+        return BasicDate::create(year, 1, 1);
+    }
+
+    /** @copydoc Date_from_year_month */
+    static PRESENT_CONSTEXPR BasicDate create(int_year year, int_month month) {
+        return BasicDate::create(year, month, 1);
+    }
+
+    /** @copydoc Date_from_year_month_day */
+    static PRESENT_CONSTEXPR BasicDate create(
+            int_year year,
+            int_month month,
+            int_day day) {
+        BasicDate result = BasicDate();
+        Date date = Date();
+
+        if (Policy::validates) {
+            result.storage_.assign(
+                    Policy::check(Date::create(year, month, day)));
+        } else {
+            date.data_.year = year;
+            date.data_.month = month;
+            date.data_.day = day;
+            present_internal::normalize_date_data(date.data_);
+            result.storage_.assign(date);
+        }
+        return result;
+    }
+
+    /** Determine whether there were any errors when creating this Date. */
+    PRESENT_CONSTEXPR bool has_error() const {
+        return this->storage_.stored_error();
+    }
+
+    /** Convert to a plain Date. */
+    PRESENT_CONSTEXPR operator Date() const {
+        return this->storage_.value();
+    }
+
+    /** @copydoc Date_year */
+    PRESENT_CONSTEXPR int_year year() const {
+        return this->storage_.value().year();
+    }
+
+    /** @copydoc Date_month */
+    PRESENT_CONSTEXPR int_month month() const {
+        return this->storage_.value().month();
+    }
+
+    /** @copydoc Date_day */
+    PRESENT_CONSTEXPR int_day day() const {
+        return this->storage_.value().day();
+    }
+
+    /** @copydoc Date_day_of_year */
+    PRESENT_CONSTEXPR int_day_of_year day_of_year() const {
+        return this->storage_.value().day_of_year();
+    }
+
+    /** @copydoc Date_week_of_year */
+    PRESENT_CONSTEXPR PresentWeekYear week_of_year() const {
+        return this->storage_.value().week_of_year();
+    }
+
+    /** @copydoc Date_day_of_week */
+    PRESENT_CONSTEXPR int_day_of_week day_of_week() const {
+        return this->storage_.value().day_of_week();
+    }
+
+    /** @copydoc Date_difference */
+    PRESENT_CONSTEXPR DayDelta difference(const BasicDate & other) const {
+        return this->storage_.value().difference(other.storage_.value());
+    }
+
+    /** @copydoc Date_absolute_difference */
+    PRESENT_CONSTEXPR DayDelta absolute_difference(
+            const BasicDate & other) const {
+        return this->storage_.value().absolute_difference(
+                other.storage_.value());
+    }
+
+    /** @copydoc Date_add_DayDelta */
+    PRESENT_CONSTEXPR BasicDate & operator+=(const DayDelta & delta) {
+        this->storage_.assign(this->storage_.value() + delta);
+        return *this;
+    }
+
+    /** @copydoc Date_add_MonthDelta */
+    PRESENT_CONSTEXPR BasicDate & operator+=(const MonthDelta & delta) {
+        this->storage_.assign(this->storage_.value() + delta);
+        return *this;
+    }
+
+    /** @copydoc Date_subtract_DayDelta */
+    PRESENT_CONSTEXPR BasicDate & operator-=(const DayDelta & delta) {
+        this->storage_.assign(this->storage_.value() - delta);
+        return *this;
+    }
+
+    /** @copydoc Date_subtract_MonthDelta */
+    PRESENT_CONSTEXPR BasicDate & operator-=(const MonthDelta & delta) {
+        this->storage_.assign(this->storage_.value() - delta);
+        return *this;
+    }
+
+    /** @copydoc Date_compare */
+    static PRESENT_CONSTEXPR short compare(
+            const BasicDate & lhs,
+            const BasicDate & rhs) {
+        return Date::compare(lhs.storage_.value(), rhs.storage_.value());
+    }
+};
+
+/**
+ * A ClockTime with a compile-time error-handling policy.
+ * @see ClockTime
+ */
+template <typename Policy>
+struct BasicClockTime {
+    /* Internal data representation (and error state, for Flags) */
+    present_internal::PolicyStorage<
+        ClockTime, PresentClockTimeData, Policy::has_error_state> storage_;
+
+    /** Create from a ClockTime, checking it according to the policy. */
+    static PRESENT_CONSTEXPR BasicClockTime from(
+            const ClockTime & clock_time) {
+        BasicClockTime result = BasicClockTime();
+        result.storage_.assign(Policy::check(clock_time));
+        return result;
+    }
+
+    /** @copydoc ClockTime_from_hour */
+    static PRESENT_CONSTEXPR BasicClockTime create(int_hour hour) {
+        return BasicClockTime::create(hour, 0, 0, 0);
+    }
+
+    /** @copydoc ClockTime_from_hour_minute */
+    static PRESENT_CONSTEXPR BasicClockTime create(
+            int_hour hour,
+            int_minute minute) {
+        return BasicClockTime::create(hour, minute, 0, 0);
+    }
+
+    /** @copydoc ClockTime_from_hour_minute_second */
+    static PRESENT_CONSTEXPR BasicClockTime create(
+            int_hour hour,
+            int_minute minute,
+            int_second second) {
+        return BasicClockTime::create(hour, minute, second, 0);
+    }
+
+    /** @copydoc ClockTime_from_hour_minute_second_nanosecond */
+    static PRESENT_CONSTEXPR BasicClockTime create(
+            int_hour hour,
+            int_minute minute,
+            int_second second,
+            int_nanosecond nanosecond) {
+        BasicClockTime result = BasicClockTime();
+        ClockTime clock_time = ClockTime();
+
+        if (Policy::validates) {
+            result.storage_.assign(Policy::check(
+                        ClockTime::create(hour, minute, second, nanosecond)));
+        } else {
+            clock_time.data_.seconds = second +
+                minute * present_internal::seconds_in_minute +
+                hour * present_internal::seconds_in_hour;
+            clock_time.data_.nanoseconds = nanosecond;
+            result.storage_.assign(clock_time);
+        }
+        return result;
+    }
+
+    /** @copydoc ClockTime_midnight */
+    static PRESENT_CONSTEXPR BasicClockTime midnight() {
+        return BasicClockTime::create(0, 0, 0, 0);
+    }
+
+    /** @copydoc ClockTime_noon */
+    static PRESENT_CONSTEXPR BasicClockTime noon() {
+        return BasicClockTime::create(12, 0, 0, 0);
+    }
+
+    /** Determine whether there were any errors creating this ClockTime. */
+    PRESENT_CONSTEXPR bool has_error() const {
+        return this->storage_.stored_error();
+    }
+
+    /** Convert to a plain ClockTime. */
+    PRESENT_CONSTEXPR operator ClockTime() const {
+        return this->storage_.value();
+    }
+
+    /** @copydoc ClockTime_hour */
+    PRESENT_CONSTEXPR int_hour hour() const {
+        return this->storage_.value().hour();
+    }
+
+    /** @copydoc ClockTime_minute */
+    PRESENT_CONSTEXPR int_minute minute() const {
+        return this->storage_.value().minute();
+    }
+
+    /** @copydoc ClockTime_second */
+    PRESENT_CONSTEXPR int_second second() const {
+        return this->storage_.value().second();
+    }
+
+    /** @copydoc ClockTime_nanosecond */
+    PRESENT_CONSTEXPR int_nanosecond nanosecond() const {
+        return this->storage_.value().nanosecond();
+    }
+
+    /** @copydoc ClockTime_second_decimal */
+    PRESENT_CONSTEXPR double second_decimal() const {
+        return this->storage_.value().second_decimal();
+    }
+
+    /** @copydoc ClockTime_time_since_midnight */
+    PRESENT_CONSTEXPR TimeDelta time_since_midnight() const {
+        return this->storage_.value().time_since_midnight();
+    }
+
+    /** @copydoc ClockTime_add_TimeDelta */
+    PRESENT_CONSTEXPR BasicClockTime & operator+=(const TimeDelta & delta) {
+        this->storage_.assign(this->storage_.value() + delta);
+        return *this;
+    }
+
+    /** @copydoc ClockTime_subtract_TimeDelta */
+    PRESENT_CONSTEXPR BasicClockTime & operator-=(const TimeDelta & delta) {
+        this->storage_.assign(this->storage_.value() - delta);
+        return *this;
+    }
+
+    /** @copydoc ClockTime_compare */
+    static PRESENT_CONSTEXPR short compare(
+            const BasicClockTime & lhs,
+            const BasicClockTime & rhs) {
+        return ClockTime::compare(lhs.storage_.value(), rhs.storage_.value());
+    }
+};
+
+/**
+ * A Timestamp with a compile-time error-handling policy.
+ * @see Timestamp
+ */
+template <typename Policy>
+struct BasicTimestamp {
+    /* Internal data representation (and error state, for Flags) */
+    present_internal::PolicyStorage<
+        Timestamp, PresentTimestampData, Policy::has_error_state> storage_;
+
+    /** Create from a Timestamp, checking it according to the policy. */
+    static PRESENT_CONSTEXPR BasicTimestamp from(const Timestamp & timestamp) {
+        BasicTimestamp result = BasicTimestamp();
+        result.storage_.assign(Policy::check(timestamp));
+        return result;
+    }
+
+    /** @copydoc Timestamp_from_time_t */
+    static PRESENT_CONSTEXPR BasicTimestamp create(const time_t time) {
+        return BasicTimestamp::from(Timestamp::create(time));
+    }
+
+    /** @copydoc Timestamp_create */
+    static PRESENT_CONSTEXPR BasicTimestamp create(
+            const BasicDate<Policy> & date,
+            const BasicClockTime<Policy> & clock_time,
+            const TimeDelta & time_zone_offset) {
+        BasicTimestamp result = BasicTimestamp::create_utc(date, clock_time);
+        if (!result.has_error()) {
+            result -= time_zone_offset;
+        }
+        return result;
+    }
+
+    /** @copydoc Timestamp_create_utc */
+    static PRESENT_CONSTEXPR BasicTimestamp create_utc(
+            const BasicDate<Policy> & date,
+            const BasicClockTime<Policy> & clock_time) {
+        /* The Date and ClockTime have already been checked according to the
+           policy, so this can only fail if they have errors with Flags */
+        return BasicTimestamp::from(Timestamp::create_utc(
+                    Date(date), ClockTime(clock_time)));
+    }
+
+    /** @copydoc Timestamp_now */
+    static BasicTimestamp now() {
+        return BasicTimestamp::from(Timestamp::now());
+    }
+
+    /** @copydoc Timestamp_epoch */
+    static PRESENT_CONSTEXPR BasicTimestamp epoch() {
+        return BasicTimestamp::from(Timestamp::epoch());
+    }
+
+    /** Determine whether there were any errors creating this Timestamp. */
+    PRESENT_CONSTEXPR bool has_error() const {
+        return this->storage_.stored_error();
+    }
+
+    /** Convert to a plain Timestamp. */
+    PRESENT_CONSTEXPR operator Timestamp() const {
+        return this->storage_.value();
+    }
+
+    /** @copydoc Timestamp_get_time_t */
+    PRESENT_CONSTEXPR time_t get_time_t() const {
+        return this->storage_.value().get_time_t();
+    }
+
+    /** @copydoc Timestamp_get_date */
+    PRESENT_CONSTEXPR BasicDate<Policy> get_date(
+            const TimeDelta & time_zone_offset) const {
+        return BasicDate<Policy>::from(
+                this->storage_.value().get_date(time_zone_offset));
+    }
+
+    /** @copydoc Timestamp_get_date_utc */
+    PRESENT_CONSTEXPR BasicDate<Policy> get_date_utc() const {
+        return BasicDate<Policy>::from(this->storage_.value().get_date_utc());
+    }
+
+    /** @copydoc Timestamp_get_clock_time */
+    PRESENT_CONSTEXPR BasicClockTime<Policy> get_clock_time(
+            const TimeDelta & time_zone_offset) const {
+        return BasicClockTime<Policy>::from(
+                this->storage_.value().get_clock_time(time_zone_offset));
+    }
+
+    /** @copydoc Timestamp_get_clock_time_utc */
+    PRESENT_CONSTEXPR BasicClockTime<Policy> get_clock_time_utc() const {
+        return BasicClockTime<Policy>::from(
+                this->storage_.value().get_clock_time_utc());
+    }
+
+    /** @copydoc Timestamp_difference */
+    PRESENT_CONSTEXPR TimeDelta difference(
+            const BasicTimestamp & other) const {
+        return this->storage_.value().difference(other.storage_.value());
+    }
+
+    /** @copydoc Timestamp_absolute_difference */
+    PRESENT_CONSTEXPR TimeDelta absolute_difference(
+            const BasicTimestamp & other) const {
+        return this->storage_.value().absolute_difference(
+                other.storage_.value());
+    }
+
+    /** @copydoc Timestamp_add_TimeDelta */
+    PRESENT_CONSTEXPR BasicTimestamp & operator+=(const TimeDelta & delta) {
+        this->storage_.assign(this->storage_.value() + delta);
+        return *this;
+    }
+
+    /** @copydoc Timestamp_add_DayDelta */
+    PRESENT_CONSTEXPR BasicTimestamp & operator+=(const DayDelta & delta) {
+        this->storage_.assign(this->storage_.value() + delta);
+        return *this;
+    }
+
+    /** @copydoc Timestamp_add_MonthDelta */
+    PRESENT_CONSTEXPR BasicTimestamp & operator+=(const MonthDelta & delta) {
+        this->storage_.assign(this->storage_.value() + delta);
+        return *this;
+    }
+
+    /** @copydoc Timestamp_subtract_TimeDelta */
+    PRESENT_CONSTEXPR BasicTimestamp & operator-=(const TimeDelta & delta) {
+        this->storage_.assign(this->storage_.value() - delta);
+        return *this;
+    }
+
+    /** @copydoc Timestamp_subtract_DayDelta */
+    PRESENT_CONSTEXPR BasicTimestamp & operator-=(const DayDelta & delta) {
+        this->storage_.assign(this->storage_.value() - delta);
+        return *this;
+    }
+
+    /** @copydoc Timestamp_subtract_MonthDelta */
+    PRESENT_CONSTEXPR BasicTimestamp & operator-=(const MonthDelta & delta) {
+        this->storage_.assign(this->storage_.value() - delta);
+        return *this;
+    }
+
+    /** @copydoc Timestamp_compare */
+    static PRESENT_CONSTEXPR short compare(
+            const BasicTimestamp & lhs,
+            const BasicTimestamp & rhs) {
+        return Timestamp::compare(lhs.storage_.value(), rhs.storage_.value());
+    }
+};
+
+/*
+ * Arithmetic and comparison operators shared by all the policy-templated
+ * classes
+ */
+
+#define PRESENT_POLICY_ARITHMETIC_OPERATORS(__Class__, __Delta__)           \
+    template <typename Policy>                                              \
+    inline PRESENT_CONSTEXPR const __Class__<Policy>                        \
+    operator+(const __Class__<Policy> & lhs, const __Delta__ & rhs)         \
+    {                                                                       \
+        return (__Class__<Policy>(lhs) += rhs);                             \
+    }                                                                       \
+    template <typename Policy>                                              \
+    inline PRESENT_CONSTEXPR const __Class__<Policy>                        \
+    operator+(const __Delta__ & lhs, const __Class__<Policy> & rhs)         \
+    {                                                                       \
+        return (__Class__<Policy>(rhs) += lhs);                             \
+    }                                                                       \
+    template <typename Policy>                                              \
+    inline PRESENT_CONSTEXPR const __Class__<Policy>                        \
+    operator-(const __Class__<Policy> & lhs, const __Delta__ & rhs)         \
+    {                                                                       \
+        return (__Class__<Policy>(lhs) -= rhs);                             \
+    }
+
+#define PRESENT_POLICY_COMPARISON_OPERATOR(__Class__, __Operator__)         \
+    template <typename Policy>                                              \
+    inline PRESENT_CONSTEXPR bool                                           \
+    operator __Operator__(                                                  \
+            const __Class__<Policy> & lhs,                                  \
+            const __Class__<Policy> & rhs)                                  \
+    {                                                                       \
+        return __Class__<Policy>::compare(lhs, rhs) __Operator__ 0;         \
+    }
+
+#define PRESENT_POLICY_COMPARISON_OPERATORS(__Class__)                      \
+    PRESENT_POLICY_COMPARISON_OPERATOR(__Class__, ==)                       \
+    PRESENT_POLICY_COMPARISON_OPERATOR(__Class__, !=)                       \
+    PRESENT_POLICY_COMPARISON_OPERATOR(__Class__, <)                        \
+    PRESENT_POLICY_COMPARISON_OPERATOR(__Class__, <=)                       \
+    PRESENT_POLICY_COMPARISON_OPERATOR(__Class__, >)                        \
+    PRESENT_POLICY_COMPARISON_OPERATOR(__Class__, >=)
+
+PRESENT_POLICY_ARITHMETIC_OPERATORS(BasicDate, DayDelta)
+PRESENT_POLICY_ARITHMETIC_OPERATORS(BasicDate, MonthDelta)
+PRESENT_POLICY_COMPARISON_OPERATORS(BasicDate)
+
+PRESENT_POLICY_ARITHMETIC_OPERATORS(BasicClockTime, TimeDelta)
+PRESENT_POLICY_COMPARISON_OPERATORS(BasicClockTime)
+
+PRESENT_POLICY_ARITHMETIC_OPERATORS(BasicTimestamp, TimeDelta)
+PRESENT_POLICY_ARITHMETIC_OPERATORS(BasicTimestamp, DayDelta)
+PRESENT_POLICY_ARITHMETIC_OPERATORS(BasicTimestamp, MonthDelta)
+PRESENT_POLICY_COMPARISON_OPERATORS(BasicTimestamp)
+
+#undef PRESENT_POLICY_ARITHMETIC_OPERATORS
+#undef PRESENT_POLICY_COMPARISON_OPERATOR
+#undef PRESENT_POLICY_COMPARISON_OPERATORS
@@ -0,0 +1,217 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the DateRange and TimestampRange C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+/*
+ * DateRangeIterator
+ */
+
+inline const Date &
+DateRangeIterator::operator*() const
+{
+    assert(this->remaining_ > 0);
+    return this->current_;
+}
+
+inline const Date *
+DateRangeIterator::operator->() const
+{
+    assert(this->remaining_ > 0);
+    return &this->current_;
+}
+
+inline DateRangeIterator &
+DateRangeIterator::operator++()
+{
+    DateRangeIterator_next(this);
+    return *this;
+}
+
+inline DateRangeIterator
+DateRangeIterator::operator++(int)
+{
+    DateRangeIterator copy(*this);
+    DateRangeIterator_next(this);
+    return copy;
+}
+
+inline bool
+operator==(const DateRangeIterator & lhs, const DateRangeIterator & rhs)
+{
+    return lhs.remaining_ == rhs.remaining_ &&
+        (lhs.remaining_ == 0 || lhs.current_ == rhs.current_);
+}
+
+inline bool
+operator!=(const DateRangeIterator & lhs, const DateRangeIterator & rhs)
+{
+    return !(lhs == rhs);
+}
+
+/*
+ * DateRange
+ */
+
+inline DateRange
+DateRange::create(const Date & first, const Date & end, const DayDelta & step)
+{
+    return DateRange_from_DayDelta(&first, &end, &step);
+}
+
+inline DateRange
+DateRange::create(
+        const Date & first,
+        const Date & end,
+        const MonthDelta & step)
+{
+    return DateRange_from_MonthDelta(&first, &end, &step);
+}
+
+inline size_t
+DateRange::size() const
+{
+    return DateRange_size(this);
+}
+
+inline bool
+DateRange::empty() const
+{
+    return DateRange_size(this) == 0;
+}
+
+inline Date
+DateRange::operator[](size_t index) const
+{
+    return DateRange_get(this, index);
+}
+
+inline size_t
+DateRange::materialize(Date * results, size_t capacity) const
+{
+    return DateRange_materialize(this, results, capacity);
+}
+
+inline DateRangeIterator
+DateRange::begin() const
+{
+    DateRangeIterator result;
+    DateRange_begin(this, &result);
+    return result;
+}
+
+inline DateRangeIterator
+DateRange::end() const
+{
+    return DateRangeIterator();
+}
+
+/*
+ * TimestampRangeIterator
+ */
+
+inline const Timestamp &
+TimestampRangeIterator::operator*() const
+{
+    assert(this->remaining_ > 0);
+    return this->current_;
+}
+
+inline const Timestamp *
+TimestampRangeIterator::operator->() const
+{
+    assert(this->remaining_ > 0);
+    return &this->current_;
+}
+
+inline TimestampRangeIterator &
+TimestampRangeIterator::operator++()
+{
+    TimestampRangeIterator_next(this);
+    return *this;
+}
+
+inline TimestampRangeIterator
+TimestampRangeIterator::operator++(int)
+{
+    TimestampRangeIterator copy(*this);
+    TimestampRangeIterator_next(this);
+    return copy;
+}
+
+inline bool
+operator==(
+        const TimestampRangeIterator & lhs,
+        const TimestampRangeIterator & rhs)
+{
+    return lhs.remaining_ == rhs.remaining_ &&
+        (lhs.remaining_ == 0 || lhs.current_ == rhs.current_);
+}
+
+inline bool
+operator!=(
+        const TimestampRangeIterator & lhs,
+        const TimestampRangeIterator & rhs)
+{
+    return !(lhs == rhs);
+}
+
+/*
+ * TimestampRange
+ */
+
+inline TimestampRange
+TimestampRange::create(
+        const Timestamp & first,
+        const Timestamp & end,
+        const TimeDelta & step)
+{
+    return TimestampRange_from_TimeDelta(&first, &end, &step);
+}
+
+inline size_t
+TimestampRange::size() const
+{
+    return TimestampRange_size(this);
+}
+
+inline bool
+TimestampRange::empty() const
+{
+    return TimestampRange_size(this) == 0;
+}
+
+inline Timestamp
+TimestampRange::operator[](size_t index) const
+{
+    return TimestampRange_get(this, index);
+}
+
+inline size_t
+TimestampRange::materialize(Timestamp * results, size_t capacity) const
+{
+    return TimestampRange_materialize(this, results, capacity);
+}
+
+inline TimestampRangeIterator
+TimestampRange::begin() const
+{
+    TimestampRangeIterator result;
+    TimestampRange_begin(this, &result);
+    return result;
+}
+
+inline TimestampRangeIterator
+TimestampRange::end() const
+{
+    return TimestampRangeIterator();
+}
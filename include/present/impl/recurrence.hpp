@@ -0,0 +1,82 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the Recurrence C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+/*
+ * Recurrence
+ */
+
+inline Recurrence
+Recurrence::create(
+        const Date & start,
+        const ClockTime & time,
+        const TimeDelta & time_zone_offset,
+        const char * rule)
+{
+    return Recurrence_from_rule(&start, &time, &time_zone_offset, rule);
+}
+
+inline void
+Recurrence::set_exdates(const Timestamp * exdates, size_t exdate_count)
+{
+    Recurrence_set_exdates(this, exdates, exdate_count);
+}
+
+inline RecurrenceIterator
+Recurrence::begin(const Timestamp & from) const
+{
+    RecurrenceIterator result;
+    Recurrence_begin(this, &from, NULL, &result);
+    return result;
+}
+
+inline RecurrenceIterator
+Recurrence::begin(const Timestamp & from, const Timestamp & end) const
+{
+    RecurrenceIterator result;
+    Recurrence_begin(this, &from, &end, &result);
+    return result;
+}
+
+inline size_t
+Recurrence::expand(
+        const Timestamp & from,
+        const Timestamp & end,
+        Timestamp * results,
+        size_t capacity) const
+{
+    return Recurrence_expand(this, &from, &end, results, capacity);
+}
+
+/*
+ * RecurrenceIterator
+ */
+
+inline bool
+RecurrenceIterator::done() const
+{
+    return RecurrenceIterator_done(this);
+}
+
+inline size_t
+RecurrenceIterator::next(Timestamp * results, size_t capacity)
+{
+    return RecurrenceIterator_next_timestamps(this, results, capacity);
+}
+
+inline size_t
+RecurrenceIterator::next(Date * results, size_t capacity)
+{
+    return RecurrenceIterator_next_dates(this, results, capacity);
+}
+
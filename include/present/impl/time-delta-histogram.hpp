@@ -0,0 +1,140 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimeDeltaHistogram C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+inline
+TimeDeltaHistogram::TimeDeltaHistogram()
+{
+    TimeDeltaHistogram_init(this);
+}
+
+inline
+TimeDeltaHistogram::TimeDeltaHistogram(
+        const TimeDelta & highest,
+        int precision)
+{
+    TimeDeltaHistogram_init(this);
+    configure(highest, precision);
+}
+
+inline
+TimeDeltaHistogram::TimeDeltaHistogram(const TimeDeltaHistogram & other)
+{
+    TimeDeltaHistogram_init(this);
+    if (!TimeDeltaHistogram_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline TimeDeltaHistogram &
+TimeDeltaHistogram::operator=(const TimeDeltaHistogram & other)
+{
+    if (!TimeDeltaHistogram_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline
+TimeDeltaHistogram::~TimeDeltaHistogram()
+{
+    TimeDeltaHistogram_destroy(this);
+}
+
+inline void
+TimeDeltaHistogram::configure(const TimeDelta & highest, int precision)
+{
+    if (!TimeDeltaHistogram_configure(this, &highest, precision)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline int
+TimeDeltaHistogram::precision() const
+{
+    return precision_;
+}
+
+inline size_t
+TimeDeltaHistogram::bucket_count() const
+{
+    return bucket_count_;
+}
+
+inline void
+TimeDeltaHistogram::record(const TimeDelta & value)
+{
+    TimeDeltaHistogram_record(this, &value);
+}
+
+inline void
+TimeDeltaHistogram::record(const TimeDelta & value, present_uint64 count)
+{
+    TimeDeltaHistogram_record_count(this, &value, count);
+}
+
+inline void
+TimeDeltaHistogram::merge(const TimeDeltaHistogram & other)
+{
+    TimeDeltaHistogram_merge(this, &other);
+}
+
+inline void
+TimeDeltaHistogram::clear()
+{
+    TimeDeltaHistogram_clear(this);
+}
+
+inline present_uint64
+TimeDeltaHistogram::count() const
+{
+    return TimeDeltaHistogram_count(this);
+}
+
+inline TimeDelta
+TimeDeltaHistogram::min() const
+{
+    return TimeDeltaHistogram_min(this);
+}
+
+inline TimeDelta
+TimeDeltaHistogram::max() const
+{
+    return TimeDeltaHistogram_max(this);
+}
+
+inline TimeDelta
+TimeDeltaHistogram::mean() const
+{
+    return TimeDeltaHistogram_mean(this);
+}
+
+inline TimeDelta
+TimeDeltaHistogram::value_at_quantile(double quantile) const
+{
+    return TimeDeltaHistogram_value_at_quantile(this, quantile);
+}
+
+inline size_t
+TimeDeltaHistogram::serialize(
+        unsigned char * buffer,
+        size_t buffer_size) const
+{
+    return TimeDeltaHistogram_serialize(this, buffer, buffer_size);
+}
+
+inline bool
+TimeDeltaHistogram::deserialize(const unsigned char * buffer, size_t size)
+{
+    return TimeDeltaHistogram_deserialize(this, buffer, size) != 0;
+}
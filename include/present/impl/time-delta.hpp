@@ -12,199 +12,280 @@
 
 #include <assert.h>
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_nanoseconds(int_delta nanoseconds)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_nanoseconds(&result, nanoseconds);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_nanoseconds = nanoseconds;
+    present_internal::normalize_time_delta_data(result.data_);
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_microseconds(int_delta microseconds)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_microseconds(&result, microseconds);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_nanoseconds = microseconds *
+        present_internal::nanoseconds_in_microsecond;
+    present_internal::normalize_time_delta_data(result.data_);
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_milliseconds(int_delta milliseconds)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_milliseconds(&result, milliseconds);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_nanoseconds = milliseconds *
+        present_internal::nanoseconds_in_millisecond;
+    present_internal::normalize_time_delta_data(result.data_);
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_seconds(int_delta seconds)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_seconds(&result, seconds);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_seconds = seconds;
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_minutes(int_delta minutes)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_minutes(&result, minutes);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_seconds = minutes * present_internal::seconds_in_minute;
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_hours(int_delta hours)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_hours(&result, hours);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_seconds = hours * present_internal::seconds_in_hour;
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_days(int_delta days)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_days(&result, days);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_seconds = days * present_internal::seconds_in_day;
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::from_weeks(int_delta weeks)
 {
-    TimeDelta result;
-    TimeDelta_ptr_from_weeks(&result, weeks);
+    TimeDelta result = TimeDelta();
+    result.data_.delta_seconds = weeks * present_internal::seconds_in_week;
     return result;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::zero()
 {
-    TimeDelta result;
-    TimeDelta_ptr_zero(&result);
+    return TimeDelta::from_seconds(0);
+}
+
+inline TimeDeltaSummary
+TimeDelta::summarize(const TimeDelta * deltas, size_t count)
+{
+    TimeDeltaSummary result;
+    TimeDelta_summarize(deltas, count, &result);
     return result;
 }
 
-inline int_delta
+inline TimeDeltaSummary
+TimeDelta::summarize_nanoseconds(const int_delta * nanoseconds, size_t count)
+{
+    TimeDeltaSummary result;
+    TimeDelta_summarize_nanoseconds(nanoseconds, count, &result);
+    return result;
+}
+
+#ifdef PRESENT_HAS_CHRONO
+
+template <typename Rep, typename Period>
+inline PRESENT_CONSTEXPR TimeDelta
+TimeDelta::from_duration(const std::chrono::duration<Rep, Period> & duration)
+{
+    TimeDelta result = TimeDelta();
+    present_internal::split_duration(duration,
+            result.data_.delta_seconds,
+            result.data_.delta_nanoseconds);
+    return result;
+}
+
+#endif
+
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::nanoseconds() const
 {
-    return TimeDelta_nanoseconds(this);
+    return this->data_.delta_seconds *
+        present_internal::nanoseconds_in_second +
+        this->data_.delta_nanoseconds;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::microseconds() const
 {
-    return TimeDelta_microseconds(this);
+    return this->data_.delta_seconds *
+        present_internal::microseconds_in_second +
+        this->data_.delta_nanoseconds /
+        present_internal::nanoseconds_in_microsecond;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 TimeDelta::microseconds_decimal() const
 {
-    return TimeDelta_microseconds_decimal(this);
+    return this->data_.delta_seconds *
+        present_internal::microseconds_in_second +
+        (double)this->data_.delta_nanoseconds /
+        (double)present_internal::nanoseconds_in_microsecond;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::milliseconds() const
 {
-    return TimeDelta_milliseconds(this);
+    return this->data_.delta_seconds *
+        present_internal::milliseconds_in_second +
+        this->data_.delta_nanoseconds /
+        present_internal::nanoseconds_in_millisecond;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 TimeDelta::milliseconds_decimal() const
 {
-    return TimeDelta_milliseconds_decimal(this);
+    return this->data_.delta_seconds *
+        present_internal::milliseconds_in_second +
+        (double)this->data_.delta_nanoseconds /
+        (double)present_internal::nanoseconds_in_millisecond;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::seconds() const
 {
-    return TimeDelta_seconds(this);
+    return this->data_.delta_seconds;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 TimeDelta::seconds_decimal() const
 {
-    return TimeDelta_seconds_decimal(this);
+    return this->data_.delta_seconds +
+        (double)this->data_.delta_nanoseconds /
+        (double)present_internal::nanoseconds_in_second;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::minutes() const
 {
-    return TimeDelta_minutes(this);
+    return this->seconds() / present_internal::seconds_in_minute;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 TimeDelta::minutes_decimal() const
 {
-    return TimeDelta_minutes_decimal(this);
+    return this->seconds_decimal() /
+        (double)present_internal::seconds_in_minute;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::hours() const
 {
-    return TimeDelta_hours(this);
+    return this->seconds() / present_internal::seconds_in_hour;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 TimeDelta::hours_decimal() const
 {
-    return TimeDelta_hours_decimal(this);
+    return this->seconds_decimal() /
+        (double)present_internal::seconds_in_hour;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::days() const
 {
-    return TimeDelta_days(this);
+    return this->seconds() / present_internal::seconds_in_day;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 TimeDelta::days_decimal() const
 {
-    return TimeDelta_days_decimal(this);
+    return this->seconds_decimal() /
+        (double)present_internal::seconds_in_day;
 }
 
-inline int_delta
+inline PRESENT_CONSTEXPR int_delta
 TimeDelta::weeks() const
 {
-    return TimeDelta_weeks(this);
+    return this->seconds() / present_internal::seconds_in_week;
 }
 
-inline double
+inline PRESENT_CONSTEXPR double
 TimeDelta::weeks_decimal() const
 {
-    return TimeDelta_weeks_decimal(this);
+    return this->seconds_decimal() /
+        (double)present_internal::seconds_in_week;
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 TimeDelta::to_DayDelta_truncated() const
 {
-    return TimeDelta_to_DayDelta_truncated(this);
+    /* Truncation in integer division with negative operands is
+       implementation-dependent before C++11, so we'll just use positives */
+    return DayDelta::from_days(this->data_.delta_seconds >= 0 ?
+            this->data_.delta_seconds / present_internal::seconds_in_day :
+            -((-this->data_.delta_seconds) /
+                present_internal::seconds_in_day));
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 TimeDelta::to_DayDelta_rounded() const
 {
-    return TimeDelta_to_DayDelta_rounded(this);
+    return DayDelta::from_days((int_delta)present_internal::round(
+                (double)this->data_.delta_seconds /
+                (double)present_internal::seconds_in_day));
 }
 
-inline DayDelta
+inline PRESENT_CONSTEXPR DayDelta
 TimeDelta::to_DayDelta_abs_ceil() const
 {
-    return TimeDelta_to_DayDelta_abs_ceil(this);
+    const DayDelta truncated = this->to_DayDelta_truncated();
+
+    if (this->data_.delta_seconds % present_internal::seconds_in_day == 0) {
+        return truncated;
+    }
+    return DayDelta::from_days(this->data_.delta_seconds >= 0 ?
+            truncated.days() + 1 : truncated.days() - 1);
+}
+
+#ifdef PRESENT_HAS_CHRONO
+
+template <typename Duration>
+inline PRESENT_CONSTEXPR Duration
+TimeDelta::to_duration() const
+{
+    return present_internal::join_duration<Duration>(
+            this->data_.delta_seconds,
+            this->data_.delta_nanoseconds);
 }
 
-inline bool
+#endif
+
+inline PRESENT_CONSTEXPR bool
 TimeDelta::is_negative() const
 {
-    return TimeDelta_is_negative(this);
+    return this->data_.delta_seconds < 0 || this->data_.delta_nanoseconds < 0;
 }
 
-inline void
+inline PRESENT_CONSTEXPR void
 TimeDelta::negate()
 {
-    TimeDelta_negate(this);
+    this->data_.delta_seconds = -this->data_.delta_seconds;
+    this->data_.delta_nanoseconds = -this->data_.delta_nanoseconds;
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 TimeDelta::operator-() const
 {
     TimeDelta copy(*this);
@@ -212,211 +293,247 @@ TimeDelta::operator-() const
     return copy;
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator*=(const long & scale_factor)
 {
-    TimeDelta_multiply_by(this, scale_factor);
+    this->data_.delta_seconds *= scale_factor;
+    this->data_.delta_nanoseconds *= scale_factor;
+    present_internal::normalize_time_delta_data(this->data_);
     return *this;
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator*=(const double & scale_factor)
 {
-    TimeDelta_multiply_by_decimal(this, scale_factor);
+    const double seconds = (double)this->data_.delta_seconds * scale_factor;
+
+    this->data_.delta_seconds = (int_delta)seconds;
+    this->data_.delta_nanoseconds = (int_delta)(
+            (double)this->data_.delta_nanoseconds * scale_factor);
+    /* When scaling the seconds, we may have a fractional part that needs to
+       be stored in the nanoseconds */
+    this->data_.delta_nanoseconds = (int_delta)(
+            (double)this->data_.delta_nanoseconds +
+            (seconds - (double)this->data_.delta_seconds) *
+            (double)present_internal::nanoseconds_in_second);
+    present_internal::normalize_time_delta_data(this->data_);
     return *this;
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator/=(const long & scale_factor)
 {
-    TimeDelta_divide_by(this, scale_factor);
+    const int_delta orig_seconds = this->data_.delta_seconds;
+
+    assert(scale_factor != 0);
+
+    /* Scale the seconds, and carry the remainder into the nanoseconds before
+       scaling those */
+    this->data_.delta_seconds /= scale_factor;
+    this->data_.delta_nanoseconds += (orig_seconds % scale_factor) *
+        present_internal::nanoseconds_in_second;
+    this->data_.delta_nanoseconds /= scale_factor;
+    present_internal::normalize_time_delta_data(this->data_);
     return *this;
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator/=(const double & scale_factor)
 {
-    TimeDelta_divide_by_decimal(this, scale_factor);
+    assert(scale_factor != 0.0);
+    *this *= 1.0 / scale_factor;
     return *this;
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator*(const TimeDelta & lhs, const long & rhs)
 {
     return (TimeDelta(lhs) *= rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator*(const TimeDelta & lhs, const double & rhs)
 {
     return (TimeDelta(lhs) *= rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator/(const TimeDelta & lhs, const long & rhs)
 {
     return (TimeDelta(lhs) /= rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator/(const TimeDelta & lhs, const double & rhs)
 {
     return (TimeDelta(lhs) /= rhs);
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator+=(const TimeDelta & other)
 {
-    TimeDelta_add(this, &other);
+    this->data_.delta_seconds += other.data_.delta_seconds;
+    this->data_.delta_nanoseconds += other.data_.delta_nanoseconds;
+    present_internal::normalize_time_delta_data(this->data_);
     return *this;
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator+=(const DayDelta & other)
 {
-    TimeDelta_add_DayDelta(this, &other);
+    this->data_.delta_seconds +=
+        other.data_.delta_days * present_internal::seconds_in_day;
+    present_internal::normalize_time_delta_data(this->data_);
     return *this;
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator-=(const TimeDelta & other)
 {
-    TimeDelta_subtract(this, &other);
+    this->data_.delta_seconds -= other.data_.delta_seconds;
+    this->data_.delta_nanoseconds -= other.data_.delta_nanoseconds;
+    present_internal::normalize_time_delta_data(this->data_);
     return *this;
 }
 
-inline TimeDelta &
+inline PRESENT_CONSTEXPR TimeDelta &
 TimeDelta::operator-=(const DayDelta & other)
 {
-    TimeDelta_subtract_DayDelta(this, &other);
+    this->data_.delta_seconds -=
+        other.data_.delta_days * present_internal::seconds_in_day;
+    present_internal::normalize_time_delta_data(this->data_);
     return *this;
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator+(const TimeDelta & lhs, const TimeDelta & rhs)
 {
     return (TimeDelta(lhs) += rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator+(const TimeDelta & lhs, const DayDelta & rhs)
 {
     return (TimeDelta(lhs) += rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator+(const DayDelta & lhs, const TimeDelta & rhs)
 {
     TimeDelta lhs_time_delta = lhs.to_TimeDelta();
     return (lhs_time_delta += rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator-(const TimeDelta & lhs, const TimeDelta & rhs)
 {
     return (TimeDelta(lhs) -= rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator-(const TimeDelta & lhs, const DayDelta & rhs)
 {
     return (TimeDelta(lhs) -= rhs);
 }
 
-inline const TimeDelta
+inline PRESENT_CONSTEXPR const TimeDelta
 operator-(const DayDelta & lhs, const TimeDelta & rhs)
 {
     TimeDelta lhs_time_delta = lhs.to_TimeDelta();
     return (lhs_time_delta -= rhs);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 TimeDelta::compare(const TimeDelta & lhs, const TimeDelta & rhs)
 {
-    return TimeDelta_compare(&lhs, &rhs);
+    return present_internal::compare(
+            lhs.data_.delta_seconds, rhs.data_.delta_seconds,
+            present_internal::compare(
+                lhs.data_.delta_nanoseconds, rhs.data_.delta_nanoseconds,
+                0));
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 TimeDelta::compare(const TimeDelta & lhs, const DayDelta & rhs)
 {
-    return TimeDelta_compare_to_DayDelta(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs.to_TimeDelta());
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 TimeDelta::compare(const DayDelta & lhs, const TimeDelta & rhs)
 {
-    return -TimeDelta_compare_to_DayDelta(&rhs, &lhs);
+    return TimeDelta::compare(lhs.to_TimeDelta(), rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const TimeDelta & lhs, const TimeDelta & rhs)
 {
-    return TimeDelta_equal(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const TimeDelta & lhs, const DayDelta & rhs)
 {
-    return TimeDelta_equal_DayDelta(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const TimeDelta & lhs, const TimeDelta & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const TimeDelta & lhs, const DayDelta & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const TimeDelta & lhs, const TimeDelta & rhs)
 {
-    return TimeDelta_less_than(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const TimeDelta & lhs, const DayDelta & rhs)
 {
-    return TimeDelta_less_than_DayDelta(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const TimeDelta & lhs, const TimeDelta & rhs)
 {
-    return TimeDelta_less_than_or_equal(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const TimeDelta & lhs, const DayDelta & rhs)
 {
-    return TimeDelta_less_than_or_equal_DayDelta(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const TimeDelta & lhs, const TimeDelta & rhs)
 {
-    return TimeDelta_greater_than(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const TimeDelta & lhs, const DayDelta & rhs)
 {
-    return TimeDelta_greater_than_DayDelta(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const TimeDelta & lhs, const TimeDelta & rhs)
 {
-    return TimeDelta_greater_than_or_equal(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) >= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const TimeDelta & lhs, const DayDelta & rhs)
 {
-    return TimeDelta_greater_than_or_equal_DayDelta(&lhs, &rhs);
+    return TimeDelta::compare(lhs, rhs) >= 0;
 }
 
@@ -0,0 +1,113 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimeIndex C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+inline
+TimeIndex::TimeIndex()
+{
+    TimeIndex_init(this);
+}
+
+inline
+TimeIndex::TimeIndex(const Timestamp * timestamps, size_t count)
+{
+    TimeIndex_init(this);
+    build(timestamps, count);
+}
+
+inline
+TimeIndex::TimeIndex(const TimestampColumn & column)
+{
+    TimeIndex_init(this);
+    build(column);
+}
+
+inline
+TimeIndex::TimeIndex(const TimeIndex & other)
+{
+    TimeIndex_init(this);
+    if (!TimeIndex_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline TimeIndex &
+TimeIndex::operator=(const TimeIndex & other)
+{
+    if (!TimeIndex_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline
+TimeIndex::~TimeIndex()
+{
+    TimeIndex_destroy(this);
+}
+
+inline size_t
+TimeIndex::size() const
+{
+    return size_;
+}
+
+inline bool
+TimeIndex::empty() const
+{
+    return size_ == 0;
+}
+
+inline void
+TimeIndex::build(const Timestamp * timestamps, size_t count)
+{
+    if (!TimeIndex_build(this, timestamps, count)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline void
+TimeIndex::build(const TimestampColumn & column)
+{
+    if (!TimeIndex_build_from_column(this, &column)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline size_t
+TimeIndex::lower_bound(const Timestamp & value) const
+{
+    return TimeIndex_lower_bound(this, &value);
+}
+
+inline size_t
+TimeIndex::upper_bound(const Timestamp & value) const
+{
+    return TimeIndex_upper_bound(this, &value);
+}
+
+inline size_t
+TimeIndex::count_range(const Timestamp & low, const Timestamp & high) const
+{
+    return TimeIndex_count_range(this, &low, &high);
+}
+
+inline size_t
+TimeIndex::find_range(
+        const Timestamp & low,
+        const Timestamp & high,
+        size_t * first) const
+{
+    return TimeIndex_find_range(this, &low, &high, first);
+}
+
@@ -0,0 +1,161 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimeInterval and TimeIntervalIndex C++ methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+/*
+ * TimeInterval
+ */
+
+inline TimeInterval
+TimeInterval::create(const Timestamp & start, const Timestamp & end)
+{
+    return TimeInterval_create(&start, &end);
+}
+
+inline TimeInterval
+TimeInterval::create(const Timestamp & start, const TimeDelta & duration)
+{
+    return TimeInterval_from_duration(&start, &duration);
+}
+
+inline TimeDelta
+TimeInterval::duration() const
+{
+    return TimeInterval_duration(this);
+}
+
+inline bool
+TimeInterval::empty() const
+{
+    return TimeInterval_is_empty(this) != 0;
+}
+
+inline bool
+TimeInterval::contains(const Timestamp & timestamp) const
+{
+    return TimeInterval_contains(this, &timestamp) != 0;
+}
+
+inline bool
+TimeInterval::contains(const TimeInterval & other) const
+{
+    return TimeInterval_contains_interval(this, &other) != 0;
+}
+
+inline bool
+TimeInterval::overlaps(const TimeInterval & other) const
+{
+    return TimeInterval_overlaps(this, &other) != 0;
+}
+
+inline TimeInterval
+TimeInterval::intersection(const TimeInterval & other) const
+{
+    return TimeInterval_intersection(this, &other);
+}
+
+inline bool
+operator==(const TimeInterval & lhs, const TimeInterval & rhs)
+{
+    return TimeInterval_equal(&lhs, &rhs) != 0;
+}
+
+inline bool
+operator!=(const TimeInterval & lhs, const TimeInterval & rhs)
+{
+    return TimeInterval_equal(&lhs, &rhs) == 0;
+}
+
+/*
+ * TimeIntervalIndex
+ */
+
+inline
+TimeIntervalIndex::TimeIntervalIndex()
+{
+    TimeIntervalIndex_init(this);
+}
+
+inline
+TimeIntervalIndex::TimeIntervalIndex(
+        const TimeInterval * intervals,
+        size_t count)
+{
+    TimeIntervalIndex_init(this);
+    build(intervals, count);
+}
+
+inline
+TimeIntervalIndex::TimeIntervalIndex(const TimeIntervalIndex & other)
+{
+    TimeIntervalIndex_init(this);
+    if (!TimeIntervalIndex_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline TimeIntervalIndex &
+TimeIntervalIndex::operator=(const TimeIntervalIndex & other)
+{
+    if (!TimeIntervalIndex_assign(this, &other)) {
+        present_internal::throw_bad_alloc();
+    }
+    return *this;
+}
+
+inline
+TimeIntervalIndex::~TimeIntervalIndex()
+{
+    TimeIntervalIndex_destroy(this);
+}
+
+inline size_t
+TimeIntervalIndex::size() const
+{
+    return size_;
+}
+
+inline bool
+TimeIntervalIndex::empty() const
+{
+    return size_ == 0;
+}
+
+inline void
+TimeIntervalIndex::build(const TimeInterval * intervals, size_t count)
+{
+    if (!TimeIntervalIndex_build(this, intervals, count)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline size_t
+TimeIntervalIndex::find_containing(
+        const Timestamp & timestamp,
+        size_t * positions,
+        size_t capacity) const
+{
+    return TimeIntervalIndex_find_containing(
+            this, &timestamp, positions, capacity);
+}
+
+inline size_t
+TimeIntervalIndex::find_overlapping(
+        const TimeInterval & interval,
+        size_t * positions,
+        size_t capacity) const
+{
+    return TimeIntervalIndex_find_overlapping(
+            this, &interval, positions, capacity);
+}
+
@@ -0,0 +1,336 @@
+/*
+ * Present - Date/Time Library
+ *
+ * TimeWindow (a rolling aggregate over the values added in the last
+ * TimeDelta), and ShardedTimeWindow (the same, for values added from many
+ * threads; C++11 and above)
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <deque>
+
+#if __cplusplus >= 201103L
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+/**
+ * A rolling aggregate (count, sum, min, and max) over the values that were
+ * added in a window of a fixed duration ending at the latest timestamp, such
+ * as "requests in the last 60 seconds".
+ *
+ * Values must be added in order of their timestamps (equal timestamps are
+ * allowed). Adding a value expires the values that have fallen out of the
+ * window; call expire() to move the window forward when no values are being
+ * added. A value added at time t is in the window until the window ends
+ * at t + duration (not inclusive).
+ *
+ * The count and sum are kept as running totals, and the min and max with
+ * monotonic deques (each holds only the values that could still become the
+ * min or max once older values expire), so adding a value and all the
+ * queries are O(1) amortized.
+ *
+ * T must be default-constructible (to zero), copyable, and support +=, -=,
+ * and <. For floating-point T, the running sum is updated by subtracting
+ * expired values, so it can drift from the exact sum of the values in the
+ * window by rounding error.
+ */
+template <typename T>
+class TimeWindow {
+public:
+    /** Create an empty window of the given (positive) duration. */
+    explicit TimeWindow(const TimeDelta & duration)
+        : duration_(duration),
+          latest_(),
+          has_latest_(false),
+          sum_()
+    {
+        assert(duration.data_.delta_seconds > 0 ||
+               duration.data_.delta_nanoseconds > 0);
+    }
+
+    /** Get the duration of the window. */
+    const TimeDelta & duration() const {
+        return duration_;
+    }
+
+    /**
+     * Add a value at a timestamp, and expire the values that are no longer
+     * in the window ending at that timestamp.
+     *
+     * The timestamp must not be before the timestamp of the last value that
+     * was added (or the last call to expire()).
+     */
+    void add(const Timestamp & timestamp, const T & value) {
+        expire(timestamp);
+
+        Entry entry;
+        entry.timestamp = timestamp;
+        entry.value = value;
+        entries_.push_back(entry);
+        sum_ += value;
+
+        while (!min_entries_.empty() && value < min_entries_.back().value) {
+            min_entries_.pop_back();
+        }
+        min_entries_.push_back(entry);
+        while (!max_entries_.empty() && max_entries_.back().value < value) {
+            max_entries_.pop_back();
+        }
+        max_entries_.push_back(entry);
+    }
+
+    /**
+     * Move the end of the window forward to @p now, expiring the values
+     * that are no longer in it.
+     *
+     * @p now must not be before the timestamp of the last value that was
+     * added (or the last call to expire()).
+     */
+    void expire(const Timestamp & now) {
+        assert(!has_latest_ || !(now < latest_));
+        latest_ = now;
+        has_latest_ = true;
+
+        const Timestamp cutoff = now - duration_;
+        while (!entries_.empty() && !(cutoff < entries_.front().timestamp)) {
+            sum_ -= entries_.front().value;
+            entries_.pop_front();
+        }
+        while (!min_entries_.empty() &&
+                !(cutoff < min_entries_.front().timestamp)) {
+            min_entries_.pop_front();
+        }
+        while (!max_entries_.empty() &&
+                !(cutoff < max_entries_.front().timestamp)) {
+            max_entries_.pop_front();
+        }
+    }
+
+    /** Remove all the values from the window. */
+    void clear() {
+        entries_.clear();
+        min_entries_.clear();
+        max_entries_.clear();
+        sum_ = T();
+        has_latest_ = false;
+    }
+
+    /** Check whether there are no values in the window. */
+    bool empty() const {
+        return entries_.empty();
+    }
+
+    /** Get the number of values in the window. */
+    size_t count() const {
+        return entries_.size();
+    }
+
+    /** Get the sum of the values in the window (T() if it is empty). */
+    T sum() const {
+        return sum_;
+    }
+
+    /** Get the smallest value in the window (which must not be empty). */
+    const T & min() const {
+        assert(!min_entries_.empty());
+        return min_entries_.front().value;
+    }
+
+    /** Get the largest value in the window (which must not be empty). */
+    const T & max() const {
+        assert(!max_entries_.empty());
+        return max_entries_.front().value;
+    }
+
+    /**
+     * Get the end of the window (the timestamp of the last value that was
+     * added, or the last call to expire()).
+     */
+    const Timestamp & latest() const {
+        assert(has_latest_);
+        return latest_;
+    }
+
+private:
+    struct Entry {
+        Timestamp timestamp;
+        T value;
+    };
+
+    TimeDelta duration_;
+    Timestamp latest_;
+    bool has_latest_;
+    T sum_;
+
+    /* Every value in the window, oldest first */
+    std::deque<Entry> entries_;
+    /* The values that could become the min (increasing from the front) */
+    std::deque<Entry> min_entries_;
+    /* The values that could become the max (decreasing from the front) */
+    std::deque<Entry> max_entries_;
+};
+
+#if __cplusplus >= 201103L
+
+/**
+ * A TimeWindow that values can be added to from many threads at once.
+ *
+ * The window is split into shards, each a TimeWindow with its own lock, and
+ * each thread adds to the shard picked by its thread ID, so threads that add
+ * at the same time rarely wait for each other. The queries lock the shards
+ * one at a time, expire them to @p now, and combine their results, so a
+ * query made while values are being added sees some of those values but not
+ * others (but every value is counted once or not at all).
+ *
+ * Values from different threads may arrive slightly out of order. A value
+ * whose timestamp is before the end of its shard's window is added at the
+ * end of the window instead, so it expires late by at most that skew.
+ */
+template <typename T>
+class ShardedTimeWindow {
+public:
+    /**
+     * Create an empty window of the given (positive) duration, split into
+     * @p shard_count shards (by default, one for each hardware thread).
+     */
+    explicit ShardedTimeWindow(
+            const TimeDelta & duration,
+            size_t shard_count = 0)
+    {
+        if (shard_count == 0) {
+            shard_count = std::thread::hardware_concurrency();
+            if (shard_count == 0) {
+                shard_count = 1;
+            }
+        }
+        shards_.reserve(shard_count);
+        for (size_t i = 0; i < shard_count; ++i) {
+            shards_.emplace_back(new Shard(duration));
+        }
+    }
+
+    /** Get the duration of the window. */
+    const TimeDelta & duration() const {
+        return shards_[0]->window.duration();
+    }
+
+    /** Get the number of shards. */
+    size_t shard_count() const {
+        return shards_.size();
+    }
+
+    /** Add a value at a timestamp (see TimeWindow::add). */
+    void add(const Timestamp & timestamp, const T & value) {
+        const size_t index =
+            std::hash<std::thread::id>()(std::this_thread::get_id()) %
+            shards_.size();
+        Shard & shard = *shards_[index];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.started && timestamp < shard.window.latest()) {
+            shard.window.add(shard.window.latest(), value);
+        } else {
+            shard.window.add(timestamp, value);
+        }
+        shard.started = true;
+    }
+
+    /** Get the number of values in the window ending at @p now. */
+    size_t count(const Timestamp & now) {
+        size_t result = 0;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+            expire_shard(*shards_[i], now);
+            result += shards_[i]->window.count();
+        }
+        return result;
+    }
+
+    /** Get the sum of the values in the window ending at @p now. */
+    T sum(const Timestamp & now) {
+        T result = T();
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+            expire_shard(*shards_[i], now);
+            result += shards_[i]->window.sum();
+        }
+        return result;
+    }
+
+    /**
+     * Get the smallest value in the window ending at @p now.
+     * @return false if the window is empty (and @p result is unchanged).
+     */
+    bool min(const Timestamp & now, T & result) {
+        bool found = false;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+            expire_shard(*shards_[i], now);
+            if (!shards_[i]->window.empty() &&
+                    (!found || shards_[i]->window.min() < result)) {
+                result = shards_[i]->window.min();
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * Get the largest value in the window ending at @p now.
+     * @return false if the window is empty (and @p result is unchanged).
+     */
+    bool max(const Timestamp & now, T & result) {
+        bool found = false;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+            expire_shard(*shards_[i], now);
+            if (!shards_[i]->window.empty() &&
+                    (!found || result < shards_[i]->window.max())) {
+                result = shards_[i]->window.max();
+                found = true;
+            }
+        }
+        return found;
+    }
+
+private:
+    struct Shard {
+        explicit Shard(const TimeDelta & duration)
+            : window(duration),
+              started(false)
+        {
+        }
+
+        std::mutex mutex;
+        TimeWindow<T> window;
+        /* Whether the window has been added to or expired yet */
+        bool started;
+    };
+
+    /*
+     * Expire a (locked) shard to now, unless its window already ends after
+     * now (when a thread added a value with a later timestamp than now).
+     */
+    static void expire_shard(Shard & shard, const Timestamp & now) {
+        if (!shard.started || !(now < shard.window.latest())) {
+            shard.window.expire(now);
+            shard.started = true;
+        }
+    }
+
+    std::vector<std::unique_ptr<Shard> > shards_;
+};
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimerWheel, TimerWheelTimer, and TimerWheelGroup C++
+ * methods
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+namespace present_internal {
+
+/** Call a function object for a timer (as a TimerWheelCallback). */
+template <typename Callback>
+inline void
+call_timer_wheel_callback(TimerWheelTimer * timer, void * context)
+{
+    (*static_cast<Callback *>(context))(timer);
+}
+
+}
+
+/*
+ * TimerWheelTimer
+ */
+
+inline
+TimerWheelTimer::TimerWheelTimer()
+{
+    TimerWheelTimer_init(this);
+}
+
+inline bool
+TimerWheelTimer::is_scheduled() const
+{
+    return TimerWheelTimer_is_scheduled(this);
+}
+
+/*
+ * TimerWheel
+ */
+
+inline
+TimerWheel::TimerWheel(const Timestamp & start, const TimeDelta & resolution)
+{
+    TimerWheel_init(this, &start, &resolution);
+}
+
+inline size_t
+TimerWheel::size() const
+{
+    return TimerWheel_count(this);
+}
+
+inline Timestamp
+TimerWheel::now() const
+{
+    return TimerWheel_get_now(this);
+}
+
+inline bool
+TimerWheel::next_event(Timestamp & result) const
+{
+    return TimerWheel_next_event(this, &result);
+}
+
+inline void
+TimerWheel::schedule_at(TimerWheelTimer & timer, const Timestamp & deadline)
+{
+    TimerWheel_schedule_at(this, &timer, &deadline);
+}
+
+inline void
+TimerWheel::schedule_after(TimerWheelTimer & timer, const TimeDelta & delay)
+{
+    TimerWheel_schedule_after(this, &timer, &delay);
+}
+
+inline bool
+TimerWheel::cancel(TimerWheelTimer & timer)
+{
+    return TimerWheel_cancel(this, &timer);
+}
+
+inline size_t
+TimerWheel::advance(
+        const Timestamp & now,
+        TimerWheelCallback callback,
+        void * context)
+{
+    return TimerWheel_advance(this, &now, callback, context);
+}
+
+template <typename Callback>
+inline size_t
+TimerWheel::advance(const Timestamp & now, Callback & callback)
+{
+    return TimerWheel_advance(this, &now,
+            &present_internal::call_timer_wheel_callback<Callback>,
+            &callback);
+}
+
+inline size_t
+TimerWheel::advance_to_now(TimerWheelCallback callback, void * context)
+{
+    return TimerWheel_advance_to_now(this, callback, context);
+}
+
+/*
+ * TimerWheelGroup
+ */
+
+inline
+TimerWheelGroup::TimerWheelGroup(
+        size_t shard_count,
+        const Timestamp & start,
+        const TimeDelta & resolution)
+{
+    if (!TimerWheelGroup_init(this, shard_count, &start, &resolution)) {
+        present_internal::throw_bad_alloc();
+    }
+}
+
+inline
+TimerWheelGroup::~TimerWheelGroup()
+{
+    TimerWheelGroup_destroy(this);
+}
+
+inline size_t
+TimerWheelGroup::shard_count() const
+{
+    return TimerWheelGroup_shard_count(this);
+}
+
+inline void
+TimerWheelGroup::schedule_at(
+        size_t shard,
+        TimerWheelTimer & timer,
+        const Timestamp & deadline)
+{
+    TimerWheelGroup_schedule_at(this, shard, &timer, &deadline);
+}
+
+inline void
+TimerWheelGroup::schedule_after(
+        size_t shard,
+        TimerWheelTimer & timer,
+        const TimeDelta & delay)
+{
+    TimerWheelGroup_schedule_after(this, shard, &timer, &delay);
+}
+
+inline bool
+TimerWheelGroup::cancel(size_t shard, TimerWheelTimer & timer)
+{
+    return TimerWheelGroup_cancel(this, shard, &timer);
+}
+
+inline size_t
+TimerWheelGroup::advance(
+        size_t shard,
+        const Timestamp & now,
+        TimerWheelCallback callback,
+        void * context)
+{
+    return TimerWheelGroup_advance(this, shard, &now, callback, context);
+}
+
@@ -10,14 +10,39 @@
  * For details, see LICENSE.
  */
 
-inline Timestamp
+inline PRESENT_CONSTEXPR Timestamp
 Timestamp::create(const time_t time)
 {
-    Timestamp result;
-    Timestamp_ptr_from_time_t(&result, time);
+    Timestamp result = Timestamp();
+    /* We're assuming that time_t is already a UNIX timestamp (like
+       time_t_to_unix_timestamp in the C library) */
+    result.data_.timestamp_seconds = (int_timestamp)time;
+    return result;
+}
+
+#ifdef PRESENT_HAS_CHRONO
+
+template <typename Duration>
+inline PRESENT_CONSTEXPR Timestamp
+Timestamp::create(
+        const std::chrono::time_point<std::chrono::system_clock, Duration> &
+            time_point)
+{
+    Timestamp result = Timestamp();
+    int_delta seconds = 0, nanoseconds = 0;
+
+    /* We're assuming that the system_clock epoch is the UNIX epoch (which is
+       required as of C++20, and true of all the major implementations) */
+    present_internal::split_duration(
+            time_point.time_since_epoch(), seconds, nanoseconds);
+    result.data_.timestamp_seconds = seconds;
+    result.data_.additional_nanoseconds = nanoseconds;
+    present_internal::normalize_timestamp_data(result.data_);
     return result;
 }
 
+#endif
+
 inline Timestamp
 Timestamp::create(const struct tm & tm, const TimeDelta & time_zone_offset)
 {
@@ -42,22 +67,44 @@ Timestamp::create_local(const struct tm & tm)
     return result;
 }
 
-inline Timestamp
+inline PRESENT_CONSTEXPR Timestamp
 Timestamp::create(
         const Date & date,
         const ClockTime & clock_time,
         const TimeDelta & time_zone_offset)
 {
-    Timestamp result;
-    Timestamp_ptr_create(&result, &date, &clock_time, &time_zone_offset);
+    Timestamp result = Timestamp::create_utc(date, clock_time);
+    if (!result.has_error) {
+        /* Subtract the UTC offset (since we're technically converting TO
+           UTC) */
+        result -= time_zone_offset;
+    }
     return result;
 }
 
-inline Timestamp
+inline PRESENT_CONSTEXPR Timestamp
 Timestamp::create_utc(const Date & date, const ClockTime & clock_time)
 {
-    Timestamp result;
-    Timestamp_ptr_create_utc(&result, &date, &clock_time);
+    Timestamp result = Timestamp();
+
+    /* Make sure the Date and ClockTime aren't erroneous */
+    if (date.has_error) {
+        result.has_error = 1;
+        result.errors.invalid_date = 1;
+    }
+    if (clock_time.has_error) {
+        result.has_error = 1;
+        result.errors.invalid_clock_time = 1;
+    }
+
+    if (!result.has_error) {
+        result.data_.timestamp_seconds =
+            present_internal::days_from_civil(
+                    date.data_.year, date.data_.month, date.data_.day) *
+                present_internal::seconds_in_day +
+            clock_time.data_.seconds;
+        result.data_.additional_nanoseconds = clock_time.data_.nanoseconds;
+    }
     return result;
 }
 
@@ -77,20 +124,35 @@ Timestamp::now()
     return result;
 }
 
-inline Timestamp
+inline PRESENT_CONSTEXPR Timestamp
 Timestamp::epoch()
 {
-    Timestamp result;
-    Timestamp_ptr_epoch(&result);
-    return result;
+    return Timestamp::create((time_t)0);
 }
 
-inline time_t
+inline PRESENT_CONSTEXPR time_t
 Timestamp::get_time_t() const
 {
-    return Timestamp_get_time_t(this);
+    assert(this->has_error == 0);
+    return (time_t)this->data_.timestamp_seconds;
 }
 
+#ifdef PRESENT_HAS_CHRONO
+
+template <typename Duration>
+inline PRESENT_CONSTEXPR
+std::chrono::time_point<std::chrono::system_clock, Duration>
+Timestamp::to_time_point() const
+{
+    assert(this->has_error == 0);
+    return std::chrono::time_point<std::chrono::system_clock, Duration>(
+            present_internal::floor_join_duration<Duration>(
+                this->data_.timestamp_seconds,
+                this->data_.additional_nanoseconds));
+}
+
+#endif
+
 inline struct tm
 Timestamp::get_struct_tm(const TimeDelta & time_zone_offset) const
 {
@@ -109,16 +171,24 @@ Timestamp::get_struct_tm_local() const
     return Timestamp_get_struct_tm_local(this);
 }
 
-inline Date
+inline PRESENT_CONSTEXPR Date
 Timestamp::get_date(const TimeDelta & time_zone_offset) const
 {
-    return Timestamp_get_date(this, &time_zone_offset);
+    assert(this->has_error == 0);
+    return (*this + time_zone_offset).get_date_utc();
 }
 
-inline Date
+inline PRESENT_CONSTEXPR Date
 Timestamp::get_date_utc() const
 {
-    return Timestamp_get_date_utc(this);
+    Date result = Date();
+
+    assert(this->has_error == 0);
+    present_internal::civil_from_days(
+            present_internal::floor_div(this->data_.timestamp_seconds,
+                present_internal::seconds_in_day),
+            result.data_);
+    return result;
 }
 
 inline Date
@@ -127,16 +197,23 @@ Timestamp::get_date_local() const
     return Timestamp_get_date_local(this);
 }
 
-inline ClockTime
+inline PRESENT_CONSTEXPR ClockTime
 Timestamp::get_clock_time(const TimeDelta & time_zone_offset) const
 {
-    return Timestamp_get_clock_time(this, &time_zone_offset);
+    assert(this->has_error == 0);
+    return (*this + time_zone_offset).get_clock_time_utc();
 }
 
-inline ClockTime
+inline PRESENT_CONSTEXPR ClockTime
 Timestamp::get_clock_time_utc() const
 {
-    return Timestamp_get_clock_time_utc(this);
+    ClockTime result = ClockTime();
+
+    assert(this->has_error == 0);
+    /* Like the C functions, this only has a precision of seconds */
+    result.data_.seconds = present_internal::floor_mod(
+            this->data_.timestamp_seconds, present_internal::seconds_in_day);
+    return result;
 }
 
 inline ClockTime
@@ -145,150 +222,243 @@ Timestamp::get_clock_time_local() const
     return Timestamp_get_clock_time_local(this);
 }
 
-inline TimeDelta
+inline size_t
+Timestamp::format(
+        const char * format,
+        const TimeDelta & time_zone_offset,
+        char * buffer,
+        size_t buffer_size) const
+{
+    return Timestamp_format(
+            this, format, &time_zone_offset, buffer, buffer_size);
+}
+
+inline size_t
+Timestamp::format_utc(
+        const char * format,
+        char * buffer,
+        size_t buffer_size) const
+{
+    return Timestamp_format_utc(this, format, buffer, buffer_size);
+}
+
+inline Timestamp
+Timestamp::truncate(int unit, const TimeDelta & time_zone_offset) const
+{
+    return Timestamp_truncate(this, unit, &time_zone_offset);
+}
+
+inline Timestamp
+Timestamp::truncate_utc(int unit) const
+{
+    return Timestamp_truncate_utc(this, unit);
+}
+
+inline Timestamp
+Timestamp::bucket(const TimeDelta & width, const Timestamp & origin) const
+{
+    return Timestamp_bucket(this, &width, &origin);
+}
+
+inline size_t
+Timestamp::get_windows(
+        const TimeDelta & size,
+        const TimeDelta & hop,
+        const Timestamp & origin,
+        int_delta * first,
+        int_delta * last) const
+{
+    return Timestamp_get_windows(this, &size, &hop, &origin, first, last);
+}
+
+inline PRESENT_CONSTEXPR TimeDelta
 Timestamp::difference(const Timestamp & other) const
 {
-    return Timestamp_difference(this, &other);
+    assert(this->has_error == 0);
+    assert(other.has_error == 0);
+    return TimeDelta::from_seconds(
+            this->data_.timestamp_seconds - other.data_.timestamp_seconds) +
+        TimeDelta::from_nanoseconds(
+            this->data_.additional_nanoseconds -
+            other.data_.additional_nanoseconds);
 }
 
-inline TimeDelta
+inline PRESENT_CONSTEXPR TimeDelta
 Timestamp::absolute_difference(const Timestamp & other) const
 {
-    return Timestamp_absolute_difference(this, &other);
+    TimeDelta delta = this->difference(other);
+    if (delta.is_negative()) {
+        delta.negate();
+    }
+    return delta;
 }
 
-inline Timestamp &
+inline PRESENT_CONSTEXPR Timestamp &
 Timestamp::operator+=(const TimeDelta & delta)
 {
-    Timestamp_add_TimeDelta(this, &delta);
+    assert(this->has_error == 0);
+    this->data_.timestamp_seconds += delta.data_.delta_seconds;
+    this->data_.additional_nanoseconds += delta.data_.delta_nanoseconds;
+    present_internal::normalize_timestamp_data(this->data_);
     return *this;
 }
 
-inline Timestamp &
+inline PRESENT_CONSTEXPR Timestamp &
 Timestamp::operator+=(const DayDelta & delta)
 {
-    Timestamp_add_DayDelta(this, &delta);
+    assert(this->has_error == 0);
+    this->data_.timestamp_seconds +=
+        delta.data_.delta_days * present_internal::seconds_in_day;
     return *this;
 }
 
-inline Timestamp &
+inline PRESENT_CONSTEXPR Timestamp &
 Timestamp::operator+=(const MonthDelta & delta)
 {
-    Timestamp_add_MonthDelta(this, &delta);
+    const int_delta days = present_internal::floor_div(
+            this->data_.timestamp_seconds, present_internal::seconds_in_day);
+    PresentDateData date = PresentDateData();
+
+    assert(this->has_error == 0);
+    present_internal::civil_from_days(days, date);
+    this->data_.timestamp_seconds +=
+        (present_internal::days_from_civil(
+            date.year, (int_delta)date.month + delta.data_.delta_months,
+            date.day) - days) * present_internal::seconds_in_day;
     return *this;
 }
 
-inline Timestamp &
+inline PRESENT_CONSTEXPR Timestamp &
 Timestamp::operator-=(const TimeDelta & delta)
 {
-    Timestamp_subtract_TimeDelta(this, &delta);
+    assert(this->has_error == 0);
+    this->data_.timestamp_seconds -= delta.data_.delta_seconds;
+    this->data_.additional_nanoseconds -= delta.data_.delta_nanoseconds;
+    present_internal::normalize_timestamp_data(this->data_);
     return *this;
 }
 
-inline Timestamp &
+inline PRESENT_CONSTEXPR Timestamp &
 Timestamp::operator-=(const DayDelta & delta)
 {
-    Timestamp_subtract_DayDelta(this, &delta);
+    assert(this->has_error == 0);
+    this->data_.timestamp_seconds -=
+        delta.data_.delta_days * present_internal::seconds_in_day;
     return *this;
 }
 
-inline Timestamp &
+inline PRESENT_CONSTEXPR Timestamp &
 Timestamp::operator-=(const MonthDelta & delta)
 {
-    Timestamp_subtract_MonthDelta(this, &delta);
+    *this += -delta;
     return *this;
 }
 
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator+(const Timestamp & lhs, const TimeDelta & rhs)
 {
     return (Timestamp(lhs) += rhs);
 }
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator+(const TimeDelta & lhs, const Timestamp & rhs)
 {
     return (Timestamp(rhs) += lhs);
 }
 
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator+(const Timestamp & lhs, const DayDelta & rhs)
 {
     return (Timestamp(lhs) += rhs);
 }
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator+(const DayDelta & lhs, const Timestamp & rhs)
 {
     return (Timestamp(rhs) += lhs);
 }
 
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator+(const Timestamp & lhs, const MonthDelta & rhs)
 {
     return (Timestamp(lhs) += rhs);
 }
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator+(const MonthDelta & lhs, const Timestamp & rhs)
 {
     return (Timestamp(rhs) += lhs);
 }
 
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator-(const Timestamp & lhs, const TimeDelta & rhs)
 {
     return (Timestamp(lhs) -= rhs);
 }
 
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator-(const Timestamp & lhs, const DayDelta & rhs)
 {
     return (Timestamp(lhs) -= rhs);
 }
 
-inline const Timestamp
+inline PRESENT_CONSTEXPR const Timestamp
 operator-(const Timestamp & lhs, const MonthDelta & rhs)
 {
     return (Timestamp(lhs) -= rhs);
 }
 
-inline short
+inline PRESENT_CONSTEXPR short
 Timestamp::compare(const Timestamp & lhs, const Timestamp & rhs)
 {
-    return Timestamp_compare(&lhs, &rhs);
+    assert(lhs.has_error == 0);
+    assert(rhs.has_error == 0);
+    return present_internal::compare(
+            lhs.data_.timestamp_seconds, rhs.data_.timestamp_seconds,
+            present_internal::compare(
+                lhs.data_.additional_nanoseconds,
+                rhs.data_.additional_nanoseconds,
+                0));
+}
+
+inline void
+Timestamp::sort(Timestamp * timestamps, size_t count)
+{
+    if (!Timestamp_sort(timestamps, count)) {
+        present_internal::throw_bad_alloc();
+    }
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator==(const Timestamp & lhs, const Timestamp & rhs)
 {
-    return Timestamp_equal(&lhs, &rhs);
+    return Timestamp::compare(lhs, rhs) == 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator!=(const Timestamp & lhs, const Timestamp & rhs)
 {
     return !(lhs == rhs);
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<(const Timestamp & lhs, const Timestamp & rhs)
 {
-    return Timestamp_less_than(&lhs, &rhs);
+    return Timestamp::compare(lhs, rhs) < 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator<=(const Timestamp & lhs, const Timestamp & rhs)
 {
-    return Timestamp_less_than_or_equal(&lhs, &rhs);
+    return Timestamp::compare(lhs, rhs) <= 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>(const Timestamp & lhs, const Timestamp & rhs)
 {
-    return Timestamp_greater_than(&lhs, &rhs);
+    return Timestamp::compare(lhs, rhs) > 0;
 }
 
-inline bool
+inline PRESENT_CONSTEXPR bool
 operator>=(const Timestamp & lhs, const Timestamp & rhs)
 {
-    return Timestamp_greater_than_or_equal(&lhs, &rhs);
+    return Timestamp::compare(lhs, rhs) >= 0;
 }
 
@@ -0,0 +1,313 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Utilities shared by the implementations of the C++ methods
+ *
+ * These mirror the calculations done by the C functions in "src/", but they
+ * are written so that they can be evaluated at compile time (they are
+ * constexpr when compiling as C++14 or later).
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#ifdef PRESENT_HAS_EXCEPTIONS
+# include <new>
+#endif
+
+namespace present_internal {
+
+const int_delta nanoseconds_in_second = 1000000000;
+const int_delta nanoseconds_in_millisecond = 1000000;
+const int_delta nanoseconds_in_microsecond = 1000;
+const int_delta microseconds_in_second = 1000000;
+const int_delta milliseconds_in_second = 1000;
+
+const int_delta seconds_in_minute = 60;
+const int_delta seconds_in_hour = 3600;
+const int_delta seconds_in_day = 86400;
+const int_delta seconds_in_week = 604800;
+
+const int_delta days_in_week = 7;
+const int_delta months_in_year = 12;
+
+/**
+ * Report that the memory for a C++ object could not be allocated, by
+ * throwing std::bad_alloc (or, when compiled without exceptions, by
+ * aborting).
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noreturn))
+#elif defined(_MSC_VER)
+__declspec(noreturn)
+#endif
+inline void
+throw_bad_alloc()
+{
+#ifdef PRESENT_HAS_EXCEPTIONS
+    throw std::bad_alloc();
+#else
+    assert(!"out of memory");
+    abort();
+#endif
+}
+
+/** Integer division, rounding towards negative infinity (b must be > 0). */
+inline PRESENT_CONSTEXPR int_delta
+floor_div(int_delta a, int_delta b)
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/** Modulo that always has the sign of b (b must be > 0). */
+inline PRESENT_CONSTEXPR int_delta
+floor_mod(int_delta a, int_delta b)
+{
+    return a - floor_div(a, b) * b;
+}
+
+/** Round half away from zero (same as present_round in the C library). */
+inline PRESENT_CONSTEXPR double
+round(double x)
+{
+    return (x >= 0.0) ? (double)(int_delta)(x + 0.5) :
+        -(double)(int_delta)(-x + 0.5);
+}
+
+/** Determine whether a given year is a leap year. */
+inline PRESENT_CONSTEXPR bool
+is_leap_year(int_delta year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+/** Determine the number of days in a month (1 to 12) of a certain year. */
+inline PRESENT_CONSTEXPR int_day
+days_in_month(int_delta year, int_delta month)
+{
+    return (month == 2) ? (is_leap_year(year) ? 29 : 28) :
+        (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+/**
+ * Get the number of days since the UNIX epoch for a year, month, and day.
+ * Any of them may be out of range (for example, month 13 is January of the
+ * next year, and day 0 is the last day of the previous month).
+ */
+inline PRESENT_CONSTEXPR int_delta
+days_from_civil(int_delta year, int_delta month, int_delta day)
+{
+    int_delta era = 0, year_of_era = 0, day_of_year = 0, day_of_era = 0;
+
+    /* Fix irregularities in the month */
+    year += floor_div(month - 1, months_in_year);
+    month = floor_mod(month - 1, months_in_year) + 1;
+
+    /* http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+       (years are counted starting in March, so leap days are at the end) */
+    if (month <= 2) {
+        year -= 1;
+    }
+    era = floor_div(year, 400);
+    year_of_era = year - era * 400;
+    day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5;
+    day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 +
+        day_of_year;
+    return era * 146097 + day_of_era - 719468 + (day - 1);
+}
+
+/**
+ * Fill in a PresentDateData for a number of days since the UNIX epoch.
+ * This is the inverse of days_from_civil.
+ */
+inline PRESENT_CONSTEXPR void
+civil_from_days(int_delta days, PresentDateData & data)
+{
+    int_delta era = 0, day_of_era = 0, year_of_era = 0, day_of_year = 0,
+              month_index = 0, year = 0;
+
+    /* http://howardhinnant.github.io/date_algorithms.html#civil_from_days */
+    days += 719468;
+    era = floor_div(days, 146097);
+    day_of_era = days - era * 146097;
+    year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+            day_of_era / 146096) / 365;
+    year = year_of_era + era * 400;
+    day_of_year = day_of_era -
+        (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    month_index = (5 * day_of_year + 2) / 153;
+
+    data.day = (int_day)(day_of_year - (153 * month_index + 2) / 5 + 1);
+    data.month = (int_month)(month_index < 10 ? month_index + 3 :
+            month_index - 9);
+    data.year = (int_year)(data.month <= 2 ? year + 1 : year);
+
+    data.day_of_year = (int_day_of_year)(
+            days - 719468 - days_from_civil(data.year, 1, 1) + 1);
+    /* Jan. 1, 1970 was a Thursday */
+    data.day_of_week = (int_day_of_week)(
+            floor_mod(days - 719468 + 3, days_in_week) + 1);
+}
+
+/**
+ * Make sure that year, month, and day are valid (wrapping them around if
+ * necessary), and set day_of_year and day_of_week to their correct values.
+ */
+inline PRESENT_CONSTEXPR void
+normalize_date_data(PresentDateData & data)
+{
+    civil_from_days(days_from_civil(data.year, data.month, data.day), data);
+}
+
+/** Get the week number of the last week of a given year (52 or 53). */
+inline PRESENT_CONSTEXPR int_week_of_year
+last_week_of_year(int_delta year)
+{
+    const int_delta jan_1_day_of_week =
+        floor_mod(days_from_civil(year, 1, 1) + 3, days_in_week) + 1;
+
+    /* https://en.wikipedia.org/wiki/ISO_week_date#Weeks_per_year */
+    return (jan_1_day_of_week == DAY_OF_WEEK_THURSDAY ||
+            (is_leap_year(year) &&
+             jan_1_day_of_week == DAY_OF_WEEK_WEDNESDAY)) ? 53 : 52;
+}
+
+/**
+ * Alter delta_nanoseconds if necessary to ensure that its absolute value is
+ * less than NANOSECONDS_IN_SECOND, then ensure that the signs of
+ * delta_seconds and delta_nanoseconds match (see CHECK_DATA in
+ * time-delta.c).
+ */
+inline PRESENT_CONSTEXPR void
+normalize_time_delta_data(PresentTimeDeltaData & data)
+{
+    if (data.delta_nanoseconds > nanoseconds_in_second) {
+        data.delta_seconds += data.delta_nanoseconds / nanoseconds_in_second;
+        data.delta_nanoseconds %= nanoseconds_in_second;
+    } else if (data.delta_nanoseconds < -nanoseconds_in_second) {
+        data.delta_seconds -=
+            (-data.delta_nanoseconds) / nanoseconds_in_second;
+        data.delta_nanoseconds =
+            -((-data.delta_nanoseconds) % nanoseconds_in_second);
+    }
+    if (data.delta_seconds > 0 && data.delta_nanoseconds < 0) {
+        data.delta_seconds -= 1;
+        data.delta_nanoseconds += nanoseconds_in_second;
+    }
+    if (data.delta_seconds < 0 && data.delta_nanoseconds > 0) {
+        data.delta_seconds += 1;
+        data.delta_nanoseconds -= nanoseconds_in_second;
+    }
+}
+
+/**
+ * Make sure that additional_nanoseconds is a positive integer less than
+ * NANOSECONDS_IN_SECOND (see CHECK_DATA in timestamp.c).
+ */
+inline PRESENT_CONSTEXPR void
+normalize_timestamp_data(PresentTimestampData & data)
+{
+    data.timestamp_seconds +=
+        floor_div(data.additional_nanoseconds, nanoseconds_in_second);
+    data.additional_nanoseconds =
+        floor_mod(data.additional_nanoseconds, nanoseconds_in_second);
+}
+
+/**
+ * Make sure that the seconds and nanoseconds of a clock time wrap around
+ * properly (see check_clock_time in clock-time.c).
+ */
+inline PRESENT_CONSTEXPR void
+normalize_clock_time_data(PresentClockTimeData & data)
+{
+    data.seconds += floor_div(data.nanoseconds, nanoseconds_in_second);
+    data.nanoseconds = floor_mod(data.nanoseconds, nanoseconds_in_second);
+    data.seconds = floor_mod(data.seconds, seconds_in_day);
+}
+
+/**
+ * Compare two values, returning a negative integer, 0, or a positive integer
+ * (like STRUCT_COMPARE in the C library).
+ */
+template <typename T>
+inline PRESENT_CONSTEXPR short
+compare(const T & lhs, const T & rhs, short otherwise)
+{
+    return (lhs < rhs) ? -1 : ((lhs > rhs) ? 1 : otherwise);
+}
+
+#ifdef PRESENT_HAS_CHRONO
+
+/**
+ * Split a std::chrono::duration into whole seconds and the remaining
+ * nanoseconds (both truncated toward zero, so their signs match).
+ */
+template <typename Rep, typename Period>
+inline PRESENT_CONSTEXPR void
+split_duration(
+        const std::chrono::duration<Rep, Period> & duration,
+        int_delta & seconds,
+        int_delta & nanoseconds)
+{
+    const std::chrono::seconds whole =
+        std::chrono::duration_cast<std::chrono::seconds>(duration);
+
+    seconds = (int_delta)whole.count();
+    nanoseconds = (int_delta)std::chrono::duration_cast<
+        std::chrono::nanoseconds>(duration - whole).count();
+}
+
+/**
+ * Convert a std::chrono::duration to Duration, rounding down (like
+ * std::chrono::floor, which is not available before C++17).
+ */
+template <typename Duration, typename Rep, typename Period>
+inline PRESENT_CONSTEXPR Duration
+floor_duration(const std::chrono::duration<Rep, Period> & duration)
+{
+    const Duration truncated = std::chrono::duration_cast<Duration>(duration);
+    return (truncated > duration) ? truncated - Duration(1) : truncated;
+}
+
+/**
+ * Combine a number of seconds and nanoseconds (with the same sign) into a
+ * std::chrono::duration, rounding toward zero (like duration_cast).
+ *
+ * Only what is left of the seconds once they are converted (less than one
+ * Duration) is added to the nanoseconds, so the sum is rounded once (even if
+ * Duration's period does not divide a second), and the seconds cannot
+ * overflow a nanosecond count unless Duration itself is in nanoseconds.
+ */
+template <typename Duration>
+inline PRESENT_CONSTEXPR Duration
+join_duration(int_delta seconds, int_delta nanoseconds)
+{
+    const std::chrono::seconds all_seconds(seconds);
+    const Duration whole = std::chrono::duration_cast<Duration>(all_seconds);
+    return whole + std::chrono::duration_cast<Duration>(
+            (all_seconds - whole) + std::chrono::nanoseconds(nanoseconds));
+}
+
+/**
+ * Like join_duration, but rounding down, for nanoseconds from 0 to
+ * 999,999,999 (as in a Timestamp).
+ */
+template <typename Duration>
+inline PRESENT_CONSTEXPR Duration
+floor_join_duration(int_delta seconds, int_delta nanoseconds)
+{
+    const std::chrono::seconds all_seconds(seconds);
+    const Duration whole = floor_duration<Duration>(all_seconds);
+    return whole + floor_duration<Duration>(
+            (all_seconds - whole) + std::chrono::nanoseconds(nanoseconds));
+}
+
+#endif
+
+}
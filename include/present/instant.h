@@ -0,0 +1,328 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definitions of the Instant and Stopwatch structures and declarations of
+ * the corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/time-delta.h"
+
+#ifndef _PRESENT_INSTANT_H_
+#define _PRESENT_INSTANT_H_
+
+/**
+ * The clocks that an Instant can be read from.
+ *
+ * PRESENT_INSTANT_MONOTONIC is CLOCK_MONOTONIC, which never jumps (when the
+ * system time is set, or stepped by NTP), but may be slewed by NTP so that
+ * its rate matches the real time. It does not count time that the system is
+ * suspended.
+ *
+ * PRESENT_INSTANT_MONOTONIC_RAW is CLOCK_MONOTONIC_RAW, which is not slewed
+ * either (it runs at the hardware's rate).
+ *
+ * PRESENT_INSTANT_BOOTTIME is CLOCK_BOOTTIME, which is like CLOCK_MONOTONIC
+ * but also counts time that the system is suspended.
+ *
+ * PRESENT_INSTANT_TSC is the CPU's time stamp counter, scaled to nanoseconds
+ * from a reading of CLOCK_MONOTONIC taken when it was calibrated (see
+ * PRESENT_CLOCK_SOURCE_TSC). It is the cheapest to read, and never jumps,
+ * but it is not slewed by NTP either, so it drifts from CLOCK_MONOTONIC by a
+ * few parts per million. It is only available on x86 CPUs with an invariant
+ * TSC.
+ *
+ * Where a clock is not available, CLOCK_MONOTONIC is used instead (and
+ * where that is not available either, the system time).
+ */
+#define PRESENT_INSTANT_MONOTONIC       0
+#define PRESENT_INSTANT_MONOTONIC_RAW   1
+#define PRESENT_INSTANT_BOOTTIME        2
+#define PRESENT_INSTANT_TSC             3
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct representing a reading of a monotonic clock, for
+ * measuring how much time has passed (such as for latencies and timeouts).
+ *
+ * Unlike a Timestamp, an Instant is unaffected by changes to the system
+ * time, but it has no meaning on its own (it is only comparable to other
+ * Instants from the same clock, during the same boot of the same machine).
+ * The difference between two Instants is a TimeDelta, and an Instant can be
+ * moved by a TimeDelta, but there is deliberately no conversion between an
+ * Instant and a Timestamp.
+ */
+struct PRESENT_CLASS_API Instant {
+    /* The seconds of the clock reading */
+    int_timestamp seconds_;
+    /* The nanoseconds of the clock reading (0 to 999,999,999) */
+    int_timestamp nanoseconds_;
+    /* The clock that the Instant was read from (PRESENT_INSTANT_...) */
+    int clock_;
+
+#ifdef __cplusplus
+    /** @copydoc Instant_now */
+    static Instant now();
+    /** @copydoc Instant_now_from */
+    static Instant now(int clock);
+
+    /** @copydoc Instant_get_clock */
+    int clock() const;
+    /** @copydoc Instant_elapsed */
+    TimeDelta elapsed() const;
+
+    /** @copydoc Instant_add_TimeDelta */
+    Instant & operator+=(const TimeDelta & delta);
+    /** @copydoc Instant_subtract_TimeDelta */
+    Instant & operator-=(const TimeDelta & delta);
+
+    /** @see Instant::operator+=(const TimeDelta & delta) */
+    friend Instant operator+(const Instant & lhs, const TimeDelta & rhs);
+    /** @see Instant::operator+=(const TimeDelta & delta) */
+    friend Instant operator+(const TimeDelta & lhs, const Instant & rhs);
+    /** @see Instant::operator-=(const TimeDelta & delta) */
+    friend Instant operator-(const Instant & lhs, const TimeDelta & rhs);
+    /** @copydoc Instant_difference */
+    friend TimeDelta operator-(const Instant & lhs, const Instant & rhs);
+
+    /** @copydoc Instant_compare */
+    static short compare(const Instant & lhs, const Instant & rhs);
+
+    /** @copydoc Instant_equal */
+    friend bool operator==(const Instant & lhs, const Instant & rhs);
+    friend bool operator!=(const Instant & lhs, const Instant & rhs);
+    /** @copydoc Instant_less_than */
+    friend bool operator<(const Instant & lhs, const Instant & rhs);
+    /** @copydoc Instant_less_than_or_equal */
+    friend bool operator<=(const Instant & lhs, const Instant & rhs);
+    /** @copydoc Instant_greater_than */
+    friend bool operator>(const Instant & lhs, const Instant & rhs);
+    /** @copydoc Instant_greater_than_or_equal */
+    friend bool operator>=(const Instant & lhs, const Instant & rhs);
+#endif
+};
+
+/**
+ * Class or struct for timing how long something takes, with Instants from
+ * CLOCK_MONOTONIC. A Stopwatch can be stopped and resumed (adding up the
+ * time that it has been running), and can take laps.
+ *
+ * Starting, stopping, and reading a Stopwatch each read the clock once, and
+ * do nothing else that is expensive.
+ */
+struct PRESENT_CLASS_API Stopwatch {
+    /* When the Stopwatch was last started, resumed, or lapped */
+    struct Instant start_;
+    /* The time that the Stopwatch ran for before start_ */
+    struct TimeDelta elapsed_;
+    /* Whether the Stopwatch is running */
+    present_bool running_;
+
+#ifdef __cplusplus
+    /** @copydoc Stopwatch_start */
+    static Stopwatch start();
+    /** @copydoc Stopwatch_stopped */
+    static Stopwatch stopped();
+
+    /** @copydoc Stopwatch_is_running */
+    bool is_running() const;
+    /** @copydoc Stopwatch_elapsed */
+    TimeDelta elapsed() const;
+
+    /** @copydoc Stopwatch_stop */
+    TimeDelta stop();
+    /** @copydoc Stopwatch_resume */
+    void resume();
+    /** @copydoc Stopwatch_restart */
+    void restart();
+    /** @copydoc Stopwatch_lap */
+    TimeDelta lap();
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Get the current Instant from CLOCK_MONOTONIC.
+ */
+PRESENT_API struct Instant
+Instant_now(void);
+
+/**
+ * Get the current Instant from one of the PRESENT_INSTANT_... clocks.
+ */
+PRESENT_API struct Instant
+Instant_now_from(int clock);
+
+/**
+ * Get the clock that an Instant was read from (one of the PRESENT_INSTANT_...
+ * values).
+ */
+PRESENT_API int
+Instant_get_clock(const struct Instant * const self);
+
+/**
+ * Get the time that has passed since an Instant (on the same clock).
+ */
+PRESENT_API struct TimeDelta
+Instant_elapsed(const struct Instant * const self);
+
+/**
+ * Get the difference between two Instants from the same clock
+ * (self - other) as a @ref TimeDelta.
+ */
+PRESENT_API struct TimeDelta
+Instant_difference(
+        const struct Instant * const self,
+        const struct Instant * const other);
+
+/**
+ * Add a @ref TimeDelta to an Instant.
+ */
+PRESENT_API void
+Instant_add_TimeDelta(
+        struct Instant * const self,
+        const struct TimeDelta * const delta);
+
+/**
+ * Subtract a @ref TimeDelta from an Instant.
+ */
+PRESENT_API void
+Instant_subtract_TimeDelta(
+        struct Instant * const self,
+        const struct TimeDelta * const delta);
+
+/**
+ * Compare two Instants from the same clock.
+ *
+ * @retval >0 if the first Instant is later than the second
+ * @retval 0 if the Instants are the same
+ * @retval <0 if the first Instant is earlier than the second
+ */
+PRESENT_API short
+Instant_compare(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs);
+
+/**
+ * Determine whether two Instants from the same clock are the same.
+ */
+PRESENT_API present_bool
+Instant_equal(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs);
+
+/**
+ * Determine whether an Instant is earlier than another Instant from the same
+ * clock (lhs < rhs).
+ */
+PRESENT_API present_bool
+Instant_less_than(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs);
+
+/**
+ * Determine whether an Instant is earlier than or the same as another
+ * Instant from the same clock (lhs <= rhs).
+ */
+PRESENT_API present_bool
+Instant_less_than_or_equal(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs);
+
+/**
+ * Determine whether an Instant is later than another Instant from the same
+ * clock (lhs > rhs).
+ */
+PRESENT_API present_bool
+Instant_greater_than(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs);
+
+/**
+ * Determine whether an Instant is later than or the same as another Instant
+ * from the same clock (lhs >= rhs).
+ */
+PRESENT_API present_bool
+Instant_greater_than_or_equal(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs);
+
+/**
+ * Create a Stopwatch that is running from now.
+ */
+PRESENT_API struct Stopwatch
+Stopwatch_start(void);
+
+/**
+ * Create a Stopwatch that is stopped at zero (so that it can be resumed
+ * later).
+ */
+PRESENT_API struct Stopwatch
+Stopwatch_stopped(void);
+
+/**
+ * Determine whether a Stopwatch is running.
+ */
+PRESENT_API present_bool
+Stopwatch_is_running(const struct Stopwatch * const self);
+
+/**
+ * Get the total time that a Stopwatch has been running for (since it was
+ * started, or its last lap).
+ */
+PRESENT_API struct TimeDelta
+Stopwatch_elapsed(const struct Stopwatch * const self);
+
+/**
+ * Stop a Stopwatch (if it is running).
+ *
+ * @return The total time that it ran for.
+ */
+PRESENT_API struct TimeDelta
+Stopwatch_stop(struct Stopwatch * const self);
+
+/**
+ * Resume a stopped Stopwatch (or do nothing if it is running).
+ */
+PRESENT_API void
+Stopwatch_resume(struct Stopwatch * const self);
+
+/**
+ * Reset a Stopwatch to zero, and start it running from now.
+ */
+PRESENT_API void
+Stopwatch_restart(struct Stopwatch * const self);
+
+/**
+ * Take a lap: get the total time that a Stopwatch has been running for, and
+ * reset it to zero (leaving it running or stopped, as it was).
+ */
+PRESENT_API struct TimeDelta
+Stopwatch_lap(struct Stopwatch * const self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_INSTANT_H_ */
+
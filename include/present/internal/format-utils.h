@@ -0,0 +1,430 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Kernels for formatting dates and times as text
+ *
+ * These are shared by the C formatting functions (Date_format,
+ * ClockTime_format, and Timestamp_format) and the C++ formatters (see
+ * "present/impl/format.hpp"), so that both produce exactly the same output.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/internal/present-clock-time-data.h"
+#include "present/internal/present-date-data.h"
+
+#ifndef _PRESENT_FORMAT_UTILS_H_
+#define _PRESENT_FORMAT_UTILS_H_
+
+/*
+ * The parts of a value that a conversion needs. A Date has
+ * PRESENT_FORMAT_DATE, a ClockTime has PRESENT_FORMAT_CLOCK_TIME, and a
+ * Timestamp has all three.
+ */
+#define PRESENT_FORMAT_DATE         (1)
+#define PRESENT_FORMAT_CLOCK_TIME   (2)
+#define PRESENT_FORMAT_TIMESTAMP    (4)
+
+/** The most characters that a single conversion can produce (for %s). */
+#define PRESENT_FORMAT_MAX_CONVERSION_LENGTH (20)
+
+/**
+ * The fields of the value being formatted.
+ */
+struct PresentFormatFields {
+    struct PresentDateData date;
+    struct PresentClockTimeData clock_time;
+    /* UNIX timestamp (only used for Timestamps) */
+    int_timestamp timestamp_seconds;
+    /* Time zone offset, in seconds east of UTC (only used for Timestamps) */
+    int_delta time_zone_offset;
+};
+
+/** The digits of 00 through 99, for writing 2 digits at a time. */
+static const char PRESENT_FORMAT_DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/** Floored division (rounding toward negative infinity). */
+static PRESENT_INLINE present_int64
+present_format_floor_div(present_int64 value, present_int64 divisor)
+{
+    present_int64 quotient = value / divisor;
+    if ((value % divisor != 0) && ((value < 0) != (divisor < 0))) {
+        quotient -= 1;
+    }
+    return quotient;
+}
+
+/** Write a value from 0 to 99 as exactly 2 digits. */
+static PRESENT_INLINE char *
+present_format_2_digits(char * out, present_uint32 value)
+{
+    out[0] = PRESENT_FORMAT_DIGIT_PAIRS[value * 2];
+    out[1] = PRESENT_FORMAT_DIGIT_PAIRS[value * 2 + 1];
+    return out + 2;
+}
+
+/** Write a non-negative value as exactly width digits (with leading 0s). */
+static PRESENT_INLINE char *
+present_format_digits(char * out, present_uint64 value, int width)
+{
+    int i = width;
+
+    while (i >= 2) {
+        i -= 2;
+        present_format_2_digits(out + i, (present_uint32)(value % 100));
+        value /= 100;
+    }
+    if (i == 1) {
+        out[0] = (char)('0' + value % 10);
+    }
+    return out + width;
+}
+
+/**
+ * Write an integer with at least min_width digits (with leading 0s), plus a
+ * "-" if it is negative.
+ */
+static PRESENT_INLINE char *
+present_format_integer(char * out, present_int64 value, int min_width)
+{
+    present_uint64 magnitude, power = 10;
+    int width = 1;
+
+    if (value < 0) {
+        *out++ = '-';
+        magnitude = (present_uint64)0 - (present_uint64)value;
+    } else {
+        magnitude = (present_uint64)value;
+    }
+
+    while (width < 19 && magnitude >= power) {
+        width += 1;
+        power *= 10;
+    }
+    if (width < min_width) {
+        width = min_width;
+    }
+    return present_format_digits(out, magnitude, width);
+}
+
+/** Determine whether a year is a leap year. */
+static PRESENT_INLINE int
+present_format_is_leap_year(present_int64 year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/**
+ * Get the ISO 8601 week number of a date (1 to 53), and the year that the
+ * week belongs to (this matches Date_week_of_year).
+ */
+static PRESENT_INLINE int
+present_format_iso_week(
+        const struct PresentDateData * const date,
+        present_int64 * const week_year)
+{
+    present_int64 year = date->year, jan_1_day_of_week, previous_jan_1;
+    int week, weeks_in_year;
+
+    /* Day of the week of Jan. 1 of this year (1 = Monday, 7 = Sunday) */
+    jan_1_day_of_week = date->day_of_week - 1 - (date->day_of_year - 1);
+    jan_1_day_of_week = jan_1_day_of_week -
+        present_format_floor_div(jan_1_day_of_week, 7) * 7 + 1;
+
+    /* https://en.wikipedia.org/wiki/ISO_week_date#Weeks_per_year */
+    weeks_in_year = (jan_1_day_of_week == 4 ||
+            (jan_1_day_of_week == 3 && present_format_is_leap_year(year)))
+        ? 53 : 52;
+
+    week = (int)((date->day_of_year - date->day_of_week + 10) / 7);
+    if (week < 1) {
+        /* The last week of the previous year */
+        year -= 1;
+        previous_jan_1 = jan_1_day_of_week - 1 -
+            (present_format_is_leap_year(year) ? 366 : 365);
+        previous_jan_1 = previous_jan_1 -
+            present_format_floor_div(previous_jan_1, 7) * 7 + 1;
+        week = (previous_jan_1 == 4 ||
+                (previous_jan_1 == 3 && present_format_is_leap_year(year)))
+            ? 53 : 52;
+    } else if (week > weeks_in_year) {
+        /* The first week of the next year */
+        year += 1;
+        week = 1;
+    }
+
+    *week_year = year;
+    return week;
+}
+
+/**
+ * Fill in the fields for a UNIX timestamp, in the time zone with the given
+ * offset (in seconds east of UTC).
+ */
+static PRESENT_INLINE void
+present_format_timestamp_fields(
+        struct PresentFormatFields * const fields,
+        int_timestamp timestamp_seconds,
+        int_timestamp additional_nanoseconds,
+        int_delta time_zone_offset)
+{
+    present_int64 seconds, days, era, day_of_era, year_of_era, day_of_year,
+                  month_index, year;
+
+    seconds = timestamp_seconds + time_zone_offset;
+    days = present_format_floor_div(seconds, 86400);
+
+    fields->timestamp_seconds = timestamp_seconds;
+    fields->time_zone_offset = time_zone_offset;
+    fields->clock_time.seconds = seconds - days * 86400;
+    fields->clock_time.nanoseconds = additional_nanoseconds;
+
+    /* http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+       (this year starts on March 1, so leap days are at the end) */
+    fields->date.day_of_week = (int_day_of_week)(
+            (days + 3) - present_format_floor_div(days + 3, 7) * 7 + 1);
+    days += 719468;
+    era = present_format_floor_div(days, 146097);
+    day_of_era = days - era * 146097;
+    year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+            day_of_era / 146096) / 365;
+    day_of_year = day_of_era -
+        (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    month_index = (5 * day_of_year + 2) / 153;
+    year = year_of_era + era * 400 + (month_index >= 10 ? 1 : 0);
+
+    fields->date.year = (int_year)year;
+    fields->date.month = (int_month)(
+            month_index < 10 ? month_index + 3 : month_index - 9);
+    fields->date.day = (int_day)(
+            day_of_year - (153 * month_index + 2) / 5 + 1);
+    /* Convert the day of the (March-based) year to January-based */
+    fields->date.day_of_year = (int_day_of_year)(day_of_year >= 306
+            ? day_of_year - 305
+            : day_of_year + 60 + present_format_is_leap_year(year));
+}
+
+/**
+ * Get the most characters that a conversion (the character after the "%")
+ * can produce, and the parts of a value that it needs. Returns 0 if the
+ * conversion is not supported.
+ */
+static PRESENT_INLINE PRESENT_CONSTEXPR int
+present_format_conversion_info(char conversion, int * const needs)
+{
+    *needs = 0;
+    switch (conversion) {
+        case 'Y':
+        case 'G':
+            *needs = PRESENT_FORMAT_DATE;
+            return 11;
+        case 'F':
+            *needs = PRESENT_FORMAT_DATE;
+            return 17;
+        case 'y':
+        case 'm':
+        case 'd':
+        case 'V':
+            *needs = PRESENT_FORMAT_DATE;
+            return 2;
+        case 'j':
+            *needs = PRESENT_FORMAT_DATE;
+            return 3;
+        case 'u':
+            *needs = PRESENT_FORMAT_DATE;
+            return 1;
+        case 'H':
+        case 'M':
+        case 'S':
+            *needs = PRESENT_FORMAT_CLOCK_TIME;
+            return 2;
+        case 'R':
+            *needs = PRESENT_FORMAT_CLOCK_TIME;
+            return 5;
+        case 'T':
+            *needs = PRESENT_FORMAT_CLOCK_TIME;
+            return 8;
+        case 'f':
+            *needs = PRESENT_FORMAT_CLOCK_TIME;
+            return 9;
+        case 's':
+            *needs = PRESENT_FORMAT_TIMESTAMP;
+            return PRESENT_FORMAT_MAX_CONVERSION_LENGTH;
+        case 'z':
+            /* (The sign, at least 2 digits of hours, and 2 of minutes; an
+               offset of 100 hours or more has more digits of hours) */
+            *needs = PRESENT_FORMAT_TIMESTAMP;
+            return PRESENT_FORMAT_MAX_CONVERSION_LENGTH;
+        case '%':
+        case 'n':
+        case 't':
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Write a single conversion (the character after the "%"). The conversion
+ * must be supported (see present_format_conversion_info), and there must be
+ * room in out for its output.
+ */
+static PRESENT_INLINE char *
+present_format_conversion(
+        char * out,
+        char conversion,
+        const struct PresentFormatFields * const fields)
+{
+    const struct PresentDateData * const date = &fields->date;
+    const present_uint32 seconds = (present_uint32)fields->clock_time.seconds;
+    present_int64 week_year, offset;
+    int week;
+
+    switch (conversion) {
+        case 'Y':
+            return present_format_integer(out, date->year, 4);
+        case 'G':
+            present_format_iso_week(date, &week_year);
+            return present_format_integer(out, week_year, 4);
+        case 'F':
+            out = present_format_integer(out, date->year, 4);
+            *out++ = '-';
+            out = present_format_2_digits(out, (present_uint32)date->month);
+            *out++ = '-';
+            return present_format_2_digits(out, (present_uint32)date->day);
+        case 'y':
+            return present_format_2_digits(out, (present_uint32)(
+                    date->year - present_format_floor_div(date->year, 100) *
+                    100));
+        case 'm':
+            return present_format_2_digits(out, (present_uint32)date->month);
+        case 'd':
+            return present_format_2_digits(out, (present_uint32)date->day);
+        case 'V':
+            week = present_format_iso_week(date, &week_year);
+            return present_format_2_digits(out, (present_uint32)week);
+        case 'j':
+            return present_format_digits(out,
+                    (present_uint64)date->day_of_year, 3);
+        case 'u':
+            *out = (char)('0' + date->day_of_week);
+            return out + 1;
+        case 'H':
+            return present_format_2_digits(out, seconds / 3600);
+        case 'M':
+            return present_format_2_digits(out, seconds / 60 % 60);
+        case 'S':
+            return present_format_2_digits(out, seconds % 60);
+        case 'R':
+        case 'T':
+            out = present_format_2_digits(out, seconds / 3600);
+            *out++ = ':';
+            out = present_format_2_digits(out, seconds / 60 % 60);
+            if (conversion == 'R') {
+                return out;
+            }
+            *out++ = ':';
+            return present_format_2_digits(out, seconds % 60);
+        case 'f':
+            return present_format_digits(out,
+                    (present_uint64)fields->clock_time.nanoseconds, 9);
+        case 's':
+            return present_format_integer(out, fields->timestamp_seconds, 1);
+        case 'z':
+            offset = fields->time_zone_offset / 60;
+            if (offset < 0) {
+                *out++ = '-';
+                offset = -offset;
+            } else {
+                *out++ = '+';
+            }
+            out = present_format_integer(out, offset / 60, 2);
+            return present_format_2_digits(out, (present_uint32)(offset % 60));
+        case '%':
+            *out = '%';
+            return out + 1;
+        case 'n':
+            *out = '\n';
+            return out + 1;
+        case 't':
+            *out = '\t';
+            return out + 1;
+        default:
+            return out;
+    }
+}
+
+/**
+ * Format the fields according to a strftime-like format string (see
+ * Date_format for the supported conversions), including only the parts of
+ * the value in available.
+ *
+ * Returns the number of characters written to buffer (not including the
+ * terminating NUL), or 0 if the format is invalid, uses parts of the value
+ * that are not available, or would not fit in buffer_size characters.
+ */
+static PRESENT_INLINE size_t
+present_format(
+        char * const buffer,
+        size_t buffer_size,
+        const char * format,
+        int available,
+        const struct PresentFormatFields * const fields)
+{
+    char scratch[PRESENT_FORMAT_MAX_CONVERSION_LENGTH];
+    size_t length = 0, conversion_length;
+    int needs;
+
+    if (buffer_size == 0) {
+        return 0;
+    }
+
+    for (; *format != '\0'; ++format) {
+        if (*format != '%') {
+            if (length + 1 >= buffer_size) {
+                buffer[0] = '\0';
+                return 0;
+            }
+            buffer[length++] = *format;
+            continue;
+        }
+
+        ++format;
+        if (present_format_conversion_info(*format, &needs) == 0 ||
+                (needs & ~available) != 0) {
+            buffer[0] = '\0';
+            return 0;
+        }
+        conversion_length = (size_t)(
+                present_format_conversion(scratch, *format, fields) -
+                scratch);
+        if (length + conversion_length >= buffer_size) {
+            buffer[0] = '\0';
+            return 0;
+        }
+        memcpy(buffer + length, scratch, conversion_length);
+        length += conversion_length;
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+#endif /* _PRESENT_FORMAT_UTILS_H_ */
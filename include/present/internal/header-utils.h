@@ -10,17 +10,79 @@
 #ifndef _PRESENT_HEADER_UTILS_H_
 #define _PRESENT_HEADER_UTILS_H_
 
+/*
+ * Define inline keyword (C89 compilers may only have an extension for it)
+ */
+#if defined(__cplusplus) || \
+    (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)
+# define PRESENT_INLINE inline
+#elif defined(__GNUC__)
+# define PRESENT_INLINE __inline__
+#else
+# define PRESENT_INLINE
+#endif
+
+/*
+ * Define constexpr keyword for the C++ methods (C++11 constexpr functions are
+ * limited to a single return statement, so we require C++14)
+ */
+#if defined(__cplusplus) && __cplusplus >= 201402L
+# define PRESENT_CONSTEXPR constexpr
+#else
+# define PRESENT_CONSTEXPR
+#endif
+
+/*
+ * Define whether the C++ classes can be converted to and from std::chrono
+ * types (C++11), and whether that includes the C++20 calendar types
+ * (std::chrono::year_month_day, std::chrono::sys_days, std::chrono::hh_mm_ss)
+ */
+#if defined(__cplusplus) && __cplusplus >= 201103L
+# include <chrono>
+# define PRESENT_HAS_CHRONO 1
+# if __cplusplus >= 202002L
+#  define PRESENT_HAS_CHRONO_CALENDAR 1
+# endif
+#endif
+
+/*
+ * Define whether the C++ methods can throw exceptions (they cannot when
+ * exceptions are disabled, such as with -fno-exceptions)
+ */
+#if defined(__cplusplus) && (defined(__cpp_exceptions) || \
+        defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+# define PRESENT_HAS_EXCEPTIONS 1
+#endif
+
 /*
  * Define class header macro if we're compiling on Windows
  */
-#ifdef _WIN32
+#if defined(PRESENT_HEADER_ONLY)
+# define PRESENT_CLASS_API
+#elif defined(_WIN32)
 # ifdef PRESENT_EXPORTS
-#  define PRESENT_API __declspec(dllexport)
+#  define PRESENT_CLASS_API __declspec(dllexport)
 # else
-#  define PRESENT_API __declspec(dllimport)
+#  define PRESENT_CLASS_API __declspec(dllimport)
 # endif
 #else
-# define PRESENT_API
+# define PRESENT_CLASS_API
+#endif
+
+/*
+ * Define function header macros
+ *
+ * If PRESENT_HEADER_ONLY is defined, then the implementations of all the
+ * Present functions are included (as "static inline" functions) by present.h
+ * itself, rather than being compiled into libpresent, so the compiler can see
+ * through (and inline) them.
+ */
+#ifdef PRESENT_HEADER_ONLY
+# define PRESENT_API static PRESENT_INLINE
+# define PRESENT_INTERNAL_API static PRESENT_INLINE
+#else
+# define PRESENT_API PRESENT_CLASS_API
+# define PRESENT_INTERNAL_API
 #endif
 
 /*
@@ -30,5 +92,12 @@
 #define PRESENT_OVERLOAD_MAX_4(_1, _2, _3, _4, NAME, ...) NAME
 #define PRESENT_OVERLOAD_MAX_6(_1, _2, _3, _4, _5, _6, NAME, ...) NAME
 
+/*
+ * Number of present_uint64 words needed for the error mask passed to the
+ * batch constructors (e.g. Date_batch_from_year_month_day) for @p count
+ * entries. Entry i is represented by bit (i % 64) of word (i / 64).
+ */
+#define PRESENT_BATCH_MASK_WORDS(count) (((count) + 63) / 64)
+
 #endif /* _PRESENT_HEADER_UTILS_H_ */
 
@@ -0,0 +1,300 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the IntervalSet structure and declarations of the
+ * corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#ifndef _PRESENT_INTERVAL_SET_H_
+#define _PRESENT_INTERVAL_SET_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct TimeDelta;
+struct TimeInterval;
+struct Timestamp;
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct holding a set of points in time, as the union of a number
+ * of TimeIntervals (such as "working hours, minus meetings, minus outages").
+ *
+ * The set is stored as a sorted array of boundaries: the start of its first
+ * interval, the end of its first interval, the start of its second interval,
+ * and so on. The intervals are always coalesced (intervals that overlap or
+ * meet end to start are merged), so the boundaries are strictly increasing,
+ * and a point in time is in the set if an odd number of boundaries are at or
+ * before it. The boundaries are stored as separate arrays of seconds and
+ * nanoseconds, in a single block of memory.
+ *
+ * The union, intersection, and difference of two sets are found by merging
+ * their boundaries in one linear pass, into a single new block of memory.
+ *
+ * In C, an IntervalSet must be initialized with IntervalSet_init, and
+ * released with IntervalSet_destroy. In C++, this is done by the constructor
+ * and the destructor.
+ */
+struct PRESENT_CLASS_API IntervalSet {
+    /* The seconds of each boundary */
+    int_timestamp * seconds_;
+    /* The nanoseconds of each boundary (in the same block as seconds_) */
+    int_timestamp * nanoseconds_;
+    /* The number of boundaries (twice the number of intervals) */
+    size_t size_;
+    /* The number of boundaries that there is room for */
+    size_t capacity_;
+
+#ifdef __cplusplus
+    /** @copydoc IntervalSet_init */
+    IntervalSet();
+    /**
+     * @copydoc IntervalSet_assign_intervals
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    IntervalSet(const TimeInterval * intervals, size_t count);
+    IntervalSet(const IntervalSet & other);
+    IntervalSet & operator=(const IntervalSet & other);
+    /** @copydoc IntervalSet_destroy */
+    ~IntervalSet();
+
+    /** @copydoc IntervalSet_count */
+    size_t size() const;
+    /** Whether the set has no intervals. */
+    bool empty() const;
+    /** @copydoc IntervalSet_get */
+    TimeInterval operator[](size_t index) const;
+
+    /** @copydoc IntervalSet_clear */
+    void clear();
+    /**
+     * @copydoc IntervalSet_add
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void add(const TimeInterval & interval);
+
+    /** @copydoc IntervalSet_contains */
+    bool contains(const Timestamp & timestamp) const;
+    /** @copydoc IntervalSet_total_duration */
+    TimeDelta total_duration() const;
+    /** @copydoc IntervalSet_find_free_slot */
+    Timestamp find_free_slot(
+            const Timestamp & after,
+            const TimeDelta & duration) const;
+
+    /**
+     * Add every interval of another IntervalSet to this one.
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    IntervalSet & operator|=(const IntervalSet & other);
+    /**
+     * Remove the points in time that are not in another IntervalSet.
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    IntervalSet & operator&=(const IntervalSet & other);
+    /**
+     * Remove the points in time that are in another IntervalSet.
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    IntervalSet & operator-=(const IntervalSet & other);
+
+    /** @see IntervalSet::operator|=(const IntervalSet & other) */
+    friend IntervalSet operator|(
+            const IntervalSet & lhs,
+            const IntervalSet & rhs);
+    /** @see IntervalSet::operator&=(const IntervalSet & other) */
+    friend IntervalSet operator&(
+            const IntervalSet & lhs,
+            const IntervalSet & rhs);
+    /** @see IntervalSet::operator-=(const IntervalSet & other) */
+    friend IntervalSet operator-(
+            const IntervalSet & lhs,
+            const IntervalSet & rhs);
+
+    /** @copydoc IntervalSet_equal */
+    friend bool operator==(const IntervalSet & lhs, const IntervalSet & rhs);
+    friend bool operator!=(const IntervalSet & lhs, const IntervalSet & rhs);
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize an empty IntervalSet.
+ */
+PRESENT_API void
+IntervalSet_init(struct IntervalSet * const self);
+
+/**
+ * Release the memory held by an IntervalSet (which is left empty).
+ */
+PRESENT_API void
+IntervalSet_destroy(struct IntervalSet * const self);
+
+/**
+ * Replace the contents of an IntervalSet with a copy of another IntervalSet.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the set is unchanged).
+ */
+PRESENT_API present_bool
+IntervalSet_assign(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const other);
+
+/**
+ * Replace the contents of an IntervalSet with the union of an array of
+ * TimeIntervals (which may be in any order, and may overlap).
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the set is unchanged).
+ */
+PRESENT_API present_bool
+IntervalSet_assign_intervals(
+        struct IntervalSet * const self,
+        const struct TimeInterval * const intervals,
+        size_t count);
+
+/**
+ * Remove every interval from an IntervalSet (keeping its memory).
+ */
+PRESENT_API void
+IntervalSet_clear(struct IntervalSet * const self);
+
+/**
+ * Add a TimeInterval to an IntervalSet, merging it with the intervals that it
+ * overlaps or meets.
+ *
+ * This takes O(log n) time to find where the interval goes, plus the time to
+ * move the boundaries after it.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the set is unchanged).
+ */
+PRESENT_API present_bool
+IntervalSet_add(
+        struct IntervalSet * const self,
+        const struct TimeInterval * const interval);
+
+/**
+ * Replace the contents of an IntervalSet with the union of two IntervalSets
+ * (every point in time that is in either one).
+ *
+ * Either of @p lhs and @p rhs may be the same set as @p self.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the set is unchanged).
+ */
+PRESENT_API present_bool
+IntervalSet_union(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs);
+
+/**
+ * Replace the contents of an IntervalSet with the intersection of two
+ * IntervalSets (every point in time that is in both).
+ *
+ * @copydetails IntervalSet_union
+ */
+PRESENT_API present_bool
+IntervalSet_intersection(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs);
+
+/**
+ * Replace the contents of an IntervalSet with the difference of two
+ * IntervalSets (every point in time that is in @p lhs but not in @p rhs).
+ *
+ * @copydetails IntervalSet_union
+ */
+PRESENT_API present_bool
+IntervalSet_difference(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs);
+
+/**
+ * Get the number of (coalesced) intervals in an IntervalSet.
+ */
+PRESENT_API size_t
+IntervalSet_count(const struct IntervalSet * const self);
+
+/**
+ * Get an interval of an IntervalSet (the intervals are in order, and never
+ * empty).
+ *
+ * Precondition: @p index must be less than IntervalSet_count.
+ */
+PRESENT_API struct TimeInterval
+IntervalSet_get(const struct IntervalSet * const self, size_t index);
+
+/**
+ * Check whether a Timestamp is in an IntervalSet.
+ */
+PRESENT_API present_bool
+IntervalSet_contains(
+        const struct IntervalSet * const self,
+        const struct Timestamp * const timestamp);
+
+/**
+ * Get the total length of the intervals in an IntervalSet.
+ */
+PRESENT_API struct TimeDelta
+IntervalSet_total_duration(const struct IntervalSet * const self);
+
+/**
+ * Find the first free slot of a given length: the earliest time at or after
+ * @p after where an interval of length @p duration would not overlap the
+ * IntervalSet.
+ *
+ * There is always such a slot, since the set does not extend past the end of
+ * its last interval.
+ *
+ * @param duration The length of the slot (not negative).
+ * @return The start of the slot.
+ */
+PRESENT_API struct Timestamp
+IntervalSet_find_free_slot(
+        const struct IntervalSet * const self,
+        const struct Timestamp * const after,
+        const struct TimeDelta * const duration);
+
+/**
+ * Check whether two IntervalSets have the same intervals.
+ */
+PRESENT_API present_bool
+IntervalSet_equal(
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_INTERVAL_SET_H_ */
+
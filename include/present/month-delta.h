@@ -35,93 +35,107 @@
  * Class or struct representing a positive or negative delta of a number of
  * months or years.
  */
-struct PRESENT_API MonthDelta {
+struct PRESENT_CLASS_API MonthDelta {
     /* Internal data representation */
     struct PresentMonthDeltaData data_;
 
 #ifdef __cplusplus
     /** @copydoc MonthDelta_from_months */
-    static MonthDelta from_months(int_month_delta months);
+    static PRESENT_CONSTEXPR MonthDelta from_months(int_month_delta months);
 
     /** @copydoc MonthDelta_from_years */
-    static MonthDelta from_years(int_year_delta years);
+    static PRESENT_CONSTEXPR MonthDelta from_years(int_year_delta years);
 
     /** @copydoc MonthDelta_zero */
-    static MonthDelta zero();
+    static PRESENT_CONSTEXPR MonthDelta zero();
 
     /** @copydoc MonthDelta_months */
-    int_month_delta months() const;
+    PRESENT_CONSTEXPR int_month_delta months() const;
 
     /** @copydoc MonthDelta_years */
-    int_year_delta years() const;
+    PRESENT_CONSTEXPR int_year_delta years() const;
 
     /** @copydoc MonthDelta_years_decimal */
-    double years_decimal() const;
+    PRESENT_CONSTEXPR double years_decimal() const;
 
     /** @copydoc MonthDelta_is_negative */
-    bool is_negative() const;
+    PRESENT_CONSTEXPR bool is_negative() const;
 
     /** @copydoc MonthDelta_negate */
-    void negate();
+    PRESENT_CONSTEXPR void negate();
 
     /**
      * Return the negated version of this MonthDelta.
      * @see MonthDelta::negate
      */
-    MonthDelta operator-() const;
+    PRESENT_CONSTEXPR MonthDelta operator-() const;
 
     /** Add one month to the MonthDelta. */
-    MonthDelta & operator++();
+    PRESENT_CONSTEXPR MonthDelta & operator++();
     /** Add one month to the MonthDelta. */
-    MonthDelta operator++(int);
+    PRESENT_CONSTEXPR MonthDelta operator++(int);
     /** Subtract one month from the MonthDelta. */
-    MonthDelta & operator--();
+    PRESENT_CONSTEXPR MonthDelta & operator--();
     /** Subtract one month from the MonthDelta. */
-    MonthDelta operator--(int);
+    PRESENT_CONSTEXPR MonthDelta operator--(int);
 
     /** @copydoc MonthDelta_multiply_by */
-    MonthDelta & operator*=(const long & scale_factor);
+    PRESENT_CONSTEXPR MonthDelta & operator*=(const long & scale_factor);
     /** @copydoc MonthDelta_divide_by */
-    MonthDelta & operator/=(const long & scale_factor);
+    PRESENT_CONSTEXPR MonthDelta & operator/=(const long & scale_factor);
 
     /** @see MonthDelta::operator*=(const long & scale_factor) */
-    friend const MonthDelta operator*(
+    friend PRESENT_CONSTEXPR const MonthDelta operator*(
             const MonthDelta & delta,
             const long & scale_factor);
     /** @see MonthDelta::operator/=(const long & scale_factor) */
-    friend const MonthDelta operator/(
+    friend PRESENT_CONSTEXPR const MonthDelta operator/(
             const MonthDelta & delta,
             const long & scale_factor);
 
     /** @copydoc MonthDelta_add */
-    MonthDelta & operator+=(const MonthDelta & other);
+    PRESENT_CONSTEXPR MonthDelta & operator+=(const MonthDelta & other);
     /** @copydoc MonthDelta_subtract */
-    MonthDelta & operator-=(const MonthDelta & other);
+    PRESENT_CONSTEXPR MonthDelta & operator-=(const MonthDelta & other);
 
     /** @see MonthDelta::operator+=(const MonthDelta & other) */
-    friend const MonthDelta operator+(
+    friend PRESENT_CONSTEXPR const MonthDelta operator+(
             const MonthDelta & lhs,
             const MonthDelta & rhs);
     /** @see MonthDelta::operator-=(const MonthDelta & other) */
-    friend const MonthDelta operator-(
+    friend PRESENT_CONSTEXPR const MonthDelta operator-(
             const MonthDelta & lhs,
             const MonthDelta & rhs);
 
     /** @copydoc MonthDelta_compare */
-    static short compare(const MonthDelta & lhs, const MonthDelta & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const MonthDelta & lhs,
+            const MonthDelta & rhs);
 
     /** @copydoc MonthDelta_equal */
-    friend bool operator==(const MonthDelta &, const MonthDelta & rhs);
-    friend bool operator!=(const MonthDelta &, const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const MonthDelta &,
+            const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const MonthDelta &,
+            const MonthDelta & rhs);
 
     /** @copydoc MonthDelta_less_than */
-    friend bool operator<(const MonthDelta & lhs, const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const MonthDelta & lhs,
+            const MonthDelta & rhs);
     /** @copydoc MonthDelta_less_than_or_equal */
-    friend bool operator<=(const MonthDelta & lhs, const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const MonthDelta & lhs,
+            const MonthDelta & rhs);
     /** @copydoc MonthDelta_greater_than */
-    friend bool operator>(const MonthDelta & lhs, const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const MonthDelta & lhs,
+            const MonthDelta & rhs);
     /** @copydoc MonthDelta_greater_than_or_equal */
-    friend bool operator>=(const MonthDelta & lhs, const MonthDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const MonthDelta & lhs,
+            const MonthDelta & rhs);
 #endif
 };
 
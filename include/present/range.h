@@ -0,0 +1,407 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definitions of the DateRange and TimestampRange structures (and their
+ * iterators) and declarations of the corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/date.h"
+#include "present/timestamp.h"
+
+#ifdef __cplusplus
+#include <iterator>
+#endif
+
+#ifndef _PRESENT_RANGE_H_
+#define _PRESENT_RANGE_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct DayDelta;
+struct MonthDelta;
+struct TimeDelta;
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct holding the position of an iteration over a DateRange.
+ *
+ * Each step moves the current Date forward (or backward) incrementally: the
+ * day is bumped, the month and the year are rolled over only when the day
+ * runs past the end of the month, and the day of the week and the day of the
+ * year are updated with modular arithmetic, so no step calls into the C
+ * standard library.
+ */
+struct PRESENT_CLASS_API DateRangeIterator {
+    /* The current Date (unless remaining_ is 0) */
+    struct Date current_;
+    /* The number of Dates left, including the current one */
+    size_t remaining_;
+    /* The step, in days (if step_months_ is 0) */
+    int_delta step_days_;
+    /* The step, in months */
+    int_delta step_months_;
+    /* For month steps: the year and month (as year * 12 + month - 1) and the
+       day of the current Date, before any overflow past the end of the
+       month */
+    int_delta month_index_;
+    int_day day_;
+
+#ifdef __cplusplus
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Date value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const Date * pointer;
+    typedef const Date & reference;
+
+    /** @copydoc DateRangeIterator_get */
+    const Date & operator*() const;
+    const Date * operator->() const;
+    /** @copydoc DateRangeIterator_next */
+    DateRangeIterator & operator++();
+    DateRangeIterator operator++(int);
+
+    /**
+     * Iterators are equal if they are both done, or if they have the same
+     * current Date and the same number of Dates left.
+     */
+    friend bool operator==(
+            const DateRangeIterator & lhs,
+            const DateRangeIterator & rhs);
+    friend bool operator!=(
+            const DateRangeIterator & lhs,
+            const DateRangeIterator & rhs);
+#endif
+};
+
+/**
+ * Class or struct representing the Dates from a first Date up to (but not
+ * including) an end Date, a fixed number of days or months apart.
+ *
+ * Date i of the range is the first Date plus i times the step (with a
+ * MonthDelta step, a day that is past the end of a month overflows into the
+ * next month, as with Date_add_MonthDelta). If the step is negative, the
+ * range goes backward from the first Date, down to (but not including) the
+ * end Date.
+ *
+ * A range can be iterated over one Date at a time (DateRange_begin, or a
+ * range-based for loop in C++), or written into an array all at once
+ * (DateRange_materialize), which converts each Date straight from its index,
+ * so no element of the array depends on the one before it.
+ */
+struct PRESENT_CLASS_API DateRange {
+    /* The first Date */
+    struct Date first_;
+    /* The end Date (not included) */
+    struct Date end_;
+    /* The step, in days (if step_months_ is 0) */
+    int_delta step_days_;
+    /* The step, in months */
+    int_delta step_months_;
+
+#ifdef __cplusplus
+    /** @copydoc DateRange_from_DayDelta */
+    static DateRange create(
+            const Date & first,
+            const Date & end,
+            const DayDelta & step);
+    /** @copydoc DateRange_from_MonthDelta */
+    static DateRange create(
+            const Date & first,
+            const Date & end,
+            const MonthDelta & step);
+
+    /** @copydoc DateRange_size */
+    size_t size() const;
+    /** Whether the range has no Dates. */
+    bool empty() const;
+    /** @copydoc DateRange_get */
+    Date operator[](size_t index) const;
+    /** @copydoc DateRange_materialize */
+    size_t materialize(Date * results, size_t capacity) const;
+
+    /** @copydoc DateRange_begin */
+    DateRangeIterator begin() const;
+    /** Get an iterator that is done (past the last Date of the range). */
+    DateRangeIterator end() const;
+#endif
+};
+
+/**
+ * Class or struct holding the position of an iteration over a
+ * TimestampRange.
+ *
+ * Each step adds the seconds and the nanoseconds of the step to the current
+ * Timestamp, with at most one carry between them.
+ */
+struct PRESENT_CLASS_API TimestampRangeIterator {
+    /* The current Timestamp (unless remaining_ is 0) */
+    struct Timestamp current_;
+    /* The number of Timestamps left, including the current one */
+    size_t remaining_;
+    /* The step, as whole seconds (rounded down) and nanoseconds (from 0 to
+       999,999,999) */
+    int_timestamp step_seconds_;
+    int_timestamp step_nanoseconds_;
+
+#ifdef __cplusplus
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Timestamp value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const Timestamp * pointer;
+    typedef const Timestamp & reference;
+
+    /** @copydoc TimestampRangeIterator_get */
+    const Timestamp & operator*() const;
+    const Timestamp * operator->() const;
+    /** @copydoc TimestampRangeIterator_next */
+    TimestampRangeIterator & operator++();
+    TimestampRangeIterator operator++(int);
+
+    /**
+     * Iterators are equal if they are both done, or if they have the same
+     * current Timestamp and the same number of Timestamps left.
+     */
+    friend bool operator==(
+            const TimestampRangeIterator & lhs,
+            const TimestampRangeIterator & rhs);
+    friend bool operator!=(
+            const TimestampRangeIterator & lhs,
+            const TimestampRangeIterator & rhs);
+#endif
+};
+
+/**
+ * Class or struct representing the Timestamps from a first Timestamp up to
+ * (but not including) an end Timestamp, a fixed TimeDelta apart.
+ *
+ * Timestamp i of the range is the first Timestamp plus i times the step. If
+ * the step is negative, the range goes backward from the first Timestamp,
+ * down to (but not including) the end Timestamp.
+ */
+struct PRESENT_CLASS_API TimestampRange {
+    /* The first Timestamp */
+    struct Timestamp first_;
+    /* The end Timestamp (not included) */
+    struct Timestamp end_;
+    /* The step, as whole seconds (rounded down) and nanoseconds (from 0 to
+       999,999,999) */
+    int_timestamp step_seconds_;
+    int_timestamp step_nanoseconds_;
+
+#ifdef __cplusplus
+    /** @copydoc TimestampRange_from_TimeDelta */
+    static TimestampRange create(
+            const Timestamp & first,
+            const Timestamp & end,
+            const TimeDelta & step);
+
+    /** @copydoc TimestampRange_size */
+    size_t size() const;
+    /** Whether the range has no Timestamps. */
+    bool empty() const;
+    /** @copydoc TimestampRange_get */
+    Timestamp operator[](size_t index) const;
+    /** @copydoc TimestampRange_materialize */
+    size_t materialize(Timestamp * results, size_t capacity) const;
+
+    /** @copydoc TimestampRange_begin */
+    TimestampRangeIterator begin() const;
+    /** Get an iterator that is done (past the last Timestamp of the range). */
+    TimestampRangeIterator end() const;
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a new DateRange from a first Date, an end Date (not included), and a
+ * (non-zero) step in days.
+ */
+PRESENT_API struct DateRange
+DateRange_from_DayDelta(
+        const struct Date * const first,
+        const struct Date * const end,
+        const struct DayDelta * const step);
+
+/**
+ * Create a new DateRange from a first Date, an end Date (not included), and a
+ * (non-zero) step in months.
+ */
+PRESENT_API struct DateRange
+DateRange_from_MonthDelta(
+        const struct Date * const first,
+        const struct Date * const end,
+        const struct MonthDelta * const step);
+
+/**
+ * Get the number of Dates in a DateRange (in constant time).
+ */
+PRESENT_API size_t
+DateRange_size(const struct DateRange * const self);
+
+/**
+ * Get Date number @p index (counting from 0) of a DateRange, which is the
+ * first Date plus @p index times the step.
+ */
+PRESENT_API struct Date
+DateRange_get(const struct DateRange * const self, size_t index);
+
+/**
+ * Write the Dates of a DateRange into an array.
+ *
+ * @param[out] results An array for the Dates (@p capacity entries). May be
+ * NULL if @p capacity is 0.
+ * @param capacity The most Dates to write.
+ * @return The number of Dates in the range (if this is more than
+ * @p capacity, only the first @p capacity were written).
+ */
+PRESENT_API size_t
+DateRange_materialize(
+        const struct DateRange * const self,
+        struct Date * const results,
+        size_t capacity);
+
+/**
+ * Start an iteration over a DateRange, at its first Date.
+ *
+ * ~~~{.c}
+ * struct DateRangeIterator it;
+ * for (DateRange_begin(&range, &it);
+ *         !DateRangeIterator_done(&it);
+ *         DateRangeIterator_next(&it)) {
+ *     struct Date date = DateRangeIterator_get(&it);
+ *     ...
+ * }
+ * ~~~
+ *
+ * @param[out] iterator A pointer to a struct DateRangeIterator for the
+ * position.
+ */
+PRESENT_API void
+DateRange_begin(
+        const struct DateRange * const self,
+        struct DateRangeIterator * const iterator);
+
+/**
+ * Determine whether an iteration over a DateRange is done (it is past the last
+ * Date of the range).
+ */
+PRESENT_API present_bool
+DateRangeIterator_done(const struct DateRangeIterator * const self);
+
+/**
+ * Get the current Date of an iteration over a DateRange (which must not be
+ * done).
+ */
+PRESENT_API struct Date
+DateRangeIterator_get(const struct DateRangeIterator * const self);
+
+/**
+ * Move an iteration over a DateRange (which must not be done) to the next
+ * Date.
+ */
+PRESENT_API void
+DateRangeIterator_next(struct DateRangeIterator * const self);
+
+/**
+ * Create a new TimestampRange from a first Timestamp, an end Timestamp (not
+ * included), and a (non-zero) step.
+ */
+PRESENT_API struct TimestampRange
+TimestampRange_from_TimeDelta(
+        const struct Timestamp * const first,
+        const struct Timestamp * const end,
+        const struct TimeDelta * const step);
+
+/**
+ * Get the number of Timestamps in a TimestampRange (in constant time).
+ */
+PRESENT_API size_t
+TimestampRange_size(const struct TimestampRange * const self);
+
+/**
+ * Get Timestamp number @p index (counting from 0) of a TimestampRange, which
+ * is the first Timestamp plus @p index times the step.
+ */
+PRESENT_API struct Timestamp
+TimestampRange_get(const struct TimestampRange * const self, size_t index);
+
+/**
+ * Write the Timestamps of a TimestampRange into an array.
+ *
+ * @param[out] results An array for the Timestamps (@p capacity entries). May
+ * be NULL if @p capacity is 0.
+ * @param capacity The most Timestamps to write.
+ * @return The number of Timestamps in the range (if this is more than
+ * @p capacity, only the first @p capacity were written).
+ */
+PRESENT_API size_t
+TimestampRange_materialize(
+        const struct TimestampRange * const self,
+        struct Timestamp * const results,
+        size_t capacity);
+
+/**
+ * Start an iteration over a TimestampRange, at its first Timestamp (see
+ * DateRange_begin).
+ *
+ * @param[out] iterator A pointer to a struct TimestampRangeIterator for the
+ * position.
+ */
+PRESENT_API void
+TimestampRange_begin(
+        const struct TimestampRange * const self,
+        struct TimestampRangeIterator * const iterator);
+
+/**
+ * Determine whether an iteration over a TimestampRange is done (it is past
+ * the last Timestamp of the range).
+ */
+PRESENT_API present_bool
+TimestampRangeIterator_done(
+        const struct TimestampRangeIterator * const self);
+
+/**
+ * Get the current Timestamp of an iteration over a TimestampRange (which
+ * must not be done).
+ */
+PRESENT_API struct Timestamp
+TimestampRangeIterator_get(const struct TimestampRangeIterator * const self);
+
+/**
+ * Move an iteration over a TimestampRange (which must not be done) to the
+ * next Timestamp.
+ */
+PRESENT_API void
+TimestampRangeIterator_next(struct TimestampRangeIterator * const self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_RANGE_H_ */
+
@@ -0,0 +1,341 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the Recurrence structure (and its iterator) and declarations
+ * of the corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/date.h"
+#include "present/timestamp.h"
+
+#ifndef _PRESENT_RECURRENCE_H_
+#define _PRESENT_RECURRENCE_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct ClockTime;
+struct TimeDelta;
+
+/*
+ * Frequencies of a Recurrence (the FREQ part of a rule)
+ */
+
+/** Every day (FREQ=DAILY). */
+#define PRESENT_RECURRENCE_DAILY    (0)
+/** Every week (FREQ=WEEKLY). */
+#define PRESENT_RECURRENCE_WEEKLY   (1)
+/** Every month (FREQ=MONTHLY). */
+#define PRESENT_RECURRENCE_MONTHLY  (2)
+/** Every year (FREQ=YEARLY). */
+#define PRESENT_RECURRENCE_YEARLY   (3)
+
+/** The most BYSETPOS values in a rule. */
+#define PRESENT_RECURRENCE_MAX_SET_POS  (16)
+
+/**
+ * The number of 64-bit words in the mask of the days of a period of a
+ * Recurrence (enough for the 366 days of a leap year).
+ */
+#define PRESENT_RECURRENCE_PERIOD_WORDS (6)
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+struct RecurrenceIterator;
+
+/**
+ * Class or struct representing an iCalendar (RFC 5545) recurrence rule
+ * (RRULE), along with the start (DTSTART) and the excluded occurrences
+ * (EXDATE) of the recurring event.
+ *
+ * The rule is expanded one period (a day, a week, a month, or a year,
+ * depending on the frequency) at a time: the candidate days of the period
+ * are built as a bit mask from the BYMONTH, BYMONTHDAY, and BYDAY parts,
+ * BYSETPOS picks among them, and the occurrences are read off of the mask in
+ * order. An iteration over a window of time starts directly at the period
+ * that contains the start of the window, rather than at the start of the
+ * event; with a COUNT, the occurrences of the periods before the window are
+ * counted (with a popcount of each mask) rather than generated.
+ *
+ * Every occurrence is at the time of day of the start, in the time zone
+ * offset of the start. Occurrences before the start are never generated, and
+ * the start itself is only an occurrence if it matches the rule.
+ *
+ * The frequencies below DAILY (SECONDLY, MINUTELY, and HOURLY) and the BYHOUR,
+ * BYMINUTE, BYSECOND, BYYEARDAY, and BYWEEKNO parts are not supported. In a
+ * YEARLY rule without BYMONTH, a BYDAY with a number (such as "20MO") counts
+ * weeks within the year.
+ */
+struct PRESENT_CLASS_API Recurrence {
+    /**
+     * This will be true if there were any errors when creating this
+     * Recurrence.
+     *
+     * @copydoc has_error_epilogue
+     */
+    present_bool has_error;
+
+    /**
+     * If there were any errors when creating this Recurrence, then one or
+     * more of these fields will be set.
+     *
+     * @copydoc errors_epilogue
+     */
+    struct {
+        unsigned int invalid_start      : 1,
+                     invalid_rule       : 1,
+                     unsupported_rule   : 1;
+    } errors;
+
+    /* The frequency (one of the PRESENT_RECURRENCE_ values) */
+    int frequency_;
+    /* The number of periods between the periods with occurrences */
+    int_delta interval_;
+    /* The number of occurrences (or 0 if there is no COUNT) */
+    int_delta count_;
+    /* Whether there is an UNTIL, and the last day that an occurrence may be
+       on (in days since the UNIX epoch) */
+    present_bool has_until_;
+    int_delta until_day_;
+
+    /* The start (in days since the UNIX epoch), and its year, month, and
+       day */
+    int_delta start_day_;
+    int_year start_year_;
+    int_month start_month_;
+    int_day start_day_of_month_;
+    /* The time of each occurrence after midnight UTC of its day (which may
+       be negative, or more than a day, with a time zone offset) */
+    int_timestamp time_seconds_;
+    int_timestamp time_nanoseconds_;
+    /* The first day of the week (1 to 7, with 1 being Monday) */
+    int week_start_;
+
+    /* The months (bit 0 for January), or 0 for any month */
+    unsigned int by_month_;
+    /* The days of the month from the start (bit 0 for the 1st) and from the
+       end (bit 0 for the last day) */
+    present_uint32 by_month_day_;
+    present_uint32 by_month_day_from_end_;
+    /* Each day of the week (by PRESENT_WEEKDAY_BIT) in BYDAY without a
+       number */
+    unsigned int by_day_;
+    /* For each day of the week (from Monday), its numbers in BYDAY from the
+       start (bit 0 for 1) and from the end (bit 0 for -1) */
+    present_uint64 by_day_nth_[7];
+    present_uint64 by_day_nth_from_end_[7];
+    /* The BYSETPOS values */
+    int by_set_pos_[PRESENT_RECURRENCE_MAX_SET_POS];
+    size_t by_set_pos_count_;
+
+    /* The excluded occurrences, in order (not owned) */
+    const struct Timestamp * exdates_;
+    size_t exdate_count_;
+
+#ifdef __cplusplus
+    /** @copydoc Recurrence_from_rule */
+    static Recurrence create(
+            const Date & start,
+            const ClockTime & time,
+            const TimeDelta & time_zone_offset,
+            const char * rule);
+
+    /** @copydoc Recurrence_set_exdates */
+    void set_exdates(const Timestamp * exdates, size_t exdate_count);
+
+    /** @copydoc Recurrence_begin */
+    RecurrenceIterator begin(const Timestamp & from) const;
+    /** @copydoc Recurrence_begin */
+    RecurrenceIterator begin(
+            const Timestamp & from,
+            const Timestamp & end) const;
+    /** @copydoc Recurrence_expand */
+    size_t expand(
+            const Timestamp & from,
+            const Timestamp & end,
+            Timestamp * results,
+            size_t capacity) const;
+#endif
+};
+
+/**
+ * Class or struct holding the position of an iteration over the occurrences
+ * of a Recurrence (which must outlive it).
+ */
+struct PRESENT_CLASS_API RecurrenceIterator {
+    /* The Recurrence */
+    const struct Recurrence * recurrence_;
+    /* The number of the current period (counting from the period of the
+       start), and its first day (in days since the UNIX epoch) */
+    int_delta period_;
+    int_delta period_first_day_;
+    /* The days of the current period that have not been looked at yet (bit i
+       for period_first_day_ + i) */
+    present_uint64 days_[PRESENT_RECURRENCE_PERIOD_WORDS];
+    /* The number of occurrences before the current position (for COUNT) */
+    int_delta generated_;
+    /* The first day of the window, and the end of the window (if has_end_) */
+    int_delta from_day_;
+    present_bool has_end_;
+    int_delta end_day_;
+    /* The first of the excluded occurrences that may still come up */
+    size_t exdate_index_;
+    /* Whether there are no more occurrences */
+    present_bool done_;
+
+#ifdef __cplusplus
+    /** @copydoc RecurrenceIterator_done */
+    bool done() const;
+    /** @copydoc RecurrenceIterator_next_timestamps */
+    size_t next(Timestamp * results, size_t capacity);
+    /** @copydoc RecurrenceIterator_next_dates */
+    size_t next(Date * results, size_t capacity);
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a new Recurrence from the start of a recurring event (DTSTART, as a
+ * date and a time of day in a time zone offset) and an RFC 5545 recurrence
+ * rule, such as "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1;COUNT=12".
+ *
+ * The rule may start with "RRULE:", and is case-insensitive. A date-time
+ * UNTIL without a "Z" is in the time zone offset of the start.
+ *
+ * If the start is erroneous, the Recurrence will have @p has_error and
+ * @p errors.invalid_start set. If the rule cannot be parsed or breaks the
+ * rules of RFC 5545, it will have @p errors.invalid_rule set; if it uses a
+ * part that is not supported, it will have @p errors.unsupported_rule set.
+ */
+PRESENT_API struct Recurrence
+Recurrence_from_rule(
+        const struct Date * const start,
+        const struct ClockTime * const time,
+        const struct TimeDelta * const time_zone_offset,
+        const char * const rule);
+
+/**
+ * Set the occurrences of a Recurrence to leave out (EXDATE).
+ *
+ * @param exdates The excluded occurrences, in order from earliest to latest.
+ * The array is not copied, so it must outlive the Recurrence (and any
+ * iteration over it). May be NULL if @p exdate_count is 0.
+ */
+PRESENT_API void
+Recurrence_set_exdates(
+        struct Recurrence * const self,
+        const struct Timestamp * const exdates,
+        size_t exdate_count);
+
+/**
+ * Start an iteration over the occurrences of a (non-erroneous) Recurrence
+ * that are at or after @p from, and before @p end.
+ *
+ * ~~~{.c}
+ * struct RecurrenceIterator it;
+ * struct Timestamp batch[64];
+ * size_t count;
+ * Recurrence_begin(&recurrence, &from, &end, &it);
+ * while ((count = RecurrenceIterator_next_timestamps(&it, batch, 64)) > 0) {
+ *     ...
+ * }
+ * ~~~
+ *
+ * @param end The end of the window (not included), or NULL for no end.
+ * @param[out] iterator A pointer to a struct RecurrenceIterator for the
+ * position.
+ */
+PRESENT_API void
+Recurrence_begin(
+        const struct Recurrence * const self,
+        const struct Timestamp * const from,
+        const struct Timestamp * const end,
+        struct RecurrenceIterator * const iterator);
+
+/**
+ * Write the first occurrences of a (non-erroneous) Recurrence that are at or
+ * after @p from, and before @p end, into an array.
+ *
+ * @param[out] results An array for the occurrences (@p capacity entries).
+ * May be NULL if @p capacity is 0.
+ * @param capacity The most occurrences to write.
+ * @return The number of occurrences written (use Recurrence_begin to go past
+ * @p capacity).
+ */
+PRESENT_API size_t
+Recurrence_expand(
+        const struct Recurrence * const self,
+        const struct Timestamp * const from,
+        const struct Timestamp * const end,
+        struct Timestamp * const results,
+        size_t capacity);
+
+/**
+ * Determine whether an iteration over the occurrences of a Recurrence is
+ * known to be done (the next batch would be empty).
+ *
+ * This may be false even if there are no more occurrences, when the end has
+ * not been reached yet.
+ */
+PRESENT_API present_bool
+RecurrenceIterator_done(const struct RecurrenceIterator * const self);
+
+/**
+ * Write the next occurrences of an iteration over a Recurrence into an
+ * array.
+ *
+ * @param[out] results An array for the occurrences (@p capacity entries).
+ * @param capacity The most occurrences to write.
+ * @return The number of occurrences written, which is less than
+ * @p capacity only if there are no more occurrences.
+ */
+PRESENT_API size_t
+RecurrenceIterator_next_timestamps(
+        struct RecurrenceIterator * const self,
+        struct Timestamp * const results,
+        size_t capacity);
+
+/**
+ * Write the dates (in the time zone offset of the start) of the next
+ * occurrences of an iteration over a Recurrence into an array.
+ *
+ * @param[out] results An array for the dates (@p capacity entries).
+ * @param capacity The most dates to write.
+ * @return The number of dates written, which is less than @p capacity only
+ * if there are no more occurrences.
+ */
+PRESENT_API size_t
+RecurrenceIterator_next_dates(
+        struct RecurrenceIterator * const self,
+        struct Date * const results,
+        size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_RECURRENCE_H_ */
+
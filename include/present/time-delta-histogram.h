@@ -0,0 +1,296 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the TimeDeltaHistogram structure and declarations of the
+ * corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#ifndef _PRESENT_TIME_DELTA_HISTOGRAM_H_
+#define _PRESENT_TIME_DELTA_HISTOGRAM_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct TimeDelta;
+
+/** The smallest precision of a TimeDeltaHistogram (in bits). */
+#define PRESENT_HISTOGRAM_MIN_PRECISION 1
+
+/** The largest precision of a TimeDeltaHistogram (in bits). */
+#define PRESENT_HISTOGRAM_MAX_PRECISION 20
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct holding a histogram of TimeDelta values (such as request
+ * latencies), for finding percentiles without keeping every value.
+ *
+ * The buckets are log-linear, like an HDR histogram: values below
+ * 2^(precision + 1) nanoseconds each have their own bucket, and each power
+ * of 2 above that is split into 2^precision buckets of equal width. So every
+ * value is recorded to within a relative error of 2^-precision (for
+ * example, a precision of 7 bits keeps values to within 1%), from 1
+ * nanosecond up to the highest value that the histogram was configured
+ * with, using a few thousand buckets.
+ *
+ * Recording a value finds its bucket with a few shifts and adds to a
+ * counter; it never allocates memory. A TimeDeltaHistogram is not
+ * thread-safe: to record values from many threads without locking, give
+ * each thread its own histogram (with the same configuration), and merge
+ * them when reporting, which adds the arrays of counters.
+ *
+ * Negative values are recorded as 0, and values above the highest value are
+ * recorded in the last bucket (the exact min and max are kept separately).
+ *
+ * In C, a TimeDeltaHistogram must be initialized with
+ * TimeDeltaHistogram_init, and released with TimeDeltaHistogram_destroy. In
+ * C++, this is done by the constructor and the destructor.
+ */
+struct PRESENT_CLASS_API TimeDeltaHistogram {
+    /* The number of values in each bucket */
+    present_uint64 * counts_;
+    /* The number of buckets (0 if the histogram is not configured) */
+    size_t bucket_count_;
+    /* The number of bits of precision */
+    int precision_;
+    /* The highest value that has its own bucket (in nanoseconds) */
+    present_int64 highest_;
+    /* The number of values recorded */
+    present_uint64 total_count_;
+    /* The smallest and largest values recorded (in nanoseconds) */
+    present_int64 min_;
+    present_int64 max_;
+
+#ifdef __cplusplus
+    /** @copydoc TimeDeltaHistogram_init */
+    TimeDeltaHistogram();
+    /**
+     * @copydoc TimeDeltaHistogram_configure
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    TimeDeltaHistogram(const TimeDelta & highest, int precision);
+    TimeDeltaHistogram(const TimeDeltaHistogram & other);
+    TimeDeltaHistogram & operator=(const TimeDeltaHistogram & other);
+    /** @copydoc TimeDeltaHistogram_destroy */
+    ~TimeDeltaHistogram();
+
+    /**
+     * @copydoc TimeDeltaHistogram_configure
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void configure(const TimeDelta & highest, int precision);
+
+    /** The number of bits of precision. */
+    int precision() const;
+    /** The number of buckets. */
+    size_t bucket_count() const;
+
+    /** @copydoc TimeDeltaHistogram_record */
+    void record(const TimeDelta & value);
+    /** @copydoc TimeDeltaHistogram_record_count */
+    void record(const TimeDelta & value, present_uint64 count);
+    /** @copydoc TimeDeltaHistogram_merge */
+    void merge(const TimeDeltaHistogram & other);
+    /** @copydoc TimeDeltaHistogram_clear */
+    void clear();
+
+    /** @copydoc TimeDeltaHistogram_count */
+    present_uint64 count() const;
+    /** @copydoc TimeDeltaHistogram_min */
+    TimeDelta min() const;
+    /** @copydoc TimeDeltaHistogram_max */
+    TimeDelta max() const;
+    /** @copydoc TimeDeltaHistogram_mean */
+    TimeDelta mean() const;
+    /** @copydoc TimeDeltaHistogram_value_at_quantile */
+    TimeDelta value_at_quantile(double quantile) const;
+
+    /** @copydoc TimeDeltaHistogram_serialize */
+    size_t serialize(unsigned char * buffer, size_t buffer_size) const;
+    /** @copydoc TimeDeltaHistogram_deserialize */
+    bool deserialize(const unsigned char * buffer, size_t size);
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize an empty TimeDeltaHistogram, which must be configured (with
+ * TimeDeltaHistogram_configure) before values are recorded.
+ */
+PRESENT_API void
+TimeDeltaHistogram_init(struct TimeDeltaHistogram * const self);
+
+/**
+ * Release the memory held by a TimeDeltaHistogram (which is left empty and
+ * not configured).
+ */
+PRESENT_API void
+TimeDeltaHistogram_destroy(struct TimeDeltaHistogram * const self);
+
+/**
+ * Replace the contents of a TimeDeltaHistogram with an empty histogram.
+ *
+ * @param highest The highest value that must be recorded to within the
+ * precision (at least 1 nanosecond, and at most 200 years).
+ * @param precision The number of bits of precision, from
+ * PRESENT_HISTOGRAM_MIN_PRECISION to PRESENT_HISTOGRAM_MAX_PRECISION. Values
+ * are recorded to within a relative error of 2^-precision.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the histogram is unchanged).
+ */
+PRESENT_API present_bool
+TimeDeltaHistogram_configure(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDelta * const highest,
+        int precision);
+
+/**
+ * Replace the contents of a TimeDeltaHistogram with a copy of another
+ * TimeDeltaHistogram.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the histogram is unchanged).
+ */
+PRESENT_API present_bool
+TimeDeltaHistogram_assign(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDeltaHistogram * const other);
+
+/**
+ * Record a value in a (configured) TimeDeltaHistogram.
+ */
+PRESENT_API void
+TimeDeltaHistogram_record(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDelta * const value);
+
+/**
+ * Record a value @p count times in a (configured) TimeDeltaHistogram.
+ */
+PRESENT_API void
+TimeDeltaHistogram_record_count(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDelta * const value,
+        present_uint64 count);
+
+/**
+ * Add the values recorded in another TimeDeltaHistogram to a (configured)
+ * TimeDeltaHistogram.
+ *
+ * If both histograms have the same precision, this adds their counters
+ * directly. Otherwise, each bucket of @p other is recorded at its midpoint.
+ */
+PRESENT_API void
+TimeDeltaHistogram_merge(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDeltaHistogram * const other);
+
+/**
+ * Remove all the values from a TimeDeltaHistogram (keeping its
+ * configuration).
+ */
+PRESENT_API void
+TimeDeltaHistogram_clear(struct TimeDeltaHistogram * const self);
+
+/**
+ * Get the number of values recorded in a TimeDeltaHistogram.
+ */
+PRESENT_API present_uint64
+TimeDeltaHistogram_count(const struct TimeDeltaHistogram * const self);
+
+/**
+ * Get the smallest value recorded in a TimeDeltaHistogram (exactly, up to
+ * about 292 years), or zero if it is empty.
+ */
+PRESENT_API struct TimeDelta
+TimeDeltaHistogram_min(const struct TimeDeltaHistogram * const self);
+
+/**
+ * Get the largest value recorded in a TimeDeltaHistogram (exactly, up to
+ * about 292 years), or zero if it is empty.
+ */
+PRESENT_API struct TimeDelta
+TimeDeltaHistogram_max(const struct TimeDeltaHistogram * const self);
+
+/**
+ * Get the mean of the values recorded in a TimeDeltaHistogram (to within
+ * the precision of the histogram), or zero if it is empty.
+ */
+PRESENT_API struct TimeDelta
+TimeDeltaHistogram_mean(const struct TimeDeltaHistogram * const self);
+
+/**
+ * Get the value at a quantile of a TimeDeltaHistogram: the smallest value
+ * that at least @p quantile of the recorded values are at or below (to
+ * within the precision of the histogram).
+ *
+ * For example, a @p quantile of 0.99 gives the 99th percentile. A
+ * @p quantile of 0 gives the min, and 1 gives the max.
+ *
+ * @return The value, or zero if the histogram is empty.
+ */
+PRESENT_API struct TimeDelta
+TimeDeltaHistogram_value_at_quantile(
+        const struct TimeDeltaHistogram * const self,
+        double quantile);
+
+/**
+ * Write a compact binary form of a TimeDeltaHistogram to a buffer.
+ *
+ * The counters are written as variable-length integers, with runs of empty
+ * buckets written as a single entry, so a typical histogram takes a few
+ * hundred bytes.
+ *
+ * @param buffer The buffer to write to (may be NULL if @p buffer_size is 0).
+ * @param buffer_size The size of @p buffer.
+ * @return The size of the whole binary form. If this is more than
+ * @p buffer_size, then only the first @p buffer_size bytes were written.
+ */
+PRESENT_API size_t
+TimeDeltaHistogram_serialize(
+        const struct TimeDeltaHistogram * const self,
+        unsigned char * const buffer,
+        size_t buffer_size);
+
+/**
+ * Replace the contents of a TimeDeltaHistogram with a histogram read from
+ * the binary form written by TimeDeltaHistogram_serialize.
+ *
+ * @return 1 on success, or 0 if the binary form is not valid or the memory
+ * could not be allocated (in which case the histogram is unchanged).
+ */
+PRESENT_API present_bool
+TimeDeltaHistogram_deserialize(
+        struct TimeDeltaHistogram * const self,
+        const unsigned char * const buffer,
+        size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_TIME_DELTA_HISTOGRAM_H_ */
+
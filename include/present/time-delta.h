@@ -12,6 +12,7 @@
  * For details, see LICENSE.
  */
 
+#include <stddef.h>
 #include <time.h>
 
 #include "present/internal/cpp-guard.h"
@@ -28,6 +29,7 @@
  */
 
 struct DayDelta;
+struct TimeDeltaSummary;
 
 /*
  * C++ Class / C Struct Definition
@@ -37,195 +39,275 @@ struct DayDelta;
  * Class or struct representing a positive or negative delta of a number of
  * nanoseconds, seconds, minutes, hours, days, or weeks.
  */
-struct PRESENT_API TimeDelta {
+struct PRESENT_CLASS_API TimeDelta {
     /* Internal data representation */
     struct PresentTimeDeltaData data_;
 
 #ifdef __cplusplus
     /** @copydoc TimeDelta_from_nanoseconds */
-    static TimeDelta from_nanoseconds(int_delta nanoseconds);
+    static PRESENT_CONSTEXPR TimeDelta from_nanoseconds(int_delta nanoseconds);
 
     /** @copydoc TimeDelta_from_microseconds */
-    static TimeDelta from_microseconds(int_delta microseconds);
+    static PRESENT_CONSTEXPR TimeDelta from_microseconds(
+            int_delta microseconds);
 
     /** @copydoc TimeDelta_from_milliseconds */
-    static TimeDelta from_milliseconds(int_delta milliseconds);
+    static PRESENT_CONSTEXPR TimeDelta from_milliseconds(
+            int_delta milliseconds);
 
     /** @copydoc TimeDelta_from_seconds */
-    static TimeDelta from_seconds(int_delta seconds);
+    static PRESENT_CONSTEXPR TimeDelta from_seconds(int_delta seconds);
 
     /** @copydoc TimeDelta_from_minutes */
-    static TimeDelta from_minutes(int_delta minutes);
+    static PRESENT_CONSTEXPR TimeDelta from_minutes(int_delta minutes);
 
     /** @copydoc TimeDelta_from_hours */
-    static TimeDelta from_hours(int_delta hours);
+    static PRESENT_CONSTEXPR TimeDelta from_hours(int_delta hours);
 
     /** @copydoc TimeDelta_from_days */
-    static TimeDelta from_days(int_delta days);
+    static PRESENT_CONSTEXPR TimeDelta from_days(int_delta days);
 
     /** @copydoc TimeDelta_from_weeks */
-    static TimeDelta from_weeks(int_delta weeks);
+    static PRESENT_CONSTEXPR TimeDelta from_weeks(int_delta weeks);
 
     /** @copydoc TimeDelta_zero */
-    static TimeDelta zero();
+    static PRESENT_CONSTEXPR TimeDelta zero();
+
+    /** @copydoc TimeDelta_summarize */
+    static TimeDeltaSummary summarize(const TimeDelta * deltas, size_t count);
+
+    /** @copydoc TimeDelta_summarize_nanoseconds */
+    static TimeDeltaSummary summarize_nanoseconds(
+            const int_delta * nanoseconds,
+            size_t count);
+
+#ifdef PRESENT_HAS_CHRONO
+    /**
+     * Create a TimeDelta from a std::chrono::duration (any part smaller than
+     * a nanosecond is truncated).
+     */
+    template <typename Rep, typename Period>
+    static PRESENT_CONSTEXPR TimeDelta from_duration(
+            const std::chrono::duration<Rep, Period> & duration);
+#endif
 
     /** @copydoc TimeDelta_nanoseconds */
-    int_delta nanoseconds() const;
+    PRESENT_CONSTEXPR int_delta nanoseconds() const;
 
     /** @copydoc TimeDelta_microseconds */
-    int_delta microseconds() const;
+    PRESENT_CONSTEXPR int_delta microseconds() const;
     /** @copydoc TimeDelta_microseconds_decimal */
-    double microseconds_decimal() const;
+    PRESENT_CONSTEXPR double microseconds_decimal() const;
 
     /** @copydoc TimeDelta_milliseconds */
-    int_delta milliseconds() const;
+    PRESENT_CONSTEXPR int_delta milliseconds() const;
     /** @copydoc TimeDelta_milliseconds_decimal */
-    double milliseconds_decimal() const;
+    PRESENT_CONSTEXPR double milliseconds_decimal() const;
 
     /** @copydoc TimeDelta_seconds */
-    int_delta seconds() const;
+    PRESENT_CONSTEXPR int_delta seconds() const;
     /** @copydoc TimeDelta_seconds_decimal */
-    double seconds_decimal() const;
+    PRESENT_CONSTEXPR double seconds_decimal() const;
 
     /** @copydoc TimeDelta_minutes */
-    int_delta minutes() const;
+    PRESENT_CONSTEXPR int_delta minutes() const;
     /** @copydoc TimeDelta_minutes_decimal */
-    double minutes_decimal() const;
+    PRESENT_CONSTEXPR double minutes_decimal() const;
 
     /** @copydoc TimeDelta_hours */
-    int_delta hours() const;
+    PRESENT_CONSTEXPR int_delta hours() const;
     /** @copydoc TimeDelta_hours_decimal */
-    double hours_decimal() const;
+    PRESENT_CONSTEXPR double hours_decimal() const;
 
     /** @copydoc TimeDelta_days */
-    int_delta days() const;
+    PRESENT_CONSTEXPR int_delta days() const;
     /** @copydoc TimeDelta_days_decimal */
-    double days_decimal() const;
+    PRESENT_CONSTEXPR double days_decimal() const;
 
     /** @copydoc TimeDelta_weeks */
-    int_delta weeks() const;
+    PRESENT_CONSTEXPR int_delta weeks() const;
     /** @copydoc TimeDelta_weeks_decimal */
-    double weeks_decimal() const;
+    PRESENT_CONSTEXPR double weeks_decimal() const;
 
     /** @copydoc TimeDelta_to_DayDelta_truncated */
-    DayDelta to_DayDelta_truncated() const;
+    PRESENT_CONSTEXPR DayDelta to_DayDelta_truncated() const;
 
     /** @copydoc TimeDelta_to_DayDelta_rounded */
-    DayDelta to_DayDelta_rounded() const;
+    PRESENT_CONSTEXPR DayDelta to_DayDelta_rounded() const;
 
     /** @copydoc TimeDelta_to_DayDelta_abs_ceil */
-    DayDelta to_DayDelta_abs_ceil() const;
+    PRESENT_CONSTEXPR DayDelta to_DayDelta_abs_ceil() const;
+
+#ifdef PRESENT_HAS_CHRONO
+    /**
+     * Convert to a std::chrono::duration (truncated toward zero if Duration
+     * is less precise than a nanosecond, like std::chrono::duration_cast).
+     */
+    template <typename Duration = std::chrono::nanoseconds>
+    PRESENT_CONSTEXPR Duration to_duration() const;
+#endif
 
     /** @copydoc TimeDelta_is_negative */
-    bool is_negative() const;
+    PRESENT_CONSTEXPR bool is_negative() const;
 
     /** @copydoc TimeDelta_negate */
-    void negate();
+    PRESENT_CONSTEXPR void negate();
 
     /**
      * Return the negated version of this TimeDelta.
      * @see TimeDelta::negate
      */
-    TimeDelta operator-() const;
+    PRESENT_CONSTEXPR TimeDelta operator-() const;
 
     /** @copydoc TimeDelta_multiply_by */
-    TimeDelta & operator*=(const long & scale_factor);
+    PRESENT_CONSTEXPR TimeDelta & operator*=(const long & scale_factor);
     /** @copydoc TimeDelta_multiply_by_decimal */
-    TimeDelta & operator*=(const double & scale_factor);
+    PRESENT_CONSTEXPR TimeDelta & operator*=(const double & scale_factor);
     /** @copydoc TimeDelta_divide_by */
-    TimeDelta & operator/=(const long & scale_factor);
+    PRESENT_CONSTEXPR TimeDelta & operator/=(const long & scale_factor);
     /** @copydoc TimeDelta_divide_by_decimal */
-    TimeDelta & operator/=(const double & scale_factor);
+    PRESENT_CONSTEXPR TimeDelta & operator/=(const double & scale_factor);
 
     /** @see TimeDelta::operator*=(const long & scale_factor) */
-    friend const TimeDelta operator*(
+    friend PRESENT_CONSTEXPR const TimeDelta operator*(
             const TimeDelta & delta,
             const long & scale_factor);
     /** @see TimeDelta::operator*=(const double & scale_factor) */
-    friend const TimeDelta operator*(
+    friend PRESENT_CONSTEXPR const TimeDelta operator*(
             const TimeDelta & delta,
             const double & scale_factor);
     /** @see TimeDelta::operator/=(const long & scale_factor) */
-    friend const TimeDelta operator/(
+    friend PRESENT_CONSTEXPR const TimeDelta operator/(
             const TimeDelta & delta,
             const long & scale_factor);
     /** @see TimeDelta::operator/=(const double & scale_factor) */
-    friend const TimeDelta operator/(
+    friend PRESENT_CONSTEXPR const TimeDelta operator/(
             const TimeDelta & delta,
             const double & scale_factor);
 
     /** @copydoc TimeDelta_add */
-    TimeDelta & operator+=(const TimeDelta & other);
+    PRESENT_CONSTEXPR TimeDelta & operator+=(const TimeDelta & other);
     /** @copydoc TimeDelta_add_DayDelta */
-    TimeDelta & operator+=(const DayDelta & other);
+    PRESENT_CONSTEXPR TimeDelta & operator+=(const DayDelta & other);
     /** @copydoc TimeDelta_subtract */
-    TimeDelta & operator-=(const TimeDelta & other);
+    PRESENT_CONSTEXPR TimeDelta & operator-=(const TimeDelta & other);
     /** @copydoc TimeDelta_subtract_DayDelta */
-    TimeDelta & operator-=(const DayDelta & other);
+    PRESENT_CONSTEXPR TimeDelta & operator-=(const DayDelta & other);
 
     /** @see TimeDelta::operator+=(const TimeDelta & other) */
-    friend const TimeDelta operator+(
+    friend PRESENT_CONSTEXPR const TimeDelta operator+(
             const TimeDelta & lhs,
             const TimeDelta & rhs);
     /** @see TimeDelta::operator+=(const DayDelta & other) */
-    friend const TimeDelta operator+(
+    friend PRESENT_CONSTEXPR const TimeDelta operator+(
             const TimeDelta & lhs,
             const DayDelta & rhs);
     /** @see TimeDelta::operator+=(const DayDelta & other) */
-    friend const TimeDelta operator+(
+    friend PRESENT_CONSTEXPR const TimeDelta operator+(
             const DayDelta & lhs,
             const TimeDelta & rhs);
     /** @see TimeDelta::operator-=(const TimeDelta & other) */
-    friend const TimeDelta operator-(
+    friend PRESENT_CONSTEXPR const TimeDelta operator-(
             const TimeDelta & lhs,
             const TimeDelta & rhs);
     /** @see TimeDelta::operator-=(const DayDelta & other) */
-    friend const TimeDelta operator-(
+    friend PRESENT_CONSTEXPR const TimeDelta operator-(
             const TimeDelta & lhs,
             const DayDelta & rhs);
     /** @see TimeDelta::operator-=(const DayDelta & other) */
-    friend const TimeDelta operator-(
+    friend PRESENT_CONSTEXPR const TimeDelta operator-(
             const DayDelta & lhs,
             const TimeDelta & rhs);
 
     /** @copydoc TimeDelta_compare */
-    static short compare(const TimeDelta & lhs, const TimeDelta & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const TimeDelta & lhs,
+            const TimeDelta & rhs);
 
     /** @copydoc TimeDelta_compare_to_DayDelta */
-    static short compare(const TimeDelta & lhs, const DayDelta & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
     /** @see TimeDelta::compare(const TimeDelta & lhs, const DayDelta & rhs) */
-    static short compare(const DayDelta & lhs, const TimeDelta & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const DayDelta & lhs,
+            const TimeDelta & rhs);
 
     /** @copydoc TimeDelta_equal */
-    friend bool operator==(const TimeDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const TimeDelta & lhs,
+            const TimeDelta & rhs);
     /** @copydoc TimeDelta_equal_DayDelta */
-    friend bool operator==(const TimeDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
 
-    friend bool operator!=(const TimeDelta & lhs, const TimeDelta & rhs);
-    friend bool operator!=(const TimeDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const TimeDelta & lhs,
+            const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
 
     /** @copydoc TimeDelta_less_than */
-    friend bool operator<(const TimeDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const TimeDelta & lhs,
+            const TimeDelta & rhs);
     /** @copydoc TimeDelta_less_than_DayDelta */
-    friend bool operator<(const TimeDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
 
     /** @copydoc TimeDelta_less_than_or_equal */
-    friend bool operator<=(const TimeDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const TimeDelta & lhs,
+            const TimeDelta & rhs);
     /** @copydoc TimeDelta_less_than_or_equal_DayDelta */
-    friend bool operator<=(const TimeDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
 
     /** @copydoc TimeDelta_greater_than */
-    friend bool operator>(const TimeDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const TimeDelta & lhs,
+            const TimeDelta & rhs);
     /** @copydoc TimeDelta_greater_than_DayDelta */
-    friend bool operator>(const TimeDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
 
     /** @copydoc TimeDelta_greater_than_or_equal */
-    friend bool operator>=(const TimeDelta & lhs, const TimeDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const TimeDelta & lhs,
+            const TimeDelta & rhs);
     /** @copydoc TimeDelta_greater_than_or_equal_DayDelta */
-    friend bool operator>=(const TimeDelta & lhs, const DayDelta & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const TimeDelta & lhs,
+            const DayDelta & rhs);
 #endif
 };
 
+/**
+ * Struct holding the summary statistics of many TimeDelta values (see
+ * TimeDelta_summarize).
+ */
+struct TimeDeltaSummary {
+    /** The number of values. */
+    size_t count;
+    /** The sum of the values (exact). */
+    struct TimeDelta sum;
+    /** The mean of the values (rounded down to a whole nanosecond). */
+    struct TimeDelta mean;
+    /** The smallest value. */
+    struct TimeDelta min;
+    /** The largest value. */
+    struct TimeDelta max;
+    /** The (population) variance of the values, in nanoseconds squared. */
+    double variance;
+    /** The square root of the variance (rounded to a nanosecond). */
+    struct TimeDelta standard_deviation;
+};
+
 /*
  * C Method Declarations
  */
@@ -677,6 +759,45 @@ TimeDelta_greater_than_or_equal_DayDelta(
         const struct TimeDelta * const lhs,
         const struct DayDelta * const rhs);
 
+/**
+ * Get the sum, mean, variance, min, and max of an array of TimeDelta values.
+ *
+ * This is much faster than adding up the values with TimeDelta_add, which
+ * normalizes the seconds and nanoseconds after every addition. Instead, the
+ * seconds and the nanoseconds are summed separately, in plain loops that
+ * compilers can vectorize, into a 128-bit total that is exact for any
+ * values (the sum itself must still fit in a TimeDelta). The variance is
+ * computed in a second pass, from each value's difference from the exact
+ * mean.
+ *
+ * If @p count is 0, every field of the result is zero.
+ *
+ * @param deltas The values (@p count entries).
+ * @param count The number of values.
+ * @param[out] result A pointer to a struct TimeDeltaSummary for the result.
+ */
+PRESENT_API void
+TimeDelta_summarize(
+        const struct TimeDelta * const deltas,
+        size_t count,
+        struct TimeDeltaSummary * const result);
+
+/**
+ * Get the sum, mean, variance, min, and max of an array of numbers of
+ * nanoseconds (as TimeDelta values).
+ *
+ * @copydetails TimeDelta_summarize
+ *
+ * @param nanoseconds The values, in nanoseconds (@p count entries).
+ * @param count The number of values.
+ * @param[out] result A pointer to a struct TimeDeltaSummary for the result.
+ */
+PRESENT_API void
+TimeDelta_summarize_nanoseconds(
+        const int_delta * const nanoseconds,
+        size_t count,
+        struct TimeDeltaSummary * const result);
+
 #ifdef __cplusplus
 }
 #endif
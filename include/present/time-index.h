@@ -0,0 +1,260 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definition of the TimeIndex structure and declarations of the
+ * corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#ifndef _PRESENT_TIME_INDEX_H_
+#define _PRESENT_TIME_INDEX_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct Timestamp;
+struct TimestampColumn;
+
+/**
+ * The number of timestamps in each node of a TimeIndex.
+ *
+ * The seconds of a node's timestamps fill one cache line (of 64 bytes), and
+ * their nanoseconds fill the next one.
+ */
+#define PRESENT_TIME_INDEX_NODE_SIZE 8
+
+/**
+ * The most levels that a TimeIndex can have. Each level has
+ * (PRESENT_TIME_INDEX_NODE_SIZE + 1) times fewer nodes than the one below it,
+ * so this is enough for any number of timestamps that fits in memory.
+ */
+#define PRESENT_TIME_INDEX_MAX_HEIGHT 24
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct holding a read-only index over a sorted array of
+ * timestamps, for answering range queries ("which timestamps are between t1
+ * and t2") faster than a binary search.
+ *
+ * A binary search over a large array takes a cache miss on almost every
+ * probe, since each one lands far from the last. Instead, a TimeIndex copies
+ * the timestamps into a static B+ tree: the bottom level is the timestamps
+ * themselves, in order, split into nodes of PRESENT_TIME_INDEX_NODE_SIZE, and
+ * each level above holds the first timestamp of each subtree below. The
+ * levels are stored one after another (from the root down) with no pointers,
+ * since the children of node k are always nodes k * (NODE_SIZE + 1) through
+ * k * (NODE_SIZE + 1) + NODE_SIZE of the next level. A lookup reads one node
+ * (two cache lines) per level, and searches each node with a loop without
+ * branches that compilers can vectorize.
+ *
+ * The results are positions in the original array (or column), so they can
+ * be used to look up the matching rows in other arrays.
+ *
+ * In C, a TimeIndex must be initialized with TimeIndex_init, and released
+ * with TimeIndex_destroy. In C++, this is done by the constructor and the
+ * destructor.
+ */
+struct PRESENT_CLASS_API TimeIndex {
+    /*
+     * The nodes of every level, starting with the root. Each node is the
+     * seconds of its PRESENT_TIME_INDEX_NODE_SIZE timestamps, followed by
+     * their nanoseconds.
+     */
+    int_timestamp * nodes_;
+    /* The number of timestamps that the index was built from */
+    size_t size_;
+    /* The number of levels (0 if the index is empty) */
+    size_t height_;
+    /*
+     * The index of the first node of each level in nodes_ (level 0 is the
+     * bottom level)
+     */
+    size_t level_offsets_[PRESENT_TIME_INDEX_MAX_HEIGHT];
+
+#ifdef __cplusplus
+    /** @copydoc TimeIndex_init */
+    TimeIndex();
+    /**
+     * @copydoc TimeIndex_build
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    TimeIndex(const Timestamp * timestamps, size_t count);
+    /**
+     * @copydoc TimeIndex_build_from_column
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    explicit TimeIndex(const TimestampColumn & column);
+    TimeIndex(const TimeIndex & other);
+    TimeIndex & operator=(const TimeIndex & other);
+    /** @copydoc TimeIndex_destroy */
+    ~TimeIndex();
+
+    /** The number of timestamps that the index was built from. */
+    size_t size() const;
+    /** Whether the index has no timestamps. */
+    bool empty() const;
+
+    /**
+     * @copydoc TimeIndex_build
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void build(const Timestamp * timestamps, size_t count);
+    /**
+     * @copydoc TimeIndex_build_from_column
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void build(const TimestampColumn & column);
+
+    /** @copydoc TimeIndex_lower_bound */
+    size_t lower_bound(const Timestamp & value) const;
+    /** @copydoc TimeIndex_upper_bound */
+    size_t upper_bound(const Timestamp & value) const;
+
+    /** @copydoc TimeIndex_count_range */
+    size_t count_range(const Timestamp & low, const Timestamp & high) const;
+    /** @copydoc TimeIndex_find_range */
+    size_t find_range(
+            const Timestamp & low,
+            const Timestamp & high,
+            size_t * first) const;
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize an empty TimeIndex.
+ */
+PRESENT_API void
+TimeIndex_init(struct TimeIndex * const self);
+
+/**
+ * Release the memory held by a TimeIndex (which is left empty).
+ */
+PRESENT_API void
+TimeIndex_destroy(struct TimeIndex * const self);
+
+/**
+ * Replace the contents of a TimeIndex with an index over an array of
+ * timestamps.
+ *
+ * Precondition: The timestamps must be sorted from earliest to latest (for
+ * example, with Timestamp_sort).
+ *
+ * The timestamps are copied into the index, so the array can be changed or
+ * released afterwards (though the positions returned by the index refer to
+ * the array as it was).
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the index is unchanged).
+ */
+PRESENT_API present_bool
+TimeIndex_build(
+        struct TimeIndex * const self,
+        const struct Timestamp * const timestamps,
+        size_t count);
+
+/**
+ * Replace the contents of a TimeIndex with an index over the timestamps in a
+ * TimestampColumn.
+ *
+ * Precondition: The column must be sorted (for example, with
+ * TimestampColumn_sort).
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the index is unchanged).
+ */
+PRESENT_API present_bool
+TimeIndex_build_from_column(
+        struct TimeIndex * const self,
+        const struct TimestampColumn * const column);
+
+/**
+ * Replace the contents of a TimeIndex with a copy of another TimeIndex.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the index is unchanged).
+ */
+PRESENT_API present_bool
+TimeIndex_assign(
+        struct TimeIndex * const self,
+        const struct TimeIndex * const other);
+
+/**
+ * Find the position of the first timestamp that is at or after @p value
+ * (like std::lower_bound).
+ *
+ * @return A position in the array that the index was built from, or the size
+ * of the index if every timestamp is before @p value.
+ */
+PRESENT_API size_t
+TimeIndex_lower_bound(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const value);
+
+/**
+ * Find the position of the first timestamp that is after @p value (like
+ * std::upper_bound).
+ *
+ * @return A position in the array that the index was built from, or the size
+ * of the index if no timestamp is after @p value.
+ */
+PRESENT_API size_t
+TimeIndex_upper_bound(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const value);
+
+/**
+ * Count the timestamps that are at or after @p low, and before @p high.
+ */
+PRESENT_API size_t
+TimeIndex_count_range(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const low,
+        const struct Timestamp * const high);
+
+/**
+ * Find the timestamps that are at or after @p low, and before @p high.
+ *
+ * Since the timestamps are sorted, these are always at consecutive positions
+ * in the array that the index was built from.
+ *
+ * @param[out] first Set to the position of the first matching timestamp (or,
+ * if there are none, to the position where one would be).
+ * @return The number of matching timestamps.
+ */
+PRESENT_API size_t
+TimeIndex_find_range(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const low,
+        const struct Timestamp * const high,
+        size_t * const first);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_TIME_INDEX_H_ */
+
@@ -0,0 +1,326 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definitions of the TimeInterval and TimeIntervalIndex structures and
+ * declarations of the corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/timestamp.h"
+
+#ifndef _PRESENT_TIME_INTERVAL_H_
+#define _PRESENT_TIME_INTERVAL_H_
+
+/*
+ * Forward Declarations
+ */
+
+struct TimeDelta;
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct representing a half-open interval of time: every point in
+ * time that is at or after @p start, and before @p end.
+ *
+ * Since the end is not included, intervals that meet end to start (such as
+ * back-to-back bookings) do not overlap. An interval whose start and end are
+ * the same is empty: it contains no points in time, and overlaps nothing.
+ */
+struct PRESENT_CLASS_API TimeInterval {
+    /** The start of the interval (included). */
+    struct Timestamp start;
+    /** The end of the interval (not included); never before the start. */
+    struct Timestamp end;
+
+#ifdef __cplusplus
+    /** @copydoc TimeInterval_create */
+    static TimeInterval create(const Timestamp & start, const Timestamp & end);
+    /** @copydoc TimeInterval_from_duration */
+    static TimeInterval create(
+            const Timestamp & start,
+            const TimeDelta & duration);
+
+    /** @copydoc TimeInterval_duration */
+    TimeDelta duration() const;
+    /** @copydoc TimeInterval_is_empty */
+    bool empty() const;
+
+    /** @copydoc TimeInterval_contains */
+    bool contains(const Timestamp & timestamp) const;
+    /** @copydoc TimeInterval_contains_interval */
+    bool contains(const TimeInterval & other) const;
+    /** @copydoc TimeInterval_overlaps */
+    bool overlaps(const TimeInterval & other) const;
+    /** @copydoc TimeInterval_intersection */
+    TimeInterval intersection(const TimeInterval & other) const;
+
+    /** @copydoc TimeInterval_equal */
+    friend bool operator==(const TimeInterval & lhs, const TimeInterval & rhs);
+    friend bool operator!=(const TimeInterval & lhs, const TimeInterval & rhs);
+#endif
+};
+
+/**
+ * Class or struct holding a read-only index over an array of TimeIntervals,
+ * for answering stabbing queries ("which intervals contain t") and overlap
+ * queries ("which intervals overlap [t1, t2)") in O(log n + k) time, where k
+ * is the number of matching intervals.
+ *
+ * The index is a centered interval tree, built in one pass over intervals
+ * that are sorted by their start. Each node has a center point, and holds the
+ * intervals that contain it; the intervals that end at or before the center
+ * are in the left subtree, and those that start after it are in the right
+ * subtree. Each node's intervals are stored twice, in contiguous arrays: once
+ * ordered by start, and once ordered by end (latest first). A stabbing query
+ * walks down one path of the tree, and at each node scans just the intervals
+ * that contain the query point from the front of one of those arrays, so
+ * every interval that it reads (other than one per node) is a match.
+ *
+ * The nodes are stored in an array (in depth-first order, so a node's left
+ * child is right after it), and the intervals are stored as separate arrays
+ * of seconds and nanoseconds with no pointers. The results are positions in
+ * the original array, so they can be used to look up the matching rows in
+ * other arrays.
+ *
+ * In C, a TimeIntervalIndex must be initialized with TimeIntervalIndex_init,
+ * and released with TimeIntervalIndex_destroy. In C++, this is done by the
+ * constructor and the destructor.
+ */
+struct PRESENT_CLASS_API TimeIntervalIndex {
+    /* The number of intervals that the index was built from */
+    size_t size_;
+    /* The number of those intervals that are not empty */
+    size_t count_;
+    /* The number of nodes in the tree */
+    size_t node_count_;
+    /*
+     * The timestamps (as seconds, then nanoseconds) of the index: the starts
+     * of the intervals in order, the centers of the nodes, and each node's
+     * starts and ends (see TIME_INTERVAL_* in time-interval.c)
+     */
+    int_timestamp * times_;
+    /*
+     * The positions and links of the index: the positions of the intervals
+     * in order of start, the links of each node, and the positions of each
+     * node's intervals
+     */
+    size_t * links_;
+
+#ifdef __cplusplus
+    /** @copydoc TimeIntervalIndex_init */
+    TimeIntervalIndex();
+    /**
+     * @copydoc TimeIntervalIndex_build
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    TimeIntervalIndex(const TimeInterval * intervals, size_t count);
+    TimeIntervalIndex(const TimeIntervalIndex & other);
+    TimeIntervalIndex & operator=(const TimeIntervalIndex & other);
+    /** @copydoc TimeIntervalIndex_destroy */
+    ~TimeIntervalIndex();
+
+    /** The number of intervals that the index was built from. */
+    size_t size() const;
+    /** Whether the index has no intervals. */
+    bool empty() const;
+
+    /**
+     * @copydoc TimeIntervalIndex_build
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    void build(const TimeInterval * intervals, size_t count);
+
+    /** @copydoc TimeIntervalIndex_find_containing */
+    size_t find_containing(
+            const Timestamp & timestamp,
+            size_t * positions,
+            size_t capacity) const;
+    /** @copydoc TimeIntervalIndex_find_overlapping */
+    size_t find_overlapping(
+            const TimeInterval & interval,
+            size_t * positions,
+            size_t capacity) const;
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a new TimeInterval from its start and its end.
+ *
+ * Precondition: @p end must not be before @p start.
+ */
+PRESENT_API struct TimeInterval
+TimeInterval_create(
+        const struct Timestamp * const start,
+        const struct Timestamp * const end);
+
+/**
+ * Create a new TimeInterval from its start and its (non-negative) duration.
+ */
+PRESENT_API struct TimeInterval
+TimeInterval_from_duration(
+        const struct Timestamp * const start,
+        const struct TimeDelta * const duration);
+
+/**
+ * Get the length of a TimeInterval.
+ */
+PRESENT_API struct TimeDelta
+TimeInterval_duration(const struct TimeInterval * const self);
+
+/**
+ * Check whether a TimeInterval is empty (its start and end are the same).
+ */
+PRESENT_API present_bool
+TimeInterval_is_empty(const struct TimeInterval * const self);
+
+/**
+ * Check whether a Timestamp is in a TimeInterval (at or after its start, and
+ * before its end).
+ */
+PRESENT_API present_bool
+TimeInterval_contains(
+        const struct TimeInterval * const self,
+        const struct Timestamp * const timestamp);
+
+/**
+ * Check whether every point in time in @p other is also in a TimeInterval.
+ */
+PRESENT_API present_bool
+TimeInterval_contains_interval(
+        const struct TimeInterval * const self,
+        const struct TimeInterval * const other);
+
+/**
+ * Check whether two TimeIntervals have any point in time in common.
+ */
+PRESENT_API present_bool
+TimeInterval_overlaps(
+        const struct TimeInterval * const self,
+        const struct TimeInterval * const other);
+
+/**
+ * Get the points in time that are in both of two TimeIntervals.
+ *
+ * @return The intersection, or (if the intervals do not overlap) an empty
+ * interval at the later of their starts.
+ */
+PRESENT_API struct TimeInterval
+TimeInterval_intersection(
+        const struct TimeInterval * const self,
+        const struct TimeInterval * const other);
+
+/**
+ * Check whether two TimeIntervals have the same start and end.
+ */
+PRESENT_API present_bool
+TimeInterval_equal(
+        const struct TimeInterval * const lhs,
+        const struct TimeInterval * const rhs);
+
+/**
+ * Initialize an empty TimeIntervalIndex.
+ */
+PRESENT_API void
+TimeIntervalIndex_init(struct TimeIntervalIndex * const self);
+
+/**
+ * Release the memory held by a TimeIntervalIndex (which is left empty).
+ */
+PRESENT_API void
+TimeIntervalIndex_destroy(struct TimeIntervalIndex * const self);
+
+/**
+ * Replace the contents of a TimeIntervalIndex with an index over an array of
+ * intervals.
+ *
+ * Precondition: The intervals must be sorted by their start (their ends may
+ * be in any order).
+ *
+ * The intervals are copied into the index, so the array can be changed or
+ * released afterwards (though the positions returned by the index refer to
+ * the array as it was).
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the index is unchanged).
+ */
+PRESENT_API present_bool
+TimeIntervalIndex_build(
+        struct TimeIntervalIndex * const self,
+        const struct TimeInterval * const intervals,
+        size_t count);
+
+/**
+ * Replace the contents of a TimeIntervalIndex with a copy of another
+ * TimeIntervalIndex.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the index is unchanged).
+ */
+PRESENT_API present_bool
+TimeIntervalIndex_assign(
+        struct TimeIntervalIndex * const self,
+        const struct TimeIntervalIndex * const other);
+
+/**
+ * Find the intervals that contain a Timestamp.
+ *
+ * The positions of those intervals (in the array that the index was built
+ * from) are written to @p positions, in no particular order.
+ *
+ * @param[out] positions An array with room for @p capacity positions (may be
+ * NULL if @p capacity is 0).
+ * @param capacity The most positions to write. If there are more matching
+ * intervals than this, then only the first @p capacity that are found are
+ * written (so a @p capacity of 0 just counts them).
+ * @return The number of matching intervals (which may be more than
+ * @p capacity).
+ */
+PRESENT_API size_t
+TimeIntervalIndex_find_containing(
+        const struct TimeIntervalIndex * const self,
+        const struct Timestamp * const timestamp,
+        size_t * const positions,
+        size_t capacity);
+
+/**
+ * Find the intervals that overlap a TimeInterval (that have any point in time
+ * in common with it).
+ *
+ * @copydetails TimeIntervalIndex_find_containing
+ */
+PRESENT_API size_t
+TimeIntervalIndex_find_overlapping(
+        const struct TimeIntervalIndex * const self,
+        const struct TimeInterval * const interval,
+        size_t * const positions,
+        size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_TIME_INTERVAL_H_ */
+
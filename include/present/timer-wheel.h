@@ -0,0 +1,464 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Definitions of the TimerWheel, TimerWheelTimer, and TimerWheelGroup
+ * structures and declarations of the corresponding functions
+ *
+ * This file may be included individually ONLY if being used by a C compiler.
+ * However, it is recommended (and required for C++ projects) to include
+ * "present.h" rather than these individual header files.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/cpp-guard.h"
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "present/time-delta.h"
+#include "present/timestamp.h"
+
+#ifndef _PRESENT_TIMER_WHEEL_H_
+#define _PRESENT_TIMER_WHEEL_H_
+
+/** The number of levels of a TimerWheel. */
+#define PRESENT_TIMER_WHEEL_LEVELS      6
+/** The number of bits of a tick that each level of a TimerWheel covers. */
+#define PRESENT_TIMER_WHEEL_LEVEL_BITS  6
+/** The number of slots in each level of a TimerWheel. */
+#define PRESENT_TIMER_WHEEL_SLOTS       (1 << PRESENT_TIMER_WHEEL_LEVEL_BITS)
+
+/*
+ * Forward Declarations
+ */
+
+struct TimerWheel;
+struct TimerWheelShard;
+
+/*
+ * C++ Class / C Struct Definitions
+ */
+
+/**
+ * Class or struct for a timer that can be scheduled on a TimerWheel.
+ *
+ * A TimerWheelTimer is meant to be embedded in the object that it times out
+ * (such as a connection), so that scheduling it never allocates memory. When
+ * it expires, the callback passed to TimerWheel_advance gets a pointer to the
+ * TimerWheelTimer, from which it can find the object that contains it.
+ *
+ * In C, a TimerWheelTimer must be initialized with TimerWheelTimer_init
+ * before it is first scheduled. In C++, this is done by the constructor. A
+ * TimerWheelTimer must not be moved or destroyed while it is scheduled.
+ */
+struct PRESENT_CLASS_API TimerWheelTimer {
+    /* The next timer in the same list */
+    struct TimerWheelTimer * next_;
+    /* The pointer that points to this timer (in the previous timer, or the
+       head of the list) */
+    struct TimerWheelTimer ** pprev_;
+    /* The wheel that the timer is scheduled on (or NULL if it is not) */
+    struct TimerWheel * wheel_;
+    /* The tick that the timer expires at */
+    int_timestamp tick_;
+    /* The list that the timer is in (a slot, or one of the other lists) */
+    int list_;
+
+#ifdef __cplusplus
+    /** @copydoc TimerWheelTimer_init */
+    TimerWheelTimer();
+
+    /** @copydoc TimerWheelTimer_is_scheduled */
+    bool is_scheduled() const;
+#endif
+};
+
+/**
+ * A function that is called for each timer that expires when a TimerWheel
+ * is advanced. It may schedule or cancel any timer (including the one that
+ * expired).
+ *
+ * @param timer The timer that expired (which is no longer scheduled).
+ * @param context The context that was passed to TimerWheel_advance.
+ */
+typedef void (*TimerWheelCallback)(
+        struct TimerWheelTimer * timer,
+        void * context);
+
+/**
+ * Class or struct holding a hierarchical timing wheel: a set of timers that
+ * each expire at a point in time, which are expired in batches as the wheel
+ * is advanced to the current time.
+ *
+ * Time is divided into ticks of a fixed resolution, starting from the time
+ * that the wheel was initialized with. The wheel has 6 levels of 64 slots
+ * each: a timer goes into the slot for its tick in the lowest level whose
+ * slots are each no more than one tick, 64 ticks, 4096 ticks, and so on,
+ * wide, counting from the current tick. When the wheel reaches the start of
+ * a slot above the lowest level, the slot's timers are moved down to the
+ * levels below it, and when it reaches a slot in the lowest level, the
+ * slot's timers expire. Timers beyond the highest level (2^36 ticks) wait
+ * in a separate list, which is moved down once every 2^36 ticks.
+ *
+ * Each slot is a linked list of the TimerWheelTimers that are embedded in
+ * the caller's objects, so scheduling and cancelling a timer take a constant
+ * number of steps and never allocate memory. A bit mask of the slots that
+ * are not empty is kept for each level, so advancing the wheel jumps
+ * straight over the slots (and ticks) that have nothing in them.
+ *
+ * A timer never expires before its deadline, and expires on the first call
+ * to TimerWheel_advance at or after the end of the tick that contains its
+ * deadline (so at most one resolution late).
+ *
+ * A TimerWheel is not thread-safe; see TimerWheelGroup for one wheel per
+ * core (or per thread). In C, a TimerWheel must be initialized with
+ * TimerWheel_init. In C++, this is done by the constructor. A TimerWheel
+ * must not be moved while any timers are scheduled on it.
+ */
+struct PRESENT_CLASS_API TimerWheel {
+    /* The time of the start of tick 0 */
+    struct Timestamp start_;
+    /* The length of a tick, in nanoseconds */
+    int_timestamp resolution_;
+    /* The time that the wheel was last advanced to */
+    struct Timestamp now_;
+    /* The tick that the wheel was last advanced to (every timer up to and
+       including this tick has expired) */
+    int_timestamp tick_;
+    /* The number of scheduled timers */
+    size_t size_;
+    /* The slots of each level that have any timers in them */
+    present_uint64 occupied_[PRESENT_TIMER_WHEEL_LEVELS];
+    /* The timers in each slot of each level */
+    struct TimerWheelTimer *
+        slots_[PRESENT_TIMER_WHEEL_LEVELS][PRESENT_TIMER_WHEEL_SLOTS];
+    /* The timers beyond the highest level */
+    struct TimerWheelTimer * overflow_;
+    /* The timers that were scheduled at or before the current tick (which
+       expire on the next call to TimerWheel_advance) */
+    struct TimerWheelTimer * pending_;
+    /* The timers that have expired but have not been passed to the callback
+       yet (during TimerWheel_advance) */
+    struct TimerWheelTimer * expired_;
+
+#ifdef __cplusplus
+    /** @copydoc TimerWheel_init */
+    TimerWheel(const Timestamp & start, const TimeDelta & resolution);
+
+    /** @copydoc TimerWheel_count */
+    size_t size() const;
+    /** @copydoc TimerWheel_get_now */
+    Timestamp now() const;
+    /** @copydoc TimerWheel_next_event */
+    bool next_event(Timestamp & result) const;
+
+    /** @copydoc TimerWheel_schedule_at */
+    void schedule_at(TimerWheelTimer & timer, const Timestamp & deadline);
+    /** @copydoc TimerWheel_schedule_after */
+    void schedule_after(TimerWheelTimer & timer, const TimeDelta & delay);
+    /** @copydoc TimerWheel_cancel */
+    bool cancel(TimerWheelTimer & timer);
+
+    /** @copydoc TimerWheel_advance */
+    size_t advance(
+            const Timestamp & now,
+            TimerWheelCallback callback,
+            void * context);
+    /**
+     * Advance the wheel to a point in time, calling a function object (with
+     * a TimerWheelTimer *) for each timer that expires.
+     *
+     * @see TimerWheel_advance
+     */
+    template <typename Callback>
+    size_t advance(const Timestamp & now, Callback & callback);
+    /** @copydoc TimerWheel_advance_to_now */
+    size_t advance_to_now(TimerWheelCallback callback, void * context);
+
+private:
+    /* A TimerWheel cannot be copied, since its timers point into it */
+    TimerWheel(const TimerWheel &);
+    TimerWheel & operator=(const TimerWheel &);
+#endif
+};
+
+/**
+ * Class or struct holding a group of TimerWheels (shards) that can be used
+ * from multiple threads at once, such as one for each core.
+ *
+ * Each shard is a TimerWheel with its own lock (if Present was compiled with
+ * pthread support), on its own cache lines, so threads that use different
+ * shards never contend with each other. Typically, each thread (pinned to
+ * its own core) schedules the timers for the objects that it owns on its own
+ * shard, and advances that shard; other threads may still schedule or cancel
+ * timers on it. A timer must always be used with the same shard.
+ *
+ * The callbacks are called without holding the shard's lock, so they may
+ * schedule or cancel timers on any shard.
+ *
+ * In C, a TimerWheelGroup must be initialized with TimerWheelGroup_init,
+ * and released with TimerWheelGroup_destroy. In C++, this is done by the
+ * constructor and the destructor.
+ */
+struct PRESENT_CLASS_API TimerWheelGroup {
+    /* The shards */
+    struct TimerWheelShard * shards_;
+    /* The number of shards */
+    size_t shard_count_;
+
+#ifdef __cplusplus
+    /**
+     * @copydoc TimerWheelGroup_init
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    TimerWheelGroup(
+            size_t shard_count,
+            const Timestamp & start,
+            const TimeDelta & resolution);
+    /** @copydoc TimerWheelGroup_destroy */
+    ~TimerWheelGroup();
+
+    /** @copydoc TimerWheelGroup_shard_count */
+    size_t shard_count() const;
+
+    /** @copydoc TimerWheelGroup_schedule_at */
+    void schedule_at(
+            size_t shard,
+            TimerWheelTimer & timer,
+            const Timestamp & deadline);
+    /** @copydoc TimerWheelGroup_schedule_after */
+    void schedule_after(
+            size_t shard,
+            TimerWheelTimer & timer,
+            const TimeDelta & delay);
+    /** @copydoc TimerWheelGroup_cancel */
+    bool cancel(size_t shard, TimerWheelTimer & timer);
+
+    /** @copydoc TimerWheelGroup_advance */
+    size_t advance(
+            size_t shard,
+            const Timestamp & now,
+            TimerWheelCallback callback,
+            void * context);
+
+private:
+    TimerWheelGroup(const TimerWheelGroup &);
+    TimerWheelGroup & operator=(const TimerWheelGroup &);
+#endif
+};
+
+/*
+ * C Method Declarations
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize a TimerWheelTimer that is not scheduled.
+ */
+PRESENT_API void
+TimerWheelTimer_init(struct TimerWheelTimer * const self);
+
+/**
+ * Determine whether a TimerWheelTimer is scheduled (that is, it has not
+ * expired or been cancelled since it was last scheduled).
+ */
+PRESENT_API present_bool
+TimerWheelTimer_is_scheduled(const struct TimerWheelTimer * const self);
+
+/**
+ * Initialize an empty TimerWheel.
+ *
+ * @param start The time that the wheel starts at (such as Timestamp_now()).
+ * @param resolution The length of a tick (which must be positive), such as
+ * 1 millisecond. The wheel reaches 2^36 ticks ahead (about 2 years, for 1
+ * millisecond) before it needs its overflow list.
+ */
+PRESENT_API void
+TimerWheel_init(
+        struct TimerWheel * const self,
+        const struct Timestamp * const start,
+        const struct TimeDelta * const resolution);
+
+/**
+ * Get the number of timers that are scheduled on a TimerWheel.
+ */
+PRESENT_API size_t
+TimerWheel_count(const struct TimerWheel * const self);
+
+/**
+ * Get the time that a TimerWheel was last advanced to (or the time that it
+ * started at, if it has never been advanced).
+ */
+PRESENT_API struct Timestamp
+TimerWheel_get_now(const struct TimerWheel * const self);
+
+/**
+ * Get the time that a TimerWheel next needs to be advanced to (such as for
+ * how long to sleep). This is the end of the next tick that has any work to
+ * do, which may be moving timers down to a lower level rather than expiring
+ * them, so it is never later than the next timer's expiry.
+ *
+ * @param[out] result The time (if there are any timers).
+ * @return Whether there are any timers scheduled on the wheel.
+ */
+PRESENT_API present_bool
+TimerWheel_next_event(
+        const struct TimerWheel * const self,
+        struct Timestamp * const result);
+
+/**
+ * Schedule a timer to expire at a point in time (cancelling it first, if it
+ * is already scheduled on this wheel). If the deadline is at or before the
+ * current tick, the timer expires on the next call to TimerWheel_advance.
+ *
+ * Deadlines more than about 126 years after the start of the wheel are
+ * treated as 126 years after it.
+ */
+PRESENT_API void
+TimerWheel_schedule_at(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer,
+        const struct Timestamp * const deadline);
+
+/**
+ * Schedule a timer to expire after a delay from the time that a TimerWheel
+ * was last advanced to.
+ *
+ * @see TimerWheel_schedule_at
+ */
+PRESENT_API void
+TimerWheel_schedule_after(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer,
+        const struct TimeDelta * const delay);
+
+/**
+ * Cancel a timer, if it is scheduled on a TimerWheel.
+ *
+ * @return Whether the timer was scheduled on the wheel.
+ */
+PRESENT_API present_bool
+TimerWheel_cancel(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer);
+
+/**
+ * Advance a TimerWheel to a point in time, expiring the timers whose ticks
+ * have ended by then. The callback is called once for each expired timer,
+ * after it has been removed from the wheel: first the timers that were
+ * scheduled at or before the current tick, then the rest in order of their
+ * ticks.
+ *
+ * Timers that are scheduled by the callback at or before the current tick
+ * do not expire until the next call. If @p now is before the time that the
+ * wheel was last advanced to, only those timers expire.
+ *
+ * @return The number of timers that expired.
+ */
+PRESENT_API size_t
+TimerWheel_advance(
+        struct TimerWheel * const self,
+        const struct Timestamp * const now,
+        TimerWheelCallback callback,
+        void * context);
+
+/**
+ * Advance a TimerWheel to the current time (from Timestamp_now).
+ *
+ * @see TimerWheel_advance
+ */
+PRESENT_API size_t
+TimerWheel_advance_to_now(
+        struct TimerWheel * const self,
+        TimerWheelCallback callback,
+        void * context);
+
+/**
+ * Initialize a TimerWheelGroup with a number of empty shards (each like
+ * TimerWheel_init).
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the group has no shards, but may still be destroyed).
+ */
+PRESENT_API present_bool
+TimerWheelGroup_init(
+        struct TimerWheelGroup * const self,
+        size_t shard_count,
+        const struct Timestamp * const start,
+        const struct TimeDelta * const resolution);
+
+/**
+ * Release the memory held by a TimerWheelGroup. Any timers that are still
+ * scheduled on it are simply forgotten.
+ */
+PRESENT_API void
+TimerWheelGroup_destroy(struct TimerWheelGroup * const self);
+
+/**
+ * Get the number of shards of a TimerWheelGroup.
+ */
+PRESENT_API size_t
+TimerWheelGroup_shard_count(const struct TimerWheelGroup * const self);
+
+/**
+ * Schedule a timer on a shard of a TimerWheelGroup.
+ *
+ * @see TimerWheel_schedule_at
+ */
+PRESENT_API void
+TimerWheelGroup_schedule_at(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        struct TimerWheelTimer * const timer,
+        const struct Timestamp * const deadline);
+
+/**
+ * Schedule a timer on a shard of a TimerWheelGroup, after a delay from the
+ * time that the shard was last advanced to.
+ *
+ * @see TimerWheel_schedule_after
+ */
+PRESENT_API void
+TimerWheelGroup_schedule_after(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        struct TimerWheelTimer * const timer,
+        const struct TimeDelta * const delay);
+
+/**
+ * Cancel a timer, if it is scheduled on a shard of a TimerWheelGroup.
+ *
+ * @see TimerWheel_cancel
+ */
+PRESENT_API present_bool
+TimerWheelGroup_cancel(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        struct TimerWheelTimer * const timer);
+
+/**
+ * Advance a shard of a TimerWheelGroup to a point in time. The shard's lock
+ * is not held while the callback is called.
+ *
+ * @see TimerWheel_advance
+ */
+PRESENT_API size_t
+TimerWheelGroup_advance(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        const struct Timestamp * const now,
+        TimerWheelCallback callback,
+        void * context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_TIMER_WHEEL_H_ */
+
@@ -12,6 +12,7 @@
  * For details, see LICENSE.
  */
 
+#include <stddef.h>
 #include <time.h>
 
 #include "present/internal/cpp-guard.h"
@@ -32,6 +33,22 @@ struct Date;
 struct MonthDelta;
 struct TimeDelta;
 
+/*
+ * Units for Timestamp_truncate
+ */
+
+#define PRESENT_TRUNCATE_MICROSECOND    (1)
+#define PRESENT_TRUNCATE_MILLISECOND    (2)
+#define PRESENT_TRUNCATE_SECOND         (3)
+#define PRESENT_TRUNCATE_MINUTE         (4)
+#define PRESENT_TRUNCATE_HOUR           (5)
+#define PRESENT_TRUNCATE_DAY            (6)
+/** ISO 8601 weeks (starting on Monday) */
+#define PRESENT_TRUNCATE_WEEK           (7)
+#define PRESENT_TRUNCATE_MONTH          (8)
+#define PRESENT_TRUNCATE_QUARTER        (9)
+#define PRESENT_TRUNCATE_YEAR           (10)
+
 /*
  * C++ Class / C Struct Definition
  */
@@ -41,7 +58,7 @@ struct TimeDelta;
  *
  * This includes a full date and time, and is sensitive to time zones.
  */
-struct PRESENT_API Timestamp {
+struct PRESENT_CLASS_API Timestamp {
     /**
      * This will be true if there were any errors when creating this Timestamp.
      *
@@ -65,7 +82,18 @@ struct PRESENT_API Timestamp {
 
 #ifdef __cplusplus
     /** @copydoc Timestamp_from_time_t */
-    static Timestamp create(const time_t time);
+    static PRESENT_CONSTEXPR Timestamp create(const time_t time);
+
+#ifdef PRESENT_HAS_CHRONO
+    /**
+     * Create a Timestamp from a std::chrono::system_clock time point (such
+     * as a std::chrono::sys_time), keeping up to nanosecond precision.
+     */
+    template <typename Duration>
+    static PRESENT_CONSTEXPR Timestamp create(
+            const std::chrono::time_point<
+                std::chrono::system_clock, Duration> & time_point);
+#endif
 
     /** @copydoc Timestamp_from_struct_tm */
     static Timestamp create(
@@ -77,12 +105,12 @@ struct PRESENT_API Timestamp {
     static Timestamp create_local(const struct tm & tm);
 
     /** @copydoc Timestamp_create */
-    static Timestamp create(
+    static PRESENT_CONSTEXPR Timestamp create(
         const Date & date,
         const ClockTime & clock_time,
         const TimeDelta & time_zone_offset);
     /** @copydoc Timestamp_create_utc */
-    static Timestamp create_utc(
+    static PRESENT_CONSTEXPR Timestamp create_utc(
             const Date & date,
             const ClockTime & clock_time);
     /** @copydoc Timestamp_create_local */
@@ -94,10 +122,21 @@ struct PRESENT_API Timestamp {
     static Timestamp now();
 
     /** @copydoc Timestamp_epoch */
-    static Timestamp epoch();
+    static PRESENT_CONSTEXPR Timestamp epoch();
 
     /** @copydoc Timestamp_get_time_t */
-    time_t get_time_t() const;
+    PRESENT_CONSTEXPR time_t get_time_t() const;
+
+#ifdef PRESENT_HAS_CHRONO
+    /**
+     * Convert to a std::chrono::system_clock time point (rounded down if
+     * Duration is less precise than a nanosecond).
+     */
+    template <typename Duration = std::chrono::nanoseconds>
+    PRESENT_CONSTEXPR
+    std::chrono::time_point<std::chrono::system_clock, Duration>
+    to_time_point() const;
+#endif
 
     /** @copydoc Timestamp_get_struct_tm */
     struct tm get_struct_tm(const TimeDelta & time_zone_offset) const;
@@ -107,94 +146,144 @@ struct PRESENT_API Timestamp {
     struct tm get_struct_tm_local() const;
 
     /** @copydoc Timestamp_get_date */
-    Date get_date(const TimeDelta & time_zone_offset) const;
+    PRESENT_CONSTEXPR Date get_date(const TimeDelta & time_zone_offset) const;
     /** @copydoc Timestamp_get_date_utc */
-    Date get_date_utc() const;
+    PRESENT_CONSTEXPR Date get_date_utc() const;
     /** @copydoc Timestamp_get_date_local */
     Date get_date_local() const;
 
     /** @copydoc Timestamp_get_clock_time */
-    ClockTime get_clock_time(const TimeDelta & time_zone_offset) const;
+    PRESENT_CONSTEXPR ClockTime get_clock_time(
+            const TimeDelta & time_zone_offset) const;
     /** @copydoc Timestamp_get_clock_time_utc */
-    ClockTime get_clock_time_utc() const;
+    PRESENT_CONSTEXPR ClockTime get_clock_time_utc() const;
     /** @copydoc Timestamp_get_clock_time_local */
     ClockTime get_clock_time_local() const;
 
+    /** @copydoc Timestamp_format */
+    size_t format(
+            const char * format,
+            const TimeDelta & time_zone_offset,
+            char * buffer,
+            size_t buffer_size) const;
+    /** @copydoc Timestamp_format_utc */
+    size_t format_utc(
+            const char * format,
+            char * buffer,
+            size_t buffer_size) const;
+
+    /** @copydoc Timestamp_truncate */
+    Timestamp truncate(
+            int unit,
+            const TimeDelta & time_zone_offset) const;
+    /** @copydoc Timestamp_truncate_utc */
+    Timestamp truncate_utc(int unit) const;
+    /** @copydoc Timestamp_bucket */
+    Timestamp bucket(const TimeDelta & width, const Timestamp & origin) const;
+    /** @copydoc Timestamp_get_windows */
+    size_t get_windows(
+            const TimeDelta & size,
+            const TimeDelta & hop,
+            const Timestamp & origin,
+            int_delta * first,
+            int_delta * last) const;
+
     /** @copydoc Timestamp_difference */
-    TimeDelta difference(const Timestamp & other) const;
+    PRESENT_CONSTEXPR TimeDelta difference(const Timestamp & other) const;
     /** @copydoc Timestamp_absolute_difference */
-    TimeDelta absolute_difference(const Timestamp & other) const;
+    PRESENT_CONSTEXPR TimeDelta absolute_difference(
+            const Timestamp & other) const;
 
     /** @copydoc Timestamp_add_TimeDelta */
-    Timestamp & operator+=(const TimeDelta & delta);
+    PRESENT_CONSTEXPR Timestamp & operator+=(const TimeDelta & delta);
     /** @copydoc Timestamp_add_DayDelta */
-    Timestamp & operator+=(const DayDelta & delta);
+    PRESENT_CONSTEXPR Timestamp & operator+=(const DayDelta & delta);
     /** @copydoc Timestamp_add_MonthDelta */
-    Timestamp & operator+=(const MonthDelta & delta);
+    PRESENT_CONSTEXPR Timestamp & operator+=(const MonthDelta & delta);
     /** @copydoc Timestamp_subtract_TimeDelta */
-    Timestamp & operator-=(const TimeDelta & delta);
+    PRESENT_CONSTEXPR Timestamp & operator-=(const TimeDelta & delta);
     /** @copydoc Timestamp_subtract_DayDelta */
-    Timestamp & operator-=(const DayDelta & delta);
+    PRESENT_CONSTEXPR Timestamp & operator-=(const DayDelta & delta);
     /** @copydoc Timestamp_subtract_MonthDelta */
-    Timestamp & operator-=(const MonthDelta & delta);
+    PRESENT_CONSTEXPR Timestamp & operator-=(const MonthDelta & delta);
 
     /** @see Timestamp::operator+=(const TimeDelta & delta) */
-    friend const Timestamp operator+(
+    friend PRESENT_CONSTEXPR const Timestamp operator+(
             const Timestamp & lhs,
             const TimeDelta & rhs);
     /** @see Timestamp::operator+=(const TimeDelta & delta) */
-    friend const Timestamp operator+(
+    friend PRESENT_CONSTEXPR const Timestamp operator+(
             const TimeDelta & lhs,
             const Timestamp & rhs);
 
     /** @see Timestamp::operator+=(const DayDelta & delta) */
-    friend const Timestamp operator+(
+    friend PRESENT_CONSTEXPR const Timestamp operator+(
             const Timestamp & lhs,
             const DayDelta & rhs);
     /** @see Timestamp::operator+=(const DayDelta & delta) */
-    friend const Timestamp operator+(
+    friend PRESENT_CONSTEXPR const Timestamp operator+(
             const DayDelta & lhs,
             const Timestamp & rhs);
 
     /** @see Timestamp::operator+=(const MonthDelta & delta) */
-    friend const Timestamp operator+(
+    friend PRESENT_CONSTEXPR const Timestamp operator+(
             const Timestamp & lhs,
             const MonthDelta & rhs);
     /** @see Timestamp::operator+=(const MonthDelta & delta) */
-    friend const Timestamp operator+(
+    friend PRESENT_CONSTEXPR const Timestamp operator+(
             const MonthDelta & lhs,
             const Timestamp & rhs);
 
     /** @see Timestamp::operator-=(const TimeDelta & delta) */
-    friend const Timestamp operator-(
+    friend PRESENT_CONSTEXPR const Timestamp operator-(
             const Timestamp & lhs,
             const TimeDelta & rhs);
 
     /** @see Timestamp::operator-=(const DayDelta & delta) */
-    friend const Timestamp operator-(
+    friend PRESENT_CONSTEXPR const Timestamp operator-(
             const Timestamp & lhs,
             const DayDelta & rhs);
 
     /** @see Timestamp::operator-=(const MonthDelta & delta) */
-    friend const Timestamp operator-(
+    friend PRESENT_CONSTEXPR const Timestamp operator-(
             const Timestamp & lhs,
             const MonthDelta & rhs);
 
     /** @copydoc Timestamp_compare */
-    static short compare(const Timestamp & lhs, const Timestamp & rhs);
+    static PRESENT_CONSTEXPR short compare(
+            const Timestamp & lhs,
+            const Timestamp & rhs);
+
+    /**
+     * @copydoc Timestamp_sort
+     * @throws std::bad_alloc if the memory could not be allocated.
+     */
+    static void sort(Timestamp * timestamps, size_t count);
 
     /** @copydoc Timestamp_equal */
-    friend bool operator==(const Timestamp & lhs, const Timestamp & rhs);
-    friend bool operator!=(const Timestamp & lhs, const Timestamp & rhs);
+    friend PRESENT_CONSTEXPR bool operator==(
+            const Timestamp & lhs,
+            const Timestamp & rhs);
+    friend PRESENT_CONSTEXPR bool operator!=(
+            const Timestamp & lhs,
+            const Timestamp & rhs);
 
     /** @copydoc Timestamp_less_than */
-    friend bool operator<(const Timestamp & lhs, const Timestamp & rhs);
+    friend PRESENT_CONSTEXPR bool operator<(
+            const Timestamp & lhs,
+            const Timestamp & rhs);
     /** @copydoc Timestamp_less_than_or_equal */
-    friend bool operator<=(const Timestamp & lhs, const Timestamp & rhs);
+    friend PRESENT_CONSTEXPR bool operator<=(
+            const Timestamp & lhs,
+            const Timestamp & rhs);
     /** @copydoc Timestamp_greater_than */
-    friend bool operator>(const Timestamp & lhs, const Timestamp & rhs);
+    friend PRESENT_CONSTEXPR bool operator>(
+            const Timestamp & lhs,
+            const Timestamp & rhs);
     /** @copydoc Timestamp_greater_than_or_equal */
-    friend bool operator>=(const Timestamp & lhs, const Timestamp & rhs);
+    friend PRESENT_CONSTEXPR bool operator>=(
+            const Timestamp & lhs,
+            const Timestamp & rhs);
 #endif
 };
 
@@ -506,6 +595,120 @@ Timestamp_get_clock_time_utc(const struct Timestamp * const self);
 PRESENT_API struct ClockTime
 Timestamp_get_clock_time_local(const struct Timestamp * const self);
 
+/**
+ * Format a Timestamp as text, according to a strftime-like format string,
+ * in the time zone with the provided offset from UTC.
+ *
+ * All the conversions supported by Date_format and ClockTime_format are
+ * supported, plus:
+ *
+ * - *\%s*: the UNIX timestamp (seconds since the epoch)
+ * - *\%z*: the time zone offset ("+hhmm" or "-hhmm")
+ *
+ * @param format The format string.
+ * @param time_zone_offset The offset of the time zone from UTC.
+ * @param buffer The buffer to write the NUL-terminated result to.
+ * @param buffer_size The size of buffer (including room for the NUL).
+ * @return The number of characters written (not including the NUL), or 0 if
+ *         the format string is invalid or the result does not fit in the
+ *         buffer (like strftime).
+ */
+PRESENT_API size_t
+Timestamp_format(
+        const struct Timestamp * const self,
+        const char * const format,
+        const struct TimeDelta * const time_zone_offset,
+        char * const buffer,
+        size_t buffer_size);
+
+/**
+ * Format a Timestamp as text, according to a strftime-like format string,
+ * in UTC.
+ *
+ * @see Timestamp_format
+ */
+PRESENT_API size_t
+Timestamp_format_utc(
+        const struct Timestamp * const self,
+        const char * const format,
+        char * const buffer,
+        size_t buffer_size);
+
+/**
+ * Get the start of the calendar unit (such as the hour, the day, the ISO week,
+ * or the month) that a Timestamp is in, in a certain time zone (represented
+ * by an offset from UTC). This is like "date_trunc" in SQL.
+ *
+ * For example, truncating 2024-05-17 13:45:10 UTC to PRESENT_TRUNCATE_MONTH
+ * with an offset of +2 hours gives 2024-05-01 00:00 (in that time zone),
+ * which is 2024-04-30 22:00 UTC.
+ *
+ * The units up to PRESENT_TRUNCATE_WEEK all have a fixed length, so they are
+ * the same as Timestamp_bucket with that width (and an origin at midnight on
+ * a Monday in the time zone).
+ *
+ * @param unit One of the PRESENT_TRUNCATE_* constants.
+ */
+PRESENT_API struct Timestamp
+Timestamp_truncate(
+        const struct Timestamp * const self,
+        int unit,
+        const struct TimeDelta * const time_zone_offset);
+
+/**
+ * Get the start of the calendar unit that a Timestamp is in, in Coordinated
+ * Universal Time.
+ *
+ * @see Timestamp_truncate
+ */
+PRESENT_API struct Timestamp
+Timestamp_truncate_utc(const struct Timestamp * const self, int unit);
+
+/**
+ * Get the start of the fixed-width bucket that a Timestamp is in, where the
+ * buckets are [origin + k * width, origin + (k + 1) * width) for every
+ * integer k.
+ *
+ * For example, with a width of 15 minutes and an origin of the UNIX epoch,
+ * 13:52:10 is in the bucket that starts at 13:45:00. The width can be any
+ * positive TimeDelta, including ones that do not divide a day evenly (such
+ * as 7 minutes, or 1.5 seconds).
+ *
+ * Precondition: @p width must be positive.
+ */
+PRESENT_API struct Timestamp
+Timestamp_bucket(
+        const struct Timestamp * const self,
+        const struct TimeDelta * const width,
+        const struct Timestamp * const origin);
+
+/**
+ * Find the hopping (or sliding) windows that a Timestamp is in.
+ *
+ * Window k covers [origin + k * hop, origin + k * hop + size) for every
+ * integer k, so a new window of length @p size starts every @p hop. If
+ * @p size is a multiple of @p hop, each timestamp is in size / hop windows;
+ * if @p hop is the same as @p size, the windows are the same as the buckets
+ * of Timestamp_bucket.
+ *
+ * Preconditions: @p size and @p hop must be positive.
+ *
+ * @param[out] first Set to the number of the first window that the
+ * timestamp is in.
+ * @param[out] last Set to the number of the last window that the timestamp
+ * is in (the timestamp is in every window from @p first to @p last).
+ * @return The number of windows that the timestamp is in (which can be 0,
+ * if @p hop is longer than @p size).
+ */
+PRESENT_API size_t
+Timestamp_get_windows(
+        const struct Timestamp * const self,
+        const struct TimeDelta * const size,
+        const struct TimeDelta * const hop,
+        const struct Timestamp * const origin,
+        int_delta * const first,
+        int_delta * const last);
+
 
 /**
  * Get the difference between two Timestamp instances as a @ref TimeDelta.
@@ -630,6 +833,27 @@ Timestamp_greater_than_or_equal(
         const struct Timestamp * const lhs,
         const struct Timestamp * const rhs);
 
+/**
+ * Sort an array of Timestamps, from earliest to latest.
+ *
+ * This is a radix sort on a 94-bit key (the seconds, followed by the 30 bits
+ * of the nanoseconds), which takes a constant number of passes over the
+ * array (the digits of the key that are the same for every Timestamp are
+ * skipped) rather than O(n log n) comparisons.
+ *
+ * For large numbers of timestamps, a TimestampColumn is more compact, and
+ * can be sorted in parallel (see TimestampColumn_sort_parallel).
+ *
+ * Precondition: None of the Timestamps may have @p has_error set.
+ *
+ * @param timestamps The Timestamps to sort (@p count entries).
+ * @param count The number of Timestamps.
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the array is unchanged).
+ */
+PRESENT_API present_bool
+Timestamp_sort(struct Timestamp * const timestamps, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,356 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the BusinessCalendar methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "present.h"
+
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/memory-utils.h"
+#include "utils/time-utils.h"
+
+/** The alignment (in bytes) of the arrays of a BusinessCalendar. */
+#define BUSINESS_CALENDAR_ALIGNMENT     64
+
+/**
+ * Get the position of a date in the range of a BusinessCalendar (in days
+ * since the first day of the range).
+ *
+ * @param allow_end Whether the date may be the end of the range (rather than
+ * a date in it).
+ * @return 1 if the date is in the range, or 0 if it is not (or has an error).
+ */
+static present_bool
+business_calendar_offset(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date,
+        present_bool allow_end,
+        size_t * const offset)
+{
+    int_delta days;
+
+    assert(date != NULL);
+    assert(date->has_error == 0);
+
+    if (date->has_error) {
+        return 0;
+    }
+    days = DATE_TO_DAYS(date) - self->first_day_;
+    if (days < 0 || (size_t)days > self->day_count_ ||
+            ((size_t)days == self->day_count_ && !allow_end)) {
+        return 0;
+    }
+    *offset = (size_t)days;
+    return 1;
+}
+
+/**
+ * Get the position of a date in the range of a BusinessCalendar, or of the
+ * first day or the end of the range if the date is before or after it.
+ */
+static size_t
+business_calendar_clamped_offset(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date)
+{
+    size_t offset;
+
+    if (business_calendar_offset(self, date, 1, &offset)) {
+        return offset;
+    }
+    return DATE_TO_DAYS(date) < self->first_day_ ? 0 : self->day_count_;
+}
+
+/**
+ * Get the Date for a date that is outside the range of a BusinessCalendar
+ * (with has_error and errors.day_out_of_range set).
+ */
+static struct Date
+business_calendar_out_of_range(void)
+{
+    struct Date result;
+
+    CLEAR(&result);
+    result.has_error = 1;
+    result.errors.day_out_of_range = 1;
+    return result;
+}
+
+/**
+ * Get the date of business day number @p index of a BusinessCalendar, or an
+ * error if there is no such business day in its range.
+ */
+static struct Date
+business_calendar_business_day(
+        const struct BusinessCalendar * const self,
+        int_delta index)
+{
+    if (index < 0 || (size_t)index >= self->business_day_count_) {
+        return business_calendar_out_of_range();
+    }
+    return present_days_to_date(
+            self->first_day_ + self->business_days_[index]);
+}
+
+void
+BusinessCalendar_init(struct BusinessCalendar * const self)
+{
+    assert(self != NULL);
+
+    self->first_day_ = 0;
+    self->day_count_ = 0;
+    self->counts_ = NULL;
+    self->business_days_ = NULL;
+    self->business_day_count_ = 0;
+}
+
+void
+BusinessCalendar_destroy(struct BusinessCalendar * const self)
+{
+    assert(self != NULL);
+
+    present_aligned_free(self->counts_);
+    BusinessCalendar_init(self);
+}
+
+present_bool
+BusinessCalendar_build(
+        struct BusinessCalendar * const self,
+        const struct Date * const first,
+        const struct Date * const end,
+        unsigned int weekend_mask,
+        const struct Date * const holidays,
+        size_t holiday_count)
+{
+    int_delta first_day, day, holiday, business_count, is_business;
+    int_delta * block;
+    int_delta * business_days;
+    size_t day_count, i;
+
+    assert(self != NULL);
+    assert(first != NULL);
+    assert(first->has_error == 0);
+    assert(end != NULL);
+    assert(end->has_error == 0);
+    assert(holidays != NULL || holiday_count == 0);
+
+    first_day = DATE_TO_DAYS(first);
+    assert(DATE_TO_DAYS(end) >= first_day);
+    day_count = (size_t)(DATE_TO_DAYS(end) - first_day);
+
+    /* The counts (day_count + 1 entries), then the business days (at most
+       day_count entries) */
+    if (day_count > ((size_t)-1 / sizeof(int_delta) - 1) / 2) {
+        return 0;
+    }
+    block = (int_delta *) present_aligned_alloc(
+            (2 * day_count + 1) * sizeof(int_delta),
+            BUSINESS_CALENDAR_ALIGNMENT);
+    if (block == NULL) {
+        return 0;
+    }
+    business_days = block + day_count + 1;
+
+    /* Mark each day that is not on the weekend (1970-01-01 was a Thursday,
+       so day 0 is day 4 of the week) */
+    for (i = 0; i < day_count; i++) {
+        day = (first_day + (int_delta)i) % DAYS_IN_WEEK;
+        day = (day + DAYS_IN_WEEK + 3) % DAYS_IN_WEEK;
+        block[i] = ((weekend_mask >> day) & 1) == 0;
+    }
+    for (i = 0; i < holiday_count; i++) {
+        assert(holidays[i].has_error == 0);
+        holiday = DATE_TO_DAYS(&holidays[i]) - first_day;
+        if (holiday >= 0 && (size_t)holiday < day_count) {
+            block[holiday] = 0;
+        }
+    }
+
+    /* Turn the marks into the number of business days before each day, and
+       list the business days */
+    business_count = 0;
+    for (i = 0; i < day_count; i++) {
+        is_business = block[i];
+        block[i] = business_count;
+        business_days[business_count] = (int_delta)i;
+        business_count += is_business;
+    }
+    block[day_count] = business_count;
+
+    present_aligned_free(self->counts_);
+    self->first_day_ = first_day;
+    self->day_count_ = day_count;
+    self->counts_ = block;
+    self->business_days_ = business_days;
+    self->business_day_count_ = (size_t)business_count;
+    return 1;
+}
+
+present_bool
+BusinessCalendar_assign(
+        struct BusinessCalendar * const self,
+        const struct BusinessCalendar * const other)
+{
+    int_delta * block = NULL;
+
+    assert(self != NULL);
+    assert(other != NULL);
+
+    if (self == other) {
+        return 1;
+    }
+    if (other->counts_ != NULL) {
+        block = (int_delta *) present_aligned_alloc(
+                (2 * other->day_count_ + 1) * sizeof(int_delta),
+                BUSINESS_CALENDAR_ALIGNMENT);
+        if (block == NULL) {
+            return 0;
+        }
+        memcpy(block, other->counts_,
+                (other->day_count_ + 1 + other->business_day_count_) *
+                sizeof(int_delta));
+    }
+
+    present_aligned_free(self->counts_);
+    self->first_day_ = other->first_day_;
+    self->day_count_ = other->day_count_;
+    self->counts_ = block;
+    self->business_days_ = block != NULL ? block + other->day_count_ + 1 :
+        NULL;
+    self->business_day_count_ = other->business_day_count_;
+    return 1;
+}
+
+struct Date
+BusinessCalendar_first(const struct BusinessCalendar * const self)
+{
+    assert(self != NULL);
+
+    return present_days_to_date(self->first_day_);
+}
+
+struct Date
+BusinessCalendar_end(const struct BusinessCalendar * const self)
+{
+    assert(self != NULL);
+
+    return present_days_to_date(
+            self->first_day_ + (int_delta)self->day_count_);
+}
+
+present_bool
+BusinessCalendar_is_business_day(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date)
+{
+    size_t offset;
+
+    assert(self != NULL);
+
+    if (!business_calendar_offset(self, date, 0, &offset)) {
+        return 0;
+    }
+    return self->counts_[offset + 1] != self->counts_[offset];
+}
+
+int_delta
+BusinessCalendar_business_days_between(
+        const struct BusinessCalendar * const self,
+        const struct Date * const first,
+        const struct Date * const end)
+{
+    assert(self != NULL);
+    assert(first != NULL);
+    assert(first->has_error == 0);
+    assert(end != NULL);
+    assert(end->has_error == 0);
+
+    return self->counts_[business_calendar_clamped_offset(self, end)] -
+        self->counts_[business_calendar_clamped_offset(self, first)];
+}
+
+struct Date
+BusinessCalendar_add_business_days(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date,
+        int_delta count)
+{
+    int_delta business_day_count;
+    size_t offset;
+
+    assert(self != NULL);
+
+    if (!business_calendar_offset(self, date, 0, &offset)) {
+        return business_calendar_out_of_range();
+    }
+    /* (Checked first, so that a huge count cannot overflow the index) */
+    business_day_count = (int_delta)self->business_day_count_;
+    if (count > business_day_count || count < -business_day_count) {
+        return business_calendar_out_of_range();
+    }
+    if (count > 0) {
+        /* counts_[offset + 1] is the number of the first business day after
+           the date */
+        return business_calendar_business_day(self,
+                self->counts_[offset + 1] + count - 1);
+    } else if (count < 0) {
+        /* counts_[offset] - 1 is the number of the last business day before
+           the date */
+        return business_calendar_business_day(self,
+                self->counts_[offset] + count);
+    }
+    return *date;
+}
+
+struct Date
+BusinessCalendar_adjust(
+        const struct BusinessCalendar * const self,
+        const struct Date * const date,
+        int rule)
+{
+    struct Date result;
+    size_t offset;
+    int_delta following;
+
+    assert(self != NULL);
+    assert(rule >= PRESENT_ADJUST_UNADJUSTED &&
+            rule <= PRESENT_ADJUST_MODIFIED_PRECEDING);
+
+    if (!business_calendar_offset(self, date, 0, &offset)) {
+        return business_calendar_out_of_range();
+    }
+    if (rule == PRESENT_ADJUST_UNADJUSTED ||
+            self->counts_[offset + 1] != self->counts_[offset]) {
+        return *date;
+    }
+
+    /* Since the date is not a business day, the business day numbered
+       counts_[offset] is the next one, and the one before it is the previous
+       one */
+    following = self->counts_[offset];
+    if (rule == PRESENT_ADJUST_FOLLOWING ||
+            rule == PRESENT_ADJUST_MODIFIED_FOLLOWING) {
+        result = business_calendar_business_day(self, following);
+        if (rule == PRESENT_ADJUST_MODIFIED_FOLLOWING && !result.has_error &&
+                result.data_.month != date->data_.month) {
+            result = business_calendar_business_day(self, following - 1);
+        }
+    } else {
+        result = business_calendar_business_day(self, following - 1);
+        if (rule == PRESENT_ADJUST_MODIFIED_PRECEDING && !result.has_error &&
+                result.data_.month != date->data_.month) {
+            result = business_calendar_business_day(self, following);
+        }
+    }
+    return result;
+}
+
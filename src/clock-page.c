@@ -0,0 +1,721 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the ClockPage methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "present-config.h"
+#include "present.h"
+
+#if defined(_POSIX_SHARED_MEMORY_OBJECTS) && defined(_POSIX_TIMERS) && \
+    !defined(__STRICT_ANSI__) && defined(PRESENT_USE_PTHREAD) && \
+    defined(__ATOMIC_ACQUIRE)
+# define CLOCK_PAGE_SUPPORTED
+#endif
+
+#ifdef CLOCK_PAGE_SUPPORTED
+# include <fcntl.h>
+# include <pthread.h>
+# include <sys/file.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/types.h>
+#endif
+
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/time-utils.h"
+
+#ifdef CLOCK_PAGE_SUPPORTED
+
+/** Marks shared memory that holds a ClockPage ("ClkP"). */
+#define PAGE_MAGIC  0x436C6B50UL
+
+#define LOAD_ACQUIRE(ptr)           __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(ptr)           __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define STORE_RELEASE(ptr, value)   \
+    __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define STORE_RELAXED(ptr, value)   \
+    __atomic_store_n((ptr), (value), __ATOMIC_RELAXED)
+
+/* The clock for the heartbeat (which, unlike CLOCK_REALTIME, is the same for
+   every process on the system, and never jumps) */
+#ifdef CLOCK_MONOTONIC
+# define PAGE_HEARTBEAT_CLOCK   CLOCK_MONOTONIC
+#else
+# define PAGE_HEARTBEAT_CLOCK   CLOCK_REALTIME
+#endif
+
+/* The clock for the publisher's timed wait (which is only CLOCK_REALTIME if
+   the condition variable's clock cannot be selected) */
+#if defined(_POSIX_CLOCK_SELECTION) && _POSIX_CLOCK_SELECTION > 0 && \
+    defined(CLOCK_MONOTONIC)
+# define PAGE_WAIT_CLOCK    CLOCK_MONOTONIC
+# define PAGE_WAIT_CLOCK_SELECTED
+#else
+# define PAGE_WAIT_CLOCK    CLOCK_REALTIME
+#endif
+
+/**
+ * How many intervals a page's heartbeat may be behind before
+ * ClockPage_publish considers the publisher that left it to be dead (but at
+ * least PAGE_STALE_MIN_NANOSECONDS).
+ */
+#define PAGE_STALE_INTERVALS        10
+#define PAGE_STALE_MIN_NANOSECONDS  NANOSECONDS_IN_SECOND
+
+/** How many times ClockPage_publish tries to replace stale shared memory. */
+#define PAGE_CREATE_ATTEMPTS    3
+
+/**
+ * The contents of a ClockPage's shared memory. Everything that a read
+ * touches is in the first 32 bytes (so in one cache line).
+ */
+struct ClockPageData {
+    /* Odd while the time is being written */
+    present_uint64 sequence;
+    /* The last time that was written */
+    present_int64 seconds;
+    present_int64 nanoseconds;
+    /* How often the time is written */
+    present_int64 interval_nanoseconds;
+    /* PAGE_MAGIC, once the first time has been written */
+    present_uint64 magic;
+    /* 1 until the publisher closes the ClockPage */
+    present_uint64 publishing;
+    /* When the time was last written, in nanoseconds of
+       PAGE_HEARTBEAT_CLOCK (which keeps a publisher that was killed, and so
+       left "publishing" set, from looking alive) */
+    present_int64 written_at;
+};
+
+struct ClockPagePublisher {
+    pthread_t thread;
+    /* Held by the thread (other than while it waits for the next interval),
+       and by ClockPage_close to tell it to stop */
+    pthread_mutex_t lock;
+    pthread_cond_t stop_condition;
+    present_bool stopping;
+    /* The process that published the ClockPage (which is the only one that
+       has the thread, if it forks) */
+    pid_t pid;
+    struct timespec interval;
+    /* A copy of the name of the shared memory (or NULL if it has none) */
+    char * name;
+    struct ClockPageData * page;
+};
+
+#define PAGE_DATA(self) ((struct ClockPageData *) (self)->page_)
+
+/** Read PAGE_HEARTBEAT_CLOCK, in nanoseconds. */
+static present_int64
+page_heartbeat_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(PAGE_HEARTBEAT_CLOCK, &now);
+    return (present_int64) now.tv_sec * NANOSECONDS_IN_SECOND +
+        (present_int64) now.tv_nsec;
+}
+
+/** Get how long ago the time was last written to a ClockPage. */
+static present_int64
+page_age_nanoseconds(const struct ClockPageData * const page)
+{
+    /* (Loaded before the clock is read, so the age is never negative) */
+    const present_int64 written_at = LOAD_ACQUIRE(&page->written_at);
+    return page_heartbeat_now() - written_at;
+}
+
+/**
+ * Write the time to a ClockPage's shared memory.
+ *
+ * This reads CLOCK_REALTIME itself, rather than calling Timestamp_now(), in
+ * case the selected clock source is a callback that reads this ClockPage.
+ */
+static void
+page_write(struct ClockPageData * const page)
+{
+    struct Timestamp now;
+    present_uint64 sequence;
+
+    present_clock_realtime(&now);
+    sequence = LOAD_RELAXED(&page->sequence);
+
+    STORE_RELAXED(&page->sequence, sequence + 1);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    STORE_RELAXED(&page->seconds, now.data_.timestamp_seconds);
+    STORE_RELAXED(&page->nanoseconds, now.data_.additional_nanoseconds);
+    STORE_RELEASE(&page->sequence, sequence + 2);
+    STORE_RELEASE(&page->written_at, page_heartbeat_now());
+}
+
+/** The publisher's thread: write the time every interval, until stopped. */
+static void *
+page_publish_loop(void * argument)
+{
+    struct ClockPagePublisher * const publisher =
+        (struct ClockPagePublisher *) argument;
+    struct timespec deadline;
+
+    pthread_mutex_lock(&publisher->lock);
+    while (!publisher->stopping) {
+        page_write(publisher->page);
+
+        clock_gettime(PAGE_WAIT_CLOCK, &deadline);
+        deadline.tv_sec += publisher->interval.tv_sec;
+        deadline.tv_nsec += publisher->interval.tv_nsec;
+        if (deadline.tv_nsec >= NANOSECONDS_IN_SECOND) {
+            deadline.tv_nsec -= NANOSECONDS_IN_SECOND;
+            ++deadline.tv_sec;
+        }
+        /* A spurious wakeup only writes the time early */
+        pthread_cond_timedwait(&publisher->stop_condition, &publisher->lock,
+                &deadline);
+    }
+    pthread_mutex_unlock(&publisher->lock);
+    return NULL;
+}
+
+/**
+ * Create shared memory for a ClockPage, without a name.
+ *
+ * @return The file descriptor, or -1 if memfd_create is not supported.
+ */
+static int
+page_create_unnamed(void)
+{
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    return memfd_create("present-clock-page", MFD_CLOEXEC);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Initialize the condition variable that the publisher's thread waits on,
+ * with PAGE_WAIT_CLOCK (so that the interval does not stretch or shrink when
+ * the system time is changed).
+ *
+ * @return 0 on success, or an error number.
+ */
+static int
+page_init_condition(pthread_cond_t * const condition)
+{
+#ifdef PAGE_WAIT_CLOCK_SELECTED
+    pthread_condattr_t attributes;
+    int error;
+
+    error = pthread_condattr_init(&attributes);
+    if (error != 0) {
+        return error;
+    }
+    error = pthread_condattr_setclock(&attributes, PAGE_WAIT_CLOCK);
+    if (error == 0) {
+        error = pthread_cond_init(condition, &attributes);
+    }
+    pthread_condattr_destroy(&attributes);
+    return error;
+#else
+    return pthread_cond_init(condition, NULL);
+#endif
+}
+
+/**
+ * Determine whether shared memory is a ClockPage that a publisher is still
+ * writing to (that is, one that has not been closed, and whose heartbeat is
+ * no more than PAGE_STALE_INTERVALS intervals old), or is about to be (it is
+ * not a ClockPage yet, but was only just created).
+ */
+static present_bool
+page_is_live(int fd)
+{
+    struct ClockPage existing;
+    const struct ClockPageData * page;
+    struct stat info;
+    present_int64 stale_nanoseconds;
+    present_bool live;
+    int copy;
+
+    ClockPage_init(&existing);
+    copy = dup(fd);
+    if (copy >= 0 && ClockPage_open_fd(&existing, copy)) {
+        page = PAGE_DATA(&existing);
+        stale_nanoseconds = page->interval_nanoseconds * PAGE_STALE_INTERVALS;
+        if (stale_nanoseconds < PAGE_STALE_MIN_NANOSECONDS) {
+            stale_nanoseconds = PAGE_STALE_MIN_NANOSECONDS;
+        }
+        live = LOAD_ACQUIRE(&page->publishing) != 0 &&
+            page_age_nanoseconds(page) <= stale_nanoseconds;
+    } else {
+        /* (A publisher writes the first time right after it creates the
+           shared memory) */
+        live = fstat(fd, &info) == 0 && time(NULL) - info.st_mtime <=
+            PAGE_STALE_MIN_NANOSECONDS / NANOSECONDS_IN_SECOND;
+    }
+    ClockPage_close(&existing);
+    return live;
+}
+
+/**
+ * Determine whether a name still refers to the shared memory that a file
+ * descriptor is open on (rather than having been removed, or replaced).
+ */
+static present_bool
+page_has_name(int fd, const char * name)
+{
+    struct stat info, named_info;
+    present_bool same;
+    int named_fd;
+
+    named_fd = shm_open(name, O_RDONLY, 0);
+    if (named_fd < 0) {
+        return 0;
+    }
+    same = fstat(fd, &info) == 0 && fstat(named_fd, &named_info) == 0 &&
+        info.st_dev == named_info.st_dev && info.st_ino == named_info.st_ino;
+    close(named_fd);
+    return same;
+}
+
+/**
+ * Remove the name of a publisher's shared memory, unless it has already been
+ * replaced (by a publisher that found it stale).
+ *
+ * Whoever removes a name holds the lock (flock) on the shared memory that it
+ * refers to, and checks that it still refers to it, so that two publishers
+ * never both decide to replace the same shared memory.
+ */
+static void
+page_unlink(int fd, const char * name)
+{
+    if (flock(fd, LOCK_EX) == 0) {
+        if (page_has_name(fd, name)) {
+            shm_unlink(name);
+        }
+        flock(fd, LOCK_UN);
+    }
+}
+
+/**
+ * Create the shared memory with a name for a ClockPage, replacing any that
+ * was left behind by a publisher that is no longer writing to it.
+ *
+ * @return The file descriptor, or -1 if another publisher is using the name
+ * (or the shared memory could not be created).
+ */
+static int
+page_create_named(const char * name)
+{
+    present_bool live;
+    int fd, existing_fd, attempt;
+
+    for (attempt = 0; attempt < PAGE_CREATE_ATTEMPTS; attempt++) {
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd >= 0 || errno != EEXIST) {
+            return fd;
+        }
+
+        /* Remove the existing shared memory if it is stale (while holding
+           its lock, and if no one else has replaced it in the meantime),
+           and try again */
+        existing_fd = shm_open(name, O_RDONLY, 0);
+        if (existing_fd < 0) {
+            continue;
+        }
+        live = 0;
+        if (flock(existing_fd, LOCK_EX) == 0) {
+            if (page_has_name(existing_fd, name)) {
+                live = page_is_live(existing_fd);
+                if (!live) {
+                    shm_unlink(name);
+                }
+            }
+            flock(existing_fd, LOCK_UN);
+        }
+        close(existing_fd);
+        if (live) {
+            break;
+        }
+    }
+    return -1;
+}
+
+/** Release a publisher's memory (once its thread has stopped). */
+static void
+page_free_publisher(struct ClockPagePublisher * const publisher)
+{
+    free(publisher->name);
+    free(publisher);
+}
+
+/**
+ * Undo a ClockPage_publish that failed part of the way through (before the
+ * thread was started).
+ *
+ * @return 0, for ClockPage_publish to return.
+ */
+static present_bool
+page_abandon(
+        struct ClockPagePublisher * const publisher,
+        void * mapping,
+        int fd)
+{
+    if (mapping != MAP_FAILED) {
+        munmap(mapping, sizeof(struct ClockPageData));
+    }
+    if (fd >= 0) {
+        if (publisher->name != NULL) {
+            page_unlink(fd, publisher->name);
+        }
+        close(fd);
+    }
+    page_free_publisher(publisher);
+    return 0;
+}
+
+void
+ClockPage_init(struct ClockPage * const self)
+{
+    assert(self != NULL);
+
+    self->page_ = NULL;
+    self->fd_ = -1;
+    self->publisher_ = NULL;
+}
+
+present_bool
+ClockPage_publish(
+        struct ClockPage * const self,
+        const char * name,
+        const struct TimeDelta * const interval)
+{
+    struct ClockPagePublisher * publisher;
+    struct ClockPageData * page;
+    void * mapping = MAP_FAILED;
+    int fd;
+
+    assert(self != NULL);
+    assert(self->page_ == NULL);
+    assert(interval != NULL);
+    assert(interval->data_.delta_seconds > 0 ||
+           (interval->data_.delta_seconds == 0 &&
+            interval->data_.delta_nanoseconds > 0));
+
+    publisher = (struct ClockPagePublisher *) calloc(1,
+            sizeof(struct ClockPagePublisher));
+    if (publisher == NULL) {
+        return 0;
+    }
+    if (name != NULL) {
+        publisher->name = (char *) malloc(strlen(name) + 1);
+        if (publisher->name == NULL) {
+            return page_abandon(publisher, MAP_FAILED, -1);
+        }
+        strcpy(publisher->name, name);
+    }
+    publisher->pid = getpid();
+    publisher->interval.tv_sec = (time_t) interval->data_.delta_seconds;
+    publisher->interval.tv_nsec = (long) interval->data_.delta_nanoseconds;
+
+    /* Create the shared memory (new, so it starts out zeroed) */
+    fd = name != NULL ? page_create_named(name) : page_create_unnamed();
+    if (fd >= 0) {
+        if (ftruncate(fd, sizeof(struct ClockPageData)) == 0) {
+            mapping = mmap(NULL, sizeof(struct ClockPageData),
+                    PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+#ifdef MAP_ANONYMOUS
+    } else if (name == NULL) {
+        /* Without memfd_create, the page is only shared with the child
+           processes that are forked after this */
+        mapping = mmap(NULL, sizeof(struct ClockPageData),
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+#endif
+    }
+    if (mapping == MAP_FAILED) {
+        return page_abandon(publisher, mapping, fd);
+    }
+
+    /* Write the first time before the page is marked as a ClockPage, so that
+       no reader sees it without a time */
+    page = (struct ClockPageData *) mapping;
+    page->interval_nanoseconds =
+        interval->data_.delta_seconds * NANOSECONDS_IN_SECOND +
+        interval->data_.delta_nanoseconds;
+    STORE_RELAXED(&page->publishing, 1);
+    page_write(page);
+    STORE_RELEASE(&page->magic, PAGE_MAGIC);
+    publisher->page = page;
+
+    if (pthread_mutex_init(&publisher->lock, NULL) != 0) {
+        return page_abandon(publisher, mapping, fd);
+    }
+    if (page_init_condition(&publisher->stop_condition) != 0) {
+        pthread_mutex_destroy(&publisher->lock);
+        return page_abandon(publisher, mapping, fd);
+    }
+    if (pthread_create(&publisher->thread, NULL, &page_publish_loop,
+                publisher) != 0) {
+        pthread_cond_destroy(&publisher->stop_condition);
+        pthread_mutex_destroy(&publisher->lock);
+        return page_abandon(publisher, mapping, fd);
+    }
+
+    self->page_ = mapping;
+    self->fd_ = fd;
+    self->publisher_ = publisher;
+    return 1;
+}
+
+present_bool
+ClockPage_open(struct ClockPage * const self, const char * name)
+{
+    int fd;
+
+    assert(self != NULL);
+    assert(self->page_ == NULL);
+    assert(name != NULL);
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    return ClockPage_open_fd(self, fd);
+}
+
+present_bool
+ClockPage_open_fd(struct ClockPage * const self, int fd)
+{
+    struct stat info;
+    void * mapping;
+
+    assert(self != NULL);
+    assert(self->page_ == NULL);
+    assert(fd >= 0);
+
+    if (fstat(fd, &info) != 0 ||
+            info.st_size < (off_t) sizeof(struct ClockPageData)) {
+        close(fd);
+        return 0;
+    }
+    mapping = mmap(NULL, sizeof(struct ClockPageData), PROT_READ,
+            MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        return 0;
+    }
+    if (LOAD_ACQUIRE(&((struct ClockPageData *) mapping)->magic) !=
+            PAGE_MAGIC) {
+        munmap(mapping, sizeof(struct ClockPageData));
+        close(fd);
+        return 0;
+    }
+
+    self->page_ = mapping;
+    self->fd_ = fd;
+    self->publisher_ = NULL;
+    return 1;
+}
+
+void
+ClockPage_close(struct ClockPage * const self)
+{
+    struct ClockPagePublisher * publisher;
+
+    assert(self != NULL);
+
+    publisher = self->publisher_;
+    if (publisher != NULL) {
+        if (publisher->pid == getpid()) {
+            pthread_mutex_lock(&publisher->lock);
+            publisher->stopping = 1;
+            pthread_cond_signal(&publisher->stop_condition);
+            pthread_mutex_unlock(&publisher->lock);
+            pthread_join(publisher->thread, NULL);
+            pthread_cond_destroy(&publisher->stop_condition);
+            pthread_mutex_destroy(&publisher->lock);
+
+            STORE_RELEASE(&publisher->page->publishing, 0);
+            if (publisher->name != NULL) {
+                page_unlink(self->fd_, publisher->name);
+            }
+        }
+        page_free_publisher(publisher);
+    }
+    if (self->page_ != NULL) {
+        munmap(self->page_, sizeof(struct ClockPageData));
+    }
+    if (self->fd_ >= 0) {
+        close(self->fd_);
+    }
+    ClockPage_init(self);
+}
+
+present_bool
+ClockPage_is_publishing(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    assert(self->page_ != NULL);
+
+    return LOAD_ACQUIRE(&PAGE_DATA(self)->publishing) != 0;
+}
+
+struct TimeDelta
+ClockPage_get_age(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    assert(self->page_ != NULL);
+
+    return TimeDelta_from_nanoseconds(page_age_nanoseconds(PAGE_DATA(self)));
+}
+
+struct TimeDelta
+ClockPage_get_interval(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    assert(self->page_ != NULL);
+
+    return TimeDelta_from_nanoseconds(PAGE_DATA(self)->interval_nanoseconds);
+}
+
+struct Timestamp
+ClockPage_now(const struct ClockPage * const self)
+{
+    const struct ClockPageData * page;
+    present_uint64 sequence;
+    present_int64 seconds, nanoseconds;
+    struct Timestamp result;
+
+    assert(self != NULL);
+    assert(self->page_ != NULL);
+
+    page = PAGE_DATA(self);
+    do {
+        sequence = LOAD_ACQUIRE(&page->sequence);
+        seconds = LOAD_RELAXED(&page->seconds);
+        nanoseconds = LOAD_RELAXED(&page->nanoseconds);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((sequence & 1) || LOAD_RELAXED(&page->sequence) != sequence);
+
+    CLEAR(&result);
+    result.data_.timestamp_seconds = seconds;
+    result.data_.additional_nanoseconds = nanoseconds;
+    return result;
+}
+
+#else /* CLOCK_PAGE_SUPPORTED */
+
+void
+ClockPage_init(struct ClockPage * const self)
+{
+    assert(self != NULL);
+
+    self->page_ = NULL;
+    self->fd_ = -1;
+    self->publisher_ = NULL;
+}
+
+present_bool
+ClockPage_publish(
+        struct ClockPage * const self,
+        const char * name,
+        const struct TimeDelta * const interval)
+{
+    assert(self != NULL);
+    assert(interval != NULL);
+
+    (void) self;
+    (void) name;
+    (void) interval;
+    return 0;
+}
+
+present_bool
+ClockPage_open(struct ClockPage * const self, const char * name)
+{
+    assert(self != NULL);
+    assert(name != NULL);
+
+    (void) self;
+    (void) name;
+    return 0;
+}
+
+present_bool
+ClockPage_open_fd(struct ClockPage * const self, int fd)
+{
+    assert(self != NULL);
+    assert(fd >= 0);
+
+    (void) self;
+    close(fd);
+    return 0;
+}
+
+void
+ClockPage_close(struct ClockPage * const self)
+{
+    ClockPage_init(self);
+}
+
+present_bool
+ClockPage_is_publishing(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    (void) self;
+    return 0;
+}
+
+struct TimeDelta
+ClockPage_get_interval(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    (void) self;
+    return TimeDelta_zero();
+}
+
+struct TimeDelta
+ClockPage_get_age(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    (void) self;
+    return TimeDelta_zero();
+}
+
+struct Timestamp
+ClockPage_now(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    assert(self->page_ != NULL);
+    (void) self;
+    return Timestamp_epoch();
+}
+
+#endif /* CLOCK_PAGE_SUPPORTED */
+
+present_bool
+ClockPage_is_open(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    return self->page_ != NULL;
+}
+
+int
+ClockPage_get_fd(const struct ClockPage * const self)
+{
+    assert(self != NULL);
+    return self->fd_;
+}
+
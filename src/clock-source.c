@@ -0,0 +1,92 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the clock source functions
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "present.h"
+
+#include "utils/time-utils.h"
+#include "utils/tsc-utils.h"
+
+present_bool
+ClockSource_select(int source)
+{
+    assert(source == PRESENT_CLOCK_SOURCE_REALTIME ||
+           source == PRESENT_CLOCK_SOURCE_REALTIME_COARSE ||
+           source == PRESENT_CLOCK_SOURCE_TSC);
+
+    if (!ClockSource_is_available(source)) {
+        return 0;
+    }
+
+    switch (source) {
+        case PRESENT_CLOCK_SOURCE_REALTIME_COARSE:
+            present_set_clock_function(&present_clock_realtime_coarse,
+                    source);
+            break;
+        case PRESENT_CLOCK_SOURCE_TSC:
+            present_set_clock_function(&present_clock_tsc, source);
+            break;
+        default:
+            present_set_clock_function(&present_clock_realtime, source);
+            break;
+    }
+    return 1;
+}
+
+void
+ClockSource_set_callback(ClockSourceCallback callback)
+{
+    assert(callback != NULL);
+
+    present_set_clock_function(callback, PRESENT_CLOCK_SOURCE_CALLBACK);
+}
+
+int
+ClockSource_get(void)
+{
+    return present_get_clock_source();
+}
+
+present_bool
+ClockSource_is_available(int source)
+{
+    struct PresentNowStruct resolution;
+
+    if (source == PRESENT_CLOCK_SOURCE_CALLBACK) {
+        return 1;
+    }
+    if (source == PRESENT_CLOCK_SOURCE_TSC) {
+        /* This calibrates the TSC, the first time */
+        return present_tsc_calibrate();
+    }
+    return present_clock_resolution(source, &resolution);
+}
+
+struct TimeDelta
+ClockSource_resolution(int source)
+{
+    struct PresentNowStruct resolution;
+    struct TimeDelta result, nanoseconds;
+
+    if (source == PRESENT_CLOCK_SOURCE_TSC) {
+        if (!present_tsc_resolution(&resolution)) {
+            return TimeDelta_zero();
+        }
+    } else if (!present_clock_resolution(source, &resolution)) {
+        return TimeDelta_zero();
+    }
+
+    result = TimeDelta_from_seconds((int_delta) resolution.sec);
+    nanoseconds = TimeDelta_from_nanoseconds((int_delta) resolution.nsec);
+    TimeDelta_add(&result, &nanoseconds);
+    return result;
+}
+
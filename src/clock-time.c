@@ -11,6 +11,7 @@
 #include <stddef.h>
 
 #include "present.h"
+#include "present/internal/format-utils.h"
 
 #include "utils/constants.h"
 #include "utils/impl-utils.h"
@@ -162,6 +163,44 @@ ClockTime_ptr_from_hour_minute_second_nanosecond(
     init_clock_time(result, hour, minute, second, nanosecond);
 }
 
+size_t
+ClockTime_batch_from_hour_minute_second(
+        const int_hour * const hours,
+        const int_minute * const minutes,
+        const int_second * const seconds,
+        struct ClockTime * const results,
+        present_uint64 * const error_mask,
+        size_t count)
+{
+    size_t i, error_count;
+    present_uint64 mask_word;
+
+    assert(hours != NULL);
+    assert(minutes != NULL);
+    assert(seconds != NULL);
+    assert(results != NULL);
+
+    error_count = 0;
+    mask_word = 0;
+    for (i = 0; i < count; i++) {
+        init_clock_time(&results[i], hours[i], minutes[i], seconds[i], 0);
+
+        if (results[i].has_error) {
+            error_count++;
+            mask_word |= (present_uint64)1 << (i % 64);
+        }
+
+        if (i % 64 == 63 || i == count - 1) {
+            if (error_mask != NULL) {
+                error_mask[i / 64] = mask_word;
+            }
+            mask_word = 0;
+        }
+    }
+
+    return error_count;
+}
+
 struct ClockTime
 ClockTime_create_with_decimal_seconds(
         int_hour hour,
@@ -276,6 +315,26 @@ ClockTime_time_since_midnight(const struct ClockTime * const self)
     return delta;
 }
 
+size_t
+ClockTime_format(
+        const struct ClockTime * const self,
+        const char * const format,
+        char * const buffer,
+        size_t buffer_size)
+{
+    struct PresentFormatFields fields;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(format != NULL);
+    assert(buffer != NULL);
+
+    CLEAR(&fields);
+    fields.clock_time = self->data_;
+    return present_format(
+            buffer, buffer_size, format, PRESENT_FORMAT_CLOCK_TIME, &fields);
+}
+
 void
 ClockTime_add_TimeDelta(
         struct ClockTime * const self,
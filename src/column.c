@@ -0,0 +1,1198 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the DateColumn and TimestampColumn methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "present.h"
+
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/memory-utils.h"
+#include "utils/sort-utils.h"
+#include "utils/time-utils.h"
+
+/*
+ * The bulk operations below are written as loops without branches (using
+ * comparison results as 0 or 1 instead), over arrays that do not alias each
+ * other, so that compilers can vectorize them. The size of the column is read
+ * into a local variable first, since otherwise the compiler has to assume that
+ * writing to one of the arrays could change it.
+ */
+
+/** The smallest capacity allocated for a column. */
+#define COLUMN_MIN_CAPACITY 16
+
+/** The number of array entries in PRESENT_COLUMN_ALIGNMENT bytes. */
+#define COLUMN_ALIGNMENT_ENTRIES \
+    (PRESENT_COLUMN_ALIGNMENT / sizeof(present_int64))
+
+/**
+ * Calculate the capacity to allocate for a column that needs room for at
+ * least @p capacity entries, when it currently has room for @p current.
+ *
+ * The result is a multiple of COLUMN_ALIGNMENT_ENTRIES, so that arrays that
+ * are stored one after another in the same block all stay aligned. If the
+ * number of bytes for @p arrays arrays of that capacity would overflow, this
+ * returns 0.
+ */
+static size_t
+column_grow_capacity(size_t current, size_t capacity, size_t arrays)
+{
+    size_t result = current < COLUMN_MIN_CAPACITY ?
+        COLUMN_MIN_CAPACITY : current;
+
+    while (result < capacity) {
+        if (result > (size_t)-1 / 2) {
+            result = capacity;
+            break;
+        }
+        result *= 2;
+    }
+    result = (result + COLUMN_ALIGNMENT_ENTRIES - 1) /
+        COLUMN_ALIGNMENT_ENTRIES * COLUMN_ALIGNMENT_ENTRIES;
+
+    if (result < capacity ||
+            result > (size_t)-1 / arrays / sizeof(present_int64)) {
+        return 0;
+    }
+    return result;
+}
+
+/**
+ * Set each entry of a permutation (if it is not NULL) to its own index.
+ */
+static void
+column_init_permutation(size_t * const permutation, size_t size)
+{
+    size_t i;
+
+    if (permutation != NULL) {
+        for (i = 0; i < size; i++) {
+            permutation[i] = i;
+        }
+    }
+}
+
+/**
+ * The bits of 2^52 + 2^51 as a double. Adding an integer of less than 2^51
+ * (in magnitude) to these bits gives the bits of that double plus the
+ * integer, which is a conversion between 64-bit integers and doubles that
+ * (unlike a cast) compilers can vectorize without AVX-512.
+ */
+#define COLUMN_DOUBLE_MAGIC_BITS    ((present_int64)0x43380000UL << 32)
+/** 2^52 + 2^51 */
+#define COLUMN_DOUBLE_MAGIC         6755399441055744.0
+
+/** The largest quotients that column_divide can estimate exactly enough. */
+#define COLUMN_MAX_QUOTIENT         562949953421312.0   /* 2^49 */
+
+/**
+ * Convert an integer (of less than 2^51 in magnitude) to a double, in a way
+ * that compilers can vectorize.
+ */
+static PRESENT_INLINE double
+column_to_double(present_int64 value)
+{
+    double result;
+
+    value += COLUMN_DOUBLE_MAGIC_BITS;
+    memcpy(&result, &value, sizeof(result));
+    return result - COLUMN_DOUBLE_MAGIC;
+}
+
+/**
+ * Round a double (of less than 2^51 in magnitude) to the nearest integer, in
+ * a way that compilers can vectorize.
+ */
+static PRESENT_INLINE present_int64
+column_to_int64(double value)
+{
+    present_int64 result;
+
+    value += COLUMN_DOUBLE_MAGIC;
+    memcpy(&result, &value, sizeof(result));
+    return result - COLUMN_DOUBLE_MAGIC_BITS;
+}
+
+/**
+ * The parameters for dividing the timestamps in a TimestampColumn into
+ * fixed-width buckets (see column_prepare_division).
+ *
+ * For a timestamp that is @p seconds and @p nanoseconds after the origin,
+ * the bucket is:
+ *
+ *     seconds * per_second +
+ *         floor((seconds * scale + nanoseconds * nanoseconds_scale) / divisor)
+ *
+ * which covers widths of whole seconds (in seconds), widths that divide a
+ * second (in nanoseconds within the second), and any other width (in
+ * nanoseconds).
+ */
+struct column_division {
+    int_timestamp origin_seconds;
+    int_timestamp origin_nanoseconds;
+    present_int64 per_second;
+    present_int64 scale;
+    present_int64 nanoseconds_scale;
+    present_int64 divisor;
+    double inverse;
+};
+
+/**
+ * Fill in a DateColumn with the date (in a time zone with the given offset)
+ * of each timestamp in a TimestampColumn.
+ */
+static present_bool
+timestamp_column_to_date_column(
+        const struct TimestampColumn * const self,
+        int_delta offset_seconds,
+        int_delta offset_nanoseconds,
+        struct DateColumn * const result)
+{
+    const int_timestamp * const seconds = self->seconds_;
+    const int_timestamp * const nanoseconds = self->nanoseconds_;
+    int_delta * days;
+    int_timestamp local_nanoseconds, local_seconds;
+    size_t i, size;
+
+    if (!DateColumn_reserve(result, self->size_)) {
+        return 0;
+    }
+
+    days = result->days_;
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        /* Same as adding the offset with timestamp_column_add */
+        local_nanoseconds = nanoseconds[i] + offset_nanoseconds;
+        local_seconds = seconds[i] + offset_seconds +
+            (local_nanoseconds >= NANOSECONDS_IN_SECOND) -
+            (local_nanoseconds < 0);
+        days[i] = FLOOR_DIV(local_seconds, SECONDS_IN_DAY);
+    }
+    result->size_ = size;
+    return 1;
+}
+
+/**
+ * Set up the division of the timestamps in a TimestampColumn (which must not
+ * be empty) into buckets of a width, starting from an origin.
+ *
+ * @return 1 if every timestamp is close enough to the origin for
+ * column_divide, or 0 if they have to be done one at a time.
+ */
+static present_bool
+column_prepare_division(
+        const struct TimestampColumn * const self,
+        int_delta width_seconds,
+        int_delta width_nanoseconds,
+        int_timestamp origin_seconds,
+        int_timestamp origin_nanoseconds,
+        struct column_division * const division)
+{
+    const int_timestamp * const seconds = self->seconds_;
+    int_timestamp low, high;
+    double limit;
+    size_t i, size;
+
+    division->origin_seconds = origin_seconds;
+    division->origin_nanoseconds = origin_nanoseconds;
+    division->per_second = 0;
+    division->scale = 1;
+    division->nanoseconds_scale = 1;
+
+    if (width_nanoseconds == 0) {
+        /* Whole seconds (the nanoseconds never reach the next bucket) */
+        if (width_seconds >= ((present_int64)1 << 61)) {
+            return 0;
+        }
+        division->nanoseconds_scale = 0;
+        division->divisor = width_seconds;
+        limit = COLUMN_MAX_QUOTIENT;
+    } else if (width_seconds == 0 &&
+            NANOSECONDS_IN_SECOND % width_nanoseconds == 0) {
+        /* Part of a second (so every second has the same buckets) */
+        division->per_second = NANOSECONDS_IN_SECOND / width_nanoseconds;
+        division->scale = 0;
+        division->divisor = width_nanoseconds;
+        limit = COLUMN_MAX_QUOTIENT / (double)NANOSECONDS_IN_SECOND;
+    } else {
+        /* Anything else (in nanoseconds, which must fit in 62 bits, and the
+           remainder must fit in a double for column_bucket_nanoseconds) */
+        if (width_seconds >= ((present_int64)1 << 50) /
+                NANOSECONDS_IN_SECOND) {
+            return 0;
+        }
+        division->scale = NANOSECONDS_IN_SECOND;
+        division->divisor =
+            width_seconds * NANOSECONDS_IN_SECOND + width_nanoseconds;
+        limit = COLUMN_MAX_QUOTIENT * (double)division->divisor /
+            NANOSECONDS_IN_SECOND;
+        if (limit > 4.0e9) {
+            limit = 4.0e9;
+        }
+    }
+    division->inverse = 1.0 / (double)division->divisor;
+
+    /* Check the range of the (whole) seconds after the origin */
+    low = high = seconds[0];
+    size = self->size_;
+    for (i = 1; i < size; i++) {
+        low = seconds[i] < low ? seconds[i] : low;
+        high = seconds[i] > high ? seconds[i] : high;
+    }
+    return (double)low - (double)origin_seconds - 1.0 > -limit &&
+        (double)high - (double)origin_seconds < limit;
+}
+
+/**
+ * Find the bucket of a timestamp (see struct column_division), and the
+ * remainder (the part of the timestamp after the start of the bucket, in
+ * units of the divisor, but not including the nanoseconds when they are not
+ * part of the division).
+ *
+ * This estimates the quotient with a multiplication by the reciprocal of the
+ * divisor, and then corrects it with integers. As long as the quotient is
+ * less than COLUMN_MAX_QUOTIENT, the estimate is off by at most 1.
+ */
+static PRESENT_INLINE present_int64
+column_divide(
+        const struct column_division * const division,
+        int_timestamp seconds,
+        int_timestamp nanoseconds,
+        present_int64 * const remainder)
+{
+    present_int64 borrow, value, quotient;
+
+    borrow = nanoseconds < division->origin_nanoseconds;
+    seconds -= division->origin_seconds + borrow;
+    nanoseconds += borrow * NANOSECONDS_IN_SECOND -
+        division->origin_nanoseconds;
+
+    value = seconds * division->scale +
+        nanoseconds * division->nanoseconds_scale;
+    quotient = column_to_int64((
+                column_to_double(seconds) * (double)division->scale +
+                column_to_double(nanoseconds) *
+                    (double)division->nanoseconds_scale) *
+            division->inverse);
+    quotient -= quotient * division->divisor > value;
+    quotient += (quotient + 1) * division->divisor <= value;
+
+    *remainder = value - quotient * division->divisor;
+    return seconds * division->per_second + quotient;
+}
+
+/**
+ * Replace every timestamp in a TimestampColumn with the start of its bucket
+ * (see TimestampColumn_bucket).
+ */
+static void
+timestamp_column_bucket(
+        struct TimestampColumn * const self,
+        const struct TimeDelta * const width,
+        const struct Timestamp * const origin)
+{
+    int_timestamp * const seconds = self->seconds_;
+    int_timestamp * const nanoseconds = self->nanoseconds_;
+    const int_delta width_seconds = width->data_.delta_seconds;
+    const int_delta width_nanoseconds = width->data_.delta_nanoseconds;
+    const int_timestamp origin_seconds = origin->data_.timestamp_seconds;
+    const int_timestamp origin_nanoseconds =
+        origin->data_.additional_nanoseconds;
+    struct column_division division;
+    struct Timestamp timestamp, result;
+    present_int64 bucket, remainder, remainder_seconds, borrow;
+    size_t i, size;
+
+    size = self->size_;
+    if (size == 0) {
+        return;
+    }
+
+    if (!column_prepare_division(self, width_seconds, width_nanoseconds,
+                origin_seconds, origin_nanoseconds, &division)) {
+        for (i = 0; i < size; i++) {
+            timestamp = TimestampColumn_get(self, i);
+            result = Timestamp_bucket(&timestamp, width, origin);
+            seconds[i] = result.data_.timestamp_seconds;
+            nanoseconds[i] = result.data_.additional_nanoseconds;
+        }
+        return;
+    }
+
+    if (width_nanoseconds == 0) {
+        for (i = 0; i < size; i++) {
+            bucket = column_divide(&division, seconds[i], nanoseconds[i],
+                    &remainder);
+            seconds[i] = origin_seconds + bucket * width_seconds;
+            nanoseconds[i] = origin_nanoseconds;
+        }
+    } else {
+        /* The start of the bucket is the remainder (which is less than
+           2^50 nanoseconds) before the timestamp */
+        for (i = 0; i < size; i++) {
+            bucket = column_divide(&division, seconds[i], nanoseconds[i],
+                    &remainder);
+            remainder_seconds = column_to_int64(
+                    column_to_double(remainder) / NANOSECONDS_IN_SECOND);
+            remainder_seconds -=
+                remainder_seconds * NANOSECONDS_IN_SECOND > remainder;
+            remainder_seconds +=
+                (remainder_seconds + 1) * NANOSECONDS_IN_SECOND <= remainder;
+            remainder -= remainder_seconds * NANOSECONDS_IN_SECOND;
+
+            borrow = nanoseconds[i] < remainder;
+            seconds[i] -= remainder_seconds + borrow;
+            nanoseconds[i] += borrow * NANOSECONDS_IN_SECOND - remainder;
+        }
+    }
+}
+
+/**
+ * Add a number of seconds and nanoseconds (with the same sign, and less than
+ * a second of nanoseconds) to every timestamp in a TimestampColumn.
+ */
+static void
+timestamp_column_add(
+        struct TimestampColumn * const self,
+        int_delta delta_seconds,
+        int_delta delta_nanoseconds)
+{
+    int_timestamp * const seconds = self->seconds_;
+    int_timestamp * const nanoseconds = self->nanoseconds_;
+    int_timestamp value, carry;
+    size_t i, size;
+
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        /* value is from -999,999,999 to 1,999,999,998 */
+        value = nanoseconds[i] + delta_nanoseconds;
+        carry = (value >= NANOSECONDS_IN_SECOND) - (value < 0);
+        seconds[i] += delta_seconds + carry;
+        nanoseconds[i] = value - carry * NANOSECONDS_IN_SECOND;
+    }
+}
+
+/*
+ * DateColumn
+ */
+
+void
+DateColumn_init(struct DateColumn * const self)
+{
+    assert(self != NULL);
+
+    self->days_ = NULL;
+    self->size_ = 0;
+    self->capacity_ = 0;
+}
+
+void
+DateColumn_destroy(struct DateColumn * const self)
+{
+    assert(self != NULL);
+
+    present_aligned_free(self->days_);
+    DateColumn_init(self);
+}
+
+present_bool
+DateColumn_reserve(struct DateColumn * const self, size_t capacity)
+{
+    int_delta * days;
+
+    assert(self != NULL);
+
+    if (capacity <= self->capacity_) {
+        return 1;
+    }
+
+    capacity = column_grow_capacity(self->capacity_, capacity, 1);
+    if (capacity == 0) {
+        return 0;
+    }
+    days = (int_delta *) present_aligned_alloc(
+            capacity * sizeof(int_delta), PRESENT_COLUMN_ALIGNMENT);
+    if (days == NULL) {
+        return 0;
+    }
+
+    if (self->size_ > 0) {
+        memcpy(days, self->days_, self->size_ * sizeof(int_delta));
+    }
+    present_aligned_free(self->days_);
+    self->days_ = days;
+    self->capacity_ = capacity;
+    return 1;
+}
+
+present_bool
+DateColumn_assign(
+        struct DateColumn * const self,
+        const struct DateColumn * const other)
+{
+    assert(self != NULL);
+    assert(other != NULL);
+
+    if (self == other) {
+        return 1;
+    }
+    if (!DateColumn_reserve(self, other->size_)) {
+        return 0;
+    }
+    if (other->size_ > 0) {
+        memcpy(self->days_, other->days_, other->size_ * sizeof(int_delta));
+    }
+    self->size_ = other->size_;
+    return 1;
+}
+
+void
+DateColumn_clear(struct DateColumn * const self)
+{
+    assert(self != NULL);
+
+    self->size_ = 0;
+}
+
+present_bool
+DateColumn_push_back(
+        struct DateColumn * const self,
+        const struct Date * const date)
+{
+    assert(self != NULL);
+    assert(date != NULL);
+    assert(date->has_error == 0);
+
+    if (self->size_ == self->capacity_ &&
+            !DateColumn_reserve(self, self->size_ + 1)) {
+        return 0;
+    }
+
+    self->days_[self->size_++] = DATE_TO_DAYS(date);
+    return 1;
+}
+
+struct Date
+DateColumn_get(const struct DateColumn * const self, size_t index)
+{
+    assert(self != NULL);
+    assert(index < self->size_);
+
+    return present_days_to_date(self->days_[index]);
+}
+
+struct Date
+DateColumn_min(const struct DateColumn * const self)
+{
+    const int_delta * days;
+    int_delta result;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(self->size_ > 0);
+
+    days = self->days_;
+
+    size = self->size_;
+    result = days[0];
+    for (i = 1; i < size; i++) {
+        result = days[i] < result ? days[i] : result;
+    }
+    return present_days_to_date(result);
+}
+
+struct Date
+DateColumn_max(const struct DateColumn * const self)
+{
+    const int_delta * days;
+    int_delta result;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(self->size_ > 0);
+
+    days = self->days_;
+
+    size = self->size_;
+    result = days[0];
+    for (i = 1; i < size; i++) {
+        result = days[i] > result ? days[i] : result;
+    }
+    return present_days_to_date(result);
+}
+
+size_t
+DateColumn_filter_range(
+        const struct DateColumn * const self,
+        const struct Date * const low,
+        const struct Date * const high,
+        size_t * const selection)
+{
+    const int_delta * days;
+    int_delta low_days, high_days;
+    size_t i, count, size;
+
+    assert(self != NULL);
+    assert(low != NULL);
+    assert(low->has_error == 0);
+    assert(high != NULL);
+    assert(high->has_error == 0);
+    assert(selection != NULL || self->size_ == 0);
+
+    days = self->days_;
+
+    low_days = DATE_TO_DAYS(low);
+    high_days = DATE_TO_DAYS(high);
+
+    count = 0;
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        selection[count] = i;
+        count += (days[i] >= low_days) & (days[i] < high_days);
+    }
+    return count;
+}
+
+void
+DateColumn_compare(
+        const struct DateColumn * const self,
+        const struct Date * const value,
+        present_int8 * const results)
+{
+    const int_delta * days;
+    int_delta value_days;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(value != NULL);
+    assert(value->has_error == 0);
+    assert(results != NULL || self->size_ == 0);
+
+    days = self->days_;
+
+    value_days = DATE_TO_DAYS(value);
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        results[i] = (present_int8)(
+                (days[i] > value_days) - (days[i] < value_days));
+    }
+}
+
+void
+DateColumn_add_DayDelta(
+        struct DateColumn * const self,
+        const struct DayDelta * const delta)
+{
+    int_delta * days;
+    int_delta delta_days;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(delta != NULL);
+
+    days = self->days_;
+
+    delta_days = delta->data_.delta_days;
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        days[i] += delta_days;
+    }
+}
+
+void
+DateColumn_subtract_DayDelta(
+        struct DateColumn * const self,
+        const struct DayDelta * const delta)
+{
+    struct DayDelta negated;
+
+    assert(delta != NULL);
+
+    negated = *delta;
+    DayDelta_negate(&negated);
+    DateColumn_add_DayDelta(self, &negated);
+}
+
+present_bool
+DateColumn_sort(struct DateColumn * const self, size_t * const permutation)
+{
+    return DateColumn_sort_parallel(self, permutation, 1);
+}
+
+present_bool
+DateColumn_sort_parallel(
+        struct DateColumn * const self,
+        size_t * const permutation,
+        unsigned int thread_count)
+{
+    present_uint64 * keys;
+    size_t i, size;
+    present_bool success;
+
+    assert(self != NULL);
+
+    /* Flipping the sign bit turns the days into unsigned keys in the same
+       order (and flipping it back turns them into days again) */
+    keys = (present_uint64 *) self->days_;
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        keys[i] ^= PRESENT_SORT_SIGN_BIT;
+    }
+
+    column_init_permutation(permutation, size);
+    success = present_radix_sort(
+            keys, NULL, 0, permutation, size, thread_count);
+
+    for (i = 0; i < size; i++) {
+        keys[i] ^= PRESENT_SORT_SIGN_BIT;
+    }
+    return success;
+}
+
+size_t
+DateColumn_unique(struct DateColumn * const self)
+{
+    int_delta * days;
+    size_t i, size, count;
+
+    assert(self != NULL);
+
+    days = self->days_;
+    size = self->size_;
+    if (size == 0) {
+        return 0;
+    }
+
+    count = 1;
+    for (i = 1; i < size; i++) {
+        days[count] = days[i];
+        count += days[i] != days[count - 1];
+    }
+    self->size_ = count;
+    return count;
+}
+
+/*
+ * TimestampColumn
+ */
+
+void
+TimestampColumn_init(struct TimestampColumn * const self)
+{
+    assert(self != NULL);
+
+    self->seconds_ = NULL;
+    self->nanoseconds_ = NULL;
+    self->size_ = 0;
+    self->capacity_ = 0;
+}
+
+void
+TimestampColumn_destroy(struct TimestampColumn * const self)
+{
+    assert(self != NULL);
+
+    /* Both arrays are in the block allocated for seconds_ */
+    present_aligned_free(self->seconds_);
+    TimestampColumn_init(self);
+}
+
+present_bool
+TimestampColumn_reserve(struct TimestampColumn * const self, size_t capacity)
+{
+    int_timestamp * block;
+
+    assert(self != NULL);
+
+    if (capacity <= self->capacity_) {
+        return 1;
+    }
+
+    capacity = column_grow_capacity(self->capacity_, capacity, 2);
+    if (capacity == 0) {
+        return 0;
+    }
+    /* The nanoseconds are right after the seconds (since the capacity is a
+       multiple of COLUMN_ALIGNMENT_ENTRIES, they are also aligned) */
+    block = (int_timestamp *) present_aligned_alloc(
+            2 * capacity * sizeof(int_timestamp),
+            PRESENT_COLUMN_ALIGNMENT);
+    if (block == NULL) {
+        return 0;
+    }
+
+    if (self->size_ > 0) {
+        memcpy(block, self->seconds_, self->size_ * sizeof(int_timestamp));
+        memcpy(block + capacity, self->nanoseconds_,
+                self->size_ * sizeof(int_timestamp));
+    }
+    present_aligned_free(self->seconds_);
+    self->seconds_ = block;
+    self->nanoseconds_ = block + capacity;
+    self->capacity_ = capacity;
+    return 1;
+}
+
+present_bool
+TimestampColumn_assign(
+        struct TimestampColumn * const self,
+        const struct TimestampColumn * const other)
+{
+    assert(self != NULL);
+    assert(other != NULL);
+
+    if (self == other) {
+        return 1;
+    }
+    if (!TimestampColumn_reserve(self, other->size_)) {
+        return 0;
+    }
+    if (other->size_ > 0) {
+        memcpy(self->seconds_, other->seconds_,
+                other->size_ * sizeof(int_timestamp));
+        memcpy(self->nanoseconds_, other->nanoseconds_,
+                other->size_ * sizeof(int_timestamp));
+    }
+    self->size_ = other->size_;
+    return 1;
+}
+
+void
+TimestampColumn_clear(struct TimestampColumn * const self)
+{
+    assert(self != NULL);
+
+    self->size_ = 0;
+}
+
+present_bool
+TimestampColumn_push_back(
+        struct TimestampColumn * const self,
+        const struct Timestamp * const timestamp)
+{
+    assert(self != NULL);
+    assert(timestamp != NULL);
+    assert(timestamp->has_error == 0);
+
+    if (self->size_ == self->capacity_ &&
+            !TimestampColumn_reserve(self, self->size_ + 1)) {
+        return 0;
+    }
+
+    self->seconds_[self->size_] = timestamp->data_.timestamp_seconds;
+    self->nanoseconds_[self->size_] = timestamp->data_.additional_nanoseconds;
+    self->size_++;
+    return 1;
+}
+
+struct Timestamp
+TimestampColumn_get(const struct TimestampColumn * const self, size_t index)
+{
+    struct Timestamp result;
+
+    assert(self != NULL);
+    assert(index < self->size_);
+
+    CLEAR(&result);
+    result.data_.timestamp_seconds = self->seconds_[index];
+    result.data_.additional_nanoseconds = self->nanoseconds_[index];
+    return result;
+}
+
+struct Timestamp
+TimestampColumn_min(const struct TimestampColumn * const self)
+{
+    const int_timestamp * seconds;
+    const int_timestamp * nanoseconds;
+    int_timestamp min_seconds, min_nanoseconds, candidate;
+    struct Timestamp result;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(self->size_ > 0);
+
+    seconds = self->seconds_;
+    nanoseconds = self->nanoseconds_;
+
+    /* First find the earliest second, then the earliest nanosecond within
+       that second (2 passes that can each be vectorized, rather than 1 pass
+       that compares both fields) */
+    size = self->size_;
+    min_seconds = seconds[0];
+    for (i = 1; i < size; i++) {
+        min_seconds = seconds[i] < min_seconds ? seconds[i] : min_seconds;
+    }
+    min_nanoseconds = NANOSECONDS_IN_SECOND;
+    for (i = 0; i < size; i++) {
+        candidate = seconds[i] == min_seconds ?
+            nanoseconds[i] : NANOSECONDS_IN_SECOND;
+        min_nanoseconds = candidate < min_nanoseconds ?
+            candidate : min_nanoseconds;
+    }
+
+    CLEAR(&result);
+    result.data_.timestamp_seconds = min_seconds;
+    result.data_.additional_nanoseconds = min_nanoseconds;
+    return result;
+}
+
+struct Timestamp
+TimestampColumn_max(const struct TimestampColumn * const self)
+{
+    const int_timestamp * seconds;
+    const int_timestamp * nanoseconds;
+    int_timestamp max_seconds, max_nanoseconds, candidate;
+    struct Timestamp result;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(self->size_ > 0);
+
+    seconds = self->seconds_;
+    nanoseconds = self->nanoseconds_;
+
+    /* See TimestampColumn_min */
+    size = self->size_;
+    max_seconds = seconds[0];
+    for (i = 1; i < size; i++) {
+        max_seconds = seconds[i] > max_seconds ? seconds[i] : max_seconds;
+    }
+    max_nanoseconds = -1;
+    for (i = 0; i < size; i++) {
+        candidate = seconds[i] == max_seconds ? nanoseconds[i] : -1;
+        max_nanoseconds = candidate > max_nanoseconds ?
+            candidate : max_nanoseconds;
+    }
+
+    CLEAR(&result);
+    result.data_.timestamp_seconds = max_seconds;
+    result.data_.additional_nanoseconds = max_nanoseconds;
+    return result;
+}
+
+size_t
+TimestampColumn_filter_range(
+        const struct TimestampColumn * const self,
+        const struct Timestamp * const low,
+        const struct Timestamp * const high,
+        size_t * const selection)
+{
+    const int_timestamp * seconds;
+    const int_timestamp * nanoseconds;
+    int_timestamp low_seconds, low_nanoseconds, high_seconds, high_nanoseconds;
+    size_t i, count, size;
+
+    assert(self != NULL);
+    assert(low != NULL);
+    assert(low->has_error == 0);
+    assert(high != NULL);
+    assert(high->has_error == 0);
+    assert(selection != NULL || self->size_ == 0);
+
+    seconds = self->seconds_;
+    nanoseconds = self->nanoseconds_;
+
+    low_seconds = low->data_.timestamp_seconds;
+    low_nanoseconds = low->data_.additional_nanoseconds;
+    high_seconds = high->data_.timestamp_seconds;
+    high_nanoseconds = high->data_.additional_nanoseconds;
+
+    count = 0;
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        selection[count] = i;
+        count +=
+            ((seconds[i] > low_seconds) |
+             ((seconds[i] == low_seconds) &
+              (nanoseconds[i] >= low_nanoseconds))) &
+            ((seconds[i] < high_seconds) |
+             ((seconds[i] == high_seconds) &
+              (nanoseconds[i] < high_nanoseconds)));
+    }
+    return count;
+}
+
+void
+TimestampColumn_compare(
+        const struct TimestampColumn * const self,
+        const struct Timestamp * const value,
+        present_int8 * const results)
+{
+    const int_timestamp * seconds;
+    const int_timestamp * nanoseconds;
+    int_timestamp value_seconds, value_nanoseconds;
+    int seconds_result, nanoseconds_result;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(value != NULL);
+    assert(value->has_error == 0);
+    assert(results != NULL || self->size_ == 0);
+
+    seconds = self->seconds_;
+    nanoseconds = self->nanoseconds_;
+
+    value_seconds = value->data_.timestamp_seconds;
+    value_nanoseconds = value->data_.additional_nanoseconds;
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        seconds_result =
+            (seconds[i] > value_seconds) - (seconds[i] < value_seconds);
+        nanoseconds_result =
+            (nanoseconds[i] > value_nanoseconds) -
+            (nanoseconds[i] < value_nanoseconds);
+        /* The nanoseconds only matter if the seconds are the same */
+        results[i] = (present_int8)(seconds_result +
+                (seconds_result == 0) * nanoseconds_result);
+    }
+}
+
+void
+TimestampColumn_add_TimeDelta(
+        struct TimestampColumn * const self,
+        const struct TimeDelta * const delta)
+{
+    assert(self != NULL);
+    assert(delta != NULL);
+
+    timestamp_column_add(self,
+            delta->data_.delta_seconds, delta->data_.delta_nanoseconds);
+}
+
+void
+TimestampColumn_subtract_TimeDelta(
+        struct TimestampColumn * const self,
+        const struct TimeDelta * const delta)
+{
+    assert(self != NULL);
+    assert(delta != NULL);
+
+    timestamp_column_add(self,
+            -delta->data_.delta_seconds, -delta->data_.delta_nanoseconds);
+}
+
+present_bool
+TimestampColumn_get_date_column(
+        const struct TimestampColumn * const self,
+        const struct TimeDelta * const time_zone_offset,
+        struct DateColumn * const result)
+{
+    assert(self != NULL);
+    assert(time_zone_offset != NULL);
+    assert(result != NULL);
+
+    return timestamp_column_to_date_column(self,
+            time_zone_offset->data_.delta_seconds,
+            time_zone_offset->data_.delta_nanoseconds,
+            result);
+}
+
+present_bool
+TimestampColumn_get_date_column_utc(
+        const struct TimestampColumn * const self,
+        struct DateColumn * const result)
+{
+    assert(self != NULL);
+    assert(result != NULL);
+
+    return timestamp_column_to_date_column(self, 0, 0, result);
+}
+
+present_bool
+TimestampColumn_sort(
+        struct TimestampColumn * const self,
+        size_t * const permutation)
+{
+    return TimestampColumn_sort_parallel(self, permutation, 1);
+}
+
+present_bool
+TimestampColumn_sort_parallel(
+        struct TimestampColumn * const self,
+        size_t * const permutation,
+        unsigned int thread_count)
+{
+    present_uint64 * keys;
+    size_t i, size;
+    present_bool success;
+
+    assert(self != NULL);
+
+    /* See DateColumn_sort_parallel (the nanoseconds are never negative, so
+       they are already in order as unsigned keys) */
+    keys = (present_uint64 *) self->seconds_;
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        keys[i] ^= PRESENT_SORT_SIGN_BIT;
+    }
+
+    column_init_permutation(permutation, size);
+    success = present_radix_sort(keys,
+            (present_uint64 *) self->nanoseconds_, 30,
+            permutation, size, thread_count);
+
+    for (i = 0; i < size; i++) {
+        keys[i] ^= PRESENT_SORT_SIGN_BIT;
+    }
+    return success;
+}
+
+size_t
+TimestampColumn_unique(struct TimestampColumn * const self)
+{
+    int_timestamp * seconds;
+    int_timestamp * nanoseconds;
+    size_t i, size, count;
+
+    assert(self != NULL);
+
+    seconds = self->seconds_;
+    nanoseconds = self->nanoseconds_;
+    size = self->size_;
+    if (size == 0) {
+        return 0;
+    }
+
+    count = 1;
+    for (i = 1; i < size; i++) {
+        seconds[count] = seconds[i];
+        nanoseconds[count] = nanoseconds[i];
+        count += (seconds[i] != seconds[count - 1]) |
+            (nanoseconds[i] != nanoseconds[count - 1]);
+    }
+    self->size_ = count;
+    return count;
+}
+
+void
+TimestampColumn_truncate(
+        struct TimestampColumn * const self,
+        int unit,
+        const struct TimeDelta * const time_zone_offset)
+{
+    int_timestamp * const seconds = self->seconds_;
+    int_timestamp * const nanoseconds = self->nanoseconds_;
+    struct Timestamp timestamp, origin;
+    struct TimeDelta width;
+    int_delta width_seconds, width_nanoseconds;
+    int_timestamp origin_seconds;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(time_zone_offset != NULL);
+
+    if (present_truncate_unit_width(unit, &width_seconds,
+                &width_nanoseconds, &origin_seconds)) {
+        /* The origin is at midnight in the time zone */
+        width = width_seconds != 0 ?
+            TimeDelta_from_seconds(width_seconds) :
+            TimeDelta_from_nanoseconds(width_nanoseconds);
+        CLEAR(&origin);
+        origin.data_.timestamp_seconds = origin_seconds;
+        Timestamp_subtract_TimeDelta(&origin, time_zone_offset);
+        timestamp_column_bucket(self, &width, &origin);
+        return;
+    }
+
+    size = self->size_;
+    for (i = 0; i < size; i++) {
+        timestamp = TimestampColumn_get(self, i);
+        timestamp = Timestamp_truncate(&timestamp, unit, time_zone_offset);
+        seconds[i] = timestamp.data_.timestamp_seconds;
+        nanoseconds[i] = timestamp.data_.additional_nanoseconds;
+    }
+}
+
+void
+TimestampColumn_truncate_utc(struct TimestampColumn * const self, int unit)
+{
+    const struct TimeDelta zero = TimeDelta_zero();
+    TimestampColumn_truncate(self, unit, &zero);
+}
+
+void
+TimestampColumn_bucket(
+        struct TimestampColumn * const self,
+        const struct TimeDelta * const width,
+        const struct Timestamp * const origin)
+{
+    assert(self != NULL);
+    assert(width != NULL);
+    assert(width->data_.delta_seconds > 0 ||
+            width->data_.delta_nanoseconds > 0);
+    assert(origin != NULL);
+    assert(origin->has_error == 0);
+
+    timestamp_column_bucket(self, width, origin);
+}
+
+void
+TimestampColumn_get_windows(
+        const struct TimestampColumn * const self,
+        const struct TimeDelta * const size,
+        const struct TimeDelta * const hop,
+        const struct Timestamp * const origin,
+        int_delta * const first,
+        int_delta * const last)
+{
+    const int_timestamp * const seconds = self->seconds_;
+    const int_timestamp * const nanoseconds = self->nanoseconds_;
+    struct column_division first_division, last_division;
+    struct Timestamp end_origin, timestamp;
+    present_int64 remainder;
+    size_t i, column_size;
+
+    assert(self != NULL);
+    assert(size != NULL);
+    assert(size->data_.delta_seconds > 0 ||
+            size->data_.delta_nanoseconds > 0);
+    assert(hop != NULL);
+    assert(hop->data_.delta_seconds > 0 ||
+            hop->data_.delta_nanoseconds > 0);
+    assert(origin != NULL);
+    assert(origin->has_error == 0);
+    assert(first != NULL || self->size_ == 0);
+    assert(last != NULL || self->size_ == 0);
+
+    column_size = self->size_;
+    if (column_size == 0) {
+        return;
+    }
+
+    /* The last window is the bucket (of width hop) that the timestamp is in,
+       and the first window is the one after the bucket that the timestamp
+       is in when the buckets start at the end of window 0 */
+    end_origin = *origin;
+    Timestamp_add_TimeDelta(&end_origin, size);
+    if (column_prepare_division(self, hop->data_.delta_seconds,
+                hop->data_.delta_nanoseconds,
+                origin->data_.timestamp_seconds,
+                origin->data_.additional_nanoseconds, &last_division) &&
+            column_prepare_division(self, hop->data_.delta_seconds,
+                hop->data_.delta_nanoseconds,
+                end_origin.data_.timestamp_seconds,
+                end_origin.data_.additional_nanoseconds, &first_division)) {
+        for (i = 0; i < column_size; i++) {
+            last[i] = column_divide(&last_division, seconds[i],
+                    nanoseconds[i], &remainder);
+            first[i] = column_divide(&first_division, seconds[i],
+                    nanoseconds[i], &remainder) + 1;
+        }
+    } else {
+        for (i = 0; i < column_size; i++) {
+            timestamp = TimestampColumn_get(self, i);
+            Timestamp_get_windows(&timestamp, size, hop, origin,
+                    &first[i], &last[i]);
+        }
+    }
+}
@@ -0,0 +1,718 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the CronSchedule methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <ctype.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "present.h"
+#include "present/internal/format-utils.h"
+
+#include "utils/bit-utils.h"
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/time-utils.h"
+
+/** Number of days in each month (in non-leap years). */
+static const int CRON_DAYS_PER_MONTH[13] = {
+    0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+/** Get the number of days in a month (1 to 12, inclusive) of a year. */
+#define CRON_DAYS_IN_MONTH(year, month)                 \
+    ((IS_LEAP_YEAR(year) && (month) == 2) ? 29 :        \
+     CRON_DAYS_PER_MONTH[month])
+
+/** The number of fields of a 6-field expression. */
+#define CRON_MAX_FIELDS     6
+
+/** The fields of an expression (in the order of a 6-field expression). */
+#define CRON_SECOND         0
+#define CRON_MINUTE         1
+#define CRON_HOUR           2
+#define CRON_DAY_OF_MONTH   3
+#define CRON_MONTH          4
+#define CRON_DAY_OF_WEEK    5
+
+/** The smallest and largest value of each field. */
+static const int CRON_FIELD_MIN[CRON_MAX_FIELDS] = {0, 0, 0, 1, 1, 0};
+static const int CRON_FIELD_MAX[CRON_MAX_FIELDS] = {59, 59, 23, 31, 12, 7};
+
+/** The 3-letter names of the months (from January). */
+static const char * const CRON_MONTH_NAMES[12] = {
+    "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+    "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+};
+
+/** The 3-letter names of the days of the week (from Sunday). */
+static const char * const CRON_DAY_NAMES[7] = {
+    "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"
+};
+
+/** The expressions that "@" names stand for. */
+static const char * const CRON_MACROS[][2] = {
+    {"@yearly",     "0 0 1 1 *"},
+    {"@annually",   "0 0 1 1 *"},
+    {"@monthly",    "0 0 1 * *"},
+    {"@weekly",     "0 0 * * 0"},
+    {"@daily",      "0 0 * * *"},
+    {"@midnight",   "0 0 * * *"},
+    {"@hourly",     "0 * * * *"}
+};
+
+/**
+ * The local date and time that a search for a match is at (in the time zone
+ * offset of the schedule).
+ */
+struct CronPosition {
+    int_delta year;
+    int month, day, hour, minute, second;
+};
+
+/**
+ * Get the lowest set bit of a mask that is at or above @p position, or -1 if
+ * there is none.
+ */
+static PRESENT_INLINE int
+cron_next_bit(present_uint64 mask, int position)
+{
+    if (position < 0) {
+        position = 0;
+    }
+    if (position >= 64) {
+        return -1;
+    }
+    mask &= ~(((present_uint64)1 << position) - 1);
+    if (mask == 0) {
+        return -1;
+    }
+    return present_lowest_bit(mask);
+}
+
+/**
+ * Get the highest set bit of a mask that is at or below @p position, or -1
+ * if there is none.
+ */
+static PRESENT_INLINE int
+cron_prev_bit(present_uint64 mask, int position)
+{
+    if (position < 0) {
+        return -1;
+    }
+    if (position < 63) {
+        mask &= ((present_uint64)1 << (position + 1)) - 1;
+    }
+    if (mask == 0) {
+        return -1;
+    }
+    return present_highest_bit(mask);
+}
+
+/**
+ * Get the days (bit 1 to 31) of a month that match a schedule, from its days
+ * of the month and its days of the week.
+ */
+static present_uint64
+cron_month_days(
+        const struct CronSchedule * const self,
+        int_delta year,
+        int month)
+{
+    const int length = CRON_DAYS_IN_MONTH(year, month);
+    const present_uint64 all = (((present_uint64)1 << length) - 1) << 1;
+    present_uint64 week, week_days;
+    int first_day_of_week;
+
+    /* The day of the week of the 1st (0 for Sunday); January 1, 1970 was a
+       Thursday */
+    first_day_of_week = (int)((to_unix_timestamp((int_year)year,
+                    (int_month)month, 1, 0, 0, 0) / SECONDS_IN_DAY + 4) %
+            DAYS_IN_WEEK);
+    if (first_day_of_week < 0) {
+        first_day_of_week += DAYS_IN_WEEK;
+    }
+
+    /* Rotate the days of the week so that bit i is the day of the week of
+       the (i + 1)th, then repeat it for the 5 weeks of the month */
+    week = (present_uint64)self->days_of_week_;
+    week = ((week | (week << DAYS_IN_WEEK)) >> first_day_of_week) & 0x7F;
+    week_days = (week | (week << 7) | (week << 14) | (week << 21) |
+            (week << 28)) << 1;
+
+    if (self->day_or_) {
+        return (self->days_of_month_ | week_days) & all;
+    }
+    return self->days_of_month_ & week_days & all;
+}
+
+/**
+ * Split the local time of a Timestamp (in the time zone offset of a
+ * schedule) into a date and a time of day, rounded down to the second.
+ *
+ * @return Whether the local time is on a whole second.
+ */
+static present_bool
+cron_position(
+        const struct CronSchedule * const self,
+        const struct Timestamp * const timestamp,
+        struct CronPosition * const position)
+{
+    struct PresentFormatFields fields;
+    int_timestamp seconds;
+    long nanoseconds;
+
+    /* The nanoseconds of a TimeDelta have the same sign as its seconds */
+    seconds = timestamp->data_.timestamp_seconds +
+        self->time_zone_offset_.data_.delta_seconds;
+    nanoseconds = timestamp->data_.additional_nanoseconds +
+        self->time_zone_offset_.data_.delta_nanoseconds;
+    if (nanoseconds >= NANOSECONDS_IN_SECOND) {
+        ++seconds;
+        nanoseconds -= NANOSECONDS_IN_SECOND;
+    } else if (nanoseconds < 0) {
+        --seconds;
+        nanoseconds += NANOSECONDS_IN_SECOND;
+    }
+
+    present_format_timestamp_fields(&fields, seconds, 0, 0);
+    position->year = fields.date.year;
+    position->month = fields.date.month;
+    position->day = fields.date.day;
+    position->hour = (int)(fields.clock_time.seconds / SECONDS_IN_HOUR);
+    position->minute = (int)(fields.clock_time.seconds / SECONDS_IN_MINUTE %
+            60);
+    position->second = (int)(fields.clock_time.seconds % SECONDS_IN_MINUTE);
+    return nanoseconds == 0;
+}
+
+/** Convert a local date and time back to a Timestamp. */
+static struct Timestamp
+cron_timestamp(
+        const struct CronSchedule * const self,
+        const struct CronPosition * const position)
+{
+    struct Timestamp result;
+
+    CLEAR(&result);
+    result.data_.timestamp_seconds = to_unix_timestamp(
+            (int_year)position->year,
+            (int_month)position->month,
+            (int_day)position->day,
+            (int_hour)position->hour,
+            (int_minute)position->minute,
+            (int_second)position->second) -
+        self->time_zone_offset_.data_.delta_seconds;
+    result.data_.additional_nanoseconds =
+        -self->time_zone_offset_.data_.delta_nanoseconds;
+    if (result.data_.additional_nanoseconds >= NANOSECONDS_IN_SECOND) {
+        result.data_.additional_nanoseconds -= NANOSECONDS_IN_SECOND;
+        ++result.data_.timestamp_seconds;
+    } else if (result.data_.additional_nanoseconds < 0) {
+        result.data_.additional_nanoseconds += NANOSECONDS_IN_SECOND;
+        --result.data_.timestamp_seconds;
+    }
+    return result;
+}
+
+/**
+ * Move a position forward to the first time at or after it that matches a
+ * schedule.
+ *
+ * Each step either finds the next matching value of a field (and resets the
+ * fields below it), or, if there is none, moves on to the start of the next
+ * value of the field above it.
+ */
+static void
+cron_search_forward(
+        const struct CronSchedule * const self,
+        struct CronPosition * const p)
+{
+    int next;
+
+    for (;;) {
+        if (p->month > 12) {
+            ++p->year;
+            p->month = 1;
+        }
+        next = cron_next_bit(self->months_, p->month);
+        if (next < 0) {
+            ++p->year;
+            p->month = 1;
+            p->day = 1;
+            p->hour = p->minute = p->second = 0;
+            continue;
+        }
+        if (next != p->month) {
+            p->month = next;
+            p->day = 1;
+            p->hour = p->minute = p->second = 0;
+        }
+
+        next = cron_next_bit(cron_month_days(self, p->year, p->month), p->day);
+        if (next < 0) {
+            ++p->month;
+            p->day = 1;
+            p->hour = p->minute = p->second = 0;
+            continue;
+        }
+        if (next != p->day) {
+            p->day = next;
+            p->hour = p->minute = p->second = 0;
+        }
+
+        next = cron_next_bit(self->hours_, p->hour);
+        if (next < 0) {
+            ++p->day;
+            p->hour = p->minute = p->second = 0;
+            continue;
+        }
+        if (next != p->hour) {
+            p->hour = next;
+            p->minute = p->second = 0;
+        }
+
+        next = cron_next_bit(self->minutes_, p->minute);
+        if (next < 0) {
+            ++p->hour;
+            p->minute = p->second = 0;
+            continue;
+        }
+        if (next != p->minute) {
+            p->minute = next;
+            p->second = 0;
+        }
+
+        next = cron_next_bit(self->seconds_, p->second);
+        if (next < 0) {
+            ++p->minute;
+            p->second = 0;
+            continue;
+        }
+        p->second = next;
+        return;
+    }
+}
+
+/**
+ * Move a position backward to the last time at or before it that matches a
+ * schedule (the mirror image of cron_search_forward).
+ */
+static void
+cron_search_backward(
+        const struct CronSchedule * const self,
+        struct CronPosition * const p)
+{
+    int prev;
+
+    for (;;) {
+        if (p->month < 1) {
+            --p->year;
+            p->month = 12;
+        }
+        prev = cron_prev_bit(self->months_, p->month);
+        if (prev < 0) {
+            --p->year;
+            p->month = 12;
+            p->day = 31;
+            p->hour = 23;
+            p->minute = p->second = 59;
+            continue;
+        }
+        if (prev != p->month) {
+            p->month = prev;
+            p->day = 31;
+            p->hour = 23;
+            p->minute = p->second = 59;
+        }
+
+        prev = cron_prev_bit(cron_month_days(self, p->year, p->month), p->day);
+        if (prev < 0) {
+            --p->month;
+            p->day = 31;
+            p->hour = 23;
+            p->minute = p->second = 59;
+            continue;
+        }
+        if (prev != p->day) {
+            p->day = prev;
+            p->hour = 23;
+            p->minute = p->second = 59;
+        }
+
+        prev = cron_prev_bit(self->hours_, p->hour);
+        if (prev < 0) {
+            --p->day;
+            p->hour = 23;
+            p->minute = p->second = 59;
+            continue;
+        }
+        if (prev != p->hour) {
+            p->hour = prev;
+            p->minute = p->second = 59;
+        }
+
+        prev = cron_prev_bit(self->minutes_, p->minute);
+        if (prev < 0) {
+            --p->hour;
+            p->minute = p->second = 59;
+            continue;
+        }
+        if (prev != p->minute) {
+            p->minute = prev;
+            p->second = 59;
+        }
+
+        prev = cron_prev_bit(self->seconds_, p->second);
+        if (prev < 0) {
+            --p->minute;
+            p->second = 59;
+            continue;
+        }
+        p->second = prev;
+        return;
+    }
+}
+
+/** Add a second to a position (for a search that starts after it). */
+static void
+cron_add_second(struct CronPosition * const p)
+{
+    if (++p->second < 60) {
+        return;
+    }
+    p->second = 0;
+    if (++p->minute < 60) {
+        return;
+    }
+    p->minute = 0;
+    ++p->hour;
+    /* An hour of 24 is handled by the search, like any other overflow */
+}
+
+/*
+ * Parsing
+ */
+
+/**
+ * Parse a value of a field (a number, or a name for the months and the days
+ * of the week) at @p *text, and move past it.
+ *
+ * @return The value, or -1 if there is none.
+ */
+static int
+cron_parse_value(const char ** const text, int field)
+{
+    const char * const * names = NULL;
+    int value = 0, digits = 0, i, j, name_count = 0;
+
+    if (field == CRON_MONTH) {
+        names = CRON_MONTH_NAMES;
+        name_count = 12;
+    } else if (field == CRON_DAY_OF_WEEK) {
+        names = CRON_DAY_NAMES;
+        name_count = 7;
+    }
+    for (i = 0; i < name_count; ++i) {
+        for (j = 0; j < 3 && toupper((unsigned char) (*text)[j]) ==
+                names[i][j]; ++j) {}
+        if (j == 3) {
+            *text += 3;
+            return i + CRON_FIELD_MIN[field];
+        }
+    }
+
+    while (**text >= '0' && **text <= '9') {
+        if (++digits > 2) {
+            return -1;
+        }
+        value = value * 10 + (**text - '0');
+        ++*text;
+    }
+    return digits > 0 ? value : -1;
+}
+
+/**
+ * Parse a field (a list of values and ranges) at @p *text into a mask, and
+ * move past it.
+ *
+ * @param[out] star Whether the field starts with "*" (or "?").
+ * @return 1 on success, or 0 if the field is invalid.
+ */
+static present_bool
+cron_parse_field(
+        const char ** const text,
+        int field,
+        present_uint64 * const mask,
+        present_bool * const star)
+{
+    const int min = CRON_FIELD_MIN[field], max = CRON_FIELD_MAX[field];
+    int first, last, step, value;
+
+    *mask = 0;
+    *star = **text == '*' || **text == '?';
+
+    for (;;) {
+        if (**text == '*' || **text == '?') {
+            ++*text;
+            first = min;
+            last = max;
+        } else {
+            first = last = cron_parse_value(text, field);
+            if (first < min || first > max) {
+                return 0;
+            }
+            if (**text == '-') {
+                ++*text;
+                last = cron_parse_value(text, field);
+                if (last < first || last > max) {
+                    return 0;
+                }
+            } else if (**text == '/') {
+                last = max;
+            }
+        }
+
+        step = 1;
+        if (**text == '/') {
+            ++*text;
+            step = cron_parse_value(text, CRON_SECOND);
+            if (step < 1) {
+                return 0;
+            }
+        }
+        for (value = first; value <= last; value += step) {
+            *mask |= (present_uint64)1 << value;
+        }
+
+        if (**text != ',') {
+            break;
+        }
+        ++*text;
+    }
+    return **text == '\0' || isspace((unsigned char) **text);
+}
+
+/**
+ * Parse an expression into a CronSchedule.
+ *
+ * @return 1 on success, or 0 if the expression is invalid.
+ */
+static present_bool
+cron_parse_expression(
+        struct CronSchedule * const result,
+        const char * text)
+{
+    present_uint64 masks[CRON_MAX_FIELDS];
+    present_bool stars[CRON_MAX_FIELDS];
+    const char * fields[CRON_MAX_FIELDS];
+    const char * p;
+    int field_count = 0, first_field, i;
+
+    for (p = text; *p != '\0';) {
+        while (isspace((unsigned char) *p)) {
+            ++p;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (field_count == CRON_MAX_FIELDS) {
+            return 0;
+        }
+        fields[field_count++] = p;
+        while (*p != '\0' && !isspace((unsigned char) *p)) {
+            ++p;
+        }
+    }
+    if (field_count < CRON_MAX_FIELDS - 1) {
+        return 0;
+    }
+
+    /* Without the seconds, a schedule matches at the start of a minute */
+    first_field = CRON_MAX_FIELDS - field_count;
+    masks[CRON_SECOND] = 1;
+    for (i = first_field; i < CRON_MAX_FIELDS; ++i) {
+        p = fields[i - first_field];
+        if (!cron_parse_field(&p, i, &masks[i], &stars[i])) {
+            return 0;
+        }
+    }
+
+    result->seconds_ = masks[CRON_SECOND];
+    result->minutes_ = masks[CRON_MINUTE];
+    result->hours_ = (present_uint32)masks[CRON_HOUR];
+    result->days_of_month_ = (present_uint32)masks[CRON_DAY_OF_MONTH];
+    result->months_ = (present_uint32)masks[CRON_MONTH];
+    /* Sunday may be 0 or 7 */
+    result->days_of_week_ = (unsigned int)
+        ((masks[CRON_DAY_OF_WEEK] | (masks[CRON_DAY_OF_WEEK] >> 7)) & 0x7F);
+    result->day_or_ = !stars[CRON_DAY_OF_MONTH] && !stars[CRON_DAY_OF_WEEK];
+    return 1;
+}
+
+/**
+ * Determine whether any date could match a schedule. With the days of the
+ * week (or both), every month has a match; otherwise, one of the days of the
+ * month must fit into one of the months (February fits 29 days, in leap
+ * years).
+ */
+static present_bool
+cron_can_match(const struct CronSchedule * const self)
+{
+    int month, longest = 0;
+
+    if (self->days_of_week_ == 0) {
+        return 0;
+    }
+    if (self->day_or_) {
+        return 1;
+    }
+    for (month = 1; month <= 12; ++month) {
+        if (((self->months_ >> month) & 1) &&
+                CRON_DAYS_IN_MONTH(2000, month) > longest) {
+            longest = CRON_DAYS_IN_MONTH(2000, month);
+        }
+    }
+    return (self->days_of_month_ &
+            ((((present_uint64)1 << longest) - 1) << 1)) != 0;
+}
+
+struct CronSchedule
+CronSchedule_from_expression(
+        const char * const expression,
+        const struct TimeDelta * const time_zone_offset)
+{
+    struct CronSchedule result;
+    const char * text = expression;
+    size_t i;
+
+    assert(expression != NULL);
+    assert(time_zone_offset != NULL);
+
+    CLEAR(&result);
+    result.time_zone_offset_ = *time_zone_offset;
+
+    while (isspace((unsigned char) *text)) {
+        ++text;
+    }
+    if (*text == '@') {
+        for (i = 0; i < sizeof(CRON_MACROS) / sizeof(CRON_MACROS[0]); ++i) {
+            if (strcmp(text, CRON_MACROS[i][0]) == 0) {
+                text = CRON_MACROS[i][1];
+                break;
+            }
+        }
+    }
+
+    if (!cron_parse_expression(&result, text)) {
+        result.has_error = 1;
+        result.errors.invalid_expression = 1;
+    } else if (!cron_can_match(&result)) {
+        result.has_error = 1;
+        result.errors.never_matches = 1;
+    }
+    return result;
+}
+
+struct CronSchedule
+CronSchedule_from_expression_utc(const char * const expression)
+{
+    struct TimeDelta offset = TimeDelta_zero();
+    return CronSchedule_from_expression(expression, &offset);
+}
+
+present_bool
+CronSchedule_matches(
+        const struct CronSchedule * const self,
+        const struct Timestamp * const timestamp)
+{
+    struct CronPosition p;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(timestamp != NULL);
+
+    cron_position(self, timestamp, &p);
+    return ((self->seconds_ >> p.second) & 1) &&
+        ((self->minutes_ >> p.minute) & 1) &&
+        ((self->hours_ >> p.hour) & 1) &&
+        ((self->months_ >> p.month) & 1) &&
+        ((cron_month_days(self, p.year, p.month) >> p.day) & 1);
+}
+
+struct Timestamp
+CronSchedule_next_after(
+        const struct CronSchedule * const self,
+        const struct Timestamp * const timestamp)
+{
+    struct CronPosition p;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(timestamp != NULL);
+
+    cron_position(self, timestamp, &p);
+    cron_add_second(&p);
+    cron_search_forward(self, &p);
+    return cron_timestamp(self, &p);
+}
+
+struct Timestamp
+CronSchedule_prev_before(
+        const struct CronSchedule * const self,
+        const struct Timestamp * const timestamp)
+{
+    struct CronPosition p;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(timestamp != NULL);
+
+    /* The second that contains the Timestamp is before it, unless the
+       Timestamp is at its very start */
+    if (cron_position(self, timestamp, &p)) {
+        if (--p.second < 0) {
+            p.second = 59;
+            if (--p.minute < 0) {
+                p.minute = 59;
+                --p.hour;
+            }
+        }
+    }
+    cron_search_backward(self, &p);
+    return cron_timestamp(self, &p);
+}
+
+void
+CronSchedule_batch_next_after(
+        const struct CronSchedule * const schedules,
+        const struct Timestamp * const timestamp,
+        struct Timestamp * const results,
+        size_t count)
+{
+    struct CronPosition start, p;
+    size_t i;
+
+    assert(schedules != NULL || count == 0);
+    assert(timestamp != NULL);
+    assert(results != NULL || count == 0);
+
+    for (i = 0; i < count; ++i) {
+        assert(schedules[i].has_error == 0);
+        if (i == 0 || !TimeDelta_equal(&schedules[i].time_zone_offset_,
+                    &schedules[i - 1].time_zone_offset_)) {
+            cron_position(&schedules[i], timestamp, &start);
+            cron_add_second(&start);
+        }
+        p = start;
+        cron_search_forward(&schedules[i], &p);
+        results[i] = cron_timestamp(&schedules[i], &p);
+    }
+}
+
@@ -9,14 +9,27 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "present.h"
+#include "present/internal/format-utils.h"
 
 #include "utils/constants.h"
 #include "utils/impl-utils.h"
+#include "utils/sort-utils.h"
 #include "utils/time-utils.h"
 
+/** Number of days in each month (in non-leap years). */
+static const int_day DAYS_PER_MONTH[13] = {
+    0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+/** Day of the year before the first of each month (in non-leap years). */
+static const int_day_of_year DAY_OF_START_OF_MONTH[13] = {
+    0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
+};
+
 /**
  * Get the week number of the last week of a given year (either 52 or 53).
  */
@@ -79,6 +92,51 @@ check_date_data(struct PresentDateData * const data)
     }
 }
 
+/**
+ * Get the number of days in a month (1 to 12, inclusive) of a year.
+ */
+static int_day
+days_in_month(int_year year, int_month month)
+{
+    return (IS_LEAP_YEAR(year) && month == 2) ? 29 : DAYS_PER_MONTH[month];
+}
+
+/**
+ * Get the day of the week (1 to 7, inclusive) of a number of days since the
+ * UNIX epoch.
+ */
+static int_day_of_week
+day_of_week_from_days(int_timestamp days_since_epoch)
+{
+    /* Jan. 1, 1970 was a Thursday (adding DAYS_IN_WEEK before the final
+       modulo keeps this correct for negative remainders too) */
+    return (int_day_of_week)(
+            (days_since_epoch % DAYS_IN_WEEK + DAYS_IN_WEEK +
+             DAY_OF_WEEK_THURSDAY - 1) % DAYS_IN_WEEK + 1);
+}
+
+/**
+ * Set day_of_year and day_of_week to their correct values, without calling
+ * into the C standard library.
+ *
+ * Precondition: year, month, and day must already be valid.
+ */
+static void
+fill_date_data(struct PresentDateData * const data)
+{
+    int_timestamp days_since_epoch;
+
+    days_since_epoch = to_unix_timestamp(
+            data->year, data->month, data->day, 0, 0, 0) / SECONDS_IN_DAY;
+
+    data->day_of_year = DAY_OF_START_OF_MONTH[data->month] + data->day;
+    if (IS_LEAP_YEAR(data->year) && data->month > 2) {
+        data->day_of_year += 1;
+    }
+
+    data->day_of_week = day_of_week_from_days(days_since_epoch);
+}
+
 /**
  * Initialize a new Date instance based on its data parameters.
  */
@@ -89,23 +147,13 @@ init_date(
         int_month month,
         int_day day)
 {
-    static const int_day DAYS_PER_MONTH[13] = {
-        0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
-    };
-
-    int_day days_in_month;
-
     assert(result != NULL);
     CLEAR(result);
 
     if (month < 1 || month > 12) {
         result->has_error = 1;
         result->errors.month_out_of_range = 1;
-    }
-
-    days_in_month = (IS_LEAP_YEAR(year) && month == 2) ? 29 :
-        DAYS_PER_MONTH[month];
-    if (day < 1 || day > days_in_month) {
+    } else if (day < 1 || day > days_in_month(year, month)) {
         result->has_error = 1;
         result->errors.day_out_of_range = 1;
     }
@@ -138,6 +186,96 @@ init_date_no_bounds_check(
     check_date_data(&result->data_);
 }
 
+/**
+ * Initialize a new Date instance to the nth occurrence of a day of the week in
+ * a month (see Date_nth_weekday_of_month), without calling into the C
+ * standard library.
+ */
+static void
+init_nth_weekday_of_month(
+        struct Date * const result,
+        int_year year,
+        int_month month,
+        int_day_of_week day_of_week,
+        int n)
+{
+    int_day days, day;
+    int_day_of_week first_day_of_week, last_day_of_week;
+
+    assert(result != NULL);
+    CLEAR(result);
+
+    if (month < 1 || month > 12) {
+        result->has_error = 1;
+        result->errors.month_out_of_range = 1;
+    }
+    if (day_of_week == DAY_OF_WEEK_SUNDAY_COMPAT) {
+        day_of_week = DAY_OF_WEEK_SUNDAY;
+    }
+    if (day_of_week < 1 || day_of_week > 7) {
+        result->has_error = 1;
+        result->errors.day_of_week_out_of_range = 1;
+    }
+    if (n == 0 || n < -5 || n > 5) {
+        result->has_error = 1;
+        result->errors.day_out_of_range = 1;
+    }
+    if (result->has_error) {
+        return;
+    }
+
+    /* Count forward from the first day of the month, or backward from the
+       last day of the month */
+    days = days_in_month(year, month);
+    first_day_of_week = day_of_week_from_days(
+            to_unix_timestamp(year, month, 1, 0, 0, 0) / SECONDS_IN_DAY);
+    if (n > 0) {
+        day = (int_day)(1 +
+                (day_of_week - first_day_of_week + DAYS_IN_WEEK) %
+                DAYS_IN_WEEK + (n - 1) * DAYS_IN_WEEK);
+    } else {
+        last_day_of_week = (int_day_of_week)(
+                (first_day_of_week + days - 2) % DAYS_IN_WEEK + 1);
+        day = (int_day)(days -
+                (last_day_of_week - day_of_week + DAYS_IN_WEEK) %
+                DAYS_IN_WEEK + (n + 1) * DAYS_IN_WEEK);
+    }
+
+    if (day < 1 || day > days) {
+        result->has_error = 1;
+        result->errors.day_out_of_range = 1;
+    } else {
+        result->data_.year = year;
+        result->data_.month = month;
+        result->data_.day = day;
+        fill_date_data(&result->data_);
+    }
+}
+
+/**
+ * Initialize a new Date instance to the last day of a month, without calling
+ * into the C standard library.
+ */
+static void
+init_last_day_of_month(
+        struct Date * const result,
+        int_year year,
+        int_month month)
+{
+    assert(result != NULL);
+    CLEAR(result);
+
+    if (month < 1 || month > 12) {
+        result->has_error = 1;
+        result->errors.month_out_of_range = 1;
+    } else {
+        result->data_.year = year;
+        result->data_.month = month;
+        result->data_.day = days_in_month(year, month);
+        fill_date_data(&result->data_);
+    }
+}
+
 
 struct Date
 Date_from_year(int_year year)
@@ -188,6 +326,63 @@ Date_ptr_from_year_month_day(
     init_date(result, year, month, day);
 }
 
+size_t
+Date_batch_from_year_month_day(
+        const int_year * const years,
+        const int_month * const months,
+        const int_day * const days,
+        struct Date * const results,
+        present_uint64 * const error_mask,
+        size_t count)
+{
+    size_t i, error_count;
+    present_uint64 mask_word;
+    struct Date * result;
+    int_month month;
+
+    assert(years != NULL);
+    assert(months != NULL);
+    assert(days != NULL);
+    assert(results != NULL);
+
+    error_count = 0;
+    mask_word = 0;
+    for (i = 0; i < count; i++) {
+        result = &results[i];
+        month = months[i];
+        CLEAR(result);
+
+        if (month < 1 || month > 12) {
+            result->has_error = 1;
+            result->errors.month_out_of_range = 1;
+        } else {
+            if (days[i] < 1 || days[i] > days_in_month(years[i], month)) {
+                result->has_error = 1;
+                result->errors.day_out_of_range = 1;
+            }
+        }
+
+        if (result->has_error) {
+            error_count++;
+            mask_word |= (present_uint64)1 << (i % 64);
+        } else {
+            result->data_.year = years[i];
+            result->data_.month = month;
+            result->data_.day = days[i];
+            fill_date_data(&result->data_);
+        }
+
+        if (i % 64 == 63 || i == count - 1) {
+            if (error_mask != NULL) {
+                error_mask[i / 64] = mask_word;
+            }
+            mask_word = 0;
+        }
+    }
+
+    return error_count;
+}
+
 struct Date
 Date_from_year_day(int_year year, int_day_of_year day_of_year)
 {
@@ -350,6 +545,186 @@ Date_day_of_week(const struct Date * const self)
     return self->data_.day_of_week;
 }
 
+int_day
+Date_days_in_month(const struct Date * const self)
+{
+    assert(self != NULL);
+    assert(self->has_error == 0);
+
+    return days_in_month(self->data_.year, self->data_.month);
+}
+
+struct Date
+Date_last_day_of_month(const struct Date * const self)
+{
+    struct Date result;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+
+    init_last_day_of_month(&result, self->data_.year, self->data_.month);
+    return result;
+}
+
+struct Date
+Date_nth_weekday_of_month(
+        int_year year,
+        int_month month,
+        int_day_of_week day_of_week,
+        int n)
+{
+    struct Date result;
+    init_nth_weekday_of_month(&result, year, month, day_of_week, n);
+    return result;
+}
+
+void
+Date_ptr_nth_weekday_of_month(
+        struct Date * const result,
+        int_year year,
+        int_month month,
+        int_day_of_week day_of_week,
+        int n)
+{
+    init_nth_weekday_of_month(result, year, month, day_of_week, n);
+}
+
+int_delta
+Date_count_weekday_between(
+        const struct Date * const first,
+        const struct Date * const end,
+        int_day_of_week day_of_week)
+{
+    int_timestamp first_days, end_days;
+
+    assert(first != NULL);
+    assert(first->has_error == 0);
+    assert(end != NULL);
+    assert(end->has_error == 0);
+    assert(day_of_week <= DAY_OF_WEEK_SUNDAY);
+
+    /* Count the days with that day of the week before each date, starting
+       from a day with that day of the week (day 0 was a Thursday) */
+    first_days = DATE_TO_DAYS(first) - (day_of_week - DAY_OF_WEEK_THURSDAY);
+    end_days = DATE_TO_DAYS(end) - (day_of_week - DAY_OF_WEEK_THURSDAY);
+
+    return (int_delta)(FLOOR_DIV(end_days + DAYS_IN_WEEK - 1, DAYS_IN_WEEK) -
+        FLOOR_DIV(first_days + DAYS_IN_WEEK - 1, DAYS_IN_WEEK));
+}
+
+size_t
+Date_batch_nth_weekday_of_month(
+        const int_year * const years,
+        const int_month * const months,
+        int_day_of_week day_of_week,
+        int n,
+        struct Date * const results,
+        present_uint64 * const error_mask,
+        size_t count)
+{
+    size_t i, error_count;
+    present_uint64 mask_word;
+
+    assert(years != NULL);
+    assert(months != NULL);
+    assert(results != NULL);
+
+    error_count = 0;
+    mask_word = 0;
+    for (i = 0; i < count; i++) {
+        init_nth_weekday_of_month(
+                &results[i], years[i], months[i], day_of_week, n);
+        if (results[i].has_error) {
+            error_count++;
+            mask_word |= (present_uint64)1 << (i % 64);
+        }
+
+        if (i % 64 == 63 || i == count - 1) {
+            if (error_mask != NULL) {
+                error_mask[i / 64] = mask_word;
+            }
+            mask_word = 0;
+        }
+    }
+
+    return error_count;
+}
+
+size_t
+Date_batch_last_day_of_month(
+        const int_year * const years,
+        const int_month * const months,
+        struct Date * const results,
+        present_uint64 * const error_mask,
+        size_t count)
+{
+    size_t i, error_count;
+    present_uint64 mask_word;
+
+    assert(years != NULL);
+    assert(months != NULL);
+    assert(results != NULL);
+
+    error_count = 0;
+    mask_word = 0;
+    for (i = 0; i < count; i++) {
+        init_last_day_of_month(&results[i], years[i], months[i]);
+        if (results[i].has_error) {
+            error_count++;
+            mask_word |= (present_uint64)1 << (i % 64);
+        }
+
+        if (i % 64 == 63 || i == count - 1) {
+            if (error_mask != NULL) {
+                error_mask[i / 64] = mask_word;
+            }
+            mask_word = 0;
+        }
+    }
+
+    return error_count;
+}
+
+void
+Date_batch_count_weekday_between(
+        const struct Date * const firsts,
+        const struct Date * const ends,
+        int_day_of_week day_of_week,
+        int_delta * const results,
+        size_t count)
+{
+    size_t i;
+
+    assert(firsts != NULL || count == 0);
+    assert(ends != NULL || count == 0);
+    assert(results != NULL || count == 0);
+
+    for (i = 0; i < count; i++) {
+        results[i] = Date_count_weekday_between(
+                &firsts[i], &ends[i], day_of_week);
+    }
+}
+
+size_t
+Date_format(
+        const struct Date * const self,
+        const char * const format,
+        char * const buffer,
+        size_t buffer_size)
+{
+    struct PresentFormatFields fields;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(format != NULL);
+    assert(buffer != NULL);
+
+    CLEAR(&fields);
+    fields.date = self->data_;
+    return present_format(
+            buffer, buffer_size, format, PRESENT_FORMAT_DATE, &fields);
+}
+
 struct DayDelta
 Date_difference(
         const struct Date * const self,
@@ -460,3 +835,51 @@ Date_compare(
 
 STRUCT_COMPARISON_OPERATORS(Date)
 
+present_bool
+Date_sort(struct Date * const dates, size_t count)
+{
+    present_uint64 * keys;
+    size_t * order;
+    struct Date * copy;
+    size_t i;
+    present_bool success;
+
+    assert(dates != NULL || count == 0);
+
+    if (count < 2) {
+        return 1;
+    }
+
+    keys = (present_uint64 *) malloc(count * sizeof(present_uint64));
+    order = (size_t *) malloc(count * sizeof(size_t));
+    copy = (struct Date *) malloc(count * sizeof(struct Date));
+    success = keys != NULL && order != NULL && copy != NULL;
+
+    if (success) {
+        for (i = 0; i < count; i++) {
+            assert(dates[i].has_error == 0);
+            /* Offsetting the year by 2^31 makes it non-negative, so that
+               the key sorts the same way as an unsigned integer */
+            keys[i] =
+                ((present_uint64)((present_int64)dates[i].data_.year +
+                                  (present_int64)0x80000000UL) << 16) |
+                ((present_uint64)dates[i].data_.month << 8) |
+                (present_uint64)dates[i].data_.day;
+            order[i] = i;
+        }
+        success = present_radix_sort(keys, NULL, 0, order, count, 1);
+    }
+
+    if (success) {
+        memcpy(copy, dates, count * sizeof(struct Date));
+        for (i = 0; i < count; i++) {
+            dates[i] = copy[order[i]];
+        }
+    }
+
+    free(keys);
+    free(order);
+    free(copy);
+    return success;
+}
+
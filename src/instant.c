@@ -0,0 +1,284 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the Instant and Stopwatch methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "present.h"
+
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/time-utils.h"
+#include "utils/tsc-utils.h"
+
+/** Assert that two Instants were read from the same clock. */
+#define ASSERT_SAME_CLOCK(lhs, rhs)             \
+    do {                                        \
+        assert((lhs) != NULL);                  \
+        assert((rhs) != NULL);                  \
+        assert((lhs)->clock_ == (rhs)->clock_); \
+    } while (0)
+
+/** Move an Instant by a number of seconds and nanoseconds. */
+static void
+instant_add(
+        struct Instant * const self,
+        int_timestamp seconds,
+        int_timestamp nanoseconds)
+{
+    self->seconds_ += seconds + nanoseconds / NANOSECONDS_IN_SECOND;
+    self->nanoseconds_ += nanoseconds % NANOSECONDS_IN_SECOND;
+    if (self->nanoseconds_ >= NANOSECONDS_IN_SECOND) {
+        self->nanoseconds_ -= NANOSECONDS_IN_SECOND;
+        ++self->seconds_;
+    } else if (self->nanoseconds_ < 0) {
+        self->nanoseconds_ += NANOSECONDS_IN_SECOND;
+        --self->seconds_;
+    }
+}
+
+/*
+ * Instant
+ */
+
+struct Instant
+Instant_now(void)
+{
+    return Instant_now_from(PRESENT_INSTANT_MONOTONIC);
+}
+
+struct Instant
+Instant_now_from(int clock)
+{
+    struct PresentNowStruct now;
+    struct Instant result;
+
+    assert(clock == PRESENT_INSTANT_MONOTONIC ||
+           clock == PRESENT_INSTANT_MONOTONIC_RAW ||
+           clock == PRESENT_INSTANT_BOOTTIME ||
+           clock == PRESENT_INSTANT_TSC);
+
+    if (clock == PRESENT_INSTANT_TSC) {
+        present_now_tsc(&now);
+    } else {
+        present_now_monotonic(clock, &now);
+    }
+    result.seconds_ = (int_timestamp) now.sec;
+    result.nanoseconds_ = now.nsec;
+    result.clock_ = clock;
+    return result;
+}
+
+int
+Instant_get_clock(const struct Instant * const self)
+{
+    assert(self != NULL);
+    return self->clock_;
+}
+
+struct TimeDelta
+Instant_elapsed(const struct Instant * const self)
+{
+    struct Instant now;
+
+    assert(self != NULL);
+
+    now = Instant_now_from(self->clock_);
+    return Instant_difference(&now, self);
+}
+
+struct TimeDelta
+Instant_difference(
+        const struct Instant * const self,
+        const struct Instant * const other)
+{
+    struct TimeDelta delta, ns_delta;
+
+    ASSERT_SAME_CLOCK(self, other);
+
+    delta = TimeDelta_from_seconds(self->seconds_ - other->seconds_);
+    ns_delta = TimeDelta_from_nanoseconds(
+            self->nanoseconds_ - other->nanoseconds_);
+    TimeDelta_add(&delta, &ns_delta);
+    return delta;
+}
+
+void
+Instant_add_TimeDelta(
+        struct Instant * const self,
+        const struct TimeDelta * const delta)
+{
+    assert(self != NULL);
+    assert(delta != NULL);
+
+    instant_add(self, delta->data_.delta_seconds,
+            delta->data_.delta_nanoseconds);
+}
+
+void
+Instant_subtract_TimeDelta(
+        struct Instant * const self,
+        const struct TimeDelta * const delta)
+{
+    assert(self != NULL);
+    assert(delta != NULL);
+
+    instant_add(self, -delta->data_.delta_seconds,
+            -delta->data_.delta_nanoseconds);
+}
+
+short
+Instant_compare(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs)
+{
+    ASSERT_SAME_CLOCK(lhs, rhs);
+
+    if (lhs->seconds_ != rhs->seconds_) {
+        return lhs->seconds_ < rhs->seconds_ ? -1 : 1;
+    }
+    if (lhs->nanoseconds_ != rhs->nanoseconds_) {
+        return lhs->nanoseconds_ < rhs->nanoseconds_ ? -1 : 1;
+    }
+    return 0;
+}
+
+present_bool
+Instant_equal(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs)
+{
+    return Instant_compare(lhs, rhs) == 0;
+}
+
+present_bool
+Instant_less_than(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs)
+{
+    return Instant_compare(lhs, rhs) < 0;
+}
+
+present_bool
+Instant_less_than_or_equal(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs)
+{
+    return Instant_compare(lhs, rhs) <= 0;
+}
+
+present_bool
+Instant_greater_than(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs)
+{
+    return Instant_compare(lhs, rhs) > 0;
+}
+
+present_bool
+Instant_greater_than_or_equal(
+        const struct Instant * const lhs,
+        const struct Instant * const rhs)
+{
+    return Instant_compare(lhs, rhs) >= 0;
+}
+
+/*
+ * Stopwatch
+ */
+
+struct Stopwatch
+Stopwatch_start(void)
+{
+    struct Stopwatch result;
+    result.start_ = Instant_now();
+    result.elapsed_ = TimeDelta_zero();
+    result.running_ = 1;
+    return result;
+}
+
+struct Stopwatch
+Stopwatch_stopped(void)
+{
+    struct Stopwatch result;
+    CLEAR(&result);
+    result.elapsed_ = TimeDelta_zero();
+    return result;
+}
+
+present_bool
+Stopwatch_is_running(const struct Stopwatch * const self)
+{
+    assert(self != NULL);
+    return self->running_;
+}
+
+struct TimeDelta
+Stopwatch_elapsed(const struct Stopwatch * const self)
+{
+    struct TimeDelta result, running;
+
+    assert(self != NULL);
+
+    result = self->elapsed_;
+    if (self->running_) {
+        running = Instant_elapsed(&self->start_);
+        TimeDelta_add(&result, &running);
+    }
+    return result;
+}
+
+struct TimeDelta
+Stopwatch_stop(struct Stopwatch * const self)
+{
+    assert(self != NULL);
+
+    self->elapsed_ = Stopwatch_elapsed(self);
+    self->running_ = 0;
+    return self->elapsed_;
+}
+
+void
+Stopwatch_resume(struct Stopwatch * const self)
+{
+    assert(self != NULL);
+
+    if (!self->running_) {
+        self->start_ = Instant_now();
+        self->running_ = 1;
+    }
+}
+
+void
+Stopwatch_restart(struct Stopwatch * const self)
+{
+    assert(self != NULL);
+    *self = Stopwatch_start();
+}
+
+struct TimeDelta
+Stopwatch_lap(struct Stopwatch * const self)
+{
+    struct TimeDelta result, running;
+    struct Instant now;
+
+    assert(self != NULL);
+
+    result = self->elapsed_;
+    self->elapsed_ = TimeDelta_zero();
+    if (self->running_) {
+        /* The clock is read once, so that no time is lost between laps */
+        now = Instant_now_from(self->start_.clock_);
+        running = Instant_difference(&now, &self->start_);
+        TimeDelta_add(&result, &running);
+        self->start_ = now;
+    }
+    return result;
+}
+
@@ -0,0 +1,562 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the IntervalSet methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "present.h"
+
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/memory-utils.h"
+#include "utils/sort-utils.h"
+
+/** The alignment (in bytes) of the boundaries of an IntervalSet. */
+#define INTERVAL_SET_ALIGNMENT  64
+
+/*
+ * The operations for interval_set_combine
+ */
+
+#define INTERVAL_SET_UNION          (1)
+#define INTERVAL_SET_INTERSECTION   (2)
+#define INTERVAL_SET_DIFFERENCE     (3)
+
+/** Compare two timestamps (as seconds and nanoseconds): a < b. */
+#define INTERVAL_SET_LESS( \
+        seconds_a, nanoseconds_a, seconds_b, nanoseconds_b) \
+    ((seconds_a) < (seconds_b) || \
+     ((seconds_a) == (seconds_b) && (nanoseconds_a) < (nanoseconds_b)))
+
+/**
+ * Allocate a block of memory for @p capacity boundaries (seconds, followed by
+ * nanoseconds).
+ *
+ * @return The block, or NULL if it could not be allocated.
+ */
+static int_timestamp *
+interval_set_allocate(size_t capacity)
+{
+    if (capacity > (size_t)-1 / 2 / sizeof(int_timestamp)) {
+        return NULL;
+    }
+    return (int_timestamp *) present_aligned_alloc(
+            (capacity > 0 ? 2 * capacity : 1) * sizeof(int_timestamp),
+            INTERVAL_SET_ALIGNMENT);
+}
+
+/**
+ * Replace the boundaries of an IntervalSet with a new block of memory (from
+ * interval_set_allocate) holding @p size boundaries.
+ */
+static void
+interval_set_replace(
+        struct IntervalSet * const self,
+        int_timestamp * const block,
+        size_t capacity,
+        size_t size)
+{
+    present_aligned_free(self->seconds_);
+    self->seconds_ = block;
+    self->nanoseconds_ = block + capacity;
+    self->capacity_ = capacity;
+    self->size_ = size;
+}
+
+/**
+ * Find the number of boundaries of an IntervalSet that are before a
+ * timestamp (given as seconds and nanoseconds).
+ */
+static size_t
+interval_set_search(
+        const struct IntervalSet * const self,
+        int_timestamp seconds,
+        int_timestamp nanoseconds)
+{
+    size_t first = 0, size = self->size_, half;
+
+    while (size > 0) {
+        half = size / 2;
+        if (INTERVAL_SET_LESS(self->seconds_[first + half],
+                    self->nanoseconds_[first + half], seconds, nanoseconds)) {
+            first += half + 1;
+            size -= half + 1;
+        } else {
+            size = half;
+        }
+    }
+    return first;
+}
+
+/**
+ * Replace the contents of an IntervalSet with the union, intersection, or
+ * difference of two IntervalSets.
+ *
+ * This merges the boundaries of the two sets in order, keeping track of
+ * whether each point in time is in each set, and writes a boundary wherever
+ * the result changes. Since both sets are coalesced, there is at most one
+ * boundary of each set at any point in time, and the boundaries that are
+ * written are strictly increasing (so the result is coalesced too).
+ *
+ * @param operation INTERVAL_SET_UNION, INTERVAL_SET_INTERSECTION, or
+ * INTERVAL_SET_DIFFERENCE.
+ */
+static present_bool
+interval_set_combine(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs,
+        int operation)
+{
+    int_timestamp * block;
+    int_timestamp * seconds;
+    int_timestamp * nanoseconds;
+    int_timestamp t_seconds, t_nanoseconds;
+    size_t capacity, i = 0, j = 0, size = 0;
+    int in_lhs = 0, in_rhs = 0, in_result = 0, now;
+
+    assert(self != NULL);
+    assert(lhs != NULL);
+    assert(rhs != NULL);
+
+    capacity = lhs->size_ + rhs->size_;
+    block = interval_set_allocate(capacity);
+    if (block == NULL) {
+        return 0;
+    }
+    seconds = block;
+    nanoseconds = block + capacity;
+
+    while (i < lhs->size_ || j < rhs->size_) {
+        if (j == rhs->size_ || (i < lhs->size_ && INTERVAL_SET_LESS(
+                        lhs->seconds_[i], lhs->nanoseconds_[i],
+                        rhs->seconds_[j], rhs->nanoseconds_[j]))) {
+            t_seconds = lhs->seconds_[i];
+            t_nanoseconds = lhs->nanoseconds_[i];
+        } else {
+            t_seconds = rhs->seconds_[j];
+            t_nanoseconds = rhs->nanoseconds_[j];
+        }
+        if (i < lhs->size_ && lhs->seconds_[i] == t_seconds &&
+                lhs->nanoseconds_[i] == t_nanoseconds) {
+            in_lhs = !in_lhs;
+            i++;
+        }
+        if (j < rhs->size_ && rhs->seconds_[j] == t_seconds &&
+                rhs->nanoseconds_[j] == t_nanoseconds) {
+            in_rhs = !in_rhs;
+            j++;
+        }
+
+        if (operation == INTERVAL_SET_UNION) {
+            now = in_lhs || in_rhs;
+        } else if (operation == INTERVAL_SET_INTERSECTION) {
+            now = in_lhs && in_rhs;
+        } else {
+            now = in_lhs && !in_rhs;
+        }
+        if (now != in_result) {
+            seconds[size] = t_seconds;
+            nanoseconds[size] = t_nanoseconds;
+            size++;
+            in_result = now;
+        }
+    }
+
+    interval_set_replace(self, block, capacity, size);
+    return 1;
+}
+
+void
+IntervalSet_init(struct IntervalSet * const self)
+{
+    assert(self != NULL);
+
+    self->seconds_ = NULL;
+    self->nanoseconds_ = NULL;
+    self->size_ = 0;
+    self->capacity_ = 0;
+}
+
+void
+IntervalSet_destroy(struct IntervalSet * const self)
+{
+    assert(self != NULL);
+
+    present_aligned_free(self->seconds_);
+    IntervalSet_init(self);
+}
+
+present_bool
+IntervalSet_assign(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const other)
+{
+    int_timestamp * block;
+
+    assert(self != NULL);
+    assert(other != NULL);
+
+    if (self == other) {
+        return 1;
+    }
+    if (other->size_ > self->capacity_) {
+        block = interval_set_allocate(other->size_);
+        if (block == NULL) {
+            return 0;
+        }
+        interval_set_replace(self, block, other->size_, 0);
+    }
+    if (other->size_ > 0) {
+        memcpy(self->seconds_, other->seconds_,
+                other->size_ * sizeof(int_timestamp));
+        memcpy(self->nanoseconds_, other->nanoseconds_,
+                other->size_ * sizeof(int_timestamp));
+    }
+    self->size_ = other->size_;
+    return 1;
+}
+
+present_bool
+IntervalSet_assign_intervals(
+        struct IntervalSet * const self,
+        const struct TimeInterval * const intervals,
+        size_t count)
+{
+    present_uint64 * keys;
+    size_t * order;
+    int_timestamp * block;
+    int_timestamp * seconds;
+    int_timestamp * nanoseconds;
+    const struct TimeInterval * interval;
+    size_t capacity, i, size = 0;
+
+    assert(self != NULL);
+    assert(intervals != NULL || count == 0);
+
+    if (count > (size_t)-1 / 2) {
+        return 0;
+    }
+    capacity = 2 * count;
+    block = interval_set_allocate(capacity);
+    keys = (present_uint64 *) malloc(
+            (count > 0 ? 2 * count : 1) * sizeof(present_uint64));
+    order = (size_t *) malloc((count > 0 ? count : 1) * sizeof(size_t));
+    if (block == NULL || keys == NULL || order == NULL) {
+        present_aligned_free(block);
+        free(keys);
+        free(order);
+        return 0;
+    }
+
+    /* Sort the intervals by start */
+    for (i = 0; i < count; i++) {
+        assert(intervals[i].start.has_error == 0);
+        assert(intervals[i].end.has_error == 0);
+        assert(Timestamp_less_than_or_equal(
+                    &intervals[i].start, &intervals[i].end));
+        keys[i] = (present_uint64)
+            intervals[i].start.data_.timestamp_seconds ^ PRESENT_SORT_SIGN_BIT;
+        keys[count + i] = (present_uint64)
+            intervals[i].start.data_.additional_nanoseconds;
+        order[i] = i;
+    }
+    if (!present_radix_sort(keys, keys + count, 30, order, count, 1)) {
+        present_aligned_free(block);
+        free(keys);
+        free(order);
+        return 0;
+    }
+
+    /* Each interval either extends the last one (if it starts at or before
+       the last one's end), or starts a new one */
+    seconds = block;
+    nanoseconds = block + capacity;
+    for (i = 0; i < count; i++) {
+        interval = &intervals[order[i]];
+        if (TimeInterval_is_empty(interval)) {
+            continue;
+        }
+        if (size > 0 && !INTERVAL_SET_LESS(
+                    seconds[size - 1], nanoseconds[size - 1],
+                    interval->start.data_.timestamp_seconds,
+                    interval->start.data_.additional_nanoseconds)) {
+            if (INTERVAL_SET_LESS(
+                        seconds[size - 1], nanoseconds[size - 1],
+                        interval->end.data_.timestamp_seconds,
+                        interval->end.data_.additional_nanoseconds)) {
+                seconds[size - 1] = interval->end.data_.timestamp_seconds;
+                nanoseconds[size - 1] =
+                    interval->end.data_.additional_nanoseconds;
+            }
+        } else {
+            seconds[size] = interval->start.data_.timestamp_seconds;
+            nanoseconds[size] = interval->start.data_.additional_nanoseconds;
+            seconds[size + 1] = interval->end.data_.timestamp_seconds;
+            nanoseconds[size + 1] = interval->end.data_.additional_nanoseconds;
+            size += 2;
+        }
+    }
+
+    free(keys);
+    free(order);
+    interval_set_replace(self, block, capacity, size);
+    return 1;
+}
+
+void
+IntervalSet_clear(struct IntervalSet * const self)
+{
+    assert(self != NULL);
+
+    self->size_ = 0;
+}
+
+present_bool
+IntervalSet_add(
+        struct IntervalSet * const self,
+        const struct TimeInterval * const interval)
+{
+    int_timestamp new_seconds[2], new_nanoseconds[2];
+    int_timestamp * block;
+    size_t first, last, new_count = 0, size, capacity;
+
+    assert(self != NULL);
+    assert(interval != NULL);
+    assert(interval->start.has_error == 0);
+    assert(interval->end.has_error == 0);
+
+    if (TimeInterval_is_empty(interval)) {
+        return 1;
+    }
+
+    /* The boundaries from first to last - 1 are inside the interval (or are
+       an end that meets its start, or a start that meets its end), so they
+       are replaced. If an even number of boundaries are before the start,
+       then the start is not in the set (and it becomes a boundary), and
+       likewise for the end. */
+    first = interval_set_search(self,
+            interval->start.data_.timestamp_seconds,
+            interval->start.data_.additional_nanoseconds);
+    last = interval_set_search(self,
+            interval->end.data_.timestamp_seconds,
+            interval->end.data_.additional_nanoseconds + 1);
+    if (first % 2 == 0) {
+        new_seconds[new_count] = interval->start.data_.timestamp_seconds;
+        new_nanoseconds[new_count] =
+            interval->start.data_.additional_nanoseconds;
+        new_count++;
+    }
+    if (last % 2 == 0) {
+        new_seconds[new_count] = interval->end.data_.timestamp_seconds;
+        new_nanoseconds[new_count] =
+            interval->end.data_.additional_nanoseconds;
+        new_count++;
+    }
+
+    size = self->size_ - (last - first) + new_count;
+    if (size > self->capacity_) {
+        capacity = self->capacity_ * 2 > size ? self->capacity_ * 2 : size;
+        block = interval_set_allocate(capacity);
+        if (block == NULL) {
+            return 0;
+        }
+        if (self->size_ > 0) {
+            memcpy(block, self->seconds_, first * sizeof(int_timestamp));
+            memcpy(block + capacity, self->nanoseconds_,
+                    first * sizeof(int_timestamp));
+            memcpy(block + first + new_count, self->seconds_ + last,
+                    (self->size_ - last) * sizeof(int_timestamp));
+            memcpy(block + capacity + first + new_count,
+                    self->nanoseconds_ + last,
+                    (self->size_ - last) * sizeof(int_timestamp));
+        }
+        interval_set_replace(self, block, capacity, self->size_);
+    } else {
+        memmove(self->seconds_ + first + new_count, self->seconds_ + last,
+                (self->size_ - last) * sizeof(int_timestamp));
+        memmove(self->nanoseconds_ + first + new_count,
+                self->nanoseconds_ + last,
+                (self->size_ - last) * sizeof(int_timestamp));
+    }
+    memcpy(self->seconds_ + first, new_seconds,
+            new_count * sizeof(int_timestamp));
+    memcpy(self->nanoseconds_ + first, new_nanoseconds,
+            new_count * sizeof(int_timestamp));
+    self->size_ = size;
+    return 1;
+}
+
+present_bool
+IntervalSet_union(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs)
+{
+    return interval_set_combine(self, lhs, rhs, INTERVAL_SET_UNION);
+}
+
+present_bool
+IntervalSet_intersection(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs)
+{
+    return interval_set_combine(self, lhs, rhs, INTERVAL_SET_INTERSECTION);
+}
+
+present_bool
+IntervalSet_difference(
+        struct IntervalSet * const self,
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs)
+{
+    return interval_set_combine(self, lhs, rhs, INTERVAL_SET_DIFFERENCE);
+}
+
+size_t
+IntervalSet_count(const struct IntervalSet * const self)
+{
+    assert(self != NULL);
+
+    return self->size_ / 2;
+}
+
+struct TimeInterval
+IntervalSet_get(const struct IntervalSet * const self, size_t index)
+{
+    struct TimeInterval result;
+
+    assert(self != NULL);
+    assert(index < self->size_ / 2);
+
+    CLEAR(&result.start);
+    result.start.data_.timestamp_seconds = self->seconds_[2 * index];
+    result.start.data_.additional_nanoseconds =
+        self->nanoseconds_[2 * index];
+    CLEAR(&result.end);
+    result.end.data_.timestamp_seconds = self->seconds_[2 * index + 1];
+    result.end.data_.additional_nanoseconds =
+        self->nanoseconds_[2 * index + 1];
+    return result;
+}
+
+present_bool
+IntervalSet_contains(
+        const struct IntervalSet * const self,
+        const struct Timestamp * const timestamp)
+{
+    assert(self != NULL);
+    assert(timestamp != NULL);
+    assert(timestamp->has_error == 0);
+
+    /* The timestamp is in the set if an odd number of boundaries are at or
+       before it */
+    return interval_set_search(self, timestamp->data_.timestamp_seconds,
+            timestamp->data_.additional_nanoseconds + 1) % 2 == 1;
+}
+
+struct TimeDelta
+IntervalSet_total_duration(const struct IntervalSet * const self)
+{
+    struct TimeDelta result, nanoseconds_delta;
+    int_timestamp seconds = 0, nanoseconds = 0;
+    size_t i;
+
+    assert(self != NULL);
+
+    /* Each end is added and each start is subtracted (each difference of
+       nanoseconds is less than a second, so their sum does not overflow) */
+    for (i = 0; i < self->size_; i += 2) {
+        seconds += self->seconds_[i + 1] - self->seconds_[i];
+        nanoseconds += self->nanoseconds_[i + 1] - self->nanoseconds_[i];
+    }
+    seconds += nanoseconds / NANOSECONDS_IN_SECOND;
+    nanoseconds %= NANOSECONDS_IN_SECOND;
+    result = TimeDelta_from_seconds(seconds);
+    nanoseconds_delta = TimeDelta_from_nanoseconds(nanoseconds);
+    TimeDelta_add(&result, &nanoseconds_delta);
+    return result;
+}
+
+struct Timestamp
+IntervalSet_find_free_slot(
+        const struct IntervalSet * const self,
+        const struct Timestamp * const after,
+        const struct TimeDelta * const duration)
+{
+    struct Timestamp result;
+    int_timestamp seconds, nanoseconds, end_seconds, end_nanoseconds;
+    size_t next;
+
+    assert(self != NULL);
+    assert(after != NULL);
+    assert(after->has_error == 0);
+    assert(duration != NULL);
+    assert(!TimeDelta_is_negative(duration));
+
+    seconds = after->data_.timestamp_seconds;
+    nanoseconds = after->data_.additional_nanoseconds;
+
+    /* If the time is in an interval, then the first free time is the end of
+       that interval. After that, next is the start of the next interval. */
+    next = interval_set_search(self, seconds, nanoseconds + 1);
+    if (next % 2 == 1) {
+        seconds = self->seconds_[next];
+        nanoseconds = self->nanoseconds_[next];
+        next++;
+    }
+
+    /* Skip the gaps that are too short */
+    while (next < self->size_) {
+        end_seconds = seconds + duration->data_.delta_seconds;
+        end_nanoseconds = nanoseconds + duration->data_.delta_nanoseconds;
+        if (end_nanoseconds >= NANOSECONDS_IN_SECOND) {
+            end_seconds += 1;
+            end_nanoseconds -= NANOSECONDS_IN_SECOND;
+        }
+        if (!INTERVAL_SET_LESS(self->seconds_[next], self->nanoseconds_[next],
+                    end_seconds, end_nanoseconds)) {
+            break;
+        }
+        seconds = self->seconds_[next + 1];
+        nanoseconds = self->nanoseconds_[next + 1];
+        next += 2;
+    }
+
+    CLEAR(&result);
+    result.data_.timestamp_seconds = seconds;
+    result.data_.additional_nanoseconds = nanoseconds;
+    return result;
+}
+
+present_bool
+IntervalSet_equal(
+        const struct IntervalSet * const lhs,
+        const struct IntervalSet * const rhs)
+{
+    size_t i;
+
+    assert(lhs != NULL);
+    assert(rhs != NULL);
+
+    if (lhs->size_ != rhs->size_) {
+        return 0;
+    }
+    for (i = 0; i < lhs->size_; i++) {
+        if (lhs->seconds_[i] != rhs->seconds_[i] ||
+                lhs->nanoseconds_[i] != rhs->nanoseconds_[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
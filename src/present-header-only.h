@@ -0,0 +1,52 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Header file that includes the implementations of all the Present functions
+ * when Present is used in header-only mode (PRESENT_HEADER_ONLY)
+ *
+ * This file is included from "present.h", and is NOT meant to be included
+ * from anywhere else. In header-only mode, Present's "src" directory must be
+ * in the include path (in addition to the "include" directory), and the
+ * program does not need to link to libpresent.
+ *
+ * Every function is defined "static inline" in each translation unit, so any
+ * static state (such as the time set with present_set_test_time) is also
+ * local to each translation unit.
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#ifndef _PRESENT_HEADER_ONLY_H_
+#define _PRESENT_HEADER_ONLY_H_
+
+#include "utils/memory-utils.c"
+#include "utils/sort-utils.c"
+#include "utils/time-utils.c"
+#include "utils/tsc-utils.c"
+
+#include "business-calendar.c"
+#include "clock-page.c"
+#include "clock-source.c"
+#include "clock-time.c"
+#include "column.c"
+#include "cron-schedule.c"
+#include "date.c"
+#include "day-delta.c"
+#include "instant.c"
+#include "interval-set.c"
+#include "month-delta.c"
+#include "range.c"
+#include "recurrence.c"
+#include "time-delta.c"
+#include "time-delta-histogram.c"
+#include "time-index.c"
+#include "time-interval.c"
+#include "timer-wheel.c"
+/* The TimeDelta and Timestamp implementations each define their own
+   CHECK_DATA macro */
+#undef CHECK_DATA
+#include "timestamp.c"
+#undef CHECK_DATA
+
+#endif /* _PRESENT_HEADER_ONLY_H_ */
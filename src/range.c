@@ -0,0 +1,460 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the DateRange and TimestampRange methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "present.h"
+
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/time-utils.h"
+
+/** Number of days in each month (in non-leap years). */
+static const int_day RANGE_DAYS_PER_MONTH[13] = {
+    0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+/** Day of the year before the first of each month (in non-leap years). */
+static const int_day_of_year RANGE_DAY_OF_START_OF_MONTH[13] = {
+    0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
+};
+
+/** Get the number of days in a month (1 to 12, inclusive) of a year. */
+#define RANGE_DAYS_IN_MONTH(year, month)                \
+    ((IS_LEAP_YEAR(year) && (month) == 2) ? 29 :        \
+     RANGE_DAYS_PER_MONTH[month])
+
+/**
+ * The largest day step (in either direction) that DateRangeIterator_next
+ * takes by rolling the month over; since it is no more than the length of
+ * the shortest month, the month never has to be rolled over more than once.
+ */
+#define RANGE_MAX_INCREMENTAL_DAYS  28
+
+/**
+ * Get the days since the UNIX epoch of a day of a month (given as
+ * year * 12 + month - 1). The day may be past the end of the month, in which
+ * case it overflows into the next month.
+ */
+static int_timestamp
+range_month_day_to_days(int_delta month_index, int_day day)
+{
+    int_delta year;
+
+    year = FLOOR_DIV(month_index, 12);
+    return present_date_to_days((int_year)year,
+            (int_month)(month_index - year * 12 + 1), day);
+}
+
+/** Get the days since the UNIX epoch of Date number @p index of a range. */
+static int_timestamp
+range_date_days(const struct DateRange * const self, size_t index)
+{
+    if (self->step_months_ != 0) {
+        return range_month_day_to_days(
+                (int_delta)self->first_.data_.year * 12 +
+                self->first_.data_.month - 1 +
+                (int_delta)index * self->step_months_,
+                self->first_.data_.day);
+    }
+    return DATE_TO_DAYS(&self->first_) +
+        (int_delta)index * self->step_days_;
+}
+
+struct DateRange
+DateRange_from_DayDelta(
+        const struct Date * const first,
+        const struct Date * const end,
+        const struct DayDelta * const step)
+{
+    struct DateRange result;
+
+    assert(first != NULL);
+    assert(first->has_error == 0);
+    assert(end != NULL);
+    assert(end->has_error == 0);
+    assert(step != NULL);
+    assert(step->data_.delta_days != 0);
+
+    result.first_ = *first;
+    result.end_ = *end;
+    result.step_days_ = step->data_.delta_days;
+    result.step_months_ = 0;
+    return result;
+}
+
+struct DateRange
+DateRange_from_MonthDelta(
+        const struct Date * const first,
+        const struct Date * const end,
+        const struct MonthDelta * const step)
+{
+    struct DateRange result;
+
+    assert(first != NULL);
+    assert(first->has_error == 0);
+    assert(end != NULL);
+    assert(end->has_error == 0);
+    assert(step != NULL);
+    assert(step->data_.delta_months != 0);
+
+    result.first_ = *first;
+    result.end_ = *end;
+    result.step_days_ = 0;
+    result.step_months_ = step->data_.delta_months;
+    return result;
+}
+
+size_t
+DateRange_size(const struct DateRange * const self)
+{
+    int_timestamp distance, end_days;
+    int_delta step, count;
+
+    assert(self != NULL);
+
+    end_days = DATE_TO_DAYS(&self->end_);
+    if (self->step_months_ == 0) {
+        /* Flip a backward range around, so that the step is positive */
+        distance = end_days - DATE_TO_DAYS(&self->first_);
+        step = self->step_days_;
+        if (step < 0) {
+            distance = -distance;
+            step = -step;
+        }
+        return distance <= 0 ? 0 : (size_t)((distance + step - 1) / step);
+    }
+
+    /* Estimate the count from the number of months, then correct it (the
+       day of the first Date can move the end by a month either way) */
+    count = ((int_delta)(self->end_.data_.year - self->first_.data_.year) *
+            12 + self->end_.data_.month - self->first_.data_.month) /
+        self->step_months_;
+    if (count < 0) {
+        count = 0;
+    }
+    if (self->step_months_ > 0) {
+        while (range_date_days(self, (size_t)count) < end_days) {
+            count++;
+        }
+        while (count > 0 &&
+                range_date_days(self, (size_t)count - 1) >= end_days) {
+            count--;
+        }
+    } else {
+        while (range_date_days(self, (size_t)count) > end_days) {
+            count++;
+        }
+        while (count > 0 &&
+                range_date_days(self, (size_t)count - 1) <= end_days) {
+            count--;
+        }
+    }
+    return (size_t)count;
+}
+
+struct Date
+DateRange_get(const struct DateRange * const self, size_t index)
+{
+    assert(self != NULL);
+
+    return present_days_to_date(range_date_days(self, index));
+}
+
+size_t
+DateRange_materialize(
+        const struct DateRange * const self,
+        struct Date * const results,
+        size_t capacity)
+{
+    int_timestamp first_days;
+    size_t size, count, i;
+
+    assert(self != NULL);
+    assert(results != NULL || capacity == 0);
+
+    size = DateRange_size(self);
+    count = size < capacity ? size : capacity;
+
+    if (self->step_months_ != 0) {
+        for (i = 0; i < count; i++) {
+            results[i] = present_days_to_date(range_date_days(self, i));
+        }
+        return size;
+    }
+
+    /* Each Date is converted straight from its days since the epoch, with
+       no dependency on the Date before it */
+    first_days = DATE_TO_DAYS(&self->first_);
+    for (i = 0; i < count; i++) {
+        results[i] = present_days_to_date(
+                first_days + (int_delta)i * self->step_days_);
+    }
+    return size;
+}
+
+void
+DateRange_begin(
+        const struct DateRange * const self,
+        struct DateRangeIterator * const iterator)
+{
+    assert(self != NULL);
+    assert(iterator != NULL);
+
+    iterator->current_ = self->first_;
+    iterator->remaining_ = DateRange_size(self);
+    iterator->step_days_ = self->step_days_;
+    iterator->step_months_ = self->step_months_;
+    iterator->month_index_ = (int_delta)self->first_.data_.year * 12 +
+        self->first_.data_.month - 1;
+    iterator->day_ = self->first_.data_.day;
+}
+
+present_bool
+DateRangeIterator_done(const struct DateRangeIterator * const self)
+{
+    assert(self != NULL);
+
+    return self->remaining_ == 0;
+}
+
+struct Date
+DateRangeIterator_get(const struct DateRangeIterator * const self)
+{
+    assert(self != NULL);
+    assert(self->remaining_ > 0);
+
+    return self->current_;
+}
+
+void
+DateRangeIterator_next(struct DateRangeIterator * const self)
+{
+    struct PresentDateData * data;
+    int_delta step;
+
+    assert(self != NULL);
+    assert(self->remaining_ > 0);
+
+    self->remaining_--;
+    if (self->remaining_ == 0) {
+        return;
+    }
+
+    data = &self->current_.data_;
+    step = self->step_days_;
+    if (self->step_months_ != 0) {
+        self->month_index_ += self->step_months_;
+        self->current_ = present_days_to_date(
+                range_month_day_to_days(self->month_index_, self->day_));
+        return;
+    }
+    if (step > RANGE_MAX_INCREMENTAL_DAYS ||
+            step < -RANGE_MAX_INCREMENTAL_DAYS) {
+        self->current_ = present_days_to_date(
+                DATE_TO_DAYS(&self->current_) + step);
+        return;
+    }
+
+    /* Bump the day, and roll the month (and the year) over if it ran past
+       either end of the month */
+    data->day = (int_day)(data->day + step);
+    if (data->day > RANGE_DAYS_IN_MONTH(data->year, data->month)) {
+        data->day = (int_day)(data->day -
+                RANGE_DAYS_IN_MONTH(data->year, data->month));
+        if (data->month == 12) {
+            data->month = 1;
+            data->year++;
+        } else {
+            data->month++;
+        }
+    } else if (data->day < 1) {
+        if (data->month == 1) {
+            data->month = 12;
+            data->year--;
+        } else {
+            data->month--;
+        }
+        data->day = (int_day)(data->day +
+                RANGE_DAYS_IN_MONTH(data->year, data->month));
+    }
+
+    data->day_of_year = (int_day_of_year)(
+            RANGE_DAY_OF_START_OF_MONTH[data->month] + data->day +
+            (IS_LEAP_YEAR(data->year) && data->month > 2));
+    data->day_of_week = (int_day_of_week)(
+            (data->day_of_week - 1 + step % DAYS_IN_WEEK + DAYS_IN_WEEK) %
+            DAYS_IN_WEEK + 1);
+}
+
+struct TimestampRange
+TimestampRange_from_TimeDelta(
+        const struct Timestamp * const first,
+        const struct Timestamp * const end,
+        const struct TimeDelta * const step)
+{
+    struct TimestampRange result;
+
+    assert(first != NULL);
+    assert(first->has_error == 0);
+    assert(end != NULL);
+    assert(end->has_error == 0);
+    assert(step != NULL);
+    assert(step->data_.delta_seconds != 0 ||
+            step->data_.delta_nanoseconds != 0);
+
+    result.first_ = *first;
+    result.end_ = *end;
+    result.step_seconds_ = step->data_.delta_seconds +
+        FLOOR_DIV(step->data_.delta_nanoseconds,
+                NANOSECONDS_IN_SECOND);
+    result.step_nanoseconds_ = FLOOR_MOD(step->data_.delta_nanoseconds,
+            NANOSECONDS_IN_SECOND);
+    return result;
+}
+
+size_t
+TimestampRange_size(const struct TimestampRange * const self)
+{
+    const struct Timestamp * low;
+    const struct Timestamp * high;
+    int_timestamp seconds, nanoseconds, step_seconds, step_nanoseconds;
+
+    assert(self != NULL);
+
+    /* Flip a backward range around, so that the step is positive */
+    step_seconds = self->step_seconds_;
+    step_nanoseconds = self->step_nanoseconds_;
+    low = &self->first_;
+    high = &self->end_;
+    if (step_seconds < 0) {
+        low = &self->end_;
+        high = &self->first_;
+        step_seconds = -step_seconds;
+        if (step_nanoseconds != 0) {
+            step_seconds--;
+            step_nanoseconds = NANOSECONDS_IN_SECOND - step_nanoseconds;
+        }
+    }
+
+    /* The distance, minus 1 nanosecond (so that the floor of its quotient
+       by the step, plus 1, is the ceiling of the distance's quotient) */
+    seconds = high->data_.timestamp_seconds - low->data_.timestamp_seconds;
+    nanoseconds = high->data_.additional_nanoseconds -
+        low->data_.additional_nanoseconds - 1;
+    if (nanoseconds < 0) {
+        seconds--;
+        nanoseconds += NANOSECONDS_IN_SECOND;
+    }
+    if (seconds < 0) {
+        return 0;
+    }
+    return (size_t)present_floor_div_time(
+            seconds, nanoseconds, step_seconds, step_nanoseconds) + 1;
+}
+
+struct Timestamp
+TimestampRange_get(const struct TimestampRange * const self, size_t index)
+{
+    struct Timestamp result;
+    int_timestamp nanoseconds;
+
+    assert(self != NULL);
+
+    nanoseconds = self->first_.data_.additional_nanoseconds +
+        (int_timestamp)index * self->step_nanoseconds_;
+    CLEAR(&result);
+    result.data_.timestamp_seconds = self->first_.data_.timestamp_seconds +
+        (int_timestamp)index * self->step_seconds_ +
+        nanoseconds / NANOSECONDS_IN_SECOND;
+    result.data_.additional_nanoseconds = nanoseconds % NANOSECONDS_IN_SECOND;
+    return result;
+}
+
+size_t
+TimestampRange_materialize(
+        const struct TimestampRange * const self,
+        struct Timestamp * const results,
+        size_t capacity)
+{
+    int_timestamp first_seconds, first_nanoseconds, nanoseconds;
+    size_t size, count, i;
+
+    assert(self != NULL);
+    assert(results != NULL || capacity == 0);
+
+    size = TimestampRange_size(self);
+    count = size < capacity ? size : capacity;
+
+    /* Each Timestamp is calculated straight from its index (the nanoseconds
+       are never negative, so the carry is a plain division) */
+    first_seconds = self->first_.data_.timestamp_seconds;
+    first_nanoseconds = self->first_.data_.additional_nanoseconds;
+    for (i = 0; i < count; i++) {
+        nanoseconds = first_nanoseconds +
+            (int_timestamp)i * self->step_nanoseconds_;
+        CLEAR(&results[i]);
+        results[i].data_.timestamp_seconds = first_seconds +
+            (int_timestamp)i * self->step_seconds_ +
+            nanoseconds / NANOSECONDS_IN_SECOND;
+        results[i].data_.additional_nanoseconds =
+            nanoseconds % NANOSECONDS_IN_SECOND;
+    }
+    return size;
+}
+
+void
+TimestampRange_begin(
+        const struct TimestampRange * const self,
+        struct TimestampRangeIterator * const iterator)
+{
+    assert(self != NULL);
+    assert(iterator != NULL);
+
+    iterator->current_ = self->first_;
+    iterator->remaining_ = TimestampRange_size(self);
+    iterator->step_seconds_ = self->step_seconds_;
+    iterator->step_nanoseconds_ = self->step_nanoseconds_;
+}
+
+present_bool
+TimestampRangeIterator_done(const struct TimestampRangeIterator * const self)
+{
+    assert(self != NULL);
+
+    return self->remaining_ == 0;
+}
+
+struct Timestamp
+TimestampRangeIterator_get(const struct TimestampRangeIterator * const self)
+{
+    assert(self != NULL);
+    assert(self->remaining_ > 0);
+
+    return self->current_;
+}
+
+void
+TimestampRangeIterator_next(struct TimestampRangeIterator * const self)
+{
+    struct PresentTimestampData * data;
+
+    assert(self != NULL);
+    assert(self->remaining_ > 0);
+
+    self->remaining_--;
+    data = &self->current_.data_;
+    data->timestamp_seconds += self->step_seconds_;
+    data->additional_nanoseconds += self->step_nanoseconds_;
+    if (data->additional_nanoseconds >= NANOSECONDS_IN_SECOND) {
+        data->timestamp_seconds++;
+        data->additional_nanoseconds -= NANOSECONDS_IN_SECOND;
+    }
+}
@@ -0,0 +1,1106 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the Recurrence methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <ctype.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "present.h"
+
+#include "utils/bit-utils.h"
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/time-utils.h"
+
+/** The number of words in the mask of the days of a period. */
+#define RECURRENCE_WORDS    PRESENT_RECURRENCE_PERIOD_WORDS
+
+/** Number of days in each month (in non-leap years). */
+static const int_day RECURRENCE_DAYS_PER_MONTH[13] = {
+    0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+/** Day of the year before the first of each month (in non-leap years). */
+static const int_day_of_year RECURRENCE_DAY_OF_START_OF_MONTH[13] = {
+    0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
+};
+
+/** Get the number of days in a month (1 to 12, inclusive) of a year. */
+#define RECURRENCE_DAYS_IN_MONTH(year, month)           \
+    ((IS_LEAP_YEAR(year) && (month) == 2) ? 29 :        \
+     RECURRENCE_DAYS_PER_MONTH[month])
+
+/**
+ * The number of periods of each frequency in the 400-year cycle of the
+ * Gregorian calendar (146,097 days, which is exactly 20,871 weeks). After
+ * this many periods in a row without an occurrence, a rule never has another
+ * one.
+ */
+static const int_delta RECURRENCE_CYCLE_PERIODS[4] = {
+    146097, 20871, 4800, 400
+};
+
+/** The parts of a rule (for finding parts that are given twice). */
+#define RECURRENCE_PART_FREQ        (1U << 0)
+#define RECURRENCE_PART_INTERVAL    (1U << 1)
+#define RECURRENCE_PART_COUNT       (1U << 2)
+#define RECURRENCE_PART_UNTIL       (1U << 3)
+#define RECURRENCE_PART_WKST        (1U << 4)
+#define RECURRENCE_PART_BYMONTH     (1U << 5)
+#define RECURRENCE_PART_BYMONTHDAY  (1U << 6)
+#define RECURRENCE_PART_BYDAY       (1U << 7)
+#define RECURRENCE_PART_BYSETPOS    (1U << 8)
+
+/** The 2-letter names of the days of the week (from Monday), for BYDAY. */
+static const char * const RECURRENCE_DAY_NAMES[7] = {
+    "MO", "TU", "WE", "TH", "FR", "SA", "SU"
+};
+
+/**
+ * Get the day of the week (1 to 7, with 1 being Monday) of a day since the
+ * UNIX epoch (which was a Thursday).
+ */
+static int
+recurrence_day_of_week(int_delta days)
+{
+    return (int)FLOOR_MOD(days + 3, (int_delta)DAYS_IN_WEEK) + 1;
+}
+
+/** Set bit @p bit of the mask of the days of a period. */
+static PRESENT_INLINE void
+recurrence_set_bit(present_uint64 * const days, int_delta bit)
+{
+    days[bit / 64] |= (present_uint64)1 << (bit % 64);
+}
+
+/** Whether a rule has a BYDAY part. */
+static present_bool
+recurrence_has_by_day(const struct Recurrence * const self)
+{
+    int day;
+
+    if (self->by_day_ != 0) {
+        return 1;
+    }
+    for (day = 0; day < DAYS_IN_WEEK; ++day) {
+        if (self->by_day_nth_[day] != 0 ||
+                self->by_day_nth_from_end_[day] != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Set the bits of the days that match the BYDAY part of a rule, in a span of
+ * @p length days (a week, a month, or a year) whose first day is on day of
+ * the week @p first_day_of_week. The numbers in BYDAY count within the span.
+ */
+static void
+recurrence_by_day_days(
+        const struct Recurrence * const self,
+        int first_day_of_week,
+        int_delta length,
+        present_uint64 * const days)
+{
+    present_uint64 nth, nth_from_end;
+    int_delta offset, count, k;
+    int day;
+
+    for (day = 1; day <= DAYS_IN_WEEK; ++day) {
+        const present_bool every = (self->by_day_ >> (day - 1)) & 1;
+        nth = self->by_day_nth_[day - 1];
+        nth_from_end = self->by_day_nth_from_end_[day - 1];
+        if (!every && nth == 0 && nth_from_end == 0) {
+            continue;
+        }
+
+        /* The first of this day of the week in the span, and how many there
+           are */
+        offset = FLOOR_MOD(day - first_day_of_week, DAYS_IN_WEEK);
+        if (offset >= length) {
+            continue;
+        }
+        count = (length - 1 - offset) / DAYS_IN_WEEK + 1;
+
+        for (k = 0; k < count; ++k) {
+            if (every || ((nth >> k) & 1) ||
+                    ((nth_from_end >> (count - 1 - k)) & 1)) {
+                recurrence_set_bit(days, offset + k * DAYS_IN_WEEK);
+            }
+        }
+    }
+}
+
+/**
+ * Get the days of a month (bit 0 for the 1st) that match the BYMONTHDAY part
+ * of a rule (or, if there is neither BYMONTHDAY nor BYDAY, the day of the
+ * month of the start).
+ *
+ * @param by_day_in_month Whether to also match the BYDAY part, with its
+ * numbers counting within the month.
+ */
+static present_uint64
+recurrence_month_days(
+        const struct Recurrence * const self,
+        int_delta year,
+        int month,
+        int_delta first_day,
+        present_bool by_day_in_month)
+{
+    const int length = RECURRENCE_DAYS_IN_MONTH(year, month);
+    const present_uint64 all = ((present_uint64)1 << length) - 1;
+    present_uint64 days = all, month_days, from_end;
+    present_uint64 by_day_days[RECURRENCE_WORDS];
+    const present_bool has_by_day = recurrence_has_by_day(self);
+
+    if (self->by_month_day_ != 0 || self->by_month_day_from_end_ != 0) {
+        month_days = self->by_month_day_;
+        from_end = self->by_month_day_from_end_ & all;
+        while (from_end != 0) {
+            month_days |= (present_uint64)1 <<
+                (length - 1 - present_lowest_bit(from_end));
+            from_end &= from_end - 1;
+        }
+        days &= month_days;
+    } else if (!has_by_day) {
+        days &= self->start_day_of_month_ <= length ?
+            (present_uint64)1 << (self->start_day_of_month_ - 1) : 0;
+    }
+
+    if (by_day_in_month && has_by_day) {
+        memset(by_day_days, 0, sizeof(by_day_days));
+        recurrence_by_day_days(self, recurrence_day_of_week(first_day),
+                length, by_day_days);
+        days &= by_day_days[0];
+    }
+    return days;
+}
+
+/** Keep only the days of a period that are picked by BYSETPOS. */
+static void
+recurrence_apply_set_pos(
+        const struct Recurrence * const self,
+        present_uint64 * const days)
+{
+    present_uint64 picked[RECURRENCE_WORDS], word;
+    int_delta total = 0, index;
+    size_t i;
+    int w;
+
+    for (w = 0; w < RECURRENCE_WORDS; ++w) {
+        total += present_popcount(days[w]);
+    }
+    memset(picked, 0, sizeof(picked));
+
+    for (i = 0; i < self->by_set_pos_count_; ++i) {
+        index = self->by_set_pos_[i] > 0 ?
+            self->by_set_pos_[i] - 1 : total + self->by_set_pos_[i];
+        if (index < 0 || index >= total) {
+            continue;
+        }
+        /* Find the word with day number "index", then the day in it */
+        for (w = 0; index >= present_popcount(days[w]); ++w) {
+            index -= present_popcount(days[w]);
+        }
+        word = days[w];
+        while (index-- > 0) {
+            word &= word - 1;
+        }
+        picked[w] |= word & (~word + 1);
+    }
+    memcpy(days, picked, sizeof(picked));
+}
+
+/**
+ * Build the mask of the days of period number @p period of a rule (counting
+ * from the period of the start), after BYSETPOS.
+ *
+ * @return The first day of the period (in days since the UNIX epoch).
+ */
+static int_delta
+recurrence_period_days(
+        const struct Recurrence * const self,
+        int_delta period,
+        present_uint64 * const days)
+{
+    struct PresentDateData date;
+    int_delta first_day, month_index, year, length, split;
+    present_uint64 month_days, year_days[RECURRENCE_WORDS];
+    unsigned int months;
+    int month, offset, w;
+
+    memset(days, 0, RECURRENCE_WORDS * sizeof(present_uint64));
+
+    switch (self->frequency_) {
+        case PRESENT_RECURRENCE_DAILY:
+            first_day = self->start_day_ + period * self->interval_;
+            date = present_days_to_date(first_day).data_;
+            if (self->by_month_ != 0 &&
+                    !((self->by_month_ >> (date.month - 1)) & 1)) {
+                break;
+            }
+            if (self->by_month_day_ != 0 ||
+                    self->by_month_day_from_end_ != 0) {
+                length = RECURRENCE_DAYS_IN_MONTH(date.year, date.month);
+                if (!((self->by_month_day_ >> (date.day - 1)) & 1) &&
+                        !((self->by_month_day_from_end_ >>
+                                (length - date.day)) & 1)) {
+                    break;
+                }
+            }
+            if (self->by_day_ != 0 &&
+                    !((self->by_day_ >> (date.day_of_week - 1)) & 1)) {
+                break;
+            }
+            days[0] = 1;
+            break;
+
+        case PRESENT_RECURRENCE_WEEKLY:
+            first_day = self->start_day_ - FLOOR_MOD(
+                    recurrence_day_of_week(self->start_day_) -
+                    self->week_start_, DAYS_IN_WEEK) +
+                period * self->interval_ * DAYS_IN_WEEK;
+            recurrence_by_day_days(self, self->week_start_, DAYS_IN_WEEK,
+                    days);
+            if (self->by_month_ != 0) {
+                /* The week may have days from 2 months: the first "split"
+                   days are in the month of its first day */
+                date = present_days_to_date(first_day).data_;
+                split = RECURRENCE_DAYS_IN_MONTH(date.year, date.month) -
+                    date.day + 1;
+                if (!((self->by_month_ >> (date.month - 1)) & 1)) {
+                    days[0] &= split < DAYS_IN_WEEK ?
+                        ~(((present_uint64)1 << split) - 1) : 0;
+                }
+                if (split < DAYS_IN_WEEK &&
+                        !((self->by_month_ >> (date.month % 12)) & 1)) {
+                    days[0] &= ((present_uint64)1 << split) - 1;
+                }
+            }
+            break;
+
+        case PRESENT_RECURRENCE_MONTHLY:
+            month_index = (int_delta)self->start_year_ * 12 +
+                self->start_month_ - 1 + period * self->interval_;
+            year = FLOOR_DIV(month_index, (int_delta)12);
+            month = (int)(month_index - year * 12) + 1;
+            first_day = present_date_to_days(
+                    (int_year)year, (int_month)month, 1);
+            if (self->by_month_ != 0 &&
+                    !((self->by_month_ >> (month - 1)) & 1)) {
+                break;
+            }
+            days[0] = recurrence_month_days(self, year, month, first_day, 1);
+            break;
+
+        default:
+            assert(self->frequency_ == PRESENT_RECURRENCE_YEARLY);
+            year = self->start_year_ + period * self->interval_;
+            first_day = present_date_to_days((int_year)year, 1, 1);
+            if (self->by_month_ != 0) {
+                months = self->by_month_;
+            } else if (self->by_month_day_ != 0 ||
+                    self->by_month_day_from_end_ != 0 ||
+                    recurrence_has_by_day(self)) {
+                months = (1U << 12) - 1;
+            } else {
+                months = 1U << (self->start_month_ - 1);
+            }
+
+            for (month = 1; month <= 12; ++month) {
+                if (!((months >> (month - 1)) & 1)) {
+                    continue;
+                }
+                offset = RECURRENCE_DAY_OF_START_OF_MONTH[month] +
+                    (IS_LEAP_YEAR(year) && month > 2);
+                month_days = recurrence_month_days(self, year, month,
+                        first_day + offset, self->by_month_ != 0);
+                days[offset / 64] |= month_days << (offset % 64);
+                if (offset % 64 > 64 - 31) {
+                    /* The month runs into the next word */
+                    days[offset / 64 + 1] |= month_days >> (64 - offset % 64);
+                }
+            }
+
+            /* Without BYMONTH, the numbers in BYDAY count within the year */
+            if (self->by_month_ == 0 && recurrence_has_by_day(self)) {
+                memset(year_days, 0, sizeof(year_days));
+                recurrence_by_day_days(self, recurrence_day_of_week(first_day),
+                        IS_LEAP_YEAR(year) ? 366 : 365, year_days);
+                for (w = 0; w < RECURRENCE_WORDS; ++w) {
+                    days[w] &= year_days[w];
+                }
+            }
+            break;
+    }
+
+    if (self->by_set_pos_count_ > 0) {
+        recurrence_apply_set_pos(self, days);
+    }
+    return first_day;
+}
+
+/**
+ * Get the number of the period of a rule that contains a day (or 0 if the
+ * day is before the period of the start).
+ */
+static int_delta
+recurrence_period_of_day(const struct Recurrence * const self, int_delta day)
+{
+    struct PresentDateData date;
+    int_delta units;
+
+    switch (self->frequency_) {
+        case PRESENT_RECURRENCE_DAILY:
+            units = day - self->start_day_;
+            break;
+        case PRESENT_RECURRENCE_WEEKLY:
+            units = day - self->start_day_ + FLOOR_MOD(
+                    recurrence_day_of_week(self->start_day_) -
+                    self->week_start_, DAYS_IN_WEEK);
+            units = FLOOR_DIV(units, (int_delta)DAYS_IN_WEEK);
+            break;
+        case PRESENT_RECURRENCE_MONTHLY:
+            date = present_days_to_date(day).data_;
+            units = ((int_delta)date.year - self->start_year_) * 12 +
+                date.month - self->start_month_;
+            break;
+        default:
+            date = present_days_to_date(day).data_;
+            units = (int_delta)date.year - self->start_year_;
+            break;
+    }
+    return units < 0 ? 0 : units / self->interval_;
+}
+
+/**
+ * Count the set bits of the mask of the days of a period from bit @p first
+ * up to (but not including) bit @p end.
+ */
+static int_delta
+recurrence_count_days(
+        const present_uint64 * const days,
+        int_delta first,
+        int_delta end)
+{
+    present_uint64 word;
+    int_delta count = 0, low, high;
+    int w;
+
+    for (w = 0; w < RECURRENCE_WORDS; ++w) {
+        low = first - w * 64;
+        high = end - w * 64;
+        if (high <= 0 || low >= 64) {
+            continue;
+        }
+        word = days[w];
+        if (low > 0) {
+            word &= ~(((present_uint64)1 << low) - 1);
+        }
+        if (high < 64) {
+            word &= ((present_uint64)1 << high) - 1;
+        }
+        count += present_popcount(word);
+    }
+    return count;
+}
+
+/**
+ * Get the first day with an occurrence at or after a Timestamp (if the rule
+ * had an occurrence on every day).
+ */
+static int_delta
+recurrence_first_day_at_or_after(
+        const struct Recurrence * const self,
+        const struct Timestamp * const timestamp)
+{
+    int_delta seconds, nanoseconds, day;
+
+    seconds = timestamp->data_.timestamp_seconds - self->time_seconds_;
+    nanoseconds = timestamp->data_.additional_nanoseconds -
+        self->time_nanoseconds_;
+    if (nanoseconds < 0) {
+        nanoseconds += NANOSECONDS_IN_SECOND;
+        --seconds;
+    }
+    day = FLOOR_DIV(seconds, (int_delta)SECONDS_IN_DAY);
+    if (day * SECONDS_IN_DAY < seconds || nanoseconds > 0) {
+        ++day;
+    }
+    return day;
+}
+
+/**
+ * Get the last day with an occurrence at or before a Timestamp (if the rule
+ * had an occurrence on every day).
+ */
+static int_delta
+recurrence_last_day_at_or_before(
+        const struct Recurrence * const self,
+        const struct Timestamp * const timestamp)
+{
+    int_delta seconds;
+
+    seconds = timestamp->data_.timestamp_seconds - self->time_seconds_;
+    if (timestamp->data_.additional_nanoseconds < self->time_nanoseconds_) {
+        --seconds;
+    }
+    return FLOOR_DIV(seconds, (int_delta)SECONDS_IN_DAY);
+}
+
+/*
+ * Parsing
+ */
+
+/**
+ * If the text at @p *text starts with @p word (ignoring case), move past it
+ * and return 1; otherwise, return 0.
+ */
+static present_bool
+recurrence_match(const char ** const text, const char * word)
+{
+    const char * p = *text;
+
+    for (; *word != '\0'; ++word, ++p) {
+        if (toupper((unsigned char) *p) != *word) {
+            return 0;
+        }
+    }
+    *text = p;
+    return 1;
+}
+
+/**
+ * Parse an integer (with an optional sign) at @p *text, and move past it.
+ *
+ * @return 1 on success, or 0 if there is no integer (or it has more than 9
+ * digits).
+ */
+static present_bool
+recurrence_parse_integer(const char ** const text, int_delta * const value)
+{
+    const char * p = *text;
+    int_delta sign = 1;
+    int digits = 0;
+
+    if (*p == '+' || *p == '-') {
+        sign = *p == '-' ? -1 : 1;
+        ++p;
+    }
+    *value = 0;
+    while (*p >= '0' && *p <= '9') {
+        if (++digits > 9) {
+            return 0;
+        }
+        *value = *value * 10 + (*p - '0');
+        ++p;
+    }
+    if (digits == 0) {
+        return 0;
+    }
+    *value *= sign;
+    *text = p;
+    return 1;
+}
+
+/** Parse exactly @p digits digits at @p *text, and move past them. */
+static present_bool
+recurrence_parse_digits(
+        const char ** const text,
+        int digits,
+        int_delta * const value)
+{
+    *value = 0;
+    for (; digits > 0; --digits, ++*text) {
+        if (**text < '0' || **text > '9') {
+            return 0;
+        }
+        *value = *value * 10 + (**text - '0');
+    }
+    return 1;
+}
+
+/** Whether @p text is at the end of a part of a rule. */
+#define RECURRENCE_END_OF_PART(text)    (*(text) == ';' || *(text) == '\0')
+
+/**
+ * Parse a list of integers from @p min to @p max (other than 0) separated by
+ * commas, calling @p add for each one.
+ */
+static present_bool
+recurrence_parse_list(
+        struct Recurrence * const result,
+        const char ** const text,
+        int_delta min,
+        int_delta max,
+        present_bool (*add)(struct Recurrence * const, int_delta))
+{
+    int_delta value;
+
+    for (;;) {
+        if (!recurrence_parse_integer(text, &value) ||
+                value < min || value > max || value == 0 ||
+                !add(result, value)) {
+            return 0;
+        }
+        if (**text != ',') {
+            return RECURRENCE_END_OF_PART(*text);
+        }
+        ++*text;
+    }
+}
+
+/** Add a BYMONTH value. */
+static present_bool
+recurrence_add_month(struct Recurrence * const result, int_delta month)
+{
+    result->by_month_ |= 1U << (month - 1);
+    return 1;
+}
+
+/** Add a BYMONTHDAY value. */
+static present_bool
+recurrence_add_month_day(struct Recurrence * const result, int_delta day)
+{
+    if (day > 0) {
+        result->by_month_day_ |= (present_uint32)1 << (day - 1);
+    } else {
+        result->by_month_day_from_end_ |= (present_uint32)1 << (-day - 1);
+    }
+    return 1;
+}
+
+/** Add a BYSETPOS value. */
+static present_bool
+recurrence_add_set_pos(struct Recurrence * const result, int_delta position)
+{
+    if (result->by_set_pos_count_ == PRESENT_RECURRENCE_MAX_SET_POS) {
+        return 0;
+    }
+    result->by_set_pos_[result->by_set_pos_count_++] = (int)position;
+    return 1;
+}
+
+/**
+ * Parse a day of the week (a 2-letter name, such as "MO") at @p *text, and
+ * move past it.
+ *
+ * @return The day of the week (1 to 7, with 1 being Monday), or 0 if there is
+ * no day of the week.
+ */
+static int
+recurrence_parse_day_of_week(const char ** const text)
+{
+    int day;
+
+    for (day = 0; day < DAYS_IN_WEEK; ++day) {
+        if (recurrence_match(text, RECURRENCE_DAY_NAMES[day])) {
+            return day + 1;
+        }
+    }
+    return 0;
+}
+
+/** Parse the value of a BYDAY part (such as "MO,WE,-1FR"). */
+static present_bool
+recurrence_parse_by_day(
+        struct Recurrence * const result,
+        const char ** const text)
+{
+    int_delta number;
+    int day;
+
+    for (;;) {
+        number = 0;
+        if (**text == '+' || **text == '-' ||
+                (**text >= '0' && **text <= '9')) {
+            if (!recurrence_parse_integer(text, &number) ||
+                    number == 0 || number < -53 || number > 53) {
+                return 0;
+            }
+        }
+        day = recurrence_parse_day_of_week(text);
+        if (day == 0) {
+            return 0;
+        }
+        if (number == 0) {
+            result->by_day_ |= 1U << (day - 1);
+        } else if (number > 0) {
+            result->by_day_nth_[day - 1] |= (present_uint64)1 << (number - 1);
+        } else {
+            result->by_day_nth_from_end_[day - 1] |=
+                (present_uint64)1 << (-number - 1);
+        }
+        if (**text != ',') {
+            return RECURRENCE_END_OF_PART(*text);
+        }
+        ++*text;
+    }
+}
+
+/**
+ * Parse the value of an UNTIL part (a date, a date-time in the time zone
+ * offset of the start, or a date-time in UTC ending with "Z").
+ */
+static present_bool
+recurrence_parse_until(
+        struct Recurrence * const result,
+        const char ** const text,
+        const struct TimeDelta * const time_zone_offset)
+{
+    int_delta year, month, day, hour, minute, second;
+    struct Date date;
+    struct ClockTime clock_time;
+    struct Timestamp until;
+
+    if (!recurrence_parse_digits(text, 4, &year) ||
+            !recurrence_parse_digits(text, 2, &month) ||
+            !recurrence_parse_digits(text, 2, &day)) {
+        return 0;
+    }
+    date = Date_from_year_month_day(
+            (int_year)year, (int_month)month, (int_day)day);
+    if (date.has_error) {
+        return 0;
+    }
+    result->has_until_ = 1;
+
+    if (RECURRENCE_END_OF_PART(*text)) {
+        result->until_day_ = DATE_TO_DAYS(&date);
+        return 1;
+    }
+
+    if (!recurrence_match(text, "T") ||
+            !recurrence_parse_digits(text, 2, &hour) ||
+            !recurrence_parse_digits(text, 2, &minute) ||
+            !recurrence_parse_digits(text, 2, &second)) {
+        return 0;
+    }
+    clock_time = ClockTime_from_hour_minute_second(
+            (int_hour)hour, (int_minute)minute, (int_second)second);
+    if (clock_time.has_error) {
+        return 0;
+    }
+    if (recurrence_match(text, "Z")) {
+        until = Timestamp_create_utc(&date, &clock_time);
+    } else {
+        until = Timestamp_create(&date, &clock_time, time_zone_offset);
+    }
+    result->until_day_ = recurrence_last_day_at_or_before(result, &until);
+    return RECURRENCE_END_OF_PART(*text);
+}
+
+/**
+ * Parse the parts of a rule into a Recurrence (whose start has already been
+ * set).
+ *
+ * @return 1 on success, or 0 if the rule is invalid or unsupported (in which
+ * case the Recurrence has its errors set).
+ */
+static present_bool
+recurrence_parse_rule(
+        struct Recurrence * const result,
+        const char * text,
+        const struct TimeDelta * const time_zone_offset)
+{
+    unsigned int parts = 0, part;
+    present_bool ok = 1, has_nth = 0;
+    int day;
+
+    (void) recurrence_match(&text, "RRULE:");
+
+    while (*text != '\0') {
+        if (recurrence_match(&text, "FREQ=")) {
+            part = RECURRENCE_PART_FREQ;
+            if (recurrence_match(&text, "DAILY")) {
+                result->frequency_ = PRESENT_RECURRENCE_DAILY;
+            } else if (recurrence_match(&text, "WEEKLY")) {
+                result->frequency_ = PRESENT_RECURRENCE_WEEKLY;
+            } else if (recurrence_match(&text, "MONTHLY")) {
+                result->frequency_ = PRESENT_RECURRENCE_MONTHLY;
+            } else if (recurrence_match(&text, "YEARLY")) {
+                result->frequency_ = PRESENT_RECURRENCE_YEARLY;
+            } else if (recurrence_match(&text, "SECONDLY") ||
+                    recurrence_match(&text, "MINUTELY") ||
+                    recurrence_match(&text, "HOURLY")) {
+                result->errors.unsupported_rule = 1;
+                return 0;
+            } else {
+                ok = 0;
+            }
+            ok = ok && RECURRENCE_END_OF_PART(text);
+        } else if (recurrence_match(&text, "INTERVAL=")) {
+            part = RECURRENCE_PART_INTERVAL;
+            ok = recurrence_parse_integer(&text, &result->interval_) &&
+                result->interval_ > 0 && RECURRENCE_END_OF_PART(text);
+        } else if (recurrence_match(&text, "COUNT=")) {
+            part = RECURRENCE_PART_COUNT;
+            ok = recurrence_parse_integer(&text, &result->count_) &&
+                result->count_ > 0 && RECURRENCE_END_OF_PART(text);
+        } else if (recurrence_match(&text, "UNTIL=")) {
+            part = RECURRENCE_PART_UNTIL;
+            ok = recurrence_parse_until(result, &text, time_zone_offset);
+        } else if (recurrence_match(&text, "WKST=")) {
+            part = RECURRENCE_PART_WKST;
+            result->week_start_ = recurrence_parse_day_of_week(&text);
+            ok = result->week_start_ != 0 && RECURRENCE_END_OF_PART(text);
+        } else if (recurrence_match(&text, "BYMONTH=")) {
+            part = RECURRENCE_PART_BYMONTH;
+            ok = recurrence_parse_list(result, &text, 1, 12,
+                    &recurrence_add_month);
+        } else if (recurrence_match(&text, "BYMONTHDAY=")) {
+            part = RECURRENCE_PART_BYMONTHDAY;
+            ok = recurrence_parse_list(result, &text, -31, 31,
+                    &recurrence_add_month_day);
+        } else if (recurrence_match(&text, "BYDAY=")) {
+            part = RECURRENCE_PART_BYDAY;
+            ok = recurrence_parse_by_day(result, &text);
+        } else if (recurrence_match(&text, "BYSETPOS=")) {
+            part = RECURRENCE_PART_BYSETPOS;
+            ok = recurrence_parse_list(result, &text, -366, 366,
+                    &recurrence_add_set_pos);
+        } else if (recurrence_match(&text, "BYSECOND=") ||
+                recurrence_match(&text, "BYMINUTE=") ||
+                recurrence_match(&text, "BYHOUR=") ||
+                recurrence_match(&text, "BYYEARDAY=") ||
+                recurrence_match(&text, "BYWEEKNO=")) {
+            result->errors.unsupported_rule = 1;
+            return 0;
+        } else {
+            ok = 0;
+            part = 0;
+        }
+
+        if (!ok || (parts & part)) {
+            result->errors.invalid_rule = 1;
+            return 0;
+        }
+        parts |= part;
+        if (*text == ';') {
+            ++text;
+        }
+    }
+
+    for (day = 0; day < DAYS_IN_WEEK; ++day) {
+        has_nth = has_nth || result->by_day_nth_[day] != 0 ||
+            result->by_day_nth_from_end_[day] != 0;
+    }
+
+    /* FREQ is required; COUNT and UNTIL may not both be given; BYMONTHDAY
+       may not be used with WEEKLY; BYDAY may only have numbers with MONTHLY
+       and YEARLY; and BYSETPOS needs another BYxxx part */
+    if (!(parts & RECURRENCE_PART_FREQ) ||
+            ((parts & RECURRENCE_PART_COUNT) &&
+             (parts & RECURRENCE_PART_UNTIL)) ||
+            (result->frequency_ == PRESENT_RECURRENCE_WEEKLY &&
+             (parts & RECURRENCE_PART_BYMONTHDAY)) ||
+            (has_nth && result->frequency_ != PRESENT_RECURRENCE_MONTHLY &&
+             result->frequency_ != PRESENT_RECURRENCE_YEARLY) ||
+            ((parts & RECURRENCE_PART_BYSETPOS) &&
+             !(parts & (RECURRENCE_PART_BYMONTH | RECURRENCE_PART_BYMONTHDAY |
+                        RECURRENCE_PART_BYDAY)))) {
+        result->errors.invalid_rule = 1;
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Iteration
+ */
+
+/** Build the mask of the days of the current period of an iteration. */
+static void
+recurrence_load_period(struct RecurrenceIterator * const self)
+{
+    const struct Recurrence * const recurrence = self->recurrence_;
+
+    self->period_first_day_ = recurrence_period_days(
+            recurrence, self->period_, self->days_);
+    if ((recurrence->has_until_ &&
+                self->period_first_day_ > recurrence->until_day_) ||
+            (self->has_end_ && self->period_first_day_ >= self->end_day_)) {
+        self->done_ = 1;
+    }
+}
+
+/**
+ * Determine whether the occurrence on a day is excluded (by EXDATE), moving
+ * past the excluded occurrences that are before it.
+ */
+static present_bool
+recurrence_is_excluded(struct RecurrenceIterator * const self, int_delta day)
+{
+    const struct Recurrence * const recurrence = self->recurrence_;
+    const int_timestamp seconds =
+        day * SECONDS_IN_DAY + recurrence->time_seconds_;
+    const struct Timestamp * exdate;
+
+    for (; self->exdate_index_ < recurrence->exdate_count_;
+            ++self->exdate_index_) {
+        exdate = &recurrence->exdates_[self->exdate_index_];
+        if (exdate->data_.timestamp_seconds > seconds ||
+                (exdate->data_.timestamp_seconds == seconds &&
+                 exdate->data_.additional_nanoseconds >=
+                 recurrence->time_nanoseconds_)) {
+            return exdate->data_.timestamp_seconds == seconds &&
+                exdate->data_.additional_nanoseconds ==
+                recurrence->time_nanoseconds_;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Get the day of the next occurrence of an iteration.
+ *
+ * @return 1 on success, or 0 if there are no more occurrences.
+ */
+static present_bool
+recurrence_next_day(
+        struct RecurrenceIterator * const self,
+        int_delta * const day)
+{
+    const struct Recurrence * const recurrence = self->recurrence_;
+    int_delta candidate, periods = 0;
+    int w;
+
+    while (!self->done_) {
+        for (w = 0; w < RECURRENCE_WORDS && self->days_[w] == 0; ++w) {}
+
+        if (w == RECURRENCE_WORDS) {
+            /* The period is used up; move on to the next one */
+            if (++periods >
+                    RECURRENCE_CYCLE_PERIODS[recurrence->frequency_]) {
+                self->done_ = 1;
+                break;
+            }
+            ++self->period_;
+            recurrence_load_period(self);
+            continue;
+        }
+
+        candidate = self->period_first_day_ + w * 64 +
+            present_lowest_bit(self->days_[w]);
+        self->days_[w] &= self->days_[w] - 1;
+
+        if (candidate < recurrence->start_day_) {
+            continue;
+        }
+        if ((recurrence->has_until_ && candidate > recurrence->until_day_) ||
+                (self->has_end_ && candidate >= self->end_day_)) {
+            self->done_ = 1;
+            break;
+        }
+        ++self->generated_;
+        if (recurrence->count_ > 0 &&
+                self->generated_ == recurrence->count_) {
+            self->done_ = 1;
+        }
+        if (candidate < self->from_day_ ||
+                recurrence_is_excluded(self, candidate)) {
+            continue;
+        }
+        *day = candidate;
+        return 1;
+    }
+    return 0;
+}
+
+struct Recurrence
+Recurrence_from_rule(
+        const struct Date * const start,
+        const struct ClockTime * const time,
+        const struct TimeDelta * const time_zone_offset,
+        const char * const rule)
+{
+    struct Recurrence result;
+
+    assert(start != NULL);
+    assert(time != NULL);
+    assert(time_zone_offset != NULL);
+    assert(rule != NULL);
+
+    CLEAR(&result);
+    if (start->has_error || time->has_error) {
+        result.has_error = 1;
+        result.errors.invalid_start = 1;
+        return result;
+    }
+
+    result.interval_ = 1;
+    result.start_year_ = start->data_.year;
+    result.start_month_ = start->data_.month;
+    result.start_day_of_month_ = start->data_.day;
+    result.start_day_ = DATE_TO_DAYS(start);
+    result.time_seconds_ = time->data_.seconds -
+        time_zone_offset->data_.delta_seconds;
+    result.time_nanoseconds_ = time->data_.nanoseconds -
+        time_zone_offset->data_.delta_nanoseconds;
+    if (result.time_nanoseconds_ < 0) {
+        result.time_nanoseconds_ += NANOSECONDS_IN_SECOND;
+        --result.time_seconds_;
+    }
+    result.week_start_ = DAY_OF_WEEK_MONDAY;
+
+    if (!recurrence_parse_rule(&result, rule, time_zone_offset)) {
+        result.has_error = 1;
+        return result;
+    }
+
+    /* Without a BYDAY, a WEEKLY rule is on the day of the week of the
+       start */
+    if (result.frequency_ == PRESENT_RECURRENCE_WEEKLY &&
+            result.by_day_ == 0) {
+        result.by_day_ = 1U << (recurrence_day_of_week(result.start_day_) - 1);
+    }
+    return result;
+}
+
+void
+Recurrence_set_exdates(
+        struct Recurrence * const self,
+        const struct Timestamp * const exdates,
+        size_t exdate_count)
+{
+    assert(self != NULL);
+    assert(exdates != NULL || exdate_count == 0);
+
+    self->exdates_ = exdates;
+    self->exdate_count_ = exdate_count;
+}
+
+void
+Recurrence_begin(
+        const struct Recurrence * const self,
+        const struct Timestamp * const from,
+        const struct Timestamp * const end,
+        struct RecurrenceIterator * const iterator)
+{
+    present_uint64 days[RECURRENCE_WORDS];
+    int_delta period, p, first_day, last;
+    size_t low, high, middle;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(from != NULL);
+    assert(iterator != NULL);
+
+    CLEAR(iterator);
+    iterator->recurrence_ = self;
+    iterator->from_day_ = recurrence_first_day_at_or_after(self, from);
+    if (iterator->from_day_ < self->start_day_) {
+        iterator->from_day_ = self->start_day_;
+    }
+    if (end != NULL) {
+        iterator->has_end_ = 1;
+        iterator->end_day_ = recurrence_first_day_at_or_after(self, end);
+    }
+
+    /* Jump to the period that contains the start of the window; with a
+       COUNT, the occurrences in the periods before it still count */
+    period = recurrence_period_of_day(self, iterator->from_day_);
+    if (self->count_ > 0) {
+        for (p = 0; p < period; ++p) {
+            first_day = recurrence_period_days(self, p, days);
+            last = self->has_until_ ?
+                self->until_day_ + 1 - first_day : RECURRENCE_WORDS * 64;
+            iterator->generated_ += recurrence_count_days(
+                    days, self->start_day_ - first_day, last);
+            if (iterator->generated_ >= self->count_) {
+                iterator->done_ = 1;
+                return;
+            }
+        }
+    }
+    iterator->period_ = period;
+    recurrence_load_period(iterator);
+
+    /* Skip the excluded occurrences before the window (with a binary
+       search) */
+    low = 0;
+    high = self->exdate_count_;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (recurrence_first_day_at_or_after(self, &self->exdates_[middle]) <
+                iterator->from_day_) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    iterator->exdate_index_ = low;
+}
+
+size_t
+Recurrence_expand(
+        const struct Recurrence * const self,
+        const struct Timestamp * const from,
+        const struct Timestamp * const end,
+        struct Timestamp * const results,
+        size_t capacity)
+{
+    struct RecurrenceIterator iterator;
+
+    Recurrence_begin(self, from, end, &iterator);
+    return RecurrenceIterator_next_timestamps(&iterator, results, capacity);
+}
+
+present_bool
+RecurrenceIterator_done(const struct RecurrenceIterator * const self)
+{
+    assert(self != NULL);
+
+    return self->done_;
+}
+
+size_t
+RecurrenceIterator_next_timestamps(
+        struct RecurrenceIterator * const self,
+        struct Timestamp * const results,
+        size_t capacity)
+{
+    int_delta day;
+    size_t count;
+
+    assert(self != NULL);
+    assert(results != NULL || capacity == 0);
+
+    for (count = 0; count < capacity && recurrence_next_day(self, &day);
+            ++count) {
+        CLEAR(&results[count]);
+        results[count].data_.timestamp_seconds =
+            day * SECONDS_IN_DAY + self->recurrence_->time_seconds_;
+        results[count].data_.additional_nanoseconds =
+            self->recurrence_->time_nanoseconds_;
+    }
+    return count;
+}
+
+size_t
+RecurrenceIterator_next_dates(
+        struct RecurrenceIterator * const self,
+        struct Date * const results,
+        size_t capacity)
+{
+    int_delta day;
+    size_t count;
+
+    assert(self != NULL);
+    assert(results != NULL || capacity == 0);
+
+    for (count = 0; count < capacity && recurrence_next_day(self, &day);
+            ++count) {
+        results[count] = present_days_to_date(day);
+    }
+    return count;
+}
+
@@ -0,0 +1,673 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimeDeltaHistogram methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "present.h"
+
+#include "utils/bit-utils.h"
+#include "utils/constants.h"
+#include "utils/memory-utils.h"
+
+/** The alignment (in bytes) of the counters of a TimeDeltaHistogram. */
+#define HISTOGRAM_ALIGNMENT     64
+
+/**
+ * The largest number of nanoseconds (which is also the min of a
+ * TimeDeltaHistogram with no values).
+ */
+#define HISTOGRAM_MAX_NANOSECONDS \
+    ((present_int64) (((present_uint64)1 << 63) - 1))
+
+/** The highest value that a TimeDeltaHistogram can be configured with. */
+#define HISTOGRAM_MAX_HIGHEST_SECONDS \
+    ((present_int64)200 * 366 * SECONDS_IN_DAY)
+
+/** The version of the binary form written by TimeDeltaHistogram_serialize. */
+#define HISTOGRAM_FORMAT_VERSION    1
+
+/** The most bytes in a variable-length integer (for 64 bits). */
+#define HISTOGRAM_MAX_VARINT_LENGTH 10
+
+/**
+ * Get the index of the bucket for a (non-negative) value in nanoseconds.
+ *
+ * Values below 2^(precision + 1) are their own index. Above that, the value
+ * is shifted right until it has precision + 1 bits, and the shift (which is
+ * one more for each power of 2) picks the group of 2^precision buckets.
+ */
+static PRESENT_INLINE size_t
+histogram_index(present_uint64 value, int precision)
+{
+    int shift = present_highest_bit(value | 1) - precision;
+    if (shift < 0) {
+        shift = 0;
+    }
+    return ((size_t)shift << precision) + (size_t)(value >> shift);
+}
+
+/**
+ * Get the smallest value (in nanoseconds) in a bucket.
+ */
+static present_int64
+histogram_bucket_low(size_t index, int precision)
+{
+    size_t shift;
+    if (index < ((size_t)2 << precision)) {
+        return (present_int64)index;
+    }
+    shift = (index >> precision) - 1;
+    return (present_int64)
+        ((present_uint64)(index - (shift << precision)) << shift);
+}
+
+/**
+ * Get the number of values (in nanoseconds) in a bucket.
+ */
+static present_int64
+histogram_bucket_width(size_t index, int precision)
+{
+    if (index < ((size_t)2 << precision)) {
+        return 1;
+    }
+    return (present_int64)1 << ((index >> precision) - 1);
+}
+
+/**
+ * Get the value (in nanoseconds) that a bucket is reported as: its
+ * midpoint, limited to the min and max of the histogram.
+ */
+static present_int64
+histogram_bucket_value(
+        const struct TimeDeltaHistogram * const self,
+        size_t index)
+{
+    present_int64 value = histogram_bucket_low(index, self->precision_) +
+        histogram_bucket_width(index, self->precision_) / 2;
+    if (value < self->min_) {
+        value = self->min_;
+    }
+    if (value > self->max_) {
+        value = self->max_;
+    }
+    return value;
+}
+
+/**
+ * Convert a TimeDelta to nanoseconds, limited to the range of values that a
+ * TimeDeltaHistogram records (negative values become 0).
+ */
+static PRESENT_INLINE present_int64
+histogram_nanoseconds(const struct TimeDelta * const value)
+{
+    if (value->data_.delta_seconds < 0 || value->data_.delta_nanoseconds < 0) {
+        return 0;
+    }
+    if (value->data_.delta_seconds >=
+            HISTOGRAM_MAX_NANOSECONDS / NANOSECONDS_IN_SECOND) {
+        return HISTOGRAM_MAX_NANOSECONDS;
+    }
+    return value->data_.delta_seconds * NANOSECONDS_IN_SECOND +
+        value->data_.delta_nanoseconds;
+}
+
+/**
+ * Record a value (in nanoseconds) @p count times.
+ */
+static PRESENT_INLINE void
+histogram_record(
+        struct TimeDeltaHistogram * const self,
+        present_int64 nanoseconds,
+        present_uint64 count)
+{
+    size_t index;
+
+    assert(self->counts_ != NULL);
+    if (count == 0) {
+        return;
+    }
+
+    index = histogram_index((present_uint64)nanoseconds, self->precision_);
+    if (index >= self->bucket_count_) {
+        index = self->bucket_count_ - 1;
+    }
+    self->counts_[index] += count;
+    self->total_count_ += count;
+    if (nanoseconds < self->min_) {
+        self->min_ = nanoseconds;
+    }
+    if (nanoseconds > self->max_) {
+        self->max_ = nanoseconds;
+    }
+}
+
+/**
+ * Allocate the (zeroed) counters for a histogram.
+ */
+static present_uint64 *
+histogram_allocate(size_t bucket_count)
+{
+    present_uint64 * counts;
+
+    if (bucket_count > (size_t)-1 / sizeof(present_uint64)) {
+        return NULL;
+    }
+    counts = (present_uint64 *) present_aligned_alloc(
+            bucket_count * sizeof(present_uint64), HISTOGRAM_ALIGNMENT);
+    if (counts != NULL) {
+        memset(counts, 0, bucket_count * sizeof(present_uint64));
+    }
+    return counts;
+}
+
+/**
+ * Replace the counters and configuration of a histogram (which is left with
+ * no values).
+ *
+ * This works on the fields directly rather than on a temporary struct
+ * TimeDeltaHistogram, since in C++ (including when this file is compiled as
+ * C++) that would run the TimeDeltaHistogram constructor, destructor, and
+ * assignment operator.
+ */
+static void
+histogram_replace(
+        struct TimeDeltaHistogram * const self,
+        present_uint64 * counts,
+        size_t bucket_count,
+        int precision,
+        present_int64 highest)
+{
+    present_aligned_free(self->counts_);
+    self->counts_ = counts;
+    self->bucket_count_ = bucket_count;
+    self->precision_ = precision;
+    self->highest_ = highest;
+    self->total_count_ = 0;
+    self->min_ = HISTOGRAM_MAX_NANOSECONDS;
+    self->max_ = 0;
+}
+
+/**
+ * Write a variable-length integer (7 bits per byte, with the high bit set on
+ * every byte but the last) at @p position, if it fits in the buffer.
+ *
+ * @return The position after the integer.
+ */
+static size_t
+histogram_write_varint(
+        unsigned char * const buffer,
+        size_t buffer_size,
+        size_t position,
+        present_uint64 value)
+{
+    do {
+        unsigned char byte = (unsigned char)(value & 0x7F);
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        if (position < buffer_size) {
+            buffer[position] = byte;
+        }
+        ++position;
+    } while (value != 0);
+    return position;
+}
+
+/**
+ * Read a variable-length integer (see histogram_write_varint), advancing
+ * @p position past it.
+ *
+ * @return 1 on success, or 0 if the buffer ends first or the integer is too
+ * long.
+ */
+static present_bool
+histogram_read_varint(
+        const unsigned char * const buffer,
+        size_t size,
+        size_t * const position,
+        present_uint64 * const value)
+{
+    int length = 0;
+
+    *value = 0;
+    while (*position < size && length < HISTOGRAM_MAX_VARINT_LENGTH) {
+        const unsigned char byte = buffer[(*position)++];
+        *value |= (present_uint64)(byte & 0x7F) << (7 * length);
+        ++length;
+        if ((byte & 0x80) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * PUBLIC FUNCTIONS
+ */
+
+void
+TimeDeltaHistogram_init(struct TimeDeltaHistogram * const self)
+{
+    assert(self != NULL);
+
+    self->counts_ = NULL;
+    self->bucket_count_ = 0;
+    self->precision_ = 0;
+    self->highest_ = 0;
+    self->total_count_ = 0;
+    self->min_ = HISTOGRAM_MAX_NANOSECONDS;
+    self->max_ = 0;
+}
+
+void
+TimeDeltaHistogram_destroy(struct TimeDeltaHistogram * const self)
+{
+    assert(self != NULL);
+
+    present_aligned_free(self->counts_);
+    TimeDeltaHistogram_init(self);
+}
+
+present_bool
+TimeDeltaHistogram_configure(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDelta * const highest,
+        int precision)
+{
+    present_int64 highest_nanoseconds;
+    size_t bucket_count;
+    present_uint64 * counts;
+
+    assert(self != NULL);
+    assert(highest != NULL);
+    assert(highest->data_.delta_seconds > 0 ||
+           highest->data_.delta_nanoseconds > 0);
+    assert(highest->data_.delta_seconds <= HISTOGRAM_MAX_HIGHEST_SECONDS);
+    assert(precision >= PRESENT_HISTOGRAM_MIN_PRECISION &&
+           precision <= PRESENT_HISTOGRAM_MAX_PRECISION);
+
+    highest_nanoseconds = histogram_nanoseconds(highest);
+    bucket_count = histogram_index(
+            (present_uint64)highest_nanoseconds, precision) + 1;
+    counts = histogram_allocate(bucket_count);
+    if (counts == NULL) {
+        return 0;
+    }
+
+    histogram_replace(self, counts, bucket_count, precision,
+            highest_nanoseconds);
+    return 1;
+}
+
+present_bool
+TimeDeltaHistogram_assign(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDeltaHistogram * const other)
+{
+    present_uint64 * counts;
+
+    assert(self != NULL);
+    assert(other != NULL);
+
+    if (self == other) {
+        return 1;
+    }
+    if (other->counts_ == NULL) {
+        TimeDeltaHistogram_destroy(self);
+        return 1;
+    }
+
+    counts = histogram_allocate(other->bucket_count_);
+    if (counts == NULL) {
+        return 0;
+    }
+    memcpy(counts, other->counts_,
+            other->bucket_count_ * sizeof(present_uint64));
+
+    histogram_replace(self, counts, other->bucket_count_, other->precision_,
+            other->highest_);
+    self->total_count_ = other->total_count_;
+    self->min_ = other->min_;
+    self->max_ = other->max_;
+    return 1;
+}
+
+void
+TimeDeltaHistogram_record(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDelta * const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    histogram_record(self, histogram_nanoseconds(value), 1);
+}
+
+void
+TimeDeltaHistogram_record_count(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDelta * const value,
+        present_uint64 count)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    histogram_record(self, histogram_nanoseconds(value), count);
+}
+
+void
+TimeDeltaHistogram_merge(
+        struct TimeDeltaHistogram * const self,
+        const struct TimeDeltaHistogram * const other)
+{
+    present_int64 min, max;
+    size_t i;
+
+    assert(self != NULL);
+    assert(self->counts_ != NULL);
+    assert(other != NULL);
+    assert(self != other);
+
+    if (other->total_count_ == 0) {
+        return;
+    }
+    min = self->min_ < other->min_ ? self->min_ : other->min_;
+    max = self->max_ > other->max_ ? self->max_ : other->max_;
+
+    if (other->precision_ == self->precision_) {
+        /* The buckets are the same, so just add the counters (other's
+           buckets past our last one all go in our last one) */
+        const present_uint64 * const other_counts = other->counts_;
+        present_uint64 * const counts = self->counts_;
+        const size_t shared = other->bucket_count_ < self->bucket_count_ ?
+            other->bucket_count_ : self->bucket_count_;
+        for (i = 0; i < shared; ++i) {
+            counts[i] += other_counts[i];
+        }
+        for (i = shared; i < other->bucket_count_; ++i) {
+            counts[self->bucket_count_ - 1] += other_counts[i];
+        }
+        self->total_count_ += other->total_count_;
+    } else {
+        for (i = 0; i < other->bucket_count_; ++i) {
+            if (other->counts_[i] != 0) {
+                histogram_record(self, histogram_bucket_value(other, i),
+                        other->counts_[i]);
+            }
+        }
+    }
+
+    self->min_ = min;
+    self->max_ = max;
+}
+
+void
+TimeDeltaHistogram_clear(struct TimeDeltaHistogram * const self)
+{
+    assert(self != NULL);
+
+    if (self->counts_ != NULL) {
+        memset(self->counts_, 0, self->bucket_count_ * sizeof(present_uint64));
+    }
+    self->total_count_ = 0;
+    self->min_ = HISTOGRAM_MAX_NANOSECONDS;
+    self->max_ = 0;
+}
+
+present_uint64
+TimeDeltaHistogram_count(const struct TimeDeltaHistogram * const self)
+{
+    assert(self != NULL);
+
+    return self->total_count_;
+}
+
+struct TimeDelta
+TimeDeltaHistogram_min(const struct TimeDeltaHistogram * const self)
+{
+    assert(self != NULL);
+
+    if (self->total_count_ == 0) {
+        return TimeDelta_zero();
+    }
+    return TimeDelta_from_nanoseconds(self->min_);
+}
+
+struct TimeDelta
+TimeDeltaHistogram_max(const struct TimeDeltaHistogram * const self)
+{
+    assert(self != NULL);
+
+    return TimeDelta_from_nanoseconds(self->max_);
+}
+
+struct TimeDelta
+TimeDeltaHistogram_mean(const struct TimeDeltaHistogram * const self)
+{
+    double sum = 0;
+    double mean;
+    size_t i;
+
+    assert(self != NULL);
+
+    if (self->total_count_ == 0) {
+        return TimeDelta_zero();
+    }
+    for (i = 0; i < self->bucket_count_; ++i) {
+        if (self->counts_[i] != 0) {
+            sum += (double)histogram_bucket_value(self, i) *
+                (double)self->counts_[i];
+        }
+    }
+
+    /* Limit the mean to [min, max] (which it can only leave by rounding) */
+    mean = sum / (double)self->total_count_;
+    if (mean <= (double)self->min_) {
+        return TimeDelta_from_nanoseconds(self->min_);
+    }
+    if (mean >= (double)self->max_) {
+        return TimeDelta_from_nanoseconds(self->max_);
+    }
+    return TimeDelta_from_nanoseconds((int_delta)(mean + 0.5));
+}
+
+struct TimeDelta
+TimeDeltaHistogram_value_at_quantile(
+        const struct TimeDeltaHistogram * const self,
+        double quantile)
+{
+    present_uint64 target, seen = 0;
+    present_int64 value;
+    size_t i;
+
+    assert(self != NULL);
+
+    if (self->total_count_ == 0) {
+        return TimeDelta_zero();
+    }
+    if (quantile <= 0) {
+        return TimeDelta_from_nanoseconds(self->min_);
+    }
+    if (quantile >= 1) {
+        return TimeDelta_from_nanoseconds(self->max_);
+    }
+
+    /* The rank of the value: ceil(quantile * count), and at least 1 */
+    target = (present_uint64)(quantile * (double)self->total_count_);
+    if ((double)target < quantile * (double)self->total_count_) {
+        ++target;
+    }
+    if (target == 0) {
+        target = 1;
+    }
+
+    for (i = 0; i + 1 < self->bucket_count_; ++i) {
+        seen += self->counts_[i];
+        if (seen >= target) {
+            break;
+        }
+    }
+
+    /* Report the highest value in the bucket, since every value at or below
+       the target is at or below it */
+    value = histogram_bucket_low(i, self->precision_) +
+        histogram_bucket_width(i, self->precision_) - 1;
+    if (i + 1 == self->bucket_count_ || value > self->max_) {
+        value = self->max_;
+    }
+    if (value < self->min_) {
+        value = self->min_;
+    }
+    return TimeDelta_from_nanoseconds(value);
+}
+
+/*
+ * The binary form is:
+ *
+ * - The format version (1 byte) and the precision (1 byte)
+ * - The highest value, the min, and the max (in nanoseconds), and the
+ *   number of values, each as a variable-length integer (the min and max
+ *   are 0 if there are no values)
+ * - The counters up to the last one that is not 0, each as a
+ *   variable-length integer, except that a run of counters that are 0 is
+ *   written as a 0 followed by the length of the run
+ */
+
+size_t
+TimeDeltaHistogram_serialize(
+        const struct TimeDeltaHistogram * const self,
+        unsigned char * const buffer,
+        size_t buffer_size)
+{
+    size_t position;
+    size_t end;
+    size_t i;
+
+    assert(self != NULL);
+    assert(self->counts_ != NULL);
+    assert(buffer != NULL || buffer_size == 0);
+
+    if (buffer_size > 0) {
+        buffer[0] = HISTOGRAM_FORMAT_VERSION;
+    }
+    if (buffer_size > 1) {
+        buffer[1] = (unsigned char)self->precision_;
+    }
+    position = 2;
+    position = histogram_write_varint(buffer, buffer_size, position,
+            (present_uint64)self->highest_);
+    position = histogram_write_varint(buffer, buffer_size, position,
+            self->total_count_ == 0 ? 0 : (present_uint64)self->min_);
+    position = histogram_write_varint(buffer, buffer_size, position,
+            (present_uint64)self->max_);
+    position = histogram_write_varint(buffer, buffer_size, position,
+            self->total_count_);
+
+    end = self->bucket_count_;
+    while (end > 0 && self->counts_[end - 1] == 0) {
+        --end;
+    }
+    for (i = 0; i < end; ) {
+        if (self->counts_[i] != 0) {
+            position = histogram_write_varint(buffer, buffer_size, position,
+                    self->counts_[i]);
+            ++i;
+        } else {
+            const size_t start = i;
+            while (self->counts_[i] == 0) {
+                ++i;
+            }
+            position = histogram_write_varint(buffer, buffer_size, position,
+                    0);
+            position = histogram_write_varint(buffer, buffer_size, position,
+                    (present_uint64)(i - start));
+        }
+    }
+    return position;
+}
+
+present_bool
+TimeDeltaHistogram_deserialize(
+        struct TimeDeltaHistogram * const self,
+        const unsigned char * const buffer,
+        size_t size)
+{
+    size_t position = 2;
+    present_uint64 highest, min, max, expected_count, count, total_count = 0;
+    int precision;
+    size_t bucket_count, i = 0;
+    present_uint64 * counts;
+    present_bool valid = 1;
+
+    assert(self != NULL);
+    assert(buffer != NULL || size == 0);
+
+    if (size < 2 || buffer[0] != HISTOGRAM_FORMAT_VERSION) {
+        return 0;
+    }
+    precision = buffer[1];
+    if (precision < PRESENT_HISTOGRAM_MIN_PRECISION ||
+            precision > PRESENT_HISTOGRAM_MAX_PRECISION ||
+            !histogram_read_varint(buffer, size, &position, &highest) ||
+            !histogram_read_varint(buffer, size, &position, &min) ||
+            !histogram_read_varint(buffer, size, &position, &max) ||
+            !histogram_read_varint(buffer, size, &position, &expected_count) ||
+            highest == 0 ||
+            highest > (present_uint64)HISTOGRAM_MAX_HIGHEST_SECONDS *
+                NANOSECONDS_IN_SECOND ||
+            min > max || max > (present_uint64)HISTOGRAM_MAX_NANOSECONDS) {
+        return 0;
+    }
+
+    bucket_count = histogram_index(highest, precision) + 1;
+    counts = histogram_allocate(bucket_count);
+    if (counts == NULL) {
+        return 0;
+    }
+
+    while (valid && position < size) {
+        if (!histogram_read_varint(buffer, size, &position, &count)) {
+            valid = 0;
+        } else if (count != 0) {
+            if (i < bucket_count) {
+                counts[i++] = count;
+                total_count += count;
+            } else {
+                valid = 0;
+            }
+        } else {
+            /* A run of counters that are 0 */
+            if (histogram_read_varint(buffer, size, &position, &count) &&
+                    count != 0 && count <= bucket_count - i) {
+                i += (size_t)count;
+            } else {
+                valid = 0;
+            }
+        }
+    }
+    /* The total also catches a binary form that was cut short */
+    if (!valid || total_count != expected_count ||
+            (total_count == 0 && max != 0)) {
+        present_aligned_free(counts);
+        return 0;
+    }
+
+    histogram_replace(self, counts, bucket_count, precision,
+            (present_int64)highest);
+    self->total_count_ = total_count;
+    if (total_count != 0) {
+        self->min_ = (present_int64)min;
+        self->max_ = (present_int64)max;
+    }
+    return 1;
+}
+
@@ -8,6 +8,7 @@
  */
 
 #include <assert.h>
+#include <math.h>
 #include <stddef.h>
 
 #include "present.h"
@@ -46,6 +47,24 @@
         if (data.delta_seconds < 0) assert(data.delta_nanoseconds <= 0);    \
     } while (0)
 
+/**
+ * 2^63, which maps a signed 64-bit integer onto an unsigned one (in the same
+ * order) when added to it.
+ */
+#define SUMMARY_BIAS    ((present_uint64)1 << 63)
+
+/**
+ * 2^63 as a double, which is more seconds than a TimeDelta can hold (for
+ * saturating the standard deviation).
+ */
+#define SUMMARY_MAX_SECONDS 9223372036854775808.0
+
+/**
+ * The most values that are summed in one block, so that the sums of their
+ * 32-bit halves (and of their nanoseconds) fit in 64 bits.
+ */
+#define SUMMARY_BLOCK_SIZE  ((size_t)1 << 31)
+
 /** Initialize a new TimeDelta based on seconds and nanoseconds. */
 static void
 init_time_delta(
@@ -529,3 +548,351 @@ STRUCT_COMPARISON_OPERATORS(TimeDelta)
 
 STRUCT_COMPARISON_OPERATORS_WITH_OTHER_STRUCT(TimeDelta, DayDelta)
 
+
+/*
+ * Summaries of many TimeDeltas
+ *
+ * The exact sums are kept as 128-bit two's complement integers, in a pair of
+ * 64-bit words (high and low).
+ */
+
+/** Add a 128-bit integer to another. */
+static void
+summary_add(
+        present_uint64 * const high,
+        present_uint64 * const low,
+        present_uint64 add_high,
+        present_uint64 add_low)
+{
+    *low += add_low;
+    *high += add_high + (*low < add_low);
+}
+
+/**
+ * Add the sum of a block of @p count signed 64-bit values to a 128-bit
+ * integer, given the sums of the upper and lower 32-bit halves of each value
+ * plus SUMMARY_BIAS.
+ */
+static void
+summary_add_halves(
+        present_uint64 * const high,
+        present_uint64 * const low,
+        present_uint64 upper_sum,
+        present_uint64 lower_sum,
+        size_t count)
+{
+    const present_uint64 bias_high = (present_uint64)count >> 1;
+    const present_uint64 bias_low = ((present_uint64)count & 1) << 63;
+
+    summary_add(high, low, upper_sum >> 32, upper_sum << 32);
+    summary_add(high, low, 0, lower_sum);
+
+    /* Subtract count * SUMMARY_BIAS */
+    *high -= bias_high + (*low < bias_low);
+    *low -= bias_low;
+}
+
+/** Multiply a 128-bit integer by a factor that is less than 2^32. */
+static void
+summary_multiply(
+        present_uint64 * const high,
+        present_uint64 * const low,
+        present_uint64 factor)
+{
+    const present_uint64 low_product = (*low & 0xFFFFFFFFUL) * factor;
+    const present_uint64 high_product = (*low >> 32) * factor;
+    const present_uint64 new_low = low_product + (high_product << 32);
+
+    *high = *high * factor + (high_product >> 32) + (new_low < low_product);
+    *low = new_low;
+}
+
+/**
+ * Divide a 128-bit integer by a positive divisor (at most 2^63), rounding
+ * down.
+ *
+ * @return The remainder (from 0 to divisor - 1).
+ */
+static present_uint64
+summary_floor_divide(
+        present_uint64 * const high,
+        present_uint64 * const low,
+        present_uint64 divisor)
+{
+    const present_bool negative = (*high >> 63) != 0;
+    present_uint64 remainder = 0;
+    int bit;
+
+    assert(divisor > 0 && divisor <= SUMMARY_BIAS);
+
+    if (negative) {
+        *high = ~*high + (*low == 0);
+        *low = ~*low + 1;
+    }
+
+    /* Long division, shifting the quotient in as the dividend shifts out */
+    for (bit = 0; bit < 128; bit++) {
+        remainder = (remainder << 1) | (*high >> 63);
+        *high = (*high << 1) | (*low >> 63);
+        *low <<= 1;
+        if (remainder >= divisor) {
+            remainder -= divisor;
+            *low |= 1;
+        }
+    }
+
+    if (negative) {
+        if (remainder != 0) {
+            summary_add(high, low, 0, 1);
+            remainder = divisor - remainder;
+        }
+        *high = ~*high + (*low == 0);
+        *low = ~*low + 1;
+    }
+    return remainder;
+}
+
+/**
+ * Convert a signed 64-bit integer to a double, from its 32-bit halves.
+ *
+ * This gives the same result as a cast (up to rounding), but compilers can
+ * vectorize it on processors that can only convert 32-bit integers to
+ * doubles in bulk.
+ */
+static PRESENT_INLINE double
+summary_to_double(present_int64 value)
+{
+    /* The lower half is offset by 2^31 so that it fits in an int */
+    const int upper = (int)(value >> 32);
+    const int lower = (int)((value & (present_int64)0xFFFFFFFFUL) -
+            (present_int64)0x80000000UL);
+    return (double)upper * 4294967296.0 + ((double)lower + 2147483648.0);
+}
+
+/**
+ * Get the difference (in nanoseconds) between a TimeDelta and a mean, given
+ * as its seconds (converted to a double) and nanoseconds.
+ */
+static PRESENT_INLINE double
+summary_difference(
+        const struct TimeDelta * const delta,
+        double mean_seconds,
+        int_delta mean_nanoseconds)
+{
+    return (summary_to_double(delta->data_.delta_seconds) - mean_seconds) *
+        NANOSECONDS_IN_SECOND +
+        summary_to_double(delta->data_.delta_nanoseconds - mean_nanoseconds);
+}
+
+/** Convert a 128-bit number of nanoseconds to a TimeDelta. */
+static struct TimeDelta
+summary_to_time_delta(present_uint64 high, present_uint64 low)
+{
+    struct TimeDelta result;
+    const present_uint64 nanoseconds =
+        summary_floor_divide(&high, &low, NANOSECONDS_IN_SECOND);
+
+    /* The seconds must fit in 64 bits */
+    assert(high == ((low >> 63) ? ~(present_uint64)0 : 0));
+    init_time_delta(&result, (int_delta)low, (int_delta)nanoseconds);
+    return result;
+}
+
+/**
+ * Fill in the count, variance, and standard deviation of a summary, from
+ * the sum of the squares of the differences from the mean.
+ */
+static void
+summary_finish(
+        struct TimeDeltaSummary * const result,
+        size_t count,
+        double sum_of_squares)
+{
+    /* The standard deviation can be more nanoseconds than fit in 64 bits,
+       so it is split into seconds and nanoseconds while it is a double (and
+       saturates at the most seconds that fit in a TimeDelta) */
+    const double deviation = sqrt(sum_of_squares / (double)count);
+    const double seconds = floor(deviation / NANOSECONDS_IN_SECOND);
+
+    result->count = count;
+    result->variance = sum_of_squares / (double)count;
+    if (seconds >= SUMMARY_MAX_SECONDS) {
+        init_time_delta(&result->standard_deviation,
+                (int_delta)(SUMMARY_BIAS - 1), NANOSECONDS_IN_SECOND - 1);
+    } else {
+        init_time_delta(&result->standard_deviation, (int_delta)seconds,
+                (int_delta)floor(deviation -
+                    seconds * NANOSECONDS_IN_SECOND + 0.5));
+    }
+}
+
+/** Set every field of a summary to zero. */
+static void
+summary_clear(struct TimeDeltaSummary * const result)
+{
+    result->count = 0;
+    init_time_delta(&result->sum, 0, 0);
+    init_time_delta(&result->mean, 0, 0);
+    init_time_delta(&result->min, 0, 0);
+    init_time_delta(&result->max, 0, 0);
+    result->variance = 0;
+    init_time_delta(&result->standard_deviation, 0, 0);
+}
+
+void
+TimeDelta_summarize(
+        const struct TimeDelta * const deltas,
+        size_t count,
+        struct TimeDeltaSummary * const result)
+{
+    present_uint64 high = 0, low = 0, nanoseconds_high = 0,
+                   nanoseconds_low = 0, mean_high, mean_low;
+    int_delta min_seconds, max_seconds, min_nanoseconds, max_nanoseconds,
+              mean_nanoseconds;
+    double mean_seconds;
+    double sums_of_squares[4] = {0, 0, 0, 0};
+    size_t start, i, j;
+
+    assert(deltas != NULL || count == 0);
+    assert(result != NULL);
+
+    if (count == 0) {
+        summary_clear(result);
+        return;
+    }
+
+    /* The exact sum, in blocks: the seconds by their 32-bit halves (so each
+       half can be summed with plain 64-bit adds), and the nanoseconds (which
+       are always less than a second) directly */
+    for (start = 0; start < count; start += SUMMARY_BLOCK_SIZE) {
+        const size_t end = count - start > SUMMARY_BLOCK_SIZE ?
+            start + SUMMARY_BLOCK_SIZE : count;
+        present_uint64 upper_sum = 0, lower_sum = 0;
+        present_int64 nanoseconds_sum = 0;
+        for (i = start; i < end; ++i) {
+            const present_uint64 biased =
+                (present_uint64)deltas[i].data_.delta_seconds ^ SUMMARY_BIAS;
+            upper_sum += biased >> 32;
+            lower_sum += biased & 0xFFFFFFFFUL;
+            nanoseconds_sum += deltas[i].data_.delta_nanoseconds;
+        }
+        summary_add_halves(&high, &low, upper_sum, lower_sum, end - start);
+        summary_add(&nanoseconds_high, &nanoseconds_low,
+                nanoseconds_sum < 0 ? ~(present_uint64)0 : 0,
+                (present_uint64)nanoseconds_sum);
+    }
+    summary_multiply(&high, &low, NANOSECONDS_IN_SECOND);
+    summary_add(&high, &low, nanoseconds_high, nanoseconds_low);
+
+    result->sum = summary_to_time_delta(high, low);
+    mean_high = high;
+    mean_low = low;
+    summary_floor_divide(&mean_high, &mean_low, (present_uint64)count);
+    result->mean = summary_to_time_delta(mean_high, mean_low);
+
+    /* The min and max seconds first, then the min and max nanoseconds among
+       the values with those seconds (since the seconds and nanoseconds of a
+       TimeDelta have the same sign, this orders them correctly) */
+    min_seconds = max_seconds = deltas[0].data_.delta_seconds;
+    for (i = 1; i < count; ++i) {
+        const int_delta seconds = deltas[i].data_.delta_seconds;
+        min_seconds = seconds < min_seconds ? seconds : min_seconds;
+        max_seconds = seconds > max_seconds ? seconds : max_seconds;
+    }
+    min_nanoseconds = NANOSECONDS_IN_SECOND;
+    max_nanoseconds = -NANOSECONDS_IN_SECOND;
+    for (i = 0; i < count; ++i) {
+        const int_delta seconds = deltas[i].data_.delta_seconds;
+        const int_delta nanoseconds = deltas[i].data_.delta_nanoseconds;
+        const int_delta min_candidate =
+            seconds == min_seconds ? nanoseconds : NANOSECONDS_IN_SECOND;
+        const int_delta max_candidate =
+            seconds == max_seconds ? nanoseconds : -NANOSECONDS_IN_SECOND;
+        min_nanoseconds = min_candidate < min_nanoseconds ?
+            min_candidate : min_nanoseconds;
+        max_nanoseconds = max_candidate > max_nanoseconds ?
+            max_candidate : max_nanoseconds;
+    }
+    init_time_delta(&result->min, min_seconds, min_nanoseconds);
+    init_time_delta(&result->max, max_seconds, max_nanoseconds);
+
+    /* The variance, from the differences from the mean (with 4 partial
+       sums, which compilers can keep in one vector) */
+    mean_seconds = summary_to_double(result->mean.data_.delta_seconds);
+    mean_nanoseconds = result->mean.data_.delta_nanoseconds;
+    for (i = 0; i + 4 <= count; i += 4) {
+        for (j = 0; j < 4; ++j) {
+            const double difference = summary_difference(
+                    &deltas[i + j], mean_seconds, mean_nanoseconds);
+            sums_of_squares[j] += difference * difference;
+        }
+    }
+    for (; i < count; ++i) {
+        const double difference =
+            summary_difference(&deltas[i], mean_seconds, mean_nanoseconds);
+        sums_of_squares[0] += difference * difference;
+    }
+    summary_finish(result, count, (sums_of_squares[0] + sums_of_squares[1]) +
+            (sums_of_squares[2] + sums_of_squares[3]));
+}
+
+void
+TimeDelta_summarize_nanoseconds(
+        const int_delta * const nanoseconds,
+        size_t count,
+        struct TimeDeltaSummary * const result)
+{
+    present_uint64 high = 0, low = 0;
+    int_delta min, max;
+    double mean;
+    double sums_of_squares[4] = {0, 0, 0, 0};
+    size_t start, i, j;
+
+    assert(nanoseconds != NULL || count == 0);
+    assert(result != NULL);
+
+    if (count == 0) {
+        summary_clear(result);
+        return;
+    }
+
+    for (start = 0; start < count; start += SUMMARY_BLOCK_SIZE) {
+        const size_t end = count - start > SUMMARY_BLOCK_SIZE ?
+            start + SUMMARY_BLOCK_SIZE : count;
+        present_uint64 upper_sum = 0, lower_sum = 0;
+        for (i = start; i < end; ++i) {
+            const present_uint64 biased =
+                (present_uint64)nanoseconds[i] ^ SUMMARY_BIAS;
+            upper_sum += biased >> 32;
+            lower_sum += biased & 0xFFFFFFFFUL;
+        }
+        summary_add_halves(&high, &low, upper_sum, lower_sum, end - start);
+    }
+    result->sum = summary_to_time_delta(high, low);
+    summary_floor_divide(&high, &low, (present_uint64)count);
+    result->mean = summary_to_time_delta(high, low);
+
+    min = max = nanoseconds[0];
+    for (i = 1; i < count; ++i) {
+        min = nanoseconds[i] < min ? nanoseconds[i] : min;
+        max = nanoseconds[i] > max ? nanoseconds[i] : max;
+    }
+    init_time_delta(&result->min, 0, min);
+    init_time_delta(&result->max, 0, max);
+
+    /* The mean of 64-bit values always fits in 64 bits */
+    mean = summary_to_double((present_int64)low);
+    for (i = 0; i + 4 <= count; i += 4) {
+        for (j = 0; j < 4; ++j) {
+            const double difference =
+                summary_to_double(nanoseconds[i + j]) - mean;
+            sums_of_squares[j] += difference * difference;
+        }
+    }
+    for (; i < count; ++i) {
+        const double difference = summary_to_double(nanoseconds[i]) - mean;
+        sums_of_squares[0] += difference * difference;
+    }
+    summary_finish(result, count, (sums_of_squares[0] + sums_of_squares[1]) +
+            (sums_of_squares[2] + sums_of_squares[3]));
+}
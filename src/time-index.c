@@ -0,0 +1,386 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimeIndex methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "present.h"
+
+#include "utils/constants.h"
+#include "utils/memory-utils.h"
+
+/** The number of children of each node above the bottom level. */
+#define TIME_INDEX_FANOUT   (PRESENT_TIME_INDEX_NODE_SIZE + 1)
+
+/** The number of array entries in each node (seconds and nanoseconds). */
+#define TIME_INDEX_NODE_ENTRIES (2 * PRESENT_TIME_INDEX_NODE_SIZE)
+
+/** The alignment (in bytes) of the nodes of a TimeIndex. */
+#define TIME_INDEX_ALIGNMENT    64
+
+/**
+ * The seconds of the timestamp used to fill the empty entries of the nodes.
+ * Along with TIME_INDEX_PADDING_NANOSECONDS, this is after any valid
+ * timestamp, so the searches never go past the end of a level.
+ */
+#define TIME_INDEX_PADDING_SECONDS \
+    ((int_timestamp) (((present_uint64)1 << 63) - 1))
+
+/** The nanoseconds of the timestamp used to fill the empty entries. */
+#define TIME_INDEX_PADDING_NANOSECONDS  NANOSECONDS_IN_SECOND
+
+/** Get a pointer to node @p k of level @p level of a TimeIndex. */
+#define TIME_INDEX_NODE(self, level, k) \
+    ((self)->nodes_ + \
+     ((self)->level_offsets_[level] + (k)) * TIME_INDEX_NODE_ENTRIES)
+
+/**
+ * Get the number of nodes in a level of a (non-empty) TimeIndex.
+ */
+static size_t
+time_index_level_size(const struct TimeIndex * const self, size_t level)
+{
+    if (level == 0) {
+        return self->size_ / PRESENT_TIME_INDEX_NODE_SIZE +
+            (self->size_ % PRESENT_TIME_INDEX_NODE_SIZE != 0);
+    }
+    /* The levels are stored from the root down, so each one ends where the
+       level below it starts */
+    return self->level_offsets_[level - 1] - self->level_offsets_[level];
+}
+
+/**
+ * Get the total number of nodes in a (non-empty) TimeIndex.
+ */
+static size_t
+time_index_node_count(const struct TimeIndex * const self)
+{
+    return self->level_offsets_[0] + time_index_level_size(self, 0);
+}
+
+/**
+ * Replace a TimeIndex with room for an index of @p count timestamps (without
+ * filling in its nodes).
+ *
+ * This works on the fields directly rather than on a temporary struct
+ * TimeIndex, since in C++ (including when this file is compiled as C++) that
+ * would run the TimeIndex constructor, destructor, and assignment operator.
+ *
+ * @return 1 on success, or 0 if the memory could not be allocated (in which
+ * case the index is unchanged).
+ */
+static present_bool
+time_index_allocate(struct TimeIndex * const self, size_t count)
+{
+    size_t level_sizes[PRESENT_TIME_INDEX_MAX_HEIGHT];
+    size_t nodes, total, height, level;
+    int_timestamp * block;
+
+    if (count == 0) {
+        TimeIndex_destroy(self);
+        return 1;
+    }
+
+    nodes = count / PRESENT_TIME_INDEX_NODE_SIZE +
+        (count % PRESENT_TIME_INDEX_NODE_SIZE != 0);
+    level_sizes[0] = nodes;
+    total = nodes;
+    height = 1;
+    while (nodes > 1) {
+        nodes = (nodes + TIME_INDEX_FANOUT - 1) / TIME_INDEX_FANOUT;
+        assert(height < PRESENT_TIME_INDEX_MAX_HEIGHT);
+        level_sizes[height++] = nodes;
+        total += nodes;
+    }
+
+    if (total > (size_t)-1 / TIME_INDEX_NODE_ENTRIES /
+            sizeof(int_timestamp)) {
+        return 0;
+    }
+    block = (int_timestamp *) present_aligned_alloc(
+            total * TIME_INDEX_NODE_ENTRIES * sizeof(int_timestamp),
+            TIME_INDEX_ALIGNMENT);
+    if (block == NULL) {
+        return 0;
+    }
+
+    present_aligned_free(self->nodes_);
+    self->nodes_ = block;
+    self->size_ = count;
+    self->height_ = height;
+    total = 0;
+    for (level = height; level-- > 0; ) {
+        self->level_offsets_[level] = total;
+        total += level_sizes[level];
+    }
+    return 1;
+}
+
+/**
+ * Fill in the padding at the end of the bottom level of a TimeIndex, and all
+ * of the levels above it, once the timestamps are in the bottom level.
+ */
+static void
+time_index_fill_levels(struct TimeIndex * const self)
+{
+    int_timestamp * node;
+    const int_timestamp * child;
+    size_t level, nodes, child_nodes, child_span, k, i, c;
+
+    for (i = self->size_;
+            i % PRESENT_TIME_INDEX_NODE_SIZE != 0;
+            i++) {
+        node = TIME_INDEX_NODE(self, 0, i / PRESENT_TIME_INDEX_NODE_SIZE);
+        node[i % PRESENT_TIME_INDEX_NODE_SIZE] = TIME_INDEX_PADDING_SECONDS;
+        node[i % PRESENT_TIME_INDEX_NODE_SIZE +
+            PRESENT_TIME_INDEX_NODE_SIZE] = TIME_INDEX_PADDING_NANOSECONDS;
+    }
+
+    /* Each entry of a node is the first timestamp of the subtree under its
+       next child, which is the first one in that subtree's first node of the
+       bottom level (child_span is the number of bottom nodes per subtree) */
+    child_span = 1;
+    for (level = 1; level < self->height_; level++) {
+        nodes = time_index_level_size(self, level);
+        child_nodes = time_index_level_size(self, level - 1);
+        for (k = 0; k < nodes; k++) {
+            node = TIME_INDEX_NODE(self, level, k);
+            for (i = 0; i < PRESENT_TIME_INDEX_NODE_SIZE; i++) {
+                c = k * TIME_INDEX_FANOUT + i + 1;
+                if (c < child_nodes) {
+                    child = TIME_INDEX_NODE(self, 0, c * child_span);
+                    node[i] = child[0];
+                    node[i + PRESENT_TIME_INDEX_NODE_SIZE] =
+                        child[PRESENT_TIME_INDEX_NODE_SIZE];
+                } else {
+                    node[i] = TIME_INDEX_PADDING_SECONDS;
+                    node[i + PRESENT_TIME_INDEX_NODE_SIZE] =
+                        TIME_INDEX_PADDING_NANOSECONDS;
+                }
+            }
+        }
+        child_span *= TIME_INDEX_FANOUT;
+    }
+}
+
+/**
+ * Count the timestamps in a node that are before a timestamp.
+ *
+ * This is a loop without branches over a fixed number of entries, so that
+ * compilers can vectorize it (and unroll it completely).
+ */
+static size_t
+time_index_count_before(
+        const int_timestamp * const node,
+        int_timestamp seconds,
+        int_timestamp nanoseconds)
+{
+    const int_timestamp * const node_nanoseconds =
+        node + PRESENT_TIME_INDEX_NODE_SIZE;
+    size_t i, count = 0;
+
+    for (i = 0; i < PRESENT_TIME_INDEX_NODE_SIZE; i++) {
+        count += (node[i] < seconds) |
+            ((node[i] == seconds) & (node_nanoseconds[i] < nanoseconds));
+    }
+    return count;
+}
+
+/**
+ * Find the number of timestamps in a TimeIndex that are before a timestamp
+ * (given as seconds and nanoseconds).
+ */
+static size_t
+time_index_search(
+        const struct TimeIndex * const self,
+        int_timestamp seconds,
+        int_timestamp nanoseconds)
+{
+    size_t level, k = 0, position;
+
+    if (self->size_ == 0) {
+        return 0;
+    }
+
+    for (level = self->height_ - 1; level > 0; level--) {
+        k = k * TIME_INDEX_FANOUT + time_index_count_before(
+                TIME_INDEX_NODE(self, level, k), seconds, nanoseconds);
+    }
+    position = k * PRESENT_TIME_INDEX_NODE_SIZE + time_index_count_before(
+            TIME_INDEX_NODE(self, 0, k), seconds, nanoseconds);
+    return position < self->size_ ? position : self->size_;
+}
+
+void
+TimeIndex_init(struct TimeIndex * const self)
+{
+    assert(self != NULL);
+
+    self->nodes_ = NULL;
+    self->size_ = 0;
+    self->height_ = 0;
+}
+
+void
+TimeIndex_destroy(struct TimeIndex * const self)
+{
+    assert(self != NULL);
+
+    present_aligned_free(self->nodes_);
+    TimeIndex_init(self);
+}
+
+present_bool
+TimeIndex_build(
+        struct TimeIndex * const self,
+        const struct Timestamp * const timestamps,
+        size_t count)
+{
+    int_timestamp * node;
+    size_t i;
+
+    assert(self != NULL);
+    assert(timestamps != NULL || count == 0);
+
+    if (!time_index_allocate(self, count)) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        assert(timestamps[i].has_error == 0);
+        assert(i == 0 || Timestamp_less_than_or_equal(
+                    &timestamps[i - 1], &timestamps[i]));
+        node = TIME_INDEX_NODE(self, 0, i / PRESENT_TIME_INDEX_NODE_SIZE);
+        node[i % PRESENT_TIME_INDEX_NODE_SIZE] =
+            timestamps[i].data_.timestamp_seconds;
+        node[i % PRESENT_TIME_INDEX_NODE_SIZE +
+            PRESENT_TIME_INDEX_NODE_SIZE] =
+            timestamps[i].data_.additional_nanoseconds;
+    }
+    if (count > 0) {
+        time_index_fill_levels(self);
+    }
+    return 1;
+}
+
+present_bool
+TimeIndex_build_from_column(
+        struct TimeIndex * const self,
+        const struct TimestampColumn * const column)
+{
+    const int_timestamp * const seconds = column->seconds_;
+    const int_timestamp * const nanoseconds = column->nanoseconds_;
+    int_timestamp * node;
+    size_t i, size;
+
+    assert(self != NULL);
+    assert(column != NULL);
+
+    size = column->size_;
+    for (i = 1; i < size; i++) {
+        assert(seconds[i - 1] < seconds[i] ||
+                (seconds[i - 1] == seconds[i] &&
+                 nanoseconds[i - 1] <= nanoseconds[i]));
+    }
+    if (!time_index_allocate(self, size)) {
+        return 0;
+    }
+    /* Copy the column a whole node at a time */
+    for (i = 0; i < size; i += PRESENT_TIME_INDEX_NODE_SIZE) {
+        node = TIME_INDEX_NODE(self, 0, i / PRESENT_TIME_INDEX_NODE_SIZE);
+        memcpy(node, seconds + i, (size - i < PRESENT_TIME_INDEX_NODE_SIZE ?
+                    size - i : PRESENT_TIME_INDEX_NODE_SIZE) *
+                sizeof(int_timestamp));
+        memcpy(node + PRESENT_TIME_INDEX_NODE_SIZE, nanoseconds + i,
+                (size - i < PRESENT_TIME_INDEX_NODE_SIZE ?
+                 size - i : PRESENT_TIME_INDEX_NODE_SIZE) *
+                sizeof(int_timestamp));
+    }
+    if (size > 0) {
+        time_index_fill_levels(self);
+    }
+    return 1;
+}
+
+present_bool
+TimeIndex_assign(
+        struct TimeIndex * const self,
+        const struct TimeIndex * const other)
+{
+    assert(self != NULL);
+    assert(other != NULL);
+
+    if (self == other) {
+        return 1;
+    }
+    if (!time_index_allocate(self, other->size_)) {
+        return 0;
+    }
+    if (other->size_ > 0) {
+        memcpy(self->nodes_, other->nodes_, time_index_node_count(other) *
+                TIME_INDEX_NODE_ENTRIES * sizeof(int_timestamp));
+    }
+    return 1;
+}
+
+size_t
+TimeIndex_lower_bound(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    return time_index_search(self, value->data_.timestamp_seconds,
+            value->data_.additional_nanoseconds);
+}
+
+size_t
+TimeIndex_upper_bound(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    /* The timestamps before the next nanosecond */
+    return time_index_search(self, value->data_.timestamp_seconds,
+            value->data_.additional_nanoseconds + 1);
+}
+
+size_t
+TimeIndex_count_range(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const low,
+        const struct Timestamp * const high)
+{
+    size_t first;
+
+    return TimeIndex_find_range(self, low, high, &first);
+}
+
+size_t
+TimeIndex_find_range(
+        const struct TimeIndex * const self,
+        const struct Timestamp * const low,
+        const struct Timestamp * const high,
+        size_t * const first)
+{
+    size_t end;
+
+    assert(self != NULL);
+    assert(low != NULL);
+    assert(high != NULL);
+    assert(first != NULL);
+
+    *first = TimeIndex_lower_bound(self, low);
+    end = TimeIndex_lower_bound(self, high);
+    return end > *first ? end - *first : 0;
+}
+
@@ -0,0 +1,727 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimeInterval and TimeIntervalIndex methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "present.h"
+
+#include "utils/constants.h"
+#include "utils/memory-utils.h"
+#include "utils/sort-utils.h"
+
+/** The alignment (in bytes) of the arrays of a TimeIntervalIndex. */
+#define TIME_INTERVAL_ALIGNMENT     64
+
+/** The link of a node that has no child on that side. */
+#define TIME_INTERVAL_NO_NODE       ((size_t)-1)
+
+/*
+ * The layout of the times_ array of a TimeIntervalIndex with n (non-empty)
+ * intervals and m nodes: the seconds and the nanoseconds of the starts of the
+ * intervals in order (n each), the seconds and the nanoseconds of the centers
+ * of the nodes (m each), the seconds and the nanoseconds of the starts of
+ * each node's intervals (n each), and the seconds and the nanoseconds of the
+ * ends of each node's intervals (n each).
+ *
+ * Each node's intervals are a range of positions in the last two pairs of
+ * arrays, ordered by start in the first pair, and by end (latest first) in
+ * the second.
+ */
+
+/** Get the seconds of the (ordered) starts of a TimeIntervalIndex. */
+#define TIME_INTERVAL_STARTS(self)  ((self)->times_)
+/** Get the seconds of the centers of the nodes of a TimeIntervalIndex. */
+#define TIME_INTERVAL_CENTERS(self) ((self)->times_ + 2 * (self)->count_)
+/** Get the seconds of the starts of each node's intervals. */
+#define TIME_INTERVAL_NODE_STARTS(self) \
+    ((self)->times_ + 2 * (self)->count_ + 2 * (self)->node_count_)
+/** Get the seconds of the ends of each node's intervals. */
+#define TIME_INTERVAL_NODE_ENDS(self) \
+    ((self)->times_ + 4 * (self)->count_ + 2 * (self)->node_count_)
+
+/*
+ * The layout of the links_ array: the positions of the intervals in order of
+ * start (n), the links of each node (4 * m: the first of its intervals, the
+ * number of its intervals, and its left and right children), the positions
+ * of each node's intervals in order of start (n), and the positions of each
+ * node's intervals in order of end (n).
+ */
+
+/** Get the positions of the (ordered) intervals of a TimeIntervalIndex. */
+#define TIME_INTERVAL_POSITIONS(self)   ((self)->links_)
+/** Get the links of node @p k of a TimeIntervalIndex. */
+#define TIME_INTERVAL_NODE(self, k) \
+    ((self)->links_ + (self)->count_ + 4 * (k))
+/** Get the positions of each node's intervals (in order of start). */
+#define TIME_INTERVAL_NODE_START_POSITIONS(self) \
+    ((self)->links_ + (self)->count_ + 4 * (self)->node_count_)
+/** Get the positions of each node's intervals (in order of end). */
+#define TIME_INTERVAL_NODE_END_POSITIONS(self) \
+    ((self)->links_ + 2 * (self)->count_ + 4 * (self)->node_count_)
+
+/** Compare two timestamps (as seconds and nanoseconds): a < b. */
+#define TIME_INTERVAL_LESS( \
+        seconds_a, nanoseconds_a, seconds_b, nanoseconds_b) \
+    ((seconds_a) < (seconds_b) || \
+     ((seconds_a) == (seconds_b) && (nanoseconds_a) < (nanoseconds_b)))
+
+/**
+ * The scratch arrays used while building a TimeIntervalIndex (each with one
+ * entry for each non-empty interval).
+ */
+struct TimeIntervalBuild {
+    /* The seconds and nanoseconds of the end of each interval */
+    int_timestamp * end_seconds;
+    int_timestamp * end_nanoseconds;
+    /* The node that holds each interval */
+    size_t * nodes;
+    /* The intervals that are still to be placed in a node */
+    size_t * pending;
+    /* Space for splitting the pending intervals */
+    size_t * split;
+    /* The number of nodes added so far */
+    size_t node_count;
+    /* The next free entry of the nodes' intervals */
+    size_t entry_count;
+};
+
+/**
+ * Add a node (and its subtrees) to a TimeIntervalIndex, for the intervals
+ * pending[0] to pending[count - 1], which are in order of start.
+ *
+ * The center of the node is the start of the median interval, so the median
+ * interval (which is not empty) stays in the node, and at most half of the
+ * intervals go into each subtree. The depth of the tree is therefore at most
+ * log2(n) + 1.
+ *
+ * @return The index of the node, or TIME_INTERVAL_NO_NODE if @p count is 0.
+ */
+static size_t
+time_interval_build_node(
+        struct TimeIntervalIndex * const self,
+        struct TimeIntervalBuild * const build,
+        size_t * const pending,
+        size_t count)
+{
+    const int_timestamp * const starts = TIME_INTERVAL_STARTS(self);
+    int_timestamp * const centers = TIME_INTERVAL_CENTERS(self);
+    int_timestamp * const node_starts = TIME_INTERVAL_NODE_STARTS(self);
+    size_t * const positions = TIME_INTERVAL_POSITIONS(self);
+    size_t * const node_positions = TIME_INTERVAL_NODE_START_POSITIONS(self);
+    size_t * node;
+    int_timestamp center_seconds, center_nanoseconds;
+    size_t k, i, j, left_count, stay_count, right_first;
+
+    if (count == 0) {
+        return TIME_INTERVAL_NO_NODE;
+    }
+
+    k = build->node_count++;
+    center_seconds = starts[pending[count / 2]];
+    center_nanoseconds = starts[self->count_ + pending[count / 2]];
+    centers[k] = center_seconds;
+    centers[self->node_count_ + k] = center_nanoseconds;
+
+    /* The intervals that start after the center are at the end (since they
+       are in order of start) */
+    right_first = count / 2 + 1;
+    while (right_first < count && !TIME_INTERVAL_LESS(
+                center_seconds, center_nanoseconds,
+                starts[pending[right_first]],
+                starts[self->count_ + pending[right_first]])) {
+        right_first++;
+    }
+
+    /* Of the others, move the intervals that end at or before the center to
+       the front (keeping them in order), and those that contain the center
+       after them */
+    left_count = 0;
+    stay_count = 0;
+    for (i = 0; i < right_first; i++) {
+        j = pending[i];
+        if (TIME_INTERVAL_LESS(center_seconds, center_nanoseconds,
+                    build->end_seconds[j], build->end_nanoseconds[j])) {
+            build->split[stay_count++] = j;
+        } else {
+            pending[left_count++] = j;
+        }
+    }
+    memcpy(pending + left_count, build->split, stay_count * sizeof(size_t));
+
+    /* The intervals that contain the center are stored in the node, in order
+       of start (their order of end is filled in once the tree is built) */
+    node = TIME_INTERVAL_NODE(self, k);
+    node[0] = build->entry_count;
+    node[1] = stay_count;
+    for (i = 0; i < stay_count; i++) {
+        j = pending[left_count + i];
+        build->nodes[j] = k;
+        node_starts[build->entry_count] = starts[j];
+        node_starts[self->count_ + build->entry_count] =
+            starts[self->count_ + j];
+        node_positions[build->entry_count] = positions[j];
+        build->entry_count++;
+    }
+
+    /* The left child is built first, so that it is right after this node */
+    node[2] = time_interval_build_node(self, build, pending, left_count);
+    node[3] = time_interval_build_node(self, build, pending + right_first,
+            count - right_first);
+    return k;
+}
+
+/**
+ * Fill in the order of end of each node's intervals, once the tree is built.
+ *
+ * Rather than sorting each node's intervals separately, every interval is
+ * sorted by end (latest first) at once, and then added to the end of its
+ * node's range in that order.
+ *
+ * @return 1 on success, or 0 if the memory for the sort could not be
+ * allocated.
+ */
+static present_bool
+time_interval_fill_ends(
+        struct TimeIntervalIndex * const self,
+        struct TimeIntervalBuild * const build)
+{
+    int_timestamp * const node_ends = TIME_INTERVAL_NODE_ENDS(self);
+    size_t * const node_positions = TIME_INTERVAL_NODE_END_POSITIONS(self);
+    const size_t * const positions = TIME_INTERVAL_POSITIONS(self);
+    present_uint64 * keys;
+    size_t * order;
+    size_t * next_entry;
+    size_t i, j, entry;
+    present_bool success;
+
+    keys = (present_uint64 *) malloc(2 * self->count_ *
+            sizeof(present_uint64));
+    order = (size_t *) malloc((self->count_ + self->node_count_) *
+            sizeof(size_t));
+    if (keys == NULL || order == NULL) {
+        free(keys);
+        free(order);
+        return 0;
+    }
+
+    /* Inverting the keys sorts the latest end first */
+    for (i = 0; i < self->count_; i++) {
+        keys[i] = ~((present_uint64)build->end_seconds[i] ^
+                PRESENT_SORT_SIGN_BIT);
+        keys[self->count_ + i] = ~(present_uint64)build->end_nanoseconds[i];
+        order[i] = i;
+    }
+    success = present_radix_sort(keys, keys + self->count_, 30, order,
+            self->count_, 1);
+
+    if (success) {
+        next_entry = order + self->count_;
+        for (i = 0; i < self->node_count_; i++) {
+            next_entry[i] = TIME_INTERVAL_NODE(self, i)[0];
+        }
+        for (i = 0; i < self->count_; i++) {
+            j = order[i];
+            entry = next_entry[build->nodes[j]]++;
+            node_ends[entry] = build->end_seconds[j];
+            node_ends[self->count_ + entry] = build->end_nanoseconds[j];
+            node_positions[entry] = positions[j];
+        }
+    }
+
+    free(keys);
+    free(order);
+    return success;
+}
+
+/**
+ * Add the positions of the intervals in a range of a TimeIntervalIndex's
+ * ordered starts to the results of a query.
+ */
+static size_t
+time_interval_report(
+        const size_t * const from,
+        size_t count,
+        size_t * const positions,
+        size_t capacity,
+        size_t found)
+{
+    if (found < capacity) {
+        memcpy(positions + found, from,
+                (capacity - found < count ? capacity - found : count) *
+                sizeof(size_t));
+    }
+    return found + count;
+}
+
+/**
+ * Find the intervals of a TimeIntervalIndex that contain a timestamp (given
+ * as seconds and nanoseconds).
+ *
+ * @return The number of matching intervals, plus @p found (the number of
+ * positions already in @p positions).
+ */
+static size_t
+time_interval_stab(
+        const struct TimeIntervalIndex * const self,
+        int_timestamp seconds,
+        int_timestamp nanoseconds,
+        size_t * const positions,
+        size_t capacity,
+        size_t found)
+{
+    const int_timestamp * const centers = TIME_INTERVAL_CENTERS(self);
+    const int_timestamp * const node_starts = TIME_INTERVAL_NODE_STARTS(self);
+    const int_timestamp * const node_ends = TIME_INTERVAL_NODE_ENDS(self);
+    const size_t * node;
+    size_t k, i, first;
+
+    k = self->node_count_ > 0 ? 0 : TIME_INTERVAL_NO_NODE;
+    while (k != TIME_INTERVAL_NO_NODE) {
+        node = TIME_INTERVAL_NODE(self, k);
+        first = node[0];
+        i = 0;
+        if (TIME_INTERVAL_LESS(seconds, nanoseconds,
+                    centers[k], centers[self->node_count_ + k])) {
+            /* Every interval in the node ends after the timestamp, so the
+               matches are the ones that start at or before it */
+            while (i < node[1] && !TIME_INTERVAL_LESS(
+                        seconds, nanoseconds,
+                        node_starts[first + i],
+                        node_starts[self->count_ + first + i])) {
+                i++;
+            }
+            found = time_interval_report(
+                    TIME_INTERVAL_NODE_START_POSITIONS(self) + first, i,
+                    positions, capacity, found);
+            k = node[2];
+        } else {
+            /* Every interval in the node starts at or before the timestamp,
+               so the matches are the ones that end after it */
+            while (i < node[1] && TIME_INTERVAL_LESS(
+                        seconds, nanoseconds,
+                        node_ends[first + i],
+                        node_ends[self->count_ + first + i])) {
+                i++;
+            }
+            found = time_interval_report(
+                    TIME_INTERVAL_NODE_END_POSITIONS(self) + first, i,
+                    positions, capacity, found);
+            k = node[3];
+        }
+    }
+    return found;
+}
+
+/**
+ * Find the number of (non-empty) intervals of a TimeIntervalIndex that start
+ * before a timestamp (given as seconds and nanoseconds).
+ */
+static size_t
+time_interval_search(
+        const struct TimeIntervalIndex * const self,
+        int_timestamp seconds,
+        int_timestamp nanoseconds)
+{
+    const int_timestamp * const starts = TIME_INTERVAL_STARTS(self);
+    size_t first = 0, size = self->count_, half;
+
+    while (size > 0) {
+        half = size / 2;
+        if (TIME_INTERVAL_LESS(starts[first + half],
+                    starts[self->count_ + first + half],
+                    seconds, nanoseconds)) {
+            first += half + 1;
+            size -= half + 1;
+        } else {
+            size = half;
+        }
+    }
+    return first;
+}
+
+/*
+ * TimeInterval
+ */
+
+struct TimeInterval
+TimeInterval_create(
+        const struct Timestamp * const start,
+        const struct Timestamp * const end)
+{
+    struct TimeInterval result;
+
+    assert(start != NULL);
+    assert(start->has_error == 0);
+    assert(end != NULL);
+    assert(end->has_error == 0);
+    assert(Timestamp_less_than_or_equal(start, end));
+
+    result.start = *start;
+    result.end = *end;
+    return result;
+}
+
+struct TimeInterval
+TimeInterval_from_duration(
+        const struct Timestamp * const start,
+        const struct TimeDelta * const duration)
+{
+    struct TimeInterval result;
+
+    assert(start != NULL);
+    assert(start->has_error == 0);
+    assert(duration != NULL);
+    assert(!TimeDelta_is_negative(duration));
+
+    result.start = *start;
+    result.end = *start;
+    Timestamp_add_TimeDelta(&result.end, duration);
+    return result;
+}
+
+struct TimeDelta
+TimeInterval_duration(const struct TimeInterval * const self)
+{
+    assert(self != NULL);
+
+    return Timestamp_difference(&self->end, &self->start);
+}
+
+present_bool
+TimeInterval_is_empty(const struct TimeInterval * const self)
+{
+    assert(self != NULL);
+
+    return Timestamp_equal(&self->start, &self->end);
+}
+
+present_bool
+TimeInterval_contains(
+        const struct TimeInterval * const self,
+        const struct Timestamp * const timestamp)
+{
+    assert(self != NULL);
+    assert(timestamp != NULL);
+
+    return Timestamp_less_than_or_equal(&self->start, timestamp) &&
+        Timestamp_less_than(timestamp, &self->end);
+}
+
+present_bool
+TimeInterval_contains_interval(
+        const struct TimeInterval * const self,
+        const struct TimeInterval * const other)
+{
+    assert(self != NULL);
+    assert(other != NULL);
+
+    return Timestamp_less_than_or_equal(&self->start, &other->start) &&
+        Timestamp_less_than_or_equal(&other->end, &self->end);
+}
+
+present_bool
+TimeInterval_overlaps(
+        const struct TimeInterval * const self,
+        const struct TimeInterval * const other)
+{
+    assert(self != NULL);
+    assert(other != NULL);
+
+    /* Neither one is empty, and each one starts before the other one ends */
+    return Timestamp_less_than(&self->start, &self->end) &&
+        Timestamp_less_than(&other->start, &other->end) &&
+        Timestamp_less_than(&self->start, &other->end) &&
+        Timestamp_less_than(&other->start, &self->end);
+}
+
+struct TimeInterval
+TimeInterval_intersection(
+        const struct TimeInterval * const self,
+        const struct TimeInterval * const other)
+{
+    struct TimeInterval result;
+
+    assert(self != NULL);
+    assert(other != NULL);
+
+    result.start = Timestamp_less_than(&self->start, &other->start) ?
+        other->start : self->start;
+    result.end = Timestamp_less_than(&self->end, &other->end) ?
+        self->end : other->end;
+    if (Timestamp_less_than(&result.end, &result.start)) {
+        result.end = result.start;
+    }
+    return result;
+}
+
+present_bool
+TimeInterval_equal(
+        const struct TimeInterval * const lhs,
+        const struct TimeInterval * const rhs)
+{
+    assert(lhs != NULL);
+    assert(rhs != NULL);
+
+    return Timestamp_equal(&lhs->start, &rhs->start) &&
+        Timestamp_equal(&lhs->end, &rhs->end);
+}
+
+/*
+ * TimeIntervalIndex
+ */
+
+void
+TimeIntervalIndex_init(struct TimeIntervalIndex * const self)
+{
+    assert(self != NULL);
+
+    self->size_ = 0;
+    self->count_ = 0;
+    self->node_count_ = 0;
+    self->times_ = NULL;
+    self->links_ = NULL;
+}
+
+void
+TimeIntervalIndex_destroy(struct TimeIntervalIndex * const self)
+{
+    assert(self != NULL);
+
+    present_aligned_free(self->times_);
+    present_aligned_free(self->links_);
+    TimeIntervalIndex_init(self);
+}
+
+present_bool
+TimeIntervalIndex_build(
+        struct TimeIntervalIndex * const self,
+        const struct TimeInterval * const intervals,
+        size_t count)
+{
+    struct TimeIntervalBuild build;
+    int_timestamp * old_times;
+    size_t * old_links;
+    size_t old_size, old_count, old_node_count;
+    size_t i, n;
+    present_bool success;
+
+    assert(self != NULL);
+    assert(intervals != NULL || count == 0);
+
+    /* Only the intervals that are not empty can match a query */
+    n = 0;
+    for (i = 0; i < count; i++) {
+        assert(intervals[i].start.has_error == 0);
+        assert(intervals[i].end.has_error == 0);
+        assert(Timestamp_less_than_or_equal(
+                    &intervals[i].start, &intervals[i].end));
+        assert(i == 0 || Timestamp_less_than_or_equal(
+                    &intervals[i - 1].start, &intervals[i].start));
+        n += !TimeInterval_is_empty(&intervals[i]);
+    }
+
+    /* There are at most n nodes (since each one holds at least 1 interval),
+       so the arrays are allocated for that many */
+    if (n > (size_t)-1 / 8 / sizeof(int_timestamp)) {
+        return 0;
+    }
+    old_times = self->times_;
+    old_links = self->links_;
+    old_size = self->size_;
+    old_count = self->count_;
+    old_node_count = self->node_count_;
+    self->times_ = NULL;
+    self->links_ = NULL;
+    build.end_seconds = NULL;
+    build.nodes = NULL;
+    if (n > 0) {
+        self->times_ = (int_timestamp *) present_aligned_alloc(
+                8 * n * sizeof(int_timestamp), TIME_INTERVAL_ALIGNMENT);
+        self->links_ = (size_t *) present_aligned_alloc(
+                7 * n * sizeof(size_t), TIME_INTERVAL_ALIGNMENT);
+        build.end_seconds = (int_timestamp *) malloc(
+                2 * n * sizeof(int_timestamp));
+        build.nodes = (size_t *) malloc(3 * n * sizeof(size_t));
+    }
+    success = n == 0 || (self->times_ != NULL && self->links_ != NULL &&
+            build.end_seconds != NULL && build.nodes != NULL);
+
+    if (success) {
+        self->size_ = count;
+        self->count_ = n;
+        /* Until the tree is built, the node arrays are laid out for n
+           nodes */
+        self->node_count_ = n;
+        n = 0;
+        for (i = 0; i < count; i++) {
+            if (!TimeInterval_is_empty(&intervals[i])) {
+                self->times_[n] = intervals[i].start.data_.timestamp_seconds;
+                self->times_[self->count_ + n] =
+                    intervals[i].start.data_.additional_nanoseconds;
+                self->links_[n] = i;
+                n++;
+            }
+        }
+    }
+    if (success && n > 0) {
+        build.end_nanoseconds = build.end_seconds + n;
+        build.pending = build.nodes + n;
+        build.split = build.nodes + 2 * n;
+        build.node_count = 0;
+        build.entry_count = 0;
+        n = 0;
+        for (i = 0; i < count; i++) {
+            if (!TimeInterval_is_empty(&intervals[i])) {
+                build.end_seconds[n] = intervals[i].end.data_.timestamp_seconds;
+                build.end_nanoseconds[n] =
+                    intervals[i].end.data_.additional_nanoseconds;
+                build.pending[n] = n;
+                n++;
+            }
+        }
+
+        time_interval_build_node(self, &build, build.pending, n);
+
+        /* Move the node arrays that follow the centers up to where they go
+           with the actual number of nodes */
+        i = build.node_count;
+        memmove(TIME_INTERVAL_CENTERS(self) + i,
+                TIME_INTERVAL_CENTERS(self) + n, i * sizeof(int_timestamp));
+        memmove(TIME_INTERVAL_CENTERS(self) + 2 * i,
+                TIME_INTERVAL_NODE_STARTS(self),
+                2 * n * sizeof(int_timestamp));
+        memmove(TIME_INTERVAL_NODE(self, i),
+                TIME_INTERVAL_NODE_START_POSITIONS(self),
+                n * sizeof(size_t));
+        self->node_count_ = i;
+
+        success = time_interval_fill_ends(self, &build);
+    }
+    free(build.end_seconds);
+    free(build.nodes);
+
+    if (!success) {
+        present_aligned_free(self->times_);
+        present_aligned_free(self->links_);
+        self->times_ = old_times;
+        self->links_ = old_links;
+        self->size_ = old_size;
+        self->count_ = old_count;
+        self->node_count_ = old_node_count;
+        return 0;
+    }
+    present_aligned_free(old_times);
+    present_aligned_free(old_links);
+    if (self->count_ == 0) {
+        /* Every interval was empty, so there is nothing to search */
+        present_aligned_free(self->times_);
+        present_aligned_free(self->links_);
+        self->times_ = NULL;
+        self->links_ = NULL;
+        self->node_count_ = 0;
+    }
+    return 1;
+}
+
+present_bool
+TimeIntervalIndex_assign(
+        struct TimeIntervalIndex * const self,
+        const struct TimeIntervalIndex * const other)
+{
+    int_timestamp * times = NULL;
+    size_t * links = NULL;
+    size_t time_count, link_count;
+
+    assert(self != NULL);
+    assert(other != NULL);
+
+    if (self == other) {
+        return 1;
+    }
+
+    time_count = 6 * other->count_ + 2 * other->node_count_;
+    link_count = 3 * other->count_ + 4 * other->node_count_;
+    if (other->count_ > 0) {
+        times = (int_timestamp *) present_aligned_alloc(
+                time_count * sizeof(int_timestamp), TIME_INTERVAL_ALIGNMENT);
+        links = (size_t *) present_aligned_alloc(
+                link_count * sizeof(size_t), TIME_INTERVAL_ALIGNMENT);
+        if (times == NULL || links == NULL) {
+            present_aligned_free(times);
+            present_aligned_free(links);
+            return 0;
+        }
+        memcpy(times, other->times_, time_count * sizeof(int_timestamp));
+        memcpy(links, other->links_, link_count * sizeof(size_t));
+    }
+
+    present_aligned_free(self->times_);
+    present_aligned_free(self->links_);
+    self->times_ = times;
+    self->links_ = links;
+    self->size_ = other->size_;
+    self->count_ = other->count_;
+    self->node_count_ = other->node_count_;
+    return 1;
+}
+
+size_t
+TimeIntervalIndex_find_containing(
+        const struct TimeIntervalIndex * const self,
+        const struct Timestamp * const timestamp,
+        size_t * const positions,
+        size_t capacity)
+{
+    assert(self != NULL);
+    assert(timestamp != NULL);
+    assert(timestamp->has_error == 0);
+    assert(positions != NULL || capacity == 0);
+
+    return time_interval_stab(self, timestamp->data_.timestamp_seconds,
+            timestamp->data_.additional_nanoseconds, positions, capacity, 0);
+}
+
+size_t
+TimeIntervalIndex_find_overlapping(
+        const struct TimeIntervalIndex * const self,
+        const struct TimeInterval * const interval,
+        size_t * const positions,
+        size_t capacity)
+{
+    size_t found, first, end;
+
+    assert(self != NULL);
+    assert(interval != NULL);
+    assert(positions != NULL || capacity == 0);
+
+    if (TimeInterval_is_empty(interval)) {
+        return 0;
+    }
+
+    /* An interval overlaps the query if it contains the query's start, or
+       (if not) if it starts after the query's start and before its end */
+    found = time_interval_stab(self, interval->start.data_.timestamp_seconds,
+            interval->start.data_.additional_nanoseconds, positions, capacity,
+            0);
+    first = time_interval_search(self,
+            interval->start.data_.timestamp_seconds,
+            interval->start.data_.additional_nanoseconds + 1);
+    end = time_interval_search(self,
+            interval->end.data_.timestamp_seconds,
+            interval->end.data_.additional_nanoseconds);
+    if (end > first) {
+        found = time_interval_report(TIME_INTERVAL_POSITIONS(self) + first,
+                end - first, positions, capacity, found);
+    }
+    return found;
+}
+
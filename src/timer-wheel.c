@@ -0,0 +1,705 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementation of the TimerWheel, TimerWheelTimer, and TimerWheelGroup
+ * methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "present-config.h"
+#include "present.h"
+
+#ifdef PRESENT_USE_PTHREAD
+# include <pthread.h>
+#endif
+
+#include "utils/bit-utils.h"
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/memory-utils.h"
+
+/** The number of bits of a tick that all of the levels cover. */
+#define WHEEL_BITS \
+    (PRESENT_TIMER_WHEEL_LEVELS * PRESENT_TIMER_WHEEL_LEVEL_BITS)
+
+/** The lists that a timer can be in, other than a slot. */
+#define WHEEL_LIST_OVERFLOW \
+    (PRESENT_TIMER_WHEEL_LEVELS * PRESENT_TIMER_WHEEL_SLOTS)
+#define WHEEL_LIST_PENDING  (WHEEL_LIST_OVERFLOW + 1)
+#define WHEEL_LIST_EXPIRED  (WHEEL_LIST_OVERFLOW + 2)
+
+/**
+ * The furthest from the start of a wheel that a time may be, in seconds
+ * (about 126 years), so that its number of nanoseconds fits in 63 bits.
+ */
+#define WHEEL_MAX_SECONDS   4000000000
+
+/** The size of a cache line (that each shard of a group is aligned to). */
+#define WHEEL_CACHE_LINE    64
+
+/**
+ * A shard of a TimerWheelGroup, padded out to a whole number of cache lines.
+ */
+struct TimerWheelShard {
+    struct TimerWheel wheel;
+#ifdef PRESENT_USE_PTHREAD
+    pthread_mutex_t lock;
+#endif
+};
+
+/** The size of each shard of a TimerWheelGroup (including its padding). */
+#define WHEEL_SHARD_SIZE                                                    \
+    ((sizeof(struct TimerWheelShard) + WHEEL_CACHE_LINE - 1) /              \
+     WHEEL_CACHE_LINE * WHEEL_CACHE_LINE)
+
+/** Get a shard of a TimerWheelGroup. */
+#define WHEEL_SHARD(group, shard)                                           \
+    ((struct TimerWheelShard *) ((char *) (group)->shards_ +                \
+                                 (shard) * WHEEL_SHARD_SIZE))
+
+#ifdef PRESENT_USE_PTHREAD
+# define WHEEL_LOCK(shard)      pthread_mutex_lock(&(shard)->lock)
+# define WHEEL_UNLOCK(shard)    pthread_mutex_unlock(&(shard)->lock)
+#else
+# define WHEEL_LOCK(shard)
+# define WHEEL_UNLOCK(shard)
+#endif
+
+/**
+ * Get the number of nanoseconds from the start of a wheel to a point in
+ * time (clamped to WHEEL_MAX_SECONDS either way).
+ */
+static int_timestamp
+wheel_nanoseconds(
+        const struct TimerWheel * const self,
+        const struct Timestamp * const timestamp)
+{
+    int_timestamp seconds = timestamp->data_.timestamp_seconds -
+        self->start_.data_.timestamp_seconds;
+    if (seconds > WHEEL_MAX_SECONDS) {
+        seconds = WHEEL_MAX_SECONDS;
+    } else if (seconds < -WHEEL_MAX_SECONDS) {
+        seconds = -WHEEL_MAX_SECONDS;
+    }
+    return seconds * NANOSECONDS_IN_SECOND +
+        (timestamp->data_.additional_nanoseconds -
+         self->start_.data_.additional_nanoseconds);
+}
+
+/** Get the first tick that ends at or after a point in time. */
+static int_timestamp
+wheel_tick_at_or_after(
+        const struct TimerWheel * const self,
+        const struct Timestamp * const timestamp)
+{
+    const int_timestamp nanoseconds = wheel_nanoseconds(self, timestamp);
+    if (nanoseconds > 0) {
+        return (nanoseconds - 1) / self->resolution_ + 1;
+    }
+    return -(-nanoseconds / self->resolution_);
+}
+
+/** Get the last tick that ends at or before a point in time. */
+static int_timestamp
+wheel_tick_at_or_before(
+        const struct TimerWheel * const self,
+        const struct Timestamp * const timestamp)
+{
+    const int_timestamp nanoseconds = wheel_nanoseconds(self, timestamp);
+    if (nanoseconds >= 0) {
+        return nanoseconds / self->resolution_;
+    }
+    return -((-nanoseconds - 1) / self->resolution_ + 1);
+}
+
+/** Get the time at the end of a tick. */
+static struct Timestamp
+wheel_tick_time(const struct TimerWheel * const self, int_timestamp tick)
+{
+    const int_timestamp max_tick = (int_timestamp)WHEEL_MAX_SECONDS *
+        NANOSECONDS_IN_SECOND / self->resolution_;
+    struct Timestamp result = self->start_;
+    struct TimeDelta delta;
+
+    if (tick > max_tick) {
+        tick = max_tick;
+    }
+    delta = TimeDelta_from_nanoseconds(tick * self->resolution_);
+    Timestamp_add_TimeDelta(&result, &delta);
+    return result;
+}
+
+/** Add a timer to the front of a list. */
+static PRESENT_INLINE void
+wheel_push(
+        struct TimerWheelTimer ** const head,
+        struct TimerWheelTimer * const timer,
+        int list)
+{
+    timer->next_ = *head;
+    timer->pprev_ = head;
+    if (*head != NULL) {
+        (*head)->pprev_ = &timer->next_;
+    }
+    *head = timer;
+    timer->list_ = list;
+}
+
+/** Remove a timer from the list that it is in. */
+static PRESENT_INLINE void
+wheel_unlink(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer)
+{
+    int level, slot;
+
+    *timer->pprev_ = timer->next_;
+    if (timer->next_ != NULL) {
+        timer->next_->pprev_ = timer->pprev_;
+    }
+    if (timer->list_ < WHEEL_LIST_OVERFLOW) {
+        level = timer->list_ / PRESENT_TIMER_WHEEL_SLOTS;
+        slot = timer->list_ % PRESENT_TIMER_WHEEL_SLOTS;
+        if (self->slots_[level][slot] == NULL) {
+            self->occupied_[level] &= ~((present_uint64)1 << slot);
+        }
+    }
+    timer->next_ = NULL;
+    timer->pprev_ = NULL;
+}
+
+/**
+ * Put a timer whose tick is at or after the current tick into its slot (in
+ * the lowest level whose slots are wide enough that the timer's tick and the
+ * current tick only differ in that level's bits, or below).
+ */
+static void
+wheel_place(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer)
+{
+    const present_uint64 differing = (present_uint64)
+        (timer->tick_ ^ self->tick_);
+    int level, slot;
+
+    assert(timer->tick_ >= self->tick_);
+
+    level = differing == 0 ? 0 :
+        present_highest_bit(differing) / PRESENT_TIMER_WHEEL_LEVEL_BITS;
+    if (level >= PRESENT_TIMER_WHEEL_LEVELS) {
+        wheel_push(&self->overflow_, timer, WHEEL_LIST_OVERFLOW);
+        return;
+    }
+    slot = (int)((timer->tick_ >> (level * PRESENT_TIMER_WHEEL_LEVEL_BITS)) &
+            (PRESENT_TIMER_WHEEL_SLOTS - 1));
+    wheel_push(&self->slots_[level][slot], timer,
+            level * PRESENT_TIMER_WHEEL_SLOTS + slot);
+    self->occupied_[level] |= (present_uint64)1 << slot;
+}
+
+/** Schedule a timer at a tick. */
+static void
+wheel_schedule(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer,
+        int_timestamp tick)
+{
+    if (timer->wheel_ == self) {
+        wheel_unlink(self, timer);
+    } else {
+        assert(timer->wheel_ == NULL);
+        timer->wheel_ = self;
+        ++self->size_;
+    }
+    timer->tick_ = tick;
+    if (tick <= self->tick_) {
+        wheel_push(&self->pending_, timer, WHEEL_LIST_PENDING);
+    } else {
+        wheel_place(self, timer);
+    }
+}
+
+/** Cancel a timer, if it is scheduled on a wheel. */
+static present_bool
+wheel_cancel(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer)
+{
+    if (timer->wheel_ != self) {
+        return 0;
+    }
+    wheel_unlink(self, timer);
+    timer->wheel_ = NULL;
+    --self->size_;
+    return 1;
+}
+
+/** Move every timer of a list to the list of expired timers. */
+static void
+wheel_expire_list(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer ** const head)
+{
+    struct TimerWheelTimer * timer = *head;
+    struct TimerWheelTimer * next;
+
+    *head = NULL;
+    for (; timer != NULL; timer = next) {
+        next = timer->next_;
+        wheel_push(&self->expired_, timer, WHEEL_LIST_EXPIRED);
+    }
+}
+
+/**
+ * Reverse the list of expired timers of a wheel (which wheel_expire_list
+ * builds up back to front), so that they are called back in order.
+ */
+static void
+wheel_reverse_expired(struct TimerWheel * const self)
+{
+    struct TimerWheelTimer * timer = self->expired_;
+    struct TimerWheelTimer * next;
+
+    self->expired_ = NULL;
+    for (; timer != NULL; timer = next) {
+        next = timer->next_;
+        wheel_push(&self->expired_, timer, WHEEL_LIST_EXPIRED);
+    }
+}
+
+/** Move every timer of a list back into the wheel (at the current tick). */
+static void
+wheel_cascade_list(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer ** const head)
+{
+    struct TimerWheelTimer * timer = *head;
+    struct TimerWheelTimer * next;
+
+    *head = NULL;
+    for (; timer != NULL; timer = next) {
+        next = timer->next_;
+        wheel_place(self, timer);
+    }
+}
+
+/**
+ * Get the next tick (after the current tick) at which a wheel has any work
+ * to do, or -1 if it has none: the start of the next slot in any level that
+ * has timers, or the start of the next 2^36 ticks if there are any timers
+ * beyond the highest level.
+ *
+ * Every timer in a level is within the current slot of the level above it,
+ * and after the current slot of its own level, so the next slot of each
+ * level is the next set bit of its mask after the current slot.
+ */
+static int_timestamp
+wheel_next_tick(const struct TimerWheel * const self)
+{
+    int_timestamp result = -1, tick;
+    present_uint64 later;
+    int level, shift, slot;
+
+    for (level = 0; level < PRESENT_TIMER_WHEEL_LEVELS; ++level) {
+        shift = level * PRESENT_TIMER_WHEEL_LEVEL_BITS;
+        slot = (int)((self->tick_ >> shift) & (PRESENT_TIMER_WHEEL_SLOTS - 1));
+        later = self->occupied_[level] & ~(((present_uint64)2 << slot) - 1);
+        if (later != 0) {
+            tick = ((self->tick_ >> (shift + PRESENT_TIMER_WHEEL_LEVEL_BITS))
+                    << (shift + PRESENT_TIMER_WHEEL_LEVEL_BITS)) |
+                ((int_timestamp)present_lowest_bit(later) << shift);
+            if (result < 0 || tick < result) {
+                result = tick;
+            }
+        }
+    }
+    if (self->overflow_ != NULL) {
+        tick = ((self->tick_ >> WHEEL_BITS) + 1) << WHEEL_BITS;
+        if (result < 0 || tick < result) {
+            result = tick;
+        }
+    }
+    return result;
+}
+
+/**
+ * Move the current tick of a wheel forward to a target tick, moving every
+ * timer that expires on the way (and every pending timer) to the list of
+ * expired timers.
+ */
+static void
+wheel_collect(struct TimerWheel * const self, int_timestamp target)
+{
+    int_timestamp next;
+    int level, shift, slot;
+
+    wheel_expire_list(self, &self->pending_);
+
+    while (self->tick_ < target) {
+        next = wheel_next_tick(self);
+        if (next < 0 || next > target) {
+            self->tick_ = target;
+            break;
+        }
+        self->tick_ = next;
+
+        /* Move the timers of the slots that start at this tick down, from
+           the top level to the bottom, then expire the bottom slot */
+        if ((next & (((int_timestamp)1 << WHEEL_BITS) - 1)) == 0) {
+            wheel_cascade_list(self, &self->overflow_);
+        }
+        for (level = PRESENT_TIMER_WHEEL_LEVELS - 1; level >= 0; --level) {
+            shift = level * PRESENT_TIMER_WHEEL_LEVEL_BITS;
+            if ((next & (((int_timestamp)1 << shift) - 1)) != 0) {
+                continue;
+            }
+            slot = (int)((next >> shift) & (PRESENT_TIMER_WHEEL_SLOTS - 1));
+            if (!((self->occupied_[level] >> slot) & 1)) {
+                continue;
+            }
+            self->occupied_[level] &= ~((present_uint64)1 << slot);
+            if (level > 0) {
+                wheel_cascade_list(self, &self->slots_[level][slot]);
+            } else {
+                wheel_expire_list(self, &self->slots_[level][slot]);
+            }
+        }
+    }
+    wheel_reverse_expired(self);
+}
+
+/**
+ * Take the next timer off the list of expired timers of a wheel (or get
+ * NULL if there are none).
+ */
+static struct TimerWheelTimer *
+wheel_pop_expired(struct TimerWheel * const self)
+{
+    struct TimerWheelTimer * const timer = self->expired_;
+    if (timer != NULL) {
+        wheel_cancel(self, timer);
+    }
+    return timer;
+}
+
+/*
+ * TimerWheelTimer
+ */
+
+void
+TimerWheelTimer_init(struct TimerWheelTimer * const self)
+{
+    assert(self != NULL);
+    CLEAR(self);
+}
+
+present_bool
+TimerWheelTimer_is_scheduled(const struct TimerWheelTimer * const self)
+{
+    assert(self != NULL);
+    return self->wheel_ != NULL;
+}
+
+/*
+ * TimerWheel
+ */
+
+void
+TimerWheel_init(
+        struct TimerWheel * const self,
+        const struct Timestamp * const start,
+        const struct TimeDelta * const resolution)
+{
+    assert(self != NULL);
+    assert(start != NULL);
+    assert(resolution != NULL);
+    assert(resolution->data_.delta_seconds > 0 ||
+            (resolution->data_.delta_seconds == 0 &&
+             resolution->data_.delta_nanoseconds > 0));
+    assert(resolution->data_.delta_seconds < WHEEL_MAX_SECONDS);
+
+    CLEAR(self);
+    self->start_ = *start;
+    self->now_ = *start;
+    self->resolution_ = resolution->data_.delta_seconds *
+        NANOSECONDS_IN_SECOND + resolution->data_.delta_nanoseconds;
+}
+
+size_t
+TimerWheel_count(const struct TimerWheel * const self)
+{
+    assert(self != NULL);
+    return self->size_;
+}
+
+struct Timestamp
+TimerWheel_get_now(const struct TimerWheel * const self)
+{
+    assert(self != NULL);
+    return self->now_;
+}
+
+present_bool
+TimerWheel_next_event(
+        const struct TimerWheel * const self,
+        struct Timestamp * const result)
+{
+    int_timestamp tick;
+
+    assert(self != NULL);
+    assert(result != NULL);
+
+    if (self->pending_ != NULL) {
+        *result = self->now_;
+        return 1;
+    }
+    tick = wheel_next_tick(self);
+    if (tick < 0) {
+        return 0;
+    }
+    *result = wheel_tick_time(self, tick);
+    return 1;
+}
+
+void
+TimerWheel_schedule_at(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer,
+        const struct Timestamp * const deadline)
+{
+    assert(self != NULL);
+    assert(timer != NULL);
+    assert(deadline != NULL);
+
+    wheel_schedule(self, timer, wheel_tick_at_or_after(self, deadline));
+}
+
+void
+TimerWheel_schedule_after(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer,
+        const struct TimeDelta * const delay)
+{
+    struct Timestamp deadline;
+
+    assert(self != NULL);
+    assert(delay != NULL);
+
+    deadline = self->now_;
+    Timestamp_add_TimeDelta(&deadline, delay);
+    TimerWheel_schedule_at(self, timer, &deadline);
+}
+
+present_bool
+TimerWheel_cancel(
+        struct TimerWheel * const self,
+        struct TimerWheelTimer * const timer)
+{
+    assert(self != NULL);
+    assert(timer != NULL);
+
+    return wheel_cancel(self, timer);
+}
+
+size_t
+TimerWheel_advance(
+        struct TimerWheel * const self,
+        const struct Timestamp * const now,
+        TimerWheelCallback callback,
+        void * context)
+{
+    struct TimerWheelTimer * timer;
+    size_t count = 0;
+
+    assert(self != NULL);
+    assert(now != NULL);
+    assert(callback != NULL);
+
+    if (Timestamp_greater_than(now, &self->now_)) {
+        self->now_ = *now;
+    }
+    wheel_collect(self, wheel_tick_at_or_before(self, &self->now_));
+    while ((timer = wheel_pop_expired(self)) != NULL) {
+        callback(timer, context);
+        ++count;
+    }
+    return count;
+}
+
+size_t
+TimerWheel_advance_to_now(
+        struct TimerWheel * const self,
+        TimerWheelCallback callback,
+        void * context)
+{
+    const struct Timestamp now = Timestamp_now();
+    return TimerWheel_advance(self, &now, callback, context);
+}
+
+/*
+ * TimerWheelGroup
+ */
+
+present_bool
+TimerWheelGroup_init(
+        struct TimerWheelGroup * const self,
+        size_t shard_count,
+        const struct Timestamp * const start,
+        const struct TimeDelta * const resolution)
+{
+    struct TimerWheelShard * shard;
+    size_t i;
+
+    assert(self != NULL);
+
+    CLEAR(self);
+    if (shard_count == 0) {
+        return 1;
+    }
+    self->shards_ = (struct TimerWheelShard *) present_aligned_alloc(
+            shard_count * WHEEL_SHARD_SIZE, WHEEL_CACHE_LINE);
+    if (self->shards_ == NULL) {
+        return 0;
+    }
+    for (i = 0; i < shard_count; ++i) {
+        shard = WHEEL_SHARD(self, i);
+        TimerWheel_init(&shard->wheel, start, resolution);
+#ifdef PRESENT_USE_PTHREAD
+        if (pthread_mutex_init(&shard->lock, NULL) != 0) {
+            self->shard_count_ = i;
+            TimerWheelGroup_destroy(self);
+            return 0;
+        }
+#endif
+    }
+    self->shard_count_ = shard_count;
+    return 1;
+}
+
+void
+TimerWheelGroup_destroy(struct TimerWheelGroup * const self)
+{
+#ifdef PRESENT_USE_PTHREAD
+    size_t i;
+#endif
+
+    assert(self != NULL);
+
+#ifdef PRESENT_USE_PTHREAD
+    for (i = 0; i < self->shard_count_; ++i) {
+        pthread_mutex_destroy(&WHEEL_SHARD(self, i)->lock);
+    }
+#endif
+    present_aligned_free(self->shards_);
+    CLEAR(self);
+}
+
+size_t
+TimerWheelGroup_shard_count(const struct TimerWheelGroup * const self)
+{
+    assert(self != NULL);
+    return self->shard_count_;
+}
+
+void
+TimerWheelGroup_schedule_at(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        struct TimerWheelTimer * const timer,
+        const struct Timestamp * const deadline)
+{
+    struct TimerWheelShard * s;
+
+    assert(self != NULL);
+    assert(shard < self->shard_count_);
+
+    s = WHEEL_SHARD(self, shard);
+    WHEEL_LOCK(s);
+    TimerWheel_schedule_at(&s->wheel, timer, deadline);
+    WHEEL_UNLOCK(s);
+}
+
+void
+TimerWheelGroup_schedule_after(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        struct TimerWheelTimer * const timer,
+        const struct TimeDelta * const delay)
+{
+    struct TimerWheelShard * s;
+
+    assert(self != NULL);
+    assert(shard < self->shard_count_);
+
+    s = WHEEL_SHARD(self, shard);
+    WHEEL_LOCK(s);
+    TimerWheel_schedule_after(&s->wheel, timer, delay);
+    WHEEL_UNLOCK(s);
+}
+
+present_bool
+TimerWheelGroup_cancel(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        struct TimerWheelTimer * const timer)
+{
+    struct TimerWheelShard * s;
+    present_bool result;
+
+    assert(self != NULL);
+    assert(shard < self->shard_count_);
+
+    s = WHEEL_SHARD(self, shard);
+    WHEEL_LOCK(s);
+    result = TimerWheel_cancel(&s->wheel, timer);
+    WHEEL_UNLOCK(s);
+    return result;
+}
+
+size_t
+TimerWheelGroup_advance(
+        struct TimerWheelGroup * const self,
+        size_t shard,
+        const struct Timestamp * const now,
+        TimerWheelCallback callback,
+        void * context)
+{
+    struct TimerWheelShard * s;
+    struct TimerWheelTimer * timer;
+    size_t count = 0;
+
+    assert(self != NULL);
+    assert(shard < self->shard_count_);
+    assert(now != NULL);
+    assert(callback != NULL);
+
+    s = WHEEL_SHARD(self, shard);
+    WHEEL_LOCK(s);
+    if (Timestamp_greater_than(now, &s->wheel.now_)) {
+        s->wheel.now_ = *now;
+    }
+    wheel_collect(&s->wheel, wheel_tick_at_or_before(&s->wheel,
+                &s->wheel.now_));
+
+    /* The expired timers are taken off one at a time (so that another
+       thread can still cancel the ones that have not been called back yet),
+       and the lock is released for each callback */
+    for (;;) {
+        timer = wheel_pop_expired(&s->wheel);
+        WHEEL_UNLOCK(s);
+        if (timer == NULL) {
+            break;
+        }
+        callback(timer, context);
+        ++count;
+        WHEEL_LOCK(s);
+    }
+    return count;
+}
+
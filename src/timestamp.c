@@ -9,11 +9,14 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdlib.h>
 
 #include "present.h"
+#include "present/internal/format-utils.h"
 
 #include "utils/constants.h"
 #include "utils/impl-utils.h"
+#include "utils/sort-utils.h"
 #include "utils/time-utils.h"
 
 /**
@@ -96,6 +99,41 @@ init_timestamp(
     result->data_.additional_nanoseconds = additional_nanoseconds;
 }
 
+/**
+ * Find the start of the bucket that a Timestamp is in, where the buckets are
+ * @p width_seconds and @p width_nanoseconds wide, and one of them starts at
+ * @p origin_seconds and @p origin_nanoseconds (from 0 to 999,999,999).
+ */
+static struct Timestamp
+timestamp_bucket(
+        const struct Timestamp * const self,
+        int_delta width_seconds,
+        int_delta width_nanoseconds,
+        int_timestamp origin_seconds,
+        int_timestamp origin_nanoseconds)
+{
+    struct Timestamp result;
+    int_timestamp seconds, nanoseconds, into_seconds, into_nanoseconds;
+
+    seconds = self->data_.timestamp_seconds - origin_seconds;
+    nanoseconds = self->data_.additional_nanoseconds - origin_nanoseconds;
+    if (nanoseconds < 0) {
+        seconds -= 1;
+        nanoseconds += NANOSECONDS_IN_SECOND;
+    }
+
+    /* The Timestamp, less how far it is into its bucket (rather than origin
+       plus bucket number times width, since there can be more buckets than
+       fit in an int_delta) */
+    present_floor_mod_time(seconds, nanoseconds, width_seconds,
+            width_nanoseconds, &into_seconds, &into_nanoseconds);
+    init_timestamp(&result,
+            self->data_.timestamp_seconds - into_seconds,
+            self->data_.additional_nanoseconds - into_nanoseconds);
+    CHECK_DATA(result.data_);
+    return result;
+}
+
 /**
  * Initialize a new Timestamp instance based on a Date and a ClockTime in UTC.
  */
@@ -361,9 +399,14 @@ Timestamp_now(void)
 void
 Timestamp_ptr_now(struct Timestamp * const result)
 {
-    struct PresentNowStruct now;
-    present_now(&now);
-    init_timestamp(result, time_t_to_unix_timestamp(now.sec), now.nsec);
+    assert(result != NULL);
+
+    present_now(result);
+    /* Keep only the time (a clock source callback may leave the errors
+       unset, or nanoseconds of a second or more) */
+    init_timestamp(result, result->data_.timestamp_seconds,
+            result->data_.additional_nanoseconds);
+    CHECK_DATA(result->data_);
 }
 
 struct Timestamp
@@ -522,6 +565,173 @@ Timestamp_get_clock_time_local(const struct Timestamp * const self)
     return clock_time;
 }
 
+size_t
+Timestamp_format(
+        const struct Timestamp * const self,
+        const char * const format,
+        const struct TimeDelta * const time_zone_offset,
+        char * const buffer,
+        size_t buffer_size)
+{
+    struct PresentFormatFields fields;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(format != NULL);
+    assert(time_zone_offset != NULL);
+    assert(buffer != NULL);
+
+    CLEAR(&fields);
+    present_format_timestamp_fields(
+            &fields,
+            self->data_.timestamp_seconds,
+            self->data_.additional_nanoseconds,
+            TimeDelta_seconds(time_zone_offset));
+    return present_format(buffer, buffer_size, format,
+            PRESENT_FORMAT_DATE | PRESENT_FORMAT_CLOCK_TIME |
+            PRESENT_FORMAT_TIMESTAMP,
+            &fields);
+}
+
+size_t
+Timestamp_format_utc(
+        const struct Timestamp * const self,
+        const char * const format,
+        char * const buffer,
+        size_t buffer_size)
+{
+    const struct TimeDelta zero = TimeDelta_zero();
+    return Timestamp_format(self, format, &zero, buffer, buffer_size);
+}
+
+struct Timestamp
+Timestamp_truncate(
+        const struct Timestamp * const self,
+        int unit,
+        const struct TimeDelta * const time_zone_offset)
+{
+    struct PresentFormatFields fields;
+    struct Timestamp result;
+    int_delta width_seconds, width_nanoseconds;
+    int_timestamp origin_seconds, local_seconds, start;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(time_zone_offset != NULL);
+
+    if (present_truncate_unit_width(unit, &width_seconds,
+                &width_nanoseconds, &origin_seconds)) {
+        /* The origin is at midnight in the time zone */
+        init_timestamp(&result, origin_seconds, 0);
+        Timestamp_subtract_TimeDelta(&result, time_zone_offset);
+        return timestamp_bucket(self, width_seconds, width_nanoseconds,
+                result.data_.timestamp_seconds,
+                result.data_.additional_nanoseconds);
+    }
+
+    /* Find the date in the time zone (rounding the time zone's nanoseconds
+       into the seconds) */
+    local_seconds = self->data_.timestamp_seconds +
+        time_zone_offset->data_.delta_seconds;
+    local_seconds += present_format_floor_div(
+            self->data_.additional_nanoseconds +
+                time_zone_offset->data_.delta_nanoseconds,
+            NANOSECONDS_IN_SECOND);
+    present_format_timestamp_fields(&fields, local_seconds, 0, 0);
+
+    /* Midnight at the start of that date */
+    start = local_seconds - fields.clock_time.seconds;
+    if (unit == PRESENT_TRUNCATE_MONTH) {
+        start -= (int_timestamp)(fields.date.day - 1) * SECONDS_IN_DAY;
+    } else if (unit == PRESENT_TRUNCATE_QUARTER) {
+        start = to_unix_timestamp(fields.date.year,
+                (fields.date.month - 1) / 3 * 3 + 1, 1, 0, 0, 0);
+    } else {
+        start -= (int_timestamp)(fields.date.day_of_year - 1) *
+            SECONDS_IN_DAY;
+    }
+
+    init_timestamp(&result, start, 0);
+    Timestamp_subtract_TimeDelta(&result, time_zone_offset);
+    return result;
+}
+
+struct Timestamp
+Timestamp_truncate_utc(const struct Timestamp * const self, int unit)
+{
+    const struct TimeDelta zero = TimeDelta_zero();
+    return Timestamp_truncate(self, unit, &zero);
+}
+
+struct Timestamp
+Timestamp_bucket(
+        const struct Timestamp * const self,
+        const struct TimeDelta * const width,
+        const struct Timestamp * const origin)
+{
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(width != NULL);
+    assert(width->data_.delta_seconds > 0 ||
+            width->data_.delta_nanoseconds > 0);
+    assert(origin != NULL);
+    assert(origin->has_error == 0);
+
+    return timestamp_bucket(self, width->data_.delta_seconds,
+            width->data_.delta_nanoseconds, origin->data_.timestamp_seconds,
+            origin->data_.additional_nanoseconds);
+}
+
+size_t
+Timestamp_get_windows(
+        const struct Timestamp * const self,
+        const struct TimeDelta * const size,
+        const struct TimeDelta * const hop,
+        const struct Timestamp * const origin,
+        int_delta * const first,
+        int_delta * const last)
+{
+    int_timestamp seconds, nanoseconds;
+
+    assert(self != NULL);
+    assert(self->has_error == 0);
+    assert(size != NULL);
+    assert(size->data_.delta_seconds > 0 ||
+            size->data_.delta_nanoseconds > 0);
+    assert(hop != NULL);
+    assert(hop->data_.delta_seconds > 0 ||
+            hop->data_.delta_nanoseconds > 0);
+    assert(origin != NULL);
+    assert(origin->has_error == 0);
+    assert(first != NULL);
+    assert(last != NULL);
+
+    /* The last window is the last one that starts at or before the
+       timestamp */
+    seconds = self->data_.timestamp_seconds - origin->data_.timestamp_seconds;
+    nanoseconds = self->data_.additional_nanoseconds -
+        origin->data_.additional_nanoseconds;
+    if (nanoseconds < 0) {
+        seconds -= 1;
+        nanoseconds += NANOSECONDS_IN_SECOND;
+    }
+    *last = present_floor_div_time(seconds, nanoseconds,
+            hop->data_.delta_seconds, hop->data_.delta_nanoseconds);
+
+    /* The first window is the one after the last one that ends at or before
+       the timestamp (i.e. that starts at or before the timestamp - size) */
+    seconds -= size->data_.delta_seconds;
+    nanoseconds -= size->data_.delta_nanoseconds;
+    if (nanoseconds < 0) {
+        seconds -= 1;
+        nanoseconds += NANOSECONDS_IN_SECOND;
+    }
+    *first = present_floor_div_time(seconds, nanoseconds,
+            hop->data_.delta_seconds, hop->data_.delta_nanoseconds) + 1;
+
+    return *last >= *first ? (size_t)(*last - *first + 1) : 0;
+}
+
 struct TimeDelta
 Timestamp_difference(
         const struct Timestamp * const self,
@@ -679,3 +889,51 @@ Timestamp_compare(
 
 STRUCT_COMPARISON_OPERATORS(Timestamp)
 
+present_bool
+Timestamp_sort(struct Timestamp * const timestamps, size_t count)
+{
+    present_uint64 * seconds;
+    present_uint64 * nanoseconds;
+    size_t i;
+    present_bool success;
+
+    assert(timestamps != NULL || count == 0);
+
+    if (count < 2) {
+        return 1;
+    }
+
+    seconds = (present_uint64 *) malloc(count * sizeof(present_uint64));
+    nanoseconds = (present_uint64 *) malloc(count * sizeof(present_uint64));
+    success = seconds != NULL && nanoseconds != NULL;
+
+    if (success) {
+        for (i = 0; i < count; i++) {
+            assert(timestamps[i].has_error == 0);
+            /* Flipping the sign bit turns the seconds into unsigned keys in
+               the same order */
+            seconds[i] = (present_uint64)timestamps[i].data_.timestamp_seconds
+                ^ PRESENT_SORT_SIGN_BIT;
+            nanoseconds[i] =
+                (present_uint64)timestamps[i].data_.additional_nanoseconds;
+        }
+        success = present_radix_sort(seconds, nanoseconds, 30, NULL, count, 1);
+    }
+
+    if (success) {
+        /* The keys have everything in a Timestamp, so there is no need to
+           move the Timestamps themselves around while sorting */
+        for (i = 0; i < count; i++) {
+            CLEAR(&timestamps[i]);
+            timestamps[i].data_.timestamp_seconds =
+                (int_timestamp)(seconds[i] ^ PRESENT_SORT_SIGN_BIT);
+            timestamps[i].data_.additional_nanoseconds =
+                (int_timestamp)nanoseconds[i];
+        }
+    }
+
+    free(seconds);
+    free(nanoseconds);
+    return success;
+}
+
@@ -0,0 +1,87 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Utility functions for scanning the bits of 64-bit masks
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#ifndef _PRESENT_BIT_UTILS_H_
+#define _PRESENT_BIT_UTILS_H_
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+# include <intrin.h>
+# define PRESENT_HAVE_BIT_SCAN_64
+#endif
+
+/**
+ * Get the position of the lowest set bit of a (non-zero) value.
+ */
+static PRESENT_INLINE int
+present_lowest_bit(present_uint64 value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#elif defined(PRESENT_HAVE_BIT_SCAN_64)
+    unsigned long bit;
+    _BitScanForward64(&bit, value);
+    return (int)bit;
+#else
+    int bit = 0, shift;
+    for (shift = 32; shift > 0; shift >>= 1) {
+        if ((value & (((present_uint64)1 << shift) - 1)) == 0) {
+            value >>= shift;
+            bit += shift;
+        }
+    }
+    return bit;
+#endif
+}
+
+/**
+ * Get the position of the highest set bit of a (non-zero) value.
+ */
+static PRESENT_INLINE int
+present_highest_bit(present_uint64 value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#elif defined(PRESENT_HAVE_BIT_SCAN_64)
+    unsigned long bit;
+    _BitScanReverse64(&bit, value);
+    return (int)bit;
+#else
+    int bit = 0, shift;
+    for (shift = 32; shift > 0; shift >>= 1) {
+        if ((value >> shift) != 0) {
+            value >>= shift;
+            bit += shift;
+        }
+    }
+    return bit;
+#endif
+}
+
+/**
+ * Count the set bits of a value.
+ */
+static PRESENT_INLINE int
+present_popcount(present_uint64 value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    int count = 0;
+    while (value != 0) {
+        value &= value - 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+#endif /* _PRESENT_BIT_UTILS_H_ */
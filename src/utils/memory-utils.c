@@ -0,0 +1,52 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementations of utility functions for allocating memory
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/memory-utils.h"
+
+/*
+ * The pointer returned by malloc is stored right before the aligned block, so
+ * it can be passed to free by present_aligned_free.
+ */
+
+void *
+present_aligned_alloc(size_t size, size_t alignment)
+{
+    unsigned char * raw;
+    unsigned char * aligned;
+
+    if (size > (size_t)-1 - alignment - sizeof(void *)) {
+        return NULL;
+    }
+    raw = (unsigned char *) malloc(size + alignment + sizeof(void *));
+    if (raw == NULL) {
+        return NULL;
+    }
+
+    aligned = raw + sizeof(void *);
+    aligned += (alignment - (size_t)aligned % alignment) % alignment;
+    memcpy(aligned - sizeof(void *), &raw, sizeof(void *));
+    return aligned;
+}
+
+void
+present_aligned_free(void * aligned)
+{
+    unsigned char * raw;
+
+    if (aligned != NULL) {
+        memcpy(&raw, (unsigned char *)aligned - sizeof(void *),
+                sizeof(void *));
+        free(raw);
+    }
+}
+
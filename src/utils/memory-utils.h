@@ -0,0 +1,40 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Declarations of utility functions for allocating memory
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/header-utils.h"
+
+#ifndef _PRESENT_MEMORY_UTILS_H_
+#define _PRESENT_MEMORY_UTILS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocate @p size bytes, aligned to @p alignment bytes (which must be a
+ * power of 2).
+ *
+ * @return The aligned block (which must be freed with present_aligned_free),
+ * or NULL if it could not be allocated.
+ */
+PRESENT_INTERNAL_API void *
+present_aligned_alloc(size_t size, size_t alignment);
+
+/** Free memory allocated by present_aligned_alloc (or do nothing if NULL). */
+PRESENT_INTERNAL_API void
+present_aligned_free(void * aligned);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_MEMORY_UTILS_H_ */
+
@@ -0,0 +1,401 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementations of utility functions for sorting arrays of keys
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "present-config.h"
+
+#ifdef PRESENT_USE_PTHREAD
+# include <pthread.h>
+#endif
+
+#include "utils/sort-utils.h"
+
+/** The number of bits in each digit of a key. */
+#define RADIX_BITS      8
+/** The number of possible values of each digit of a key. */
+#define RADIX_SIZE      (1 << RADIX_BITS)
+/** The most digits in a key (64 high bits and up to 64 low bits). */
+#define RADIX_MAX_DIGITS    (2 * 64 / RADIX_BITS)
+
+/**
+ * The fewest entries that are worth giving to a thread of their own (any
+ * fewer, and starting the thread takes longer than sorting them).
+ */
+#define RADIX_MIN_ENTRIES_PER_THREAD    65536
+
+/** The parts of a radix sort that can be split between threads. */
+enum radix_phase {
+    /* Count every digit of the entries in a chunk */
+    RADIX_COUNT_ALL_DIGITS,
+    /* Count the current digit of the entries in a chunk */
+    RADIX_COUNT_DIGIT,
+    /* Move the entries in a chunk to their places for the current digit */
+    RADIX_SCATTER
+};
+
+/**
+ * The state of a radix sort.
+ *
+ * The entries are split into chunk_count contiguous chunks (one per thread).
+ * Each pass sorts by one digit, moving the entries from buffer "source" to
+ * buffer "1 - source".
+ */
+struct radix_sort {
+    present_uint64 * high_keys[2];
+    present_uint64 * low_keys[2];
+    size_t * values[2];
+    int source;
+
+    size_t count;
+    size_t chunk_count;
+    unsigned int digit_count;
+    unsigned int low_digit_count;
+
+    /* The current digit (0 is the least significant) */
+    unsigned int digit;
+    /* chunk_count * digit_count * RADIX_SIZE counts (RADIX_COUNT_ALL_DIGITS)
+       or chunk_count * RADIX_SIZE counts (RADIX_COUNT_DIGIT) */
+    size_t * counts;
+    /* chunk_count * RADIX_SIZE offsets for RADIX_SCATTER */
+    size_t * offsets;
+};
+
+/** The work for one chunk of one phase. */
+struct radix_task {
+    struct radix_sort * sort;
+    size_t chunk;
+    enum radix_phase phase;
+};
+
+/** Get the index of the first entry in a chunk. */
+static size_t
+radix_chunk_begin(const struct radix_sort * const sort, size_t chunk)
+{
+    size_t size = sort->count / sort->chunk_count;
+    size_t extra = sort->count % sort->chunk_count;
+
+    return chunk * size + (chunk < extra ? chunk : extra);
+}
+
+/**
+ * Get the keys that contain a digit of the current source buffer, and the
+ * shift to get that digit from them.
+ */
+static const present_uint64 *
+radix_digit_keys(
+        const struct radix_sort * const sort,
+        unsigned int digit,
+        unsigned int * const shift)
+{
+    if (digit < sort->low_digit_count) {
+        *shift = digit * RADIX_BITS;
+        return sort->low_keys[sort->source];
+    }
+    *shift = (digit - sort->low_digit_count) * RADIX_BITS;
+    return sort->high_keys[sort->source];
+}
+
+/** Run one phase of a radix sort on one chunk. */
+static void
+radix_run_task(const struct radix_task * const task)
+{
+    struct radix_sort * const sort = task->sort;
+    const size_t begin = radix_chunk_begin(sort, task->chunk);
+    const size_t end = radix_chunk_begin(sort, task->chunk + 1);
+    const present_uint64 * keys;
+    const present_uint64 * high_keys;
+    const present_uint64 * low_keys;
+    present_uint64 * high_out;
+    present_uint64 * low_out;
+    const size_t * values;
+    size_t * values_out;
+    size_t * counts;
+    size_t * offsets;
+    size_t i, position;
+    unsigned int digit, shift;
+
+    switch (task->phase) {
+        case RADIX_COUNT_ALL_DIGITS:
+            counts = sort->counts +
+                task->chunk * sort->digit_count * RADIX_SIZE;
+            memset(counts, 0,
+                    sort->digit_count * RADIX_SIZE * sizeof(size_t));
+            for (digit = 0; digit < sort->digit_count; digit++) {
+                keys = radix_digit_keys(sort, digit, &shift);
+                for (i = begin; i < end; i++) {
+                    counts[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                }
+                counts += RADIX_SIZE;
+            }
+            break;
+
+        case RADIX_COUNT_DIGIT:
+            counts = sort->counts + task->chunk * RADIX_SIZE;
+            memset(counts, 0, RADIX_SIZE * sizeof(size_t));
+            keys = radix_digit_keys(sort, sort->digit, &shift);
+            for (i = begin; i < end; i++) {
+                counts[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+            }
+            break;
+
+        case RADIX_SCATTER:
+            offsets = sort->offsets + task->chunk * RADIX_SIZE;
+            keys = radix_digit_keys(sort, sort->digit, &shift);
+            high_keys = sort->high_keys[sort->source];
+            high_out = sort->high_keys[1 - sort->source];
+            low_keys = sort->low_keys[sort->source];
+            low_out = sort->low_keys[1 - sort->source];
+            values = sort->values[sort->source];
+            values_out = sort->values[1 - sort->source];
+            for (i = begin; i < end; i++) {
+                position = offsets[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                high_out[position] = high_keys[i];
+                if (low_keys != NULL) {
+                    low_out[position] = low_keys[i];
+                }
+                if (values != NULL) {
+                    values_out[position] = values[i];
+                }
+            }
+            break;
+    }
+}
+
+#ifdef PRESENT_USE_PTHREAD
+/** Thread entry point for radix_run_task. */
+static void *
+radix_thread_main(void * task)
+{
+    radix_run_task((const struct radix_task *) task);
+    return NULL;
+}
+#endif
+
+/**
+ * Run one phase of a radix sort on every chunk (in parallel, if there is more
+ * than one chunk and pthread is available), and wait for all of them to
+ * finish.
+ */
+static void
+radix_run_phase(
+        struct radix_sort * const sort,
+        struct radix_task * const tasks,
+        enum radix_phase phase)
+{
+    size_t chunk;
+#ifdef PRESENT_USE_PTHREAD
+    pthread_t * threads = NULL;
+    present_bool * started = NULL;
+#endif
+
+    for (chunk = 0; chunk < sort->chunk_count; chunk++) {
+        tasks[chunk].sort = sort;
+        tasks[chunk].chunk = chunk;
+        tasks[chunk].phase = phase;
+    }
+
+#ifdef PRESENT_USE_PTHREAD
+    if (sort->chunk_count > 1) {
+        threads = (pthread_t *) malloc(sort->chunk_count * sizeof(pthread_t));
+        started = (present_bool *) calloc(
+                sort->chunk_count, sizeof(present_bool));
+    }
+    if (threads != NULL && started != NULL) {
+        /* The calling thread takes the first chunk itself, and any chunk
+           whose thread could not be started */
+        for (chunk = 1; chunk < sort->chunk_count; chunk++) {
+            started[chunk] = pthread_create(&threads[chunk], NULL,
+                    radix_thread_main, &tasks[chunk]) == 0;
+        }
+        for (chunk = 0; chunk < sort->chunk_count; chunk++) {
+            if (!started[chunk]) {
+                radix_run_task(&tasks[chunk]);
+            }
+        }
+        for (chunk = 1; chunk < sort->chunk_count; chunk++) {
+            if (started[chunk]) {
+                pthread_join(threads[chunk], NULL);
+            }
+        }
+        free(threads);
+        free(started);
+        return;
+    }
+    free(threads);
+    free(started);
+#endif
+
+    for (chunk = 0; chunk < sort->chunk_count; chunk++) {
+        radix_run_task(&tasks[chunk]);
+    }
+}
+
+/**
+ * Sort the entries, once the scratch buffers have been allocated.
+ */
+static void
+radix_sort_passes(struct radix_sort * const sort, struct radix_task * tasks)
+{
+    size_t totals[RADIX_MAX_DIGITS * RADIX_SIZE];
+    size_t * digit_counts;
+    size_t chunk, bucket, total, digit_total;
+    unsigned int digit, passes;
+
+    /* Count every digit at once, so that the digits that are the same for
+       every entry can be skipped */
+    radix_run_phase(sort, tasks, RADIX_COUNT_ALL_DIGITS);
+    memset(totals, 0, sizeof(totals));
+    for (chunk = 0; chunk < sort->chunk_count; chunk++) {
+        digit_counts = sort->counts +
+            chunk * sort->digit_count * RADIX_SIZE;
+        for (bucket = 0; bucket < sort->digit_count * RADIX_SIZE; bucket++) {
+            totals[bucket] += digit_counts[bucket];
+        }
+    }
+
+    passes = 0;
+    for (digit = 0; digit < sort->digit_count; digit++) {
+        digit_counts = totals + digit * RADIX_SIZE;
+        for (bucket = 0; bucket < RADIX_SIZE; bucket++) {
+            if (digit_counts[bucket] != 0) {
+                break;
+            }
+        }
+        if (digit_counts[bucket] == sort->count) {
+            /* Every entry has the same value for this digit */
+            continue;
+        }
+        sort->digit = digit;
+
+        if (sort->chunk_count == 1) {
+            /* With one chunk, the total counts are the chunk's counts */
+            memcpy(sort->offsets, digit_counts, RADIX_SIZE * sizeof(size_t));
+        } else if (passes == 0) {
+            /* The counts from RADIX_COUNT_ALL_DIGITS are still accurate
+               for each chunk, since nothing has moved yet */
+            for (chunk = 0; chunk < sort->chunk_count; chunk++) {
+                memcpy(sort->offsets + chunk * RADIX_SIZE,
+                        sort->counts +
+                        (chunk * sort->digit_count + digit) * RADIX_SIZE,
+                        RADIX_SIZE * sizeof(size_t));
+            }
+        } else {
+            radix_run_phase(sort, tasks, RADIX_COUNT_DIGIT);
+            memcpy(sort->offsets, sort->counts,
+                    sort->chunk_count * RADIX_SIZE * sizeof(size_t));
+        }
+
+        /* Turn the counts into the position where each chunk puts its first
+           entry with each value of the digit (keeping the order of the
+           chunks, so the sort is stable) */
+        total = 0;
+        for (bucket = 0; bucket < RADIX_SIZE; bucket++) {
+            for (chunk = 0; chunk < sort->chunk_count; chunk++) {
+                digit_total = sort->offsets[chunk * RADIX_SIZE + bucket];
+                sort->offsets[chunk * RADIX_SIZE + bucket] = total;
+                total += digit_total;
+            }
+        }
+
+        radix_run_phase(sort, tasks, RADIX_SCATTER);
+        sort->source = 1 - sort->source;
+        passes++;
+    }
+
+    /* If there was an odd number of passes, the entries are in the scratch
+       buffers */
+    if (sort->source != 0) {
+        memcpy(sort->high_keys[0], sort->high_keys[1],
+                sort->count * sizeof(present_uint64));
+        if (sort->low_keys[0] != NULL) {
+            memcpy(sort->low_keys[0], sort->low_keys[1],
+                    sort->count * sizeof(present_uint64));
+        }
+        if (sort->values[0] != NULL) {
+            memcpy(sort->values[0], sort->values[1],
+                    sort->count * sizeof(size_t));
+        }
+    }
+}
+
+present_bool
+present_radix_sort(
+        present_uint64 * const high_keys,
+        present_uint64 * const low_keys,
+        unsigned int low_key_bits,
+        size_t * const values,
+        size_t count,
+        unsigned int thread_count)
+{
+    struct radix_sort sort;
+    struct radix_task * tasks;
+    present_bool success;
+
+    assert(high_keys != NULL || count == 0);
+    assert(low_key_bits <= 64);
+
+    if (count < 2) {
+        return 1;
+    }
+
+    memset(&sort, 0, sizeof(sort));
+    sort.high_keys[0] = high_keys;
+    sort.low_keys[0] = low_keys;
+    sort.values[0] = values;
+    sort.count = count;
+    sort.low_digit_count = low_keys == NULL ? 0 :
+        (low_key_bits + RADIX_BITS - 1) / RADIX_BITS;
+    sort.digit_count = sort.low_digit_count + 64 / RADIX_BITS;
+
+    sort.chunk_count = count / RADIX_MIN_ENTRIES_PER_THREAD;
+    if (sort.chunk_count > thread_count) {
+        sort.chunk_count = thread_count;
+    }
+    if (sort.chunk_count < 1) {
+        sort.chunk_count = 1;
+    }
+
+    /* Allocate everything up front, so that the arrays are never left
+       partially sorted */
+    tasks = (struct radix_task *) malloc(
+            sort.chunk_count * sizeof(struct radix_task));
+    sort.counts = (size_t *) malloc(
+            sort.chunk_count * sort.digit_count * RADIX_SIZE * sizeof(size_t));
+    sort.offsets = (size_t *) malloc(
+            sort.chunk_count * RADIX_SIZE * sizeof(size_t));
+    sort.high_keys[1] = (present_uint64 *) malloc(
+            count * sizeof(present_uint64));
+    if (low_keys != NULL) {
+        sort.low_keys[1] = (present_uint64 *) malloc(
+                count * sizeof(present_uint64));
+    }
+    if (values != NULL) {
+        sort.values[1] = (size_t *) malloc(count * sizeof(size_t));
+    }
+    success = tasks != NULL && sort.counts != NULL && sort.offsets != NULL &&
+        sort.high_keys[1] != NULL &&
+        (low_keys == NULL || sort.low_keys[1] != NULL) &&
+        (values == NULL || sort.values[1] != NULL);
+    if (success) {
+        radix_sort_passes(&sort, tasks);
+    }
+
+    free(tasks);
+    free(sort.counts);
+    free(sort.offsets);
+    free(sort.high_keys[1]);
+    free(sort.low_keys[1]);
+    free(sort.values[1]);
+    return success;
+}
+
@@ -0,0 +1,68 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Declarations of utility functions for sorting arrays of keys
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#ifndef _PRESENT_SORT_UTILS_H_
+#define _PRESENT_SORT_UTILS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The bit to flip in a signed 64-bit integer (reinterpreted as unsigned) to
+ * get an unsigned key that sorts in the same order.
+ */
+#define PRESENT_SORT_SIGN_BIT   ((present_uint64)1 << 63)
+
+/**
+ * Sort the entries of parallel arrays by an unsigned key of up to 128 bits,
+ * using a stable LSD (least significant digit first) radix sort with 8-bit
+ * digits.
+ *
+ * The key of entry i is high_keys[i] followed by the lowest
+ * @p low_key_bits bits of low_keys[i] (if low_keys is not NULL). The digits
+ * that are the same for every entry (such as the high bytes of timestamps
+ * that are all within a few years) are skipped, so a sort usually takes far
+ * fewer than 8 (or 16) passes.
+ *
+ * If @p thread_count is more than 1 and Present was compiled with pthread
+ * support (PRESENT_USE_PTHREAD), each pass is split between that many
+ * threads. Otherwise, the sort runs on the calling thread.
+ *
+ * @param high_keys The high 64 bits of each key (@p count entries).
+ * @param low_keys The low bits of each key (@p count entries), or NULL.
+ * @param low_key_bits The number of bits used in each of @p low_keys (from 0
+ * to 64).
+ * @param values Values to move along with the keys (@p count entries), or
+ * NULL.
+ * @param count The number of entries.
+ * @param thread_count The maximum number of threads to use.
+ * @return 1 on success, or 0 if the scratch memory could not be allocated (in
+ * which case the arrays are unchanged).
+ */
+PRESENT_INTERNAL_API present_bool
+present_radix_sort(
+        present_uint64 * const high_keys,
+        present_uint64 * const low_keys,
+        unsigned int low_key_bits,
+        size_t * const values,
+        size_t count,
+        unsigned int thread_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_SORT_UTILS_H_ */
+
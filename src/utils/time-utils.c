@@ -15,8 +15,10 @@
 #include <unistd.h>
 
 #include "present-config.h"
+#include "present.h"
+#include "present/internal/format-utils.h"
 
-#ifdef PRESENT_WRAP_STDLIB_CALLS
+#if defined(PRESENT_WRAP_STDLIB_CALLS) || defined(PRESENT_USE_PTHREAD)
 # include <pthread.h>
 #endif
 
@@ -45,9 +47,40 @@ static pthread_mutex_t stdlib_call_lock = PTHREAD_MUTEX_INITIALIZER;
 
 #endif
 
+#ifdef PRESENT_USE_PTHREAD
+/* Protects the test time and the selected clock source (but not
+   clock_function, which present_now reads without locking) */
+static pthread_mutex_t clock_lock = PTHREAD_MUTEX_INITIALIZER;
+
+# define CLOCK_LOCK()       pthread_mutex_lock(&clock_lock)
+# define CLOCK_UNLOCK()     pthread_mutex_unlock(&clock_lock)
+#else
+# define CLOCK_LOCK()
+# define CLOCK_UNLOCK()
+#endif
+
 static int is_test_time_set = 0;
 static struct PresentNowStruct test_time;
 
+/* The function for the selected clock source, and which source it is */
+static ClockSourceCallback selected_clock_function =
+    &present_clock_realtime;
+static int selected_clock_source = PRESENT_CLOCK_SOURCE_REALTIME;
+/* The function that present_now calls (the selected clock source, or the
+   test time); this is read without locking, so it is only ever replaced
+   whole */
+static ClockSourceCallback clock_function = &present_clock_realtime;
+
+#if defined(__ATOMIC_ACQUIRE) && defined(__ATOMIC_RELEASE)
+# define LOAD_CLOCK_FUNCTION()      \
+    __atomic_load_n(&clock_function, __ATOMIC_ACQUIRE)
+# define STORE_CLOCK_FUNCTION(f)    \
+    __atomic_store_n(&clock_function, (f), __ATOMIC_RELEASE)
+#else
+# define LOAD_CLOCK_FUNCTION()      (clock_function)
+# define STORE_CLOCK_FUNCTION(f)    (clock_function = (f))
+#endif
+
 /**
  * Calculate the number of days that have occurred since the very beginning
  * (January 1st) of a base year.
@@ -175,6 +208,173 @@ to_unix_timestamp(
         + second;
 }
 
+int_timestamp
+present_date_to_days(int_year year, int_month month, int_day day)
+{
+    return to_unix_timestamp(year, month, day, 0, 0, 0) / SECONDS_IN_DAY;
+}
+
+struct Date
+present_days_to_date(int_timestamp days)
+{
+    struct PresentFormatFields fields;
+    struct Date result;
+
+    present_format_timestamp_fields(&fields, days * SECONDS_IN_DAY, 0, 0);
+    CLEAR(&result);
+    result.data_ = fields.date;
+    return result;
+}
+
+/**
+ * Divide a length of time by a width of time that is not a whole number of
+ * seconds (see present_floor_div_time), as quotient * 10^9 + fine_quotient
+ * (so that the quotient itself, which may not fit in 64 bits, is never
+ * computed), and a remainder (in nanoseconds, less than the width).
+ */
+static void
+floor_div_time_parts(
+        int_timestamp seconds,
+        int_timestamp nanoseconds,
+        int_delta width_seconds,
+        int_delta width_nanoseconds,
+        present_int64 * const quotient,
+        present_int64 * const fine_quotient,
+        present_int64 * const remainder_nanoseconds)
+{
+    present_int64 width, remainder, high_product;
+    present_uint64 low, high, shifted_low, shifted_high, new_low;
+    int bit;
+
+    assert(width_seconds < ((present_int64)1 << 62) / NANOSECONDS_IN_SECOND);
+    width = width_seconds * NANOSECONDS_IN_SECOND + width_nanoseconds;
+
+    /* seconds * 10^9 + nanoseconds = (quotient * width + remainder) * 10^9 +
+       nanoseconds, and the last part is less than width * 10^9 (so it fits in
+       94 bits, and dividing it by the width gives less than 10^9) */
+    *quotient = FLOOR_DIV(seconds, width);
+    remainder = seconds - *quotient * width;
+
+    /* low and high are the 128-bit remainder * 10^9 + nanoseconds (with the
+       remainder split into 32-bit halves so that each product fits) */
+    high_product = (remainder >> 32) * NANOSECONDS_IN_SECOND;
+    low = (present_uint64)(remainder & 0xFFFFFFFFUL) * NANOSECONDS_IN_SECOND +
+        (present_uint64)nanoseconds;
+    new_low = low + ((present_uint64)high_product << 32);
+    high = ((present_uint64)high_product >> 32) + (new_low < low);
+    low = new_low;
+
+    /* Long division, one bit of the result (at most 30 bits) at a time; what
+       is left is less than the width */
+    *fine_quotient = 0;
+    for (bit = 29; bit >= 0; bit--) {
+        shifted_low = (present_uint64)width << bit;
+        shifted_high = bit == 0 ? 0 : (present_uint64)width >> (64 - bit);
+        if (high > shifted_high ||
+                (high == shifted_high && low >= shifted_low)) {
+            high -= shifted_high + (low < shifted_low);
+            low -= shifted_low;
+            *fine_quotient += (present_int64)1 << bit;
+        }
+    }
+    *remainder_nanoseconds = (present_int64)low;
+}
+
+int_delta
+present_floor_div_time(
+        int_timestamp seconds,
+        int_timestamp nanoseconds,
+        int_delta width_seconds,
+        int_delta width_nanoseconds)
+{
+    present_int64 quotient, fine_quotient, remainder;
+
+    assert(nanoseconds >= 0 && nanoseconds < NANOSECONDS_IN_SECOND);
+    assert(width_seconds >= 0 && width_nanoseconds >= 0);
+    assert(width_seconds > 0 || width_nanoseconds > 0);
+
+    if (width_nanoseconds == 0) {
+        /* The nanoseconds never reach the next multiple of the width */
+        return FLOOR_DIV(seconds, width_seconds);
+    }
+
+    floor_div_time_parts(seconds, nanoseconds, width_seconds,
+            width_nanoseconds, &quotient, &fine_quotient, &remainder);
+    return quotient * NANOSECONDS_IN_SECOND + fine_quotient;
+}
+
+void
+present_floor_mod_time(
+        int_timestamp seconds,
+        int_timestamp nanoseconds,
+        int_delta width_seconds,
+        int_delta width_nanoseconds,
+        int_timestamp * const remainder_seconds,
+        int_timestamp * const remainder_nanoseconds)
+{
+    present_int64 quotient, fine_quotient, remainder;
+
+    assert(nanoseconds >= 0 && nanoseconds < NANOSECONDS_IN_SECOND);
+    assert(width_seconds >= 0 && width_nanoseconds >= 0);
+    assert(width_seconds > 0 || width_nanoseconds > 0);
+    assert(remainder_seconds != NULL);
+    assert(remainder_nanoseconds != NULL);
+
+    if (width_nanoseconds == 0) {
+        *remainder_seconds = FLOOR_MOD(seconds, width_seconds);
+        *remainder_nanoseconds = nanoseconds;
+        return;
+    }
+
+    floor_div_time_parts(seconds, nanoseconds, width_seconds,
+            width_nanoseconds, &quotient, &fine_quotient, &remainder);
+    *remainder_seconds = remainder / NANOSECONDS_IN_SECOND;
+    *remainder_nanoseconds = remainder % NANOSECONDS_IN_SECOND;
+}
+
+present_bool
+present_truncate_unit_width(
+        int unit,
+        int_delta * const width_seconds,
+        int_delta * const width_nanoseconds,
+        int_timestamp * const origin_seconds)
+{
+    *width_seconds = 0;
+    *width_nanoseconds = 0;
+    *origin_seconds = 0;
+
+    switch (unit) {
+        case PRESENT_TRUNCATE_MICROSECOND:
+            *width_nanoseconds = NANOSECONDS_IN_MICROSECOND;
+            return 1;
+        case PRESENT_TRUNCATE_MILLISECOND:
+            *width_nanoseconds = NANOSECONDS_IN_MILLISECOND;
+            return 1;
+        case PRESENT_TRUNCATE_SECOND:
+            *width_seconds = 1;
+            return 1;
+        case PRESENT_TRUNCATE_MINUTE:
+            *width_seconds = SECONDS_IN_MINUTE;
+            return 1;
+        case PRESENT_TRUNCATE_HOUR:
+            *width_seconds = SECONDS_IN_HOUR;
+            return 1;
+        case PRESENT_TRUNCATE_DAY:
+            *width_seconds = SECONDS_IN_DAY;
+            return 1;
+        case PRESENT_TRUNCATE_WEEK:
+            *width_seconds = SECONDS_IN_WEEK;
+            /* The UNIX epoch was on a Thursday, so the Monday before */
+            *origin_seconds = -3 * SECONDS_IN_DAY;
+            return 1;
+        default:
+            assert(unit == PRESENT_TRUNCATE_MONTH ||
+                    unit == PRESENT_TRUNCATE_QUARTER ||
+                    unit == PRESENT_TRUNCATE_YEAR);
+            return 0;
+    }
+}
+
 void
 time_t_to_struct_tm(const time_t * timep, struct tm * result)
 {
@@ -226,44 +426,206 @@ clean_struct_tm(struct tm * const tm)
     time_t_to_struct_tm(&time, tm);
 }
 
-void
-present_now(struct PresentNowStruct * result)
+/**
+ * Read a POSIX clock into a Timestamp.
+ *
+ * If clock_gettime is not supported, this falls back to the @p time function
+ * (whichever clock is asked for).
+ */
+static void
+read_realtime_clock(int source, struct Timestamp * const result)
 {
+#if defined(_POSIX_TIMERS) && !defined(__STRICT_ANSI__)
+    struct timespec tp;
+    clockid_t clock_id = CLOCK_REALTIME;
+#endif
+
     assert(result != NULL);
+    CLEAR(result);
+
+#if defined(_POSIX_TIMERS) && !defined(__STRICT_ANSI__)
+# ifdef CLOCK_REALTIME_COARSE
+    if (source == PRESENT_CLOCK_SOURCE_REALTIME_COARSE) {
+        clock_id = CLOCK_REALTIME_COARSE;
+    }
+# else
+    (void) source;
+# endif
+    clock_gettime(clock_id, &tp);
+    result->data_.timestamp_seconds = time_t_to_unix_timestamp(tp.tv_sec);
+    result->data_.additional_nanoseconds = tp.tv_nsec;
+#else
+    (void) source;
+    result->data_.timestamp_seconds = time_t_to_unix_timestamp(time(NULL));
+    result->data_.additional_nanoseconds = 0;
+#endif
+}
+
+void
+present_clock_realtime(struct Timestamp * const result)
+{
+    read_realtime_clock(PRESENT_CLOCK_SOURCE_REALTIME, result);
+}
+
+void
+present_clock_realtime_coarse(struct Timestamp * const result)
+{
+    read_realtime_clock(PRESENT_CLOCK_SOURCE_REALTIME_COARSE, result);
+}
+
+present_bool
+present_clock_resolution(int source, struct PresentNowStruct * result)
+{
 #if defined(_POSIX_TIMERS) && !defined(__STRICT_ANSI__)
     struct timespec tp;
+    clockid_t clock_id = CLOCK_REALTIME;
 #endif
 
-    LOCK();
-    if (is_test_time_set) {
-        *result = test_time;
-    } else {
+    assert(result != NULL);
+    result->sec = 0;
+    result->nsec = 0;
+
+    if (source != PRESENT_CLOCK_SOURCE_REALTIME &&
+            source != PRESENT_CLOCK_SOURCE_REALTIME_COARSE) {
+        return 0;
+    }
+
 #if defined(_POSIX_TIMERS) && !defined(__STRICT_ANSI__)
-        clock_gettime(CLOCK_REALTIME, &tp);
-        result->sec = tp.tv_sec;
-        result->nsec = tp.tv_nsec;
+    if (source == PRESENT_CLOCK_SOURCE_REALTIME_COARSE) {
+# ifdef CLOCK_REALTIME_COARSE
+        clock_id = CLOCK_REALTIME_COARSE;
+# else
+        return 0;
+# endif
+    }
+    /* This also tells whether the kernel supports the clock */
+    if (clock_getres(clock_id, &tp) != 0) {
+        return 0;
+    }
+    result->sec = tp.tv_sec;
+    result->nsec = tp.tv_nsec;
 #else
-        result->sec = time(NULL);
-        result->nsec = 0;
+    if (source != PRESENT_CLOCK_SOURCE_REALTIME) {
+        return 0;
+    }
+    result->sec = 1;
+#endif
+    return 1;
+}
+
+/** Read the test time set by present_set_test_time. */
+static void
+read_test_time(struct Timestamp * const result)
+{
+    struct PresentNowStruct value;
+
+    assert(result != NULL);
+    CLEAR(result);
+
+    /* The test time can be set again while this function is published */
+    CLOCK_LOCK();
+    value = test_time;
+    CLOCK_UNLOCK();
+
+    result->data_.timestamp_seconds = time_t_to_unix_timestamp(value.sec);
+    result->data_.additional_nanoseconds = value.nsec;
+}
+
+/** Make the function that present_now calls visible to every thread. */
+static void
+publish_clock_function(void)
+{
+    ClockSourceCallback function =
+        is_test_time_set ? &read_test_time : selected_clock_function;
+    STORE_CLOCK_FUNCTION(function);
+}
+
+void
+present_now(struct Timestamp * const result)
+{
+    ClockSourceCallback function;
+
+    assert(result != NULL);
+    function = LOAD_CLOCK_FUNCTION();
+    (*function)(result);
+}
+
+void
+present_set_clock_function(ClockSourceCallback function, int source)
+{
+    assert(function != NULL);
+
+    CLOCK_LOCK();
+    selected_clock_function = function;
+    selected_clock_source = source;
+    publish_clock_function();
+    CLOCK_UNLOCK();
+}
+
+int
+present_get_clock_source(void)
+{
+    int source;
+
+    CLOCK_LOCK();
+    source = selected_clock_source;
+    CLOCK_UNLOCK();
+    return source;
+}
+
+void
+present_now_monotonic(int clock, struct PresentNowStruct * result)
+{
+#if defined(_POSIX_TIMERS) && !defined(__STRICT_ANSI__) && \
+    defined(CLOCK_MONOTONIC)
+    struct timespec tp;
+    clockid_t clock_id = CLOCK_MONOTONIC;
 #endif
+
+    assert(result != NULL);
+
+#if defined(_POSIX_TIMERS) && !defined(__STRICT_ANSI__) && \
+    defined(CLOCK_MONOTONIC)
+# ifdef CLOCK_MONOTONIC_RAW
+    if (clock == PRESENT_INSTANT_MONOTONIC_RAW) {
+        clock_id = CLOCK_MONOTONIC_RAW;
     }
-    UNLOCK();
+# endif
+# ifdef CLOCK_BOOTTIME
+    if (clock == PRESENT_INSTANT_BOOTTIME) {
+        clock_id = CLOCK_BOOTTIME;
+    }
+# endif
+    /* If the kernel does not support the clock, fall back to
+       CLOCK_MONOTONIC */
+    if (clock_gettime(clock_id, &tp) != 0) {
+        clock_gettime(CLOCK_MONOTONIC, &tp);
+    }
+    result->sec = tp.tv_sec;
+    result->nsec = tp.tv_nsec;
+#else
+    (void) clock;
+    result->sec = time(NULL);
+    result->nsec = 0;
+#endif
 }
 
 void
 present_set_test_time(struct PresentNowStruct value)
 {
-    LOCK();
+    CLOCK_LOCK();
     is_test_time_set = 1;
     test_time = value;
-    UNLOCK();
+    publish_clock_function();
+    CLOCK_UNLOCK();
 }
 
 void
 present_reset_test_time()
 {
-    LOCK();
+    CLOCK_LOCK();
     is_test_time_set = 0;
-    UNLOCK();
+    publish_clock_function();
+    CLOCK_UNLOCK();
 }
 
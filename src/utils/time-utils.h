@@ -9,8 +9,11 @@
 
 #include <time.h>
 
+#include "present/internal/header-utils.h"
 #include "present/internal/types.h"
 
+#include "present/clock-source.h"
+
 #ifndef _PRESENT_TIME_UTILS_H_
 #define _PRESENT_TIME_UTILS_H_
 
@@ -19,8 +22,8 @@ extern "C" {
 #endif
 
 /**
- * Struct used for @p present_now. Identical to "struct timespec" on systems
- * that support it.
+ * Struct used for @p present_now_monotonic and @p present_set_test_time.
+ * Identical to "struct timespec" on systems that support it.
  */
 struct PresentNowStruct {
     time_t  sec;    /* seconds since the epoch */
@@ -31,15 +34,15 @@ struct PresentNowStruct {
  * Reimplementation of @p round to support older versions of the math library
  * that don't have @p round.
  */
-double
+PRESENT_INTERNAL_API double
 present_round(double x);
 
 /** Convert a time_t to a UNIX timestamp. */
-int_timestamp
+PRESENT_INTERNAL_API int_timestamp
 time_t_to_unix_timestamp(const time_t timestamp);
 
 /** Convert a UNIX timestamp to a time_t. */
-time_t
+PRESENT_INTERNAL_API time_t
 unix_timestamp_to_time_t(const int_timestamp timestamp_seconds);
 
 /**
@@ -49,7 +52,7 @@ unix_timestamp_to_time_t(const int_timestamp timestamp_seconds);
  * This is essentially a reimplementation of the nonstandard C @p timegm
  * function.
  */
-int_timestamp
+PRESENT_INTERNAL_API int_timestamp
 to_unix_timestamp(
         int_year year,
         int_month month,
@@ -58,6 +61,95 @@ to_unix_timestamp(
         int_minute minute,
         int_second second);
 
+/**
+ * Divide an integer by a positive divisor, rounding towards negative infinity
+ * (whether the C implementation rounds integer division of negative values
+ * toward 0, as required by C99, or down, as allowed by C89). This has no
+ * branches, so compilers can vectorize loops that use it.
+ */
+#define FLOOR_DIV(value, divisor)                               \
+    ((value) / (divisor) - ((value) / (divisor) * (divisor) > (value)))
+
+/** Get the remainder of FLOOR_DIV (from 0 to divisor - 1). */
+#define FLOOR_MOD(value, divisor)                               \
+    ((value) - FLOOR_DIV(value, divisor) * (divisor))
+
+/**
+ * Get the number of days since the UNIX epoch of a day of a month (which, as
+ * with @p to_unix_timestamp, may be out of range and overflow into the next
+ * or previous months).
+ */
+PRESENT_INTERNAL_API int_timestamp
+present_date_to_days(int_year year, int_month month, int_day day);
+
+/** Get the number of days since the UNIX epoch of a struct Date. */
+#define DATE_TO_DAYS(date)                                              \
+    present_date_to_days(                                               \
+            (date)->data_.year, (date)->data_.month, (date)->data_.day)
+
+/**
+ * Get the date that is a number of days since the UNIX epoch (with all of
+ * its fields filled in, and no error).
+ */
+PRESENT_INTERNAL_API struct Date
+present_days_to_date(int_timestamp days);
+
+/**
+ * Divide a length of time by a (positive) width of time, rounding down to a
+ * whole number of widths.
+ *
+ * The result is exact, even when the lengths in nanoseconds would not fit in
+ * 64 bits (for example, a timestamp thousands of years from its origin,
+ * divided into 1.5-second buckets).
+ *
+ * @param seconds The whole seconds of the length (rounded down).
+ * @param nanoseconds The rest of the length (from 0 to 999,999,999).
+ * @param width_seconds The whole seconds of the width.
+ * @param width_nanoseconds The rest of the width (from 0 to 999,999,999).
+ * If it is not 0, then the whole width (in nanoseconds) must fit in 63 bits.
+ * @return The number of widths, which must fit in an int_delta (see
+ * present_floor_mod_time for when it may not).
+ */
+PRESENT_INTERNAL_API int_delta
+present_floor_div_time(
+        int_timestamp seconds,
+        int_timestamp nanoseconds,
+        int_delta width_seconds,
+        int_delta width_nanoseconds);
+
+/**
+ * Get the remainder of present_floor_div_time (from 0 up to the width), as
+ * whole seconds and the rest in nanoseconds.
+ *
+ * This works for any length, even one with more widths than fit in an
+ * int_delta (such as a timestamp hundreds of years from its origin, divided
+ * into 1-nanosecond buckets).
+ */
+PRESENT_INTERNAL_API void
+present_floor_mod_time(
+        int_timestamp seconds,
+        int_timestamp nanoseconds,
+        int_delta width_seconds,
+        int_delta width_nanoseconds,
+        int_timestamp * const remainder_seconds,
+        int_timestamp * const remainder_nanoseconds);
+
+/**
+ * Get the width of a unit for Timestamp_truncate, and the start of one of
+ * its buckets (in seconds since the UNIX epoch, in local time), if the unit
+ * has a fixed length.
+ *
+ * @param unit One of the PRESENT_TRUNCATE_* constants.
+ * @return 1 if the unit has a fixed length (up to PRESENT_TRUNCATE_WEEK), or
+ * 0 if it is a calendar unit with a varying length (such as months).
+ */
+PRESENT_INTERNAL_API present_bool
+present_truncate_unit_width(
+        int unit,
+        int_delta * const width_seconds,
+        int_delta * const width_nanoseconds,
+        int_timestamp * const origin_seconds);
+
 /**
  * Convert a UNIX timestamp @p timep to a "struct tm" (in UTC) and store the
  * result in @p result.
@@ -67,7 +159,7 @@ to_unix_timestamp(
  * If Present is not compiled with PRESENT_WRAP_STDLIB_CALLS, then this
  * function is not thread-safe.
  */
-void
+PRESENT_INTERNAL_API void
 time_t_to_struct_tm(const time_t * timep, struct tm * result);
 
 /**
@@ -79,7 +171,7 @@ time_t_to_struct_tm(const time_t * timep, struct tm * result);
  * If Present is not compiled with PRESENT_WRAP_STDLIB_CALLS, then this
  * function is not thread-safe.
  */
-time_t
+PRESENT_INTERNAL_API time_t
 struct_tm_to_time_t_local(struct tm * tm);
 
 /**
@@ -92,27 +184,78 @@ struct_tm_to_time_t_local(struct tm * tm);
  * If Present is not compiled with PRESENT_WRAP_STDLIB_CALLS, then this
  * function is not thread-safe.
  */
-void
+PRESENT_INTERNAL_API void
 time_t_to_struct_tm_local(const time_t * timep, struct tm * result);
 
 /**
  * Clean a struct tm, fixing any issues with date or time components that are
  * out of range.
  */
-void
+PRESENT_INTERNAL_API void
 clean_struct_tm(struct tm * const tm);
 
 /**
- * Get the current system time.
+ * Get the current system time, from the selected clock source.
  *
- * If a test time is set, this will return that. Otherwise, it is a wrapper
- * around the @p clock_gettime function (if supported) or the @p time function
- * from the C standard library.
+ * If a test time is set, this will return that. Otherwise, it calls the
+ * function for the clock source selected with @p present_set_clock_function
+ * (by default, @p present_clock_realtime). Either way, this is a single call
+ * through a cached function pointer, with no locking.
  *
  * @see present_set_test_time
  */
-void
-present_now(struct PresentNowStruct * result);
+PRESENT_INTERNAL_API void
+present_now(struct Timestamp * const result);
+
+/**
+ * Set the function that @p present_now calls to get the current time (when
+ * no test time is set), and which clock source it is (one of the
+ * PRESENT_CLOCK_SOURCE_... values).
+ */
+PRESENT_INTERNAL_API void
+present_set_clock_function(ClockSourceCallback function, int source);
+
+/**
+ * Get the clock source set with @p present_set_clock_function (by default,
+ * PRESENT_CLOCK_SOURCE_REALTIME).
+ */
+PRESENT_INTERNAL_API int
+present_get_clock_source(void);
+
+/**
+ * Read CLOCK_REALTIME (PRESENT_CLOCK_SOURCE_REALTIME) with the
+ * @p clock_gettime function (if supported) or the @p time function from the
+ * C standard library.
+ */
+PRESENT_INTERNAL_API void
+present_clock_realtime(struct Timestamp * const result);
+
+/**
+ * Read CLOCK_REALTIME_COARSE (PRESENT_CLOCK_SOURCE_REALTIME_COARSE), or
+ * CLOCK_REALTIME where that is not supported.
+ */
+PRESENT_INTERNAL_API void
+present_clock_realtime_coarse(struct Timestamp * const result);
+
+/**
+ * Get the resolution of the POSIX clock behind a clock source (one of the
+ * PRESENT_CLOCK_SOURCE_... values), from the @p clock_getres function.
+ *
+ * @return 1 if the clock is available on this system, or 0 if it is not (or
+ * if the source is not a POSIX clock).
+ */
+PRESENT_INTERNAL_API present_bool
+present_clock_resolution(int source, struct PresentNowStruct * result);
+
+/**
+ * Get the current time of a monotonic clock (one of the PRESENT_INSTANT_...
+ * values), from the @p clock_gettime function. Where that is not supported,
+ * this falls back to the @p time function.
+ *
+ * Unlike @p present_now, this is not affected by the test time.
+ */
+PRESENT_INTERNAL_API void
+present_now_monotonic(int clock, struct PresentNowStruct * result);
 
 /**
  * Set a test time that will be returned by calls to @p present_now.
@@ -120,7 +263,7 @@ present_now(struct PresentNowStruct * result);
  * @see present_now
  * @see present_reset_test_time
  */
-void
+PRESENT_INTERNAL_API void
 present_set_test_time(struct PresentNowStruct value);
 
 /**
@@ -132,7 +275,7 @@ present_set_test_time(struct PresentNowStruct value);
  * @see present_now
  * @see present_set_test_time
  */
-void
+PRESENT_INTERNAL_API void
 present_reset_test_time();
 
 #ifdef __cplusplus
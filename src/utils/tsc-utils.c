@@ -0,0 +1,408 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Implementations of utility functions for reading the time from the CPU's
+ * time stamp counter (TSC)
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "present-config.h"
+#include "present.h"
+
+#ifdef PRESENT_USE_PTHREAD
+# include <pthread.h>
+#endif
+
+#include "utils/constants.h"
+#include "utils/impl-utils.h"
+#include "utils/time-utils.h"
+#include "utils/tsc-utils.h"
+
+#ifdef PRESENT_HAVE_TSC
+
+/** How long the TSC's rate is measured for when it is calibrated. */
+#define TSC_CALIBRATION_NANOSECONDS     (10 * NANOSECONDS_IN_MILLISECOND)
+
+/** How many times to read a clock, keeping the reading that took least. */
+#define TSC_CLOCK_READ_ATTEMPTS         5
+
+/**
+ * How much a resync may change the TSC's rate by (in parts per million).
+ * A bigger change means that the system time was set in between (rather
+ * than slewed), so the resync only moves the anchor and keeps the rate.
+ */
+#define TSC_MAX_RATE_CHANGE_PPM         500
+
+/* The states of the calibration */
+#define TSC_UNCALIBRATED    0
+#define TSC_USABLE          1
+#define TSC_UNUSABLE        2
+
+#define LOAD_ACQUIRE(ptr)           __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(ptr)           __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define STORE_RELEASE(ptr, value)   \
+    __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define STORE_RELAXED(ptr, value)   \
+    __atomic_store_n((ptr), (value), __ATOMIC_RELAXED)
+
+/**
+ * A reading of the TSC, the time of a clock (in nanoseconds) when it was
+ * taken, and the number of nanoseconds per tick of the TSC (as a fixed-point
+ * number with tsc_shift fractional bits).
+ */
+struct TscAnchor {
+    present_uint64 tsc;
+    present_int64 nanoseconds;
+    present_uint64 mult;
+};
+
+static int tsc_state = TSC_UNCALIBRATED;
+static int tsc_shift;
+static present_uint64 tsc_resync_cycles;
+static long tsc_tick_nanoseconds;
+
+/* Set when the TSC is calibrated, and never changed after that */
+static struct TscAnchor tsc_monotonic;
+
+/* Replaced by each resync; it is protected by a sequence lock (readers retry
+   if tsc_sequence was odd, or changed while they read it), and only one
+   thread at a time resyncs (the one that sets tsc_resyncing) */
+static struct TscAnchor tsc_realtime;
+static unsigned long tsc_sequence;
+static int tsc_resyncing;
+
+#ifdef PRESENT_USE_PTHREAD
+static pthread_mutex_t tsc_calibration_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/** Read the TSC. */
+static PRESENT_INLINE present_uint64
+tsc_read(void)
+{
+    unsigned int low, high;
+    __asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+    return ((present_uint64) high << 32) | low;
+}
+
+/**
+ * Convert a number of ticks of the TSC to nanoseconds: (cycles * mult) >>
+ * shift, with the multiplication split into 32-bit halves so that it cannot
+ * overflow (mult is less than 2^32, and shift is at most 32).
+ */
+static PRESENT_INLINE present_int64
+tsc_scale(present_uint64 cycles, present_uint64 mult)
+{
+    const present_uint64 high = cycles >> 32;
+    const present_uint64 low = cycles & 0xFFFFFFFFUL;
+    return (present_int64) (((high * mult) << (32 - tsc_shift)) +
+            ((low * mult) >> tsc_shift));
+}
+
+/**
+ * Read a POSIX clock (in nanoseconds), and the TSC at the same moment
+ * (halfway between readings of the TSC on either side of the clock).
+ */
+static present_int64
+tsc_read_clock(clockid_t clock_id, present_uint64 * const tsc)
+{
+    struct timespec tp, best_tp;
+    present_uint64 before, after, best_span = 0;
+    int attempt;
+
+    for (attempt = 0; attempt < TSC_CLOCK_READ_ATTEMPTS; ++attempt) {
+        before = tsc_read();
+        clock_gettime(clock_id, &tp);
+        after = tsc_read();
+        if (attempt == 0 || after - before < best_span) {
+            best_span = after - before;
+            best_tp = tp;
+            *tsc = before + best_span / 2;
+        }
+    }
+    return (present_int64) best_tp.tv_sec * NANOSECONDS_IN_SECOND +
+        best_tp.tv_nsec;
+}
+
+/**
+ * Determine whether the TSC is invariant, from the flags of the first CPU in
+ * /proc/cpuinfo.
+ */
+static present_bool
+tsc_is_invariant(void)
+{
+#ifdef __linux__
+    FILE * file;
+    char word[64];
+    present_bool constant = 0, nonstop = 0;
+
+    file = fopen("/proc/cpuinfo", "r");
+    if (file == NULL) {
+        return 0;
+    }
+    while (!(constant && nonstop) && fscanf(file, "%63s", word) == 1) {
+        if (strcmp(word, "constant_tsc") == 0) {
+            constant = 1;
+        } else if (strcmp(word, "nonstop_tsc") == 0) {
+            nonstop = 1;
+        }
+    }
+    fclose(file);
+    return constant && nonstop;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Measure the TSC's rate against CLOCK_REALTIME, and anchor it to
+ * CLOCK_REALTIME and CLOCK_MONOTONIC.
+ *
+ * @return TSC_USABLE or TSC_UNUSABLE.
+ */
+static int
+tsc_measure(void)
+{
+    struct timespec tp;
+    present_uint64 start_tsc, end_tsc, monotonic_tsc, cycles, mult;
+    present_int64 start, end, monotonic, elapsed;
+    int shift;
+
+    if (!tsc_is_invariant()) {
+        return TSC_UNUSABLE;
+    }
+
+    start = tsc_read_clock(CLOCK_REALTIME, &start_tsc);
+    monotonic = tsc_read_clock(CLOCK_MONOTONIC, &monotonic_tsc);
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &tp);
+    } while ((present_int64) tp.tv_sec * NANOSECONDS_IN_SECOND + tp.tv_nsec -
+            monotonic < TSC_CALIBRATION_NANOSECONDS);
+    end = tsc_read_clock(CLOCK_REALTIME, &end_tsc);
+
+    /* Give up if the system time was set while measuring, or the TSC runs at
+       less than 10 MHz or more than 100 GHz (so it is not really ticking) */
+    elapsed = end - start;
+    cycles = end_tsc - start_tsc;
+    if (elapsed <= 0 || elapsed > 100 * TSC_CALIBRATION_NANOSECONDS ||
+            cycles < (present_uint64) elapsed / 100 ||
+            cycles > (present_uint64) elapsed * 100) {
+        return TSC_UNUSABLE;
+    }
+
+    /* Use as many fractional bits as fit, keeping mult under 2^32 */
+    shift = 32;
+    while (((present_uint64) elapsed << shift) / cycles >=
+            ((present_uint64) 1 << 32)) {
+        --shift;
+    }
+    mult = ((present_uint64) elapsed << shift) / cycles;
+
+    tsc_shift = shift;
+    tsc_resync_cycles = ((present_uint64) NANOSECONDS_IN_SECOND << shift) /
+        mult;
+    tsc_tick_nanoseconds = (long) ((mult + ((present_uint64) 1 << shift) - 1)
+        >> shift);
+
+    tsc_monotonic.tsc = monotonic_tsc;
+    tsc_monotonic.nanoseconds = monotonic;
+    tsc_monotonic.mult = mult;
+
+    tsc_realtime.tsc = end_tsc;
+    tsc_realtime.nanoseconds = end;
+    tsc_realtime.mult = mult;
+
+    return TSC_USABLE;
+}
+
+/** Read tsc_realtime (retrying if it is being resynced at the same time). */
+static PRESENT_INLINE void
+tsc_load_realtime(struct TscAnchor * const anchor)
+{
+    unsigned long sequence;
+
+    do {
+        sequence = LOAD_ACQUIRE(&tsc_sequence);
+        anchor->tsc = LOAD_RELAXED(&tsc_realtime.tsc);
+        anchor->nanoseconds = LOAD_RELAXED(&tsc_realtime.nanoseconds);
+        anchor->mult = LOAD_RELAXED(&tsc_realtime.mult);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((sequence & 1) || LOAD_RELAXED(&tsc_sequence) != sequence);
+}
+
+/**
+ * Sync tsc_realtime with CLOCK_REALTIME again, unless another thread is
+ * already doing so.
+ *
+ * @param anchor The last sync (which is replaced with the new one).
+ * @return 1 if it was resynced, or 0 if another thread is resyncing it.
+ */
+static present_bool
+tsc_resync(struct TscAnchor * const anchor)
+{
+    struct TscAnchor synced;
+    present_uint64 cycles, measured, limit;
+    present_int64 elapsed;
+    unsigned long sequence;
+
+    if (__atomic_exchange_n(&tsc_resyncing, 1, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+
+    synced.nanoseconds = tsc_read_clock(CLOCK_REALTIME, &synced.tsc);
+    synced.mult = anchor->mult;
+
+    /* Refine the rate over the time since the last sync (unless the system
+       time was set in between, or it has been too long to do so exactly) */
+    elapsed = synced.nanoseconds - anchor->nanoseconds;
+    cycles = synced.tsc - anchor->tsc;
+    if (elapsed > 0 && cycles > 0 && (present_uint64) elapsed <
+            ((present_uint64) 1 << (64 - tsc_shift))) {
+        measured = ((present_uint64) elapsed << tsc_shift) / cycles;
+        limit = anchor->mult / (1000000 / TSC_MAX_RATE_CHANGE_PPM);
+        if (measured >= anchor->mult - limit &&
+                measured <= anchor->mult + limit) {
+            synced.mult = measured;
+        }
+    }
+
+    sequence = LOAD_RELAXED(&tsc_sequence);
+    STORE_RELAXED(&tsc_sequence, sequence + 1);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    STORE_RELAXED(&tsc_realtime.tsc, synced.tsc);
+    STORE_RELAXED(&tsc_realtime.nanoseconds, synced.nanoseconds);
+    STORE_RELAXED(&tsc_realtime.mult, synced.mult);
+    STORE_RELEASE(&tsc_sequence, sequence + 2);
+
+    STORE_RELEASE(&tsc_resyncing, 0);
+    *anchor = synced;
+    return 1;
+}
+
+/** Get the nanoseconds since an anchor's clock's epoch, from the TSC. */
+static PRESENT_INLINE present_int64
+tsc_nanoseconds(const struct TscAnchor * const anchor, present_uint64 now)
+{
+    /* The TSCs of different CPUs can be a few ticks apart */
+    const present_uint64 cycles = now > anchor->tsc ? now - anchor->tsc : 0;
+    return anchor->nanoseconds + tsc_scale(cycles, anchor->mult);
+}
+
+present_bool
+present_tsc_calibrate(void)
+{
+    int state = LOAD_ACQUIRE(&tsc_state);
+
+    if (state == TSC_UNCALIBRATED) {
+#ifdef PRESENT_USE_PTHREAD
+        pthread_mutex_lock(&tsc_calibration_lock);
+#endif
+        state = LOAD_RELAXED(&tsc_state);
+        if (state == TSC_UNCALIBRATED) {
+            state = tsc_measure();
+            STORE_RELEASE(&tsc_state, state);
+        }
+#ifdef PRESENT_USE_PTHREAD
+        pthread_mutex_unlock(&tsc_calibration_lock);
+#endif
+    }
+    return state == TSC_USABLE;
+}
+
+void
+present_clock_tsc(struct Timestamp * const result)
+{
+    struct TscAnchor anchor;
+    present_uint64 now;
+    present_int64 nanoseconds, seconds;
+
+    assert(result != NULL);
+
+    tsc_load_realtime(&anchor);
+    now = tsc_read();
+    if (now - anchor.tsc >= tsc_resync_cycles && tsc_resync(&anchor)) {
+        now = tsc_read();
+    }
+    nanoseconds = tsc_nanoseconds(&anchor, now);
+
+    seconds = nanoseconds / NANOSECONDS_IN_SECOND;
+    nanoseconds %= NANOSECONDS_IN_SECOND;
+    if (nanoseconds < 0) {
+        nanoseconds += NANOSECONDS_IN_SECOND;
+        --seconds;
+    }
+    CLEAR(result);
+    result->data_.timestamp_seconds = seconds;
+    result->data_.additional_nanoseconds = nanoseconds;
+}
+
+void
+present_now_tsc(struct PresentNowStruct * result)
+{
+    present_int64 nanoseconds;
+
+    assert(result != NULL);
+
+    if (!present_tsc_calibrate()) {
+        present_now_monotonic(PRESENT_INSTANT_MONOTONIC, result);
+        return;
+    }
+
+    nanoseconds = tsc_nanoseconds(&tsc_monotonic, tsc_read());
+    result->sec = (time_t) (nanoseconds / NANOSECONDS_IN_SECOND);
+    result->nsec = (long) (nanoseconds % NANOSECONDS_IN_SECOND);
+}
+
+present_bool
+present_tsc_resolution(struct PresentNowStruct * result)
+{
+    assert(result != NULL);
+
+    result->sec = 0;
+    result->nsec = 0;
+    if (!present_tsc_calibrate()) {
+        return 0;
+    }
+    result->nsec = tsc_tick_nanoseconds;
+    return 1;
+}
+
+#else /* PRESENT_HAVE_TSC */
+
+present_bool
+present_tsc_calibrate(void)
+{
+    return 0;
+}
+
+void
+present_clock_tsc(struct Timestamp * const result)
+{
+    present_clock_realtime(result);
+}
+
+void
+present_now_tsc(struct PresentNowStruct * result)
+{
+    present_now_monotonic(PRESENT_INSTANT_MONOTONIC, result);
+}
+
+present_bool
+present_tsc_resolution(struct PresentNowStruct * result)
+{
+    assert(result != NULL);
+
+    result->sec = 0;
+    result->nsec = 0;
+    return 0;
+}
+
+#endif /* PRESENT_HAVE_TSC */
+
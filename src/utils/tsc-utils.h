@@ -0,0 +1,88 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Declarations of utility functions for reading the time from the CPU's
+ * time stamp counter (TSC)
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <unistd.h>
+
+#include "present/internal/header-utils.h"
+#include "present/internal/types.h"
+
+#include "utils/time-utils.h"
+
+#ifndef _PRESENT_TSC_UTILS_H_
+#define _PRESENT_TSC_UTILS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Whether Present was compiled with support for reading the TSC (which
+ * needs an x86 CPU, and a compiler that supports GCC-style inline
+ * assembly and atomic builtins).
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    defined(__ATOMIC_ACQUIRE) && \
+    defined(_POSIX_TIMERS) && !defined(__STRICT_ANSI__)
+# define PRESENT_HAVE_TSC
+#endif
+
+/**
+ * Make sure that the TSC has been calibrated, and determine whether it can
+ * be used.
+ *
+ * The TSC can only be used if it is invariant (it runs at a constant rate,
+ * even when the CPU changes frequency or sleeps, which Linux reports with the
+ * "constant_tsc" and "nonstop_tsc" flags in /proc/cpuinfo). The first call
+ * checks that, and measures the TSC's rate against CLOCK_REALTIME for a few
+ * milliseconds; later calls just return the result.
+ *
+ * This is thread-safe.
+ */
+PRESENT_INTERNAL_API present_bool
+present_tsc_calibrate(void);
+
+/**
+ * Read the system time from the TSC (PRESENT_CLOCK_SOURCE_TSC), scaled with
+ * a multiply and a shift from the last time that it was synced with
+ * CLOCK_REALTIME.
+ *
+ * A read that finds the last sync to be more than a second old syncs it
+ * again, so that the TSC follows any changes to the system time.
+ *
+ * Precondition: @p present_tsc_calibrate returned 1.
+ */
+PRESENT_INTERNAL_API void
+present_clock_tsc(struct Timestamp * const result);
+
+/**
+ * Read a monotonic time from the TSC (for PRESENT_INSTANT_TSC), scaled with
+ * a multiply and a shift from a reading of CLOCK_MONOTONIC taken when the
+ * TSC was calibrated. It is never synced again, so it never jumps.
+ *
+ * If the TSC cannot be used, this reads CLOCK_MONOTONIC instead.
+ */
+PRESENT_INTERNAL_API void
+present_now_tsc(struct PresentNowStruct * result);
+
+/**
+ * Get the length of one tick of the TSC (rounded up to a whole nanosecond).
+ *
+ * @return 1 if the TSC can be used, or 0 if it cannot.
+ */
+PRESENT_INTERNAL_API present_bool
+present_tsc_resolution(struct PresentNowStruct * result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PRESENT_TSC_UTILS_H_ */
+
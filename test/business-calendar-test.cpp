@@ -0,0 +1,264 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the BusinessCalendar C++ class and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/**
+ * Check whether a date is a business day the slow way (by its day of the
+ * week, and a linear search of the holidays).
+ */
+static bool
+slow_is_business_day(
+        const Date & date,
+        unsigned int weekend_mask,
+        const std::vector<Date> & holidays)
+{
+    if (weekend_mask & PRESENT_WEEKDAY_BIT(date.day_of_week())) {
+        return false;
+    }
+    for (size_t i = 0; i < holidays.size(); ++i) {
+        if (holidays[i] == date) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("BusinessCalendar matches a day-by-day walk", "[business-calendar]") {
+    const Date first = Date::create(2019, 12, 1);
+    const Date end = Date::create(2021, 2, 1);
+    const unsigned int masks[] = {
+        PRESENT_WEEKEND_SATURDAY_SUNDAY,
+        PRESENT_WEEKEND_FRIDAY_SATURDAY,
+        PRESENT_WEEKDAY_BIT(7),
+    };
+
+    std::vector<Date> holidays;
+    holidays.push_back(Date::create(2020, 12, 25));
+    holidays.push_back(Date::create(2020, 1, 1));
+    holidays.push_back(Date::create(2020, 7, 3));
+    holidays.push_back(Date::create(2020, 11, 26));
+    holidays.push_back(Date::create(2020, 5, 25));
+    holidays.push_back(Date::create(2020, 5, 30));      /* A Saturday */
+    holidays.push_back(Date::create(2018, 1, 1));       /* Out of range */
+    holidays.push_back(Date::create(2020, 1, 1));       /* A duplicate */
+
+    for (size_t m = 0; m < sizeof(masks) / sizeof(masks[0]); ++m) {
+        const BusinessCalendar calendar(first, end, masks[m], &holidays[0],
+                holidays.size());
+        CHECK(calendar.first() == first);
+        CHECK(calendar.end() == end);
+
+        std::vector<Date> dates;
+        std::vector<bool> business;
+        for (Date date = first; date < end; date += DayDelta::from_days(1)) {
+            dates.push_back(date);
+            business.push_back(
+                    slow_is_business_day(date, masks[m], holidays));
+            REQUIRE(calendar.is_business_day(date) == business.back());
+        }
+
+        for (size_t i = 0; i < dates.size(); i += 5) {
+            /* Business days between, counted one day at a time */
+            int_delta count = 0;
+            for (size_t j = i; j < dates.size(); j += 1) {
+                if (j % 11 == 0) {
+                    REQUIRE(calendar.business_days_between(
+                                dates[i], dates[j]) == count);
+                    REQUIRE(calendar.business_days_between(
+                                dates[j], dates[i]) == -count);
+                }
+                count += business[j];
+            }
+            REQUIRE(calendar.business_days_between(dates[i], end) == count);
+
+            /* Adding business days, one day at a time */
+            for (int_delta n = -12; n <= 12; ++n) {
+                size_t j = i;
+                for (int_delta k = 0; k < (n < 0 ? -n : n); ++k) {
+                    do {
+                        j = n < 0 ? j - 1 : j + 1;
+                    } while (j < dates.size() && !business[j]);
+                }
+                if (j < dates.size()) {
+                    REQUIRE(calendar.add_business_days(dates[i], n) ==
+                            dates[j]);
+                }
+            }
+
+            /* Adjusting to a business day */
+            size_t next = i, previous = i;
+            while (next < dates.size() && !business[next]) {
+                ++next;
+            }
+            while (previous < dates.size() && !business[previous]) {
+                --previous;
+            }
+            if (next < dates.size() && previous < dates.size()) {
+                const bool same_month_next =
+                    dates[next].month() == dates[i].month();
+                const bool same_month_previous =
+                    dates[previous].month() == dates[i].month();
+                CHECK(calendar.adjust(dates[i], PRESENT_ADJUST_UNADJUSTED) ==
+                        dates[i]);
+                CHECK(calendar.adjust(dates[i], PRESENT_ADJUST_FOLLOWING) ==
+                        dates[next]);
+                CHECK(calendar.adjust(dates[i], PRESENT_ADJUST_PRECEDING) ==
+                        dates[previous]);
+                CHECK(calendar.adjust(dates[i],
+                            PRESENT_ADJUST_MODIFIED_FOLLOWING) ==
+                        dates[same_month_next ? next : previous]);
+                CHECK(calendar.adjust(dates[i],
+                            PRESENT_ADJUST_MODIFIED_PRECEDING) ==
+                        dates[same_month_previous ? previous : next]);
+            }
+        }
+    }
+}
+
+TEST_CASE("BusinessCalendar settlement examples", "[business-calendar]") {
+    const Date holidays[] = {
+        Date::create(2024, 12, 25),
+        Date::create(2024, 12, 26),
+        Date::create(2025, 1, 1),
+    };
+    BusinessCalendar calendar(Date::create(2024, 1, 1),
+            Date::create(2026, 1, 1), PRESENT_WEEKEND_SATURDAY_SUNDAY,
+            holidays, 3);
+
+    /* T+2 from Monday, December 23 skips the holidays */
+    CHECK(calendar.add_business_days(Date::create(2024, 12, 23), 2) ==
+            Date::create(2024, 12, 27));
+    /* T+1 from a Friday is the next Monday */
+    CHECK(calendar.add_business_days(Date::create(2025, 3, 7), 1) ==
+            Date::create(2025, 3, 10));
+    /* From a Saturday, 1 business day later is the Monday */
+    CHECK(calendar.add_business_days(Date::create(2025, 3, 8), 1) ==
+            Date::create(2025, 3, 10));
+    CHECK(calendar.add_business_days(Date::create(2025, 3, 8), -1) ==
+            Date::create(2025, 3, 7));
+    CHECK(calendar.add_business_days(Date::create(2025, 3, 8), 0) ==
+            Date::create(2025, 3, 8));
+
+    /* Saturday, May 31, 2025: following is in June, so modified following
+       goes back to Friday */
+    CHECK(calendar.adjust(Date::create(2025, 5, 31),
+                PRESENT_ADJUST_FOLLOWING) == Date::create(2025, 6, 2));
+    CHECK(calendar.adjust(Date::create(2025, 5, 31),
+                PRESENT_ADJUST_MODIFIED_FOLLOWING) ==
+            Date::create(2025, 5, 30));
+    /* Sunday, June 1, 2025: preceding is in May */
+    CHECK(calendar.adjust(Date::create(2025, 6, 1),
+                PRESENT_ADJUST_MODIFIED_PRECEDING) ==
+            Date::create(2025, 6, 2));
+
+    /* There are 260 business days in 2025 (261 weekdays, minus New Year's
+       Day) */
+    CHECK(calendar.business_days_between(Date::create(2025, 1, 1),
+                Date::create(2026, 1, 1)) == 260);
+
+    /* Copies are independent of the original */
+    BusinessCalendar copy(calendar);
+    calendar.build(Date::create(2025, 1, 1), Date::create(2025, 2, 1),
+            PRESENT_WEEKEND_SATURDAY_SUNDAY, NULL, 0);
+    CHECK(calendar.business_days_between(Date::create(2025, 1, 1),
+                Date::create(2025, 2, 1)) == 23);
+    CHECK(copy.business_days_between(Date::create(2025, 1, 1),
+                Date::create(2025, 2, 1)) == 22);
+}
+
+/** Determine whether a Date is the error for a date outside a calendar. */
+static bool
+is_out_of_range(const Date & date)
+{
+    return date.has_error && date.errors.day_out_of_range;
+}
+
+TEST_CASE("BusinessCalendar outside its range", "[business-calendar]") {
+    const int_delta max = (int_delta)(((present_uint64)1 << 63) - 1);
+    const Date holiday = Date::create(2025, 1, 1);
+    /* The business days are January 2, 3, 6, and 7 */
+    const BusinessCalendar calendar(Date::create(2025, 1, 1),
+            Date::create(2025, 1, 8), PRESENT_WEEKEND_SATURDAY_SUNDAY,
+            &holiday, 1);
+    const Date before = Date::create(2024, 12, 31);
+    const Date end = Date::create(2025, 1, 8);
+
+    CHECK_FALSE(calendar.is_business_day(before));
+    CHECK_FALSE(calendar.is_business_day(end));
+    CHECK(calendar.is_business_day(Date::create(2025, 1, 2)));
+
+    /* Only the business days in the range are counted */
+    CHECK(calendar.business_days_between(Date::create(2024, 12, 1),
+                Date::create(2025, 2, 1)) == 4);
+    CHECK(calendar.business_days_between(Date::create(2025, 2, 1),
+                Date::create(2025, 1, 3)) == -3);
+    CHECK(calendar.business_days_between(before,
+                Date::create(2024, 12, 1)) == 0);
+
+    CHECK(calendar.add_business_days(Date::create(2025, 1, 2), 3) ==
+            Date::create(2025, 1, 7));
+    CHECK(is_out_of_range(calendar.add_business_days(
+                    Date::create(2025, 1, 2), 4)));
+    CHECK(is_out_of_range(calendar.add_business_days(
+                    Date::create(2025, 1, 2), -1)));
+    CHECK(is_out_of_range(calendar.add_business_days(
+                    Date::create(2025, 1, 2), max)));
+    CHECK(is_out_of_range(calendar.add_business_days(
+                    Date::create(2025, 1, 7), -max)));
+    CHECK(is_out_of_range(calendar.add_business_days(before, 1)));
+    CHECK(is_out_of_range(calendar.add_business_days(end, 0)));
+
+    /* There is no business day before January 2 */
+    CHECK(calendar.adjust(holiday, PRESENT_ADJUST_FOLLOWING) ==
+            Date::create(2025, 1, 2));
+    CHECK(is_out_of_range(calendar.adjust(holiday,
+                    PRESENT_ADJUST_PRECEDING)));
+    CHECK(is_out_of_range(calendar.adjust(holiday,
+                    PRESENT_ADJUST_MODIFIED_PRECEDING)));
+    CHECK(is_out_of_range(calendar.adjust(before,
+                    PRESENT_ADJUST_UNADJUSTED)));
+
+    /* There is no business day after the weekend at the end of this one */
+    const BusinessCalendar short_calendar(Date::create(2025, 1, 1),
+            Date::create(2025, 1, 6), PRESENT_WEEKEND_SATURDAY_SUNDAY,
+            &holiday, 1);
+    CHECK(is_out_of_range(short_calendar.adjust(Date::create(2025, 1, 4),
+                    PRESENT_ADJUST_FOLLOWING)));
+    CHECK(is_out_of_range(short_calendar.adjust(Date::create(2025, 1, 4),
+                    PRESENT_ADJUST_MODIFIED_FOLLOWING)));
+    CHECK(short_calendar.adjust(Date::create(2025, 1, 4),
+                PRESENT_ADJUST_PRECEDING) == Date::create(2025, 1, 3));
+}
+
+TEST_CASE("BusinessCalendar C functions", "[business-calendar]") {
+    struct BusinessCalendar calendar;
+    struct Date first = Date_from_year_month_day(2025, 1, 1);
+    struct Date end = Date_from_year_month_day(2025, 1, 8);
+    struct Date date;
+
+    BusinessCalendar_init(&calendar);
+    REQUIRE(BusinessCalendar_build(&calendar, &first, &end,
+                PRESENT_WEEKEND_SATURDAY_SUNDAY, &first, 1));
+    CHECK_FALSE(BusinessCalendar_is_business_day(&calendar, &first));
+    CHECK(BusinessCalendar_business_days_between(&calendar, &first, &end) ==
+            4);
+    date = BusinessCalendar_adjust(&calendar, &first,
+            PRESENT_ADJUST_FOLLOWING);
+    CHECK(date == Date_from_year_month_day(2025, 1, 2));
+    BusinessCalendar_destroy(&calendar);
+    CHECK(calendar.day_count_ == 0);
+}
@@ -0,0 +1,197 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the conversions between the C++ classes and std::chrono types
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+#ifdef PRESENT_HAS_CHRONO
+
+#if __cplusplus >= 201402L
+
+static_assert(TimeDelta::from_duration(std::chrono::milliseconds(1500)) ==
+        TimeDelta::from_milliseconds(1500),
+        "TimeDelta::from_duration should be constexpr");
+static_assert(TimeDelta::from_minutes(-90).to_duration<std::chrono::hours>()
+        == std::chrono::hours(-1),
+        "TimeDelta::to_duration should be constexpr");
+
+#endif
+
+TEST_CASE("TimeDelta from std::chrono::duration", "[chrono] [time-delta]") {
+    using namespace std::chrono;
+
+    CHECK(TimeDelta::from_duration(nanoseconds(1234567890123LL)) ==
+            TimeDelta::from_nanoseconds(1234567890123LL));
+    CHECK(TimeDelta::from_duration(nanoseconds(-1234567890123LL)) ==
+            TimeDelta::from_nanoseconds(-1234567890123LL));
+    CHECK(TimeDelta::from_duration(microseconds(-5)) ==
+            TimeDelta::from_microseconds(-5));
+    CHECK(TimeDelta::from_duration(hours(1000000)) ==
+            TimeDelta::from_hours(1000000));
+    CHECK(TimeDelta::from_duration(duration<double>(1.5)) ==
+            TimeDelta::from_milliseconds(1500));
+    CHECK(TimeDelta::from_duration(duration<long, std::pico>(2500)) ==
+            TimeDelta::from_nanoseconds(2));
+
+    /* This is more than a 64-bit number of nanoseconds can hold */
+    CHECK(TimeDelta::from_duration(hours(24 * 365 * 1000)).days() ==
+            365 * 1000);
+}
+
+TEST_CASE("TimeDelta to std::chrono::duration", "[chrono] [time-delta]") {
+    using namespace std::chrono;
+
+    CHECK(TimeDelta::from_nanoseconds(1234567890123LL).to_duration() ==
+            nanoseconds(1234567890123LL));
+    CHECK(TimeDelta::from_nanoseconds(-1234567890123LL).to_duration() ==
+            nanoseconds(-1234567890123LL));
+    CHECK(TimeDelta::from_milliseconds(1999).to_duration<seconds>() ==
+            seconds(1));
+    CHECK(TimeDelta::from_milliseconds(-1999).to_duration<seconds>() ==
+            seconds(-1));
+    CHECK(TimeDelta::from_seconds(-150).to_duration<minutes>() ==
+            minutes(-2));
+    CHECK(TimeDelta::from_milliseconds(1500).to_duration<
+            duration<double> >().count() == 1.5);
+    CHECK(TimeDelta::from_days(365 * 1000).to_duration<hours>() ==
+            hours(24 * 365 * 1000));
+
+    /* A period that does not divide a second (the seconds and nanoseconds
+       are joined before they are rounded) */
+    typedef duration<int_delta, std::ratio<3, 10> > tenths3;
+    CHECK(TimeDelta::from_milliseconds(2100).to_duration<tenths3>() ==
+            tenths3(7));
+    CHECK(TimeDelta::from_milliseconds(-2100).to_duration<tenths3>() ==
+            tenths3(-7));
+    CHECK(TimeDelta::from_milliseconds(2000).to_duration<tenths3>() ==
+            tenths3(6));
+    CHECK(TimeDelta::from_milliseconds(-2000).to_duration<tenths3>() ==
+            tenths3(-6));
+}
+
+TEST_CASE("Timestamp from/to std::chrono::system_clock time points",
+          "[chrono] [timestamp]") {
+    using namespace std::chrono;
+    typedef time_point<system_clock, nanoseconds> ns_time;
+    typedef time_point<system_clock, seconds> s_time;
+    typedef time_point<system_clock, milliseconds> ms_time;
+    typedef time_point<system_clock, minutes> min_time;
+    typedef time_point<system_clock, hours> h_time;
+    typedef duration<int_delta, std::ratio<86400> > day_duration;
+    typedef time_point<system_clock, day_duration> day_time;
+    typedef duration<int_delta, std::ratio<3, 10> > tenths3;
+    typedef time_point<system_clock, tenths3> tenths3_time;
+
+    Timestamp t = Timestamp::create(ns_time(nanoseconds(1500000000LL)));
+    CHECK(t == Timestamp::epoch() + TimeDelta::from_milliseconds(1500));
+    CHECK(t.to_time_point() == ns_time(nanoseconds(1500000000LL)));
+    CHECK(t.to_time_point<seconds>() == s_time(seconds(1)));
+
+    t = Timestamp::create(ns_time(nanoseconds(-1500000000LL)));
+    CHECK(t == Timestamp::epoch() - TimeDelta::from_milliseconds(1500));
+    CHECK(t.get_time_t() == -2);
+    CHECK(t.to_time_point() == ns_time(nanoseconds(-1500000000LL)));
+    /* Rounded down (like std::chrono::floor), not toward zero */
+    CHECK(t.to_time_point<seconds>() == s_time(seconds(-2)));
+
+    /* Durations coarser than a second are rounded down too */
+    t = Timestamp::epoch() - TimeDelta::from_seconds(30);
+    CHECK(t.to_time_point<minutes>() == min_time(minutes(-1)));
+    t = Timestamp::epoch() - TimeDelta::from_hours(1);
+    CHECK(t.to_time_point<hours>() == h_time(hours(-1)));
+    CHECK(t.to_time_point<day_duration>() == day_time(day_duration(-1)));
+    t = Timestamp::epoch() - TimeDelta::from_nanoseconds(1);
+    CHECK(t.to_time_point<milliseconds>() == ms_time(milliseconds(-1)));
+    t = Timestamp::epoch() + TimeDelta::from_seconds(90);
+    CHECK(t.to_time_point<minutes>() == min_time(minutes(1)));
+
+    /* A period that does not divide a second */
+    t = Timestamp::epoch() + TimeDelta::from_milliseconds(2100);
+    CHECK(t.to_time_point<tenths3>() == tenths3_time(tenths3(7)));
+    t = Timestamp::epoch() + TimeDelta::from_milliseconds(2099);
+    CHECK(t.to_time_point<tenths3>() == tenths3_time(tenths3(6)));
+    t = Timestamp::epoch() - TimeDelta::from_milliseconds(2100);
+    CHECK(t.to_time_point<tenths3>() == tenths3_time(tenths3(-7)));
+    t = Timestamp::epoch() - TimeDelta::from_milliseconds(2000);
+    CHECK(t.to_time_point<tenths3>() == tenths3_time(tenths3(-7)));
+
+    t = Timestamp::create(s_time(seconds(1234567890)));
+    CHECK(t.get_time_t() == 1234567890);
+
+    /* system_clock::now() keeps its sub-second precision */
+    const system_clock::time_point now = system_clock::now();
+    CHECK(Timestamp::create(now).to_time_point<system_clock::duration>() ==
+            now.time_since_epoch() + system_clock::time_point());
+}
+
+#ifdef PRESENT_HAS_CHRONO_CALENDAR
+
+static_assert(Date::create(std::chrono::sys_days(std::chrono::days(0))) ==
+        Date::create(1970, 1, 1),
+        "Date::create(sys_days) should be constexpr");
+static_assert(ClockTime::create(13, 45).to_hh_mm_ss().minutes() ==
+        std::chrono::minutes(45),
+        "ClockTime::to_hh_mm_ss should be constexpr");
+
+TEST_CASE("Date from/to std::chrono calendar types", "[chrono] [date]") {
+    using namespace std::chrono;
+    Date d;
+
+    d = Date::create(year_month_day(year(2024), month(2), day(29)));
+    REQUIRE_FALSE(d.has_error);
+    CHECK(d == Date::create(2024, 2, 29));
+    CHECK(d.to_year_month_day() ==
+            year_month_day(year(2024), month(2), day(29)));
+    CHECK(d.to_sys_days() == sys_days(year_month_day(
+                    year(2024), month(2), day(29))));
+
+    d = Date::create(year_month_day(year(2023), month(2), day(29)));
+    CHECK(d.has_error);
+    CHECK(d.errors.day_out_of_range);
+
+    for (int days = -800000; days <= 800000; days += 997) {
+        d = Date::create(sys_days(std::chrono::days(days)));
+        REQUIRE_FALSE(d.has_error);
+        CHECK(d.to_sys_days().time_since_epoch().count() == days);
+        CHECK(d.to_year_month_day() ==
+                year_month_day(sys_days(std::chrono::days(days))));
+        CHECK(d.day_of_week() ==
+                weekday(sys_days(std::chrono::days(days))).iso_encoding());
+    }
+}
+
+TEST_CASE("ClockTime from/to std::chrono::hh_mm_ss", "[chrono] [clock-time]") {
+    using namespace std::chrono;
+    ClockTime c;
+
+    c = ClockTime::create(hh_mm_ss<nanoseconds>(
+                hours(13) + minutes(45) + seconds(30) + nanoseconds(5)));
+    REQUIRE_FALSE(c.has_error);
+    CHECK(c == ClockTime::create(13, 45, 30, 5));
+    CHECK(c.to_hh_mm_ss().to_duration() ==
+            hours(13) + minutes(45) + seconds(30) + nanoseconds(5));
+
+    c = ClockTime::create(hh_mm_ss<milliseconds>(milliseconds(1500)));
+    REQUIRE_FALSE(c.has_error);
+    CHECK(c == ClockTime::create(0, 0, 1, 500000000));
+
+    c = ClockTime::create(hh_mm_ss<seconds>(hours(25)));
+    CHECK(c.has_error);
+    CHECK(c.errors.hour_out_of_range);
+
+    c = ClockTime::create(hh_mm_ss<seconds>(seconds(-1)));
+    CHECK(c.has_error);
+    CHECK(c.errors.hour_out_of_range);
+}
+
+#endif
+
+#endif
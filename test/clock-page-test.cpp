@@ -0,0 +1,278 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the ClockPage C++ class and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stdio.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/** How often the ClockPages in these tests are written. */
+static const TimeDelta INTERVAL = TimeDelta::from_microseconds(100);
+
+/**
+ * How far behind the system time a ClockPage may be (much more than the
+ * interval, since the publisher's thread may not be scheduled on time).
+ */
+static const TimeDelta SLACK = TimeDelta::from_milliseconds(200);
+
+/** Determine whether a ClockPage's time is within SLACK of the system time. */
+static bool
+is_current(const ClockPage & page)
+{
+    const Timestamp before = Timestamp_now();
+    const Timestamp time = page.now();
+    const Timestamp after = Timestamp_now();
+    return time >= before - SLACK && time <= after;
+}
+
+/** Wait (for up to a second) for a ClockPage's time to change. */
+static bool
+wait_for_update(const ClockPage & page)
+{
+    const Timestamp first = page.now();
+    const Instant start = Instant::now();
+    while (start.elapsed() < TimeDelta::from_seconds(1)) {
+        if (page.now() > first) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE("Publishing a ClockPage", "[clock-page]") {
+    ClockPage page;
+    CHECK_FALSE(page.is_open());
+    CHECK(page.fd() == -1);
+
+    if (!page.publish(NULL, INTERVAL)) {
+        // ClockPages are not supported on this system
+        CHECK_FALSE(page.is_open());
+        return;
+    }
+    CHECK(page.is_open());
+    CHECK(page.is_publishing());
+    CHECK(page.interval() == INTERVAL);
+    CHECK(page.age() >= TimeDelta::zero());
+    CHECK(page.age() < SLACK);
+
+    for (int i = 0; i < 3; ++i) {
+        CHECK(is_current(page));
+        CHECK(wait_for_update(page));
+    }
+
+    // A child process reads the page through the mapping that fork copies
+    const pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        const bool ok = is_current(page) && wait_for_update(page);
+        page.close();
+        _exit(ok ? 0 : 1);
+    }
+    int status = -1;
+    REQUIRE(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+
+    // (The child's close did not stop this process's thread)
+    CHECK(page.is_publishing());
+    CHECK(wait_for_update(page));
+
+    // Another ClockPage can be opened from a copy of the file descriptor
+    if (page.fd() >= 0) {
+        ClockPage reader;
+        REQUIRE(reader.open_fd(dup(page.fd())));
+        CHECK(reader.fd() >= 0);
+        CHECK(reader.interval() == INTERVAL);
+        CHECK(is_current(reader));
+    }
+
+    page.close();
+    CHECK_FALSE(page.is_open());
+    CHECK(page.fd() == -1);
+}
+
+TEST_CASE("Opening a ClockPage by name", "[clock-page]") {
+    char name[64];
+    sprintf(name, "/present-test-clock-page-%ld", (long) getpid());
+
+    ClockPage reader;
+    CHECK_FALSE(reader.open(name));
+    CHECK_FALSE(reader.is_open());
+
+    ClockPage publisher;
+    if (!publisher.publish(name, INTERVAL)) {
+        return;
+    }
+    REQUIRE(reader.open(name));
+    CHECK(reader.is_open());
+    CHECK(reader.is_publishing());
+    CHECK(reader.interval() == INTERVAL);
+    CHECK(is_current(reader));
+    CHECK(wait_for_update(reader));
+    CHECK(reader.age() < SLACK);
+
+    // A second publisher cannot take the name while it is in use
+    ClockPage other;
+    CHECK_FALSE(other.publish(name, INTERVAL));
+    CHECK_FALSE(other.is_open());
+    CHECK(wait_for_update(reader));
+
+    // Once the publisher closes it, the time stops, and the name is removed
+    publisher.close();
+    CHECK_FALSE(reader.is_publishing());
+    const Timestamp last = reader.now();
+    CHECK(reader.now() == last);
+    const TimeDelta age = reader.age();
+    usleep(10000);
+    CHECK(reader.age() > age);
+    ClockPage again;
+    CHECK_FALSE(again.open(name));
+
+    // A file that is not a ClockPage cannot be opened
+    const int fd = ::open("/dev/null", O_RDONLY);
+    REQUIRE(fd >= 0);
+    CHECK_FALSE(again.open_fd(fd));
+    CHECK_FALSE(again.is_open());
+}
+
+TEST_CASE("Replacing a ClockPage whose publisher was killed",
+          "[clock-page]") {
+    char name[64];
+    sprintf(name, "/present-test-dead-clock-page-%ld", (long) getpid());
+
+    // The child publishes the page, and exits without closing it
+    const pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        ClockPage page;
+        _exit(page.publish(name, INTERVAL) ? 0 : 1);
+    }
+    int status = -1;
+    REQUIRE(waitpid(child, &status, 0) == child);
+    REQUIRE(WIFEXITED(status));
+    if (WEXITSTATUS(status) != 0) {
+        // ClockPages are not supported on this system
+        return;
+    }
+
+    // It still says that it is publishing, but its heartbeat stops
+    ClockPage reader;
+    REQUIRE(reader.open(name));
+    CHECK(reader.is_publishing());
+    const TimeDelta age = reader.age();
+    CHECK_FALSE(wait_for_update(reader));
+    CHECK(reader.age() > age);
+
+    // Once it is stale (after a second), a new publisher replaces it
+    while (reader.age() <= TimeDelta::from_milliseconds(1100)) {
+        usleep(10000);
+    }
+    ClockPage publisher;
+    REQUIRE(publisher.publish(name, INTERVAL));
+    CHECK(publisher.age() < SLACK);
+
+    // (The reader still has the old page, which was only unlinked)
+    CHECK(reader.age() > TimeDelta::from_seconds(1));
+    ClockPage fresh;
+    REQUIRE(fresh.open(name));
+    CHECK(is_current(fresh));
+}
+
+TEST_CASE("Publishers racing to replace a stale ClockPage",
+          "[clock-page]") {
+    char name[64];
+    sprintf(name, "/present-test-raced-clock-page-%ld", (long) getpid());
+
+    // A child publishes the page, and exits without closing it
+    pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        ClockPage page;
+        _exit(page.publish(name, INTERVAL) ? 0 : 1);
+    }
+    int status = -1;
+    REQUIRE(waitpid(child, &status, 0) == child);
+    REQUIRE(WIFEXITED(status));
+    if (WEXITSTATUS(status) != 0) {
+        // ClockPages are not supported on this system
+        return;
+    }
+    ClockPage reader;
+    REQUIRE(reader.open(name));
+    while (reader.age() <= TimeDelta::from_milliseconds(1100)) {
+        usleep(10000);
+    }
+
+    // Then several children try to replace it at the same time, and stay
+    // alive for a while if they do; only one of them can
+    const int racers = 4;
+    pid_t children[racers];
+    const Timestamp start = Timestamp_now() + TimeDelta::from_milliseconds(50);
+    for (int i = 0; i < racers; ++i) {
+        children[i] = fork();
+        REQUIRE(children[i] >= 0);
+        if (children[i] == 0) {
+            while (Timestamp_now() < start) {
+            }
+            ClockPage page;
+            const bool published = page.publish(name, INTERVAL);
+            usleep(200000);
+            _exit(published ? 0 : 2);
+        }
+    }
+    int published = 0;
+    for (int i = 0; i < racers; ++i) {
+        REQUIRE(waitpid(children[i], &status, 0) == children[i]);
+        REQUIRE(WIFEXITED(status));
+        if (WEXITSTATUS(status) == 0) {
+            ++published;
+        }
+    }
+    CHECK(published == 1);
+
+    // (The winner exited without closing it either)
+    shm_unlink(name);
+}
+
+TEST_CASE("ClockPage C functions", "[clock-page]") {
+    struct TimeDelta interval = TimeDelta_from_milliseconds(1);
+    struct TimeDelta page_interval, page_age;
+    struct TimeDelta slack = TimeDelta_from_milliseconds(200);
+    struct Timestamp time;
+    struct Timestamp epoch = Timestamp_epoch();
+    /* In C++, this has a constructor, so it is only allocated here */
+    struct ClockPage * page = static_cast<ClockPage *>(
+            operator new(sizeof(ClockPage)));
+
+    ClockPage_init(page);
+    CHECK_FALSE(ClockPage_is_open(page));
+    CHECK(ClockPage_get_fd(page) == -1);
+    if (ClockPage_publish(page, NULL, &interval)) {
+        CHECK(ClockPage_is_open(page));
+        CHECK(ClockPage_is_publishing(page));
+        page_interval = ClockPage_get_interval(page);
+        CHECK(TimeDelta_equal(&page_interval, &interval));
+        page_age = ClockPage_get_age(page);
+        CHECK(TimeDelta_less_than(&page_age, &slack));
+        time = ClockPage_now(page);
+        CHECK(Timestamp_greater_than(&time, &epoch));
+    }
+    ClockPage_close(page);
+    CHECK_FALSE(ClockPage_is_open(page));
+    operator delete(page);
+}
+
@@ -0,0 +1,218 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the clock source C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <ctime>
+
+#if __cplusplus >= 201103L
+#include <thread>
+#include <vector>
+#endif
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+#include "utils/time-utils.h"
+
+/** A clock source callback that always reads 2001-09-09 01:46:40 UTC. */
+static void
+fixed_clock(struct Timestamp * const result)
+{
+    *result = Timestamp_from_time_t((time_t) 1000000000);
+}
+
+/**
+ * A clock source callback that only sets the seconds and nanoseconds (and
+ * leaves them unnormalized), reading 2001-09-09 01:46:42.5 UTC.
+ */
+static void
+raw_clock(struct Timestamp * const result)
+{
+    result->has_error = 1;
+    result->errors.invalid_date = 1;
+    result->data_.timestamp_seconds = 1000000000;
+    result->data_.additional_nanoseconds = (int_timestamp) 25 * 100000000;
+}
+
+TEST_CASE("Clock source registry", "[clock-source]") {
+    // Timestamp_now (the C function) is used throughout, since in header-only
+    // mode the selected source is local to each translation unit
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME);
+    CHECK(ClockSource_is_available(PRESENT_CLOCK_SOURCE_REALTIME));
+    CHECK(ClockSource_is_available(PRESENT_CLOCK_SOURCE_CALLBACK));
+
+    CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_REALTIME) >
+            TimeDelta::zero());
+    CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_REALTIME) <=
+            TimeDelta::from_seconds(1));
+    CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_CALLBACK) ==
+            TimeDelta::zero());
+
+    // The realtime source is the system time
+    const Timestamp before = Timestamp::create(std::time(NULL));
+    const Timestamp now = Timestamp_now();
+    const Timestamp after =
+        Timestamp::create(std::time(NULL)) + TimeDelta::from_seconds(1);
+    CHECK(now >= before);
+    CHECK(now < after);
+}
+
+TEST_CASE("Coarse clock source", "[clock-source]") {
+    if (!ClockSource_is_available(PRESENT_CLOCK_SOURCE_REALTIME_COARSE)) {
+        CHECK_FALSE(ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME_COARSE));
+        CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME);
+        CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_REALTIME_COARSE) ==
+                TimeDelta::zero());
+        return;
+    }
+
+    // The coarse clock only moves on each timer tick
+    CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_REALTIME_COARSE) >=
+            ClockSource_resolution(PRESENT_CLOCK_SOURCE_REALTIME));
+
+    REQUIRE(ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME_COARSE));
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME_COARSE);
+
+    const TimeDelta slack =
+        ClockSource_resolution(PRESENT_CLOCK_SOURCE_REALTIME_COARSE) +
+        TimeDelta::from_milliseconds(100);
+    for (int i = 0; i < 100; ++i) {
+        Timestamp coarse = Timestamp_now();
+        Timestamp precise;
+        present_clock_realtime(&precise);
+        CHECK(precise.absolute_difference(coarse) <= slack);
+    }
+
+    CHECK(ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME));
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME);
+}
+
+TEST_CASE("Callback clock source", "[clock-source]") {
+    const Timestamp fixed = Timestamp::create(1000000000);
+
+    ClockSource_set_callback(&fixed_clock);
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_CALLBACK);
+    CHECK(Timestamp_now() == fixed);
+
+    // Only the time that a callback reads is kept, normalized
+    ClockSource_set_callback(&raw_clock);
+    const Timestamp raw = Timestamp_now();
+    CHECK_FALSE(raw.has_error);
+    CHECK_FALSE(raw.errors.invalid_date);
+    CHECK(raw.data_.additional_nanoseconds == 500000000);
+    CHECK(raw == fixed + TimeDelta::from_milliseconds(2500));
+    ClockSource_set_callback(&fixed_clock);
+
+    // The test time takes precedence over any clock source
+    struct PresentNowStruct test_now = {
+        (time_t) 920180081,
+        (long)   986000000
+    };
+    present_set_test_time(test_now);
+    CHECK(Timestamp_now() == Timestamp::create(920180081) +
+            TimeDelta::from_milliseconds(986));
+
+    // Selecting a source while the test time is set takes effect afterwards
+    CHECK(ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME));
+    CHECK(Timestamp_now() == Timestamp::create(920180081) +
+            TimeDelta::from_milliseconds(986));
+    ClockSource_set_callback(&fixed_clock);
+    present_reset_test_time();
+    CHECK(Timestamp_now() == fixed);
+
+    CHECK(ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME));
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME);
+    CHECK(Timestamp_now() > fixed);
+}
+
+#if __cplusplus >= 201103L
+
+TEST_CASE("Clock sources and the test time from many threads",
+          "[clock-source]") {
+    // One thread keeps changing the test time and the source, while others
+    // read them; every reading must be one of the values that was set
+    struct PresentNowStruct test_now = {(time_t) 920180081, 0L};
+    present_set_test_time(test_now);
+
+    std::thread writer([&test_now]() {
+        for (long i = 0; i < 10000; ++i) {
+            test_now.nsec = (i % 2) * 500000000L;
+            present_set_test_time(test_now);
+            ClockSource_set_callback(&fixed_clock);
+            ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME);
+        }
+    });
+    bool valid[3] = {true, true, true};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.push_back(std::thread([&valid, t]() {
+            const Timestamp first = Timestamp::create(920180081);
+            const Timestamp second =
+                first + TimeDelta::from_milliseconds(500);
+            for (int i = 0; i < 10000; ++i) {
+                const Timestamp now = Timestamp_now();
+                const int source = ClockSource_get();
+                if ((now != first && now != second) ||
+                        (source != PRESENT_CLOCK_SOURCE_REALTIME &&
+                         source != PRESENT_CLOCK_SOURCE_CALLBACK)) {
+                    valid[t] = false;
+                }
+            }
+        }));
+    }
+    writer.join();
+    for (size_t t = 0; t < readers.size(); ++t) {
+        readers[t].join();
+        CHECK(valid[t]);
+    }
+    present_reset_test_time();
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME);
+}
+
+#endif
+
+TEST_CASE("TSC clock source", "[clock-source]") {
+    if (!ClockSource_is_available(PRESENT_CLOCK_SOURCE_TSC)) {
+        // Without an invariant TSC, Timestamp_now stays on the regular path
+        CHECK_FALSE(ClockSource_select(PRESENT_CLOCK_SOURCE_TSC));
+        CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME);
+        CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_TSC) ==
+                TimeDelta::zero());
+        return;
+    }
+
+    CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_TSC) >
+            TimeDelta::zero());
+    CHECK(ClockSource_resolution(PRESENT_CLOCK_SOURCE_TSC) <=
+            TimeDelta::from_nanoseconds(100));
+
+    REQUIRE(ClockSource_select(PRESENT_CLOCK_SOURCE_TSC));
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_TSC);
+
+    // It stays within a millisecond of CLOCK_REALTIME, including across a
+    // resync (once a second)
+    const TimeDelta slack = TimeDelta::from_milliseconds(1);
+    const Instant start = Instant::now();
+    int reads = 0;
+    while (reads < 1000 ||
+            start.elapsed() < TimeDelta::from_milliseconds(1100)) {
+        Timestamp before, after;
+        present_clock_realtime(&before);
+        const Timestamp now = Timestamp_now();
+        present_clock_realtime(&after);
+        CHECK(now >= before - slack);
+        CHECK(now <= after + slack);
+        ++reads;
+    }
+
+    CHECK(ClockSource_select(PRESENT_CLOCK_SOURCE_REALTIME));
+    CHECK(ClockSource_get() == PRESENT_CLOCK_SOURCE_REALTIME);
+}
+
@@ -304,6 +304,30 @@ TEST_CASE("ClockTime arithmetic operators", "[clock-time]") {
     }
 }
 
+TEST_CASE("ClockTime batch creator", "[clock-time]") {
+    const int_hour hours[4] = {0, 25, 23, 12};
+    const int_minute minutes[4] = {0, 0, 59, 60};
+    const int_second seconds[4] = {0, 0, 60, 0};
+    ClockTime results[4];
+    present_uint64 error_mask[PRESENT_BATCH_MASK_WORDS(4)];
+
+    CHECK(ClockTime::create_batch(hours, minutes, seconds, results,
+                error_mask, 4) == 2);
+    CHECK(error_mask[0] == ((1 << 1) | (1 << 3)));
+
+    CHECK(results[0] == ClockTime::midnight());
+    CHECK(results[1].has_error);
+    CHECK(results[1].errors.hour_out_of_range);
+    CHECK(results[2] == ClockTime::create(23, 59, 60));
+    CHECK(results[3].has_error);
+    CHECK(results[3].errors.minute_out_of_range);
+
+    CHECK(ClockTime_batch_from_hour_minute_second(hours, minutes, seconds,
+                results, NULL, 4) == 2);
+    CHECK(ClockTime_batch_from_hour_minute_second(hours, minutes, seconds,
+                results, error_mask, 0) == 0);
+}
+
 TEST_CASE("ClockTime comparison operators", "[clock-time]") {
     ClockTime c1 = ClockTime::create(0, 0, 0, 0),
               c2 = ClockTime::create(0, 0, 0, 1),
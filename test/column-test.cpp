@@ -0,0 +1,427 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the DateColumn and TimestampColumn C++ classes and C-compatible
+ * methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/** Check whether a pointer is aligned to PRESENT_COLUMN_ALIGNMENT bytes. */
+#define IS_ALIGNED(pointer) \
+    ((size_t)(pointer) % PRESENT_COLUMN_ALIGNMENT == 0)
+
+/**
+ * Create a timestamp from a number of seconds and nanoseconds since the UNIX
+ * epoch.
+ */
+static Timestamp
+make_timestamp(time_t seconds, int_nanosecond nanoseconds)
+{
+    return Timestamp::create(seconds) +
+        TimeDelta::from_nanoseconds(nanoseconds);
+}
+
+TEST_CASE("DateColumn storage", "[column] [date]") {
+    DateColumn column;
+    CHECK(column.empty());
+    CHECK(column.size() == 0);
+
+    const Date start = Date::create(1970, 1, 1);
+    for (int i = -800000; i <= 800000; i += 997) {
+        column.push_back(start + DayDelta::from_days(i));
+    }
+    REQUIRE(column.size() == 1605);
+    CHECK(column.capacity() >= column.size());
+    CHECK(IS_ALIGNED(column.days()));
+
+    /* Dates are stored as days since the UNIX epoch, and come back as the
+       same Date (including the day of the year and the day of the week) */
+    for (size_t i = 0; i < column.size(); ++i) {
+        const Date d = start + DayDelta::from_days(-800000 + (int)i * 997);
+        REQUIRE(column.days()[i] == -800000 + (int_delta)i * 997);
+        CHECK(column[i] == d);
+        CHECK(column[i].day_of_year() == d.day_of_year());
+        CHECK(column[i].day_of_week() == d.day_of_week());
+    }
+
+    /* Copies have their own (aligned) arrays */
+    DateColumn copy(column);
+    CHECK(copy.size() == column.size());
+    CHECK(copy.days() != column.days());
+    CHECK(IS_ALIGNED(copy.days()));
+    copy += DayDelta::from_days(1);
+    CHECK(copy[0] == column[0] + DayDelta::from_days(1));
+
+    DateColumn other;
+    other.push_back(Date::create(2000, 1, 1));
+    other.swap(copy);
+    CHECK(other.size() == 1605);
+    CHECK(copy.size() == 1);
+    CHECK(copy[0] == Date::create(2000, 1, 1));
+
+    copy = column;
+    CHECK(copy.size() == column.size());
+    CHECK(copy[1604] == column[1604]);
+
+    column.clear();
+    CHECK(column.empty());
+    CHECK(column.capacity() >= 1605);
+}
+
+TEST_CASE("DateColumn bulk operations", "[column] [date]") {
+    DateColumn column;
+    column.push_back(Date::create(2024, 3, 1));
+    column.push_back(Date::create(1969, 12, 31));
+    column.push_back(Date::create(2024, 2, 29));
+    column.push_back(Date::create(2100, 1, 1));
+    column.push_back(Date::create(2024, 3, 1));
+
+    CHECK(column.min() == Date::create(1969, 12, 31));
+    CHECK(column.max() == Date::create(2100, 1, 1));
+
+    /* The range includes the low end, but not the high end */
+    std::vector<size_t> selection(column.size());
+    REQUIRE(column.filter_range(Date::create(2024, 2, 29),
+                Date::create(2024, 3, 2), &selection[0]) == 3);
+    CHECK(selection[0] == 0);
+    CHECK(selection[1] == 2);
+    CHECK(selection[2] == 4);
+    CHECK(column.filter_range(Date::create(2024, 3, 1),
+                Date::create(2024, 3, 1), &selection[0]) == 0);
+
+    std::vector<present_int8> results(column.size());
+    column.compare(Date::create(2024, 3, 1), &results[0]);
+    CHECK(results[0] == 0);
+    CHECK(results[1] < 0);
+    CHECK(results[2] < 0);
+    CHECK(results[3] > 0);
+    CHECK(results[4] == 0);
+
+    column -= DayDelta::from_weeks(1);
+    CHECK(column[0] == Date::create(2024, 2, 23));
+    CHECK(column[1] == Date::create(1969, 12, 24));
+    column += DayDelta::from_days(8);
+    CHECK(column[2] == Date::create(2024, 3, 1));
+    CHECK(column[3] == Date::create(2100, 1, 2));
+}
+
+TEST_CASE("TimestampColumn storage", "[column] [timestamp]") {
+    TimestampColumn column;
+    CHECK(column.empty());
+
+    for (int i = 0; i < 1000; ++i) {
+        column.push_back(make_timestamp(
+                    (time_t)(i - 500) * 86399 * 97, i * 999999));
+    }
+    REQUIRE(column.size() == 1000);
+    CHECK(IS_ALIGNED(column.seconds()));
+    CHECK(IS_ALIGNED(column.nanoseconds()));
+
+    for (size_t i = 0; i < column.size(); ++i) {
+        CHECK(column[i] == make_timestamp(
+                    (time_t)((int)i - 500) * 86399 * 97, (int)i * 999999));
+        CHECK(column.seconds()[i] == column[i].get_time_t());
+    }
+
+    TimestampColumn copy;
+    copy = column;
+    CHECK(copy.size() == 1000);
+    CHECK(IS_ALIGNED(copy.nanoseconds()));
+    CHECK(copy[999] == column[999]);
+}
+
+TEST_CASE("TimestampColumn bulk operations", "[column] [timestamp]") {
+    TimestampColumn column;
+    std::vector<Timestamp> values;
+
+    /* Several timestamps share each second, so that the nanoseconds matter */
+    for (int i = 0; i < 300; ++i) {
+        values.push_back(make_timestamp(
+                    (time_t)((i * 7919) % 101 - 50) * 43201,
+                    (i * 104729) % 1000000000));
+        column.push_back(values.back());
+    }
+
+    Timestamp expected_min = values[0], expected_max = values[0];
+    for (size_t i = 1; i < values.size(); ++i) {
+        if (values[i] < expected_min) expected_min = values[i];
+        if (values[i] > expected_max) expected_max = values[i];
+    }
+    CHECK(column.min() == expected_min);
+    CHECK(column.max() == expected_max);
+
+    const Timestamp low = values[17], high = values[42];
+    std::vector<size_t> selection(column.size());
+    const size_t count = column.filter_range(low, high, &selection[0]);
+    size_t expected_count = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] >= low && values[i] < high) {
+            REQUIRE(expected_count < count);
+            CHECK(selection[expected_count] == i);
+            ++expected_count;
+        }
+    }
+    CHECK(count == expected_count);
+
+    std::vector<present_int8> results(column.size());
+    column.compare(values[99], &results[0]);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const short expected = Timestamp::compare(values[i], values[99]);
+        CHECK((results[i] < 0) == (expected < 0));
+        CHECK((results[i] > 0) == (expected > 0));
+    }
+
+    const TimeDelta deltas[] = {
+        TimeDelta::from_nanoseconds(999999999),
+        TimeDelta::from_nanoseconds(-999999999),
+        TimeDelta::from_milliseconds(-1500),
+        TimeDelta::from_hours(-36) - TimeDelta::from_nanoseconds(1),
+    };
+    for (size_t d = 0; d < sizeof(deltas) / sizeof(deltas[0]); ++d) {
+        TimestampColumn added(column), subtracted(column);
+        added += deltas[d];
+        subtracted -= deltas[d];
+        for (size_t i = 0; i < values.size(); ++i) {
+            CHECK(added[i] == values[i] + deltas[d]);
+            CHECK(subtracted[i] == values[i] - deltas[d]);
+        }
+    }
+}
+
+TEST_CASE("TimestampColumn to DateColumn", "[column] [timestamp] [date]") {
+    TimestampColumn column;
+
+    for (time_t time = (time_t)-5 * 1000000000;
+            time <= (time_t)5 * 1000000000; time += 86399 * 97) {
+        column.push_back(make_timestamp(time, 500000000));
+    }
+    column.push_back(make_timestamp(-1, 999999999));
+    column.push_back(make_timestamp(86399, 999999999));
+
+    const DateColumn utc = column.get_date_column_utc();
+    REQUIRE(utc.size() == column.size());
+    for (size_t i = 0; i < column.size(); ++i) {
+        CHECK(utc[i] == column[i].get_date_utc());
+    }
+
+    /* Offsets with nanoseconds can move a timestamp into the next day */
+    const TimeDelta offsets[] = {
+        TimeDelta::from_hours(-5),
+        TimeDelta::from_minutes(330),
+        TimeDelta::from_nanoseconds(1),
+        TimeDelta::from_nanoseconds(-999999999),
+    };
+    for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); ++o) {
+        const DateColumn local = column.get_date_column(offsets[o]);
+        REQUIRE(local.size() == column.size());
+        for (size_t i = 0; i < column.size(); ++i) {
+            CHECK(local[i] == column[i].get_date(offsets[o]));
+        }
+    }
+}
+
+TEST_CASE("TimestampColumn truncation and buckets",
+        "[column] [timestamp]") {
+    TimestampColumn column;
+
+    for (time_t time = (time_t)-5 * 1000000000;
+            time <= (time_t)5 * 1000000000; time += 86399 * 97 + 13) {
+        column.push_back(make_timestamp(time, (int_nanosecond)
+                    ((time * 7919 % 1000000000 + 1000000000) % 1000000000)));
+    }
+    column.push_back(make_timestamp(-1, 999999999));
+    column.push_back(make_timestamp(0, 0));
+
+    /* Each result must match the result for the single Timestamp */
+    const TimeDelta offsets[] = {
+        TimeDelta::zero(),
+        TimeDelta::from_minutes(330),
+        TimeDelta::from_hours(-5),
+    };
+    for (int unit = PRESENT_TRUNCATE_MICROSECOND;
+            unit <= PRESENT_TRUNCATE_YEAR; ++unit) {
+        for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); ++o) {
+            TimestampColumn result(column);
+            result.truncate(unit, offsets[o]);
+            for (size_t i = 0; i < column.size(); ++i) {
+                CHECK(result[i] == column[i].truncate(unit, offsets[o]));
+            }
+        }
+    }
+
+    /* Whole seconds, widths that divide a second, other widths, and an
+       origin far enough away to need the exact (non-vectorized) path */
+    const TimeDelta widths[] = {
+        TimeDelta::from_minutes(7),
+        TimeDelta::from_milliseconds(1),
+        TimeDelta::from_nanoseconds(1500000007),
+        TimeDelta::from_days(400),
+    };
+    const Timestamp origins[] = {
+        Timestamp::epoch(),
+        make_timestamp(1234567, 89),
+        Timestamp::create_utc(Date::create(1, 1, 1),
+                ClockTime::create(0, 0, 0)),
+    };
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+        for (size_t o = 0; o < sizeof(origins) / sizeof(origins[0]); ++o) {
+            TimestampColumn result(column);
+            result.bucket(widths[w], origins[o]);
+            for (size_t i = 0; i < column.size(); ++i) {
+                CHECK(result[i] == column[i].bucket(widths[w], origins[o]));
+            }
+
+            std::vector<int_delta> first(column.size()), last(column.size());
+            column.get_windows(widths[w] * 3L, widths[w], origins[o],
+                    &first[0], &last[0]);
+            for (size_t i = 0; i < column.size(); ++i) {
+                int_delta expected_first, expected_last;
+                column[i].get_windows(widths[w] * 3L, widths[w], origins[o],
+                        &expected_first, &expected_last);
+                CHECK(first[i] == expected_first);
+                CHECK(last[i] == expected_last);
+            }
+        }
+    }
+
+    /* An empty column needs no output arrays */
+    const TimestampColumn empty;
+    empty.get_windows(widths[0], widths[0], origins[0], NULL, NULL);
+    CHECK(empty.size() == 0);
+}
+
+TEST_CASE("TimestampColumn C functions", "[column] [timestamp]") {
+    struct TimestampColumn column;
+    struct DateColumn dates;
+    struct Timestamp t;
+
+    TimestampColumn_init(&column);
+    DateColumn_init(&dates);
+
+    REQUIRE(TimestampColumn_reserve(&column, 5));
+    CHECK(column.capacity_ >= 5);
+    CHECK(IS_ALIGNED(column.seconds_));
+
+    t = Timestamp_from_time_t(1234567890);
+    REQUIRE(TimestampColumn_push_back(&column, &t));
+    t = Timestamp_from_time_t(0);
+    REQUIRE(TimestampColumn_push_back(&column, &t));
+    CHECK(column.size_ == 2);
+
+    t = TimestampColumn_min(&column);
+    CHECK(Timestamp_get_time_t(&t) == 0);
+    t = TimestampColumn_max(&column);
+    CHECK(Timestamp_get_time_t(&t) == 1234567890);
+
+    REQUIRE(TimestampColumn_get_date_column_utc(&column, &dates));
+    CHECK(dates.size_ == 2);
+    CHECK(DateColumn_get(&dates, 0) == Date::create(2009, 2, 13));
+    CHECK(DateColumn_get(&dates, 1) == Date::create(1970, 1, 1));
+
+    DateColumn_destroy(&dates);
+    TimestampColumn_destroy(&column);
+    CHECK(column.seconds_ == NULL);
+    CHECK(column.size_ == 0);
+}
+
+TEST_CASE("DateColumn sorting and dedup", "[column] [date]") {
+    DateColumn column;
+    std::vector<int_delta> expected;
+    unsigned long seed = 1;
+
+    /* Enough dates to split the parallel sort between threads */
+    for (int i = 0; i < 300000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const int days = (int)((seed >> 8) % 200001) - 100000;
+        column.push_back(Date::create(1970, 1, 1) + DayDelta::from_days(days));
+        expected.push_back(days);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    DateColumn parallel(column);
+    std::vector<size_t> permutation(column.size());
+    column.sort(&permutation[0]);
+    parallel.sort_parallel(4);
+
+    for (size_t i = 0; i < column.size(); ++i) {
+        REQUIRE(column.days()[i] == expected[i]);
+        REQUIRE(parallel.days()[i] == expected[i]);
+    }
+    /* Equal dates keep their original order */
+    for (size_t i = 1; i < column.size(); ++i) {
+        if (column.days()[i] == column.days()[i - 1]) {
+            REQUIRE(permutation[i] > permutation[i - 1]);
+        }
+    }
+
+    expected.erase(std::unique(expected.begin(), expected.end()),
+            expected.end());
+    CHECK(column.unique() == expected.size());
+    REQUIRE(column.size() == expected.size());
+    for (size_t i = 0; i < column.size(); ++i) {
+        REQUIRE(column.days()[i] == expected[i]);
+    }
+}
+
+TEST_CASE("TimestampColumn sorting and dedup", "[column] [timestamp]") {
+    TimestampColumn column;
+    std::vector<Timestamp> values;
+    unsigned long seed = 1;
+
+    /* Many timestamps share each second (and some are equal), so that both
+       the seconds and the nanoseconds matter */
+    for (int i = 0; i < 300000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        values.push_back(make_timestamp(
+                    (time_t)((seed >> 8) % 20001) - 10000,
+                    (int_nanosecond)((seed >> 4) % 2000) * 499999));
+        column.push_back(values.back());
+    }
+
+    TimestampColumn parallel(column);
+    std::vector<size_t> permutation(column.size());
+    std::vector<size_t> parallel_permutation(column.size());
+    column.sort(&permutation[0]);
+    parallel.sort_parallel(4, &parallel_permutation[0]);
+
+    std::vector<Timestamp> expected(values);
+    std::stable_sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < column.size(); ++i) {
+        REQUIRE(column[i] == expected[i]);
+        REQUIRE(parallel[i] == expected[i]);
+        /* The permutation says where each timestamp came from, and is the
+           same for the parallel sort (which is also stable) */
+        REQUIRE(values[permutation[i]] == column[i]);
+        REQUIRE(parallel_permutation[i] == permutation[i]);
+    }
+
+    expected.erase(std::unique(expected.begin(), expected.end()),
+            expected.end());
+    CHECK(column.unique() == expected.size());
+    REQUIRE(column.size() == expected.size());
+    for (size_t i = 0; i < column.size(); ++i) {
+        REQUIRE(column[i] == expected[i]);
+    }
+
+    /* Sorting a column of timestamps before the epoch */
+    TimestampColumn small;
+    small.push_back(make_timestamp(-1, 5));
+    small.push_back(make_timestamp(-2, 999999999));
+    small.push_back(make_timestamp(-1, 4));
+    small.sort();
+    CHECK(small[0] == make_timestamp(-2, 999999999));
+    CHECK(small[1] == make_timestamp(-1, 4));
+    CHECK(small[2] == make_timestamp(-1, 5));
+}
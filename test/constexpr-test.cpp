@@ -0,0 +1,183 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the constexpr C++ methods and the user-defined literals
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+#if __cplusplus >= 201402L
+
+/*
+ * These are all evaluated at compile time; if any of them can't be, then
+ * this file will fail to compile.
+ */
+
+static_assert(Date::create(2024, 3, 1).day_of_week() == DAY_OF_WEEK_FRIDAY,
+        "Date::create should be constexpr");
+static_assert(Date::create(2024, 3, 1).day_of_year() == 61,
+        "Date::day_of_year should be constexpr");
+static_assert(Date::create(2023, 2, 29).errors.day_out_of_range,
+        "Date::create should report errors at compile time");
+static_assert(Date::create(2024, 1, 31) + MonthDelta::from_months(1) ==
+        Date::create(2024, 3, 2),
+        "Date arithmetic should be constexpr");
+static_assert(Date::from_year_week_day(2009, 53, 7) ==
+        Date::create(2010, 1, 3),
+        "Date::from_year_week_day should be constexpr");
+static_assert(Date::create(2010, 1, 3).week_of_year().week == 53,
+        "Date::week_of_year should be constexpr");
+
+static_assert(ClockTime::create(13, 45, 30).minute() == 45,
+        "ClockTime::create should be constexpr");
+static_assert((ClockTime::create(23, 0) + TimeDelta::from_hours(2)).hour() ==
+        1,
+        "ClockTime arithmetic should be constexpr");
+
+static_assert(TimeDelta::from_minutes(90) == TimeDelta::from_hours(1) +
+        TimeDelta::from_minutes(30),
+        "TimeDelta arithmetic should be constexpr");
+static_assert((TimeDelta::from_seconds(3) / 2L).milliseconds() == 1500,
+        "TimeDelta division should be constexpr");
+static_assert(DayDelta::from_weeks(2) == TimeDelta::from_days(14),
+        "DayDelta/TimeDelta comparison should be constexpr");
+
+static_assert(Timestamp::create_utc(
+            Date::create(1970, 1, 2), ClockTime::midnight()).get_time_t() ==
+        86400,
+        "Timestamp::create_utc should be constexpr");
+static_assert(Timestamp::create(
+            Date::create(2024, 3, 1), ClockTime::noon(),
+            TimeDelta::from_hours(-5)).get_clock_time_utc().hour() == 17,
+        "Timestamp time zone conversion should be constexpr");
+
+using namespace present_literals;
+
+static_assert("2024-03-01"_date == Date::create(2024, 3, 1),
+        "_date should be constexpr");
+static_assert("2024-02-30"_date.errors.day_out_of_range,
+        "_date should report errors at compile time");
+static_assert(90_min == TimeDelta::from_seconds(5400),
+        "_min should be constexpr");
+
+#endif
+
+TEST_CASE("C++ methods match the C functions", "[constexpr] [date]") {
+    int_year year;
+    int_month month;
+    int_day day;
+    Date cpp, c;
+
+    for (year = 1595; year <= 2405; year += 5) {
+        for (month = 1; month <= 12; ++month) {
+            for (day = 1; day <= 31; day += 3) {
+                cpp = Date::create(year, month, day);
+                Date_ptr_from_year_month_day(&c, year, month, day);
+                REQUIRE(cpp.has_error == c.has_error);
+                if (cpp.has_error) continue;
+
+                CHECK(cpp.data_.day_of_year == c.data_.day_of_year);
+                CHECK(cpp.data_.day_of_week == c.data_.day_of_week);
+
+                struct PresentWeekYear cpp_week = cpp.week_of_year();
+                struct PresentWeekYear c_week = Date_week_of_year(&c);
+                CHECK(cpp_week.week == c_week.week);
+                CHECK(cpp_week.year == c_week.year);
+
+                Date c_plus = c;
+                MonthDelta months = MonthDelta::from_months(day - 14);
+                Date_add_MonthDelta(&c_plus, &months);
+                CHECK((cpp + months) == c_plus);
+
+                ClockTime clock_time = ClockTime::create(6, 30);
+                Timestamp cpp_ts = Timestamp::create_utc(cpp, clock_time);
+                Timestamp c_ts = Timestamp_create_utc(&c, &clock_time);
+                CHECK(cpp_ts == c_ts);
+                CHECK(cpp_ts.get_date_utc() == Timestamp_get_date_utc(&c_ts));
+            }
+        }
+    }
+}
+
+#if __cplusplus >= 201103L
+
+TEST_CASE("Date literal", "[constexpr] [date]") {
+    using namespace present_literals;
+    Date d;
+
+    d = "2024-03-01"_date;
+    REQUIRE_FALSE(d.has_error);
+    CHECK(d == Date::create(2024, 3, 1));
+
+    d = "1-1-1"_date;
+    REQUIRE_FALSE(d.has_error);
+    CHECK(d == Date::create(1, 1, 1));
+
+    d = "-44-03-15"_date;
+    REQUIRE_FALSE(d.has_error);
+    CHECK(d == Date::create(-44, 3, 15));
+
+    d = "2024-13-01"_date;
+    CHECK(d.has_error);
+    CHECK(d.errors.month_out_of_range);
+
+    d = "2024-03-01x"_date;
+    CHECK(d.has_error);
+    CHECK(d.errors.month_out_of_range);
+
+    d = ""_date;
+    CHECK(d.has_error);
+}
+
+TEST_CASE("ClockTime literal", "[constexpr] [clock-time]") {
+    using namespace present_literals;
+    ClockTime c;
+
+    c = "13:45"_clock_time;
+    REQUIRE_FALSE(c.has_error);
+    CHECK(c == ClockTime::create(13, 45));
+
+    c = "13:45:30"_clock_time;
+    REQUIRE_FALSE(c.has_error);
+    CHECK(c == ClockTime::create(13, 45, 30));
+
+    c = "13:45:30.25"_clock_time;
+    REQUIRE_FALSE(c.has_error);
+    CHECK(c == ClockTime::create(13, 45, 30, 250000000));
+
+    c = "25:00"_clock_time;
+    CHECK(c.has_error);
+    CHECK(c.errors.hour_out_of_range);
+
+    c = "13"_clock_time;
+    CHECK(c.has_error);
+    CHECK(c.errors.hour_out_of_range);
+}
+
+TEST_CASE("Delta literals", "[constexpr] [time-delta] [day-delta] "
+                            "[month-delta]") {
+    using namespace present_literals;
+
+    CHECK(5_ns == TimeDelta::from_nanoseconds(5));
+    CHECK(5_us == TimeDelta::from_microseconds(5));
+    CHECK(5_ms == TimeDelta::from_milliseconds(5));
+    CHECK(5_s == TimeDelta::from_seconds(5));
+    CHECK(90_min == TimeDelta::from_minutes(90));
+    CHECK(5_h == TimeDelta::from_hours(5));
+
+    CHECK(5_days == DayDelta::from_days(5));
+    CHECK(5_weeks == DayDelta::from_weeks(5));
+
+    CHECK(5_months == MonthDelta::from_months(5));
+    CHECK(5_years == MonthDelta::from_years(5));
+
+    CHECK(-(2_h) == TimeDelta::from_hours(-2));
+}
+
+#endif
@@ -0,0 +1,316 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the CronSchedule C++ class and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/** The time zone offset of the schedules in these tests (UTC+5:30). */
+static const TimeDelta OFFSET =
+    TimeDelta::from_hours(5) + TimeDelta::from_minutes(30);
+
+/** Create a Timestamp at a date and time in OFFSET. */
+static Timestamp
+local_time(int year, int month, int day, int hour, int minute, int second = 0)
+{
+    return Timestamp::create(Date::create(year, month, day),
+            ClockTime::create(hour, minute, second), OFFSET);
+}
+
+/**
+ * Find the next time after a Timestamp that matches a schedule by stepping
+ * through the times one at a time (a second or a minute at a time).
+ */
+static Timestamp
+brute_next_after(const CronSchedule & schedule, const Timestamp & timestamp,
+        int step_seconds)
+{
+    const TimeDelta step = TimeDelta::from_seconds(step_seconds);
+    /* Round down to a multiple of the step (OFFSET is a whole number of
+       minutes, so this is the same in UTC and in local time) */
+    const time_t seconds = timestamp.get_time_t();
+    Timestamp t = Timestamp::create(
+            seconds - ((seconds % step_seconds) + step_seconds) %
+            step_seconds);
+    do {
+        t += step;
+    } while (!schedule.matches(t));
+    return t;
+}
+
+/** Find the previous time before a Timestamp that matches a schedule. */
+static Timestamp
+brute_prev_before(const CronSchedule & schedule, const Timestamp & timestamp,
+        int step_seconds)
+{
+    const TimeDelta step = TimeDelta::from_seconds(step_seconds);
+    const time_t seconds = timestamp.get_time_t();
+    Timestamp t = Timestamp::create(
+            seconds - ((seconds % step_seconds) + step_seconds) %
+            step_seconds);
+    if (t < timestamp) {
+        t += step;
+    }
+    do {
+        t -= step;
+    } while (!schedule.matches(t));
+    return t;
+}
+
+TEST_CASE("CronSchedule next and previous times", "[cron-schedule]") {
+    const CronSchedule weekdays = CronSchedule::create("0 9 * * MON-FRI",
+            OFFSET);
+    REQUIRE_FALSE(weekdays.has_error);
+
+    /* Friday, April 5, 2024 */
+    CHECK(weekdays.next_after(local_time(2024, 4, 5, 17, 0)) ==
+            local_time(2024, 4, 8, 9, 0));
+    CHECK(weekdays.next_after(local_time(2024, 4, 5, 8, 59, 59)) ==
+            local_time(2024, 4, 5, 9, 0));
+    CHECK(weekdays.next_after(local_time(2024, 4, 5, 9, 0)) ==
+            local_time(2024, 4, 8, 9, 0));
+    CHECK(weekdays.prev_before(local_time(2024, 4, 8, 9, 0)) ==
+            local_time(2024, 4, 5, 9, 0));
+    CHECK(weekdays.prev_before(local_time(2024, 4, 8, 9, 0) +
+                TimeDelta::from_nanoseconds(1)) ==
+            local_time(2024, 4, 8, 9, 0));
+    CHECK(weekdays.matches(local_time(2024, 4, 8, 9, 0) +
+                TimeDelta::from_milliseconds(999)));
+    CHECK_FALSE(weekdays.matches(local_time(2024, 4, 8, 9, 0, 1)));
+    CHECK_FALSE(weekdays.matches(local_time(2024, 4, 7, 9, 0)));
+
+    /* Leap days are years apart */
+    const CronSchedule leap_day = CronSchedule::create_utc("0 0 29 FEB *");
+    REQUIRE_FALSE(leap_day.has_error);
+    CHECK(leap_day.next_after(Timestamp::create_utc(Date::create(2024, 3, 1),
+                    ClockTime::create(0))) ==
+            Timestamp::create_utc(Date::create(2028, 2, 29),
+                ClockTime::create(0)));
+    CHECK(leap_day.prev_before(Timestamp::create_utc(Date::create(2024, 2, 28),
+                    ClockTime::create(0))) ==
+            Timestamp::create_utc(Date::create(2020, 2, 29),
+                ClockTime::create(0)));
+    CHECK(leap_day.prev_before(Timestamp::create_utc(Date::create(2000, 1, 1),
+                    ClockTime::create(0))) ==
+            Timestamp::create_utc(Date::create(1996, 2, 29),
+                ClockTime::create(0)));
+
+    /* With both day fields, either one matches (Friday the 13th is just
+       another Friday) */
+    const CronSchedule either = CronSchedule::create("0 0 13 * FRI", OFFSET);
+    REQUIRE_FALSE(either.has_error);
+    CHECK(either.next_after(local_time(2024, 9, 10, 0, 0)) ==
+            local_time(2024, 9, 13, 0, 0));
+    CHECK(either.next_after(local_time(2024, 9, 13, 0, 0)) ==
+            local_time(2024, 9, 20, 0, 0));
+    CHECK(either.next_after(local_time(2024, 9, 27, 0, 0)) ==
+            local_time(2024, 10, 4, 0, 0));
+    CHECK(either.next_after(local_time(2024, 10, 11, 0, 0)) ==
+            local_time(2024, 10, 13, 0, 0));
+
+    /* 6 fields, with the seconds first, and the end of a year */
+    const CronSchedule seconds = CronSchedule::create_utc(
+            "*/20 59 23 31 DEC ?");
+    REQUIRE_FALSE(seconds.has_error);
+    CHECK(seconds.next_after(Timestamp::create_utc(Date::create(2023, 12, 31),
+                    ClockTime::create(23, 59, 40))) ==
+            Timestamp::create_utc(Date::create(2024, 12, 31),
+                ClockTime::create(23, 59, 0)));
+    CHECK(seconds.prev_before(Timestamp::create_utc(Date::create(2024, 1, 1),
+                    ClockTime::create(0))) ==
+            Timestamp::create_utc(Date::create(2023, 12, 31),
+                ClockTime::create(23, 59, 40)));
+
+    /* Macros */
+    const CronSchedule yearly = CronSchedule::create_utc("@yearly");
+    REQUIRE_FALSE(yearly.has_error);
+    CHECK(yearly.next_after(Timestamp::create(0)) ==
+            Timestamp::create_utc(Date::create(1971, 1, 1),
+                ClockTime::create(0)));
+    CHECK(yearly.prev_before(Timestamp::create(0)) ==
+            Timestamp::create_utc(Date::create(1969, 1, 1),
+                ClockTime::create(0)));
+    const CronSchedule hourly = CronSchedule::create_utc("@hourly");
+    CHECK(hourly.next_after(Timestamp::create(5)) == Timestamp::create(3600));
+}
+
+TEST_CASE("CronSchedule against stepping through the times",
+        "[cron-schedule]") {
+    struct Case {
+        const char * expression;
+        int step_seconds;
+    };
+    const Case cases[] = {
+        {"* * * * *", 60},
+        {"*/15 9-17 * * MON-FRI", 60},
+        {"30 2 * * 0", 60},
+        {"5,10,50 */5 1-7 * 1", 60},
+        {"0 0 31 * *", 60},
+        {"0 0 1,15 * SAT", 60},
+        {"20-40/7 3 * JAN-MAR,NOV sun-tue", 60},
+        {"*/20 */7 * * * *", 1},
+        {"10 30 23 * * 7", 1},
+    };
+    const Timestamp starts[] = {
+        local_time(2024, 1, 31, 23, 59, 59),
+        local_time(2024, 2, 28, 12, 0) + TimeDelta::from_milliseconds(250),
+        local_time(2023, 12, 31, 23, 58),
+        local_time(1969, 12, 31, 18, 30),
+        local_time(2024, 11, 30, 3, 40),
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        INFO(cases[i].expression);
+        const CronSchedule schedule = CronSchedule::create(
+                cases[i].expression, OFFSET);
+        REQUIRE_FALSE(schedule.has_error);
+
+        for (size_t j = 0; j < sizeof(starts) / sizeof(starts[0]); ++j) {
+            Timestamp next = starts[j], prev = starts[j];
+            /* Follow a few times in a row in each direction */
+            for (int k = 0; k < 3; ++k) {
+                const Timestamp expected_next = brute_next_after(schedule,
+                        next, cases[i].step_seconds);
+                const Timestamp expected_prev = brute_prev_before(schedule,
+                        prev, cases[i].step_seconds);
+                next = schedule.next_after(next);
+                prev = schedule.prev_before(prev);
+                CHECK(next == expected_next);
+                CHECK(prev == expected_prev);
+                CHECK(schedule.matches(next));
+                CHECK(schedule.matches(prev));
+            }
+        }
+    }
+}
+
+TEST_CASE("CronSchedule errors", "[cron-schedule]") {
+    const char * const invalid[] = {
+        "",
+        "* * * *",
+        "* * * * * * *",
+        "60 * * * *",
+        "* 24 * * *",
+        "* * 0 * *",
+        "* * 32 * *",
+        "* * * 0 *",
+        "* * * 13 *",
+        "* * * * 8",
+        "5-1 * * * *",
+        "*/0 * * * *",
+        "1, * * * *",
+        "1-* * * * *",
+        "0 12 15,L * *",
+        "MON * * * *",
+        "* * * * MONDAY",
+        "100 * * * *",
+        "*/x * * * *",
+        "@often",
+        "@daily *",
+    };
+    const char * const never[] = {
+        "0 0 30 2 *",
+        "0 0 31 4,6,9,11 *",
+        "0 0 30,31 FEB *",
+    };
+    const char * const valid[] = {
+        "0 0 31 2 FRI",
+        "0 0 29 2 *",
+        "0 0 * 2 *",
+        "  0   0   1   1   *  ",
+        "0 0 * * 7",
+        "0 0 1 * *",
+        "@weekly",
+        "@annually",
+        "@monthly",
+        "@midnight",
+    };
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        INFO(invalid[i]);
+        const CronSchedule schedule = CronSchedule::create_utc(invalid[i]);
+        CHECK(schedule.has_error);
+        CHECK(schedule.errors.invalid_expression);
+        CHECK_FALSE(schedule.errors.never_matches);
+    }
+    for (size_t i = 0; i < sizeof(never) / sizeof(never[0]); ++i) {
+        INFO(never[i]);
+        const CronSchedule schedule = CronSchedule::create_utc(never[i]);
+        CHECK(schedule.has_error);
+        CHECK(schedule.errors.never_matches);
+        CHECK_FALSE(schedule.errors.invalid_expression);
+    }
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); ++i) {
+        INFO(valid[i]);
+        CHECK_FALSE(CronSchedule::create_utc(valid[i]).has_error);
+    }
+}
+
+TEST_CASE("CronSchedule batches", "[cron-schedule]") {
+    const char * const expressions[] = {
+        "0 9 * * MON-FRI",
+        "*/5 * * * *",
+        "0 0 1 1 *",
+        "0 0 13 * FRI",
+    };
+    const TimeDelta offsets[] = {
+        OFFSET, OFFSET, TimeDelta::from_hours(-8), TimeDelta::zero()
+    };
+    const size_t count = sizeof(expressions) / sizeof(expressions[0]);
+    std::vector<CronSchedule> schedules;
+    for (size_t i = 0; i < count; ++i) {
+        schedules.push_back(CronSchedule::create(expressions[i], offsets[i]));
+        REQUIRE_FALSE(schedules.back().has_error);
+    }
+
+    const Timestamp now = local_time(2024, 6, 7, 23, 57, 12) +
+        TimeDelta::from_microseconds(5);
+    std::vector<Timestamp> results(count);
+    CronSchedule::next_after_batch(&schedules[0], now, &results[0], count);
+    for (size_t i = 0; i < count; ++i) {
+        INFO(expressions[i]);
+        CHECK(results[i] == schedules[i].next_after(now));
+    }
+    CHECK(results[1] == local_time(2024, 6, 8, 0, 0));
+}
+
+TEST_CASE("CronSchedule C functions", "[cron-schedule]") {
+    struct TimeDelta offset = TimeDelta_from_hours(-4);
+    struct CronSchedule schedule = CronSchedule_from_expression(
+            "0 30 8 * * 1-5", &offset);
+    struct Date date = Date_from_year_month_day(2024, 3, 1);
+    struct ClockTime time = ClockTime_from_hour_minute(8, 30);
+    struct Timestamp friday = Timestamp_create(&date, &time, &offset);
+    struct Timestamp result;
+
+    REQUIRE_FALSE(schedule.has_error);
+    CHECK(CronSchedule_matches(&schedule, &friday));
+    result = CronSchedule_next_after(&schedule, &friday);
+    CHECK(Timestamp_get_date(&result, &offset) ==
+            Date_from_year_month_day(2024, 3, 4));
+    result = CronSchedule_prev_before(&schedule, &friday);
+    CHECK(Timestamp_get_date(&result, &offset) ==
+            Date_from_year_month_day(2024, 2, 29));
+
+    struct CronSchedule utc = CronSchedule_from_expression_utc("0 0 * * *");
+    struct Date saturday = Date_from_year_month_day(2024, 3, 2);
+    struct ClockTime midnight = ClockTime_from_hour(0);
+    CronSchedule_batch_next_after(&utc, &friday, &result, 1);
+    CHECK(result == Timestamp_create_utc(&saturday, &midnight));
+
+    schedule = CronSchedule_from_expression_utc("0 0 30 2 *");
+    CHECK(schedule.has_error);
+    CHECK(schedule.errors.never_matches);
+}
+
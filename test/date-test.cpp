@@ -7,6 +7,9 @@
  * For details, see LICENSE.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include "catch.hpp"
 #include "test-utils.hpp"
 
@@ -224,6 +227,71 @@ TEST_CASE("Date creators", "[date]") {
     }
 }
 
+TEST_CASE("Date batch creator", "[date]") {
+    const int_year years[5] = {1999, 2000, 1999, 1969, 2016};
+    const int_month months[5] = {1, 2, 13, 7, 8};
+    const int_day days[5] = {31, 29, 1, 20, 32};
+    Date results[5];
+    present_uint64 error_mask[PRESENT_BATCH_MASK_WORDS(5)];
+
+    CHECK(Date::create_batch(years, months, days, results, error_mask, 5) ==
+            2);
+    CHECK(error_mask[0] == ((1 << 2) | (1 << 4)));
+
+    Date d = results[0];
+    IS(1999, 1, 31);
+    d = results[1];
+    IS(2000, 2, 29);
+    d = results[2];
+    IS_ERROR(month_out_of_range);
+    d = results[3];
+    IS(1969, 7, 20);
+    d = results[4];
+    IS_ERROR(day_out_of_range);
+
+    SECTION("matches the single Date creator") {
+        // Exercise more than one mask word, and the derived fields
+        int_year many_years[200];
+        int_month many_months[200];
+        int_day many_days[200];
+        Date many_results[200];
+        present_uint64 many_errors[PRESENT_BATCH_MASK_WORDS(200)];
+
+        for (int i = 0; i < 200; i++) {
+            many_years[i] = 1890 + i;
+            many_months[i] = i % 14;
+            many_days[i] = i % 31 + 1;
+        }
+
+        size_t error_count = Date_batch_from_year_month_day(
+                many_years, many_months, many_days, many_results,
+                many_errors, 200);
+
+        size_t expected_error_count = 0;
+        for (int i = 0; i < 200; i++) {
+            const Date expected = Date::create(
+                    many_years[i], many_months[i], many_days[i]);
+            const bool mask_bit = (many_errors[i / 64] >> (i % 64)) & 1;
+            CHECK(mask_bit == expected.has_error);
+            REQUIRE(many_results[i].has_error == expected.has_error);
+            if (expected.has_error) {
+                expected_error_count++;
+            } else {
+                CHECK(many_results[i] == expected);
+                CHECK(many_results[i].day_of_year() ==
+                        expected.day_of_year());
+                CHECK(many_results[i].day_of_week() ==
+                        expected.day_of_week());
+            }
+        }
+        CHECK(error_count == expected_error_count);
+
+        // The error mask is optional
+        CHECK(Date_batch_from_year_month_day(many_years, many_months,
+                    many_days, many_results, NULL, 200) == error_count);
+    }
+}
+
 TEST_CASE("Date accessors", "[date]") {
     Date d1 = Date::create(1902, 1, 1);
     Date d2 = Date::create(2011, 4, 19);
@@ -338,6 +406,168 @@ TEST_CASE("Date 'week_of_year' and 'day_of_week' edge cases",
     CHECK(d.day_of_week() == DAY_OF_WEEK_SUNDAY);
 }
 
+TEST_CASE("Date calendar queries", "[date]") {
+    Date d;
+
+    // The third Friday of March 2024, and the last Monday of May 2025
+    d = Date::nth_weekday_of_month(2024, 3, DAY_OF_WEEK_FRIDAY, 3);
+    IS(2024, 3, 15);
+    d = Date::nth_weekday_of_month(2025, 5, DAY_OF_WEEK_MONDAY, -1);
+    IS(2025, 5, 26);
+    d = Date_nth_weekday_of_month(2024, 2, DAY_OF_WEEK_THURSDAY, -5);
+    IS(2024, 2, 1);
+    d = Date_nth_weekday_of_month(2024, 2, DAY_OF_WEEK_SUNDAY_COMPAT, -4);
+    IS(2024, 2, 4);
+    d = Date::nth_weekday_of_month(2025, 2, DAY_OF_WEEK_MONDAY, 5);
+    IS_ERROR(day_out_of_range);
+    d = Date::nth_weekday_of_month(2025, 2, DAY_OF_WEEK_MONDAY, 0);
+    IS_ERROR(day_out_of_range);
+    d = Date_nth_weekday_of_month(2025, 13, DAY_OF_WEEK_MONDAY, 1);
+    IS_ERROR(month_out_of_range);
+    d = Date_nth_weekday_of_month(2025, 1, 8, 1);
+    IS_ERROR(day_of_week_out_of_range);
+
+    d = Date::create(2024, 2, 10).last_day_of_month();
+    IS(2024, 2, 29);
+    CHECK(d.day_of_week() == DAY_OF_WEEK_THURSDAY);
+    d = Date::create(1900, 2, 10);
+    CHECK(Date_days_in_month(&d) == 28);
+    d = Date_last_day_of_month(&d);
+    IS(1900, 2, 28);
+
+    // Check every month and day of the week against a walk through the
+    // month
+    std::vector<int_year> years;
+    std::vector<int_month> months;
+    for (int_year year = 1895; year <= 2105; year += 3) {
+        for (int_month month = 1; month <= 12; month++) {
+            years.push_back(year);
+            months.push_back(month);
+
+            std::vector<Date> occurrences[8];
+            const Date first = Date::create(year, month, 1);
+            for (Date date = first; date.month() == month;
+                    date += DayDelta::from_days(1)) {
+                occurrences[date.day_of_week()].push_back(date);
+            }
+            REQUIRE(first.days_in_month() ==
+                    first.last_day_of_month().day());
+            REQUIRE(first.last_day_of_month() ==
+                    Date_last_day_of_month(&first));
+
+            for (int_day_of_week w = 1; w <= 7; w++) {
+                const std::vector<Date> & dates = occurrences[w];
+                for (int n = 1; n <= 5; n++) {
+                    const Date forward = Date::nth_weekday_of_month(
+                            year, month, w, n);
+                    const Date backward = Date::nth_weekday_of_month(
+                            year, month, w, -n);
+                    REQUIRE(forward.has_error == (n > (int)dates.size()));
+                    REQUIRE(backward.has_error == forward.has_error);
+                    const Date c_forward = Date_nth_weekday_of_month(
+                            year, month, w, n);
+                    const Date c_backward = Date_nth_weekday_of_month(
+                            year, month, w, -n);
+                    REQUIRE(c_forward.has_error == forward.has_error);
+                    REQUIRE(c_backward.has_error == forward.has_error);
+                    if (!forward.has_error) {
+                        REQUIRE(forward == dates[n - 1]);
+                        REQUIRE(forward.day_of_week() == w);
+                        REQUIRE(forward.day_of_year() ==
+                                dates[n - 1].day_of_year());
+                        REQUIRE(backward == dates[dates.size() - n]);
+                        REQUIRE(c_forward == forward);
+                        REQUIRE(c_forward.day_of_year() ==
+                                forward.day_of_year());
+                        REQUIRE(c_backward == backward);
+                        REQUIRE(c_backward.day_of_week() == w);
+                    }
+                }
+            }
+        }
+    }
+
+    // The batch variants match the single ones
+    const size_t count = years.size();
+    std::vector<Date> results(count);
+    std::vector<present_uint64> errors(PRESENT_BATCH_MASK_WORDS(count));
+    size_t error_count = Date::nth_weekday_of_month_batch(&years[0],
+            &months[0], DAY_OF_WEEK_TUESDAY, 5, &results[0], &errors[0],
+            count);
+    size_t expected_error_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Date expected = Date::nth_weekday_of_month(
+                years[i], months[i], DAY_OF_WEEK_TUESDAY, 5);
+        REQUIRE(results[i].has_error == expected.has_error);
+        REQUIRE(((errors[i / 64] >> (i % 64)) & 1) ==
+                (present_uint64)expected.has_error);
+        if (expected.has_error) {
+            expected_error_count++;
+        } else {
+            REQUIRE(results[i] == expected);
+        }
+    }
+    CHECK(error_count == expected_error_count);
+
+    months[1] = 0;
+    CHECK(Date::last_day_of_month_batch(&years[0], &months[0], &results[0],
+                &errors[0], count) == 1);
+    CHECK(errors[0] == 2);
+    CHECK(results[1].errors.month_out_of_range);
+    for (size_t i = 2; i < count; i++) {
+        REQUIRE(results[i] ==
+                Date::create(years[i], months[i]).last_day_of_month());
+    }
+}
+
+TEST_CASE("Date weekday counts", "[date]") {
+    std::vector<Date> firsts, ends;
+    std::vector<int_delta> expected[8];
+
+    // Count each day of the week in ranges of up to 40 days, around the
+    // UNIX epoch and elsewhere
+    for (Date first = Date::create(1969, 11, 1);
+            first < Date::create(1970, 3, 1);
+            first += DayDelta::from_days(3)) {
+        for (int length = -10; length <= 40; length += 5) {
+            const Date end = first + DayDelta::from_days(length);
+            const Date & low = length < 0 ? end : first;
+            const Date & high = length < 0 ? first : end;
+            int_delta counts[8] = {0};
+            for (Date date = low; date < high;
+                    date += DayDelta::from_days(1)) {
+                counts[date.day_of_week()]++;
+            }
+            firsts.push_back(first);
+            ends.push_back(end);
+            for (int_day_of_week w = 1; w <= 7; w++) {
+                expected[w].push_back(length < 0 ? -counts[w] : counts[w]);
+                REQUIRE(Date::count_weekday_between(first, end, w) ==
+                        expected[w].back());
+                REQUIRE(Date_count_weekday_between(&first, &end, w) ==
+                        expected[w].back());
+            }
+        }
+    }
+
+    // Mondays in 2024 (which started on a Monday and had 366 days)
+    const Date jan_1_2024 = Date::create(2024, 1, 1);
+    const Date jan_1_2025 = Date::create(2025, 1, 1);
+    CHECK(Date::count_weekday_between(jan_1_2024, jan_1_2025,
+                DAY_OF_WEEK_MONDAY) == 53);
+    CHECK(Date::count_weekday_between(jan_1_2024, jan_1_2025,
+                DAY_OF_WEEK_WEDNESDAY) == 52);
+    CHECK(Date::count_weekday_between(jan_1_2024, jan_1_2025,
+                DAY_OF_WEEK_SUNDAY_COMPAT) == 52);
+
+    std::vector<int_delta> results(firsts.size());
+    for (int_day_of_week w = 1; w <= 7; w++) {
+        Date::count_weekday_between_batch(&firsts[0], &ends[0], w,
+                &results[0], firsts.size());
+        REQUIRE(results == expected[w]);
+    }
+}
+
 TEST_CASE("Date 'difference' functions", "[date]") {
     Date d1 = Date::create(2010, 1, 1);
     Date d2 = Date::create(2010, 1, 2);
@@ -452,3 +682,31 @@ TEST_CASE("Date comparison operators", "[date]") {
     CHECK(!(d1 >= d2));
 }
 
+TEST_CASE("Date sorting", "[date]") {
+    std::vector<Date> dates, expected;
+    unsigned long seed = 12345;
+
+    /* Dates on both sides of year 0, and some that are equal */
+    for (int i = 0; i < 5000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        dates.push_back(Date::create(
+                    (int_year)((seed >> 8) % 4001) - 2000,
+                    (int_month)((seed >> 4) % 12 + 1),
+                    (int_day)((seed >> 16) % 28 + 1)));
+    }
+    dates.push_back(Date::create(-2147483647 - 1, 1, 1));
+    dates.push_back(Date::create(2147483647, 12, 31));
+    expected = dates;
+    std::stable_sort(expected.begin(), expected.end());
+
+    REQUIRE(Date_sort(&dates[0], dates.size()));
+    for (size_t i = 0; i < dates.size(); ++i) {
+        CHECK(dates[i] == expected[i]);
+        CHECK(dates[i].day_of_year() == expected[i].day_of_year());
+    }
+
+    /* Sorting an empty array or a single Date does nothing */
+    Date::sort(NULL, 0);
+    Date::sort(&dates[0], 1);
+    CHECK(dates[0] == expected[0]);
+}
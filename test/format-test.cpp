@@ -0,0 +1,226 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for formatting the C++ classes and C structs as text
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "catch.hpp"
+
+/* The {fmt} formatters are only defined if {fmt} is included first */
+#if __cplusplus >= 201103L && defined(__has_include)
+# if __has_include(<fmt/format.h>)
+#  define FMT_HEADER_ONLY
+#  include <fmt/format.h>
+# endif
+#endif
+
+#include "test-utils.hpp"
+
+#include "present.h"
+
+#if __cplusplus >= 201402L
+
+static_assert(PresentFormat::compile("%FT%T").max_length() == 26,
+        "PresentFormat::compile should be constexpr");
+static_assert(PresentFormat::compile("%Q").has_error,
+        "PresentFormat::compile should report errors at compile time");
+
+#endif
+
+TEST_CASE("Date_format", "[format] [date]") {
+    char buffer[64];
+    Date d = Date::create(2024, 3, 1);
+
+    CHECK(Date_format(&d, "%F", buffer, sizeof(buffer)) == 10);
+    CHECK(std::string(buffer) == "2024-03-01");
+
+    CHECK(d.format("%d/%m/%y (%j, day %u of week %V of %G) %%", buffer,
+                sizeof(buffer)) == 42);
+    CHECK(std::string(buffer) ==
+            "01/03/24 (061, day 5 of week 09 of 2024) %");
+
+    d = Date::create(-44, 3, 15);
+    CHECK(d.format("%Y-%m-%d", buffer, sizeof(buffer)) == 11);
+    CHECK(std::string(buffer) == "-0044-03-15");
+    d = Date::create(12345, 1, 1);
+    CHECK(d.format("%F", buffer, sizeof(buffer)) == 11);
+    CHECK(std::string(buffer) == "12345-01-01");
+
+    /* Invalid conversions, and conversions that a Date doesn't have */
+    CHECK(d.format("%Q", buffer, sizeof(buffer)) == 0);
+    CHECK(d.format("100%", buffer, sizeof(buffer)) == 0);
+    CHECK(d.format("%H", buffer, sizeof(buffer)) == 0);
+
+    /* Not enough room */
+    d = Date::create(2024, 3, 1);
+    CHECK(d.format("%F", buffer, 10) == 0);
+    CHECK(d.format("%F", buffer, 11) == 10);
+    CHECK(d.format("%F", buffer, 0) == 0);
+}
+
+TEST_CASE("Date_format ISO weeks match Date_week_of_year",
+          "[format] [date]") {
+    char buffer[16];
+    char expected[16];
+
+    for (int_year year = 1990; year <= 2030; ++year) {
+        for (int_day_of_year day = 1; day <= 366; day += 1) {
+            if (day == 366 && year % 4 != 0) break;
+            const Date d = Date::from_year_day(year, day);
+            const PresentWeekYear week = d.week_of_year();
+            snprintf(expected, sizeof(expected), "%d-W%02d-%d",
+                    (int)week.year, (int)week.week, (int)d.day_of_week());
+            REQUIRE(d.format("%G-W%V-%u", buffer, sizeof(buffer)) > 0);
+            CHECK(std::string(buffer) == expected);
+        }
+    }
+}
+
+TEST_CASE("ClockTime_format", "[format] [clock-time]") {
+    char buffer[64];
+    ClockTime c = ClockTime::create(13, 5, 9, 120000000);
+
+    CHECK(ClockTime_format(&c, "%T", buffer, sizeof(buffer)) == 8);
+    CHECK(std::string(buffer) == "13:05:09");
+
+    CHECK(c.format("%H%M%S.%f|%R", buffer, sizeof(buffer)) == 22);
+    CHECK(std::string(buffer) == "130509.120000000|13:05");
+
+    CHECK(c.format("%F", buffer, sizeof(buffer)) == 0);
+    CHECK(c.format("%z", buffer, sizeof(buffer)) == 0);
+}
+
+TEST_CASE("Timestamp_format", "[format] [timestamp]") {
+    char buffer[64];
+    Timestamp t = Timestamp::create_utc(
+            Date::create(2009, 2, 13),
+            ClockTime::create(23, 31, 30, 5));
+
+    CHECK(Timestamp_format_utc(&t, "%FT%T.%fZ", buffer, sizeof(buffer)) ==
+            30);
+    CHECK(std::string(buffer) == "2009-02-13T23:31:30.000000005Z");
+
+    CHECK(t.format_utc("%s %z", buffer, sizeof(buffer)) == 16);
+    CHECK(std::string(buffer) == "1234567890 +0000");
+
+    CHECK(t.format("%F %T %z", TimeDelta::from_hours(-5), buffer,
+                sizeof(buffer)) == 25);
+    CHECK(std::string(buffer) == "2009-02-13 18:31:30 -0500");
+
+    CHECK(t.format("%F %T %z", TimeDelta::from_minutes(330), buffer,
+                sizeof(buffer)) == 25);
+    CHECK(std::string(buffer) == "2009-02-14 05:01:30 +0530");
+
+    /* Offsets of 100 hours or more get more digits of hours */
+    CHECK(t.format("[%z]", TimeDelta::from_hours(150), buffer,
+                sizeof(buffer)) == 8);
+    CHECK(std::string(buffer) == "[+15000]");
+    CHECK(t.format("[%z]", TimeDelta::from_hours(-100000) -
+                TimeDelta::from_minutes(7), buffer, sizeof(buffer)) == 11);
+    CHECK(std::string(buffer) == "[-10000007]");
+
+    /* Before the epoch */
+    t = Timestamp::create((time_t)-1);
+    CHECK(t.format_utc("%F %T %s", buffer, sizeof(buffer)) == 22);
+    CHECK(std::string(buffer) == "1969-12-31 23:59:59 -1");
+}
+
+TEST_CASE("Timestamp_format matches the Timestamp getters",
+          "[format] [timestamp]") {
+    char buffer[64];
+    char expected[64];
+
+    for (time_t time = (time_t)-5 * 1000000000;
+            time <= (time_t)5 * 1000000000; time += 86399 * 97) {
+        const Timestamp t = Timestamp::create(time);
+        const Date d = t.get_date_utc();
+        const ClockTime c = t.get_clock_time_utc();
+        snprintf(expected, sizeof(expected),
+                "%04d-%02d-%02d %03d %d %02d:%02d:%02d",
+                (int)d.year(), (int)d.month(), (int)d.day(),
+                (int)d.day_of_year(), (int)d.day_of_week(),
+                (int)c.hour(), (int)c.minute(), (int)c.second());
+        REQUIRE(t.format_utc("%F %j %u %T", buffer, sizeof(buffer)) > 0);
+        CHECK(std::string(buffer) == expected);
+    }
+}
+
+TEST_CASE("PresentFormat", "[format]") {
+    char buffer[64];
+    const PresentFormat iso = PresentFormat::compile("%FT%T");
+
+    REQUIRE_FALSE(iso.has_error);
+    CHECK(iso.max_length() == 26);
+    CHECK(iso.can_format(PRESENT_FORMAT_DATE | PRESENT_FORMAT_CLOCK_TIME));
+    CHECK_FALSE(iso.can_format(PRESENT_FORMAT_DATE));
+
+    const Timestamp t = Timestamp::create((time_t)1234567890);
+    CHECK(iso.format_utc(t, buffer, sizeof(buffer)) == 19);
+    CHECK(std::string(buffer) == "2009-02-13T23:31:30");
+
+    /* Output that fits, even though max_length() would not */
+    CHECK(iso.format_utc(t, buffer, 20) == 19);
+    CHECK(std::string(buffer) == "2009-02-13T23:31:30");
+    CHECK(iso.format_utc(t, buffer, 19) == 0);
+
+    CHECK(iso.format(Date::create(2024, 3, 1), buffer, sizeof(buffer)) == 0);
+    CHECK(PresentFormat::compile("%F").format(
+                Date::create(2024, 3, 1), buffer, sizeof(buffer)) == 10);
+    CHECK(std::string(buffer) == "2024-03-01");
+
+    CHECK(PresentFormat::compile("%").errors.invalid_conversion);
+    CHECK(PresentFormat::compile("%k").errors.invalid_conversion);
+    CHECK(PresentFormat::compile(std::string(100, 'x').c_str())
+            .errors.too_long);
+}
+
+#ifdef FMT_VERSION
+
+TEST_CASE("fmt formatters", "[format]") {
+    const Timestamp t = Timestamp::create_utc(
+            Date::create(2009, 2, 13),
+            ClockTime::create(23, 31, 30, 5));
+
+    CHECK(fmt::format("{}", Date::create(2024, 3, 1)) == "2024-03-01");
+    CHECK(fmt::format("{:%d.%m.%Y}", Date::create(2024, 3, 1)) ==
+            "01.03.2024");
+    CHECK(fmt::format("{}", ClockTime::create(13, 5)) ==
+            "13:05:00.000000000");
+    CHECK(fmt::format("{:%R}", ClockTime::create(13, 5)) == "13:05");
+    CHECK(fmt::format("{}", t) == "2009-02-13T23:31:30.000000005Z");
+    CHECK(fmt::format("[{:%FT%T}]", t) == "[2009-02-13T23:31:30]");
+
+    CHECK(fmt::format("{}", TimeDelta::from_milliseconds(5400500)) ==
+            "PT5400.5S");
+    CHECK(fmt::format("{}", TimeDelta::from_nanoseconds(-1)) ==
+            "-PT0.000000001S");
+    CHECK(fmt::format("{}", DayDelta::from_days(-3)) == "-P3D");
+    CHECK(fmt::format("{}", MonthDelta::from_years(1)) == "P12M");
+
+    CHECK_THROWS_AS(fmt::format(fmt::runtime("{:%H}"),
+                Date::create(2024, 3, 1)), const fmt::format_error &);
+    CHECK_THROWS_AS(fmt::format(fmt::runtime("{:%F}"), DayDelta::zero()),
+            const fmt::format_error &);
+}
+
+#endif
+
+#ifdef __cpp_lib_format
+
+TEST_CASE("std::format formatters", "[format]") {
+    CHECK(std::format("{}", Date::create(2024, 3, 1)) == "2024-03-01");
+    CHECK(std::format("{:%FT%T}", Timestamp::create((time_t)1234567890)) ==
+            "2009-02-13T23:31:30");
+    CHECK(std::format("{}", TimeDelta::from_milliseconds(5400500)) ==
+            "PT5400.5S");
+}
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the Instant and Stopwatch C++ classes and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#if __cplusplus >= 201103L
+# include <type_traits>
+#endif
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+#include "utils/time-utils.h"
+
+/** Spin until a monotonic clock has moved on from an Instant. */
+static void
+wait_for_clock(const Instant & instant)
+{
+    while (Instant::now(instant.clock()) == instant) {}
+}
+
+TEST_CASE("Instant readings", "[instant]") {
+    const int clocks[] = {
+        PRESENT_INSTANT_MONOTONIC,
+        PRESENT_INSTANT_MONOTONIC_RAW,
+        PRESENT_INSTANT_BOOTTIME,
+        PRESENT_INSTANT_TSC
+    };
+
+    for (int i = 0; i < 4; ++i) {
+        Instant previous = Instant::now(clocks[i]);
+        CHECK(previous.clock() == clocks[i]);
+        for (int j = 0; j < 1000; ++j) {
+            const Instant now = Instant::now(clocks[i]);
+            CHECK(now >= previous);
+            CHECK(now - previous >= TimeDelta::zero());
+            previous = now;
+        }
+    }
+    CHECK(Instant::now().clock() == PRESENT_INSTANT_MONOTONIC);
+
+    // The TSC (or CLOCK_MONOTONIC, where it cannot be used) runs at the same
+    // rate as CLOCK_MONOTONIC, to within a few parts per million
+    const Instant tsc_start = Instant::now(PRESENT_INSTANT_TSC);
+    const Instant monotonic_start = Instant::now();
+    while (monotonic_start.elapsed() < TimeDelta::from_milliseconds(20)) {}
+    const TimeDelta tsc_elapsed = tsc_start.elapsed();
+    const TimeDelta monotonic_elapsed = monotonic_start.elapsed();
+    CHECK(tsc_elapsed - monotonic_elapsed <= TimeDelta::from_milliseconds(1));
+    CHECK(monotonic_elapsed - tsc_elapsed <= TimeDelta::from_milliseconds(1));
+
+    // The test time only changes the system time
+    struct PresentNowStruct test_now = {
+        (time_t) 920180081,
+        (long)   986000000
+    };
+    present_set_test_time(test_now);
+    const Instant start = Instant::now();
+    wait_for_clock(start);
+    CHECK(Timestamp_now() == Timestamp::create(920180081) +
+            TimeDelta::from_milliseconds(986));
+    CHECK(Instant::now() > start);
+    CHECK(start.elapsed() > TimeDelta::zero());
+    present_reset_test_time();
+
+#if __cplusplus >= 201103L
+    CHECK_FALSE((std::is_convertible<Instant, Timestamp>::value));
+    CHECK_FALSE((std::is_convertible<Timestamp, Instant>::value));
+#endif
+}
+
+TEST_CASE("Instant arithmetic", "[instant]") {
+    const Instant a = Instant::now();
+    const TimeDelta step = TimeDelta::from_milliseconds(1500);
+
+    Instant b = a + step;
+    CHECK(b - a == step);
+    CHECK(a - b == -step);
+    CHECK(b > a);
+    CHECK(a < b);
+    CHECK(a <= b);
+    CHECK(b >= a);
+    CHECK(a != b);
+    CHECK(Instant::compare(a, b) < 0);
+    CHECK(Instant::compare(b, a) > 0);
+    CHECK(Instant::compare(a, a) == 0);
+
+    b -= step;
+    CHECK(b == a);
+    CHECK(step + a == a + step);
+
+    // Nanoseconds carry into and borrow from the seconds
+    for (int i = 0; i < 2000; ++i) {
+        b += TimeDelta::from_microseconds(999999);
+    }
+    CHECK(b - a == TimeDelta::from_microseconds(1999998000));
+    b = b - TimeDelta::from_nanoseconds((int_delta)1999998 * 1000000 + 1);
+    CHECK(b - a == TimeDelta::from_nanoseconds(-1));
+    CHECK(b.nanoseconds_ >= 0);
+    CHECK(b.nanoseconds_ < 1000000000);
+}
+
+TEST_CASE("Stopwatch", "[instant]") {
+    Stopwatch stopped = Stopwatch::stopped();
+    CHECK_FALSE(stopped.is_running());
+    CHECK(stopped.elapsed() == TimeDelta::zero());
+    CHECK(stopped.lap() == TimeDelta::zero());
+
+    Stopwatch watch = Stopwatch::start();
+    CHECK(watch.is_running());
+    wait_for_clock(watch.start_);
+    const TimeDelta first = watch.elapsed();
+    CHECK(first > TimeDelta::zero());
+    CHECK(watch.elapsed() >= first);
+
+    // Stopping freezes it, and resuming carries on from there
+    const TimeDelta total = watch.stop();
+    CHECK_FALSE(watch.is_running());
+    CHECK(total >= first);
+    CHECK(watch.elapsed() == total);
+    watch.stop();
+    CHECK(watch.elapsed() == total);
+    watch.resume();
+    CHECK(watch.is_running());
+    wait_for_clock(watch.start_);
+    CHECK(watch.elapsed() > total);
+
+    // A lap resets it to zero (but keeps it running)
+    const TimeDelta lap = watch.lap();
+    CHECK(lap > total);
+    CHECK(watch.is_running());
+    const TimeDelta since_lap = watch.stop();
+    CHECK(since_lap >= TimeDelta::zero());
+    CHECK(watch.lap() == since_lap);
+    CHECK(watch.elapsed() == TimeDelta::zero());
+    CHECK_FALSE(watch.is_running());
+
+    watch.restart();
+    CHECK(watch.is_running());
+}
+
+TEST_CASE("Instant C functions", "[instant]") {
+    struct Instant a = Instant_now();
+    struct Instant b = Instant_now_from(PRESENT_INSTANT_BOOTTIME);
+    struct TimeDelta delta = TimeDelta_from_seconds(3);
+    struct TimeDelta difference;
+    struct Stopwatch watch;
+
+    CHECK(Instant_get_clock(&a) == PRESENT_INSTANT_MONOTONIC);
+    CHECK(Instant_get_clock(&b) == PRESENT_INSTANT_BOOTTIME);
+    CHECK_FALSE(TimeDelta_is_negative(&(difference = Instant_elapsed(&b))));
+
+    b = a;
+    Instant_add_TimeDelta(&b, &delta);
+    difference = Instant_difference(&b, &a);
+    CHECK(TimeDelta_equal(&difference, &delta));
+    CHECK(Instant_greater_than(&b, &a));
+    CHECK(Instant_greater_than_or_equal(&b, &a));
+    CHECK(Instant_less_than(&a, &b));
+    CHECK(Instant_less_than_or_equal(&a, &b));
+    Instant_subtract_TimeDelta(&b, &delta);
+    CHECK(Instant_equal(&a, &b));
+
+    watch = Stopwatch_stopped();
+    Stopwatch_resume(&watch);
+    CHECK(Stopwatch_is_running(&watch));
+    Stopwatch_stop(&watch);
+    difference = Stopwatch_elapsed(&watch);
+    CHECK_FALSE(TimeDelta_is_negative(&difference));
+    Stopwatch_restart(&watch);
+    difference = Stopwatch_lap(&watch);
+    CHECK_FALSE(TimeDelta_is_negative(&difference));
+    watch = Stopwatch_start();
+    CHECK(Stopwatch_is_running(&watch));
+}
+
@@ -0,0 +1,257 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the IntervalSet C++ class and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/** The number of half-second cells in the timelines of the tests. */
+static const size_t CELL_COUNT = 200;
+
+/** Get the timestamp at the start of a half-second cell. */
+static Timestamp
+cell_time(long cell)
+{
+    return Timestamp::create((time_t)1000000) +
+        TimeDelta::from_milliseconds(cell * 500);
+}
+
+/** Create the interval from one cell up to (but not including) another. */
+static TimeInterval
+cell_interval(long first, long end)
+{
+    return TimeInterval::create(cell_time(first), cell_time(end));
+}
+
+/**
+ * Create the IntervalSet with one interval for each run of cells that are in
+ * a set (as a vector of bools).
+ */
+static IntervalSet
+from_cells(const std::vector<bool> & cells)
+{
+    std::vector<TimeInterval> intervals;
+    for (size_t i = 0; i < cells.size(); ) {
+        if (!cells[i]) {
+            ++i;
+            continue;
+        }
+        size_t end = i;
+        while (end < cells.size() && cells[end]) {
+            ++end;
+        }
+        intervals.push_back(cell_interval((long)i, (long)end));
+        i = end;
+    }
+    return IntervalSet(intervals.empty() ? NULL : &intervals[0],
+            intervals.size());
+}
+
+/** Check whether none of the cells from first to first + count - 1 are set. */
+static bool
+cells_free(const std::vector<bool> & cells, long first, long count)
+{
+    for (long c = first; c < first + count; ++c) {
+        if (c >= 0 && c < (long)cells.size() && cells[(size_t)c]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Create a random set of (possibly overlapping, touching, or empty)
+ * intervals, and mark their cells.
+ */
+static std::vector<TimeInterval>
+random_intervals(unsigned long & seed, std::vector<bool> & cells)
+{
+    std::vector<TimeInterval> intervals;
+    const size_t count = (seed >> 8) % 12;
+    cells.assign(CELL_COUNT, false);
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const long first = (long)((seed >> 8) % (CELL_COUNT - 20));
+        const long end = first + (long)((seed >> 16) % 20);
+        intervals.push_back(cell_interval(first, end));
+        for (long c = first; c < end; ++c) {
+            cells[(size_t)c] = true;
+        }
+    }
+    return intervals;
+}
+
+TEST_CASE("IntervalSet construction", "[interval-set]") {
+    const TimeInterval intervals[] = {
+        cell_interval(10, 20),
+        cell_interval(0, 5),
+        cell_interval(5, 8),        /* Meets the one before */
+        cell_interval(12, 30),      /* Overlaps one */
+        cell_interval(40, 40),      /* Empty */
+        cell_interval(50, 60),
+    };
+    const IntervalSet set(intervals, 6);
+
+    REQUIRE(set.size() == 3);
+    CHECK(set[0] == cell_interval(0, 8));
+    CHECK(set[1] == cell_interval(10, 30));
+    CHECK(set[2] == cell_interval(50, 60));
+    CHECK(set.total_duration() == TimeDelta::from_seconds(19));
+
+    CHECK(set.contains(cell_time(0)));
+    CHECK(set.contains(cell_time(7)));
+    CHECK_FALSE(set.contains(cell_time(8)));
+    CHECK_FALSE(set.contains(cell_time(-1)));
+    CHECK(set.contains(cell_time(60) - TimeDelta::from_nanoseconds(1)));
+    CHECK_FALSE(set.contains(cell_time(60)));
+
+    /* Adding the same intervals one at a time gives the same set */
+    IntervalSet added;
+    for (size_t i = 0; i < 6; ++i) {
+        added.add(intervals[i]);
+    }
+    CHECK(added == set);
+    added.add(cell_interval(8, 10));
+    CHECK(added.size() == 2);
+    CHECK(added[0] == cell_interval(0, 30));
+    added.add(cell_interval(-10, 100));
+    CHECK(added.size() == 1);
+    CHECK(added[0] == cell_interval(-10, 100));
+
+    added.clear();
+    CHECK(added.empty());
+    CHECK(added.total_duration() == TimeDelta::zero());
+    CHECK_FALSE(added.contains(cell_time(0)));
+}
+
+TEST_CASE("IntervalSet operations", "[interval-set]") {
+    unsigned long seed = 5;
+
+    for (int round = 0; round < 300; ++round) {
+        seed = seed * 1103515245 + 12345;
+        std::vector<bool> lhs_cells, rhs_cells;
+        const std::vector<TimeInterval> lhs_intervals =
+            random_intervals(seed, lhs_cells);
+        seed = seed * 1103515245 + 12345;
+        const std::vector<TimeInterval> rhs_intervals =
+            random_intervals(seed, rhs_cells);
+
+        IntervalSet lhs, rhs;
+        for (size_t i = 0; i < lhs_intervals.size(); ++i) {
+            lhs.add(lhs_intervals[i]);
+        }
+        for (size_t i = 0; i < rhs_intervals.size(); ++i) {
+            rhs.add(rhs_intervals[i]);
+        }
+        REQUIRE(lhs == from_cells(lhs_cells));
+        REQUIRE(rhs == from_cells(rhs_cells));
+
+        std::vector<bool> union_cells(CELL_COUNT), intersection_cells(
+                CELL_COUNT), difference_cells(CELL_COUNT);
+        long covered = 0;
+        for (size_t c = 0; c < CELL_COUNT; ++c) {
+            union_cells[c] = lhs_cells[c] || rhs_cells[c];
+            intersection_cells[c] = lhs_cells[c] && rhs_cells[c];
+            difference_cells[c] = lhs_cells[c] && !rhs_cells[c];
+            covered += lhs_cells[c];
+            REQUIRE(lhs.contains(cell_time((long)c)) == lhs_cells[c]);
+        }
+        REQUIRE((lhs | rhs) == from_cells(union_cells));
+        REQUIRE((lhs & rhs) == from_cells(intersection_cells));
+        REQUIRE((lhs - rhs) == from_cells(difference_cells));
+        REQUIRE(lhs.total_duration() ==
+                TimeDelta::from_milliseconds(covered * 500));
+
+        /* The in-place operations give the same results */
+        IntervalSet result(lhs);
+        result -= rhs;
+        REQUIRE(result == from_cells(difference_cells));
+        result = lhs;
+        result |= rhs;
+        REQUIRE(result == from_cells(union_cells));
+        result &= lhs;
+        REQUIRE(result == lhs);
+
+        /* The first free slot, found by checking each cell */
+        for (long after = -2; after < (long)CELL_COUNT; after += 7) {
+            const long length = (after + 2) % 5;
+            /* A slot of length 0 just has to start outside the set */
+            long slot = after;
+            while (!cells_free(lhs_cells, slot, length > 0 ? length : 1)) {
+                ++slot;
+            }
+            REQUIRE(lhs.find_free_slot(cell_time(after),
+                        TimeDelta::from_milliseconds(length * 500)) ==
+                    cell_time(slot));
+        }
+    }
+}
+
+TEST_CASE("IntervalSet free slots", "[interval-set]") {
+    const TimeInterval busy[] = {
+        cell_interval(0, 10),
+        cell_interval(12, 20),
+        cell_interval(25, 30),
+    };
+    const IntervalSet set(busy, 3);
+    const TimeDelta one_second = TimeDelta::from_seconds(1);
+
+    /* In a gap that is long enough */
+    CHECK(set.find_free_slot(cell_time(-5), one_second) == cell_time(-5));
+    /* In an interval, so the slot starts at its end */
+    CHECK(set.find_free_slot(cell_time(3), one_second) == cell_time(10));
+    /* The gaps from 10 to 12 and from 20 to 25 are long enough for 1s and
+       2.5s */
+    CHECK(set.find_free_slot(cell_time(10), one_second) == cell_time(10));
+    CHECK(set.find_free_slot(cell_time(11), one_second) == cell_time(20));
+    CHECK(set.find_free_slot(cell_time(0),
+                TimeDelta::from_milliseconds(2500)) == cell_time(20));
+    /* After the last interval, everything is free */
+    CHECK(set.find_free_slot(cell_time(0),
+                TimeDelta::from_hours(1)) == cell_time(30));
+    CHECK(IntervalSet().find_free_slot(cell_time(3), one_second) ==
+            cell_time(3));
+}
+
+TEST_CASE("IntervalSet C functions", "[interval-set]") {
+    struct IntervalSet working_hours, meetings, free_time;
+    struct TimeInterval interval;
+
+    IntervalSet_init(&working_hours);
+    IntervalSet_init(&meetings);
+    IntervalSet_init(&free_time);
+
+    interval = cell_interval(0, 100);
+    REQUIRE(IntervalSet_add(&working_hours, &interval));
+    interval = cell_interval(20, 30);
+    REQUIRE(IntervalSet_add(&meetings, &interval));
+    interval = cell_interval(90, 120);
+    REQUIRE(IntervalSet_add(&meetings, &interval));
+
+    REQUIRE(IntervalSet_difference(&free_time, &working_hours, &meetings));
+    CHECK(IntervalSet_count(&free_time) == 2);
+    CHECK(IntervalSet_get(&free_time, 0) == cell_interval(0, 20));
+    CHECK(IntervalSet_get(&free_time, 1) == cell_interval(30, 90));
+
+    /* The result may be one of the operands */
+    REQUIRE(IntervalSet_intersection(&meetings, &meetings, &working_hours));
+    CHECK(IntervalSet_count(&meetings) == 2);
+    CHECK(IntervalSet_get(&meetings, 1) == cell_interval(90, 100));
+    REQUIRE(IntervalSet_union(&free_time, &free_time, &meetings));
+    CHECK(IntervalSet_equal(&free_time, &working_hours));
+
+    IntervalSet_destroy(&working_hours);
+    IntervalSet_destroy(&meetings);
+    IntervalSet_destroy(&free_time);
+}
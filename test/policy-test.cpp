@@ -0,0 +1,146 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the policy-templated BasicDate, BasicClockTime, and
+ * BasicTimestamp C++ classes
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+typedef BasicDate<present_policy::Flags> FlagsDate;
+typedef BasicDate<present_policy::Throwing> ThrowingDate;
+typedef BasicDate<present_policy::Unchecked> UncheckedDate;
+
+typedef BasicClockTime<present_policy::Flags> FlagsClockTime;
+typedef BasicClockTime<present_policy::Throwing> ThrowingClockTime;
+typedef BasicClockTime<present_policy::Unchecked> UncheckedClockTime;
+
+typedef BasicTimestamp<present_policy::Throwing> ThrowingTimestamp;
+typedef BasicTimestamp<present_policy::Unchecked> UncheckedTimestamp;
+
+#if __cplusplus >= 201402L
+
+static_assert(UncheckedDate::create(2024, 3, 1).day_of_week() ==
+        DAY_OF_WEEK_FRIDAY,
+        "BasicDate<Unchecked>::create should be constexpr");
+static_assert(ThrowingDate::create(2024, 1, 31) + MonthDelta::from_months(1)
+        == ThrowingDate::create(2024, 3, 2),
+        "BasicDate<Throwing> arithmetic should be constexpr");
+static_assert(UncheckedClockTime::create(13, 45, 30).minute() == 45,
+        "BasicClockTime<Unchecked>::create should be constexpr");
+static_assert(UncheckedTimestamp::create_utc(
+            UncheckedDate::create(1970, 1, 2),
+            UncheckedClockTime::midnight()).get_time_t() == 86400,
+        "BasicTimestamp<Unchecked>::create_utc should be constexpr");
+
+#endif
+
+TEST_CASE("Policy-templated classes have no error state unless needed",
+          "[policy]") {
+    CHECK(sizeof(FlagsDate) == sizeof(Date));
+    CHECK(sizeof(ThrowingDate) == sizeof(PresentDateData));
+    CHECK(sizeof(UncheckedDate) == sizeof(PresentDateData));
+
+    CHECK(sizeof(FlagsClockTime) == sizeof(ClockTime));
+    CHECK(sizeof(ThrowingClockTime) == sizeof(PresentClockTimeData));
+    CHECK(sizeof(UncheckedClockTime) == sizeof(PresentClockTimeData));
+
+    CHECK(sizeof(ThrowingTimestamp) == sizeof(PresentTimestampData));
+    CHECK(sizeof(UncheckedTimestamp) == sizeof(PresentTimestampData));
+}
+
+TEST_CASE("BasicDate with the Flags policy", "[policy] [date]") {
+    FlagsDate d = FlagsDate::create(2016, 2, 29);
+    REQUIRE_FALSE(d.has_error());
+    CHECK(d.day_of_week() == DAY_OF_WEEK_MONDAY);
+    CHECK(Date(d) == Date::create(2016, 2, 29));
+
+    d = FlagsDate::create(2015, 2, 29);
+    CHECK(d.has_error());
+    CHECK(Date(d).errors.day_out_of_range);
+}
+
+TEST_CASE("BasicDate with the Throwing policy", "[policy] [date]") {
+    ThrowingDate d = ThrowingDate::create(2016, 2, 29);
+    CHECK_FALSE(d.has_error());
+    CHECK(d.year() == 2016);
+    CHECK(d.month() == 2);
+    CHECK(d.day() == 29);
+    CHECK(d.day_of_year() == 60);
+
+    CHECK_THROWS_AS(ThrowingDate::create(2015, 2, 29), const PresentError &);
+    CHECK_THROWS_AS(ThrowingDate::create(2015, 13), const PresentError &);
+    CHECK_THROWS_AS(ThrowingDate::from(Date::create(2015, 0)),
+            const PresentError &);
+
+    d += MonthDelta::from_years(1);
+    CHECK(d == ThrowingDate::create(2017, 3, 1));
+    CHECK(d - DayDelta::from_days(1) == ThrowingDate::create(2017, 2, 28));
+    CHECK(d.difference(ThrowingDate::create(2017, 1, 1)) ==
+            DayDelta::from_days(59));
+    CHECK(ThrowingDate::create(2017) < d);
+}
+
+TEST_CASE("BasicDate with the Unchecked policy", "[policy] [date]") {
+    UncheckedDate d = UncheckedDate::create(2016, 12, 31);
+    CHECK_FALSE(d.has_error());
+    CHECK(d.day_of_year() == 366);
+    CHECK(d.day_of_week() == DAY_OF_WEEK_SATURDAY);
+    CHECK(d.week_of_year().week == 52);
+
+    d += DayDelta::from_days(1);
+    CHECK(d == UncheckedDate::create(2017));
+    CHECK(d >= UncheckedDate::create(2016, 12, 31));
+}
+
+TEST_CASE("BasicClockTime with each policy", "[policy] [clock-time]") {
+    FlagsClockTime f = FlagsClockTime::create(24, 60);
+    CHECK(f.has_error());
+    CHECK(ClockTime(f).errors.minute_out_of_range);
+
+    CHECK_THROWS_AS(ThrowingClockTime::create(25), const PresentError &);
+    CHECK_THROWS_AS(ThrowingClockTime::create(1, 2, 3, -1),
+            const PresentError &);
+
+    ThrowingClockTime t = ThrowingClockTime::create(23, 30);
+    t += TimeDelta::from_hours(1);
+    CHECK(t.hour() == 0);
+    CHECK(t.minute() == 30);
+
+    UncheckedClockTime u = UncheckedClockTime::create(12, 34, 56, 789);
+    CHECK(u.hour() == 12);
+    CHECK(u.minute() == 34);
+    CHECK(u.second() == 56);
+    CHECK(u.nanosecond() == 789);
+    CHECK(u > UncheckedClockTime::noon());
+    CHECK(u - TimeDelta::from_hours(12) < UncheckedClockTime::create(1));
+}
+
+TEST_CASE("BasicTimestamp with each policy", "[policy] [timestamp]") {
+    ThrowingTimestamp t = ThrowingTimestamp::create_utc(
+            ThrowingDate::create(1970, 1, 2),
+            ThrowingClockTime::create(1, 0));
+    CHECK(t.get_time_t() == 90000);
+    CHECK(t.get_date_utc() == ThrowingDate::create(1970, 1, 2));
+    CHECK(t.get_clock_time_utc() == ThrowingClockTime::create(1, 0));
+
+    UncheckedTimestamp u = UncheckedTimestamp::create(
+            UncheckedDate::create(2000, 1, 1),
+            UncheckedClockTime::midnight(),
+            TimeDelta::from_hours(2));
+    CHECK(u == UncheckedTimestamp::create(Timestamp::create(
+                    Date::create(1999, 12, 31),
+                    ClockTime::create(22),
+                    TimeDelta::zero()).get_time_t()));
+    u += MonthDelta::from_months(1);
+    CHECK(u.get_date(TimeDelta::from_hours(2)) ==
+            UncheckedDate::create(2000, 2, 1));
+    CHECK(u.difference(UncheckedTimestamp::epoch()) ==
+            TimeDelta::from_seconds(949356000));
+}
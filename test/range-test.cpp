@@ -0,0 +1,215 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the DateRange and TimestampRange C++ classes and C-compatible
+ * methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/**
+ * Check that every way of getting the Dates of a DateRange (iterating, the
+ * C iterator, indexing, and materializing) gives the expected Dates, along
+ * with the right day of the year and day of the week.
+ */
+static void
+check_date_range(const DateRange & range, const std::vector<Date> & expected)
+{
+    REQUIRE(range.size() == expected.size());
+    CHECK(range.empty() == expected.empty());
+
+    size_t i = 0;
+    for (DateRangeIterator it = range.begin(); it != range.end(); ++it) {
+        REQUIRE(i < expected.size());
+        REQUIRE(*it == expected[i]);
+        REQUIRE(it->day_of_year() == expected[i].day_of_year());
+        REQUIRE(it->day_of_week() == expected[i].day_of_week());
+        ++i;
+    }
+    CHECK(i == expected.size());
+
+    struct DateRangeIterator c_it;
+    i = 0;
+    for (DateRange_begin(&range, &c_it); !DateRangeIterator_done(&c_it);
+            DateRangeIterator_next(&c_it)) {
+        REQUIRE(DateRangeIterator_get(&c_it) == expected[i]);
+        ++i;
+    }
+    CHECK(i == expected.size());
+
+    std::vector<Date> materialized(expected.size() + 1);
+    REQUIRE(range.materialize(&materialized[0], materialized.size()) ==
+            expected.size());
+    for (i = 0; i < expected.size(); ++i) {
+        REQUIRE(materialized[i] == expected[i]);
+        REQUIRE(materialized[i].day_of_year() == expected[i].day_of_year());
+        REQUIRE(materialized[i].day_of_week() == expected[i].day_of_week());
+        REQUIRE(range[i] == expected[i]);
+    }
+    if (!expected.empty()) {
+        /* Only as many Dates as fit are written */
+        CHECK(range.materialize(&materialized[0], 1) == expected.size());
+        CHECK(range.materialize(NULL, 0) == expected.size());
+    }
+}
+
+TEST_CASE("DateRange with day steps", "[range]") {
+    const Date first = Date::create(1999, 12, 20);
+    const int steps[] = {1, 2, 6, 7, 13, 28, 29, 31, 45, 400,
+                         -1, -7, -28, -30, -100};
+
+    for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); ++s) {
+        for (int length = -800; length <= 800; length += 229) {
+            const Date end = first + DayDelta::from_days(length);
+            std::vector<Date> expected;
+            for (Date date = first;
+                    steps[s] > 0 ? date < end : date > end;
+                    date += DayDelta::from_days(steps[s])) {
+                expected.push_back(date);
+            }
+            check_date_range(DateRange::create(first, end,
+                        DayDelta::from_days(steps[s])), expected);
+        }
+    }
+
+    /* A leap day, and the end of a year */
+    std::vector<Date> expected;
+    expected.push_back(Date::create(2024, 2, 28));
+    expected.push_back(Date::create(2024, 2, 29));
+    expected.push_back(Date::create(2024, 3, 1));
+    check_date_range(DateRange::create(Date::create(2024, 2, 28),
+                Date::create(2024, 3, 2), DayDelta::from_days(1)), expected);
+    expected.clear();
+    expected.push_back(Date::create(1970, 1, 3));
+    expected.push_back(Date::create(1969, 12, 27));
+    check_date_range(DateRange::create(Date::create(1970, 1, 3),
+                Date::create(1969, 12, 26), DayDelta::from_weeks(-1)),
+            expected);
+}
+
+TEST_CASE("DateRange with month steps", "[range]") {
+    const int first_days[] = {1, 15, 28, 29, 30, 31};
+    const int steps[] = {1, 2, 3, 12, -1, -5};
+
+    for (size_t d = 0; d < sizeof(first_days) / sizeof(first_days[0]); ++d) {
+        const Date first = Date::create(2023, 1, first_days[d]);
+        for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); ++s) {
+            for (int length = -40; length <= 40; length += 7) {
+                const Date end = first + DayDelta::from_days(length * 17);
+                /* Date i is the first Date plus i steps */
+                std::vector<Date> expected;
+                for (int i = 0; ; ++i) {
+                    const Date date = first +
+                        MonthDelta::from_months(i * steps[s]);
+                    if (steps[s] > 0 ? !(date < end) : !(date > end)) {
+                        break;
+                    }
+                    expected.push_back(date);
+                }
+                check_date_range(DateRange::create(first, end,
+                            MonthDelta::from_months(steps[s])), expected);
+            }
+        }
+    }
+
+    /* Month ends overflow into the next month, like Date + MonthDelta */
+    const DateRange range = DateRange::create(Date::create(2023, 1, 31),
+            Date::create(2023, 6, 1), MonthDelta::from_months(1));
+    REQUIRE(range.size() == 5);
+    CHECK(range[1] == Date::create(2023, 3, 3));
+    CHECK(range[2] == Date::create(2023, 3, 31));
+    CHECK(range[3] == Date::create(2023, 5, 1));
+}
+
+TEST_CASE("TimestampRange", "[range]") {
+    const Timestamp first = Timestamp::create((time_t)1000000) +
+        TimeDelta::from_milliseconds(250);
+    const long step_milliseconds[] = {17, 333, 999, 1000, 1001, 2500, 86400000,
+                                      -23, -750, -1000, -3001};
+
+    for (size_t s = 0;
+            s < sizeof(step_milliseconds) / sizeof(step_milliseconds[0]);
+            ++s) {
+        const TimeDelta step =
+            TimeDelta::from_milliseconds(step_milliseconds[s]);
+        for (long length = -9000; length <= 9000; length += 1250) {
+            const Timestamp end = first +
+                TimeDelta::from_milliseconds(length * 7);
+            std::vector<Timestamp> expected;
+            for (Timestamp t = first;
+                    step_milliseconds[s] > 0 ? t < end : t > end;
+                    t += step) {
+                expected.push_back(t);
+            }
+
+            const TimestampRange range =
+                TimestampRange::create(first, end, step);
+            REQUIRE(range.size() == expected.size());
+
+            size_t i = 0;
+            for (TimestampRangeIterator it = range.begin();
+                    it != range.end(); it++) {
+                REQUIRE(i < expected.size());
+                REQUIRE(*it == expected[i]);
+                ++i;
+            }
+            CHECK(i == expected.size());
+
+            std::vector<Timestamp> materialized(expected.size() + 1);
+            REQUIRE(range.materialize(&materialized[0],
+                        materialized.size()) == expected.size());
+            for (i = 0; i < expected.size(); ++i) {
+                REQUIRE(materialized[i] == expected[i]);
+                REQUIRE(range[i] == expected[i]);
+            }
+        }
+    }
+
+    /* The end is not included, even when it is exactly on a step */
+    const TimestampRange range = TimestampRange::create(first,
+            first + TimeDelta::from_seconds(3), TimeDelta::from_seconds(1));
+    CHECK(range.size() == 3);
+    CHECK(range[2] == first + TimeDelta::from_seconds(2));
+    CHECK(TimestampRange::create(first, first, TimeDelta::from_seconds(1))
+            .empty());
+}
+
+TEST_CASE("Range C functions", "[range]") {
+    struct Date first = Date_from_year_month_day(2024, 1, 1);
+    struct Date end = Date_from_year_month_day(2024, 2, 1);
+    struct DayDelta week = DayDelta_from_weeks(1);
+    struct DateRange dates = DateRange_from_DayDelta(&first, &end, &week);
+    struct Date mondays[5];
+
+    CHECK(DateRange_size(&dates) == 5);
+    CHECK(DateRange_materialize(&dates, mondays, 5) == 5);
+    CHECK(mondays[4] == Date_from_year_month_day(2024, 1, 29));
+    CHECK(Date_day_of_week(&mondays[4]) == DAY_OF_WEEK_MONDAY);
+
+    struct Timestamp start = Timestamp_from_time_t(0);
+    struct Timestamp stop = Timestamp_from_time_t(10);
+    struct TimeDelta step = TimeDelta_from_milliseconds(1500);
+    struct TimestampRange times =
+        TimestampRange_from_TimeDelta(&start, &stop, &step);
+    struct TimestampRangeIterator it;
+    size_t count = 0;
+
+    for (TimestampRange_begin(&times, &it);
+            !TimestampRangeIterator_done(&it);
+            TimestampRangeIterator_next(&it)) {
+        ++count;
+    }
+    CHECK(count == 7);
+    CHECK(TimestampRange_get(&times, 6) ==
+            Timestamp_from_time_t(9));
+}
@@ -0,0 +1,498 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the Recurrence C++ class and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/** The time zone offset of the recurrences in these tests (UTC-4:00). */
+static const TimeDelta OFFSET = TimeDelta::from_hours(-4);
+
+/** Create a Recurrence that starts at 09:00 on a date. */
+static Recurrence
+create_recurrence(const Date & start, const char * rule)
+{
+    return Recurrence::create(start, ClockTime::create(9, 0, 0), OFFSET, rule);
+}
+
+/**
+ * Get the dates of the occurrences of a Recurrence from its start up to
+ * (but not including) an end date (in batches of a few dates, to exercise
+ * picking up where a batch left off).
+ */
+static std::vector<Date>
+occurrence_dates(const Recurrence & recurrence, const Date & start,
+        const Date & end)
+{
+    RecurrenceIterator it = recurrence.begin(
+            Timestamp::create(start, ClockTime::create(0), OFFSET),
+            Timestamp::create(end, ClockTime::create(0), OFFSET));
+    std::vector<Date> result;
+    Date batch[3];
+    size_t count;
+
+    while ((count = it.next(batch, 3)) > 0) {
+        result.insert(result.end(), batch, batch + count);
+        if (count < 3) {
+            CHECK(it.done());
+        }
+    }
+    CHECK(it.next(batch, 3) == 0);
+    return result;
+}
+
+/**
+ * Check the occurrences of a rule (from the examples in RFC 5545) up to an
+ * end date.
+ */
+static void
+check_rule(const Date & start, const char * rule, const Date & end,
+        const std::vector<Date> & expected)
+{
+    INFO(rule);
+    const Recurrence recurrence = create_recurrence(start, rule);
+    REQUIRE_FALSE(recurrence.has_error);
+    CHECK(occurrence_dates(recurrence, start, end) == expected);
+}
+
+/** Build a list of dates in one month. */
+static void
+add_days(std::vector<Date> & dates, int year, int month, int first, int last,
+        int step = 1)
+{
+    for (int day = first; day <= last; day += step) {
+        dates.push_back(Date::create(year, month, day));
+    }
+}
+
+TEST_CASE("Recurrence daily and weekly rules", "[recurrence]") {
+    const Date start = Date::create(1997, 9, 2);
+    const Date end = Date::create(2001, 1, 1);
+    std::vector<Date> expected;
+
+    add_days(expected, 1997, 9, 2, 11);
+    check_rule(start, "FREQ=DAILY;COUNT=10", end, expected);
+
+    expected.clear();
+    add_days(expected, 1997, 9, 2, 30, 2);
+    add_days(expected, 1997, 10, 2, 14, 2);
+    check_rule(start, "RRULE:FREQ=DAILY;INTERVAL=2", Date::create(1997, 10, 15),
+            expected);
+
+    expected.clear();
+    add_days(expected, 1997, 9, 2, 22, 10);
+    add_days(expected, 1997, 10, 2, 12, 10);
+    check_rule(start, "FREQ=DAILY;INTERVAL=10;COUNT=5", end, expected);
+
+    expected.clear();
+    for (int year = 1998; year <= 2000; ++year) {
+        add_days(expected, year, 1, 1, 31);
+    }
+    check_rule(Date::create(1998, 1, 1),
+            "FREQ=YEARLY;UNTIL=20000131T140000Z;BYMONTH=1;"
+            "BYDAY=SU,MO,TU,WE,TH,FR,SA", end, expected);
+    check_rule(Date::create(1998, 1, 1),
+            "freq=daily;until=20000131T140000Z;bymonth=1", end, expected);
+
+    expected.clear();
+    add_days(expected, 1997, 9, 2, 30, 7);
+    add_days(expected, 1997, 10, 7, 28, 7);
+    add_days(expected, 1997, 11, 4, 4);
+    check_rule(start, "FREQ=WEEKLY;COUNT=10", end, expected);
+
+    expected.clear();
+    add_days(expected, 1997, 9, 3, 5, 2);
+    add_days(expected, 1997, 9, 15, 19, 2);
+    add_days(expected, 1997, 9, 29, 29);
+    add_days(expected, 1997, 10, 1, 3, 2);
+    add_days(expected, 1997, 10, 13, 17, 2);
+    add_days(expected, 1997, 10, 27, 31, 2);
+    add_days(expected, 1997, 11, 10, 14, 2);
+    add_days(expected, 1997, 11, 24, 28, 2);
+    add_days(expected, 1997, 12, 8, 12, 2);
+    add_days(expected, 1997, 12, 22, 22);
+    check_rule(start,
+            "FREQ=WEEKLY;INTERVAL=2;UNTIL=19971224T000000Z;WKST=SU;"
+            "BYDAY=MO,WE,FR", end, expected);
+
+    /* The first day of the week changes which weeks have occurrences */
+    expected.clear();
+    add_days(expected, 1997, 8, 5, 5);
+    add_days(expected, 1997, 8, 10, 10);
+    add_days(expected, 1997, 8, 19, 19);
+    add_days(expected, 1997, 8, 24, 24);
+    check_rule(Date::create(1997, 8, 5),
+            "FREQ=WEEKLY;INTERVAL=2;COUNT=4;BYDAY=TU,SU;WKST=MO", end,
+            expected);
+    expected.clear();
+    add_days(expected, 1997, 8, 5, 5);
+    add_days(expected, 1997, 8, 17, 19, 2);
+    add_days(expected, 1997, 8, 31, 31);
+    check_rule(Date::create(1997, 8, 5),
+            "FREQ=WEEKLY;INTERVAL=2;COUNT=4;BYDAY=TU,SU;WKST=SU", end,
+            expected);
+
+    /* A week that spans 2 months, with only one of them in BYMONTH */
+    expected.clear();
+    add_days(expected, 2024, 1, 29, 31);
+    add_days(expected, 2025, 1, 27, 31);
+    check_rule(Date::create(2024, 1, 29),
+            "FREQ=WEEKLY;INTERVAL=52;BYMONTH=1;BYDAY=MO,TU,WE,TH,FR",
+            Date::create(2025, 6, 1), expected);
+}
+
+TEST_CASE("Recurrence monthly and yearly rules", "[recurrence]") {
+    const Date end = Date::create(2001, 1, 1);
+    std::vector<Date> expected;
+
+    expected.push_back(Date::create(1997, 9, 5));
+    expected.push_back(Date::create(1997, 10, 3));
+    expected.push_back(Date::create(1997, 11, 7));
+    expected.push_back(Date::create(1997, 12, 5));
+    expected.push_back(Date::create(1998, 1, 2));
+    expected.push_back(Date::create(1998, 2, 6));
+    expected.push_back(Date::create(1998, 3, 6));
+    expected.push_back(Date::create(1998, 4, 3));
+    expected.push_back(Date::create(1998, 5, 1));
+    expected.push_back(Date::create(1998, 6, 5));
+    check_rule(Date::create(1997, 9, 5), "FREQ=MONTHLY;COUNT=10;BYDAY=1FR",
+            end, expected);
+
+    expected.clear();
+    expected.push_back(Date::create(1997, 9, 22));
+    expected.push_back(Date::create(1997, 10, 20));
+    expected.push_back(Date::create(1997, 11, 17));
+    expected.push_back(Date::create(1997, 12, 22));
+    expected.push_back(Date::create(1998, 1, 19));
+    expected.push_back(Date::create(1998, 2, 16));
+    check_rule(Date::create(1997, 9, 22), "FREQ=MONTHLY;COUNT=6;BYDAY=-2MO",
+            end, expected);
+
+    expected.clear();
+    expected.push_back(Date::create(1997, 9, 28));
+    expected.push_back(Date::create(1997, 10, 29));
+    expected.push_back(Date::create(1997, 11, 28));
+    expected.push_back(Date::create(1997, 12, 29));
+    expected.push_back(Date::create(1998, 1, 29));
+    expected.push_back(Date::create(1998, 2, 26));
+    check_rule(Date::create(1997, 9, 28), "FREQ=MONTHLY;BYMONTHDAY=-3",
+            Date::create(1998, 3, 1), expected);
+
+    expected.clear();
+    expected.push_back(Date::create(1997, 9, 30));
+    expected.push_back(Date::create(1997, 10, 1));
+    expected.push_back(Date::create(1997, 10, 31));
+    expected.push_back(Date::create(1997, 11, 1));
+    expected.push_back(Date::create(1997, 11, 30));
+    expected.push_back(Date::create(1997, 12, 1));
+    expected.push_back(Date::create(1997, 12, 31));
+    expected.push_back(Date::create(1998, 1, 1));
+    expected.push_back(Date::create(1998, 1, 31));
+    expected.push_back(Date::create(1998, 2, 1));
+    check_rule(Date::create(1997, 9, 30),
+            "FREQ=MONTHLY;COUNT=10;BYMONTHDAY=1,-1", end, expected);
+
+    expected.clear();
+    add_days(expected, 1997, 9, 10, 15);
+    add_days(expected, 1999, 3, 10, 13);
+    check_rule(Date::create(1997, 9, 10),
+            "FREQ=MONTHLY;INTERVAL=18;COUNT=10;BYMONTHDAY=10,11,12,13,14,15",
+            end, expected);
+
+    /* Every Friday the 13th */
+    expected.clear();
+    expected.push_back(Date::create(1998, 2, 13));
+    expected.push_back(Date::create(1998, 3, 13));
+    expected.push_back(Date::create(1998, 11, 13));
+    expected.push_back(Date::create(1999, 8, 13));
+    expected.push_back(Date::create(2000, 10, 13));
+    check_rule(Date::create(1997, 9, 2), "FREQ=MONTHLY;BYDAY=FR;BYMONTHDAY=13",
+            end, expected);
+
+    /* The first Saturday that follows the first Sunday of the month */
+    expected.clear();
+    expected.push_back(Date::create(1997, 9, 13));
+    expected.push_back(Date::create(1997, 10, 11));
+    expected.push_back(Date::create(1997, 11, 8));
+    expected.push_back(Date::create(1997, 12, 13));
+    expected.push_back(Date::create(1998, 1, 10));
+    expected.push_back(Date::create(1998, 2, 7));
+    check_rule(Date::create(1997, 9, 13),
+            "FREQ=MONTHLY;BYDAY=SA;BYMONTHDAY=7,8,9,10,11,12,13",
+            Date::create(1998, 3, 1), expected);
+
+    /* Days that do not exist in a month are skipped */
+    expected.clear();
+    expected.push_back(Date::create(2007, 1, 15));
+    expected.push_back(Date::create(2007, 1, 30));
+    expected.push_back(Date::create(2007, 2, 15));
+    expected.push_back(Date::create(2007, 3, 15));
+    expected.push_back(Date::create(2007, 3, 30));
+    check_rule(Date::create(2007, 1, 15),
+            "FREQ=MONTHLY;BYMONTHDAY=15,30;COUNT=5", Date::create(2008, 1, 1),
+            expected);
+
+    expected.clear();
+    for (int year = 1997; year <= 2001; ++year) {
+        expected.push_back(Date::create(year, 6, 10));
+        expected.push_back(Date::create(year, 7, 10));
+    }
+    check_rule(Date::create(1997, 6, 10), "FREQ=YEARLY;COUNT=10;BYMONTH=6,7",
+            Date::create(2010, 1, 1), expected);
+
+    expected.clear();
+    expected.push_back(Date::create(1997, 5, 19));
+    expected.push_back(Date::create(1998, 5, 18));
+    expected.push_back(Date::create(1999, 5, 17));
+    check_rule(Date::create(1997, 5, 19), "FREQ=YEARLY;BYDAY=20MO",
+            Date::create(2000, 1, 1), expected);
+
+    expected.clear();
+    add_days(expected, 1997, 3, 13, 27, 7);
+    add_days(expected, 1998, 3, 5, 26, 7);
+    add_days(expected, 1999, 3, 4, 25, 7);
+    check_rule(Date::create(1997, 3, 13), "FREQ=YEARLY;BYMONTH=3;BYDAY=TH",
+            Date::create(2000, 1, 1), expected);
+
+    /* US presidential election day */
+    expected.clear();
+    expected.push_back(Date::create(1996, 11, 5));
+    expected.push_back(Date::create(2000, 11, 7));
+    expected.push_back(Date::create(2004, 11, 2));
+    check_rule(Date::create(1996, 11, 5),
+            "FREQ=YEARLY;INTERVAL=4;BYMONTH=11;BYDAY=TU;"
+            "BYMONTHDAY=2,3,4,5,6,7,8", Date::create(2005, 1, 1), expected);
+
+    /* Leap days */
+    expected.clear();
+    expected.push_back(Date::create(2024, 2, 29));
+    expected.push_back(Date::create(2028, 2, 29));
+    check_rule(Date::create(2024, 2, 29), "FREQ=YEARLY",
+            Date::create(2030, 1, 1), expected);
+}
+
+TEST_CASE("Recurrence BYSETPOS", "[recurrence]") {
+    std::vector<Date> expected;
+
+    expected.push_back(Date::create(1997, 9, 4));
+    expected.push_back(Date::create(1997, 10, 7));
+    expected.push_back(Date::create(1997, 11, 6));
+    check_rule(Date::create(1997, 9, 4),
+            "FREQ=MONTHLY;COUNT=3;BYDAY=TU,WE,TH;BYSETPOS=3",
+            Date::create(2001, 1, 1), expected);
+
+    expected.clear();
+    expected.push_back(Date::create(1997, 9, 29));
+    expected.push_back(Date::create(1997, 10, 30));
+    expected.push_back(Date::create(1997, 11, 27));
+    expected.push_back(Date::create(1997, 12, 30));
+    expected.push_back(Date::create(1998, 1, 29));
+    expected.push_back(Date::create(1998, 2, 26));
+    expected.push_back(Date::create(1998, 3, 30));
+    check_rule(Date::create(1997, 9, 29),
+            "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-2",
+            Date::create(1998, 4, 1), expected);
+
+    /* The first and last weekdays of each year, which reach past the first
+       64 days of the period */
+    expected.clear();
+    expected.push_back(Date::create(2024, 1, 1));
+    expected.push_back(Date::create(2024, 12, 31));
+    expected.push_back(Date::create(2025, 1, 1));
+    expected.push_back(Date::create(2025, 12, 31));
+    expected.push_back(Date::create(2026, 1, 1));
+    expected.push_back(Date::create(2026, 12, 31));
+    check_rule(Date::create(2024, 1, 1),
+            "FREQ=YEARLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=1,-1",
+            Date::create(2027, 1, 1), expected);
+}
+
+TEST_CASE("Recurrence windows", "[recurrence]") {
+    const char * const rules[] = {
+        "FREQ=DAILY;INTERVAL=3",
+        "FREQ=DAILY;COUNT=500;BYDAY=MO,FR",
+        "FREQ=WEEKLY;INTERVAL=2;BYDAY=TU,SA;COUNT=300",
+        "FREQ=MONTHLY;BYMONTHDAY=31,-5;COUNT=250",
+        "FREQ=MONTHLY;INTERVAL=5;BYDAY=-1SU,2WE",
+        "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=1,-1;COUNT=400",
+        "FREQ=YEARLY;BYMONTH=2,8;BYDAY=1MO,-1FR;UNTIL=20700101",
+        "FREQ=YEARLY;BYDAY=1SU,-1SU,26TH;COUNT=90",
+    };
+    const Date start = Date::create(2021, 3, 31);
+    const Date end = Date::create(2060, 1, 1);
+    const ClockTime time = ClockTime::create(9, 30, 15);
+
+    for (size_t r = 0; r < sizeof(rules) / sizeof(rules[0]); ++r) {
+        INFO(rules[r]);
+        Recurrence recurrence = Recurrence::create(start, time, OFFSET,
+                rules[r]);
+        REQUIRE_FALSE(recurrence.has_error);
+        const std::vector<Date> all = occurrence_dates(recurrence, start, end);
+        REQUIRE(all.size() > 50);
+
+        /* Leave out every seventh occurrence */
+        std::vector<Timestamp> exdates;
+        std::vector<Timestamp> kept;
+        for (size_t i = 0; i < all.size(); ++i) {
+            const Timestamp timestamp = Timestamp::create(all[i], time, OFFSET);
+            if (i % 7 == 3) {
+                exdates.push_back(timestamp);
+            } else {
+                kept.push_back(timestamp);
+            }
+        }
+        recurrence.set_exdates(&exdates[0], exdates.size());
+
+        /* Windows that start at, just after, and between occurrences */
+        for (size_t w = 0; w < all.size(); w += all.size() / 9 + 1) {
+            const Timestamp at = Timestamp::create(all[w], time, OFFSET);
+            const Timestamp froms[] = {
+                at, at + TimeDelta::from_nanoseconds(1),
+                at - TimeDelta::from_hours(30)
+            };
+            for (size_t f = 0; f < 3; ++f) {
+                const Timestamp window_end = froms[f] +
+                    TimeDelta::from_days(200);
+                std::vector<Timestamp> expected;
+                for (size_t i = 0; i < kept.size(); ++i) {
+                    if (kept[i] >= froms[f] && kept[i] < window_end) {
+                        expected.push_back(kept[i]);
+                    }
+                }
+
+                std::vector<Timestamp> results(expected.size() + 5);
+                const size_t count = recurrence.expand(froms[f], window_end,
+                        &results[0], results.size());
+                results.resize(count);
+                REQUIRE(results == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Recurrence occurrence times", "[recurrence]") {
+    /* 23:30 at UTC-4:00 is 03:30 UTC on the next day */
+    const Recurrence recurrence = Recurrence::create(Date::create(2024, 3, 1),
+            ClockTime::create(23, 30, 0), OFFSET, "FREQ=MONTHLY;COUNT=3");
+    Timestamp results[4];
+
+    REQUIRE(recurrence.expand(Timestamp::create((time_t)0),
+                Timestamp::create((time_t)2000000000), results, 4) == 3);
+    CHECK(results[0] == Timestamp::create(Date::create(2024, 3, 1),
+                ClockTime::create(23, 30, 0), OFFSET));
+    CHECK(results[2] == Timestamp::create(Date::create(2024, 5, 2),
+                ClockTime::create(3, 30, 0), TimeDelta::zero()));
+
+    /* The window starts right after the first occurrence */
+    CHECK(recurrence.expand(results[0] + TimeDelta::from_nanoseconds(1),
+                Timestamp::create((time_t)2000000000), results, 4) == 2);
+
+    /* An UNTIL in UTC, just before the fourth occurrence */
+    const Recurrence until = Recurrence::create(Date::create(2024, 3, 1),
+            ClockTime::create(23, 30, 0), OFFSET,
+            "FREQ=MONTHLY;UNTIL=20240602T032959Z");
+    CHECK(until.expand(Timestamp::create((time_t)0),
+                Timestamp::create((time_t)2000000000), results, 4) == 3);
+
+    /* Without an end, the iteration only stops when the rule does */
+    RecurrenceIterator it = recurrence.begin(Timestamp::create((time_t)0));
+    CHECK(it.next(results, 2) == 2);
+    CHECK(it.next(results, 2) == 1);
+    CHECK(it.done());
+
+    /* A rule that never has an occurrence */
+    const Recurrence never = create_recurrence(Date::create(2024, 1, 1),
+            "FREQ=MONTHLY;BYMONTH=2;BYMONTHDAY=30");
+    REQUIRE_FALSE(never.has_error);
+    it = never.begin(Timestamp::create((time_t)0));
+    CHECK(it.next(results, 4) == 0);
+    CHECK(it.done());
+}
+
+TEST_CASE("Recurrence errors", "[recurrence]") {
+    const Date start = Date::create(2024, 1, 1);
+    const char * const invalid[] = {
+        "",
+        "COUNT=3",
+        "FREQ=FORTNIGHTLY",
+        "FREQ=DAILY;COUNT=0",
+        "FREQ=DAILY;INTERVAL=-1",
+        "FREQ=DAILY;COUNT=3;UNTIL=20240101",
+        "FREQ=DAILY;FREQ=DAILY",
+        "FREQ=DAILY;UNTIL=20240230",
+        "FREQ=DAILY;UNTIL=20240101T250000Z",
+        "FREQ=DAILY;BYMONTH=13",
+        "FREQ=MONTHLY;BYMONTHDAY=0",
+        "FREQ=MONTHLY;BYMONTHDAY=1,",
+        "FREQ=MONTHLY;BYDAY=6XX",
+        "FREQ=MONTHLY;BYDAY=54MO",
+        "FREQ=WEEKLY;BYDAY=1MO",
+        "FREQ=WEEKLY;BYMONTHDAY=1",
+        "FREQ=MONTHLY;BYSETPOS=1",
+        "FREQ=DAILY;WKST=XX",
+        "FREQ=DAILY;COLOR=RED",
+    };
+    const char * const unsupported[] = {
+        "FREQ=HOURLY",
+        "FREQ=YEARLY;BYYEARDAY=1,100",
+        "FREQ=YEARLY;BYWEEKNO=20",
+        "FREQ=DAILY;BYHOUR=9,17",
+    };
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        INFO(invalid[i]);
+        const Recurrence recurrence = create_recurrence(start, invalid[i]);
+        CHECK(recurrence.has_error);
+        CHECK(recurrence.errors.invalid_rule);
+        CHECK_FALSE(recurrence.errors.unsupported_rule);
+    }
+    for (size_t i = 0; i < sizeof(unsupported) / sizeof(unsupported[0]); ++i) {
+        INFO(unsupported[i]);
+        const Recurrence recurrence = create_recurrence(start, unsupported[i]);
+        CHECK(recurrence.has_error);
+        CHECK(recurrence.errors.unsupported_rule);
+    }
+
+    const Recurrence recurrence = create_recurrence(
+            Date::create(2024, 2, 30), "FREQ=DAILY");
+    CHECK(recurrence.has_error);
+    CHECK(recurrence.errors.invalid_start);
+}
+
+TEST_CASE("Recurrence C functions", "[recurrence]") {
+    struct Date start = Date_from_year_month_day(2024, 1, 1);
+    struct ClockTime time = ClockTime_from_hour(8);
+    struct TimeDelta offset = TimeDelta_zero();
+    struct Recurrence recurrence = Recurrence_from_rule(&start, &time, &offset,
+            "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1;COUNT=12");
+    struct Timestamp from = Timestamp_from_time_t(0);
+    struct RecurrenceIterator it;
+    struct Date dates[12];
+
+    REQUIRE_FALSE(recurrence.has_error);
+    Recurrence_begin(&recurrence, &from, NULL, &it);
+    CHECK(RecurrenceIterator_next_dates(&it, dates, 12) == 12);
+    CHECK(RecurrenceIterator_done(&it));
+    CHECK(dates[0] == Date_from_year_month_day(2024, 1, 31));
+    CHECK(dates[2] == Date_from_year_month_day(2024, 3, 29));
+    CHECK(dates[10] == Date_from_year_month_day(2024, 11, 29));
+
+    struct Timestamp exdate = Timestamp_create(&dates[2], &time, &offset);
+    struct Timestamp timestamps[12];
+    Recurrence_set_exdates(&recurrence, &exdate, 1);
+    CHECK(Recurrence_expand(&recurrence, &from, NULL, timestamps, 12) == 11);
+    CHECK(Timestamp_get_date_utc(&timestamps[2]) ==
+            Date_from_year_month_day(2024, 4, 30));
+}
+
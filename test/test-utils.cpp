@@ -87,7 +87,9 @@ std::ostream & operator<<(std::ostream & os, TimeDelta const & v) {
         os  << v.hours_decimal() << " hours";
     } else if (v.minutes() > 1) {
         os  << v.minutes_decimal() << " minutes";
-    } else if (v.seconds() > 1) {
+    } else if (v.seconds() > 1 || v.seconds() < -1) {
+        /* (negative values are shown in seconds, since they may have too
+           many seconds to convert to milliseconds) */
         os  << v.seconds_decimal() << " seconds";
     } else if (v.milliseconds() > 1) {
         os  << v.milliseconds_decimal() << " ms";
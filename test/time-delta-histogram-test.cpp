@@ -0,0 +1,248 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the TimeDeltaHistogram C++ class and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/**
+ * Check whether a value from a histogram is within the relative error of
+ * its precision from the exact value.
+ */
+static bool
+is_close(const TimeDelta & value, const TimeDelta & exact, int precision)
+{
+    const double v = (double)value.nanoseconds();
+    const double e = (double)exact.nanoseconds();
+    const double tolerance = e / (double)(1L << precision) + 1;
+    return v >= e - tolerance && v <= e + tolerance;
+}
+
+/** Generate latencies from about 1 microsecond to about an hour. */
+static std::vector<TimeDelta>
+make_latencies(size_t count, unsigned long seed)
+{
+    std::vector<TimeDelta> latencies;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const int magnitude = (int)((seed >> 8) % 32) + 10;
+        seed = seed * 1103515245 + 12345;
+        const long mantissa = (long)((seed >> 8) % 1024);
+        latencies.push_back(TimeDelta::from_nanoseconds(
+                    ((long)1 << magnitude) + (mantissa << (magnitude - 10))));
+    }
+    return latencies;
+}
+
+TEST_CASE("TimeDeltaHistogram quantiles", "[time-delta-histogram]") {
+    const int precisions[] = {3, 7, 10};
+    const std::vector<TimeDelta> latencies = make_latencies(20000, 3);
+    std::vector<TimeDelta> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t p = 0; p < sizeof(precisions) / sizeof(precisions[0]); ++p) {
+        TimeDeltaHistogram histogram(TimeDelta::from_hours(2), precisions[p]);
+        CHECK(histogram.precision() == precisions[p]);
+        for (size_t i = 0; i < latencies.size(); ++i) {
+            histogram.record(latencies[i]);
+        }
+
+        CHECK(histogram.count() == latencies.size());
+        CHECK(histogram.min() == sorted.front());
+        CHECK(histogram.max() == sorted.back());
+        CHECK(histogram.value_at_quantile(0) == sorted.front());
+        CHECK(histogram.value_at_quantile(1) == sorted.back());
+
+        const double quantiles[] = {0.01, 0.25, 0.5, 0.9, 0.99, 0.999};
+        for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]);
+                ++q) {
+            const size_t rank =
+                (size_t)(quantiles[q] * (double)sorted.size() + 0.999999);
+            CHECK(is_close(histogram.value_at_quantile(quantiles[q]),
+                        sorted[rank - 1], precisions[p]));
+        }
+
+        double sum = 0;
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            sum += (double)sorted[i].nanoseconds();
+        }
+        CHECK(is_close(histogram.mean(), TimeDelta::from_nanoseconds(
+                        (long)(sum / (double)sorted.size())), precisions[p]));
+    }
+}
+
+TEST_CASE("TimeDeltaHistogram edge cases", "[time-delta-histogram]") {
+    TimeDeltaHistogram histogram(TimeDelta::from_seconds(1), 7);
+
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.min() == TimeDelta::zero());
+    CHECK(histogram.max() == TimeDelta::zero());
+    CHECK(histogram.mean() == TimeDelta::zero());
+    CHECK(histogram.value_at_quantile(0.5) == TimeDelta::zero());
+
+    /* Small values are recorded exactly */
+    for (long ns = 0; ns < 256; ++ns) {
+        histogram.record(TimeDelta::from_nanoseconds(ns));
+    }
+    CHECK(histogram.value_at_quantile(0.5) == TimeDelta::from_nanoseconds(127));
+    CHECK(histogram.mean() == TimeDelta::from_nanoseconds(128));
+
+    /* Negative values are recorded as 0 */
+    histogram.clear();
+    histogram.record(-TimeDelta::from_seconds(5));
+    CHECK(histogram.count() == 1);
+    CHECK(histogram.max() == TimeDelta::zero());
+
+    /* Values above the highest value go in the last bucket, but the max is
+       still exact */
+    histogram.clear();
+    histogram.record(TimeDelta::from_milliseconds(10), 99);
+    histogram.record(TimeDelta::from_days(3));
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.max() == TimeDelta::from_days(3));
+    CHECK(histogram.value_at_quantile(1) == TimeDelta::from_days(3));
+    CHECK(histogram.value_at_quantile(0.995) == TimeDelta::from_days(3));
+    CHECK(is_close(histogram.value_at_quantile(0.99),
+                TimeDelta::from_milliseconds(10), 7));
+
+    /* Recording 0 times does nothing */
+    histogram.record(TimeDelta::from_nanoseconds(1), 0);
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.min() == TimeDelta::from_milliseconds(10));
+
+    /* More buckets for more precision or a higher highest value */
+    CHECK(TimeDeltaHistogram(TimeDelta::from_hours(1), 7).bucket_count() <
+            TimeDeltaHistogram(TimeDelta::from_hours(1), 8).bucket_count());
+    CHECK(TimeDeltaHistogram(TimeDelta::from_hours(1), 7).bucket_count() <
+            TimeDeltaHistogram(TimeDelta::from_hours(2), 7).bucket_count());
+}
+
+TEST_CASE("TimeDeltaHistogram merge and copy", "[time-delta-histogram]") {
+    const std::vector<TimeDelta> latencies = make_latencies(9000, 5);
+    TimeDeltaHistogram all(TimeDelta::from_hours(2), 7);
+    TimeDeltaHistogram parts[3] = {
+        TimeDeltaHistogram(TimeDelta::from_hours(2), 7),
+        TimeDeltaHistogram(TimeDelta::from_hours(2), 7),
+        /* A higher highest value, so it has more buckets */
+        TimeDeltaHistogram(TimeDelta::from_hours(5), 7),
+    };
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        all.record(latencies[i]);
+        parts[i % 3].record(latencies[i]);
+    }
+
+    /* With the same precision, merging is the same as recording everything
+       in one histogram */
+    TimeDeltaHistogram merged(parts[0]);
+    merged.merge(parts[1]);
+    merged.merge(parts[2]);
+    CHECK(merged.count() == all.count());
+    CHECK(merged.min() == all.min());
+    CHECK(merged.max() == all.max());
+    const double quantiles[] = {0.1, 0.5, 0.9};
+    for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); ++q) {
+        CHECK(merged.value_at_quantile(quantiles[q]) ==
+                all.value_at_quantile(quantiles[q]));
+    }
+
+    /* With a different precision, each bucket is recorded at its midpoint */
+    TimeDeltaHistogram coarse(TimeDelta::from_hours(2), 4);
+    coarse.merge(all);
+    CHECK(coarse.count() == all.count());
+    CHECK(coarse.min() == all.min());
+    CHECK(coarse.max() == all.max());
+    CHECK(is_close(coarse.value_at_quantile(0.5),
+                all.value_at_quantile(0.5), 3));
+
+    TimeDeltaHistogram copy;
+    copy = all;
+    CHECK(copy.count() == all.count());
+    CHECK(copy.value_at_quantile(0.5) == all.value_at_quantile(0.5));
+    all.clear();
+    CHECK(all.count() == 0);
+    CHECK(copy.count() == 9000);
+}
+
+TEST_CASE("TimeDeltaHistogram serialization", "[time-delta-histogram]") {
+    const std::vector<TimeDelta> latencies = make_latencies(5000, 9);
+    TimeDeltaHistogram histogram(TimeDelta::from_hours(2), 7);
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        histogram.record(latencies[i]);
+    }
+
+    const size_t size = histogram.serialize(NULL, 0);
+    std::vector<unsigned char> buffer(size + 1);
+    CHECK(histogram.serialize(&buffer[0], buffer.size()) == size);
+    /* Runs of empty buckets take a few bytes each */
+    CHECK(size < histogram.bucket_count() * 2);
+
+    TimeDeltaHistogram read;
+    REQUIRE(read.deserialize(&buffer[0], size));
+    CHECK(read.precision() == histogram.precision());
+    CHECK(read.bucket_count() == histogram.bucket_count());
+    CHECK(read.count() == histogram.count());
+    CHECK(read.min() == histogram.min());
+    CHECK(read.max() == histogram.max());
+    CHECK(read.value_at_quantile(0.99) == histogram.value_at_quantile(0.99));
+
+    /* An empty histogram */
+    TimeDeltaHistogram empty(TimeDelta::from_seconds(10), 3);
+    const size_t empty_size = empty.serialize(&buffer[0], buffer.size());
+    REQUIRE(read.deserialize(&buffer[0], empty_size));
+    CHECK(read.count() == 0);
+    CHECK(read.precision() == 3);
+
+    /* Binary forms that are cut short, too long, or from another version
+       are rejected (and leave the histogram unchanged) */
+    histogram.serialize(&buffer[0], buffer.size());
+    CHECK_FALSE(read.deserialize(&buffer[0], size - 1));
+    CHECK_FALSE(read.deserialize(&buffer[0], 1));
+    buffer[size] = 1;
+    CHECK_FALSE(read.deserialize(&buffer[0], size + 1));
+    buffer[0] = 99;
+    CHECK_FALSE(read.deserialize(&buffer[0], size));
+    CHECK(read.count() == 0);
+    CHECK(read.precision() == 3);
+}
+
+TEST_CASE("TimeDeltaHistogram C functions", "[time-delta-histogram]") {
+    struct TimeDeltaHistogram histogram, copy;
+    struct TimeDelta highest = TimeDelta_from_seconds(60);
+    struct TimeDelta value;
+    int i;
+
+    TimeDeltaHistogram_init(&histogram);
+    TimeDeltaHistogram_init(&copy);
+    CHECK(histogram.bucket_count_ == 0);
+
+    REQUIRE(TimeDeltaHistogram_configure(&histogram, &highest, 7));
+    for (i = 1; i <= 100; ++i) {
+        value = TimeDelta_from_milliseconds(i);
+        TimeDeltaHistogram_record(&histogram, &value);
+    }
+    CHECK(TimeDeltaHistogram_count(&histogram) == 100);
+    value = TimeDeltaHistogram_value_at_quantile(&histogram, 0.5);
+    CHECK(is_close(value, TimeDelta_from_milliseconds(50), 7));
+
+    REQUIRE(TimeDeltaHistogram_assign(&copy, &histogram));
+    TimeDeltaHistogram_merge(&copy, &histogram);
+    CHECK(TimeDeltaHistogram_count(&copy) == 200);
+    value = TimeDeltaHistogram_max(&copy);
+    CHECK(value == TimeDelta_from_milliseconds(100));
+
+    TimeDeltaHistogram_destroy(&histogram);
+    TimeDeltaHistogram_destroy(&copy);
+    CHECK(histogram.counts_ == NULL);
+}
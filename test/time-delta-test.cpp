@@ -7,8 +7,156 @@
  * For details, see LICENSE.
  */
 
+#include <math.h>
+#include <stddef.h>
+
+#include <vector>
+
 #include "catch.hpp"
 #include "test-utils.hpp"
 
 #include "present.h"
 
+
+TEST_CASE("TimeDelta summaries", "[time-delta]") {
+    TimeDeltaSummary summary = TimeDelta::summarize(NULL, 0);
+    CHECK(summary.count == 0);
+    CHECK(summary.sum == TimeDelta::zero());
+    CHECK(summary.mean == TimeDelta::zero());
+    CHECK(summary.variance == 0);
+
+    const TimeDelta values[] = {
+        TimeDelta::from_milliseconds(1500),
+        TimeDelta::from_milliseconds(-500),
+        TimeDelta::from_seconds(2),
+        TimeDelta::from_milliseconds(3250),
+        TimeDelta::from_nanoseconds(-1),
+    };
+    summary = TimeDelta::summarize(values, 5);
+    CHECK(summary.count == 5);
+    CHECK(summary.sum == TimeDelta::from_nanoseconds(6249999999L));
+    /* The mean is rounded down */
+    CHECK(summary.mean == TimeDelta::from_nanoseconds(1250000000L - 1));
+    CHECK(summary.min == TimeDelta::from_milliseconds(-500));
+    CHECK(summary.max == TimeDelta::from_milliseconds(3250));
+    CHECK(summary.variance == Approx(1.85e18));
+    CHECK(summary.standard_deviation.nanoseconds() ==
+            Approx(1360147051.0).epsilon(1e-9));
+
+    /* Negative values with the same seconds are ordered by nanoseconds */
+    const TimeDelta negatives[] = {
+        TimeDelta::from_milliseconds(-1200),
+        TimeDelta::from_milliseconds(-1700),
+        TimeDelta::from_milliseconds(-1300),
+    };
+    summary = TimeDelta::summarize(negatives, 3);
+    CHECK(summary.min == TimeDelta::from_milliseconds(-1700));
+    CHECK(summary.max == TimeDelta::from_milliseconds(-1200));
+    CHECK(summary.mean == TimeDelta::from_milliseconds(-1400));
+}
+
+TEST_CASE("TimeDelta summaries match for TimeDeltas and nanoseconds",
+        "[time-delta]") {
+    std::vector<int_delta> nanoseconds;
+    std::vector<TimeDelta> deltas;
+    unsigned long seed = 17;
+
+    for (size_t i = 0; i < 1003; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const int_delta value = (int_delta)((seed >> 8) % 2000000000000L) -
+            1000000000000L;
+        nanoseconds.push_back(value);
+        deltas.push_back(TimeDelta::from_nanoseconds(value));
+    }
+
+    int_delta sum = 0, min = nanoseconds[0], max = nanoseconds[0];
+    for (size_t i = 0; i < nanoseconds.size(); ++i) {
+        sum += nanoseconds[i];
+        min = nanoseconds[i] < min ? nanoseconds[i] : min;
+        max = nanoseconds[i] > max ? nanoseconds[i] : max;
+    }
+    int_delta mean = sum / (int_delta)nanoseconds.size();
+    if (mean * (int_delta)nanoseconds.size() > sum) {
+        --mean;
+    }
+    double sum_of_squares = 0;
+    for (size_t i = 0; i < nanoseconds.size(); ++i) {
+        const double difference = (double)(nanoseconds[i] - mean);
+        sum_of_squares += difference * difference;
+    }
+
+    const TimeDeltaSummary from_nanoseconds = TimeDelta::summarize_nanoseconds(
+            &nanoseconds[0], nanoseconds.size());
+    const TimeDeltaSummary from_deltas = TimeDelta::summarize(
+            &deltas[0], deltas.size());
+    const TimeDeltaSummary * const summaries[] = {
+        &from_nanoseconds,
+        &from_deltas,
+    };
+    for (size_t s = 0; s < 2; ++s) {
+        CHECK(summaries[s]->count == nanoseconds.size());
+        CHECK(summaries[s]->sum == TimeDelta::from_nanoseconds(sum));
+        CHECK(summaries[s]->mean == TimeDelta::from_nanoseconds(mean));
+        CHECK(summaries[s]->min == TimeDelta::from_nanoseconds(min));
+        CHECK(summaries[s]->max == TimeDelta::from_nanoseconds(max));
+        CHECK(summaries[s]->variance ==
+                Approx(sum_of_squares / (double)nanoseconds.size()));
+    }
+}
+
+TEST_CASE("TimeDelta summaries are exact beyond 64 bits", "[time-delta]") {
+    const int_delta max = (int_delta)(((present_uint64)1 << 63) - 1);
+
+    /* The running total of these nanoseconds overflows 64 bits (twice) */
+    const int_delta nanoseconds[] = {max, max, -max, -1, -2};
+    TimeDeltaSummary summary = TimeDelta::summarize_nanoseconds(nanoseconds, 5);
+    CHECK(summary.sum == TimeDelta::from_nanoseconds(max - 3));
+    /* (2^63 - 4) / 5, rounded down */
+    CHECK(summary.mean == TimeDelta::from_nanoseconds(1844674407370955160L));
+    CHECK(summary.min == TimeDelta::from_nanoseconds(-max));
+    CHECK(summary.max == TimeDelta::from_nanoseconds(max));
+    double sum_of_squares = 0;
+    for (size_t i = 0; i < 5; ++i) {
+        const double difference =
+            (double)nanoseconds[i] - 1844674407370955160.0;
+        sum_of_squares += difference * difference;
+    }
+    CHECK(summary.standard_deviation.seconds_decimal() * 1e9 ==
+            Approx(sqrt(sum_of_squares / 5)));
+
+    /* A sum of seconds that overflows 64 bits, and a mean of -1.5ns */
+    const TimeDelta huge = TimeDelta::from_seconds(max / 2 + 1);
+    const TimeDelta deltas[] = {
+        huge, huge, -huge, -huge,
+        TimeDelta::from_nanoseconds(-1),
+        TimeDelta::from_nanoseconds(-2),
+    };
+    summary = TimeDelta::summarize(deltas, 6);
+    CHECK(summary.sum == TimeDelta::from_nanoseconds(-3));
+    CHECK(summary.mean == TimeDelta::from_nanoseconds(-1));
+    CHECK(summary.min == -huge);
+    CHECK(summary.max == huge);
+    /* Far more nanoseconds than fit in 64 bits: sqrt(2/3) * 2^62 seconds */
+    CHECK(summary.standard_deviation.seconds_decimal() ==
+            Approx(sqrt(2.0 / 3.0) * huge.seconds_decimal()));
+
+    const int_delta halves[] = {-1, -2};
+    summary = TimeDelta::summarize_nanoseconds(halves, 2);
+    CHECK(summary.mean == TimeDelta::from_nanoseconds(-2));
+}
+
+TEST_CASE("TimeDelta summaries C functions", "[time-delta]") {
+    struct TimeDelta deltas[3];
+    struct TimeDeltaSummary summary;
+
+    deltas[0] = TimeDelta_from_seconds(1);
+    deltas[1] = TimeDelta_from_seconds(2);
+    deltas[2] = TimeDelta_from_seconds(6);
+    TimeDelta_summarize(deltas, 3, &summary);
+    CHECK(summary.count == 3);
+    CHECK(summary.sum == TimeDelta_from_seconds(9));
+    CHECK(summary.mean == TimeDelta_from_seconds(3));
+    CHECK(summary.variance == Approx(14e18 / 3));
+    CHECK(summary.standard_deviation.seconds_decimal() ==
+            Approx(sqrt(14.0 / 3)));
+}
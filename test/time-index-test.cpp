@@ -0,0 +1,133 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the TimeIndex C++ class and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/**
+ * Create a timestamp from a number of seconds and nanoseconds since the UNIX
+ * epoch.
+ */
+static Timestamp
+make_timestamp(time_t seconds, int_nanosecond nanoseconds)
+{
+    return Timestamp::create(seconds) +
+        TimeDelta::from_nanoseconds(nanoseconds);
+}
+
+TEST_CASE("TimeIndex lookups", "[time-index]") {
+    /* Sizes around the node size and the number of children per node, so
+       that the bottom level and the levels above it are partly filled */
+    const size_t sizes[] = {1, 7, 8, 9, 72, 73, 647, 648, 5833, 20000};
+    unsigned long seed = 7;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        std::vector<Timestamp> timestamps;
+        for (size_t i = 0; i < sizes[s]; ++i) {
+            seed = seed * 1103515245 + 12345;
+            /* Several timestamps share each second, and some are equal */
+            timestamps.push_back(make_timestamp(
+                        (time_t)((seed >> 8) % 2001) - 1000,
+                        (int_nanosecond)((seed >> 4) % 3) * 333333333));
+        }
+        std::sort(timestamps.begin(), timestamps.end());
+
+        const TimeIndex index(&timestamps[0], timestamps.size());
+        REQUIRE(index.size() == timestamps.size());
+
+        for (time_t second = -1002; second <= 1002; ++second) {
+            for (int_nanosecond ns = 0; ns < 1000000000; ns += 333333333) {
+                const Timestamp value = make_timestamp(second, ns);
+                const size_t lower = (size_t)(std::lower_bound(
+                            timestamps.begin(), timestamps.end(), value) -
+                        timestamps.begin());
+                const size_t upper = (size_t)(std::upper_bound(
+                            timestamps.begin(), timestamps.end(), value) -
+                        timestamps.begin());
+                REQUIRE(index.lower_bound(value) == lower);
+                REQUIRE(index.upper_bound(value) == upper);
+            }
+        }
+    }
+}
+
+TEST_CASE("TimeIndex ranges", "[time-index]") {
+    std::vector<Timestamp> timestamps;
+    for (int i = 0; i < 1000; ++i) {
+        timestamps.push_back(make_timestamp((time_t)(i / 4) * 60,
+                    (i % 4) * 250000000));
+    }
+
+    const TimeIndex index(&timestamps[0], timestamps.size());
+    size_t first;
+
+    /* The range includes the low end, but not the high end */
+    CHECK(index.find_range(make_timestamp(60, 0), make_timestamp(120, 0),
+                &first) == 4);
+    CHECK(first == 4);
+    CHECK(index.count_range(make_timestamp(60, 1), make_timestamp(120, 1)) ==
+            4);
+    CHECK(index.count_range(make_timestamp(0, 0),
+                make_timestamp(1000000, 0)) == 1000);
+    CHECK(index.find_range(make_timestamp(-5, 0), make_timestamp(-1, 0),
+                &first) == 0);
+    CHECK(first == 0);
+    CHECK(index.find_range(make_timestamp(100000, 0),
+                make_timestamp(200000, 0), &first) == 0);
+    CHECK(first == 1000);
+
+    /* An empty (or backwards) range */
+    CHECK(index.count_range(make_timestamp(120, 0), make_timestamp(120, 0)) ==
+            0);
+    CHECK(index.count_range(make_timestamp(180, 0), make_timestamp(120, 0)) ==
+            0);
+}
+
+TEST_CASE("TimeIndex from a TimestampColumn", "[time-index] [column]") {
+    TimestampColumn column;
+    for (int i = 0; i < 100000; ++i) {
+        column.push_back(make_timestamp((time_t)(i - 50000) * 3,
+                    i % 1000 * 1000));
+    }
+
+    TimeIndex index(column);
+    REQUIRE(index.size() == column.size());
+    for (size_t i = 0; i < column.size(); i += 997) {
+        CHECK(index.lower_bound(column[i]) == i);
+        CHECK(index.upper_bound(column[i]) == i + 1);
+        CHECK(index.count_range(column[i], column[i] +
+                    TimeDelta::from_seconds(29)) ==
+                std::min((size_t)10, column.size() - i));
+    }
+
+    /* Copies are independent of the original */
+    TimeIndex copy(index);
+    index.build(NULL, 0);
+    CHECK(index.empty());
+    CHECK(index.lower_bound(column[5]) == 0);
+    CHECK(copy.size() == column.size());
+    CHECK(copy.lower_bound(column[5]) == 5);
+
+    index = copy;
+    CHECK(index.lower_bound(column[99999]) == 99999);
+    CHECK(index.upper_bound(Timestamp::create((time_t)1000000)) == 100000);
+
+    /* An empty index */
+    const TimeIndex empty;
+    CHECK(empty.lower_bound(column[0]) == 0);
+    CHECK(empty.count_range(column[0], column[1]) == 0);
+}
+
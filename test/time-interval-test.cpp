@@ -0,0 +1,222 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the TimeInterval and TimeIntervalIndex C++ classes and
+ * C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/**
+ * Create a timestamp from a number of seconds and nanoseconds since the UNIX
+ * epoch.
+ */
+static Timestamp
+make_timestamp(time_t seconds, int_nanosecond nanoseconds)
+{
+    return Timestamp::create(seconds) +
+        TimeDelta::from_nanoseconds(nanoseconds);
+}
+
+/** Order TimeIntervals by their start. */
+static bool
+start_less(const TimeInterval & lhs, const TimeInterval & rhs)
+{
+    return lhs.start < rhs.start;
+}
+
+/** Get the sorted positions that a query found (up to count). */
+static std::vector<size_t>
+sorted_positions(std::vector<size_t> positions, size_t count)
+{
+    positions.resize(std::min(count, positions.size()));
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+TEST_CASE("TimeInterval basics", "[time-interval]") {
+    const Timestamp t0 = make_timestamp(100, 0);
+    const Timestamp t1 = make_timestamp(200, 0);
+    const Timestamp t2 = make_timestamp(300, 0);
+    const Timestamp t3 = make_timestamp(400, 0);
+
+    const TimeInterval a = TimeInterval::create(t0, t2);
+    const TimeInterval b =
+        TimeInterval::create(t1, TimeDelta::from_seconds(200));
+    const TimeInterval c = TimeInterval::create(t2, t3);
+    const TimeInterval empty = TimeInterval::create(t1, t1);
+
+    CHECK(b.end == t3);
+    CHECK(a.duration() == TimeDelta::from_seconds(200));
+    CHECK_FALSE(a.empty());
+    CHECK(empty.empty());
+    CHECK(empty.duration() == TimeDelta::zero());
+
+    /* The start is included, and the end is not */
+    CHECK(a.contains(t0));
+    CHECK(a.contains(make_timestamp(299, 999999999)));
+    CHECK_FALSE(a.contains(t2));
+    CHECK_FALSE(a.contains(make_timestamp(99, 999999999)));
+    CHECK_FALSE(empty.contains(t1));
+
+    CHECK(a.overlaps(b));
+    CHECK(b.overlaps(a));
+    CHECK(b.overlaps(c));
+    /* Intervals that meet end to start do not overlap */
+    CHECK_FALSE(a.overlaps(c));
+    CHECK_FALSE(c.overlaps(a));
+    /* An empty interval overlaps nothing */
+    CHECK_FALSE(a.overlaps(empty));
+    CHECK_FALSE(empty.overlaps(empty));
+
+    CHECK(a.contains(TimeInterval::create(t0, t1)));
+    CHECK(a.contains(a));
+    CHECK_FALSE(a.contains(b));
+
+    CHECK(a.intersection(b) == TimeInterval::create(t1, t2));
+    CHECK(b.intersection(a) == TimeInterval::create(t1, t2));
+    CHECK(a.intersection(c) == TimeInterval::create(t2, t2));
+    CHECK(TimeInterval::create(t0, t1).intersection(c) ==
+            TimeInterval::create(t2, t2));
+    CHECK(a != b);
+}
+
+TEST_CASE("TimeIntervalIndex queries", "[time-interval]") {
+    const size_t sizes[] = {0, 1, 2, 3, 10, 100, 1000, 5000};
+    unsigned long seed = 11;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        std::vector<TimeInterval> intervals;
+        for (size_t i = 0; i < sizes[s]; ++i) {
+            seed = seed * 1103515245 + 12345;
+            const Timestamp start = make_timestamp(
+                    (time_t)((seed >> 8) % 1001),
+                    (int_nanosecond)((seed >> 4) % 2) * 500000000);
+            seed = seed * 1103515245 + 12345;
+            /* Mostly short intervals, with some long ones and some empty
+               ones */
+            const long length = (seed >> 8) % 10 == 0 ?
+                (long)((seed >> 12) % 500) : (long)((seed >> 12) % 8);
+            intervals.push_back(TimeInterval::create(
+                        start, TimeDelta::from_milliseconds(length * 500)));
+        }
+        std::stable_sort(intervals.begin(), intervals.end(), start_less);
+
+        const TimeIntervalIndex index(
+                intervals.empty() ? NULL : &intervals[0], intervals.size());
+        REQUIRE(index.size() == intervals.size());
+        std::vector<size_t> positions(intervals.size() + 1);
+
+        for (time_t second = -2; second <= 1503; second += 3) {
+            for (int_nanosecond ns = 0; ns < 1000000000; ns += 500000000) {
+                const Timestamp value = make_timestamp(second, ns);
+                std::vector<size_t> expected;
+                for (size_t i = 0; i < intervals.size(); ++i) {
+                    if (intervals[i].contains(value)) {
+                        expected.push_back(i);
+                    }
+                }
+                const size_t count = index.find_containing(
+                        value, &positions[0], positions.size());
+                REQUIRE(count == expected.size());
+                REQUIRE(sorted_positions(positions, count) == expected);
+                /* With no room, the matches are just counted */
+                REQUIRE(index.find_containing(value, NULL, 0) == count);
+            }
+
+            const TimeInterval query = TimeInterval::create(
+                    make_timestamp(second, 500000000),
+                    TimeDelta::from_seconds((second + 7) % 7 * 2));
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < intervals.size(); ++i) {
+                if (intervals[i].overlaps(query)) {
+                    expected.push_back(i);
+                }
+            }
+            const size_t count = index.find_overlapping(
+                    query, &positions[0], positions.size());
+            REQUIRE(count == expected.size());
+            REQUIRE(sorted_positions(positions, count) == expected);
+        }
+    }
+}
+
+TEST_CASE("TimeIntervalIndex edge cases", "[time-interval]") {
+    const Timestamp t0 = make_timestamp(0, 0);
+    const Timestamp t1 = make_timestamp(10, 0);
+    const Timestamp t2 = make_timestamp(20, 0);
+
+    /* Identical, nested, and empty intervals */
+    const TimeInterval intervals[] = {
+        TimeInterval::create(t0, t0),
+        TimeInterval::create(t0, t2),
+        TimeInterval::create(t0, t2),
+        TimeInterval::create(t0, t1),
+        TimeInterval::create(t1, t1),
+        TimeInterval::create(t1, t2),
+    };
+    TimeIntervalIndex index(intervals, 6);
+    size_t positions[6];
+
+    CHECK(index.find_containing(t0, positions, 6) == 3);
+    CHECK(index.find_containing(t1, positions, 6) == 3);
+    CHECK(index.find_containing(t2, positions, 6) == 0);
+    CHECK(index.find_overlapping(TimeInterval::create(t1, t1),
+                positions, 6) == 0);
+    CHECK(index.find_overlapping(TimeInterval::create(t0, t2),
+                positions, 6) == 4);
+
+    /* Only the first matches are written when there is not enough room */
+    positions[1] = 99;
+    CHECK(index.find_overlapping(TimeInterval::create(t0, t2),
+                positions, 1) == 4);
+    CHECK(positions[0] != 4);
+    CHECK(positions[1] == 99);
+
+    /* Copies are independent of the original */
+    TimeIntervalIndex copy(index);
+    index.build(intervals, 1);
+    CHECK(index.size() == 1);
+    CHECK(index.find_containing(t0, NULL, 0) == 0);
+    CHECK(copy.size() == 6);
+    CHECK(copy.find_containing(t0, NULL, 0) == 3);
+    copy = index;
+    CHECK(copy.size() == 1);
+    CHECK(copy.find_overlapping(TimeInterval::create(t0, t2), NULL, 0) == 0);
+
+    index.build(NULL, 0);
+    CHECK(index.empty());
+    CHECK(index.find_containing(t0, NULL, 0) == 0);
+}
+
+TEST_CASE("TimeIntervalIndex C functions", "[time-interval]") {
+    struct Timestamp start = make_timestamp(0, 0);
+    struct Timestamp end = make_timestamp(60, 0);
+    struct TimeInterval intervals[2];
+    struct TimeIntervalIndex index;
+    size_t positions[2];
+
+    intervals[0] = TimeInterval_create(&start, &end);
+    end = make_timestamp(30, 0);
+    intervals[1] = TimeInterval_create(&end, &end);
+    CHECK(TimeInterval_is_empty(&intervals[1]));
+    CHECK(TimeInterval_contains(&intervals[0], &end));
+
+    TimeIntervalIndex_init(&index);
+    REQUIRE(TimeIntervalIndex_build(&index, intervals, 2));
+    CHECK(TimeIntervalIndex_find_containing(&index, &end, positions, 2) == 1);
+    CHECK(positions[0] == 0);
+    TimeIntervalIndex_destroy(&index);
+    CHECK(index.size_ == 0);
+}
@@ -0,0 +1,179 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the TimeWindow and ShardedTimeWindow C++ classes
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <thread>
+#endif
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/** Create a timestamp from a number of milliseconds since the UNIX epoch. */
+static Timestamp
+from_ms(long milliseconds)
+{
+    return Timestamp::epoch() + TimeDelta::from_milliseconds(milliseconds);
+}
+
+TEST_CASE("TimeWindow basics", "[time-window]") {
+    TimeWindow<long> window(TimeDelta::from_seconds(60));
+
+    CHECK(window.empty());
+    CHECK(window.count() == 0);
+    CHECK(window.sum() == 0);
+    CHECK(window.duration() == TimeDelta::from_seconds(60));
+
+    window.add(from_ms(0), 5);
+    window.add(from_ms(10000), 3);
+    window.add(from_ms(10000), 9);
+    window.add(from_ms(30000), 4);
+    CHECK(window.count() == 4);
+    CHECK(window.sum() == 21);
+    CHECK(window.min() == 3);
+    CHECK(window.max() == 9);
+    CHECK(window.latest() == from_ms(30000));
+
+    /* The value at 0 is in the window until the window ends at 60s */
+    window.expire(from_ms(59999));
+    CHECK(window.count() == 4);
+    window.expire(from_ms(60000));
+    CHECK(window.count() == 3);
+    CHECK(window.sum() == 16);
+    CHECK(window.min() == 3);
+    CHECK(window.max() == 9);
+
+    /* Both values at 10s expire together */
+    window.add(from_ms(70000), 6);
+    CHECK(window.count() == 2);
+    CHECK(window.sum() == 10);
+    CHECK(window.min() == 4);
+    CHECK(window.max() == 6);
+
+    window.expire(from_ms(1000000));
+    CHECK(window.empty());
+    CHECK(window.sum() == 0);
+
+    window.add(from_ms(1000000), -2);
+    CHECK(window.min() == -2);
+    CHECK(window.max() == -2);
+
+    window.clear();
+    CHECK(window.empty());
+    /* After clearing, the window can start again from any time */
+    window.add(from_ms(-5000), 1);
+    CHECK(window.count() == 1);
+}
+
+TEST_CASE("TimeWindow matches a brute-force window", "[time-window]") {
+    const TimeDelta duration = TimeDelta::from_milliseconds(2500);
+    TimeWindow<long> window(duration);
+    std::deque<std::pair<Timestamp, long> > expected;
+    unsigned long seed = 11;
+    long time = 0;
+
+    for (int i = 0; i < 5000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        /* Small steps (some of them 0), with the occasional large gap */
+        time += (long)((seed >> 8) % 200);
+        if ((seed >> 20) % 97 == 0) {
+            time += 5000;
+        }
+        const long value = (long)((seed >> 4) % 1000) - 500;
+        const Timestamp t = from_ms(time);
+
+        window.add(t, value);
+        expected.push_back(std::make_pair(t, value));
+        while (!(t - duration < expected.front().first)) {
+            expected.pop_front();
+        }
+
+        long sum = 0, min = expected.front().second,
+             max = expected.front().second;
+        for (size_t j = 0; j < expected.size(); ++j) {
+            sum += expected[j].second;
+            min = std::min(min, expected[j].second);
+            max = std::max(max, expected[j].second);
+        }
+        REQUIRE(window.count() == expected.size());
+        REQUIRE(window.sum() == sum);
+        REQUIRE(window.min() == min);
+        REQUIRE(window.max() == max);
+    }
+}
+
+TEST_CASE("TimeWindow with TimeDelta values", "[time-window]") {
+    TimeWindow<TimeDelta> latencies(TimeDelta::from_seconds(10));
+
+    latencies.add(from_ms(0), TimeDelta::from_milliseconds(120));
+    latencies.add(from_ms(4000), TimeDelta::from_milliseconds(80));
+    latencies.add(from_ms(9000), TimeDelta::from_milliseconds(200));
+    CHECK(latencies.sum() == TimeDelta::from_milliseconds(400));
+    CHECK(latencies.min() == TimeDelta::from_milliseconds(80));
+    CHECK(latencies.max() == TimeDelta::from_milliseconds(200));
+
+    latencies.expire(from_ms(14000));
+    CHECK(latencies.sum() == TimeDelta::from_milliseconds(200));
+    CHECK(latencies.min() == TimeDelta::from_milliseconds(200));
+}
+
+#if __cplusplus >= 201103L
+
+TEST_CASE("ShardedTimeWindow", "[time-window]") {
+    ShardedTimeWindow<long> window(TimeDelta::from_seconds(60), 4);
+    long value = 0;
+
+    CHECK(window.shard_count() == 4);
+    CHECK(window.duration() == TimeDelta::from_seconds(60));
+    CHECK(window.count(from_ms(0)) == 0);
+    CHECK_FALSE(window.min(from_ms(0), value));
+
+    /* Each thread adds 1000 values, one every 100ms */
+    const int thread_count = 8;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread([&window, t]() {
+            for (long i = 0; i < 1000; ++i) {
+                window.add(from_ms(i * 100), t * 1000 + i);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    /* The values from 40s to 99.9s are in the window ending at 99.9s (up
+       to the skew between threads, which is 0 when they share a shard) */
+    const size_t count = window.count(from_ms(99900));
+    CHECK(count >= 600 * thread_count);
+    CHECK(count <= 1000 * thread_count);
+
+    /* After every value has expired, the window is empty again */
+    CHECK(window.count(from_ms(200000)) == 0);
+    CHECK(window.sum(from_ms(200000)) == 0);
+
+    window.add(from_ms(200000), 7);
+    window.add(from_ms(200001), -3);
+    CHECK(window.count(from_ms(200001)) == 2);
+    CHECK(window.sum(from_ms(200001)) == 4);
+    REQUIRE(window.min(from_ms(200001), value));
+    CHECK(value == -3);
+    REQUIRE(window.max(from_ms(200001), value));
+    CHECK(value == 7);
+}
+
+#endif
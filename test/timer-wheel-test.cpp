@@ -0,0 +1,359 @@
+/*
+ * Present - Date/Time Library
+ *
+ * Tests for the TimerWheel, TimerWheelTimer, and TimerWheelGroup C++ classes
+ * and C-compatible methods
+ *
+ * Licensed under the MIT License.
+ * For details, see LICENSE.
+ */
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "catch.hpp"
+#include "test-utils.hpp"
+
+#include "present.h"
+
+/** The time that the wheels in these tests start at. */
+static const Timestamp START = Timestamp::create(1700000000);
+
+/** A timer with the deadline that it was scheduled for. */
+struct TestTimer {
+    /* The TimerWheelTimer is first, so that a pointer to it is a pointer to
+       the TestTimer */
+    TimerWheelTimer timer;
+    Timestamp deadline;
+    int id;
+    int fire_count;
+};
+
+/** The state of the callback for the tests. */
+struct FiredTimers {
+    std::vector<TestTimer *> timers;
+};
+
+static void
+record_fired(TimerWheelTimer * timer, void * context)
+{
+    TestTimer * const test_timer = reinterpret_cast<TestTimer *>(timer);
+    static_cast<FiredTimers *>(context)->timers.push_back(test_timer);
+    ++test_timer->fire_count;
+}
+
+/** Simple linear congruential generator (so that every run is the same). */
+static present_uint64
+next_random(present_uint64 & seed)
+{
+    /* (6364136223846793005 and 1442695040888963407) */
+    static const present_uint64 multiplier =
+        ((present_uint64) 0x5851F42D << 32) | 0x4C957F2D;
+    static const present_uint64 increment =
+        ((present_uint64) 0x14057B7E << 32) | 0xF767814F;
+    seed = seed * multiplier + increment;
+    return seed >> 17;
+}
+
+/** Get a random delay, spread out over every level of a millisecond wheel. */
+static TimeDelta
+random_delay(present_uint64 & seed)
+{
+    /* Up to 2^42 milliseconds (about 139 years), but mostly short */
+    const int bits = (int) (next_random(seed) % 43);
+    const int_delta milliseconds =
+        (int_delta) (next_random(seed) % ((present_uint64) 1 << bits)) - 5;
+    return TimeDelta::from_milliseconds(milliseconds) +
+        TimeDelta::from_microseconds((int_delta) (next_random(seed) % 1000));
+}
+
+TEST_CASE("TimerWheel expiry", "[timer-wheel]") {
+    TimerWheel wheel(START, TimeDelta::from_milliseconds(1));
+    FiredTimers fired;
+    TestTimer timers[5];
+    const int delays_ms[5] = {250, 3, 70000, 3, 1};
+
+    CHECK(wheel.size() == 0);
+    CHECK(wheel.now() == START);
+    Timestamp next;
+    CHECK_FALSE(wheel.next_event(next));
+
+    for (int i = 0; i < 5; ++i) {
+        timers[i].id = i;
+        timers[i].fire_count = 0;
+        CHECK_FALSE(timers[i].timer.is_scheduled());
+        wheel.schedule_after(timers[i].timer,
+                TimeDelta::from_milliseconds(delays_ms[i]));
+        CHECK(timers[i].timer.is_scheduled());
+    }
+    CHECK(wheel.size() == 5);
+    REQUIRE(wheel.next_event(next));
+    CHECK(next == START + TimeDelta::from_milliseconds(1));
+
+    /* Nothing expires before its deadline */
+    CHECK(wheel.advance(START + TimeDelta::from_microseconds(999),
+                record_fired, &fired) == 0);
+    CHECK(wheel.advance(START + TimeDelta::from_milliseconds(2),
+                record_fired, &fired) == 1);
+    CHECK(fired.timers[0] == &timers[4]);
+    CHECK_FALSE(timers[4].timer.is_scheduled());
+
+    /* The timers expire in order, each exactly once */
+    fired.timers.clear();
+    CHECK(wheel.advance(START + TimeDelta::from_hours(1), record_fired,
+                &fired) == 4);
+    REQUIRE(fired.timers.size() == 4);
+    CHECK(fired.timers[2] == &timers[0]);
+    CHECK(fired.timers[3] == &timers[2]);
+    CHECK(wheel.size() == 0);
+    CHECK(wheel.now() == START + TimeDelta::from_hours(1));
+    for (int i = 0; i < 5; ++i) {
+        CHECK(timers[i].fire_count == 1);
+    }
+
+    /* Going back in time does nothing */
+    CHECK(wheel.advance(START, record_fired, &fired) == 0);
+    CHECK(wheel.now() == START + TimeDelta::from_hours(1));
+}
+
+TEST_CASE("TimerWheel deadlines that have passed", "[timer-wheel]") {
+    TimerWheel wheel(START, TimeDelta::from_milliseconds(10));
+    FiredTimers fired;
+    TestTimer past, now;
+    past.fire_count = now.fire_count = 0;
+
+    wheel.advance(START + TimeDelta::from_seconds(5), record_fired, &fired);
+    wheel.schedule_at(past.timer, START);
+    wheel.schedule_after(now.timer, TimeDelta::zero());
+    Timestamp next;
+    REQUIRE(wheel.next_event(next));
+    CHECK(next == wheel.now());
+
+    /* They expire on the next call, even without moving forward */
+    CHECK(wheel.advance(START + TimeDelta::from_seconds(5), record_fired,
+                &fired) == 2);
+    CHECK(past.fire_count == 1);
+    CHECK(now.fire_count == 1);
+
+    /* Before the start of the wheel */
+    wheel.schedule_at(past.timer, START - TimeDelta::from_days(400));
+    CHECK(wheel.advance(START, record_fired, &fired) == 1);
+    CHECK(past.fire_count == 2);
+}
+
+/**
+ * A callback that reschedules each timer a second later, and cancels another
+ * timer.
+ */
+struct Periodic {
+    TimerWheel * wheel;
+    TestTimer * other;
+    int count;
+
+    void operator()(TimerWheelTimer * timer) {
+        ++count;
+        wheel->cancel(other->timer);
+        wheel->schedule_after(*timer, TimeDelta::from_seconds(1));
+    }
+};
+
+TEST_CASE("TimerWheel cancelling and rescheduling", "[timer-wheel]") {
+    TimerWheel wheel(START, TimeDelta::from_milliseconds(1));
+    FiredTimers fired;
+    TestTimer a, b, c;
+    a.fire_count = b.fire_count = c.fire_count = 0;
+
+    wheel.schedule_after(a.timer, TimeDelta::from_seconds(10));
+    wheel.schedule_after(b.timer, TimeDelta::from_seconds(10));
+    wheel.schedule_after(c.timer, TimeDelta::from_days(1000));
+    CHECK(wheel.size() == 3);
+
+    CHECK(wheel.cancel(a.timer));
+    CHECK_FALSE(wheel.cancel(a.timer));
+    CHECK_FALSE(a.timer.is_scheduled());
+    CHECK(wheel.size() == 2);
+
+    /* Rescheduling moves the timer */
+    wheel.schedule_after(b.timer, TimeDelta::from_seconds(20));
+    CHECK(wheel.size() == 2);
+    CHECK(wheel.advance(START + TimeDelta::from_seconds(15), record_fired,
+                &fired) == 0);
+    CHECK(wheel.advance(START + TimeDelta::from_seconds(20), record_fired,
+                &fired) == 1);
+    CHECK(b.fire_count == 1);
+
+    /* A timer beyond the highest level (2^36 milliseconds) */
+    CHECK(wheel.advance(START + TimeDelta::from_days(999), record_fired,
+                &fired) == 0);
+    CHECK(c.timer.is_scheduled());
+    CHECK(wheel.advance(START + TimeDelta::from_days(1000), record_fired,
+                &fired) == 1);
+    CHECK(c.fire_count == 1);
+    CHECK(wheel.size() == 0);
+
+    /* Rescheduling a timer from its own callback, and cancelling another */
+    Periodic periodic = {&wheel, &b, 0};
+    wheel.schedule_after(a.timer, TimeDelta::from_seconds(1));
+    wheel.schedule_after(b.timer, TimeDelta::from_seconds(1));
+    const Timestamp base = wheel.now();
+    for (int i = 1; i <= 10; ++i) {
+        wheel.advance(base + TimeDelta::from_milliseconds(i * 1000 + 500),
+                periodic);
+    }
+    CHECK(periodic.count == 10);
+    CHECK_FALSE(b.timer.is_scheduled());
+    CHECK(a.timer.is_scheduled());
+    CHECK(wheel.size() == 1);
+}
+
+TEST_CASE("TimerWheel against the deadlines", "[timer-wheel]") {
+    const TimeDelta resolution = TimeDelta::from_milliseconds(1);
+    TimerWheel wheel(START, resolution);
+    std::vector<TestTimer> timers(2000);
+    present_uint64 seed = 7;
+    FiredTimers fired;
+
+    for (size_t i = 0; i < timers.size(); ++i) {
+        timers[i].id = (int) i;
+        timers[i].fire_count = 0;
+        timers[i].deadline = START + random_delay(seed);
+        wheel.schedule_at(timers[i].timer, timers[i].deadline);
+    }
+
+    Timestamp now = START;
+    for (int step = 0; step < 400; ++step) {
+        /* Move forward by anything from a millisecond to a year */
+        const int bits = (int) (next_random(seed) % 35);
+        now += TimeDelta::from_milliseconds(
+                (int_delta) (next_random(seed) % ((present_uint64) 1 << bits)));
+
+        /* Cancel or reschedule a few timers on the way */
+        for (int j = 0; j < 5; ++j) {
+            TestTimer & timer = timers[next_random(seed) % timers.size()];
+            if (next_random(seed) % 3 == 0) {
+                CHECK(wheel.cancel(timer.timer) ==
+                        timer.timer.is_scheduled());
+                wheel.cancel(timer.timer);
+            } else {
+                timer.deadline = wheel.now() + random_delay(seed);
+                timer.fire_count = 0;
+                wheel.schedule_at(timer.timer, timer.deadline);
+            }
+        }
+
+        /* The timers that were already due expire first, then the rest in
+           order of their ticks */
+        const Timestamp before = wheel.now();
+        fired.timers.clear();
+        wheel.advance(now, record_fired, &fired);
+        for (size_t j = 0; j < fired.timers.size(); ++j) {
+            INFO(fired.timers[j]->id);
+            CHECK(fired.timers[j]->deadline <= now);
+            CHECK(fired.timers[j]->fire_count == 1);
+            if (j > 0 && fired.timers[j - 1]->deadline > before) {
+                CHECK(fired.timers[j - 1]->deadline - resolution <
+                        fired.timers[j]->deadline);
+            }
+        }
+
+        size_t scheduled = 0;
+        for (size_t j = 0; j < timers.size(); ++j) {
+            if (timers[j].timer.is_scheduled()) {
+                INFO(timers[j].id);
+                CHECK(timers[j].deadline > now - resolution);
+                ++scheduled;
+            }
+        }
+        CHECK(wheel.size() == scheduled);
+
+        Timestamp next;
+        if (wheel.next_event(next)) {
+            CHECK(next > now);
+        }
+    }
+}
+
+TEST_CASE("TimerWheelGroup shards", "[timer-wheel]") {
+    TimerWheelGroup group(4, START, TimeDelta::from_microseconds(100));
+    FiredTimers fired;
+    TestTimer timers[8];
+
+    CHECK(group.shard_count() == 4);
+    for (int i = 0; i < 8; ++i) {
+        timers[i].id = i;
+        timers[i].fire_count = 0;
+        group.schedule_after(i % 4, timers[i].timer,
+                TimeDelta::from_milliseconds(i + 1));
+    }
+    CHECK(group.cancel(3, timers[7].timer));
+    CHECK_FALSE(group.cancel(3, timers[7].timer));
+
+    /* Each shard only expires its own timers */
+    CHECK(group.advance(1, START + TimeDelta::from_seconds(1), record_fired,
+                &fired) == 2);
+    CHECK(timers[1].fire_count == 1);
+    CHECK(timers[5].fire_count == 1);
+    CHECK(timers[0].timer.is_scheduled());
+    CHECK(group.advance(3, START + TimeDelta::from_seconds(1), record_fired,
+                &fired) == 1);
+    CHECK(timers[7].fire_count == 0);
+
+    /* A timer may be scheduled at a time on its shard */
+    group.schedule_at(1, timers[1].timer,
+            START + TimeDelta::from_seconds(2));
+    CHECK(group.advance(1, START + TimeDelta::from_seconds(2), record_fired,
+                &fired) == 1);
+    CHECK(timers[1].fire_count == 2);
+}
+
+static void
+count_fired(struct TimerWheelTimer * timer, void * context)
+{
+    (void) timer;
+    ++*static_cast<int *>(context);
+}
+
+TEST_CASE("TimerWheel C functions", "[timer-wheel]") {
+    struct TimeDelta resolution = TimeDelta_from_milliseconds(1);
+    struct TimeDelta delay = TimeDelta_from_seconds(2);
+    struct Timestamp start = Timestamp_from_time_t(1000);
+    struct Timestamp now = Timestamp_from_time_t(1001);
+    struct Timestamp next;
+    /* In C++, these have constructors, so they are only allocated here */
+    struct TimerWheel * wheel = static_cast<TimerWheel *>(
+            operator new(sizeof(TimerWheel)));
+    struct TimerWheelGroup * group = static_cast<TimerWheelGroup *>(
+            operator new(sizeof(TimerWheelGroup)));
+    struct TimerWheelTimer timer;
+    int count = 0;
+
+    TimerWheel_init(wheel, &start, &resolution);
+    TimerWheelTimer_init(&timer);
+    TimerWheel_schedule_after(wheel, &timer, &delay);
+    CHECK(TimerWheel_count(wheel) == 1);
+    CHECK(TimerWheelTimer_is_scheduled(&timer));
+    CHECK(TimerWheel_next_event(wheel, &next));
+    CHECK(TimerWheel_advance(wheel, &now, count_fired, &count) == 0);
+    CHECK(TimerWheel_get_now(wheel) == now);
+    CHECK(TimerWheel_cancel(wheel, &timer));
+    CHECK_FALSE(TimerWheel_next_event(wheel, &next));
+
+    TimerWheel_schedule_at(wheel, &timer, &now);
+    CHECK(TimerWheel_advance_to_now(wheel, count_fired, &count) == 1);
+    CHECK(count == 1);
+    operator delete(wheel);
+
+    REQUIRE(TimerWheelGroup_init(group, 2, &start, &resolution));
+    CHECK(TimerWheelGroup_shard_count(group) == 2);
+    TimerWheelGroup_schedule_at(group, 1, &timer, &now);
+    TimerWheelGroup_schedule_after(group, 1, &timer, &delay);
+    CHECK(TimerWheelGroup_advance(group, 0, &now, count_fired, &count) == 0);
+    now = Timestamp_from_time_t(1002);
+    CHECK(TimerWheelGroup_advance(group, 1, &now, count_fired, &count) == 1);
+    CHECK(TimerWheelGroup_cancel(group, 1, &timer) == 0);
+    TimerWheelGroup_destroy(group);
+    CHECK(TimerWheelGroup_shard_count(group) == 0);
+    operator delete(group);
+}
+
@@ -7,6 +7,9 @@
  * For details, see LICENSE.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include "catch.hpp"
 #include "test-utils.hpp"
 
@@ -652,3 +655,162 @@ TEST_CASE("Timestamp arithmetic operators edge cases", "[timestamp]") {
     CHECK(t.get_date_utc() == Date::create(1935, 7, 16));
 }
 
+TEST_CASE("Timestamp sorting", "[timestamp]") {
+    std::vector<Timestamp> timestamps, expected;
+    unsigned long seed = 12345;
+
+    /* Timestamps before and after the epoch, and several in each second */
+    for (int i = 0; i < 5000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        timestamps.push_back(
+                Timestamp::create((time_t)((seed >> 8) % 2001) - 1000) +
+                TimeDelta::from_nanoseconds((seed >> 4) % 1000000000));
+    }
+    timestamps.push_back(Timestamp::create((time_t)-5000 * 1000000000));
+    timestamps.push_back(Timestamp::create((time_t)5000 * 1000000000));
+    expected = timestamps;
+    std::sort(expected.begin(), expected.end());
+
+    REQUIRE(Timestamp_sort(&timestamps[0], timestamps.size()));
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        CHECK(timestamps[i] == expected[i]);
+    }
+
+    Timestamp::sort(NULL, 0);
+}
+
+/** Create a Timestamp from a date and a time in UTC. */
+static Timestamp
+utc(int_year year, int_month month, int_day day, int_hour hour = 0,
+        int_minute minute = 0, int_second second = 0)
+{
+    return Timestamp::create_utc(Date::create(year, month, day),
+            ClockTime::create(hour, minute, second));
+}
+
+TEST_CASE("Timestamp truncation", "[timestamp]") {
+    const Timestamp t = utc(2024, 5, 16, 13, 45, 10) +
+        TimeDelta::from_nanoseconds(123456789);
+    const TimeDelta plus_2 = TimeDelta::from_hours(2);
+    const TimeDelta minus_530 = -TimeDelta::from_minutes(330);
+
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_MICROSECOND) ==
+            utc(2024, 5, 16, 13, 45, 10) +
+            TimeDelta::from_nanoseconds(123456000));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_MILLISECOND) ==
+            utc(2024, 5, 16, 13, 45, 10) +
+            TimeDelta::from_nanoseconds(123000000));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_SECOND) ==
+            utc(2024, 5, 16, 13, 45, 10));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_MINUTE) ==
+            utc(2024, 5, 16, 13, 45));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_HOUR) == utc(2024, 5, 16, 13));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_DAY) == utc(2024, 5, 16));
+    /* May 16, 2024 was a Thursday */
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_WEEK) == utc(2024, 5, 13));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_MONTH) == utc(2024, 5, 1));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_QUARTER) == utc(2024, 4, 1));
+    CHECK(t.truncate_utc(PRESENT_TRUNCATE_YEAR) == utc(2024, 1, 1));
+
+    /* In other time zones, the units start at local midnight */
+    CHECK(t.truncate(PRESENT_TRUNCATE_DAY, plus_2) == utc(2024, 5, 15, 22));
+    CHECK(t.truncate(PRESENT_TRUNCATE_MONTH, plus_2) ==
+            utc(2024, 4, 30, 22));
+    CHECK(t.truncate(PRESENT_TRUNCATE_HOUR, minus_530) ==
+            utc(2024, 5, 16, 13, 30));
+    CHECK(utc(2024, 1, 1, 3).truncate(PRESENT_TRUNCATE_YEAR, minus_530) ==
+            utc(2023, 1, 1, 5, 30));
+    CHECK(utc(2024, 5, 13, 1).truncate(PRESENT_TRUNCATE_WEEK, plus_2) ==
+            utc(2024, 5, 12, 22));
+    CHECK(utc(2024, 5, 12, 23).truncate(PRESENT_TRUNCATE_WEEK, plus_2) ==
+            utc(2024, 5, 12, 22));
+
+    /* Before the UNIX epoch, and on the first day of a unit */
+    CHECK(utc(1969, 12, 31, 23, 59, 59).truncate_utc(PRESENT_TRUNCATE_DAY) ==
+            utc(1969, 12, 31));
+    CHECK(utc(1969, 12, 31).truncate_utc(PRESENT_TRUNCATE_WEEK) ==
+            utc(1969, 12, 29));
+    CHECK(utc(1900, 3, 1).truncate_utc(PRESENT_TRUNCATE_QUARTER) ==
+            utc(1900, 1, 1));
+    CHECK(utc(2000, 12, 31, 23).truncate_utc(PRESENT_TRUNCATE_QUARTER) ==
+            utc(2000, 10, 1));
+    CHECK(utc(2000, 10, 1).truncate_utc(PRESENT_TRUNCATE_QUARTER) ==
+            utc(2000, 10, 1));
+}
+
+TEST_CASE("Timestamp buckets and windows", "[timestamp]") {
+    const Timestamp epoch = Timestamp::epoch();
+    const Timestamp t = utc(2024, 5, 16, 13, 52, 10);
+
+    CHECK(t.bucket(TimeDelta::from_minutes(15), epoch) ==
+            utc(2024, 5, 16, 13, 45));
+    CHECK(t.bucket(TimeDelta::from_minutes(15),
+                utc(2024, 1, 1, 0, 5)) == utc(2024, 5, 16, 13, 50));
+    /* Widths that do not divide a day or a second */
+    CHECK(utc(1970, 1, 1, 0, 20).bucket(TimeDelta::from_minutes(7), epoch) ==
+            utc(1970, 1, 1, 0, 14));
+    CHECK(utc(1969, 12, 31, 23, 59).bucket(TimeDelta::from_minutes(7),
+                epoch) == utc(1969, 12, 31, 23, 53));
+    CHECK((epoch + TimeDelta::from_milliseconds(4000)).bucket(
+                TimeDelta::from_milliseconds(1500), epoch) ==
+            epoch + TimeDelta::from_milliseconds(3000));
+    CHECK((epoch - TimeDelta::from_nanoseconds(1)).bucket(
+                TimeDelta::from_milliseconds(1500), epoch) ==
+            epoch - TimeDelta::from_milliseconds(1500));
+    /* A timestamp at the start of a bucket stays the same */
+    CHECK(t.bucket(TimeDelta::from_seconds(10), epoch) == t);
+
+    /* Far from the origin, in buckets that are not whole seconds (so the
+       number of nanoseconds from the origin does not fit in 64 bits) */
+    const Timestamp far = epoch + TimeDelta::from_days(365 * 1000000L);
+    const TimeDelta odd = TimeDelta::from_nanoseconds(1500000007);
+    const Timestamp far_bucket = far.bucket(odd, epoch);
+    CHECK(far_bucket <= far);
+    CHECK(far_bucket + odd > far);
+    CHECK(far_bucket.bucket(odd, epoch) == far_bucket);
+    CHECK((far_bucket - odd).bucket(odd, epoch) == far_bucket - odd);
+
+    /* Tiny buckets, with more of them between the timestamp and the origin
+       than fit in an int_delta */
+    const TimeDelta tiny = TimeDelta::from_nanoseconds(7);
+    const Timestamp tiny_times[] = {
+        far + TimeDelta::from_nanoseconds(5),
+        epoch - TimeDelta::from_days(365 * 1000L) +
+            TimeDelta::from_nanoseconds(3),
+    };
+    for (size_t i = 0; i < sizeof(tiny_times) / sizeof(tiny_times[0]); ++i) {
+        CHECK(tiny_times[i].bucket(TimeDelta::from_nanoseconds(1), epoch) ==
+                tiny_times[i]);
+        const Timestamp tiny_bucket = tiny_times[i].bucket(tiny, epoch);
+        CHECK(tiny_bucket <= tiny_times[i]);
+        CHECK(tiny_bucket + tiny > tiny_times[i]);
+        CHECK(tiny_bucket.bucket(tiny, epoch) == tiny_bucket);
+        CHECK((tiny_bucket + tiny).bucket(tiny, epoch) == tiny_bucket + tiny);
+    }
+    CHECK(tiny_times[0].bucket(tiny, epoch) ==
+            tiny_times[0] - TimeDelta::from_nanoseconds(6));
+    CHECK(tiny_times[1].bucket(tiny, epoch) ==
+            tiny_times[1] - TimeDelta::from_nanoseconds(4));
+
+    /* Windows of 10 minutes, starting every 5 minutes */
+    int_delta first, last;
+    CHECK(utc(1970, 1, 1, 0, 12).get_windows(TimeDelta::from_minutes(10),
+                TimeDelta::from_minutes(5), epoch, &first, &last) == 2);
+    CHECK(first == 1);
+    CHECK(last == 2);
+    CHECK(utc(1970, 1, 1, 0, 10).get_windows(TimeDelta::from_minutes(10),
+                TimeDelta::from_minutes(5), epoch, &first, &last) == 2);
+    CHECK(first == 1);
+    CHECK(last == 2);
+    CHECK(utc(1969, 12, 31, 23, 59).get_windows(TimeDelta::from_minutes(10),
+                TimeDelta::from_minutes(5), epoch, &first, &last) == 2);
+    CHECK(first == -2);
+    CHECK(last == -1);
+    /* Windows of 1 minute, starting every 5 minutes (with gaps between) */
+    CHECK(utc(1970, 1, 1, 0, 5, 59).get_windows(TimeDelta::from_minutes(1),
+                TimeDelta::from_minutes(5), epoch, &first, &last) == 1);
+    CHECK(first == 1);
+    CHECK(last == 1);
+    CHECK(utc(1970, 1, 1, 0, 6).get_windows(TimeDelta::from_minutes(1),
+                TimeDelta::from_minutes(5), epoch, &first, &last) == 0);
+}